@@ -35,6 +35,7 @@
 #include	"gaia_sync_autolockw.h"
 #include	"gaia_sync_event.h"
 #include	"gaia_sync_mutex.h"
+#include	"gaia_sync_tls.h"
 
 #include	"gaia_locale.h"
 
@@ -65,6 +66,7 @@
 #include	"gaia_iterator.h"
 
 #include	"gaia_algo_base.h"
+#include	"gaia_algo_strsimd.h"
 #include	"gaia_algo_compare.h"
 #include	"gaia_algo_memory.h"
 #include	"gaia_algo_extend.h"
@@ -84,6 +86,7 @@
 #include	"gaia_ctn_pair.h"
 #include 	"gaia_ctn_stackbitset.h"
 #include 	"gaia_ctn_bitset.h"
+#include	"gaia_ctn_roaringbitset.h"
 #include 	"gaia_ctn_chars.h"
 #include	"gaia_ctn_string.h"
 #include	"gaia_ctn_stringref.h"
@@ -108,6 +111,8 @@
 #include 	"gaia_ctn_bufferrw.h"
 #include 	"gaia_ctn_avltree.h"
 #include 	"gaia_ctn_trietree.h"
+#include 	"gaia_ctn_doublearraytrie.h"
+#include 	"gaia_ctn_fmindex.h"
 #include 	"gaia_ctn_kdtree.h"
 #include 	"gaia_ctn_ksvdtree.h"
 #include 	"gaia_ctn_tree.h"
@@ -116,6 +121,8 @@
 #include	"gaia_ctn_map.h"
 #include	"gaia_ctn_hashset.h"
 #include	"gaia_ctn_hashmap.h"
+#include	"gaia_ctn_flathashset.h"
+#include	"gaia_ctn_flathashmap.h"
 #include	"gaia_ctn_graph.h"
 #include	"gaia_ctn_dmpgraph.h"
 #include 	"gaia_ctn_net.h"
@@ -174,8 +181,12 @@
 #include	"gaia_fsys_memfile.h"
 #include	"gaia_fsys_dir.h"
 
+#include	"gaia_algo_extsort.h"
+#include	"gaia_algo_suffix.h"
+
 #include	"gaia_log.h"
 
+#include	"gaia_ctn_accesserpager.h"
 #include	"gaia_ctn_accesser.h"
 
 #include 	"gaia_digit_crc.h"
@@ -193,12 +204,14 @@
 #include 	"gaia_xml_xmlbase.h"
 #include 	"gaia_xml_xmlfactorydesc.h"
 #include 	"gaia_xml_xmlnode.h"
+#include 	"gaia_xml_xmlreader.h"
 #include 	"gaia_xml_xml.h"
 #include 	"gaia_xml_xmlfactory.h"
 
 #include 	"gaia_html_htmlbase.h"
 #include 	"gaia_html_htmlfactorydesc.h"
 #include 	"gaia_html_htmlnode.h"
+#include 	"gaia_html_htmlreader.h"
 #include 	"gaia_html_html.h"
 #include 	"gaia_html_htmlfactory.h"
 
@@ -207,6 +220,7 @@
 #include	"gaia_json_jsonnode.h"
 #include	"gaia_json_json.h"
 #include	"gaia_json_jsonfactory.h"
+#include	"gaia_json_jsondoc.h"
 
 #include	"gaia_network_ip.h"
 #include	"gaia_network_addr.h"
@@ -214,10 +228,12 @@
 #include 	"gaia_network_socket.h"
 #include	"gaia_network_asyncsocket.h"
 #include	"gaia_network_asyncdispatcher.h"
+#include	"gaia_network_congestion.h"
 #include	"gaia_network_sudpsocket.h"
 #include	"gaia_network_server.h"
 #include	"gaia_network_client.h"
 #include	"gaia_network_httpbase.h"
+#include	"gaia_network_httpparser.h"
 #include	"gaia_network_httpserver.h"
 #include	"gaia_network_http.h"
 
@@ -4,10 +4,117 @@
 #include "gaia_type.h"
 #include "gaia_assert.h"
 
+#if GAIA_COMPILER == GAIA_COMPILER_VC
+#	include <intrin.h>
+#endif
+
 namespace GAIA
 {
 	namespace ALGO
 	{
+		/*!
+			@brief Get the count of the trailing zero bits, it is the index of the lowest set bit.
+
+			@param u [in] Specify the value, it can't be 0.
+		*/
+		GINL GAIA::NUM gctz(GAIA::U32 u)
+		{
+			GAST(u != 0);
+		#if GAIA_COMPILER == GAIA_COMPILER_GCC || GAIA_COMPILER == GAIA_COMPILER_CLANG
+			return __builtin_ctz(u);
+		#elif GAIA_COMPILER == GAIA_COMPILER_VC
+			unsigned long ret;
+			_BitScanForward(&ret, u);
+			return (GAIA::NUM)ret;
+		#else
+			GAIA::NUM ret = 0;
+			while(!(u & 1))
+			{
+				u >>= 1;
+				++ret;
+			}
+			return ret;
+		#endif
+		}
+		GINL GAIA::NUM gctz(GAIA::U64 u)
+		{
+			GAST(u != 0);
+		#if GAIA_COMPILER == GAIA_COMPILER_GCC || GAIA_COMPILER == GAIA_COMPILER_CLANG
+			return __builtin_ctzll(u);
+		#elif GAIA_COMPILER == GAIA_COMPILER_VC && GAIA_MACHINE == GAIA_MACHINE64
+			unsigned long ret;
+			_BitScanForward64(&ret, u);
+			return (GAIA::NUM)ret;
+		#else
+			if((GAIA::U32)u != 0)
+				return GAIA::ALGO::gctz((GAIA::U32)u);
+			return 32 + GAIA::ALGO::gctz((GAIA::U32)(u >> 32));
+		#endif
+		}
+
+		/*!
+			@brief Get the count of the leading zero bits.
+
+			@param u [in] Specify the value, it can't be 0.
+		*/
+		GINL GAIA::NUM gclz(GAIA::U32 u)
+		{
+			GAST(u != 0);
+		#if GAIA_COMPILER == GAIA_COMPILER_GCC || GAIA_COMPILER == GAIA_COMPILER_CLANG
+			return __builtin_clz(u);
+		#elif GAIA_COMPILER == GAIA_COMPILER_VC
+			unsigned long ret;
+			_BitScanReverse(&ret, u);
+			return 31 - (GAIA::NUM)ret;
+		#else
+			GAIA::NUM ret = 31;
+			while(u >>= 1)
+				--ret;
+			return ret;
+		#endif
+		}
+		GINL GAIA::NUM gclz(GAIA::U64 u)
+		{
+			GAST(u != 0);
+		#if GAIA_COMPILER == GAIA_COMPILER_GCC || GAIA_COMPILER == GAIA_COMPILER_CLANG
+			return __builtin_clzll(u);
+		#elif GAIA_COMPILER == GAIA_COMPILER_VC && GAIA_MACHINE == GAIA_MACHINE64
+			unsigned long ret;
+			_BitScanReverse64(&ret, u);
+			return 63 - (GAIA::NUM)ret;
+		#else
+			if((GAIA::U32)(u >> 32) != 0)
+				return GAIA::ALGO::gclz((GAIA::U32)(u >> 32));
+			return 32 + GAIA::ALGO::gclz((GAIA::U32)u);
+		#endif
+		}
+
+		/*!
+			@brief Get the count of the set bits.
+		*/
+		GINL GAIA::NUM gpopcount(GAIA::U32 u)
+		{
+		#if GAIA_COMPILER == GAIA_COMPILER_GCC || GAIA_COMPILER == GAIA_COMPILER_CLANG
+			return __builtin_popcount(u);
+		#else
+			u = u - ((u >> 1) & 0x55555555);
+			u = (u & 0x33333333) + ((u >> 2) & 0x33333333);
+			u = (u + (u >> 4)) & 0x0F0F0F0F;
+			return (GAIA::NUM)((u * 0x01010101) >> 24);
+		#endif
+		}
+		GINL GAIA::NUM gpopcount(GAIA::U64 u)
+		{
+		#if GAIA_COMPILER == GAIA_COMPILER_GCC || GAIA_COMPILER == GAIA_COMPILER_CLANG
+			return __builtin_popcountll(u);
+		#else
+			u = u - ((u >> 1) & 0x5555555555555555ULL);
+			u = (u & 0x3333333333333333ULL) + ((u >> 2) & 0x3333333333333333ULL);
+			u = (u + (u >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+			return (GAIA::NUM)((u * 0x0101010101010101ULL) >> 56);
+		#endif
+		}
+
 		template<typename _DataType1, typename _DataType2>
 		GAIA::GVOID move(_DataType1& dst, const _DataType2& src){dst = src;}
 		template<typename _DataType, typename _SizeType>
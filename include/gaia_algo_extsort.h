@@ -0,0 +1,495 @@
+#ifndef		__GAIA_ALGO_EXTSORT_H__
+#define		__GAIA_ALGO_EXTSORT_H__
+
+#include "gaia_type.h"
+#include "gaia_assert.h"
+#include "gaia_algo_compare.h"
+#include "gaia_algo_sort.h"
+#include "gaia_sync_lock.h"
+#include "gaia_sync_autolock.h"
+#include "gaia_sync_event.h"
+#include "gaia_ctn_vector.h"
+#include "gaia_thread.h"
+#include "gaia_thread_pool.h"
+#include "gaia_fsys_filebase.h"
+
+namespace GAIA
+{
+	namespace ALGO
+	{
+		/*!
+			@brief The default comparer of GAIA::ALGO::esort, it compare the elements by operator <.
+		*/
+		template<typename _DataType> class ESortLess : public GAIA::Base
+		{
+		public:
+			GINL GAIA::BL operator () (const _DataType& t1, const _DataType& t2) const{return t1 < t2;}
+		};
+
+		/*!
+			@brief The implementation of GAIA::ALGO::esort.
+
+			@remarks
+				The source file is sorted by runs of the memory budget, and the runs are merged by a loser tree,
+				a merge pass merge at most GetMaxWays runs to one. The passes ping pong between the destination file and
+				the temporary file, and the first file is chosen to let the last pass write to the destination file.
+				All file reading and writing are executed in order by a IO thread, every run reader and the writer have two
+				buffers, one is used by the merge and another is being read or written.
+		*/
+		class ESortImpl
+		{
+		public:
+			static const GAIA::N64 MIN_BLOCK_SIZE = 64 * 1024; // The min bytes of a merge buffer, it limit the ways of a merge pass.
+			static const GAIA::N64 MAX_IO_SIZE = 1 << 30; // The max bytes of a file read or write call.
+			static const GAIA::N64 MAX_RUN_SIZE = 0x3FFFFFFF; // The max elements of a run, it must be a GAIA::NUM.
+
+		public:
+			template<typename _DataType, typename _CompareType> class Item
+			{
+			public:
+				GINL GAIA::BL operator < (const Item& src) const{return _CompareType()(t, src.t);}
+				GINL GAIA::BL operator > (const Item& src) const{return _CompareType()(src.t, t);}
+			public:
+				_DataType t;
+			};
+
+			class Request : public GAIA::Base
+			{
+			public:
+				GINL Request(){pFile = GNIL; nOffset = 0; p = GNIL; nSize = 0; pNext = GNIL; bWrite = GAIA::False; bResult = GAIA::True; bPending = GAIA::False;}
+			public:
+				GAIA::FSYS::FileBase* pFile;
+				GAIA::N64 nOffset;
+				GAIA::GVOID* p;
+				GAIA::N64 nSize;
+				Request* pNext;
+				GAIA::BL bWrite;
+				GAIA::BL bResult;
+				GAIA::BL bPending;
+				GAIA::SYNC::Event event;
+			};
+
+			class IOThread : public GAIA::THREAD::Thread
+			{
+			public:
+				GINL IOThread(){m_pHead = m_pTail = GNIL; m_bStop = GAIA::False; m_bResult = GAIA::True;}
+
+				/*!
+					@brief Append a request to the end of the request queue.
+
+					@remarks The request must not be pending, and the buffer must not be used until IOThread::Complete.
+				*/
+				GINL GAIA::GVOID Submit(Request& req, GAIA::FSYS::FileBase& file, GAIA::N64 nOffset, GAIA::GVOID* p, GAIA::N64 nSize, GAIA::BL bWrite)
+				{
+					GAST(!req.bPending);
+					req.pFile = &file;
+					req.nOffset = nOffset;
+					req.p = p;
+					req.nSize = nSize;
+					req.pNext = GNIL;
+					req.bWrite = bWrite;
+					req.bResult = GAIA::True;
+					req.bPending = GAIA::True;
+					{
+						GAIA::SYNC::Autolock al(m_lr);
+						if(m_pTail == GNIL)
+							m_pHead = &req;
+						else
+							m_pTail->pNext = &req;
+						m_pTail = &req;
+					}
+					m_event.Fire();
+				}
+
+				/*!
+					@brief Wait the request executed.
+
+					@return If the request is not pending or executed successfully, return GAIA::True.
+				*/
+				GINL GAIA::BL Complete(Request& req)
+				{
+					if(req.bPending)
+					{
+						req.event.Wait((GAIA::U32)GINVALID);
+						req.bPending = GAIA::False;
+						if(!req.bResult)
+							m_bResult = GAIA::False;
+					}
+					return req.bResult;
+				}
+				GINL GAIA::GVOID Stop()
+				{
+					{
+						GAIA::SYNC::Autolock al(m_lr);
+						m_bStop = GAIA::True;
+					}
+					m_event.Fire();
+					this->Wait();
+				}
+				GINL GAIA::BL GetResult() const{return m_bResult;}
+				virtual GAIA::GVOID Run()
+				{
+					for(;;)
+					{
+						m_event.Wait((GAIA::U32)GINVALID);
+						Request* pReq;
+						GAIA::BL bStop;
+						{
+							GAIA::SYNC::Autolock al(m_lr);
+							pReq = m_pHead;
+							if(pReq != GNIL)
+							{
+								m_pHead = pReq->pNext;
+								if(m_pHead == GNIL)
+									m_pTail = GNIL;
+							}
+							bStop = m_bStop;
+						}
+						if(pReq == GNIL)
+						{
+							if(bStop)
+								break;
+							continue;
+						}
+						pReq->bResult = this->Execute(*pReq);
+						pReq->event.Fire();
+					}
+				}
+			private:
+				static GINL GAIA::BL Execute(Request& req)
+				{
+					if(!req.pFile->Seek(req.nOffset, GAIA::SEEK_TYPE_BEGIN))
+						return GAIA::False;
+					if(req.pFile->Tell() != req.nOffset)
+						return GAIA::False;
+					GAIA::U8* p = GSCAST(GAIA::U8*)(req.p);
+					for(GAIA::N64 nRemain = req.nSize; nRemain > 0; )
+					{
+						GAIA::N32 nPart = GSCAST(GAIA::N32)(GAIA::ALGO::gmin(nRemain, GSCAST(GAIA::N64)(MAX_IO_SIZE)));
+						GAIA::N32 nDone = req.bWrite ? req.pFile->Write(p, nPart) : req.pFile->Read(p, nPart);
+						if(nDone != nPart)
+							return GAIA::False;
+						p += nPart;
+						nRemain -= nPart;
+					}
+					return GAIA::True;
+				}
+			private:
+				GAIA::SYNC::Lock m_lr;
+				GAIA::SYNC::Event m_event;
+				Request* m_pHead;
+				Request* m_pTail;
+				GAIA::BL m_bStop;
+				GAIA::BL m_bResult;
+			};
+
+			template<typename _DataType> class Reader : public GAIA::Base
+			{
+			public:
+				GINL GAIA::GVOID Begin(IOThread& io, GAIA::FSYS::FileBase& file, GAIA::N64 nOffset, GAIA::N64 nCount, _DataType* pBuf0, _DataType* pBuf1, GAIA::NUM sBlockSize)
+				{
+					m_pIO = &io;
+					m_pFile = &file;
+					m_nNext = nOffset;
+					m_nRemain = nCount;
+					m_pBuf[0] = pBuf0;
+					m_pBuf[1] = pBuf1;
+					m_sBlockSize = sBlockSize;
+					this->Fetch(0);
+					this->Fetch(1);
+					m_sCur = 0;
+					m_sPos = 0;
+					m_pIO->Complete(m_req[0]);
+				}
+				GINL GAIA::BL Empty() const{return m_sPos >= m_sSize[m_sCur];}
+				GINL const _DataType& Front() const{return m_pBuf[m_sCur][m_sPos];}
+				GINL GAIA::GVOID Next()
+				{
+					if(++m_sPos < m_sSize[m_sCur])
+						return;
+					this->Fetch(m_sCur);
+					m_sCur ^= 1;
+					m_sPos = 0;
+					m_pIO->Complete(m_req[m_sCur]);
+				}
+			private:
+				GINL GAIA::GVOID Fetch(GAIA::NUM sIndex)
+				{
+					m_sSize[sIndex] = GSCAST(GAIA::NUM)(GAIA::ALGO::gmin(m_nRemain, GSCAST(GAIA::N64)(m_sBlockSize)));
+					if(m_sSize[sIndex] == 0)
+						return;
+					m_pIO->Submit(m_req[sIndex], *m_pFile, m_nNext * sizeof(_DataType), m_pBuf[sIndex], GSCAST(GAIA::N64)(m_sSize[sIndex]) * sizeof(_DataType), GAIA::False);
+					m_nNext += m_sSize[sIndex];
+					m_nRemain -= m_sSize[sIndex];
+				}
+			private:
+				IOThread* m_pIO;
+				GAIA::FSYS::FileBase* m_pFile;
+				GAIA::N64 m_nNext;
+				GAIA::N64 m_nRemain;
+				_DataType* m_pBuf[2];
+				GAIA::NUM m_sSize[2];
+				GAIA::NUM m_sBlockSize;
+				GAIA::NUM m_sCur;
+				GAIA::NUM m_sPos;
+				Request m_req[2];
+			};
+
+			template<typename _DataType> class Writer : public GAIA::Base
+			{
+			public:
+				GINL GAIA::GVOID Begin(IOThread& io, GAIA::FSYS::FileBase& file, GAIA::N64 nOffset, _DataType* pBuf0, _DataType* pBuf1, GAIA::NUM sBlockSize)
+				{
+					m_pIO = &io;
+					m_pFile = &file;
+					m_nNext = nOffset;
+					m_pBuf[0] = pBuf0;
+					m_pBuf[1] = pBuf1;
+					m_sBlockSize = sBlockSize;
+					m_sCur = 0;
+					m_sPos = 0;
+				}
+				GINL GAIA::GVOID Push(const _DataType& t)
+				{
+					m_pBuf[m_sCur][m_sPos] = t;
+					if(++m_sPos == m_sBlockSize)
+						this->Flush();
+				}
+				GINL GAIA::GVOID End()
+				{
+					this->Flush();
+					m_pIO->Complete(m_req[0]);
+					m_pIO->Complete(m_req[1]);
+				}
+			private:
+				GINL GAIA::GVOID Flush()
+				{
+					if(m_sPos == 0)
+						return;
+					m_pIO->Submit(m_req[m_sCur], *m_pFile, m_nNext * sizeof(_DataType), m_pBuf[m_sCur], GSCAST(GAIA::N64)(m_sPos) * sizeof(_DataType), GAIA::True);
+					m_nNext += m_sPos;
+					m_sCur ^= 1;
+					m_sPos = 0;
+					m_pIO->Complete(m_req[m_sCur]);
+				}
+			private:
+				IOThread* m_pIO;
+				GAIA::FSYS::FileBase* m_pFile;
+				GAIA::N64 m_nNext;
+				_DataType* m_pBuf[2];
+				GAIA::NUM m_sBlockSize;
+				GAIA::NUM m_sCur;
+				GAIA::NUM m_sPos;
+				Request m_req[2];
+			};
+
+		public:
+			/*!
+				@brief Get the max ways of a merge pass by the memory budget.
+
+				@remarks Every way and the output use two buffers, and a buffer is not smaller than MIN_BLOCK_SIZE bytes.
+			*/
+			static GINL GAIA::N64 GetMaxWays(GAIA::U64 uMemorySize)
+			{
+				GAIA::N64 nWays = GSCAST(GAIA::N64)(uMemorySize / MIN_BLOCK_SIZE / 2) - 1;
+				return GAIA::ALGO::gmax(nWays, (GAIA::N64)2);
+			}
+
+			template<typename _DataType> static GAIA::BL Sort(GAIA::FSYS::FileBase& src, GAIA::FSYS::FileBase& dst, GAIA::FSYS::FileBase& tmp, GAIA::U64 uMemorySize, GAIA::THREAD::ThreadPool* pPool)
+			{
+				GAIA::N64 nSrcSize = src.Size();
+				if(nSrcSize < 0 || nSrcSize % sizeof(_DataType) != 0)
+					return GAIA::False;
+				GAIA::N64 nCount = nSrcSize / sizeof(_DataType);
+				if(nCount == 0)
+					return GAIA::True;
+
+				// The parallel sort need a merge buffer of the same size as the run, and a single run need not the second buffer.
+				GAIA::N64 nMemCount = GSCAST(GAIA::N64)(uMemorySize / sizeof(_DataType));
+				GAIA::BL bParallel = pPool != GNIL && pPool->IsBegin();
+				GAIA::N64 nRunSize = GAIA::ALGO::gmax(nMemCount / (bParallel ? 3 : 2), (GAIA::N64)1);
+				GAIA::N64 nSingleRunSize = GAIA::ALGO::gmax(nMemCount / (bParallel ? 2 : 1), (GAIA::N64)1);
+				if(nCount <= nSingleRunSize)
+					nRunSize = nCount;
+				nRunSize = GAIA::ALGO::gmin(nRunSize, GSCAST(GAIA::N64)(MAX_RUN_SIZE));
+				GAIA::N64 nRunCount = (nCount + nRunSize - 1) / nRunSize;
+				GAIA::N64 nWays = GAIA::ALGO::gmin(GetMaxWays(uMemorySize), nRunCount);
+				GAIA::NUM sPassCount = 0;
+				for(GAIA::N64 n = nRunCount; n > 1; n = (n + nWays - 1) / nWays)
+					++sPassCount;
+
+				GAIA::FSYS::FileBase* pFiles[2];
+				pFiles[sPassCount % 2] = &dst;
+				pFiles[(sPassCount + 1) % 2] = &tmp;
+
+				IOThread io;
+				if(!io.Start())
+					return GAIA::False;
+				GenerateRuns<_DataType>(io, src, *pFiles[0], nCount, GSCAST(GAIA::NUM)(nRunSize), pPool);
+				pFiles[0]->Flush();
+
+				if(sPassCount > 0)
+				{
+					GAIA::NUM sBlockSize = GSCAST(GAIA::NUM)(GAIA::ALGO::gmin(GAIA::ALGO::gmax(nMemCount / (nWays * 2 + 2), (GAIA::N64)1), GSCAST(GAIA::N64)(MAX_RUN_SIZE)));
+					GAIA::NUM sWays = GSCAST(GAIA::NUM)(nWays);
+					_DataType* pBlocks = gnew _DataType[GSCAST(GAIA::N64)(sBlockSize) * (sWays * 2 + 2)];
+					Reader<_DataType>* pReaders = gnew Reader<_DataType>[sWays];
+					Writer<_DataType> writer;
+					GAIA::NUM* pTree = gnew GAIA::NUM[sWays];
+
+					GAIA::CTN::Vector<GAIA::N64> runs, newruns;
+					for(GAIA::N64 n = 0; n < nCount; n += nRunSize)
+						runs.push_back(n);
+					for(GAIA::NUM sPass = 0; sPass < sPassCount; ++sPass)
+					{
+						GAIA::FSYS::FileBase& in = *pFiles[sPass % 2];
+						GAIA::FSYS::FileBase& out = *pFiles[(sPass + 1) % 2];
+						newruns.clear();
+						for(GAIA::NUM x = 0; x < runs.size(); x += sWays)
+						{
+							GAIA::NUM sGroup = GAIA::ALGO::gmin(sWays, runs.size() - x);
+							for(GAIA::NUM y = 0; y < sGroup; ++y)
+							{
+								GAIA::N64 nBegin = runs[x + y];
+								GAIA::N64 nEnd = x + y + 1 < runs.size() ? runs[x + y + 1] : nCount;
+								_DataType* pBuf = pBlocks + GSCAST(GAIA::N64)(sBlockSize) * y * 2;
+								pReaders[y].Begin(io, in, nBegin, nEnd - nBegin, pBuf, pBuf + sBlockSize, sBlockSize);
+							}
+							_DataType* pBuf = pBlocks + GSCAST(GAIA::N64)(sBlockSize) * sWays * 2;
+							writer.Begin(io, out, runs[x], pBuf, pBuf + sBlockSize, sBlockSize);
+							Merge(pReaders, sGroup, writer, pTree);
+							writer.End();
+							newruns.push_back(runs[x]);
+						}
+						out.Flush();
+						runs = newruns;
+					}
+
+					gdel[] pTree;
+					gdel[] pReaders;
+					gdel[] pBlocks;
+				}
+				io.Stop();
+				return io.GetResult();
+			}
+
+		private:
+			template<typename _DataType> static GAIA::GVOID GenerateRuns(IOThread& io, GAIA::FSYS::FileBase& src, GAIA::FSYS::FileBase& dst, GAIA::N64 nCount, GAIA::NUM sRunSize, GAIA::THREAD::ThreadPool* pPool)
+			{
+				// The next run is read when the current run is sorting, and it is written when the next run is sorting.
+				_DataType* pBuf[2];
+				GAIA::NUM sSize[2];
+				Request req[2];
+				pBuf[0] = gnew _DataType[GAIA::ALGO::gmin(GSCAST(GAIA::N64)(sRunSize), nCount)];
+				pBuf[1] = nCount > sRunSize ? gnew _DataType[GAIA::ALGO::gmin(GSCAST(GAIA::N64)(sRunSize), nCount - sRunSize)] : GNIL;
+				sSize[0] = GSCAST(GAIA::NUM)(GAIA::ALGO::gmin(GSCAST(GAIA::N64)(sRunSize), nCount));
+				io.Submit(req[0], src, 0, pBuf[0], GSCAST(GAIA::N64)(sSize[0]) * sizeof(_DataType), GAIA::False);
+				GAIA::N64 nNext = sSize[0];
+				GAIA::NUM sCur = 0;
+				for(GAIA::N64 nOffset = 0; nOffset < nCount; )
+				{
+					GAIA::NUM sOther = sCur ^ 1;
+					io.Complete(req[sCur]);
+					io.Complete(req[sOther]);
+					if(nNext < nCount)
+					{
+						sSize[sOther] = GSCAST(GAIA::NUM)(GAIA::ALGO::gmin(GSCAST(GAIA::N64)(sRunSize), nCount - nNext));
+						io.Submit(req[sOther], src, nNext * sizeof(_DataType), pBuf[sOther], GSCAST(GAIA::N64)(sSize[sOther]) * sizeof(_DataType), GAIA::False);
+						nNext += sSize[sOther];
+					}
+					if(pPool != GNIL)
+						pPool->ParallelSort(pBuf[sCur], sSize[sCur], GAIA::ALGO::gmax(sSize[sCur] / (pPool->GetThreadCount() * 4 + 1), 4096));
+					else
+						GAIA::ALGO::sort(pBuf[sCur], pBuf[sCur] + sSize[sCur] - 1);
+					io.Submit(req[sCur], dst, nOffset * sizeof(_DataType), pBuf[sCur], GSCAST(GAIA::N64)(sSize[sCur]) * sizeof(_DataType), GAIA::True);
+					nOffset += sSize[sCur];
+					sCur = sOther;
+				}
+				io.Complete(req[0]);
+				io.Complete(req[1]);
+				gdel[] pBuf[0];
+				if(pBuf[1] != GNIL)
+					gdel[] pBuf[1];
+			}
+			template<typename _DataType> static GAIA::GVOID Merge(Reader<_DataType>* pReaders, GAIA::NUM sCount, Writer<_DataType>& writer, GAIA::NUM* pTree)
+			{
+				// The loser tree keep the loser in the internal nodes and the winner in pTree[0], sCount is a virtual source beat all others.
+				for(GAIA::NUM x = 0; x < sCount; ++x)
+					pTree[x] = sCount;
+				for(GAIA::NUM x = sCount - 1; x >= 0; --x)
+					Adjust(pReaders, sCount, pTree, x);
+				for(;;)
+				{
+					GAIA::NUM sWinner = pTree[0];
+					if(pReaders[sWinner].Empty())
+						break;
+					writer.Push(pReaders[sWinner].Front());
+					pReaders[sWinner].Next();
+					Adjust(pReaders, sCount, pTree, sWinner);
+				}
+			}
+			template<typename _DataType> static GINL GAIA::GVOID Adjust(Reader<_DataType>* pReaders, GAIA::NUM sCount, GAIA::NUM* pTree, GAIA::NUM sSource)
+			{
+				for(GAIA::NUM t = (sSource + sCount) / 2; t > 0; t /= 2)
+				{
+					if(Beat(pReaders, sCount, pTree[t], sSource))
+						GAIA::ALGO::swap(pTree[t], sSource);
+				}
+				pTree[0] = sSource;
+			}
+			template<typename _DataType> static GINL GAIA::BL Beat(Reader<_DataType>* pReaders, GAIA::NUM sCount, GAIA::NUM s1, GAIA::NUM s2)
+			{
+				if(s1 == sCount)
+					return GAIA::True;
+				if(s2 == sCount)
+					return GAIA::False;
+				if(pReaders[s1].Empty())
+					return GAIA::False;
+				if(pReaders[s2].Empty())
+					return GAIA::True;
+				if(pReaders[s1].Front() < pReaders[s2].Front())
+					return GAIA::True;
+				if(pReaders[s2].Front() < pReaders[s1].Front())
+					return GAIA::False;
+				return s1 < s2;
+			}
+		};
+
+		/*!
+			@brief External sort the elements of a file, the memory used by the elements is limited by a budget.
+
+			@param src [in] Specify the file of the elements, the file size must be a multiple of sizeof(_DataType).
+
+			@param dst [in] Specify the file to write the sorted elements, it must be a empty file opened with OPEN_TYPE_READ and OPEN_TYPE_WRITE,
+				because the merge passes ping pong between it and the temporary file.
+
+			@param tmp [in] Specify the temporary file opened with OPEN_TYPE_READ and OPEN_TYPE_WRITE, it is not used if the elements are sorted by one run,
+				and it will not be larger than the source file.
+
+			@param uMemorySize [in] Specify the max bytes of the element buffers.
+
+			@param pPool [in] Specify the thread pool to sort the runs in parallel. If it is GNIL, the runs are sorted by the calling thread.
+
+			@return If sort successfully, return GAIA::True, or will return GAIA::False.
+
+			@remarks
+				The elements are copied by bytes between the files and the buffers, so _DataType must be a plain data type.
+				_CompareType is a stateless functor, _CompareType()(t1, t2) return GAIA::True if t1 is less than t2.
+				The sort is not stable.
+		*/
+		template<typename _DataType, typename _CompareType> GAIA::BL esort(GAIA::FSYS::FileBase& src, GAIA::FSYS::FileBase& dst, GAIA::FSYS::FileBase& tmp, GAIA::U64 uMemorySize, GAIA::THREAD::ThreadPool* pPool = GNIL)
+		{
+			typedef GAIA::ALGO::ESortImpl::Item<_DataType, _CompareType> __ItemType;
+			GAST(sizeof(__ItemType) == sizeof(_DataType));
+			if(sizeof(__ItemType) != sizeof(_DataType))
+				return GAIA::False;
+			return GAIA::ALGO::ESortImpl::Sort<__ItemType>(src, dst, tmp, uMemorySize, pPool);
+		}
+		template<typename _DataType> GAIA::BL esort(GAIA::FSYS::FileBase& src, GAIA::FSYS::FileBase& dst, GAIA::FSYS::FileBase& tmp, GAIA::U64 uMemorySize, GAIA::THREAD::ThreadPool* pPool = GNIL)
+		{
+			return GAIA::ALGO::esort<_DataType, GAIA::ALGO::ESortLess<_DataType> >(src, dst, tmp, uMemorySize, pPool);
+		}
+	}
+}
+
+#endif
@@ -4,10 +4,128 @@
 #include "gaia_type.h"
 #include "gaia_assert.h"
 
+#if GAIA_COMPILER == GAIA_COMPILER_VC && GAIA_MACHINE == GAIA_MACHINE64
+#	include <intrin.h>
+#endif
+
 namespace GAIA
 {
 	namespace ALGO
 	{
+		/*
+		*	The hash family is based on the multiply-fold mixing of wyhash,
+		*	the bytes are consumed a word at a time, and the length is mixed into the result.
+		*/
+		static const GAIA::U64 HASH_SECRET0 = 0xA0761D6478BD642FULL;
+		static const GAIA::U64 HASH_SECRET1 = 0xE7037ED1A0B428DBULL;
+		static const GAIA::U64 HASH_SECRET2 = 0x8EBC6AF09C88C6E3ULL;
+		static const GAIA::U64 HASH_SECRET3 = 0x589965CC75374CC3ULL;
+
+		/*!
+			@brief Multiply a and b to 128 bits, and fold the high 64 bits to the low 64 bits.
+		*/
+		GINL GAIA::U64 hash_mum(GAIA::U64 a, GAIA::U64 b)
+		{
+		#if (GAIA_COMPILER == GAIA_COMPILER_GCC || GAIA_COMPILER == GAIA_COMPILER_CLANG) && GAIA_MACHINE == GAIA_MACHINE64
+			__uint128_t r = (__uint128_t)a * b;
+			return (GAIA::U64)r ^ (GAIA::U64)(r >> 64);
+		#elif GAIA_COMPILER == GAIA_COMPILER_VC && GAIA_MACHINE == GAIA_MACHINE64
+			GAIA::U64 hi;
+			GAIA::U64 lo = _umul128(a, b, &hi);
+			return lo ^ hi;
+		#else
+			GAIA::U64 ha = a >> 32, hb = b >> 32, la = (GAIA::U32)a, lb = (GAIA::U32)b;
+			GAIA::U64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+			GAIA::U64 t = rl + (rm0 << 32);
+			GAIA::U64 c = t < rl;
+			GAIA::U64 lo = t + (rm1 << 32);
+			c += lo < t;
+			GAIA::U64 hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+			return lo ^ hi;
+		#endif
+		}
+		GINL GAIA::U64 hash_read64(const GAIA::U8* p)
+		{
+			return
+				(GAIA::U64)p[0] | ((GAIA::U64)p[1] << 8) | ((GAIA::U64)p[2] << 16) | ((GAIA::U64)p[3] << 24) |
+				((GAIA::U64)p[4] << 32) | ((GAIA::U64)p[5] << 40) | ((GAIA::U64)p[6] << 48) | ((GAIA::U64)p[7] << 56);
+		}
+		GINL GAIA::U64 hash_read32(const GAIA::U8* p)
+		{
+			return (GAIA::U64)p[0] | ((GAIA::U64)p[1] << 8) | ((GAIA::U64)p[2] << 16) | ((GAIA::U64)p[3] << 24);
+		}
+
+		/*!
+			@brief Hash a byte range.
+
+			@param p [in] Specify the begin of the bytes.
+
+			@param sSize [in] Specify the byte count.
+
+			@param uSeed [in] Specify the seed, different seed generate irrelevant results.
+				Use a random seed for the keys from network to resist hash flooding.
+		*/
+		GINL GAIA::U64 hash_bytes(const GAIA::GVOID* p, GAIA::NUM sSize, GAIA::U64 uSeed = 0)
+		{
+			GAST(p != GNIL || sSize == 0);
+			GAST(sSize >= 0);
+			const GAIA::U8* pBytes = GSCAST(const GAIA::U8*)(p);
+			GAIA::U64 uLen = (GAIA::U64)sSize;
+			GAIA::U64 a, b;
+			uSeed ^= GAIA::ALGO::hash_mum(uSeed ^ HASH_SECRET0, HASH_SECRET1);
+			if(uLen <= 16)
+			{
+				if(uLen >= 4)
+				{
+					GAIA::U64 uOffset = (uLen >> 3) << 2;
+					a = (GAIA::ALGO::hash_read32(pBytes) << 32) | GAIA::ALGO::hash_read32(pBytes + uOffset);
+					b = (GAIA::ALGO::hash_read32(pBytes + uLen - 4) << 32) | GAIA::ALGO::hash_read32(pBytes + uLen - 4 - uOffset);
+				}
+				else if(uLen > 0)
+				{
+					a = ((GAIA::U64)pBytes[0] << 16) | ((GAIA::U64)pBytes[uLen >> 1] << 8) | (GAIA::U64)pBytes[uLen - 1];
+					b = 0;
+				}
+				else
+					a = b = 0;
+			}
+			else
+			{
+				GAIA::U64 i = uLen;
+				if(i > 48)
+				{
+					GAIA::U64 uSeed1 = uSeed, uSeed2 = uSeed;
+					do
+					{
+						uSeed = GAIA::ALGO::hash_mum(GAIA::ALGO::hash_read64(pBytes) ^ HASH_SECRET1, GAIA::ALGO::hash_read64(pBytes + 8) ^ uSeed);
+						uSeed1 = GAIA::ALGO::hash_mum(GAIA::ALGO::hash_read64(pBytes + 16) ^ HASH_SECRET2, GAIA::ALGO::hash_read64(pBytes + 24) ^ uSeed1);
+						uSeed2 = GAIA::ALGO::hash_mum(GAIA::ALGO::hash_read64(pBytes + 32) ^ HASH_SECRET3, GAIA::ALGO::hash_read64(pBytes + 40) ^ uSeed2);
+						pBytes += 48;
+						i -= 48;
+					}
+					while(i > 48);
+					uSeed ^= uSeed1 ^ uSeed2;
+				}
+				while(i > 16)
+				{
+					uSeed = GAIA::ALGO::hash_mum(GAIA::ALGO::hash_read64(pBytes) ^ HASH_SECRET1, GAIA::ALGO::hash_read64(pBytes + 8) ^ uSeed);
+					pBytes += 16;
+					i -= 16;
+				}
+				a = GAIA::ALGO::hash_read64(pBytes + i - 16);
+				b = GAIA::ALGO::hash_read64(pBytes + i - 8);
+			}
+			return GAIA::ALGO::hash_mum(HASH_SECRET1 ^ uLen, GAIA::ALGO::hash_mum(a ^ HASH_SECRET1, b ^ uSeed));
+		}
+
+		/*!
+			@brief Hash a integer, spread the bits of the input to the whole result.
+		*/
+		GINL GAIA::U64 hash_int(GAIA::U64 u, GAIA::U64 uSeed = 0)
+		{
+			return GAIA::ALGO::hash_mum(u ^ HASH_SECRET0, uSeed ^ HASH_SECRET1);
+		}
+
 		template<typename _DataType> GAIA::U64 hash(const _DataType& t)
 		{
 			return t.hash();
@@ -16,12 +134,33 @@ namespace GAIA
 		{
 			return p->hash();
 		}
+		GINL GAIA::U64 hash(const GAIA::CH* p, GAIA::NUM sLen, GAIA::U64 uSeed = 0)
+		{
+			return GAIA::ALGO::hash_bytes(p, sLen * (GAIA::NUM)sizeof(GAIA::CH), uSeed);
+		}
+		GINL GAIA::U64 hash(const GAIA::WCH* p, GAIA::NUM sLen, GAIA::U64 uSeed = 0)
+		{
+			return GAIA::ALGO::hash_bytes(p, sLen * (GAIA::NUM)sizeof(GAIA::WCH), uSeed);
+		}
+		GINL GAIA::U64 hash_seed(const GAIA::CH* p, GAIA::U64 uSeed)
+		{
+			GAST(p != GNIL);
+			const GAIA::CH* pEnd = p;
+			while(*pEnd != '\0')
+				++pEnd;
+			return GAIA::ALGO::hash(p, (GAIA::NUM)(pEnd - p), uSeed);
+		}
+		GINL GAIA::U64 hash_seed(const GAIA::WCH* p, GAIA::U64 uSeed)
+		{
+			GAST(p != GNIL);
+			const GAIA::WCH* pEnd = p;
+			while(*pEnd != '\0')
+				++pEnd;
+			return GAIA::ALGO::hash(p, (GAIA::NUM)(pEnd - p), uSeed);
+		}
 		GINL GAIA::U64 hash(const GAIA::CH* p)
 		{
-			GAIA::U64 ret = 0;
-			for(; *p != '\0'; ++p)
-				ret += *p;
-			return ret;
+			return GAIA::ALGO::hash_seed(p, 0);
 		}
 		GINL GAIA::U64 hash(GAIA::CH* p)
 		{
@@ -29,10 +168,7 @@ namespace GAIA
 		}
 		GINL GAIA::U64 hash(const GAIA::WCH* p)
 		{
-			GAIA::U64 ret = 0;
-			for(; *p != '\0'; ++p)
-				ret += *p;
-			return ret;
+			return GAIA::ALGO::hash_seed(p, 0);
 		}
 		GINL GAIA::U64 hash(GAIA::WCH* p)
 		{
@@ -40,55 +176,55 @@ namespace GAIA
 		}
 		GINL GAIA::U64 hash(GAIA::U8 u)
 		{
-			return u;
+			return GAIA::ALGO::hash_int(u);
 		}
 		GINL GAIA::U64 hash(GAIA::U16 u)
 		{
-			return u;
+			return GAIA::ALGO::hash_int(u);
 		}
 		GINL GAIA::U64 hash(GAIA::U32 u)
 		{
-			return u;
+			return GAIA::ALGO::hash_int(u);
 		}
 		GINL GAIA::U64 hash(GAIA::U64 u)
 		{
-			return u;
+			return GAIA::ALGO::hash_int(u);
 		}
 		GINL GAIA::U64 hash(GAIA::UM u)
 		{
-			return u;
+			return GAIA::ALGO::hash_int(u);
 		}
 		GINL GAIA::U64 hash(GAIA::N8 n)
 		{
-			return n < 0 ? (~n) : n;
+			return GAIA::ALGO::hash_int((GAIA::U64)(GAIA::N64)n);
 		}
 		GINL GAIA::U64 hash(GAIA::N16 n)
 		{
-			return n < 0 ? (~n) : n;
+			return GAIA::ALGO::hash_int((GAIA::U64)(GAIA::N64)n);
 		}
 		GINL GAIA::U64 hash(GAIA::N32 n)
 		{
-			return n < 0 ? (~n) : n;
+			return GAIA::ALGO::hash_int((GAIA::U64)(GAIA::N64)n);
 		}
 		GINL GAIA::U64 hash(GAIA::N64 n)
 		{
-			return n < 0 ? (~n) : n;
+			return GAIA::ALGO::hash_int((GAIA::U64)n);
 		}
 		GINL GAIA::U64 hash(GAIA::NM n)
 		{
-			return n < 0 ? (~n) : n;
+			return GAIA::ALGO::hash_int((GAIA::U64)(GAIA::N64)n);
 		}
 		GINL GAIA::U64 hash(GAIA::WCH c)
 		{
-			return c;
+			return GAIA::ALGO::hash_int(c);
 		}
 		GINL GAIA::U64 hash(GAIA::F32 f)
 		{
-			return *(GAIA::U32*)&f;
+			return GAIA::ALGO::hash_int(*(GAIA::U32*)&f);
 		}
 		GINL GAIA::U64 hash(GAIA::F64 d)
 		{
-			return *(GAIA::U64*)&d;
+			return GAIA::ALGO::hash_int(*(GAIA::U64*)&d);
 		}
 	}
 }
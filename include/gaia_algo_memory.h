@@ -3,6 +3,13 @@
 
 #include "gaia_type.h"
 #include "gaia_assert.h"
+#include "gaia_algo_base.h"
+
+#if defined(GAIA_SIMD_AVX2)
+#	include <immintrin.h>
+#elif defined(GAIA_SIMD_SSE2)
+#	include <emmintrin.h>
+#endif
 
 namespace GAIA
 {
@@ -17,29 +24,332 @@ namespace GAIA
 				q[x] = p[sizeof(v) - x - 1];
 			return t;
 		}
+
+		/*!
+			@brief The memory copy, fill and compare implementation of every size class.
+
+			@remarks The size not above 16 bytes is handled by two overlapped words, and not above 32 bytes is
+				handled by two overlapped SSE2 registers. The middle size is handled by SIMD blocks(SSE2 is 16 bytes,
+				AVX2 is 32 bytes) with the destination aligned, and the size above
+				NONTEMPORAL_SIZE is written by the non-temporal store, so it will not evict the whole cache.
+				Without SIMD, the blocks are replaced by 8 bytes words.
+		*/
+		class MemImpl
+		{
+		public:
+		#if defined(GAIA_SIMD_AVX2)
+			static const GAIA::NUM BLOCK_SIZE = 32;
+		#elif defined(GAIA_SIMD_SSE2)
+			static const GAIA::NUM BLOCK_SIZE = 16;
+		#else
+			static const GAIA::NUM BLOCK_SIZE = 8;
+		#endif
+			static const GAIA::NUM NONTEMPORAL_SIZE = 4 * 1024 * 1024;
+
+		private:
+		#if GAIA_COMPILER == GAIA_COMPILER_GCC || GAIA_COMPILER == GAIA_COMPILER_CLANG
+			typedef GAIA::U16 __attribute__((__may_alias__, __aligned__(1))) __Word16;
+			typedef GAIA::U32 __attribute__((__may_alias__, __aligned__(1))) __Word32;
+			typedef GAIA::U64 __attribute__((__may_alias__, __aligned__(1))) __Word64;
+		#else
+			typedef GAIA::U16 __Word16;
+			typedef GAIA::U32 __Word32;
+			typedef GAIA::U64 __Word64;
+		#endif
+
+		#if defined(GAIA_SIMD_AVX2)
+			typedef __m256i __Block;
+			static GINL __Block Load(const GAIA::U8* p){return _mm256_loadu_si256(GRCAST(const __m256i*)(p));}
+			static GINL GAIA::GVOID Store(GAIA::U8* p, const __Block& b){_mm256_storeu_si256(GRCAST(__m256i*)(p), b);}
+			static GINL GAIA::GVOID StoreAligned(GAIA::U8* p, const __Block& b){_mm256_store_si256(GRCAST(__m256i*)(p), b);}
+			static GINL GAIA::GVOID StoreStream(GAIA::U8* p, const __Block& b){_mm256_stream_si256(GRCAST(__m256i*)(p), b);}
+			static GINL __Block Fill(GAIA::U8 v){return _mm256_set1_epi8((GAIA::N8)v);}
+			static GINL GAIA::U32 EqualMask(const __Block& b1, const __Block& b2){return (GAIA::U32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(b1, b2));}
+			static const GAIA::U32 EQUAL_MASK = 0xFFFFFFFF;
+		#elif defined(GAIA_SIMD_SSE2)
+			typedef __m128i __Block;
+			static GINL __Block Load(const GAIA::U8* p){return _mm_loadu_si128(GRCAST(const __m128i*)(p));}
+			static GINL GAIA::GVOID Store(GAIA::U8* p, const __Block& b){_mm_storeu_si128(GRCAST(__m128i*)(p), b);}
+			static GINL GAIA::GVOID StoreAligned(GAIA::U8* p, const __Block& b){_mm_store_si128(GRCAST(__m128i*)(p), b);}
+			static GINL GAIA::GVOID StoreStream(GAIA::U8* p, const __Block& b){_mm_stream_si128(GRCAST(__m128i*)(p), b);}
+			static GINL __Block Fill(GAIA::U8 v){return _mm_set1_epi8((GAIA::N8)v);}
+			static GINL GAIA::U32 EqualMask(const __Block& b1, const __Block& b2){return (GAIA::U32)_mm_movemask_epi8(_mm_cmpeq_epi8(b1, b2));}
+			static const GAIA::U32 EQUAL_MASK = 0xFFFF;
+		#else
+			typedef GAIA::U64 __Block;
+			static GINL __Block Load(const GAIA::U8* p){return *GRCAST(const __Word64*)(p);}
+			static GINL GAIA::GVOID Store(GAIA::U8* p, const __Block& b){*GRCAST(__Word64*)(p) = b;}
+			static GINL GAIA::GVOID StoreAligned(GAIA::U8* p, const __Block& b){*GRCAST(__Word64*)(p) = b;}
+			static GINL GAIA::GVOID StoreStream(GAIA::U8* p, const __Block& b){*GRCAST(__Word64*)(p) = b;}
+			static GINL __Block Fill(GAIA::U8 v){return (GAIA::U64)v * 0x0101010101010101ULL;}
+		#endif
+
+		public:
+			/*!
+				@brief Copy size bytes from src to dst.
+
+				@param bNonTemporal [in] Specify the blocks is written by non-temporal store or not.
+
+				@remarks The overlapped memory is copied by elements from the begin like the old implementation,
+					so dst could be before src.
+			*/
+			static GINL GAIA::GVOID Copy(GAIA::U8* dst, const GAIA::U8* src, GAIA::U64 size, GAIA::BL bNonTemporal)
+			{
+				if(size <= 16)
+				{
+					CopySmall(dst, src, size);
+					return;
+				}
+				if(dst < src + size && src < dst + size)
+				{
+					for(GAIA::U64 x = 0; x < size; ++x)
+						dst[x] = src[x];
+					return;
+				}
+			#if defined(GAIA_SIMD_SSE2)
+				if(size <= 32)
+				{
+					__m128i bHead = _mm_loadu_si128(GRCAST(const __m128i*)(src));
+					__m128i bTail = _mm_loadu_si128(GRCAST(const __m128i*)(src + size - 16));
+					_mm_storeu_si128(GRCAST(__m128i*)(dst), bHead);
+					_mm_storeu_si128(GRCAST(__m128i*)(dst + size - 16), bTail);
+					return;
+				}
+			#endif
+				if(size <= 2 * BLOCK_SIZE)
+				{
+					// Two blocks overlapped.
+					__Block bHead = Load(src);
+					__Block bTail = Load(src + size - BLOCK_SIZE);
+					Store(dst, bHead);
+					Store(dst + size - BLOCK_SIZE, bTail);
+					return;
+				}
+				if(size <= 4 * BLOCK_SIZE)
+				{
+					__Block b0 = Load(src);
+					__Block b1 = Load(src + BLOCK_SIZE);
+					__Block b2 = Load(src + size - 2 * BLOCK_SIZE);
+					__Block b3 = Load(src + size - BLOCK_SIZE);
+					Store(dst, b0);
+					Store(dst + BLOCK_SIZE, b1);
+					Store(dst + size - 2 * BLOCK_SIZE, b2);
+					Store(dst + size - BLOCK_SIZE, b3);
+					return;
+				}
+
+				// The head and the tail are unaligned blocks, the middle is aligned by dst.
+				__Block bHead = Load(src);
+				__Block bTail = Load(src + size - BLOCK_SIZE);
+				GAIA::U64 uSkip = BLOCK_SIZE - (((GAIA::U64)dst) & (BLOCK_SIZE - 1));
+				GAIA::U8* d = dst + uSkip;
+				const GAIA::U8* s = src + uSkip;
+				GAIA::U64 uRemain = size - uSkip;
+			#if defined(GAIA_SIMD_SSE2)
+				if(bNonTemporal)
+				{
+					for(; uRemain > 4 * BLOCK_SIZE; uRemain -= 4 * BLOCK_SIZE, d += 4 * BLOCK_SIZE, s += 4 * BLOCK_SIZE)
+					{
+						__Block b0 = Load(s);
+						__Block b1 = Load(s + BLOCK_SIZE);
+						__Block b2 = Load(s + 2 * BLOCK_SIZE);
+						__Block b3 = Load(s + 3 * BLOCK_SIZE);
+						StoreStream(d, b0);
+						StoreStream(d + BLOCK_SIZE, b1);
+						StoreStream(d + 2 * BLOCK_SIZE, b2);
+						StoreStream(d + 3 * BLOCK_SIZE, b3);
+					}
+					_mm_sfence();
+				}
+			#endif
+				for(; uRemain > 4 * BLOCK_SIZE; uRemain -= 4 * BLOCK_SIZE, d += 4 * BLOCK_SIZE, s += 4 * BLOCK_SIZE)
+				{
+					__Block b0 = Load(s);
+					__Block b1 = Load(s + BLOCK_SIZE);
+					__Block b2 = Load(s + 2 * BLOCK_SIZE);
+					__Block b3 = Load(s + 3 * BLOCK_SIZE);
+					StoreAligned(d, b0);
+					StoreAligned(d + BLOCK_SIZE, b1);
+					StoreAligned(d + 2 * BLOCK_SIZE, b2);
+					StoreAligned(d + 3 * BLOCK_SIZE, b3);
+				}
+				for(; uRemain > BLOCK_SIZE; uRemain -= BLOCK_SIZE, d += BLOCK_SIZE, s += BLOCK_SIZE)
+					StoreAligned(d, Load(s));
+				Store(dst, bHead);
+				Store(dst + size - BLOCK_SIZE, bTail);
+			}
+
+			/*!
+				@brief Fill size bytes of dst by v.
+			*/
+			static GINL GAIA::GVOID Set(GAIA::U8* dst, GAIA::U8 v, GAIA::U64 size, GAIA::BL bNonTemporal)
+			{
+				if(size <= 16)
+				{
+					SetSmall(dst, v, size);
+					return;
+				}
+			#if defined(GAIA_SIMD_SSE2)
+				if(size <= 32)
+				{
+					__m128i bHalf = _mm_set1_epi8((GAIA::N8)v);
+					_mm_storeu_si128(GRCAST(__m128i*)(dst), bHalf);
+					_mm_storeu_si128(GRCAST(__m128i*)(dst + size - 16), bHalf);
+					return;
+				}
+			#endif
+				__Block b = Fill(v);
+				if(size <= 2 * BLOCK_SIZE)
+				{
+					// Two blocks overlapped.
+					Store(dst, b);
+					Store(dst + size - BLOCK_SIZE, b);
+					return;
+				}
+				if(size <= 4 * BLOCK_SIZE)
+				{
+					Store(dst, b);
+					Store(dst + BLOCK_SIZE, b);
+					Store(dst + size - 2 * BLOCK_SIZE, b);
+					Store(dst + size - BLOCK_SIZE, b);
+					return;
+				}
+				GAIA::U64 uSkip = BLOCK_SIZE - (((GAIA::U64)dst) & (BLOCK_SIZE - 1));
+				GAIA::U8* d = dst + uSkip;
+				GAIA::U64 uRemain = size - uSkip;
+			#if defined(GAIA_SIMD_SSE2)
+				if(bNonTemporal)
+				{
+					for(; uRemain > 4 * BLOCK_SIZE; uRemain -= 4 * BLOCK_SIZE, d += 4 * BLOCK_SIZE)
+					{
+						StoreStream(d, b);
+						StoreStream(d + BLOCK_SIZE, b);
+						StoreStream(d + 2 * BLOCK_SIZE, b);
+						StoreStream(d + 3 * BLOCK_SIZE, b);
+					}
+					_mm_sfence();
+				}
+			#endif
+				for(; uRemain > 4 * BLOCK_SIZE; uRemain -= 4 * BLOCK_SIZE, d += 4 * BLOCK_SIZE)
+				{
+					StoreAligned(d, b);
+					StoreAligned(d + BLOCK_SIZE, b);
+					StoreAligned(d + 2 * BLOCK_SIZE, b);
+					StoreAligned(d + 3 * BLOCK_SIZE, b);
+				}
+				for(; uRemain > BLOCK_SIZE; uRemain -= BLOCK_SIZE, d += BLOCK_SIZE)
+					StoreAligned(d, b);
+				Store(dst, b);
+				Store(dst + size - BLOCK_SIZE, b);
+			}
+
+			/*!
+				@brief Compare size bytes of p1 and p2 as unsigned bytes.
+
+				@return If p1 is less than p2, return -1, if p1 is above p2, return +1, or return 0.
+			*/
+			static GINL GAIA::N32 Compare(const GAIA::U8* p1, const GAIA::U8* p2, GAIA::U64 size)
+			{
+				GAIA::U64 x = 0;
+			#if defined(GAIA_SIMD_SSE2)
+				if(size >= BLOCK_SIZE)
+				{
+					for(; x + BLOCK_SIZE <= size; x += BLOCK_SIZE)
+					{
+						GAIA::U32 uMask = EqualMask(Load(p1 + x), Load(p2 + x));
+						if(uMask != EQUAL_MASK)
+							return CompareByte(p1, p2, x + GAIA::ALGO::gctz(~uMask));
+					}
+					if(x == size)
+						return 0;
+
+					// The last block is overlapped with the compared block, the overlapped bytes are equal.
+					x = size - BLOCK_SIZE;
+					GAIA::U32 uMask = EqualMask(Load(p1 + x), Load(p2 + x));
+					if(uMask != EQUAL_MASK)
+						return CompareByte(p1, p2, x + GAIA::ALGO::gctz(~uMask));
+					return 0;
+				}
+			#endif
+				for(; x + sizeof(GAIA::U64) <= size; x += sizeof(GAIA::U64))
+				{
+					if(*GRCAST(const __Word64*)(p1 + x) != *GRCAST(const __Word64*)(p2 + x))
+						break;
+				}
+				for(; x < size; ++x)
+				{
+					if(p1[x] != p2[x])
+						return CompareByte(p1, p2, x);
+				}
+				return 0;
+			}
+
+		private:
+			static GINL GAIA::GVOID CopySmall(GAIA::U8* dst, const GAIA::U8* src, GAIA::U64 size)
+			{
+				// Read the both words before write, so the overlapped memory is copied correctly.
+				if(size >= 8)
+				{
+					GAIA::U64 uHead = *GRCAST(const __Word64*)(src);
+					GAIA::U64 uTail = *GRCAST(const __Word64*)(src + size - 8);
+					*GRCAST(__Word64*)(dst) = uHead;
+					*GRCAST(__Word64*)(dst + size - 8) = uTail;
+				}
+				else if(size >= 4)
+				{
+					GAIA::U32 uHead = *GRCAST(const __Word32*)(src);
+					GAIA::U32 uTail = *GRCAST(const __Word32*)(src + size - 4);
+					*GRCAST(__Word32*)(dst) = uHead;
+					*GRCAST(__Word32*)(dst + size - 4) = uTail;
+				}
+				else if(size >= 2)
+				{
+					GAIA::U16 uHead = *GRCAST(const __Word16*)(src);
+					GAIA::U16 uTail = *GRCAST(const __Word16*)(src + size - 2);
+					*GRCAST(__Word16*)(dst) = uHead;
+					*GRCAST(__Word16*)(dst + size - 2) = uTail;
+				}
+				else if(size == 1)
+					*dst = *src;
+			}
+			static GINL GAIA::GVOID SetSmall(GAIA::U8* dst, GAIA::U8 v, GAIA::U64 size)
+			{
+				GAIA::U64 u = (GAIA::U64)v * 0x0101010101010101ULL;
+				if(size >= 8)
+				{
+					*GRCAST(__Word64*)(dst) = u;
+					*GRCAST(__Word64*)(dst + size - 8) = u;
+				}
+				else if(size >= 4)
+				{
+					*GRCAST(__Word32*)(dst) = (GAIA::U32)u;
+					*GRCAST(__Word32*)(dst + size - 4) = (GAIA::U32)u;
+				}
+				else if(size >= 2)
+				{
+					*GRCAST(__Word16*)(dst) = (GAIA::U16)u;
+					*GRCAST(__Word16*)(dst + size - 2) = (GAIA::U16)u;
+				}
+				else if(size == 1)
+					*dst = v;
+			}
+			static GINL GAIA::N32 CompareByte(const GAIA::U8* p1, const GAIA::U8* p2, GAIA::U64 uIndex)
+			{
+				return p1[uIndex] < p2[uIndex] ? -1 : +1;
+			}
+		};
+
 		template<typename _SizeType> GAIA::GVOID* gmemcpy(
 				GAIA::GVOID* dst, const GAIA::GVOID* src, const _SizeType& size)
 		{
 			GAST(!!dst);
 			GAST(!!src);
 			GAST(size > 0);
-			_SizeType sizet = size;
-			GAIA::GVOID* pRet = dst;
-			while(sizet > sizeof(GAIA::UM))
-			{
-				*(GAIA::UM*)dst = *(GAIA::UM*)src;
-				dst = ((GAIA::UM*)dst) + 1;
-				src = ((GAIA::UM*)src) + 1;
-				sizet -= sizeof(GAIA::UM);
-			}
-			while(sizet > 0)
-			{
-				*(GAIA::U8*)dst = *(GAIA::U8*)src;
-				dst = ((GAIA::U8*)dst) + 1;
-				src = ((GAIA::U8*)src) + 1;
-				sizet -= sizeof(GAIA::U8);
-			}
-			return pRet;
+			if(size <= 0)
+				return dst;
+			GAIA::U64 uSize = (GAIA::U64)size;
+			GAIA::ALGO::MemImpl::Copy(GSCAST(GAIA::U8*)(dst), GSCAST(const GAIA::U8*)(src), uSize, uSize >= GAIA::ALGO::MemImpl::NONTEMPORAL_SIZE);
+			return dst;
 		}
 		template<typename _SizeType> GAIA::GVOID* gmemcpy(
 				GAIA::GVOID* dst, const GAIA::GVOID* src,
@@ -53,14 +363,27 @@ namespace GAIA
 			GAST(dst_stride <= src_stride);
 			GAST(size > 0);
 			GAST(count > 0);
-			GAIA::U8* pDst = (GAIA::U8*)dst;
-			const GAIA::U8* pSrc = (const GAIA::U8*)src;
-			while(count > 0)
+			if(size <= 0 || count <= 0)
+				return dst;
+			GAIA::U8* pDst = GSCAST(GAIA::U8*)(dst);
+			const GAIA::U8* pSrc = GSCAST(const GAIA::U8*)(src);
+			GAIA::U64 uSize = (GAIA::U64)size;
+			GAIA::U64 uCount = (GAIA::U64)count;
+
+			// The rows without gap are copied as a whole.
+			if(dst_stride == size && src_stride == size)
+			{
+				GAIA::ALGO::MemImpl::Copy(pDst, pSrc, uSize * uCount, uSize * uCount >= GAIA::ALGO::MemImpl::NONTEMPORAL_SIZE);
+				return dst;
+			}
+
+			// The image is too big for cache, every row is written by non-temporal store.
+			GAIA::BL bNonTemporal = uSize * uCount >= GAIA::ALGO::MemImpl::NONTEMPORAL_SIZE && uSize >= 8 * GAIA::ALGO::MemImpl::BLOCK_SIZE;
+			for(GAIA::U64 x = 0; x < uCount; ++x)
 			{
-				GAIA::ALGO::gmemcpy(pDst, pSrc, size);
+				GAIA::ALGO::MemImpl::Copy(pDst, pSrc, uSize, bNonTemporal);
 				pDst += dst_stride;
 				pSrc += src_stride;
-				--count;
 			}
 			return dst;
 		}
@@ -69,24 +392,11 @@ namespace GAIA
 		{
 			GAST(!!dst);
 			GAST(size > 0);
-			GAIA::UM clean = 0;
-			for(GAIA::U32 c = 0; c < sizeof(GAIA::UM) / sizeof(GAIA::N8); c++)
-				clean |= (((GAIA::UM)ch) << (c * 8));
-			_SizeType sizet = size;
-			GAIA::GVOID* pRet = dst;
-			while(sizet > sizeof(GAIA::UM))
-			{
-				*(GAIA::UM*)dst = (GAIA::UM)clean;
-				dst = ((GAIA::UM*)dst) + 1;
-				sizet = sizet - (_SizeType)sizeof(GAIA::UM);
-			}
-			while(sizet > 0)
-			{
-				*(GAIA::U8*)dst = (GAIA::U8)ch;
-				dst = ((GAIA::U8*)dst) + 1;
-				sizet = sizet - (_SizeType)sizeof(GAIA::U8);
-			}
-			return pRet;
+			if(size <= 0)
+				return dst;
+			GAIA::U64 uSize = (GAIA::U64)size;
+			GAIA::ALGO::MemImpl::Set(GSCAST(GAIA::U8*)(dst), (GAIA::U8)ch, uSize, uSize >= GAIA::ALGO::MemImpl::NONTEMPORAL_SIZE);
+			return dst;
 		}
 		template<typename _FillType, typename _SizeType>
 		GAIA::GVOID* gmemset(GAIA::GVOID* dst, const _FillType& ch,
@@ -97,12 +407,21 @@ namespace GAIA
 			GAST(stride > 0);
 			GAST(size > 0);
 			GAST(count > 0);
-			GAIA::U8* p = (GAIA::U8*)dst;
-			while(count > 0)
+			if(size <= 0 || count <= 0)
+				return dst;
+			GAIA::U8* p = GSCAST(GAIA::U8*)(dst);
+			GAIA::U64 uSize = (GAIA::U64)size;
+			GAIA::U64 uCount = (GAIA::U64)count;
+			if(stride == size)
+			{
+				GAIA::ALGO::MemImpl::Set(p, (GAIA::U8)ch, uSize * uCount, uSize * uCount >= GAIA::ALGO::MemImpl::NONTEMPORAL_SIZE);
+				return dst;
+			}
+			GAIA::BL bNonTemporal = uSize * uCount >= GAIA::ALGO::MemImpl::NONTEMPORAL_SIZE && uSize >= 8 * GAIA::ALGO::MemImpl::BLOCK_SIZE;
+			for(GAIA::U64 x = 0; x < uCount; ++x)
 			{
-				GAIA::ALGO::gmemset(p, ch, size);
+				GAIA::ALGO::MemImpl::Set(p, (GAIA::U8)ch, uSize, bNonTemporal);
 				p += stride;
-				--count;
 			}
 			return dst;
 		}
@@ -144,13 +463,14 @@ namespace GAIA
 			GAST(size > 0);
 			GAST(count > 0);
 			const GAIA::U8* pTemp = GSCAST(const GAIA::U8*)(p);
-			while(count > 0)
+			_SizeType sCount = count;
+			while(sCount > 0)
 			{
 				GAIA::N32 res = GAIA::ALGO::gmemchr(pTemp, ch, size);
 				if(res != 0)
 					return res;
 				pTemp += stride;
-				--count;
+				--sCount;
 			}
 			return 0;
 		}
@@ -160,28 +480,9 @@ namespace GAIA
 			GAST(!!p1);
 			GAST(!!p2);
 			GAST(size > 0);
-			_SizeType sizet = size;
-			while(sizet > sizeof(GAIA::UM))
-			{
-				if(*(GSCAST(const GAIA::UM*)(p1)) < *(GSCAST(const GAIA::UM*)(p2)))
-					return +1;
-				else if(*(GSCAST(const GAIA::UM*)(p1)) > *(GSCAST(const GAIA::UM*)(p2)))
-					return -1;
-				p1 = (GSCAST(const GAIA::UM*)(p1)) + 1;
-				p2 = (GSCAST(const GAIA::UM*)(p2)) + 1;
-				sizet -= sizeof(GAIA::UM);
-			}
-			while(sizet > sizeof(GAIA::U8))
-			{
-				if(*(GSCAST(const GAIA::U8*)(p1)) < *(GSCAST(const GAIA::U8*)(p2)))
-					return +1;
-				else if(*(GSCAST(const GAIA::U8*)(p1)) > *(GSCAST(const GAIA::U8*)(p2)))
-					return -1;
-				p1 = (GSCAST(const GAIA::U8*)(p1)) + 1;
-				p2 = (GSCAST(const GAIA::U8*)(p2)) + 1;
-				sizet -= sizeof(GAIA::U8);
-			}
-			return 0;
+			if(size <= 0)
+				return 0;
+			return GAIA::ALGO::MemImpl::Compare(GSCAST(const GAIA::U8*)(p1), GSCAST(const GAIA::U8*)(p2), (GAIA::U64)size);
 		}
 		template<typename _SizeType> GAIA::N32 gmemcmp(
 				const GAIA::GVOID* p1, const GAIA::GVOID* p2,
@@ -194,16 +495,18 @@ namespace GAIA
 			GAST(p2_stride > 0);
 			GAST(size > 0);
 			GAST(count > 0);
+			if(size <= 0 || count <= 0)
+				return 0;
 			const GAIA::U8* pA = GSCAST(const GAIA::U8*)(p1);
 			const GAIA::U8* pB = GSCAST(const GAIA::U8*)(p2);
-			while(count > 0)
+			GAIA::U64 uCount = (GAIA::U64)count;
+			for(GAIA::U64 x = 0; x < uCount; ++x)
 			{
-				GAIA::N32 nCmp = GAIA::ALGO::gmemcmp(pA, pB, size);
+				GAIA::N32 nCmp = GAIA::ALGO::MemImpl::Compare(pA, pB, (GAIA::U64)size);
 				if(nCmp != 0)
 					return nCmp;
 				pA += p1_stride;
 				pB += p2_stride;
-				--count;
 			}
 			return 0;
 		}
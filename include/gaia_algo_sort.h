@@ -13,6 +13,434 @@ namespace GAIA
 {
 	namespace ALGO
 	{
+		/*!
+			@brief The sort implementation of the half-open range [pBegin, pEnd).
+
+			@remarks The public sort functions use a closed range [pBegin, pEnd], and they convert it here.
+				The element type is only compared by operator <.
+				The _ValueType parameters are used to deduce the element type of _DataType, it's the same as *pBegin.
+		*/
+		class SortImpl
+		{
+		public:
+			static const GAIA::NUM INSERTION_SORT_THRESHOLD = 24;
+			static const GAIA::NUM NINTHER_THRESHOLD = 128;
+			static const GAIA::NUM PARTIAL_INSERTION_SORT_LIMIT = 8;
+			static const GAIA::NUM PARTITION_BLOCK_SIZE = 64;
+
+		public:
+			template<typename _DataType, typename _ValueType> static GAIA::GVOID InsertionSort(_DataType pBegin, _DataType pEnd, const _ValueType&)
+			{
+				if(pBegin == pEnd)
+					return;
+				for(_DataType pCur = pBegin + 1; pCur != pEnd; ++pCur)
+				{
+					_DataType pSift = pCur;
+					_DataType pSiftPrev = pCur - 1;
+					if(*pSift < *pSiftPrev)
+					{
+						_ValueType t = *pSift;
+						do
+						{
+							*pSift = *pSiftPrev;
+							--pSift;
+						}
+						while(pSift != pBegin && t < *--pSiftPrev);
+						*pSift = t;
+					}
+				}
+			}
+
+			/*!
+				@brief Insertion sort without the begin check, the element before pBegin must not above any element of the range.
+			*/
+			template<typename _DataType, typename _ValueType> static GAIA::GVOID UnguardedInsertionSort(_DataType pBegin, _DataType pEnd, const _ValueType&)
+			{
+				if(pBegin == pEnd)
+					return;
+				for(_DataType pCur = pBegin + 1; pCur != pEnd; ++pCur)
+				{
+					_DataType pSift = pCur;
+					_DataType pSiftPrev = pCur - 1;
+					if(*pSift < *pSiftPrev)
+					{
+						_ValueType t = *pSift;
+						do
+						{
+							*pSift = *pSiftPrev;
+							--pSift;
+						}
+						while(t < *--pSiftPrev);
+						*pSift = t;
+					}
+				}
+			}
+
+			/*!
+				@brief Insertion sort which give up when too many elements moved.
+
+				@return If the range is sorted, return GAIA::True, or return GAIA::False.
+			*/
+			template<typename _DataType, typename _ValueType> static GAIA::BL PartialInsertionSort(_DataType pBegin, _DataType pEnd, const _ValueType&)
+			{
+				if(pBegin == pEnd)
+					return GAIA::True;
+				GAIA::NUM sLimit = 0;
+				for(_DataType pCur = pBegin + 1; pCur != pEnd; ++pCur)
+				{
+					_DataType pSift = pCur;
+					_DataType pSiftPrev = pCur - 1;
+					if(*pSift < *pSiftPrev)
+					{
+						_ValueType t = *pSift;
+						do
+						{
+							*pSift = *pSiftPrev;
+							--pSift;
+						}
+						while(pSift != pBegin && t < *--pSiftPrev);
+						*pSift = t;
+						sLimit += GSCAST(GAIA::NUM)(pCur - pSift);
+					}
+					if(sLimit > PARTIAL_INSERTION_SORT_LIMIT)
+						return GAIA::False;
+				}
+				return GAIA::True;
+			}
+
+			template<typename _DataType, typename _ValueType> static GAIA::GVOID HeapSort(_DataType pBegin, _DataType pEnd, const _ValueType& v)
+			{
+				GAIA::NUM sSize = GSCAST(GAIA::NUM)(pEnd - pBegin);
+				for(GAIA::NUM x = sSize / 2 - 1; x >= 0; --x)
+					SiftDown(pBegin, x, sSize, v);
+				for(GAIA::NUM x = sSize - 1; x > 0; --x)
+				{
+					GAIA::ALGO::swap(*pBegin, *(pBegin + x));
+					SiftDown(pBegin, 0, x, v);
+				}
+			}
+
+			/*!
+				@brief Pattern-defeating quicksort.
+
+				@param sBadAllowed [in] Specify the count of highly unbalanced partitions allowed before switch to the heap sort.
+
+				@param bLeftMost [in] Specify the range is the left most, or the element before pBegin is the pivot of the parent partition.
+
+				@param bBranchless [in] Specify use the block partition which compare without branch, it is fast when the compare is cheap.
+			*/
+			template<typename _DataType, typename _ValueType> static GAIA::GVOID PdqSort(_DataType pBegin, _DataType pEnd, GAIA::NUM sBadAllowed, GAIA::BL bLeftMost, GAIA::BL bBranchless, const _ValueType& v)
+			{
+				for(;;)
+				{
+					GAIA::NUM sSize = GSCAST(GAIA::NUM)(pEnd - pBegin);
+					if(sSize < INSERTION_SORT_THRESHOLD)
+					{
+						if(bLeftMost)
+							InsertionSort(pBegin, pEnd, v);
+						else
+							UnguardedInsertionSort(pBegin, pEnd, v);
+						return;
+					}
+
+					// Choose the pivot as the median of 3 or the pseudomedian of 9, and move it to the begin.
+					GAIA::NUM sHalf = sSize / 2;
+					if(sSize > NINTHER_THRESHOLD)
+					{
+						Sort3(pBegin, pBegin + sHalf, pEnd - 1);
+						Sort3(pBegin + 1, pBegin + (sHalf - 1), pEnd - 2);
+						Sort3(pBegin + 2, pBegin + (sHalf + 1), pEnd - 3);
+						Sort3(pBegin + (sHalf - 1), pBegin + sHalf, pBegin + (sHalf + 1));
+						GAIA::ALGO::swap(*pBegin, *(pBegin + sHalf));
+					}
+					else
+						Sort3(pBegin + sHalf, pBegin, pEnd - 1);
+
+					// If the pivot is equal to the pivot of the parent partition, all the elements equal to it are put to the left,
+					// so the many equal elements are sorted in linear time.
+					if(!bLeftMost && !(*(pBegin - 1) < *pBegin))
+					{
+						pBegin = PartitionLeft(pBegin, pEnd, v) + 1;
+						continue;
+					}
+
+					GAIA::BL bAlreadyPartitioned;
+					_DataType pPivot = bBranchless ?
+						PartitionRightBranchless(pBegin, pEnd, bAlreadyPartitioned, v) :
+						PartitionRight(pBegin, pEnd, bAlreadyPartitioned, v);
+
+					GAIA::NUM sLeftSize = GSCAST(GAIA::NUM)(pPivot - pBegin);
+					GAIA::NUM sRightSize = GSCAST(GAIA::NUM)(pEnd - (pPivot + 1));
+					if(sLeftSize < sSize / 8 || sRightSize < sSize / 8)
+					{
+						// Too many bad partitions, the input is adversarial, use the heap sort to keep O(n log n).
+						if(--sBadAllowed == 0)
+						{
+							HeapSort(pBegin, pEnd, v);
+							return;
+						}
+
+						// Break the pattern by swap some elements.
+						if(sLeftSize >= INSERTION_SORT_THRESHOLD)
+						{
+							GAIA::ALGO::swap(*pBegin, *(pBegin + sLeftSize / 4));
+							GAIA::ALGO::swap(*(pPivot - 1), *(pPivot - sLeftSize / 4));
+							if(sLeftSize > NINTHER_THRESHOLD)
+							{
+								GAIA::ALGO::swap(*(pBegin + 1), *(pBegin + (sLeftSize / 4 + 1)));
+								GAIA::ALGO::swap(*(pBegin + 2), *(pBegin + (sLeftSize / 4 + 2)));
+								GAIA::ALGO::swap(*(pPivot - 2), *(pPivot - (sLeftSize / 4 + 1)));
+								GAIA::ALGO::swap(*(pPivot - 3), *(pPivot - (sLeftSize / 4 + 2)));
+							}
+						}
+						if(sRightSize >= INSERTION_SORT_THRESHOLD)
+						{
+							GAIA::ALGO::swap(*(pPivot + 1), *(pPivot + (1 + sRightSize / 4)));
+							GAIA::ALGO::swap(*(pEnd - 1), *(pEnd - sRightSize / 4));
+							if(sRightSize > NINTHER_THRESHOLD)
+							{
+								GAIA::ALGO::swap(*(pPivot + 2), *(pPivot + (2 + sRightSize / 4)));
+								GAIA::ALGO::swap(*(pPivot + 3), *(pPivot + (3 + sRightSize / 4)));
+								GAIA::ALGO::swap(*(pEnd - 2), *(pEnd - (1 + sRightSize / 4)));
+								GAIA::ALGO::swap(*(pEnd - 3), *(pEnd - (2 + sRightSize / 4)));
+							}
+						}
+					}
+					else
+					{
+						// No element swapped by a balanced partition, the range may be sorted already.
+						if(bAlreadyPartitioned && PartialInsertionSort(pBegin, pPivot, v) && PartialInsertionSort(pPivot + 1, pEnd, v))
+							return;
+					}
+
+					// Recursive the left, and loop the right.
+					PdqSort(pBegin, pPivot, sBadAllowed, bLeftMost, bBranchless, v);
+					pBegin = pPivot + 1;
+					bLeftMost = GAIA::False;
+				}
+			}
+
+			static GINL GAIA::NUM Log2(GAIA::NUM sSize)
+			{
+				GAIA::NUM ret = 0;
+				while(sSize >>= 1)
+					++ret;
+				return ret;
+			}
+
+		private:
+			template<typename _DataType, typename _ValueType> static GAIA::GVOID SiftDown(_DataType pBegin, GAIA::NUM sIndex, GAIA::NUM sSize, const _ValueType&)
+			{
+				_ValueType t = *(pBegin + sIndex);
+				for(;;)
+				{
+					GAIA::NUM sChild = sIndex * 2 + 1;
+					if(sChild >= sSize)
+						break;
+					if(sChild + 1 < sSize && *(pBegin + sChild) < *(pBegin + (sChild + 1)))
+						++sChild;
+					if(!(t < *(pBegin + sChild)))
+						break;
+					*(pBegin + sIndex) = *(pBegin + sChild);
+					sIndex = sChild;
+				}
+				*(pBegin + sIndex) = t;
+			}
+			template<typename _DataType> static GINL GAIA::GVOID Sort2(_DataType p1, _DataType p2)
+			{
+				if(*p2 < *p1)
+					GAIA::ALGO::swap(*p1, *p2);
+			}
+			template<typename _DataType> static GINL GAIA::GVOID Sort3(_DataType p1, _DataType p2, _DataType p3)
+			{
+				Sort2(p1, p2);
+				Sort2(p2, p3);
+				Sort2(p1, p2);
+			}
+
+			/*!
+				@brief Find the first pair of misplaced elements from the both sides, the pivot is the median so the search is in range.
+			*/
+			template<typename _DataType, typename _ValueType> static GINL GAIA::GVOID PartitionFind(_DataType& pFirst, _DataType& pLast, _DataType pBegin, const _ValueType& pivot)
+			{
+				while(*++pFirst < pivot);
+				if(pFirst - 1 == pBegin)
+				{
+					while(pFirst < pLast && !(*--pLast < pivot));
+				}
+				else
+				{
+					while(!(*--pLast < pivot));
+				}
+			}
+
+			/*!
+				@brief Partition [pBegin, pEnd) around the pivot *pBegin, the elements equal to the pivot are put to the right.
+
+				@param bAlreadyPartitioned [out] Return GAIA::True if no element swapped.
+
+				@return Return the position of the pivot.
+			*/
+			template<typename _DataType, typename _ValueType> static _DataType PartitionRight(_DataType pBegin, _DataType pEnd, GAIA::BL& bAlreadyPartitioned, const _ValueType&)
+			{
+				_ValueType pivot = *pBegin;
+				_DataType pFirst = pBegin;
+				_DataType pLast = pEnd;
+				PartitionFind(pFirst, pLast, pBegin, pivot);
+				bAlreadyPartitioned = pFirst >= pLast;
+				while(pFirst < pLast)
+				{
+					GAIA::ALGO::swap(*pFirst, *pLast);
+					while(*++pFirst < pivot);
+					while(!(*--pLast < pivot));
+				}
+				_DataType pPivot = pFirst - 1;
+				*pBegin = *pPivot;
+				*pPivot = pivot;
+				return pPivot;
+			}
+
+			/*!
+				@brief The same as PartitionRight, but the elements are compared by blocks, and the results are saved as offsets without branch.
+			*/
+			template<typename _DataType, typename _ValueType> static _DataType PartitionRightBranchless(_DataType pBegin, _DataType pEnd, GAIA::BL& bAlreadyPartitioned, const _ValueType&)
+			{
+				_ValueType pivot = *pBegin;
+				_DataType pFirst = pBegin;
+				_DataType pLast = pEnd;
+				PartitionFind(pFirst, pLast, pBegin, pivot);
+				bAlreadyPartitioned = pFirst >= pLast;
+				if(!bAlreadyPartitioned)
+				{
+					GAIA::ALGO::swap(*pFirst, *pLast);
+					++pFirst;
+
+					GAIA::U8 offsetsl[PARTITION_BLOCK_SIZE];
+					GAIA::U8 offsetsr[PARTITION_BLOCK_SIZE];
+					_DataType pOffsetsLBase = pFirst;
+					_DataType pOffsetsRBase = pLast;
+					GAIA::NUM sNumL = 0, sNumR = 0, sStartL = 0, sStartR = 0;
+					while(pFirst < pLast)
+					{
+						// Fill the offset blocks of the misplaced elements.
+						GAIA::NUM sUnknown = GSCAST(GAIA::NUM)(pLast - pFirst);
+						GAIA::NUM sLeftSplit = sNumL == 0 ? (sNumR == 0 ? sUnknown / 2 : sUnknown) : 0;
+						GAIA::NUM sRightSplit = sNumR == 0 ? (sUnknown - sLeftSplit) : 0;
+						if(sLeftSplit > PARTITION_BLOCK_SIZE)
+							sLeftSplit = PARTITION_BLOCK_SIZE;
+						if(sRightSplit > PARTITION_BLOCK_SIZE)
+							sRightSplit = PARTITION_BLOCK_SIZE;
+						for(GAIA::NUM x = 0; x < sLeftSplit; ++x)
+						{
+							offsetsl[sNumL] = GSCAST(GAIA::U8)(x);
+							sNumL += !(*pFirst < pivot);
+							++pFirst;
+						}
+						for(GAIA::NUM x = 0; x < sRightSplit;)
+						{
+							offsetsr[sNumR] = GSCAST(GAIA::U8)(++x);
+							sNumR += *--pLast < pivot;
+						}
+
+						// Swap the misplaced elements.
+						GAIA::NUM sNum = GAIA::ALGO::gmin(sNumL, sNumR);
+						SwapOffsets(pOffsetsLBase, pOffsetsRBase, offsetsl + sStartL, offsetsr + sStartR, sNum, sNumL == sNumR, pivot);
+						sNumL -= sNum;
+						sNumR -= sNum;
+						sStartL += sNum;
+						sStartR += sNum;
+						if(sNumL == 0)
+						{
+							sStartL = 0;
+							pOffsetsLBase = pFirst;
+						}
+						if(sNumR == 0)
+						{
+							sStartR = 0;
+							pOffsetsRBase = pLast;
+						}
+					}
+
+					// The remain misplaced elements of one side.
+					if(sNumL != 0)
+					{
+						const GAIA::U8* pOffsets = offsetsl + sStartL;
+						while(sNumL-- != 0)
+							GAIA::ALGO::swap(*(pOffsetsLBase + pOffsets[sNumL]), *--pLast);
+						pFirst = pLast;
+					}
+					if(sNumR != 0)
+					{
+						const GAIA::U8* pOffsets = offsetsr + sStartR;
+						while(sNumR-- != 0)
+						{
+							GAIA::ALGO::swap(*(pOffsetsRBase - pOffsets[sNumR]), *pFirst);
+							++pFirst;
+						}
+						pLast = pFirst;
+					}
+				}
+				_DataType pPivot = pFirst - 1;
+				*pBegin = *pPivot;
+				*pPivot = pivot;
+				return pPivot;
+			}
+			template<typename _DataType, typename _ValueType> static GINL GAIA::GVOID SwapOffsets(_DataType pFirst, _DataType pLast, const GAIA::U8* pOffsetsL, const GAIA::U8* pOffsetsR, GAIA::NUM sNum, GAIA::BL bUseSwap, const _ValueType&)
+			{
+				if(bUseSwap)
+				{
+					// The both sides will be empty, so the last swapped element must be at the right position.
+					for(GAIA::NUM x = 0; x < sNum; ++x)
+						GAIA::ALGO::swap(*(pFirst + pOffsetsL[x]), *(pLast - pOffsetsR[x]));
+				}
+				else if(sNum > 0)
+				{
+					// Rotate the elements by a cycle, it only assign one time for an element.
+					_DataType l = pFirst + pOffsetsL[0];
+					_DataType r = pLast - pOffsetsR[0];
+					_ValueType t = *l;
+					*l = *r;
+					for(GAIA::NUM x = 1; x < sNum; ++x)
+					{
+						l = pFirst + pOffsetsL[x];
+						*r = *l;
+						r = pLast - pOffsetsR[x];
+						*l = *r;
+					}
+					*r = t;
+				}
+			}
+
+			/*!
+				@brief Partition [pBegin, pEnd) around the pivot *pBegin, the elements equal to the pivot are put to the left.
+			*/
+			template<typename _DataType, typename _ValueType> static _DataType PartitionLeft(_DataType pBegin, _DataType pEnd, const _ValueType&)
+			{
+				_ValueType pivot = *pBegin;
+				_DataType pFirst = pBegin;
+				_DataType pLast = pEnd;
+				while(pivot < *--pLast);
+				if(pLast + 1 == pEnd)
+				{
+					while(pFirst < pLast && !(pivot < *++pFirst));
+				}
+				else
+				{
+					while(!(pivot < *++pFirst));
+				}
+				while(pFirst < pLast)
+				{
+					GAIA::ALGO::swap(*pFirst, *pLast);
+					while(pivot < *--pLast);
+					while(!(pivot < *++pFirst));
+				}
+				_DataType pPivot = pLast;
+				*pBegin = *pPivot;
+				*pPivot = pivot;
+				return pPivot;
+			}
+		};
+
 		template<typename _DataType> GAIA::GVOID bsort(_DataType pBegin, _DataType pEnd) // Bubble sort.
 		{
 			GAST(!!pBegin);
@@ -31,12 +459,36 @@ namespace GAIA
 		}
 		template<typename _DataType> GAIA::GVOID isort(_DataType pBegin, _DataType pEnd) // Insertion sort.
 		{
+			GAST(!!pBegin);
+			GAST(!!pEnd);
+			if(pBegin >= pEnd)
+				return;
+			GAIA::ALGO::SortImpl::InsertionSort(pBegin, pEnd + 1, *pBegin);
 		}
 		template<typename _DataType> GAIA::GVOID ssort(_DataType pBegin, _DataType pEnd) // Selection sort.
 		{
+			GAST(!!pBegin);
+			GAST(!!pEnd);
+			while(pBegin < pEnd)
+			{
+				_DataType pMin = pBegin;
+				for(_DataType pTemp = pBegin + 1; pTemp <= pEnd; ++pTemp)
+				{
+					if(*pTemp < *pMin)
+						pMin = pTemp;
+				}
+				if(pMin != pBegin)
+					GAIA::ALGO::swap(*pBegin, *pMin);
+				++pBegin;
+			}
 		}
 		template<typename _DataType> GAIA::GVOID hsort(_DataType pBegin, _DataType pEnd) // Heap sort.
 		{
+			GAST(!!pBegin);
+			GAST(!!pEnd);
+			if(pBegin >= pEnd)
+				return;
+			GAIA::ALGO::SortImpl::HeapSort(pBegin, pEnd + 1, *pBegin);
 		}
 		template<typename _DataType> GAIA::BL ksort(_DataType pBegin, _DataType pEnd) // Bucket sort.
 		{
@@ -75,12 +527,6 @@ namespace GAIA
 					*pTemp++ = x + nMin;
 			return GAIA::True;
 		}
-		template<typename _DataType> GAIA::GVOID esort(_DataType pBegin, _DataType pEnd) // External sort.
-		{
-			GAST(!!pBegin);
-			GAST(!!pEnd);
-			GAST(pBegin < pEnd);
-		}
 		template<typename _DataType> GAIA::GVOID qsort(_DataType pBegin, _DataType pEnd) // Quick sort.
 		{
 			GAST(!!pBegin);
@@ -90,36 +536,109 @@ namespace GAIA
 		#ifdef GAIA_USESTL
 			std::sort(pBegin, pEnd + 1);
 		#else
-			// quick sort optimize.
-			if(pEnd - pBegin < 16)
-				return bsort(pBegin, pEnd);
-			GAIA::ALGO::swap(*pEnd, *(pBegin + (pEnd - pBegin) / 2));
+			// Pattern-defeating quick sort, the block partition is used by the base type which compare is cheap.
+			GAIA::NUM sSize = GSCAST(GAIA::NUM)(pEnd - pBegin) + 1;
+			GAIA::ALGO::SortImpl::PdqSort(pBegin, pEnd + 1, GAIA::ALGO::SortImpl::Log2(sSize), GAIA::True, isbasetype(*pBegin), *pBegin);
+		#endif
+		}
+
+		/*!
+			@brief The unsigned key of the radix sort, the order of the keys is the same as the integers.
 
-			/* Standard quick sort algorithm. */
-			_DataType pCursor = pBegin;
-			_DataType pSplit = pBegin;
-			while(pCursor < pEnd)
+			@remarks The type which is not integer have no key, and GAIA::ALGO::rsort will return GAIA::False.
+		*/
+		template<typename _DataType> class RadixKey{public: static const GAIA::BL IS_INTEGER = GAIA::False; static GINL GAIA::U64 key(const _DataType& t){return 0;}};
+		template<> class RadixKey<GAIA::U8>{public: static const GAIA::BL IS_INTEGER = GAIA::True; static GINL GAIA::U64 key(const GAIA::U8& t){return t;}};
+		template<> class RadixKey<GAIA::U16>{public: static const GAIA::BL IS_INTEGER = GAIA::True; static GINL GAIA::U64 key(const GAIA::U16& t){return t;}};
+		template<> class RadixKey<GAIA::U32>{public: static const GAIA::BL IS_INTEGER = GAIA::True; static GINL GAIA::U64 key(const GAIA::U32& t){return t;}};
+		template<> class RadixKey<GAIA::U64>{public: static const GAIA::BL IS_INTEGER = GAIA::True; static GINL GAIA::U64 key(const GAIA::U64& t){return t;}};
+		template<> class RadixKey<GAIA::UM>{public: static const GAIA::BL IS_INTEGER = GAIA::True; static GINL GAIA::U64 key(const GAIA::UM& t){return t;}};
+		template<> class RadixKey<GAIA::N8>{public: static const GAIA::BL IS_INTEGER = GAIA::True; static GINL GAIA::U64 key(const GAIA::N8& t){return GSCAST(GAIA::U8)(t) ^ 0x80;}};
+		template<> class RadixKey<GAIA::N16>{public: static const GAIA::BL IS_INTEGER = GAIA::True; static GINL GAIA::U64 key(const GAIA::N16& t){return GSCAST(GAIA::U16)(t) ^ 0x8000;}};
+		template<> class RadixKey<GAIA::N32>{public: static const GAIA::BL IS_INTEGER = GAIA::True; static GINL GAIA::U64 key(const GAIA::N32& t){return GSCAST(GAIA::U32)(t) ^ 0x80000000;}};
+		template<> class RadixKey<GAIA::N64>{public: static const GAIA::BL IS_INTEGER = GAIA::True; static GINL GAIA::U64 key(const GAIA::N64& t){return GSCAST(GAIA::U64)(t) ^ 0x8000000000000000ULL;}};
+		template<> class RadixKey<GAIA::NM>{public: static const GAIA::BL IS_INTEGER = GAIA::True; static GINL GAIA::U64 key(const GAIA::NM& t){return (GSCAST(GAIA::U64)(t) ^ ((GAIA::U64)1 << (sizeof(GAIA::NM) * 8 - 1))) & (GAIA::U64)GSCAST(GAIA::UM)(-1);}};
+
+		/*!
+			@brief LSD radix sort of the integer elements, it sort 8 bits by a pass, and skip the pass of the same bits.
+
+			@return If the element type is not integer, return GAIA::False and nothing changed.
+
+			@remarks It need a temporary buffer of the same size as the range, and it is stable.
+		*/
+		template<typename _DataType, typename _ValueType> GAIA::BL rsort_impl(_DataType pBegin, GAIA::NUM sSize, const _ValueType&)
+		{
+			typedef GAIA::ALGO::RadixKey<_ValueType> __KeyType;
+			static const GAIA::NUM KEY_SIZE = sizeof(_ValueType);
+			static const GAIA::NUM RADIX = 256;
+			if(!__KeyType::IS_INTEGER)
+				return GAIA::False;
+
+			// Count all the digits by one pass.
+			GAIA::NUM counts[KEY_SIZE][RADIX];
+			for(GAIA::NUM x = 0; x < KEY_SIZE; ++x)
+			{
+				for(GAIA::NUM y = 0; y < RADIX; ++y)
+					counts[x][y] = 0;
+			}
+			for(GAIA::NUM x = 0; x < sSize; ++x)
 			{
-				if(*pCursor < *pEnd) // pEnd is the key.
+				GAIA::U64 uKey = __KeyType::key(*(pBegin + x));
+				for(GAIA::NUM y = 0; y < KEY_SIZE; ++y)
+					++counts[y][(uKey >> (y * 8)) & 0xFF];
+			}
+
+			// The passes write to the buffer and the range by turns.
+			_ValueType* pBuf = gnew _ValueType[sSize];
+			GAIA::BL bInBuf = GAIA::False;
+			for(GAIA::NUM x = 0; x < KEY_SIZE; ++x)
+			{
+				GAIA::NUM* pCount = counts[x];
+				if(pCount[(__KeyType::key(bInBuf ? pBuf[0] : *pBegin) >> (x * 8)) & 0xFF] == sSize)
+					continue;
+				GAIA::NUM sOffset = 0;
+				for(GAIA::NUM y = 0; y < RADIX; ++y)
+				{
+					GAIA::NUM sCount = pCount[y];
+					pCount[y] = sOffset;
+					sOffset += sCount;
+				}
+				if(bInBuf)
+				{
+					for(GAIA::NUM y = 0; y < sSize; ++y)
+						*(pBegin + pCount[(__KeyType::key(pBuf[y]) >> (x * 8)) & 0xFF]++) = pBuf[y];
+				}
+				else
 				{
-					GAIA::ALGO::swap(*pCursor, *pSplit);
-					++pSplit;
+					for(GAIA::NUM y = 0; y < sSize; ++y)
+					{
+						const _ValueType& t = *(pBegin + y);
+						pBuf[pCount[(__KeyType::key(t) >> (x * 8)) & 0xFF]++] = t;
+					}
 				}
-				++pCursor;
+				bInBuf = !bInBuf;
 			}
-			GAIA::ALGO::swap(*pSplit, *pEnd);
-			GAIA::ALGO::qsort(pBegin, pSplit - 1);
-			GAIA::ALGO::qsort(pSplit + 1, pEnd);
-		#endif
+			if(bInBuf)
+			{
+				for(GAIA::NUM x = 0; x < sSize; ++x)
+					*(pBegin + x) = pBuf[x];
+			}
+			gdel[] pBuf;
+			return GAIA::True;
+		}
+		template<typename _DataType> GAIA::BL rsort(_DataType pBegin, _DataType pEnd) // Radix sort.
+		{
+			GAST(!!pBegin);
+			GAST(!!pEnd);
+			if(pBegin > pEnd)
+				return GAIA::False;
+			return GAIA::ALGO::rsort_impl(pBegin, GSCAST(GAIA::NUM)(pEnd - pBegin) + 1, *pBegin);
 		}
 		template<typename _DataType> GAIA::GVOID sort(_DataType pBegin, _DataType pEnd) // Sort wrapper.
 		{
 			GAST(!!pBegin);
 			GAST(!!pEnd);
-			if(pEnd - pBegin < 10)
-				GAIA::ALGO::bsort(pBegin, pEnd);
-			else
-				GAIA::ALGO::qsort(pBegin, pEnd);
+			GAIA::ALGO::qsort(pBegin, pEnd);
 		}
 		template<typename _DataType> GAIA::BL issorted(_DataType pBegin, _DataType pEnd)
 		{
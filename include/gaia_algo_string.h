@@ -5,6 +5,7 @@
 #include "gaia_assert.h"
 #include "gaia_math_base.h"
 #include "gaia_algo_base.h"
+#include "gaia_algo_strsimd.h"
 
 namespace GAIA
 {
@@ -80,11 +81,24 @@ namespace GAIA
 		}
 		template<typename _DataType> _DataType gstrend(_DataType p)
 		{
+			typedef typename GAIA::ALGO::StrSimdTraits<_DataType>::__CharType __CharType;
+			if(GAIA::ALGO::StrSimd<__CharType>::IS_SIMD)
+			{
+				GAIA::ALGO::StrSimd<__CharType>::End(p);
+				return p;
+			}
 			while(*p != '\0') ++p;
 			return p;
 		}
 		template<typename _DataType1, typename _DataType2> _DataType1 gstrch(_DataType1 p, const _DataType2& c)
 		{
+			typedef typename GAIA::ALGO::StrSimdTraits<_DataType1>::__CharType __CharType;
+			if(GAIA::ALGO::StrSimd<__CharType>::IS_SIMD)
+			{
+				if(GAIA::ALGO::StrSimd<__CharType>::Ch(p, c))
+					return p;
+				return GNIL;
+			}
 			while(*p != '\0')
 			{
 				if(*p == c)
@@ -105,6 +119,14 @@ namespace GAIA
 		}
 		template<typename _DataType1, typename _DataType2> _DataType1 gstrchs(_DataType1 p, _DataType2 key)
 		{
+			typedef typename GAIA::ALGO::StrSimdTraits2<_DataType1, _DataType2>::__CharType __CharType;
+			GAIA::BL bFound;
+			if(GAIA::ALGO::StrSimd<__CharType>::IS_SIMD && GAIA::ALGO::StrSimd<__CharType>::Chs(p, key, bFound))
+			{
+				if(bFound)
+					return p;
+				return GNIL;
+			}
 			while(*p != '\0')
 			{
 				_DataType2 pTemp = key;
@@ -173,10 +195,23 @@ namespace GAIA
 			}
 			return GAIA::True;
 		}
-		template<typename _DataType> GAIA::NUM gstrlen(_DataType p){GAST(!!p); GAIA::NUM ret = 0; while(p[ret] != '\0') ret++; return ret;}
+		template<typename _DataType> GAIA::NUM gstrlen(_DataType p)
+		{
+			GAST(!!p);
+			typedef typename GAIA::ALGO::StrSimdTraits<_DataType>::__CharType __CharType;
+			if(GAIA::ALGO::StrSimd<__CharType>::IS_SIMD)
+				return GAIA::ALGO::StrSimd<__CharType>::Len(p);
+			GAIA::NUM ret = 0;
+			while(p[ret] != '\0')
+				ret++;
+			return ret;
+		}
 		template<typename _DataType> GAIA::NUM gstrlennil(_DataType p){if(p == GNIL) return 0; return GAIA::ALGO::gstrlen(p);}
 		template<typename _DataType1, typename _DataType2> GAIA::NUM gstrcnt(_DataType1 p, const _DataType2& key)
 		{
+			typedef typename GAIA::ALGO::StrSimdTraits<_DataType1>::__CharType __CharType;
+			if(GAIA::ALGO::StrSimd<__CharType>::IS_SIMD)
+				return GAIA::ALGO::StrSimd<__CharType>::Cnt(p, key);
 			GAIA::NUM ret = 0;
 			while(*p != '\0')
 			{
@@ -280,6 +315,9 @@ namespace GAIA
 		{
 			GAST(!!p1);
 			GAST(!!p2);
+			typedef typename GAIA::ALGO::StrSimdTraits2<_DataType1, _DataType2>::__CharType __CharType;
+			if(GAIA::ALGO::StrSimd<__CharType>::IS_SIMD)
+				GAIA::ALGO::StrSimd<__CharType>::Skip(p1, p2, GINVALID);
 			for(;;)
 			{
 				if(*p1 < *p2)
@@ -324,6 +362,9 @@ namespace GAIA
 		template<typename _DataType1, typename _DataType2, typename _SizeType>
 		GAIA::N32 gstrcmp(_DataType1 p1, _DataType2 p2, _SizeType size)
 		{
+			typedef typename GAIA::ALGO::StrSimdTraits2<_DataType1, _DataType2>::__CharType __CharType;
+			if(GAIA::ALGO::StrSimd<__CharType>::IS_SIMD && size > 0)
+				size -= GAIA::ALGO::StrSimd<__CharType>::Skip(p1, p2, GSCAST(GAIA::NUM)(size));
 			for(; size != 0; --size)
 			{
 				if(*p1 < *p2)
@@ -404,6 +445,13 @@ namespace GAIA
 		{
 			GAST(!!p1);
 			GAST(!!p2);
+			typedef typename GAIA::ALGO::StrSimdTraits2<_DataType1, _DataType2>::__CharType __CharType;
+			if(GAIA::ALGO::StrSimd<__CharType>::IS_SIMD)
+			{
+				if(GAIA::ALGO::StrSimd<__CharType>::Str(p1, p2))
+					return p1;
+				return GNIL;
+			}
 			while(*p1 != '\0')
 			{
 				_DataType1 po = p1;
@@ -532,6 +580,14 @@ namespace GAIA
 		template<typename _DataType1, typename _DataType2>
 		_DataType1 gstrdrop(_DataType1 p, _DataType2 pKeys)
 		{
+			typedef typename GAIA::ALGO::StrSimdTraits2<_DataType1, _DataType2>::__CharType __CharType;
+			GAIA::BL bFound;
+			if(GAIA::ALGO::StrSimd<__CharType>::IS_SIMD && GAIA::ALGO::StrSimd<__CharType>::Chs(p, pKeys, bFound))
+			{
+				if(bFound)
+					return p;
+				return GNIL;
+			}
 			while(*p != '\0')
 			{
 				_DataType2 p2 = pKeys;
@@ -0,0 +1,480 @@
+#ifndef		__GAIA_ALGO_STRSIMD_H__
+#define		__GAIA_ALGO_STRSIMD_H__
+
+#include "gaia_type.h"
+#include "gaia_assert.h"
+#include "gaia_algo_base.h"
+
+#if defined(GAIA_SIMD_AVX2)
+#	include <immintrin.h>
+#elif defined(GAIA_SIMD_SSE2)
+#	include <emmintrin.h>
+#endif
+
+namespace GAIA
+{
+	namespace ALGO
+	{
+		/*!
+			@brief The char type of a string type which have SIMD implementation.
+
+			@remarks Only the pointer of GAIA::CH and GAIA::WCH have SIMD implementation, the char type of other
+				string types (and all types when SIMD is not supported) is GAIA::GVOID.
+		*/
+		template<typename _DataType> class StrSimdTraits{public: typedef GAIA::GVOID __CharType;};
+	#ifdef GAIA_SIMD_SSE2
+		template<> class StrSimdTraits<GAIA::CH*>{public: typedef GAIA::CH __CharType;};
+		template<> class StrSimdTraits<const GAIA::CH*>{public: typedef GAIA::CH __CharType;};
+		template<> class StrSimdTraits<GAIA::WCH*>{public: typedef GAIA::WCH __CharType;};
+		template<> class StrSimdTraits<const GAIA::WCH*>{public: typedef GAIA::WCH __CharType;};
+	#endif
+
+		/*!
+			@brief The char type of two string types, it is GAIA::GVOID if they are different.
+		*/
+		template<typename _CharType1, typename _CharType2> class StrSimdSame{public: typedef GAIA::GVOID __CharType;};
+		template<typename _CharType> class StrSimdSame<_CharType, _CharType>{public: typedef _CharType __CharType;};
+		template<typename _DataType1, typename _DataType2> class StrSimdTraits2
+		{
+		public:
+			typedef typename StrSimdSame<typename StrSimdTraits<_DataType1>::__CharType, typename StrSimdTraits<_DataType2>::__CharType>::__CharType __CharType;
+		};
+
+		/*!
+			@brief The string functions of the types without SIMD implementation, never called.
+
+			@remarks The string functions check StrSimd<__CharType>::IS_SIMD before call, the members here only
+				make the calls compilable.
+		*/
+		class StrSimdNone : public GAIA::Base
+		{
+		public:
+			static const GAIA::BL IS_SIMD = GAIA::False;
+			static const GAIA::NUM MAX_KEY_COUNT = 0;
+		public:
+			template<typename _DataType> static GINL GAIA::NUM Len(const _DataType& p){return 0;}
+			template<typename _DataType> static GINL GAIA::GVOID End(_DataType& p){}
+			template<typename _DataType1, typename _DataType2> static GINL GAIA::BL Ch(_DataType1& p, const _DataType2& c){return GAIA::False;}
+			template<typename _DataType1, typename _DataType2> static GINL GAIA::BL Chs(_DataType1& p, const _DataType2& keys, GAIA::BL& bFound){return GAIA::False;}
+			template<typename _DataType1, typename _DataType2> static GINL GAIA::NUM Cnt(const _DataType1& p, const _DataType2& c){return 0;}
+			template<typename _DataType1, typename _DataType2> static GINL GAIA::NUM Skip(_DataType1& p1, _DataType2& p2, GAIA::NUM sMaxLen){return 0;}
+			template<typename _DataType1, typename _DataType2> static GINL GAIA::BL Str(_DataType1& p1, const _DataType2& p2){return GAIA::False;}
+		};
+
+	#ifdef GAIA_SIMD_SSE2
+		/*!
+			@brief A SIMD register of string elements.
+
+			@remarks It is the only place use the intrinsics, every compare function return a bit mask of the
+				bytes in block, so a matched element of sElementSize bytes set sElementSize bits.
+		*/
+		class StrSimdBlock : public GAIA::Base
+		{
+		public:
+		#if defined(GAIA_SIMD_AVX2)
+			static const GAIA::NUM BLOCK_SIZE = 32;
+		#else
+			static const GAIA::NUM BLOCK_SIZE = 16;
+		#endif
+			static const GAIA::NUM PAGE_SIZE = 4096;
+		public:
+			GINL StrSimdBlock(){}
+			GINL StrSimdBlock(const GAIA::GVOID* p)
+			{
+			#if defined(GAIA_SIMD_AVX2)
+				m_data = _mm256_loadu_si256(GRCAST(const __m256i*)(p));
+			#else
+				m_data = _mm_loadu_si128(GRCAST(const __m128i*)(p));
+			#endif
+			}
+			static GINL StrSimdBlock Fill(GAIA::U32 u, GAIA::NUM sElementSize)
+			{
+				StrSimdBlock ret;
+			#if defined(GAIA_SIMD_AVX2)
+				if(sElementSize == 1)
+					ret.m_data = _mm256_set1_epi8((GAIA::N8)u);
+				else if(sElementSize == 2)
+					ret.m_data = _mm256_set1_epi16((GAIA::N16)u);
+				else
+					ret.m_data = _mm256_set1_epi32((GAIA::N32)u);
+			#else
+				if(sElementSize == 1)
+					ret.m_data = _mm_set1_epi8((GAIA::N8)u);
+				else if(sElementSize == 2)
+					ret.m_data = _mm_set1_epi16((GAIA::N16)u);
+				else
+					ret.m_data = _mm_set1_epi32((GAIA::N32)u);
+			#endif
+				return ret;
+			}
+			GINL GAIA::U32 Equal(const StrSimdBlock& src, GAIA::NUM sElementSize) const
+			{
+			#if defined(GAIA_SIMD_AVX2)
+				__m256i v;
+				if(sElementSize == 1)
+					v = _mm256_cmpeq_epi8(m_data, src.m_data);
+				else if(sElementSize == 2)
+					v = _mm256_cmpeq_epi16(m_data, src.m_data);
+				else
+					v = _mm256_cmpeq_epi32(m_data, src.m_data);
+				return (GAIA::U32)_mm256_movemask_epi8(v);
+			#else
+				__m128i v;
+				if(sElementSize == 1)
+					v = _mm_cmpeq_epi8(m_data, src.m_data);
+				else if(sElementSize == 2)
+					v = _mm_cmpeq_epi16(m_data, src.m_data);
+				else
+					v = _mm_cmpeq_epi32(m_data, src.m_data);
+				return (GAIA::U32)_mm_movemask_epi8(v);
+			#endif
+			}
+			/*!
+				@brief Check a block load from p will cross the page, it may read a page not exist.
+			*/
+			static GINL GAIA::BL CrossPage(const GAIA::GVOID* p)
+			{
+				return (((GAIA::U64)p) & (PAGE_SIZE - 1)) > PAGE_SIZE - BLOCK_SIZE;
+			}
+		private:
+		#if defined(GAIA_SIMD_AVX2)
+			__m256i m_data;
+		#else
+			__m128i m_data;
+		#endif
+		};
+
+		/*!
+			@brief The string functions implemented by StrSimdBlock, for GAIA::CH and GAIA::WCH.
+
+			@remarks
+				The zero terminated strings are scanned by aligned blocks, a aligned block never cross the page,
+				so the bytes after the terminator in the same block can be readed safely.
+				Every function return the element index, the caller convert it to the return value of
+				the string function.
+		*/
+		template<typename _CharType> class StrSimd : public GAIA::Base
+		{
+		public:
+			static const GAIA::BL IS_SIMD = GAIA::True;
+			static const GAIA::NUM ELEMENT_SIZE = sizeof(_CharType);
+			static const GAIA::NUM BLOCK_COUNT = StrSimdBlock::BLOCK_SIZE / sizeof(_CharType);
+			static const GAIA::NUM MAX_KEY_COUNT = 8;
+		private:
+			class MatchZero
+			{
+			public:
+				GINL MatchZero(){m_zero = StrSimdBlock::Fill(0, ELEMENT_SIZE);}
+				GINL GAIA::U32 operator () (const StrSimdBlock& b) const{return b.Equal(m_zero, ELEMENT_SIZE);}
+				GINL GAIA::BL operator () (_CharType c) const{return c == '\0';}
+			private:
+				StrSimdBlock m_zero;
+			};
+			class MatchZeroOrChar
+			{
+			public:
+				GINL MatchZeroOrChar(_CharType c)
+				{
+					m_zero = StrSimdBlock::Fill(0, ELEMENT_SIZE);
+					m_ch = StrSimdBlock::Fill(GSCAST(GAIA::U32)(c), ELEMENT_SIZE);
+					m_c = c;
+				}
+				GINL GAIA::U32 operator () (const StrSimdBlock& b) const{return b.Equal(m_zero, ELEMENT_SIZE) | b.Equal(m_ch, ELEMENT_SIZE);}
+				GINL GAIA::BL operator () (_CharType c) const{return c == '\0' || c == m_c;}
+			private:
+				StrSimdBlock m_zero;
+				StrSimdBlock m_ch;
+				_CharType m_c;
+			};
+			class MatchZeroOrChars
+			{
+			public:
+				GINL MatchZeroOrChars(const _CharType* pKeys, GAIA::NUM sKeyCount)
+				{
+					GAST(sKeyCount <= MAX_KEY_COUNT);
+					m_zero = StrSimdBlock::Fill(0, ELEMENT_SIZE);
+					for(GAIA::NUM x = 0; x < sKeyCount; ++x)
+						m_keys[x] = StrSimdBlock::Fill(GSCAST(GAIA::U32)(pKeys[x]), ELEMENT_SIZE);
+					m_pKeys = pKeys;
+					m_sKeyCount = sKeyCount;
+				}
+				GINL GAIA::U32 operator () (const StrSimdBlock& b) const
+				{
+					GAIA::U32 ret = b.Equal(m_zero, ELEMENT_SIZE);
+					for(GAIA::NUM x = 0; x < m_sKeyCount; ++x)
+						ret |= b.Equal(m_keys[x], ELEMENT_SIZE);
+					return ret;
+				}
+				GINL GAIA::BL operator () (_CharType c) const
+				{
+					if(c == '\0')
+						return GAIA::True;
+					for(GAIA::NUM x = 0; x < m_sKeyCount; ++x)
+					{
+						if(c == m_pKeys[x])
+							return GAIA::True;
+					}
+					return GAIA::False;
+				}
+			private:
+				StrSimdBlock m_zero;
+				StrSimdBlock m_keys[MAX_KEY_COUNT];
+				const _CharType* m_pKeys;
+				GAIA::NUM m_sKeyCount;
+			};
+		public:
+			/*!
+				@brief Get the element count before the terminator.
+			*/
+			template<typename _DataType> static GINL GAIA::NUM Len(const _DataType& p)
+			{
+				return Scan(p, MatchZero());
+			}
+
+			/*!
+				@brief Move p to the terminator.
+			*/
+			template<typename _DataType> static GINL GAIA::GVOID End(_DataType& p)
+			{
+				p += Scan(p, MatchZero());
+			}
+
+			/*!
+				@brief Find the first element equal to c, if found, move p to it and return GAIA::True.
+			*/
+			template<typename _DataType1, typename _DataType2> static GINL GAIA::BL Ch(_DataType1& p, const _DataType2& c)
+			{
+				if(GSCAST(_DataType2)(GSCAST(_CharType)(c)) != c) // The c can't be a element, never equal.
+					return GAIA::False;
+				GAIA::NUM sIndex = Scan(p, MatchZeroOrChar(GSCAST(_CharType)(c)));
+				if(p[sIndex] == '\0')
+					return GAIA::False;
+				p += sIndex;
+				return GAIA::True;
+			}
+
+			/*!
+				@brief Find the first element equal to any element of keys, if found, move p to it.
+
+				@return If the key count is not above MAX_KEY_COUNT, return GAIA::True and bFound is the result,
+					or will return GAIA::False and the caller should find it by elements.
+			*/
+			template<typename _DataType1, typename _DataType2> static GINL GAIA::BL Chs(_DataType1& p, const _DataType2& keys, GAIA::BL& bFound)
+			{
+				const _CharType* pKeys = keys;
+				GAIA::NUM sKeyCount = 0;
+				while(pKeys[sKeyCount] != '\0')
+				{
+					if(++sKeyCount > MAX_KEY_COUNT)
+						return GAIA::False;
+				}
+				GAIA::NUM sIndex = Scan(p, MatchZeroOrChars(pKeys, sKeyCount));
+				bFound = p[sIndex] != '\0';
+				if(bFound)
+					p += sIndex;
+				return GAIA::True;
+			}
+
+			/*!
+				@brief Get the count of the elements equal to c.
+			*/
+			template<typename _DataType1, typename _DataType2> static GINL GAIA::NUM Cnt(const _DataType1& p, const _DataType2& c)
+			{
+				if(GSCAST(_DataType2)(GSCAST(_CharType)(c)) != c || c == '\0')
+					return 0;
+				return Count(p, GSCAST(_CharType)(c));
+			}
+
+			/*!
+				@brief Skip the same elements before the terminator of two strings.
+
+				@param sMaxLen [in] Specify the max element count skipped, GINVALID means no limit.
+
+				@return Return the skipped element count, p1 and p2 are moved to the first element which is different,
+					or is the terminator of both, or is the sMaxLen element.
+			*/
+			template<typename _DataType1, typename _DataType2> static GINL GAIA::NUM Skip(_DataType1& p1, _DataType2& p2, GAIA::NUM sMaxLen)
+			{
+				GAIA::NUM ret = Diff(p1, p2, sMaxLen);
+				if(ret == GINVALID)
+					ret = sMaxLen;
+				p1 += ret;
+				p2 += ret;
+				return ret;
+			}
+
+			/*!
+				@brief Find the first position of p2 in p1, if found, move p1 to it and return GAIA::True.
+			*/
+			template<typename _DataType1, typename _DataType2> static GINL GAIA::BL Str(_DataType1& p1, const _DataType2& p2)
+			{
+				GAIA::NUM sIndex = Find(p1, p2);
+				if(sIndex == GINVALID)
+					return GAIA::False;
+				p1 += sIndex;
+				return GAIA::True;
+			}
+		private:
+			static GINL GAIA::NUM Count(const _CharType* p, _CharType c)
+			{
+				if(!IsAligned(p))
+				{
+					GAIA::NUM ret = 0;
+					for(; *p != '\0'; ++p)
+					{
+						if(*p == c)
+							++ret;
+					}
+					return ret;
+				}
+				GAIA::NUM sOffset = GSCAST(GAIA::NUM)(((GAIA::U64)p) & (StrSimdBlock::BLOCK_SIZE - 1));
+				const GAIA::U8* pBlock = GRCAST(const GAIA::U8*)(p) - sOffset;
+				GAIA::U32 uSkip = ~(GAIA::U32)0 << sOffset;
+				MatchZero mz;
+				StrSimdBlock ch = StrSimdBlock::Fill(GSCAST(GAIA::U32)(c), ELEMENT_SIZE);
+				GAIA::NUM sBitCount = 0;
+				for(;;)
+				{
+					StrSimdBlock b(pBlock);
+					GAIA::U32 uZero = mz(b) & uSkip;
+					GAIA::U32 uCh = b.Equal(ch, ELEMENT_SIZE) & uSkip;
+					if(uZero != 0)
+					{
+						GAIA::U32 uBefore = (GAIA::U32)((((GAIA::U64)1) << GAIA::ALGO::gctz(uZero)) - 1);
+						return (sBitCount + GAIA::ALGO::gpopcount(uCh & uBefore)) / ELEMENT_SIZE;
+					}
+					if(uCh != 0)
+						sBitCount += GAIA::ALGO::gpopcount(uCh);
+					uSkip = ~(GAIA::U32)0;
+					pBlock += StrSimdBlock::BLOCK_SIZE;
+				}
+			}
+			/*!
+				@brief Find the first element which is different or is the terminator of both strings.
+
+				@param sMaxLen [in] Specify the max element count compared, GINVALID means no limit.
+
+				@return Return the element index, or GINVALID if the first sMaxLen elements are equal.
+			*/
+			static GINL GAIA::NUM Diff(const _CharType* p1, const _CharType* p2, GAIA::NUM sMaxLen)
+			{
+				MatchZero mz;
+				GAIA::NUM x = 0;
+				for(;;)
+				{
+					if(sMaxLen != GINVALID && sMaxLen - x < BLOCK_COUNT)
+						break;
+					if(StrSimdBlock::CrossPage(p1 + x) || StrSimdBlock::CrossPage(p2 + x))
+					{
+						// Compare by elements until the next block is in the page.
+						GAIA::NUM sEnd = x + BLOCK_COUNT;
+						for(; x < sEnd; ++x)
+						{
+							if(p1[x] != p2[x] || p1[x] == '\0')
+								return x;
+						}
+						continue;
+					}
+					StrSimdBlock b1(p1 + x);
+					StrSimdBlock b2(p2 + x);
+					GAIA::U32 uMask = ~b1.Equal(b2, ELEMENT_SIZE) | mz(b1);
+					if(StrSimdBlock::BLOCK_SIZE < 32)
+						uMask &= (GAIA::U32)((((GAIA::U64)1) << StrSimdBlock::BLOCK_SIZE) - 1);
+					if(uMask != 0)
+						return x + GAIA::ALGO::gctz(uMask) / ELEMENT_SIZE;
+					x += BLOCK_COUNT;
+				}
+				for(; x < sMaxLen; ++x)
+				{
+					if(p1[x] != p2[x] || p1[x] == '\0')
+						return x;
+				}
+				return GINVALID;
+			}
+			/*!
+				@brief Find the first position of p2 in p1.
+
+				@remarks The candidate positions are filtered by the first and the last element of p2 a block
+					a time, then compared by elements.
+			*/
+			static GINL GAIA::NUM Find(const _CharType* p1, const _CharType* p2)
+			{
+				GAIA::NUM sLen1 = Scan(p1, MatchZero());
+				GAIA::NUM sLen2 = Scan(p2, MatchZero());
+				if(sLen2 == 0)
+					return sLen1 > 0 ? 0 : GINVALID;
+				if(sLen2 > sLen1)
+					return GINVALID;
+				if(sLen2 == 1)
+				{
+					GAIA::NUM sIndex = Scan(p1, MatchZeroOrChar(p2[0]));
+					return p1[sIndex] == '\0' ? GINVALID : sIndex;
+				}
+				StrSimdBlock first = StrSimdBlock::Fill(GSCAST(GAIA::U32)(p2[0]), ELEMENT_SIZE);
+				StrSimdBlock last = StrSimdBlock::Fill(GSCAST(GAIA::U32)(p2[sLen2 - 1]), ELEMENT_SIZE);
+				GAIA::NUM sLast = sLen1 - sLen2; // The last candidate position.
+				GAIA::NUM x = 0;
+				for(; x + BLOCK_COUNT - 1 <= sLast; x += BLOCK_COUNT)
+				{
+					GAIA::U32 uMask = StrSimdBlock(p1 + x).Equal(first, ELEMENT_SIZE) &
+						StrSimdBlock(p1 + x + sLen2 - 1).Equal(last, ELEMENT_SIZE);
+					while(uMask != 0)
+					{
+						GAIA::NUM sBit = GAIA::ALGO::gctz(uMask);
+						GAIA::NUM sPos = x + sBit / ELEMENT_SIZE;
+						if(Same(p1 + sPos + 1, p2 + 1, sLen2 - 2))
+							return sPos;
+						uMask &= ~((GAIA::U32)((((GAIA::U64)1) << ELEMENT_SIZE) - 1) << sBit);
+					}
+				}
+				for(; x <= sLast; ++x)
+				{
+					if(p1[x] == p2[0] && p1[x + sLen2 - 1] == p2[sLen2 - 1] && Same(p1 + x + 1, p2 + 1, sLen2 - 2))
+						return x;
+				}
+				return GINVALID;
+			}
+			static GINL GAIA::BL IsAligned(const _CharType* p){return (((GAIA::U64)p) & (ELEMENT_SIZE - 1)) == 0;}
+			static GINL GAIA::BL Same(const _CharType* p1, const _CharType* p2, GAIA::NUM sLen)
+			{
+				for(GAIA::NUM x = 0; x < sLen; ++x)
+				{
+					if(p1[x] != p2[x])
+						return GAIA::False;
+				}
+				return GAIA::True;
+			}
+			template<typename _MatchType> static GINL GAIA::NUM Scan(const _CharType* p, const _MatchType& m)
+			{
+				if(!IsAligned(p))
+				{
+					// The elements not aligned will be splited by the aligned blocks.
+					GAIA::NUM x = 0;
+					while(!m(p[x]))
+						++x;
+					return x;
+				}
+				GAIA::NUM sOffset = GSCAST(GAIA::NUM)(((GAIA::U64)p) & (StrSimdBlock::BLOCK_SIZE - 1));
+				const GAIA::U8* pBlock = GRCAST(const GAIA::U8*)(p) - sOffset;
+				GAIA::U32 uMask = m(StrSimdBlock(pBlock)) >> sOffset;
+				if(uMask != 0)
+					return GAIA::ALGO::gctz(uMask) / ELEMENT_SIZE;
+				GAIA::NUM ret = (StrSimdBlock::BLOCK_SIZE - sOffset) / ELEMENT_SIZE;
+				for(;;)
+				{
+					pBlock += StrSimdBlock::BLOCK_SIZE;
+					uMask = m(StrSimdBlock(pBlock));
+					if(uMask != 0)
+						return ret + GAIA::ALGO::gctz(uMask) / ELEMENT_SIZE;
+					ret += BLOCK_COUNT;
+				}
+			}
+		};
+	#else
+		template<typename _CharType> class StrSimd : public StrSimdNone{};
+	#endif
+		template<> class StrSimd<GAIA::GVOID> : public StrSimdNone{};
+	}
+}
+
+#endif
@@ -0,0 +1,190 @@
+#ifndef		__GAIA_ALGO_SUFFIX_H__
+#define		__GAIA_ALGO_SUFFIX_H__
+
+#include "gaia_type.h"
+#include "gaia_assert.h"
+
+namespace GAIA
+{
+	namespace ALGO
+	{
+		/*!
+			@brief The implementation of GAIA::ALGO::suffixarray.
+
+			@remarks
+				It is the SA-IS algorithm, the suffixes are classified to L type and S type, the sorted LMS suffixes
+				induce the order of all suffixes. The LMS substrings are named by the induced order, if the names are
+				not unique the reduced string is sorted recursively. It run in linear time, and use the suffix array
+				as the buffer of the reduced string.
+		*/
+		class SuffixImpl
+		{
+		public:
+			template<typename _DataType, typename _SizeType> static GAIA::GVOID SAIS(const _DataType* p, _SizeType* pSA, const _SizeType& size, const _SizeType& k)
+			{
+				const _SizeType EMPTY = (_SizeType)GINVALID;
+
+				// Classify the suffixes, 1 is S type.
+				GAIA::U8* pType = gnew GAIA::U8[size];
+				pType[size - 1] = 1;
+				for(_SizeType x = size - 1; x > 0; --x)
+					pType[x - 1] = (p[x - 1] < p[x] || (p[x - 1] == p[x] && pType[x] != 0)) ? 1 : 0;
+
+				// Sort the LMS substrings.
+				_SizeType* pBucket = gnew _SizeType[k];
+				GetBuckets(p, pBucket, size, k, GAIA::True);
+				for(_SizeType x = 0; x < size; ++x)
+					pSA[x] = EMPTY;
+				for(_SizeType x = 1; x < size; ++x)
+				{
+					if(IsLMS(pType, x))
+						pSA[--pBucket[p[x]]] = x;
+				}
+				InduceL(p, pSA, pType, pBucket, size, k);
+				InduceS(p, pSA, pType, pBucket, size, k);
+
+				// Compact the sorted LMS substrings to the front, and name them.
+				_SizeType sLMSCount = 0;
+				for(_SizeType x = 0; x < size; ++x)
+				{
+					if(IsLMS(pType, pSA[x]))
+						pSA[sLMSCount++] = pSA[x];
+				}
+				for(_SizeType x = sLMSCount; x < size; ++x)
+					pSA[x] = EMPTY;
+				_SizeType sName = 0;
+				_SizeType sPrev = EMPTY;
+				for(_SizeType x = 0; x < sLMSCount; ++x)
+				{
+					_SizeType sPos = pSA[x];
+					GAIA::BL bDiff = GAIA::False;
+					for(_SizeType d = 0; d < size; ++d)
+					{
+						if(sPrev == EMPTY || sPos + d == size || sPrev + d == size ||
+							p[sPos + d] != p[sPrev + d] || pType[sPos + d] != pType[sPrev + d])
+						{
+							bDiff = GAIA::True;
+							break;
+						}
+						if(d > 0 && (IsLMS(pType, sPos + d) || IsLMS(pType, sPrev + d)))
+							break;
+					}
+					if(bDiff)
+					{
+						++sName;
+						sPrev = sPos;
+					}
+					pSA[sLMSCount + sPos / 2] = sName - 1;
+				}
+				for(_SizeType x = size - 1, y = size - 1; x >= sLMSCount; --x)
+				{
+					if(pSA[x] != EMPTY)
+						pSA[y--] = pSA[x];
+				}
+
+				// Sort the LMS suffixes, recursively if the names are not unique.
+				_SizeType* pReduced = pSA + size - sLMSCount;
+				if(sName < sLMSCount)
+					SAIS(GCCAST(const _SizeType*)(pReduced), pSA, sLMSCount, sName);
+				else
+				{
+					for(_SizeType x = 0; x < sLMSCount; ++x)
+						pSA[pReduced[x]] = x;
+				}
+
+				// Induce the suffix array from the sorted LMS suffixes.
+				GetBuckets(p, pBucket, size, k, GAIA::True);
+				for(_SizeType x = 1, y = 0; x < size; ++x)
+				{
+					if(IsLMS(pType, x))
+						pReduced[y++] = x;
+				}
+				for(_SizeType x = 0; x < sLMSCount; ++x)
+					pSA[x] = pReduced[pSA[x]];
+				for(_SizeType x = sLMSCount; x < size; ++x)
+					pSA[x] = EMPTY;
+				for(_SizeType x = sLMSCount; x > 0; --x)
+				{
+					_SizeType sPos = pSA[x - 1];
+					pSA[x - 1] = EMPTY;
+					pSA[--pBucket[p[sPos]]] = sPos;
+				}
+				InduceL(p, pSA, pType, pBucket, size, k);
+				InduceS(p, pSA, pType, pBucket, size, k);
+
+				gdel[] pBucket;
+				gdel[] pType;
+			}
+		private:
+			template<typename _SizeType> static GINL GAIA::BL IsLMS(const GAIA::U8* pType, const _SizeType& index)
+			{
+				return index != (_SizeType)GINVALID && index > 0 && pType[index] != 0 && pType[index - 1] == 0;
+			}
+			template<typename _DataType, typename _SizeType> static GINL GAIA::GVOID GetBuckets(const _DataType* p, _SizeType* pBucket, const _SizeType& size, const _SizeType& k, GAIA::BL bEnd)
+			{
+				for(_SizeType x = 0; x < k; ++x)
+					pBucket[x] = 0;
+				for(_SizeType x = 0; x < size; ++x)
+					++pBucket[p[x]];
+				_SizeType sSum = 0;
+				for(_SizeType x = 0; x < k; ++x)
+				{
+					sSum += pBucket[x];
+					pBucket[x] = bEnd ? sSum : sSum - pBucket[x];
+				}
+			}
+			template<typename _DataType, typename _SizeType> static GINL GAIA::GVOID InduceL(const _DataType* p, _SizeType* pSA, const GAIA::U8* pType, _SizeType* pBucket, const _SizeType& size, const _SizeType& k)
+			{
+				GetBuckets(p, pBucket, size, k, GAIA::False);
+				for(_SizeType x = 0; x < size; ++x)
+				{
+					_SizeType sPos = pSA[x];
+					if(sPos != (_SizeType)GINVALID && sPos > 0 && pType[sPos - 1] == 0)
+						pSA[pBucket[p[sPos - 1]]++] = sPos - 1;
+				}
+			}
+			template<typename _DataType, typename _SizeType> static GINL GAIA::GVOID InduceS(const _DataType* p, _SizeType* pSA, const GAIA::U8* pType, _SizeType* pBucket, const _SizeType& size, const _SizeType& k)
+			{
+				GetBuckets(p, pBucket, size, k, GAIA::True);
+				for(_SizeType x = size; x > 0; --x)
+				{
+					_SizeType sPos = pSA[x - 1];
+					if(sPos != (_SizeType)GINVALID && sPos > 0 && pType[sPos - 1] != 0)
+						pSA[--pBucket[p[sPos - 1]]] = sPos - 1;
+				}
+			}
+		};
+
+		/*!
+			@brief Build the suffix array of a string.
+
+			@param p [in] Specify the string, the elements are integers in [0, k).
+				The last element must be the unique smallest element, usually it is 0.
+
+			@param size [in] Specify the element count of p.
+
+			@param k [in] Specify the alphabet size.
+
+			@param pSA [out] Used for saving the suffix array, it has size elements.
+				pSA[x] is the start index of the x-th smallest suffix.
+
+			@remarks It use the SA-IS algorithm, the time is O(size), and the extra memory is a type byte per element and k bucket counts.
+		*/
+		template<typename _DataType, typename _SizeType> GAIA::GVOID suffixarray(const _DataType* p, const _SizeType& size, const _SizeType& k, _SizeType* pSA)
+		{
+			GAST(p != GNIL);
+			GAST(pSA != GNIL);
+			GAST(k > 0);
+			if(size <= 0)
+				return;
+			if(size == 1)
+			{
+				pSA[0] = 0;
+				return;
+			}
+			GAIA::ALGO::SuffixImpl::SAIS(p, pSA, size, k);
+		}
+	}
+}
+
+#endif
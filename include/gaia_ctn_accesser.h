@@ -4,6 +4,7 @@
 #include "gaia_type.h"
 #include "gaia_assert.h"
 #include "gaia_fsys_filebase.h"
+#include "gaia_ctn_accesserpager.h"
 
 extern GAIA::CH g_gaia_appdocdir[GAIA::MAXPL];
 
@@ -136,8 +137,8 @@ namespace GAIA
 			};
 		public:
 			GINL Accesser(){this->init();}
-			GINL Accesser(GAIA::N32 n){GAST(n == GNIL); this->operator = (n);}
-			GINL Accesser(const __MyType& src){this->operator = (src);}
+			GINL Accesser(GAIA::N32 n){GAST(n == GNIL); this->init();}
+			GINL Accesser(const __MyType& src){this->init(); this->operator = (src);}
 			GINL ~Accesser(){this->destroy();}
 			GINL GAIA::BL bindmem(_DataType* p, const _SizeType& size, GAIA::UM atm)
 			{
@@ -160,9 +161,29 @@ namespace GAIA
 				m_atm = atm;
 				return GAIA::True;
 			}
-			GINL GAIA::BL bindfile(GAIA::FSYS::FileBase* pFile, GAIA::UM atm)
+			/*!
+				@brief Bind the accesser to a file.
+
+				@param pFile [in] Specify the file, if it is GNIL, a temporary file is created and the accesser is expandable.
+
+				@param atm [in] Specify the access type mask.
+
+				@param bMapping [in] Specify map the file to the memory if the file has a native handle.
+					Otherwise the file is accessed by a LRU page cache.
+
+				@param sPageCount [in] Specify the page count of the page cache, see GAIA::CTN::AccesserPager.
+
+				@remarks
+					The modified elements are written to the file when the last copy of the accesser is destroyed, or by
+					Accesser::flush. The page cache write back by the file, so the file must not be closed before it.
+					The mapped file could be larger than the accesser after growing, Accesser::flush cut it to the size,
+					and the last copy of the accesser cut it too if the file is not closed, so the file must not be released
+					before it. Only the temporary file created when pFile is GNIL could be released before the accesser.
+			*/
+			GINL GAIA::BL bindfile(GAIA::FSYS::FileBase* pFile, GAIA::UM atm, GAIA::BL bMapping = GAIA::True, GAIA::NUM sPageCount = GAIA::CTN::AccesserPager::DEFAULT_PAGE_COUNT)
 			{
-				if(pFile == GNIL)
+				GAIA::BL bTemporary = pFile == GNIL;
+				if(bTemporary)
 				{
 					GAST(atm | ACCESS_TYPE_WRITE);
 					this->expandable(GAIA::True);
@@ -186,6 +207,13 @@ namespace GAIA
 				GAST(pFile->IsOpen());
 				if(!pFile->IsOpen())
 					return GAIA::False;
+				m_pager = gnew GAIA::CTN::AccesserPager;
+				if(!m_pager->Open(pFile, (atm & ACCESS_TYPE_WRITE) != 0, bMapping, sPageCount, bTemporary))
+				{
+					m_pager->drop_ref();
+					m_pager = GNIL;
+					return GAIA::False;
+				}
 				m_file = pFile;
 				m_size = (_SizeType)pFile->Size();
 				m_bindtype = BIND_TYPE_FILE;
@@ -197,9 +225,27 @@ namespace GAIA
 			GINL GAIA::BL isbinded() const{return m_bindtype != BIND_TYPE_INVALID;}
 			GINL _DataType* bindmem() const{return m_p;}
 			GINL GAIA::FSYS::FileBase* bindfile() const{return m_file;}
+			GINL GAIA::CTN::AccesserPager* bindpager() const{return m_pager;}
+			GINL GAIA::BL flush()
+			{
+				if(m_pager == GNIL)
+					return GAIA::True;
+				return m_pager->Flush();
+			}
+			GINL GAIA::BL advise(GAIA::CTN::AccesserPager::ADVISE_TYPE advise)
+			{
+				if(m_pager == GNIL)
+					return GAIA::False;
+				return m_pager->Advise(advise);
+			}
 			GINL GAIA::BL empty() const{if(this->expandable() && m_index >= 0) return GAIA::False; return !this->is_valid_index(m_index);}
 			GINL GAIA::GVOID destroy()
 			{
+				if(m_pager != GNIL)
+				{
+					m_pager->drop_ref();
+					m_pager = GNIL;
+				}
 				m_bindtype = BIND_TYPE_INVALID;
 				m_atm = ACCESS_TYPE_INVALID;
 				m_p = GNIL;
@@ -244,10 +290,15 @@ namespace GAIA
 			GINL ConstNode operator * () const{return (*this)[0];}
 			GINL Node operator [] (const _SizeType& index){Node n; n.m_acc = this; n.m_index = index; return n;}
 			GINL ConstNode operator [] (const _SizeType& index) const{ConstNode n; n.m_acc = this; n.m_index = index; return n;}
-			GINL __MyType& operator = (GAIA::N32 n){this->init(); return *this;}
+			GINL __MyType& operator = (GAIA::N32 n){this->destroy(); this->init(); return *this;}
 			GINL __MyType& operator = (const __MyType& src)
 			{
 				GAST(&src != this);
+				if(src.m_pager != GNIL)
+					src.m_pager->rise_ref();
+				if(m_pager != GNIL)
+					m_pager->drop_ref();
+				m_pager = src.m_pager;
 				m_bindtype = src.m_bindtype;
 				m_atm = src.m_atm;
 				m_p = src.m_p;
@@ -387,6 +438,11 @@ namespace GAIA
 			template<typename _ParamDataType, typename _ParamSizeType, typename _ParamExtendType>
 				GAIA::BL convert_from(const GAIA::CTN::Accesser<_ParamDataType, _ParamSizeType, _ParamExtendType>& src)
 			{
+				if(src.bindpager() != GNIL)
+					src.bindpager()->rise_ref();
+				if(m_pager != GNIL)
+					m_pager->drop_ref();
+				m_pager = src.bindpager();
 				m_bindtype = GSCAST(__MyType::BIND_TYPE)(src.bindtype());
 				m_atm = src.access_type_mask();
 				m_p = GRCAST(_DataType*)(src.bindmem());
@@ -449,35 +505,24 @@ namespace GAIA
 					break;
 				case BIND_TYPE_FILE:
 					{
-						if(m_file->Tell() != pracoffset)
+						if(pracsize < size)
 						{
-							if(!m_file->Seek(pracoffset, SEEK_TYPE_BEGIN))
+							if(this->expandable())
 							{
-								GASTFALSE;
-								return GINVALID;
+								if(!this->expandfile(pracoffset + size))
+									return GINVALID;
+								pracsize = size;
 							}
+							else if(pracsize == 0)
+								return 0;
 						}
-						if(pracsize == size)
-						{
-							m_index += size / this->stride();
-							return GSCAST(_SizeType)(m_file->Write(p, size));
-						}
-						else if(pracsize < size)
+						if(!m_pager->Write(pracoffset, p, pracsize))
 						{
-							if(this->expandable())
-							{
-								this->expandfile(pracoffset + size);
-								m_index += size / this->stride();
-								return GSCAST(_SizeType)(m_file->Write(p, size));
-							}
-							else
-							{
-								if(pracsize == 0)
-									return 0;
-								m_index += pracsize / this->stride();
-								return GSCAST(_SizeType)(m_file->Write(p, pracsize));
-							}
+							GASTFALSE;
+							return GINVALID;
 						}
+						m_index += pracsize / this->stride();
+						return pracsize;
 					}
 					break;
 				default:
@@ -512,16 +557,13 @@ namespace GAIA
 					break;
 				case BIND_TYPE_FILE:
 					{
-						if(m_file->Tell() != pracoffset)
+						if(!m_pager->Read(pracoffset, p, pracsize))
 						{
-							if(!m_file->Seek(pracoffset, SEEK_TYPE_BEGIN))
-							{
-								GASTFALSE;
-								return GINVALID;
-							}
+							GASTFALSE;
+							return GINVALID;
 						}
 						m_index += pracsize / this->stride();
-						return GSCAST(_SizeType)(m_file->Read(p, pracsize));
+						return pracsize;
 					}
 					break;
 				default:
@@ -537,6 +579,7 @@ namespace GAIA
 			GINL GAIA::GVOID init()
 			{
 				m_expandable = GAIA::False;
+				m_pager = GNIL;
 				this->destroy();
 			}
 			GINL GAIA::BL is_valid_index(const _SizeType& index) const
@@ -569,7 +612,8 @@ namespace GAIA
 							break;
 						case BIND_TYPE_FILE:
 							{
-								this->expandfile(pracoffset + sizeof(_DataType));
+								if(!this->expandfile(pracoffset + sizeof(_DataType)))
+									return GAIA::False;
 							}
 							break;
 						default:
@@ -593,15 +637,10 @@ namespace GAIA
 				case BIND_TYPE_FILE:
 					{
 						_SizeType pracoffset = this->practice_offset(m_index + index);
-						if(m_file->Tell() != pracoffset)
-						{
-							if(!m_file->Seek(pracoffset, SEEK_TYPE_BEGIN))
-							{
-								GASTFALSE;
-								return GAIA::False;
-							}
-						}
-						if(m_file->Write(&src, sizeof(src)) != sizeof(src))
+						GAIA::U8* p = m_pager->Lookup(pracoffset, sizeof(src), GAIA::True);
+						if(p != GNIL)
+							*GRCAST(_DataType*)(p) = src;
+						else if(!m_pager->Write(pracoffset, &src, sizeof(src)))
 						{
 							GASTFALSE;
 							return GAIA::False;
@@ -632,15 +671,10 @@ namespace GAIA
 				case BIND_TYPE_FILE:
 					{
 						_SizeType pracoffset = this->practice_offset(m_index + index);
-						if(m_file->Tell() != pracoffset)
-						{
-							if(!m_file->Seek(pracoffset, SEEK_TYPE_BEGIN))
-							{
-								GASTFALSE;
-								return GAIA::False;
-							}
-						}
-						if(m_file->Read(&dst, sizeof(dst)) != sizeof(dst))
+						const GAIA::U8* p = m_pager->Lookup(pracoffset, sizeof(dst), GAIA::False);
+						if(p != GNIL)
+							dst = *GRCAST(const _DataType*)(p);
+						else if(!m_pager->Read(pracoffset, &dst, sizeof(dst)))
 						{
 							GASTFALSE;
 							return GAIA::False;
@@ -669,16 +703,20 @@ namespace GAIA
 				m_p = pNew;
 				m_size = newsize;
 			}
-			GINL GAIA::GVOID expandfile(const _SizeType& newsize)
+			GINL GAIA::BL expandfile(const _SizeType& newsize)
 			{
 				GAST(newsize > this->size());
+				if(!m_pager->Reserve(newsize))
+					return GAIA::False;
 				m_size = newsize;
+				return GAIA::True;
 			}
 		private:
 			BIND_TYPE m_bindtype;
 			GAIA::UM m_atm; // atm means access type mask.
 			_DataType* m_p;
 			GAIA::FSYS::FileBase* m_file;
+			GAIA::CTN::AccesserPager* m_pager;
 			_SizeType m_size;
 			_SizeType m_offset;
 			_SizeType m_stride;
@@ -0,0 +1,502 @@
+#ifndef 	__GAIA_CTN_ACCESSERPAGER_H__
+#define 	__GAIA_CTN_ACCESSERPAGER_H__
+
+#include "gaia_type.h"
+#include "gaia_assert.h"
+#include "gaia_algo_memory.h"
+#include "gaia_fsys_filebase.h"
+
+#include <stdio.h>
+
+#if GAIA_OS == GAIA_OS_WINDOWS
+#	include <windows.h>
+#	include <io.h>
+#else
+#	include <sys/mman.h>
+#	include <unistd.h>
+#endif
+
+namespace GAIA
+{
+	namespace CTN
+	{
+		/*!
+			@brief The file backend of GAIA::CTN::Accesser.
+
+			@remarks
+				If the file has a native handle, the whole file is mapped to the memory, and it grow by resizing the file
+				and mapping it again. Otherwise the file is cached by a LRU list of fixed size pages, the dirty pages are
+				written back when they are evicted or flushed.
+				The pager is shared by the copies of a accesser, so it is reference counted.
+		*/
+		class AccesserPager : public GAIA::RefObject
+		{
+		public:
+			static const GAIA::N64 CACHE_PAGE_SHIFT = 16; // The page size of the page cache is 64KB.
+			static const GAIA::N64 CACHE_PAGE_SIZE = 1 << CACHE_PAGE_SHIFT;
+			static const GAIA::NUM DEFAULT_PAGE_COUNT = 256;
+		public:
+			GAIA_ENUM_BEGIN(ADVISE_TYPE)
+				ADVISE_TYPE_NORMAL,
+				ADVISE_TYPE_SEQUENTIAL,
+				ADVISE_TYPE_RANDOM,
+				ADVISE_TYPE_WILLNEED,
+			GAIA_ENUM_END(ADVISE_TYPE)
+		private:
+			class Page : public GAIA::Base
+			{
+			public:
+				GAIA::N64 nIndex;
+				GAIA::U8* p;
+				Page* pPrev; // The LRU list, the head is the most recently used.
+				Page* pNext;
+				Page* pHashNext;
+				GAIA::BL bDirty;
+			};
+		public:
+			GINL AccesserPager(){this->init();}
+			GINL ~AccesserPager()
+			{
+				// The mapping is not depend on the file, so the file could be closed before the pager.
+				// If the file is still open, the reserved tail of the mapped file is cut to the size,
+				// and the dirty pages are written back.
+				this->unmap();
+				GAIA::BL bFileAlive = m_pFile != GNIL && m_bWrite && !m_bTemporary && m_pFile->IsOpen();
+				if(m_bMapping && bFileAlive && m_pFile->Size() > m_nSize)
+				{
+					m_pFile->Flush();
+					m_pFile->Resize(m_nSize);
+				}
+				if(m_pPages != GNIL)
+				{
+					if(bFileAlive)
+						this->writeback();
+					gdel[] m_pPages;
+					gdel[] m_pPageBuf;
+					gdel[] m_ppBuckets;
+				}
+			}
+
+			/*!
+				@brief Bind the pager to a opened file.
+
+				@param pFile [in] Specify the file.
+
+				@param bWrite [in] Specify the elements will be written or not.
+
+				@param bMapping [in] Specify use the memory mapping if the file has a native handle.
+
+				@param sPageCount [in] Specify the page count of the page cache when the file is not mapped.
+
+				@param bTemporary [in] Specify the file is a temporary file which could be released before the pager,
+					the file is not accessed when the pager is released.
+					Call Flush before the pager released if the data of a temporary file is needed.
+			*/
+			GINL GAIA::BL Open(GAIA::FSYS::FileBase* pFile, GAIA::BL bWrite, GAIA::BL bMapping, GAIA::NUM sPageCount, GAIA::BL bTemporary = GAIA::False)
+			{
+				GAST(!!pFile);
+				GAST(m_pFile == GNIL);
+				if(pFile == GNIL || m_pFile != GNIL)
+					return GAIA::False;
+				m_pFile = pFile;
+				m_bWrite = bWrite;
+				m_bTemporary = bTemporary;
+				m_nSize = pFile->Size();
+				if(bMapping && pFile->GetHandle() != GNIL)
+				{
+					m_bMapping = GAIA::True;
+					if(m_nSize > 0)
+						return this->map(m_nSize);
+					return GAIA::True;
+				}
+				if(sPageCount < 1)
+					sPageCount = 1;
+				m_sPageCount = sPageCount;
+				m_pPages = gnew Page[sPageCount];
+				m_pPageBuf = gnew GAIA::U8[GSCAST(GAIA::N64)(sPageCount) * CACHE_PAGE_SIZE];
+				for(m_sBucketMask = 1; m_sBucketMask < sPageCount * 2; m_sBucketMask *= 2)
+					;
+				m_ppBuckets = gnew Page*[m_sBucketMask];
+				for(GAIA::NUM x = 0; x < m_sBucketMask; ++x)
+					m_ppBuckets[x] = GNIL;
+				--m_sBucketMask;
+				for(GAIA::NUM x = 0; x < sPageCount; ++x)
+				{
+					Page& page = m_pPages[x];
+					page.nIndex = GINVALID;
+					page.p = m_pPageBuf + GSCAST(GAIA::N64)(x) * CACHE_PAGE_SIZE;
+					page.pPrev = GNIL;
+					page.pNext = m_pFree;
+					page.pHashNext = GNIL;
+					page.bDirty = GAIA::False;
+					m_pFree = &page;
+				}
+				return GAIA::True;
+			}
+			GINL GAIA::FSYS::FileBase* GetFile() const{return m_pFile;}
+			GINL GAIA::BL IsMapping() const{return m_bMapping;}
+			GINL GAIA::N64 Size() const{return m_nSize;}
+
+			/*!
+				@brief Get the pointer of a range of bytes.
+
+				@return If the range is in one page, return the pointer, or will return GNIL, and the range should be accessed by
+					AccesserPager::Read and AccesserPager::Write.
+
+				@remarks The range must be in the size of the pager, and the pointer is invalid after the next call of the pager.
+			*/
+			GINL GAIA::U8* Lookup(GAIA::N64 nOffset, GAIA::N64 nSize, GAIA::BL bWrite)
+			{
+				GAST(nOffset >= 0 && nOffset + nSize <= m_nSize);
+				if(m_pMap != GNIL)
+					return m_pMap + nOffset;
+				GAIA::N64 nIndex = nOffset >> CACHE_PAGE_SHIFT;
+				if(((nOffset + nSize - 1) >> CACHE_PAGE_SHIFT) != nIndex)
+					return GNIL;
+				Page* pPage = m_pLast;
+				if(pPage == GNIL || pPage->nIndex != nIndex)
+				{
+					pPage = this->getpage(nIndex);
+					if(pPage == GNIL)
+						return GNIL;
+				}
+				if(bWrite)
+					pPage->bDirty = GAIA::True;
+				return pPage->p + (nOffset & (CACHE_PAGE_SIZE - 1));
+			}
+			GINL GAIA::BL Read(GAIA::N64 nOffset, GAIA::GVOID* p, GAIA::N64 nSize)
+			{
+				GAST(nOffset >= 0 && nOffset + nSize <= m_nSize);
+				if(m_pMap != GNIL)
+				{
+					GAIA::ALGO::gmemcpy(p, m_pMap + nOffset, nSize);
+					return GAIA::True;
+				}
+				GAIA::U8* pDst = GSCAST(GAIA::U8*)(p);
+				while(nSize > 0)
+				{
+					GAIA::N64 nPart = GAIA::ALGO::gmin(nSize, CACHE_PAGE_SIZE - (nOffset & (CACHE_PAGE_SIZE - 1)));
+					const GAIA::U8* pSrc = this->Lookup(nOffset, nPart, GAIA::False);
+					if(pSrc == GNIL)
+						return GAIA::False;
+					GAIA::ALGO::gmemcpy(pDst, pSrc, nPart);
+					pDst += nPart;
+					nOffset += nPart;
+					nSize -= nPart;
+				}
+				return GAIA::True;
+			}
+			GINL GAIA::BL Write(GAIA::N64 nOffset, const GAIA::GVOID* p, GAIA::N64 nSize)
+			{
+				GAST(m_bWrite);
+				GAST(nOffset >= 0 && nOffset + nSize <= m_nSize);
+				if(m_pMap != GNIL)
+				{
+					GAIA::ALGO::gmemcpy(m_pMap + nOffset, p, nSize);
+					return GAIA::True;
+				}
+				const GAIA::U8* pSrc = GSCAST(const GAIA::U8*)(p);
+				while(nSize > 0)
+				{
+					GAIA::N64 nPart = GAIA::ALGO::gmin(nSize, CACHE_PAGE_SIZE - (nOffset & (CACHE_PAGE_SIZE - 1)));
+					GAIA::U8* pDst = this->Lookup(nOffset, nPart, GAIA::True);
+					if(pDst == GNIL)
+						return GAIA::False;
+					GAIA::ALGO::gmemcpy(pDst, pSrc, nPart);
+					pSrc += nPart;
+					nOffset += nPart;
+					nSize -= nPart;
+				}
+				return GAIA::True;
+			}
+
+			/*!
+				@brief Grow the size of the pager.
+
+				@remarks The mapped file is resized by the capacity which is grown by double, so the file could be larger
+					than the size of the pager until AccesserPager::Flush or the pager is released.
+			*/
+			GINL GAIA::BL Reserve(GAIA::N64 nSize)
+			{
+				GAST(m_bWrite);
+				if(nSize <= m_nSize)
+					return GAIA::True;
+				if(m_bMapping && nSize > m_nMapSize)
+				{
+					GAIA::N64 nCapacity = GAIA::ALGO::gmax(nSize, m_nMapSize * 2);
+					nCapacity = (nCapacity + CACHE_PAGE_SIZE - 1) & ~(CACHE_PAGE_SIZE - 1);
+					if(!this->map(nCapacity))
+						return GAIA::False;
+				}
+				m_nSize = nSize;
+				return GAIA::True;
+			}
+
+			/*!
+				@brief Write back the modified elements to the file.
+
+				@remarks The file is cut to the size of the pager if it is mapped.
+			*/
+			GINL GAIA::BL Flush()
+			{
+				if(!m_bWrite)
+					return GAIA::True;
+				if(m_bMapping)
+				{
+					if(m_pMap != GNIL)
+					{
+					#if GAIA_OS == GAIA_OS_WINDOWS
+						if(!::FlushViewOfFile(m_pMap, 0))
+							return GAIA::False;
+					#else
+						if(msync(m_pMap, m_nMapSize, MS_SYNC) != 0)
+							return GAIA::False;
+					#endif
+					}
+					if(m_nMapSize > m_nSize)
+						return this->map(m_nSize);
+					return GAIA::True;
+				}
+				if(!this->writeback())
+					return GAIA::False;
+				return m_pFile->Flush();
+			}
+
+			/*!
+				@brief Give the access pattern of the elements to the system.
+
+				@remarks It only works for the mapped file on the posix systems, and it is kept when the file is mapped again.
+			*/
+			GINL GAIA::BL Advise(ADVISE_TYPE advise)
+			{
+				m_advise = advise;
+				return this->advise();
+			}
+		private:
+			GINL GAIA::GVOID init()
+			{
+				m_pFile = GNIL;
+				m_nSize = 0;
+				m_bWrite = GAIA::False;
+				m_bMapping = GAIA::False;
+				m_bTemporary = GAIA::False;
+				m_advise = ADVISE_TYPE_NORMAL;
+				m_pMap = GNIL;
+				m_nMapSize = 0;
+			#if GAIA_OS == GAIA_OS_WINDOWS
+				m_hMapping = GNIL;
+			#endif
+				m_pPages = GNIL;
+				m_pPageBuf = GNIL;
+				m_ppBuckets = GNIL;
+				m_sPageCount = 0;
+				m_sBucketMask = 0;
+				m_pHead = m_pTail = m_pFree = m_pLast = GNIL;
+			}
+			GINL GAIA::BL map(GAIA::N64 nSize)
+			{
+				// The file must be flushed before resizing, because the C runtime buffer is not seen by the mapping.
+				this->unmap();
+				m_pFile->Flush();
+				if(m_pFile->Size() != nSize)
+				{
+					if(!m_bWrite || !m_pFile->Resize(nSize))
+						return GAIA::False;
+				}
+				if(nSize == 0)
+					return GAIA::True;
+			#if GAIA_OS == GAIA_OS_WINDOWS
+				HANDLE hFile = (HANDLE)_get_osfhandle(_fileno((FILE*)m_pFile->GetHandle()));
+				if(hFile == INVALID_HANDLE_VALUE)
+					return GAIA::False;
+				m_hMapping = ::CreateFileMapping(hFile, GNIL, m_bWrite ? PAGE_READWRITE : PAGE_READONLY, (DWORD)(nSize >> 32), (DWORD)(nSize & 0xFFFFFFFF), GNIL);
+				if(m_hMapping == GNIL)
+					return GAIA::False;
+				m_pMap = (GAIA::U8*)::MapViewOfFile(m_hMapping, m_bWrite ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, (SIZE_T)nSize);
+				if(m_pMap == GNIL)
+				{
+					::CloseHandle(m_hMapping);
+					m_hMapping = GNIL;
+					return GAIA::False;
+				}
+			#else
+				GAIA::GVOID* p = mmap(GNIL, (size_t)nSize, m_bWrite ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fileno((FILE*)m_pFile->GetHandle()), 0);
+				if(p == MAP_FAILED)
+					return GAIA::False;
+				m_pMap = (GAIA::U8*)p;
+			#endif
+				m_nMapSize = nSize;
+				this->advise();
+				return GAIA::True;
+			}
+			GINL GAIA::GVOID unmap()
+			{
+				if(m_pMap == GNIL)
+					return;
+			#if GAIA_OS == GAIA_OS_WINDOWS
+				::UnmapViewOfFile(m_pMap);
+				::CloseHandle(m_hMapping);
+				m_hMapping = GNIL;
+			#else
+				munmap(m_pMap, (size_t)m_nMapSize);
+			#endif
+				m_pMap = GNIL;
+				m_nMapSize = 0;
+			}
+			GINL GAIA::BL advise()
+			{
+				if(m_pMap == GNIL)
+					return GAIA::True;
+			#if GAIA_OS == GAIA_OS_WINDOWS
+				return GAIA::True;
+			#else
+				GAIA::N32 nAdvise;
+				switch(m_advise)
+				{
+				case ADVISE_TYPE_SEQUENTIAL:
+					nAdvise = MADV_SEQUENTIAL;
+					break;
+				case ADVISE_TYPE_RANDOM:
+					nAdvise = MADV_RANDOM;
+					break;
+				case ADVISE_TYPE_WILLNEED:
+					nAdvise = MADV_WILLNEED;
+					break;
+				default:
+					nAdvise = MADV_NORMAL;
+					break;
+				}
+				return madvise(m_pMap, (size_t)m_nMapSize, nAdvise) == 0;
+			#endif
+			}
+			GINL Page* getpage(GAIA::N64 nIndex)
+			{
+				Page** ppBucket = &m_ppBuckets[GSCAST(GAIA::NUM)(nIndex & m_sBucketMask)];
+				Page* pPage = *ppBucket;
+				while(pPage != GNIL && pPage->nIndex != nIndex)
+					pPage = pPage->pHashNext;
+				if(pPage == GNIL)
+				{
+					if(m_pFree != GNIL)
+					{
+						pPage = m_pFree;
+						m_pFree = pPage->pNext;
+					}
+					else
+					{
+						pPage = m_pTail;
+						if(pPage->bDirty && !this->writepage(*pPage))
+							return GNIL;
+						this->unlink(*pPage);
+						Page** ppOld = &m_ppBuckets[GSCAST(GAIA::NUM)(pPage->nIndex & m_sBucketMask)];
+						while(*ppOld != pPage)
+							ppOld = &(*ppOld)->pHashNext;
+						*ppOld = pPage->pHashNext;
+					}
+					if(!this->readpage(nIndex, *pPage))
+					{
+						pPage->nIndex = GINVALID;
+						pPage->pNext = m_pFree;
+						m_pFree = pPage;
+						return GNIL;
+					}
+					pPage->pHashNext = *ppBucket;
+					*ppBucket = pPage;
+				}
+				else
+					this->unlink(*pPage);
+				pPage->pPrev = GNIL;
+				pPage->pNext = m_pHead;
+				if(m_pHead != GNIL)
+					m_pHead->pPrev = pPage;
+				else
+					m_pTail = pPage;
+				m_pHead = pPage;
+				m_pLast = pPage;
+				return pPage;
+			}
+			GINL GAIA::GVOID unlink(Page& page)
+			{
+				if(page.pPrev != GNIL)
+					page.pPrev->pNext = page.pNext;
+				else
+					m_pHead = page.pNext;
+				if(page.pNext != GNIL)
+					page.pNext->pPrev = page.pPrev;
+				else
+					m_pTail = page.pPrev;
+				if(m_pLast == &page)
+					m_pLast = GNIL;
+			}
+			GINL GAIA::BL readpage(GAIA::N64 nIndex, Page& page)
+			{
+				// The bytes after the end of the file are zero.
+				GAIA::N64 nOffset = nIndex << CACHE_PAGE_SHIFT;
+				GAIA::N64 nSize = GAIA::ALGO::gmin(m_pFile->Size() - nOffset, GSCAST(GAIA::N64)(CACHE_PAGE_SIZE));
+				if(nSize > 0)
+				{
+					if(!m_pFile->Seek(nOffset, GAIA::SEEK_TYPE_BEGIN))
+						return GAIA::False;
+					if(m_pFile->Read(page.p, GSCAST(GAIA::N32)(nSize)) != nSize)
+						return GAIA::False;
+				}
+				else
+					nSize = 0;
+				if(nSize < CACHE_PAGE_SIZE)
+					GAIA::ALGO::gmemset(page.p + nSize, 0, CACHE_PAGE_SIZE - nSize);
+				page.nIndex = nIndex;
+				page.bDirty = GAIA::False;
+				return GAIA::True;
+			}
+			GINL GAIA::BL writepage(Page& page)
+			{
+				GAIA::N64 nOffset = page.nIndex << CACHE_PAGE_SHIFT;
+				GAIA::N64 nSize = GAIA::ALGO::gmin(m_nSize - nOffset, GSCAST(GAIA::N64)(CACHE_PAGE_SIZE));
+				if(nSize > 0)
+				{
+					if(m_pFile->Size() < nOffset && !m_pFile->Resize(nOffset))
+						return GAIA::False;
+					if(!m_pFile->Seek(nOffset, GAIA::SEEK_TYPE_BEGIN))
+						return GAIA::False;
+					if(m_pFile->Write(page.p, GSCAST(GAIA::N32)(nSize)) != nSize)
+						return GAIA::False;
+				}
+				page.bDirty = GAIA::False;
+				return GAIA::True;
+			}
+			GINL GAIA::BL writeback()
+			{
+				GAIA::BL bRet = GAIA::True;
+				for(Page* pPage = m_pHead; pPage != GNIL; pPage = pPage->pNext)
+				{
+					if(pPage->bDirty && !this->writepage(*pPage))
+						bRet = GAIA::False;
+				}
+				return bRet;
+			}
+		private:
+			GAIA::FSYS::FileBase* m_pFile;
+			GAIA::N64 m_nSize;
+			GAIA::BL m_bWrite;
+			GAIA::BL m_bMapping;
+			GAIA::BL m_bTemporary;
+			ADVISE_TYPE m_advise;
+			GAIA::U8* m_pMap;
+			GAIA::N64 m_nMapSize;
+		#if GAIA_OS == GAIA_OS_WINDOWS
+			HANDLE m_hMapping;
+		#endif
+			Page* m_pPages;
+			GAIA::U8* m_pPageBuf;
+			Page** m_ppBuckets;
+			GAIA::NUM m_sPageCount;
+			GAIA::NUM m_sBucketMask;
+			Page* m_pHead;
+			Page* m_pTail;
+			Page* m_pFree;
+			Page* m_pLast;
+		};
+	}
+}
+
+#endif
@@ -3,14 +3,186 @@
 
 #include "gaia_type.h"
 #include "gaia_assert.h"
+#include "gaia_algo_base.h"
 #include "gaia_algo_extend.h"
 
+#if defined(GAIA_SIMD_AVX2)
+#	include <immintrin.h>
+#elif defined(GAIA_SIMD_SSE2)
+#	include <emmintrin.h>
+#endif
+
 namespace GAIA
 {
 	namespace CTN
 	{
-		#define GAIA_BITSET_SRC (m_pFront[index / 8])
-		#define GAIA_BITSET_CUR (1 << (index % 8))
+		/*!
+			@brief The 64 bits word operations of the bit sets.
+
+			@remarks
+				The bulk operations are processed by SIMD blocks(SSE2 is 2 words, AVX2 is 4 words) and the rest words one by one.
+				The AVX2 bit count is the nibble lookup by byte shuffle, and the others count word by word.
+		*/
+		class BitsetImpl : public GAIA::Base
+		{
+		public:
+			static const GAIA::NUM WORD_BITS = 64;
+		public:
+			/*!
+				@brief Get the bit index of the sRank-th(from 0) set bit of a word.
+
+				@param u [in] Specify the word.
+
+				@param sRank [in] Specify the rank, it must be less than the set bit count of the word.
+
+				@return Return the bit index.
+
+				@remarks The bytes are skipped by the byte bit count first, and then the lower set bits are cleared.
+			*/
+			static GINL GAIA::NUM Select(GAIA::U64 u, GAIA::NUM sRank)
+			{
+				GAST(sRank >= 0 && sRank < GAIA::ALGO::gpopcount(u));
+				GAIA::NUM ret = 0;
+				for(;;)
+				{
+					GAIA::NUM sByteCount = GAIA::ALGO::gpopcount(u & 0xFF);
+					if(sRank < sByteCount)
+						break;
+					sRank -= sByteCount;
+					u >>= 8;
+					ret += 8;
+				}
+				for(GAIA::NUM x = 0; x < sRank; ++x)
+					u &= u - 1;
+				return ret + GAIA::ALGO::gctz(u);
+			}
+			static GINL GAIA::U64 Count(const GAIA::U64* p, GAIA::U64 uCount)
+			{
+				GAIA::U64 ret = 0;
+				GAIA::U64 x = 0;
+			#if defined(GAIA_SIMD_AVX2)
+				const __m256i lookup = _mm256_setr_epi8(
+					0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+					0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+				const __m256i mask = _mm256_set1_epi8(0x0F);
+				__m256i acc = _mm256_setzero_si256();
+				for(; x + 4 <= uCount; x += 4)
+				{
+					__m256i v = _mm256_loadu_si256(GRCAST(const __m256i*)(p + x));
+					__m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, mask));
+					__m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), mask));
+					acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+				}
+				ret += (GAIA::U64)_mm256_extract_epi64(acc, 0) + (GAIA::U64)_mm256_extract_epi64(acc, 1) +
+					(GAIA::U64)_mm256_extract_epi64(acc, 2) + (GAIA::U64)_mm256_extract_epi64(acc, 3);
+			#endif
+				for(; x < uCount; ++x)
+					ret += GAIA::ALGO::gpopcount(p[x]);
+				return ret;
+			}
+			static GINL GAIA::BL Zero(const GAIA::U64* p, GAIA::U64 uCount)
+			{
+				for(GAIA::U64 x = 0; x < uCount; ++x)
+				{
+					if(p[x] != 0)
+						return GAIA::False;
+				}
+				return GAIA::True;
+			}
+			static GINL GAIA::GVOID Or(GAIA::U64* dst, const GAIA::U64* src, GAIA::U64 uCount){Apply<OpOr>(dst, src, uCount);}
+			static GINL GAIA::GVOID And(GAIA::U64* dst, const GAIA::U64* src, GAIA::U64 uCount){Apply<OpAnd>(dst, src, uCount);}
+			static GINL GAIA::GVOID Xor(GAIA::U64* dst, const GAIA::U64* src, GAIA::U64 uCount){Apply<OpXor>(dst, src, uCount);}
+			static GINL GAIA::GVOID AndNot(GAIA::U64* dst, const GAIA::U64* src, GAIA::U64 uCount){Apply<OpAndNot>(dst, src, uCount);}
+			static GINL GAIA::GVOID Not(GAIA::U64* dst, GAIA::U64 uCount){Apply<OpNot>(dst, dst, uCount);}
+		private:
+		#if defined(GAIA_SIMD_AVX2)
+			typedef __m256i __Block;
+			static GINL __Block Load(const GAIA::U64* p){return _mm256_loadu_si256(GRCAST(const __m256i*)(p));}
+			static GINL GAIA::GVOID Store(GAIA::U64* p, __Block v){_mm256_storeu_si256(GRCAST(__m256i*)(p), v);}
+		#elif defined(GAIA_SIMD_SSE2)
+			typedef __m128i __Block;
+			static GINL __Block Load(const GAIA::U64* p){return _mm_loadu_si128(GRCAST(const __m128i*)(p));}
+			static GINL GAIA::GVOID Store(GAIA::U64* p, __Block v){_mm_storeu_si128(GRCAST(__m128i*)(p), v);}
+		#endif
+			class OpOr
+			{
+			public:
+			#if defined(GAIA_SIMD_AVX2)
+				static GINL __Block Block(__Block a, __Block b){return _mm256_or_si256(a, b);}
+			#elif defined(GAIA_SIMD_SSE2)
+				static GINL __Block Block(__Block a, __Block b){return _mm_or_si128(a, b);}
+			#endif
+				static GINL GAIA::U64 Word(GAIA::U64 a, GAIA::U64 b){return a | b;}
+			};
+			class OpAnd
+			{
+			public:
+			#if defined(GAIA_SIMD_AVX2)
+				static GINL __Block Block(__Block a, __Block b){return _mm256_and_si256(a, b);}
+			#elif defined(GAIA_SIMD_SSE2)
+				static GINL __Block Block(__Block a, __Block b){return _mm_and_si128(a, b);}
+			#endif
+				static GINL GAIA::U64 Word(GAIA::U64 a, GAIA::U64 b){return a & b;}
+			};
+			class OpXor
+			{
+			public:
+			#if defined(GAIA_SIMD_AVX2)
+				static GINL __Block Block(__Block a, __Block b){return _mm256_xor_si256(a, b);}
+			#elif defined(GAIA_SIMD_SSE2)
+				static GINL __Block Block(__Block a, __Block b){return _mm_xor_si128(a, b);}
+			#endif
+				static GINL GAIA::U64 Word(GAIA::U64 a, GAIA::U64 b){return a ^ b;}
+			};
+			class OpAndNot
+			{
+			public:
+			#if defined(GAIA_SIMD_AVX2)
+				static GINL __Block Block(__Block a, __Block b){return _mm256_andnot_si256(b, a);}
+			#elif defined(GAIA_SIMD_SSE2)
+				static GINL __Block Block(__Block a, __Block b){return _mm_andnot_si128(b, a);}
+			#endif
+				static GINL GAIA::U64 Word(GAIA::U64 a, GAIA::U64 b){return a & ~b;}
+			};
+			class OpNot
+			{
+			public:
+			#if defined(GAIA_SIMD_AVX2)
+				static GINL __Block Block(__Block a, __Block){return _mm256_xor_si256(a, _mm256_set1_epi32(-1));}
+			#elif defined(GAIA_SIMD_SSE2)
+				static GINL __Block Block(__Block a, __Block){return _mm_xor_si128(a, _mm_set1_epi32(-1));}
+			#endif
+				static GINL GAIA::U64 Word(GAIA::U64 a, GAIA::U64){return ~a;}
+			};
+			template<typename _OpType> static GINL GAIA::GVOID Apply(GAIA::U64* dst, const GAIA::U64* src, GAIA::U64 uCount)
+			{
+				GAIA::U64 x = 0;
+			#if defined(GAIA_SIMD_AVX2) || defined(GAIA_SIMD_SSE2)
+				static const GAIA::U64 BLOCK_WORDS = sizeof(__Block) / sizeof(GAIA::U64);
+				for(; x + BLOCK_WORDS <= uCount; x += BLOCK_WORDS)
+					Store(dst + x, _OpType::Block(Load(dst + x), Load(src + x)));
+			#endif
+				for(; x < uCount; ++x)
+					dst[x] = _OpType::Word(dst[x], src[x]);
+			}
+		};
+
+		#define GAIA_BITSET_SRC (m_pFront[index / 64])
+		#define GAIA_BITSET_CUR ((GAIA::U64)1 << (index % 64))
+
+		/*!
+			@brief The dynamic bit set.
+
+			@remarks
+				The bits are stored in 64 bits words, and the bits after size() are always 0.
+				fptr and bptr is the byte view of the words, it is the same as the bit index order in little endian machine.
+
+				rank and select use a small auxiliary index which is built by buildindex. The index is a cumulative
+				count of every 65536 bits superblock(64 bits) and a relative count of every 512 bits block(16 bits),
+				it costs about 3.2% extra memory. rank is O(1), and select is a binary search of the superblocks and the
+				blocks of a superblock. Any modification drops the index, rank and select work without index too, but they
+				scan the words from the beginning.
+		*/
 		template<typename _SizeType, typename _ExtendType> class BasicBitset : public GAIA::Base
 		{
 		public:
@@ -18,26 +190,51 @@ namespace GAIA
 			typedef _ExtendType _extendtype;
 		public:
 			typedef BasicBitset<_SizeType, _ExtendType> __MyType;
+		public:
+			static const GAIA::NUM RANK_BLOCK_SHIFT = 9;
+			static const GAIA::NUM RANK_SUPER_SHIFT = 16;
 		public:
 			GINL BasicBitset(){this->init();}
 			GINL BasicBitset(const __MyType& src){this->init(); this->operator = (src);}
 			GINL ~BasicBitset(){this->destroy();}
-			GINL GAIA::GVOID clear(){if(!this->empty()) GAIA::ALGO::gmemset(this->fptr(), 0, this->buffer_size(this->size()));}
+			GINL GAIA::GVOID clear(){if(!this->empty()) GAIA::ALGO::gmemset(m_pFront, 0, this->word_count(this->size()) * sizeof(GAIA::U64)); this->dropindex();}
 			GINL GAIA::BL empty() const{return this->size() == 0;}
 			GINL GAIA::BL nill() const{return m_pFront == GNIL;}
-			GINL GAIA::BL zero() const{if(this->empty()) return GAIA::False; return GAIA::ALGO::gmemchr(this->fptr(), 0, this->buffer_size(this->size())) == 0;}
-			GINL GAIA::BL one() const{if(this->empty()) return GAIA::False; return GAIA::ALGO::gmemchr(this->fptr(), 0xFF, this->buffer_size(this->size())) == 0;}
+			GINL GAIA::BL zero() const{if(this->empty()) return GAIA::False; return GAIA::CTN::BitsetImpl::Zero(m_pFront, this->word_count(this->size()));}
+			GINL GAIA::BL one() const
+			{
+				if(this->empty())
+					return GAIA::False;
+				GAIA::U64 uFullCount = (GAIA::U64)this->size() / 64;
+				for(GAIA::U64 x = 0; x < uFullCount; ++x)
+				{
+					if(m_pFront[x] != (GAIA::U64)GINVALID)
+						return GAIA::False;
+				}
+				if(this->size() % 64 != 0)
+					return m_pFront[uFullCount] == this->tail_mask();
+				return GAIA::True;
+			}
 			GINL const _SizeType& size() const{return m_size;}
 			GINL const _SizeType& capacity() const{return m_capacity;}
-			GINL GAIA::GVOID destroy(){if(m_pFront != GNIL){gdel[] m_pFront; m_pFront = GNIL;} m_size = m_capacity = 0;}
-			GINL GAIA::U8* fptr(){if(this->empty()) return GNIL; return m_pFront;}
-			GINL GAIA::U8* bptr(){if(this->empty()) return GNIL; return &m_pFront[this->buffer_size(this->size()) - 1];}
-			GINL const GAIA::U8* fptr() const{if(this->empty()) return GNIL; return m_pFront;}
-			GINL const GAIA::U8* bptr() const{if(this->empty()) return GNIL; return &m_pFront[this->buffer_size(this->size()) - 1];}
+			GINL GAIA::GVOID destroy()
+			{
+				if(m_pFront != GNIL)
+				{
+					gdel[] m_pFront;
+					m_pFront = GNIL;
+				}
+				m_size = m_capacity = 0;
+				this->dropindex();
+			}
+			GINL GAIA::U8* fptr(){if(this->empty()) return GNIL; return GRCAST(GAIA::U8*)(m_pFront);}
+			GINL GAIA::U8* bptr(){if(this->empty()) return GNIL; return GRCAST(GAIA::U8*)(m_pFront) + this->buffer_size(this->size()) - 1;}
+			GINL const GAIA::U8* fptr() const{if(this->empty()) return GNIL; return GRCAST(const GAIA::U8*)(m_pFront);}
+			GINL const GAIA::U8* bptr() const{if(this->empty()) return GNIL; return GRCAST(const GAIA::U8*)(m_pFront) + this->buffer_size(this->size()) - 1;}
 			GINL GAIA::BL exist(const _SizeType& index) const{GAST(index >= 0 && index < this->size()); if(index >= this->size()) return GAIA::False; return (GAIA_BITSET_SRC & GAIA_BITSET_CUR) != 0;}
-			GINL GAIA::GVOID set(const _SizeType& index){GAST(index >= 0 && index < this->size()); if(index >= this->size()) return; GAIA_BITSET_SRC |= GAIA_BITSET_CUR;}
-			GINL GAIA::GVOID reset(const _SizeType& index){GAST(index >= 0 && index < this->size()); if(index >= this->size()) return; GAIA_BITSET_SRC &= ~GAIA_BITSET_CUR;}
-			GINL GAIA::GVOID inverse(const _SizeType& index){GAST(index >= 0 && index < this->size()); if(index >= this->size()) return; if(this->exist(index)) this->reset(index); else this->set(index);}
+			GINL GAIA::GVOID set(const _SizeType& index){GAST(index >= 0 && index < this->size()); if(index >= this->size()) return; GAIA_BITSET_SRC |= GAIA_BITSET_CUR; m_bIndex = GAIA::False;}
+			GINL GAIA::GVOID reset(const _SizeType& index){GAST(index >= 0 && index < this->size()); if(index >= this->size()) return; GAIA_BITSET_SRC &= ~GAIA_BITSET_CUR; m_bIndex = GAIA::False;}
+			GINL GAIA::GVOID inverse(const _SizeType& index){GAST(index >= 0 && index < this->size()); if(index >= this->size()) return; GAIA_BITSET_SRC ^= GAIA_BITSET_CUR; m_bIndex = GAIA::False;}
 			GINL GAIA::GVOID push_back(GAIA::BL bSet)
 			{
 				if(this->size() == this->capacity())
@@ -47,30 +244,38 @@ namespace GAIA
 					this->exten(newsize - this->capacity());
 				}
 				++m_size;
-				this->set(m_size - 1);
+				if(bSet)
+					this->set(m_size - 1);
+				m_bIndex = GAIA::False;
 			}
+
+			/*!
+				@brief Resize the bit set.
+
+				@param size [in] Specify the new bit count.
+
+				@remarks The existing bits are kept, and the new bits are 0.
+			*/
 			GINL GAIA::GVOID resize(const _SizeType& size)
 			{
 				GAST(size >= 0);
 				if(size < this->size())
+				{
+					GAIA::U64 uNewCount = this->word_count(size);
+					GAIA::U64 uOldCount = this->word_count(this->size());
+					for(GAIA::U64 x = uNewCount; x < uOldCount; ++x)
+						m_pFront[x] = 0;
 					m_size = size;
+					if(this->size() % 64 != 0)
+						m_pFront[uNewCount - 1] &= this->tail_mask();
+				}
 				else
 				{
 					if(size > this->capacity())
-					{
-						this->destroy();
-						this->reserve(size);
-						m_size = size;
-						this->clear();
-						m_size = size;
-					}
-					else
-					{
-						for(_SizeType x = m_size; x < size; ++x)
-							this->set(x);
-						m_size = size;
-					}
+						this->exten(size - this->capacity());
+					m_size = size;
 				}
+				this->dropindex();
 			}
 			GINL GAIA::GVOID reserve(const _SizeType& size)
 			{
@@ -78,42 +283,190 @@ namespace GAIA
 				this->destroy();
 				if(size > 0)
 				{
-					m_pFront = gnew GAIA::U8[this->buffer_size(size)];
-					GAIA::ALGO::reset(m_pFront, 0, this->buffer_size(size));
+					m_pFront = gnew GAIA::U64[this->word_count(size)];
+					GAIA::ALGO::gmemset(m_pFront, 0, this->word_count(size) * sizeof(GAIA::U64));
 					m_capacity = size;
 					m_size = 0;
 				}
 			}
+
+			/*!
+				@brief Get the set bit count.
+
+				@remarks If the index is built, the count is get from the index directly.
+			*/
+			GINL _SizeType count() const
+			{
+				if(m_bIndex)
+					return (_SizeType)m_uCount;
+				if(this->empty())
+					return 0;
+				return (_SizeType)GAIA::CTN::BitsetImpl::Count(m_pFront, this->word_count(this->size()));
+			}
+
+			/*!
+				@brief Build the rank and select index.
+
+				@remarks The index is dropped by any modification, call it after the last modification.
+			*/
+			GINL GAIA::GVOID buildindex()
+			{
+				this->dropindex();
+				GAIA::U64 uWordCount = this->word_count(this->size());
+				GAIA::U64 uBlockCount = ((GAIA::U64)this->size() >> RANK_BLOCK_SHIFT) + 1;
+				GAIA::U64 uSuperCount = ((GAIA::U64)this->size() >> RANK_SUPER_SHIFT) + 1;
+				m_pSuper = gnew GAIA::U64[uSuperCount];
+				m_pBlock = gnew GAIA::U16[uBlockCount];
+				GAIA::U64 uTotal = 0;
+				GAIA::U64 uSuper = 0;
+				for(GAIA::U64 x = 0; x < uBlockCount; ++x)
+				{
+					if((x & BLOCK_MASK) == 0)
+					{
+						m_pSuper[x >> (RANK_SUPER_SHIFT - RANK_BLOCK_SHIFT)] = uTotal;
+						uSuper = uTotal;
+					}
+					m_pBlock[x] = (GAIA::U16)(uTotal - uSuper);
+					GAIA::U64 uEnd = GAIA::ALGO::gmin((x + 1) * BLOCK_WORDS, uWordCount);
+					for(GAIA::U64 y = x * BLOCK_WORDS; y < uEnd; ++y)
+						uTotal += GAIA::ALGO::gpopcount(m_pFront[y]);
+				}
+				m_uSuperCount = uSuperCount;
+				m_uBlockCount = uBlockCount;
+				m_uCount = uTotal;
+				m_bIndex = GAIA::True;
+			}
+			GINL GAIA::BL isindex() const{return m_bIndex;}
+
+			/*!
+				@brief Get the set bit count before a bit.
+
+				@param index [in] Specify the bit index, it could be equal to size().
+
+				@return Return the set bit count in [0, index).
+			*/
+			GINL _SizeType rank(const _SizeType& index) const
+			{
+				GAST(index >= 0 && index <= this->size());
+				if(index <= 0)
+					return 0;
+				GAIA::U64 u = (GAIA::U64)GAIA::ALGO::gmin(index, this->size());
+				GAIA::U64 uWord = u / 64;
+				GAIA::U64 ret;
+				if(m_bIndex)
+				{
+					ret = m_pSuper[u >> RANK_SUPER_SHIFT] + m_pBlock[u >> RANK_BLOCK_SHIFT];
+					for(GAIA::U64 x = (u >> RANK_BLOCK_SHIFT) * BLOCK_WORDS; x < uWord; ++x)
+						ret += GAIA::ALGO::gpopcount(m_pFront[x]);
+				}
+				else
+					ret = GAIA::CTN::BitsetImpl::Count(m_pFront, uWord);
+				if(u % 64 != 0)
+					ret += GAIA::ALGO::gpopcount(m_pFront[uWord] & (((GAIA::U64)1 << (u % 64)) - 1));
+				return (_SizeType)ret;
+			}
+
+			/*!
+				@brief Get the index of a set bit by rank.
+
+				@param rank [in] Specify the rank(from 0) of the set bit.
+
+				@return Return the bit index, or GINVALID if the set bit count is not above rank.
+			*/
+			GINL _SizeType select(const _SizeType& rank) const
+			{
+				GAST(rank >= 0);
+				if(rank < 0 || this->empty())
+					return (_SizeType)GINVALID;
+				GAIA::U64 uRank = (GAIA::U64)rank;
+				GAIA::U64 uWord = 0;
+				GAIA::U64 uWordCount = this->word_count(this->size());
+				if(m_bIndex)
+				{
+					if(uRank >= m_uCount)
+						return (_SizeType)GINVALID;
+					GAIA::U64 uSuper = this->search(m_pSuper, 0, m_uSuperCount, uRank);
+					uRank -= m_pSuper[uSuper];
+					GAIA::U64 uBlockBegin = uSuper << (RANK_SUPER_SHIFT - RANK_BLOCK_SHIFT);
+					GAIA::U64 uBlockEnd = GAIA::ALGO::gmin(uBlockBegin + BLOCK_MASK + 1, m_uBlockCount);
+					GAIA::U64 uBlock = this->search(m_pBlock, uBlockBegin, uBlockEnd, uRank);
+					uRank -= m_pBlock[uBlock];
+					uWord = uBlock * BLOCK_WORDS;
+				}
+				for(; uWord < uWordCount; ++uWord)
+				{
+					GAIA::U64 uCount = (GAIA::U64)GAIA::ALGO::gpopcount(m_pFront[uWord]);
+					if(uRank < uCount)
+						return (_SizeType)(uWord * 64 + GAIA::CTN::BitsetImpl::Select(m_pFront[uWord], (GAIA::NUM)uRank));
+					uRank -= uCount;
+				}
+				return (_SizeType)GINVALID;
+			}
+
+			/*!
+				@brief Find the first set bit from a bit.
+
+				@param index [in] Specify the bit index to find from.
+
+				@return Return the first set bit index which is not less than index, or GINVALID if not exist.
+			*/
+			GINL _SizeType findnext(const _SizeType& index) const
+			{
+				GAST(index >= 0);
+				if(index < 0 || index >= this->size())
+					return (_SizeType)GINVALID;
+				GAIA::U64 uWordCount = this->word_count(this->size());
+				GAIA::U64 uWord = (GAIA::U64)index / 64;
+				GAIA::U64 uBits = m_pFront[uWord] & ((GAIA::U64)GINVALID << ((GAIA::U64)index % 64));
+				for(;;)
+				{
+					if(uBits != 0)
+						return (_SizeType)(uWord * 64 + GAIA::ALGO::gctz(uBits));
+					if(++uWord >= uWordCount)
+						return (_SizeType)GINVALID;
+					uBits = m_pFront[uWord];
+				}
+			}
 			GINL __MyType& operator = (const __MyType& src)
 			{
 				GAST(&src != this);
 				this->destroy();
 				this->resize(src.size());
-				GAIA::ALGO::copy(this->fptr(), src.fptr(), this->buffer_size(src.size()));
+				if(!src.empty())
+					GAIA::ALGO::gmemcpy(m_pFront, src.m_pFront, this->word_count(src.size()) * sizeof(GAIA::U64));
 				return *this;
 			}
 			GINL __MyType& operator |= (const __MyType& src)
 			{
-				if(this->capacity() < src.size())
-					this->exten(src.size() - this->capacity());
-				this->resize(src.size());
-				_SizeType buffer_size = src.buffer_size(src.size());
-				for(_SizeType x = 0; x < buffer_size; ++x)
-					this->fptr()[x] |= src.fptr()[x];
+				if(this->size() < src.size())
+					this->resize(src.size());
+				if(!src.empty())
+					GAIA::CTN::BitsetImpl::Or(m_pFront, src.m_pFront, this->word_count(src.size()));
+				m_bIndex = GAIA::False;
 				return *this;
 			}
 			GINL __MyType& operator &= (const __MyType& src)
 			{
-				_SizeType minsize = GAIA::ALGO::gmin(this->buffer_size(this->size()), src.buffer_size(src.size()));
-				for(_SizeType x = 0; x < minsize; ++x)
-					this->fptr()[x] &= src.fptr()[x];
+				GAIA::U64 uCount = this->word_count(this->size());
+				GAIA::U64 uSrcCount = this->word_count(src.size());
+				if(uSrcCount < uCount)
+				{
+					for(GAIA::U64 x = uSrcCount; x < uCount; ++x)
+						m_pFront[x] = 0;
+					uCount = uSrcCount;
+				}
+				if(uCount > 0)
+					GAIA::CTN::BitsetImpl::And(m_pFront, src.m_pFront, uCount);
+				m_bIndex = GAIA::False;
 				return *this;
 			}
 			GINL __MyType& operator ^= (const __MyType& src)
 			{
-				_SizeType minsize = GAIA::ALGO::gmin(this->buffer_size(this->size()), src.buffer_size(src.size()));
-				for(_SizeType x = 0; x < minsize; ++x)
-					this->fptr()[x] ^= src.fptr()[x];
+				if(this->size() < src.size())
+					this->resize(src.size());
+				if(!src.empty())
+					GAIA::CTN::BitsetImpl::Xor(m_pFront, src.m_pFront, this->word_count(src.size()));
+				m_bIndex = GAIA::False;
 				return *this;
 			}
 			GINL GAIA::N32 compare(const __MyType& src) const
@@ -130,32 +483,89 @@ namespace GAIA
 			GINL __MyType operator ~ () const
 			{
 				__MyType ret = *this;
-				_SizeType buffer_size = ret.buffer_size(ret.size());
-				for(_SizeType x = 0; x < buffer_size; ++x)
-					ret.fptr()[x] ^= (GAIA::U8)GINVALID;
+				if(!ret.empty())
+				{
+					GAIA::U64 uCount = ret.word_count(ret.size());
+					GAIA::CTN::BitsetImpl::Not(ret.m_pFront, uCount);
+					if(ret.size() % 64 != 0)
+						ret.m_pFront[uCount - 1] &= ret.tail_mask();
+				}
 				return ret;
 			}
 			GINL GAIA::BL operator[](const _SizeType& index) const{return this->exist(index);}
 		private:
-			GINL GAIA::GVOID init(){m_pFront = GNIL; m_size = m_capacity = 0;}
+			static const GAIA::U64 BLOCK_WORDS = ((GAIA::U64)1 << RANK_BLOCK_SHIFT) / 64;
+			static const GAIA::U64 BLOCK_MASK = ((GAIA::U64)1 << (RANK_SUPER_SHIFT - RANK_BLOCK_SHIFT)) - 1;
+		private:
+			GINL GAIA::GVOID init()
+			{
+				m_pFront = GNIL;
+				m_size = m_capacity = 0;
+				m_pSuper = GNIL;
+				m_pBlock = GNIL;
+				m_uSuperCount = m_uBlockCount = m_uCount = 0;
+				m_bIndex = GAIA::False;
+			}
+			GINL GAIA::GVOID dropindex()
+			{
+				if(m_pSuper != GNIL)
+				{
+					gdel[] m_pSuper;
+					m_pSuper = GNIL;
+				}
+				if(m_pBlock != GNIL)
+				{
+					gdel[] m_pBlock;
+					m_pBlock = GNIL;
+				}
+				m_uSuperCount = m_uBlockCount = m_uCount = 0;
+				m_bIndex = GAIA::False;
+			}
 			GINL GAIA::GVOID exten(const _SizeType& size)
 			{
 				GAST(size >= 0);
 				if(size == 0)
 					return;
-				GAIA::U8* pNew = gnew GAIA::U8[this->buffer_size(this->capacity() + size)];
-				if(this->size() > 0)
-					GAIA::ALGO::gmemcpy(pNew, this->fptr(), this->buffer_size(this->size()));
-				if(m_pFront != GNIL)
-					gdel[] m_pFront;
-				m_pFront = pNew;
+				GAIA::U64 uOldCount = this->word_count(this->capacity());
+				GAIA::U64 uNewCount = this->word_count(this->capacity() + size);
+				if(uNewCount > uOldCount)
+				{
+					GAIA::U64* pNew = gnew GAIA::U64[uNewCount];
+					if(uOldCount > 0)
+						GAIA::ALGO::gmemcpy(pNew, m_pFront, uOldCount * sizeof(GAIA::U64));
+					GAIA::ALGO::gmemset(pNew + uOldCount, 0, (uNewCount - uOldCount) * sizeof(GAIA::U64));
+					if(m_pFront != GNIL)
+						gdel[] m_pFront;
+					m_pFront = pNew;
+				}
 				m_capacity += size;
 			}
+			template<typename _CountType> GINL GAIA::U64 search(const _CountType* p, GAIA::U64 uBegin, GAIA::U64 uEnd, GAIA::U64 uRank) const
+			{
+				// The last one which is not above uRank, the one after it is above uRank, so it is not an empty block.
+				while(uEnd - uBegin > 1)
+				{
+					GAIA::U64 uMid = uBegin + (uEnd - uBegin) / 2;
+					if((GAIA::U64)p[uMid] <= uRank)
+						uBegin = uMid;
+					else
+						uEnd = uMid;
+				}
+				return uBegin;
+			}
 			GINL _SizeType buffer_size(const _SizeType& size) const{return (size / 8) + ((size % 8 != 0) ? 1 : 0);}
+			GINL GAIA::U64 word_count(const _SizeType& size) const{return ((GAIA::U64)size + 63) / 64;}
+			GINL GAIA::U64 tail_mask() const{return ((GAIA::U64)1 << ((GAIA::U64)this->size() % 64)) - 1;}
 		private:
-			GAIA::U8* m_pFront;
+			GAIA::U64* m_pFront;
 			_SizeType m_size;
 			_SizeType m_capacity;
+			GAIA::U64* m_pSuper;
+			GAIA::U16* m_pBlock;
+			GAIA::U64 m_uSuperCount;
+			GAIA::U64 m_uBlockCount;
+			GAIA::U64 m_uCount;
+			GAIA::BL m_bIndex;
 		};
 		class Bitset : public BasicBitset<GAIA::NUM, GAIA::ALGO::ExtendGold<GAIA::NUM> >{public:};
 	}
@@ -42,6 +42,13 @@ namespace GAIA
 			GINL _SizeType capacity() const{return GSCAST(_SizeType)(m_pBack - m_pFront);}
 			GINL GAIA::GVOID clear(){m_pWrite = m_pRead = m_pFront;}
 			GINL GAIA::GVOID destroy(){if(m_pFront != GNIL){gdel[] m_pFront; this->init();}}
+			GINL GAIA::GVOID swap(__MyType& src)
+			{
+				GAIA::ALGO::swap(m_pFront, src.m_pFront);
+				GAIA::ALGO::swap(m_pBack, src.m_pBack);
+				GAIA::ALGO::swap(m_pWrite, src.m_pWrite);
+				GAIA::ALGO::swap(m_pRead, src.m_pRead);
+			}
 			GINL GAIA::GVOID reserve(const _SizeType& size)
 			{
 				GAST(size >= 0);
@@ -101,7 +108,7 @@ namespace GAIA
 					{
 						GAIA::U8* pNew = gnew GAIA::U8[size];
 						GAIA::ALGO::gmemcpy(pNew, this->fptr(), this->write_size());
-						gdel m_pFront;
+						gdel[] m_pFront;
 						m_pFront = pNew;
 						m_pBack = m_pWrite = m_pFront + size;
 						m_pRead = m_pFront;
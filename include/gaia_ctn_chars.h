@@ -8,6 +8,7 @@
 #include "gaia_algo_string.h"
 #include "gaia_algo_search.h"
 #include "gaia_algo_replace.h"
+#include "gaia_algo_hash.h"
 
 namespace GAIA
 {
@@ -234,6 +235,7 @@ namespace GAIA
 			GINL _SizeType capacity() const{return _Size;}
 			GINL _SizeType typesize() const{return sizeof(_DataType);}
 			GINL _SizeType datasize() const{return this->typesize() * this->size();}
+			GINL GAIA::U64 hash() const{return GAIA::ALGO::hash(this->fptr());}
 			GINL GAIA::BL resize(const _SizeType& size){if(size > _Size) return GAIA::False; m_size = size + 1; m_pFront[size] = 0; return GAIA::True;}
 			GINL GAIA::BL resize_keep(const _SizeType& size)
 			{
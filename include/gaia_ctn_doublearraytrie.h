@@ -0,0 +1,302 @@
+#ifndef		__GAIA_CTN_DOUBLEARRAYTRIE_H__
+#define		__GAIA_CTN_DOUBLEARRAYTRIE_H__
+
+#include "gaia_type.h"
+#include "gaia_assert.h"
+#include "gaia_algo_extend.h"
+#include "gaia_algo_sort.h"
+#include "gaia_ctn_vector.h"
+#include "gaia_ctn_bitset.h"
+#include "gaia_ctn_trietree.h"
+
+namespace GAIA
+{
+	namespace CTN
+	{
+		/*!
+			@brief The read only trie built from a trie tree.
+
+			@remarks
+				Every node of the trie tree is a state, the root is state 0. The keys are mapped to the codes from 1 by the
+				sorted key list of the trie tree, and the child of state s by code c is state base[s] + c, if its check is s.
+				The base and check of a state are stored together, so a step of the lookup touches one cache line.
+
+				The counts of the nodes are kept, count, catagory_count and full_count of a state are the same as
+				the counts of the node of the trie tree.
+		*/
+		template<typename _DataType, typename _SizeType, typename _ExtendType> class BasicDoubleArrayTrie : public GAIA::Base
+		{
+		public:
+			typedef _DataType _datatype;
+			typedef _SizeType _sizetype;
+			typedef _ExtendType _extendtype;
+		public:
+			typedef BasicDoubleArrayTrie<_DataType, _SizeType, _ExtendType> __MyType;
+			typedef BasicTrieTree<_DataType, _SizeType, _ExtendType> __TrieType;
+		public:
+			GINL BasicDoubleArrayTrie(){this->init();}
+			GINL GAIA::BL empty() const{return this->size() == 0;}
+			GINL const _SizeType& size() const{return m_size;}
+			GINL _SizeType capacity() const{return m_units.size();}
+			GINL GAIA::GVOID clear(){m_units.clear(); m_counts.clear(); m_alphabet.clear(); this->init();}
+			GINL GAIA::GVOID destroy(){m_units.destroy(); m_counts.destroy(); m_alphabet.destroy(); this->init();}
+
+			/*!
+				@brief Build from a trie tree.
+
+				@param src [in] Specify the trie tree.
+
+				@remarks
+					The nodes are placed in breadth first order, the base of a node is the first one which makes all
+					children of the node placed at the free states.
+			*/
+			GINL GAIA::GVOID build(const __TrieType& src)
+			{
+				typedef BasicVector<const typename __TrieType::Node*, _SizeType, _ExtendType> __NodeListType;
+				this->clear();
+
+				// Collect the nodes in breadth first order and the keys.
+				__NodeListType listNode;
+				listNode.push_back(&src.root());
+				for(_SizeType x = 0; x < listNode.size(); ++x)
+				{
+					typename __TrieType::__NodeTreeType::const_it it = src.child_const_front_it(*listNode[x]);
+					for(; !it.empty(); ++it)
+					{
+						m_alphabet.push_back(***it);
+						listNode.push_back(*it);
+					}
+				}
+				if(!m_alphabet.empty())
+				{
+					GAIA::ALGO::sort(m_alphabet.fptr(), m_alphabet.bptr());
+					_SizeType sUnique = 1;
+					for(_SizeType x = 1; x < m_alphabet.size(); ++x)
+					{
+						if(m_alphabet[sUnique - 1] != m_alphabet[x])
+							m_alphabet[sUnique++] = m_alphabet[x];
+					}
+					m_alphabet.resize(sUnique);
+				}
+				if(GAIA::CTN::TrieKey<_DataType>::DIRECT)
+				{
+					for(_SizeType x = 0; x < m_alphabet.size(); ++x)
+						m_codes[GAIA::CTN::TrieKey<_DataType>::Byte(m_alphabet[x])] = x + 1;
+				}
+
+				// Place the states.
+				BasicVector<_SizeType, _SizeType, _ExtendType> listState;
+				BasicVector<_SizeType, _SizeType, _ExtendType> listCode;
+				GAIA::CTN::BasicBitset<GAIA::N64, GAIA::ALGO::ExtendGold<GAIA::N64> > freeset;
+				listState.resize(listNode.size());
+				listState[0] = 0;
+				this->exten(freeset, listNode.size() + m_alphabet.size() + 1);
+				this->place(freeset, 0, *listNode[0], src);
+				_SizeType sFirstFree = 1;
+				_SizeType sLast = 0;
+				_SizeType sChild = 1;
+				for(_SizeType x = 0; x < listNode.size(); ++x)
+				{
+					listCode.clear();
+					typename __TrieType::__NodeTreeType::const_it it = src.child_const_front_it(*listNode[x]);
+					for(; !it.empty(); ++it)
+						listCode.push_back(this->code(***it));
+					if(listCode.empty())
+						continue;
+
+					// Find the base, the first code is placed at a free state from the first free state.
+					_SizeType sPos = this->nextfree(freeset, GAIA::ALGO::gmax(sFirstFree, listCode[0] + 1));
+					_SizeType sBase;
+					for(;;)
+					{
+						sBase = sPos - listCode[0];
+						this->exten(freeset, sBase + listCode[listCode.size() - 1] + 1);
+						GAIA::BL bFree = GAIA::True;
+						for(_SizeType y = 1; y < listCode.size(); ++y)
+						{
+							if(!freeset.exist(sBase + listCode[y]))
+							{
+								bFree = GAIA::False;
+								break;
+							}
+						}
+						if(bFree)
+							break;
+						sPos = this->nextfree(freeset, sPos + 1);
+					}
+
+					_SizeType sState = listState[x];
+					m_units[sState].base = sBase;
+					for(_SizeType y = 0; y < listCode.size(); ++y)
+					{
+						_SizeType sChildState = sBase + listCode[y];
+						m_units[sChildState].check = sState;
+						this->place(freeset, sChildState, *listNode[sChild + y], src);
+						listState[sChild + y] = sChildState;
+						if(sChildState > sLast)
+							sLast = sChildState;
+					}
+					sChild += listCode.size();
+					if(sFirstFree < freeset.size() && !freeset.exist(sFirstFree))
+						sFirstFree = this->nextfree(freeset, sFirstFree);
+				}
+				GAST(sChild == listNode.size());
+				m_units.resize(sLast + 1);
+				m_counts.resize(sLast + 1);
+				m_size = listNode.size() - 1;
+			}
+			GINL _SizeType root() const{return 0;}
+
+			/*!
+				@brief Find the state of a key list from a state.
+
+				@param state [in] Specify the state to find from.
+
+				@param p [in] Specify the key list.
+
+				@param size [in] Specify the key count.
+
+				@return Return the state, or GINVALID if the key list is not exist.
+			*/
+			GINL _SizeType find(const _SizeType& state, const _DataType* p, const _SizeType& size) const
+			{
+				GAST(!!p);
+				GAST(size > 0);
+				if(m_units.empty())
+					return (_SizeType)GINVALID;
+				_SizeType sState = state;
+				for(_SizeType x = 0; x < size; ++x)
+				{
+					sState = this->next(sState, p[x]);
+					if(sState == (_SizeType)GINVALID)
+						break;
+				}
+				return sState;
+			}
+			GINL _SizeType find(const _DataType* p, const _SizeType& size) const{return this->find(this->root(), p, size);}
+			GINL GAIA::BL exist(const _DataType* p, const _SizeType& size) const{return this->find(p, size) != (_SizeType)GINVALID;}
+
+			/*!
+				@brief Get the longest inserted key list which is the prefix of a key list.
+
+				@param p [in] Specify the key list.
+
+				@param size [in] Specify the key count.
+
+				@return Return the key count of the longest inserted prefix, or 0 if there is no one.
+			*/
+			GINL _SizeType longest(const _DataType* p, const _SizeType& size) const
+			{
+				GAST(!!p);
+				if(m_units.empty())
+					return 0;
+				_SizeType ret = 0;
+				_SizeType sState = this->root();
+				for(_SizeType x = 0; x < size; ++x)
+				{
+					sState = this->next(sState, p[x]);
+					if(sState == (_SizeType)GINVALID)
+						break;
+					if(m_counts[sState].count > 0)
+						ret = x + 1;
+				}
+				return ret;
+			}
+			GINL _SizeType count(const _SizeType& state) const{return m_counts[state].count;}
+			GINL _SizeType catagory_count(const _SizeType& state) const{return m_counts[state].category_count;}
+			GINL _SizeType full_count(const _SizeType& state) const{return m_counts[state].full_count;}
+		private:
+			class Unit
+			{
+			public:
+				_SizeType base;
+				_SizeType check;
+			};
+			class Count
+			{
+			public:
+				_SizeType count;
+				_SizeType category_count;
+				_SizeType full_count;
+			};
+		private:
+			GINL GAIA::GVOID init()
+			{
+				m_size = 0;
+				for(GAIA::NUM x = 0; x < sizeofarray(m_codes); ++x)
+					m_codes[x] = 0;
+			}
+			GINL _SizeType code(const _DataType& t) const
+			{
+				if(GAIA::CTN::TrieKey<_DataType>::DIRECT)
+					return m_codes[GAIA::CTN::TrieKey<_DataType>::Byte(t)];
+				_SizeType sBegin = 0;
+				_SizeType sEnd = m_alphabet.size();
+				while(sBegin < sEnd)
+				{
+					_SizeType sMid = sBegin + (sEnd - sBegin) / 2;
+					if(m_alphabet[sMid] < t)
+						sBegin = sMid + 1;
+					else
+						sEnd = sMid;
+				}
+				if(sBegin < m_alphabet.size() && m_alphabet[sBegin] == t)
+					return sBegin + 1;
+				return 0;
+			}
+			GINL _SizeType next(const _SizeType& state, const _DataType& t) const
+			{
+				_SizeType c = this->code(t);
+				if(c == 0)
+					return (_SizeType)GINVALID;
+				_SizeType sNext = m_units[state].base + c;
+				if(sNext >= m_units.size() || m_units[sNext].check != state)
+					return (_SizeType)GINVALID;
+				return sNext;
+			}
+			template<typename _BitsetType> GINL _SizeType nextfree(const _BitsetType& freeset, const _SizeType& index) const
+			{
+				if(index >= freeset.size())
+					return index;
+				typename _BitsetType::_sizetype ret = freeset.findnext(index);
+				if(ret == (typename _BitsetType::_sizetype)GINVALID)
+					return (_SizeType)freeset.size();
+				return (_SizeType)ret;
+			}
+			template<typename _BitsetType> GINL GAIA::GVOID exten(_BitsetType& freeset, const _SizeType& size)
+			{
+				if(size <= m_units.size())
+					return;
+				_SizeType sOldSize = m_units.size();
+				_SizeType sNewSize = GAIA::ALGO::gmax(size, sOldSize * 2);
+				m_units.resize_keep(sNewSize);
+				m_counts.resize_keep(sNewSize);
+				freeset.resize(sNewSize);
+				for(_SizeType x = sOldSize; x < sNewSize; ++x)
+				{
+					m_units[x].base = 0;
+					m_units[x].check = (_SizeType)GINVALID;
+					m_counts[x].count = m_counts[x].category_count = m_counts[x].full_count = 0;
+					freeset.set(x);
+				}
+			}
+			template<typename _BitsetType> GINL GAIA::GVOID place(_BitsetType& freeset, const _SizeType& state, const typename __TrieType::Node& n, const __TrieType& src)
+			{
+				freeset.reset(state);
+				if(state == 0)
+					m_units[state].check = 0;
+				m_counts[state].count = src.count(n);
+				m_counts[state].category_count = src.catagory_count(n);
+				m_counts[state].full_count = src.full_count(n);
+			}
+		private:
+			BasicVector<Unit, _SizeType, _ExtendType> m_units;
+			BasicVector<Count, _SizeType, _ExtendType> m_counts;
+			BasicVector<_DataType, _SizeType, _ExtendType> m_alphabet;
+			_SizeType m_codes[256];
+			_SizeType m_size;
+		};
+	}
+}
+
+#endif
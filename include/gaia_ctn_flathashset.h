@@ -0,0 +1,569 @@
+#ifndef		__GAIA_CTN_FLATHASHSET_H__
+#define		__GAIA_CTN_FLATHASHSET_H__
+
+#include "gaia_type.h"
+#include "gaia_assert.h"
+#include "gaia_algo_base.h"
+#include "gaia_iterator.h"
+#include "gaia_algo_hash.h"
+
+#ifdef GAIA_SIMD_SSE2
+#	include <emmintrin.h>
+#endif
+
+namespace GAIA
+{
+	namespace CTN
+	{
+		/*!
+			@brief The control bytes group of the open addressing hash containers.
+
+			@remarks
+				Every slot has a control byte, it is CTRL_EMPTY, CTRL_DELETED or the low 7 bits of the hash value of the slot.
+				The control bytes are scanned by GROUP_WIDTH a time, and every match function return a bit mask of the slots in group.
+		*/
+		class FlatHashGroup : public GAIA::Base
+		{
+		public:
+			static const GAIA::U8 CTRL_EMPTY = 0x80;
+			static const GAIA::U8 CTRL_DELETED = 0xFE;
+			static const GAIA::NUM GROUP_WIDTH = 16;
+		public:
+			GINL FlatHashGroup(const GAIA::U8* p)
+			{
+			#ifdef GAIA_SIMD_SSE2
+				m_ctrl = _mm_loadu_si128(GRCAST(const __m128i*)(p));
+			#else
+				m_p = p;
+			#endif
+			}
+			GINL GAIA::U32 Match(GAIA::U8 h) const
+			{
+			#ifdef GAIA_SIMD_SSE2
+				return (GAIA::U32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8((GAIA::N8)h), m_ctrl));
+			#else
+				GAIA::U32 ret = 0;
+				for(GAIA::NUM x = 0; x < GROUP_WIDTH; ++x)
+				{
+					if(m_p[x] == h)
+						ret |= (1 << x);
+				}
+				return ret;
+			#endif
+			}
+			GINL GAIA::U32 MatchEmpty() const{return this->Match(CTRL_EMPTY);}
+			GINL GAIA::U32 MatchEmptyOrDeleted() const
+			{
+			#ifdef GAIA_SIMD_SSE2
+				return (GAIA::U32)_mm_movemask_epi8(m_ctrl);
+			#else
+				GAIA::U32 ret = 0;
+				for(GAIA::NUM x = 0; x < GROUP_WIDTH; ++x)
+				{
+					if(m_p[x] & 0x80)
+						ret |= (1 << x);
+				}
+				return ret;
+			#endif
+			}
+			GINL GAIA::U32 MatchFull() const{return ~this->MatchEmptyOrDeleted() & 0xFFFF;}
+			static GINL GAIA::U8 H2(GAIA::U64 h){return (GAIA::U8)(h & 0x7F);}
+			static GINL GAIA::U64 H1(GAIA::U64 h){return h >> 7;}
+		private:
+		#ifdef GAIA_SIMD_SSE2
+			__m128i m_ctrl;
+		#else
+			const GAIA::U8* m_p;
+		#endif
+		};
+
+		/*!
+			@brief Open addressing hash set.
+
+			@remarks
+				The elements are stored in a contiguous slot array without per-element allocation,
+				and probed by the groups of control bytes, see FlatHashGroup.
+				The slots never move except rehash, so the pointer returned by find is valid until next insert.
+				Unlike BasicHashSet, a element which exist in the set will not be inserted again.
+		*/
+		template<typename _DataType, typename _SizeType> class BasicFlatHashSet : public GAIA::Base
+		{
+		public:
+			typedef _DataType _datatype;
+			typedef _SizeType _sizetype;
+		public:
+			typedef BasicFlatHashSet<_DataType, _SizeType> __MyType;
+		public:
+			class it : public GAIA::ITERATOR::Iterator<_DataType>
+			{
+			private:
+				friend class BasicFlatHashSet;
+			public:
+				GINL it(){this->init();}
+				GINL virtual GAIA::BL empty() const{return m_index == GINVALID;}
+				GINL virtual GAIA::GVOID clear(){this->init();}
+				GINL virtual GAIA::BL erase()
+				{
+					if(this->empty())
+						return GAIA::False;
+					return m_pContainer->erase(*this);
+				}
+				GINL virtual _DataType& operator * (){return m_pContainer->m_pSlots[m_index];}
+				GINL virtual const _DataType& operator * () const{return m_pContainer->m_pSlots[m_index];}
+				GINL virtual GAIA::ITERATOR::Iterator<_DataType>& operator ++ (){m_index = m_pContainer->nextfull(m_index); return *this;}
+				GINL virtual GAIA::ITERATOR::Iterator<_DataType>& operator -- (){m_index = m_pContainer->prevfull(m_index); return *this;}
+				GINL virtual GAIA::ITERATOR::Iterator<_DataType>& operator = (const GAIA::ITERATOR::Iterator<_DataType>& src){GAST(&src != this); return this->operator = (*GSCAST(const it*)(&src));}
+				GINL virtual GAIA::BL operator == (const GAIA::ITERATOR::Iterator<_DataType>& src) const{return this->operator == (*GSCAST(const it*)(&src));}
+				GINL virtual GAIA::BL operator != (const GAIA::ITERATOR::Iterator<_DataType>& src) const{return this->operator != (*GSCAST(const it*)(&src));}
+				GINL GAIA::BL operator == (const it& src) const{return m_index == src.m_index;}
+				GINL GAIA::BL operator != (const it& src) const{return !this->operator == (src);}
+				GINL it& operator = (const it& src){GAST(&src != this); m_pContainer = src.m_pContainer; m_index = src.m_index; return *this;}
+				GINL it& operator += (_SizeType c)
+				{
+					GAST(!this->empty());
+					if(this->empty())
+						return *this;
+					while(c > 0)
+					{
+						++(*this);
+						if(this->empty())
+							return *this;
+						--c;
+					}
+					while(c < 0)
+					{
+						--(*this);
+						if(this->empty())
+							return *this;
+						++c;
+					}
+					return *this;
+				}
+				GINL it& operator -= (_SizeType c)
+				{
+					GAST(!this->empty());
+					if(this->empty())
+						return *this;
+					while(c > 0)
+					{
+						--(*this);
+						if(this->empty())
+							return *this;
+						--c;
+					}
+					while(c < 0)
+					{
+						++(*this);
+						if(this->empty())
+							return *this;
+						++c;
+					}
+					return *this;
+				}
+				GINL it operator + (const _SizeType& c) const
+				{
+					it ret = *this;
+					ret += c;
+					return ret;
+				}
+				GINL it operator - (const _SizeType& c) const
+				{
+					it ret = *this;
+					ret -= c;
+					return ret;
+				}
+				GINL _SizeType operator - (const it& src) const
+				{
+					if(this->empty() || src.empty())
+						return 0;
+					it iter = *this;
+					_SizeType ret = 0;
+					for(; !iter.empty(); --iter)
+					{
+						if(iter == src)
+							return ret;
+						++ret;
+					}
+					iter = *this;
+					ret = 0;
+					for(; !iter.empty(); ++iter)
+					{
+						if(iter == src)
+							return ret;
+						--ret;
+					}
+					return ret;
+				}
+			private:
+				GINL virtual GAIA::ITERATOR::Iterator<_DataType>& operator ++ (GAIA::N32){++(*this); return *this;}
+				GINL virtual GAIA::ITERATOR::Iterator<_DataType>& operator -- (GAIA::N32){--(*this); return *this;}
+			private:
+				GINL GAIA::GVOID init(){m_pContainer = GNIL; m_index = GINVALID;}
+			private:
+				__MyType* m_pContainer;
+				_SizeType m_index;
+			};
+			class const_it : public GAIA::ITERATOR::ConstIterator<_DataType>
+			{
+			private:
+				friend class BasicFlatHashSet;
+			public:
+				GINL const_it(){this->init();}
+				GINL virtual GAIA::BL empty() const{return m_index == GINVALID;}
+				GINL virtual GAIA::GVOID clear(){this->init();}
+				GINL virtual const _DataType& operator * () const{return m_pContainer->m_pSlots[m_index];}
+				GINL virtual GAIA::ITERATOR::ConstIterator<_DataType>& operator ++ (){m_index = m_pContainer->nextfull(m_index); return *this;}
+				GINL virtual GAIA::ITERATOR::ConstIterator<_DataType>& operator -- (){m_index = m_pContainer->prevfull(m_index); return *this;}
+				GINL virtual GAIA::ITERATOR::ConstIterator<_DataType>& operator = (const GAIA::ITERATOR::ConstIterator<_DataType>& src){GAST(&src != this); return this->operator = (*GSCAST(const const_it*)(&src));}
+				GINL virtual GAIA::BL operator == (const GAIA::ITERATOR::ConstIterator<_DataType>& src) const{return this->operator == (*GSCAST(const const_it*)(&src));}
+				GINL virtual GAIA::BL operator != (const GAIA::ITERATOR::ConstIterator<_DataType>& src) const{return this->operator != (*GSCAST(const const_it*)(&src));}
+				GINL GAIA::BL operator == (const const_it& src) const{return m_index == src.m_index;}
+				GINL GAIA::BL operator != (const const_it& src) const{return !this->operator == (src);}
+				GINL const_it& operator = (const const_it& src){GAST(&src != this); m_pContainer = src.m_pContainer; m_index = src.m_index; return *this;}
+				GINL const_it& operator += (_SizeType c)
+				{
+					GAST(!this->empty());
+					if(this->empty())
+						return *this;
+					while(c > 0)
+					{
+						++(*this);
+						if(this->empty())
+							return *this;
+						--c;
+					}
+					while(c < 0)
+					{
+						--(*this);
+						if(this->empty())
+							return *this;
+						++c;
+					}
+					return *this;
+				}
+				GINL const_it& operator -= (_SizeType c)
+				{
+					GAST(!this->empty());
+					if(this->empty())
+						return *this;
+					while(c > 0)
+					{
+						--(*this);
+						if(this->empty())
+							return *this;
+						--c;
+					}
+					while(c < 0)
+					{
+						++(*this);
+						if(this->empty())
+							return *this;
+						++c;
+					}
+					return *this;
+				}
+				GINL const_it operator + (const _SizeType& c) const
+				{
+					const_it ret = *this;
+					ret += c;
+					return ret;
+				}
+				GINL const_it operator - (const _SizeType& c) const
+				{
+					const_it ret = *this;
+					ret -= c;
+					return ret;
+				}
+				GINL _SizeType operator - (const const_it& src) const
+				{
+					if(this->empty() || src.empty())
+						return 0;
+					const_it iter = *this;
+					_SizeType ret = 0;
+					for(; !iter.empty(); --iter)
+					{
+						if(iter == src)
+							return ret;
+						++ret;
+					}
+					iter = *this;
+					ret = 0;
+					for(; !iter.empty(); ++iter)
+					{
+						if(iter == src)
+							return ret;
+						--ret;
+					}
+					return ret;
+				}
+			private:
+				GINL virtual GAIA::ITERATOR::ConstIterator<_DataType>& operator ++ (GAIA::N32){++(*this); return *this;}
+				GINL virtual GAIA::ITERATOR::ConstIterator<_DataType>& operator -- (GAIA::N32){--(*this); return *this;}
+			private:
+				GINL GAIA::GVOID init(){m_pContainer = GNIL; m_index = GINVALID;}
+			private:
+				const __MyType* m_pContainer;
+				_SizeType m_index;
+			};
+		public:
+			GINL BasicFlatHashSet(){this->init();}
+			GINL BasicFlatHashSet(const __MyType& src){this->init(); this->operator = (src);}
+			GINL ~BasicFlatHashSet(){this->destroy();}
+			GINL GAIA::BL empty() const{return this->size() == 0;}
+			GINL const _SizeType& size() const{return m_size;}
+			GINL const _SizeType& capacity() const{return m_capacity;}
+
+			/*!
+				@brief Set the max ratio of the used slots(include the deleted ones), the container rehash when exceed it.
+
+				@param fLoadFactor [in] Specify the load factor, it will be clamped to [0.25, 0.9375].
+			*/
+			GINL GAIA::GVOID SetMaxLoadFactor(GAIA::F32 fLoadFactor)
+			{
+				if(fLoadFactor < 0.25F)
+					fLoadFactor = 0.25F;
+				else if(fLoadFactor > 0.9375F)
+					fLoadFactor = 0.9375F;
+				m_fMaxLoadFactor = fLoadFactor;
+			}
+			GINL GAIA::F32 GetMaxLoadFactor() const{return m_fMaxLoadFactor;}
+			GINL GAIA::GVOID reserve(const _SizeType& size)
+			{
+				GAST(size >= 0);
+				_SizeType newcapacity = this->fitcapacity(size);
+				if(newcapacity > m_capacity)
+					this->rehash(newcapacity);
+			}
+			GINL GAIA::GVOID clear()
+			{
+				if(m_capacity == 0)
+					return;
+				for(_SizeType x = 0; x < m_capacity; ++x)
+					m_pCtrl[x] = FlatHashGroup::CTRL_EMPTY;
+				m_size = 0;
+				m_deleted = 0;
+			}
+			GINL GAIA::GVOID destroy()
+			{
+				if(m_pCtrl != GNIL)
+				{
+					gdel[] m_pCtrl;
+					m_pCtrl = GNIL;
+				}
+				if(m_pSlots != GNIL)
+				{
+					gdel[] m_pSlots;
+					m_pSlots = GNIL;
+				}
+				m_capacity = 0;
+				m_size = 0;
+				m_deleted = 0;
+			}
+			GINL GAIA::BL insert(const _DataType& t)
+			{
+				GAIA::U64 h = GAIA::ALGO::hash(t);
+				if(this->findindex(t, h) != GINVALID)
+					return GAIA::False;
+				if(m_capacity == 0 || (GAIA::F64)(m_size + m_deleted + 1) > (GAIA::F64)m_capacity * m_fMaxLoadFactor)
+				{
+					// Too many deleted slots rehash in place, else grow.
+					if(m_capacity != 0 && (GAIA::F64)(m_size + 1) <= (GAIA::F64)m_capacity * m_fMaxLoadFactor / 2)
+						this->rehash(m_capacity);
+					else
+						this->rehash(this->fitcapacity(m_size + 1 > m_capacity ? m_size + 1 : m_capacity));
+				}
+				_SizeType index = this->freeindex(h);
+				if(m_pCtrl[index] == FlatHashGroup::CTRL_DELETED)
+					--m_deleted;
+				m_pCtrl[index] = FlatHashGroup::H2(h);
+				m_pSlots[index] = t;
+				++m_size;
+				return GAIA::True;
+			}
+			GINL GAIA::BL erase(const _DataType& t)
+			{
+				_SizeType index = this->findindex(t, GAIA::ALGO::hash(t));
+				if(index == GINVALID)
+					return GAIA::False;
+				this->eraseindex(index);
+				return GAIA::True;
+			}
+			GINL GAIA::BL erase(it& iter)
+			{
+				if(iter.empty())
+					return GAIA::False;
+				_SizeType index = iter.m_index;
+				iter.m_index = this->nextfull(index);
+				this->eraseindex(index);
+				return GAIA::True;
+			}
+			GINL _DataType* find(const _DataType& t)
+			{
+				_SizeType index = this->findindex(t, GAIA::ALGO::hash(t));
+				if(index == GINVALID)
+					return GNIL;
+				return &m_pSlots[index];
+			}
+			GINL const _DataType* find(const _DataType& t) const
+			{
+				return GCCAST(__MyType*)(this)->find(t);
+			}
+			GINL _DataType& front(){return m_pSlots[this->nextfull(GINVALID)];}
+			GINL const _DataType& front() const{return m_pSlots[this->nextfull(GINVALID)];}
+			GINL _DataType& back(){return m_pSlots[this->prevfull(m_capacity)];}
+			GINL const _DataType& back() const{return m_pSlots[this->prevfull(m_capacity)];}
+			GINL it frontit(){it ret; ret.m_pContainer = this; ret.m_index = this->nextfull(GINVALID); return ret;}
+			GINL it backit(){it ret; ret.m_pContainer = this; ret.m_index = this->prevfull(m_capacity); return ret;}
+			GINL const_it const_frontit() const{const_it ret; ret.m_pContainer = this; ret.m_index = this->nextfull(GINVALID); return ret;}
+			GINL const_it const_backit() const{const_it ret; ret.m_pContainer = this; ret.m_index = this->prevfull(m_capacity); return ret;}
+			GINL __MyType& operator += (const __MyType& src)
+			{
+				GAST(&src != this);
+				for(const_it iter = src.const_frontit(); !iter.empty(); ++iter)
+					this->insert(*iter);
+				return *this;
+			}
+			GINL __MyType& operator = (const __MyType& src)
+			{
+				GAST(&src != this);
+				this->destroy();
+				m_fMaxLoadFactor = src.m_fMaxLoadFactor;
+				if(src.m_capacity == 0)
+					return *this;
+				m_pCtrl = gnew GAIA::U8[src.m_capacity];
+				m_pSlots = gnew _DataType[src.m_capacity];
+				m_capacity = src.m_capacity;
+				for(_SizeType x = 0; x < m_capacity; ++x)
+				{
+					m_pCtrl[x] = src.m_pCtrl[x];
+					if(!(m_pCtrl[x] & 0x80))
+						m_pSlots[x] = src.m_pSlots[x];
+				}
+				m_size = src.m_size;
+				m_deleted = src.m_deleted;
+				return *this;
+			}
+		private:
+			GINL GAIA::GVOID init()
+			{
+				m_pCtrl = GNIL;
+				m_pSlots = GNIL;
+				m_capacity = 0;
+				m_size = 0;
+				m_deleted = 0;
+				m_fMaxLoadFactor = 0.875F;
+			}
+			GINL _SizeType fitcapacity(const _SizeType& size) const
+			{
+				_SizeType ret = FlatHashGroup::GROUP_WIDTH;
+				while((GAIA::F64)size > (GAIA::F64)ret * m_fMaxLoadFactor)
+					ret *= 2;
+				return ret;
+			}
+			GINL _SizeType findindex(const _DataType& t, GAIA::U64 h) const
+			{
+				if(m_capacity == 0)
+					return GINVALID;
+				GAIA::U8 h2 = FlatHashGroup::H2(h);
+				_SizeType groupmask = m_capacity / FlatHashGroup::GROUP_WIDTH - 1;
+				_SizeType groupindex = (_SizeType)(FlatHashGroup::H1(h) & (GAIA::U64)groupmask);
+				for(_SizeType step = 1; ; ++step)
+				{
+					_SizeType offset = groupindex * FlatHashGroup::GROUP_WIDTH;
+					FlatHashGroup g(m_pCtrl + offset);
+					for(GAIA::U32 uMask = g.Match(h2); uMask != 0; uMask &= uMask - 1)
+					{
+						_SizeType index = offset + GAIA::ALGO::gctz(uMask);
+						if(m_pSlots[index] == t)
+							return index;
+					}
+					if(g.MatchEmpty() != 0 || step > groupmask)
+						return GINVALID;
+					groupindex = (groupindex + step) & groupmask;
+				}
+			}
+			GINL _SizeType freeindex(GAIA::U64 h) const
+			{
+				GAST(m_capacity != 0);
+				_SizeType groupmask = m_capacity / FlatHashGroup::GROUP_WIDTH - 1;
+				_SizeType groupindex = (_SizeType)(FlatHashGroup::H1(h) & (GAIA::U64)groupmask);
+				for(_SizeType step = 1; ; ++step)
+				{
+					_SizeType offset = groupindex * FlatHashGroup::GROUP_WIDTH;
+					GAIA::U32 uMask = FlatHashGroup(m_pCtrl + offset).MatchEmptyOrDeleted();
+					if(uMask != 0)
+						return offset + GAIA::ALGO::gctz(uMask);
+					groupindex = (groupindex + step) & groupmask;
+				}
+			}
+			GINL GAIA::GVOID eraseindex(const _SizeType& index)
+			{
+				// If the group has a empty slot, no probe sequence ever passed it, so the slot can be empty too.
+				_SizeType offset = index - index % FlatHashGroup::GROUP_WIDTH;
+				if(FlatHashGroup(m_pCtrl + offset).MatchEmpty() != 0)
+					m_pCtrl[index] = FlatHashGroup::CTRL_EMPTY;
+				else
+				{
+					m_pCtrl[index] = FlatHashGroup::CTRL_DELETED;
+					++m_deleted;
+				}
+				--m_size;
+			}
+			GINL _SizeType nextfull(const _SizeType& index) const
+			{
+				for(_SizeType x = (index == GINVALID ? 0 : index + 1); x < m_capacity; ++x)
+				{
+					if(!(m_pCtrl[x] & 0x80))
+						return x;
+				}
+				return GINVALID;
+			}
+			GINL _SizeType prevfull(const _SizeType& index) const
+			{
+				for(_SizeType x = index - 1; x >= 0 && x != GINVALID; --x)
+				{
+					if(!(m_pCtrl[x] & 0x80))
+						return x;
+				}
+				return GINVALID;
+			}
+			GINL GAIA::GVOID rehash(const _SizeType& newcapacity)
+			{
+				GAST(newcapacity >= FlatHashGroup::GROUP_WIDTH);
+				GAST(newcapacity % FlatHashGroup::GROUP_WIDTH == 0);
+				GAIA::U8* pOldCtrl = m_pCtrl;
+				_DataType* pOldSlots = m_pSlots;
+				_SizeType oldcapacity = m_capacity;
+				m_pCtrl = gnew GAIA::U8[newcapacity];
+				m_pSlots = gnew _DataType[newcapacity];
+				m_capacity = newcapacity;
+				m_deleted = 0;
+				for(_SizeType x = 0; x < m_capacity; ++x)
+					m_pCtrl[x] = FlatHashGroup::CTRL_EMPTY;
+				for(_SizeType x = 0; x < oldcapacity; ++x)
+				{
+					if(pOldCtrl[x] & 0x80)
+						continue;
+					GAIA::U64 h = GAIA::ALGO::hash(pOldSlots[x]);
+					_SizeType index = this->freeindex(h);
+					m_pCtrl[index] = FlatHashGroup::H2(h);
+					m_pSlots[index] = pOldSlots[x];
+				}
+				if(pOldCtrl != GNIL)
+					gdel[] pOldCtrl;
+				if(pOldSlots != GNIL)
+					gdel[] pOldSlots;
+			}
+		private:
+			GAIA::U8* m_pCtrl;
+			_DataType* m_pSlots;
+			_SizeType m_capacity;
+			_SizeType m_size;
+			_SizeType m_deleted;
+			GAIA::F32 m_fMaxLoadFactor;
+		};
+		template<typename _DataType> class FlatHashSet : public BasicFlatHashSet<_DataType, GAIA::NUM>{public:};
+	}
+}
+
+#endif
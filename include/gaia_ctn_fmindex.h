@@ -0,0 +1,596 @@
+#ifndef		__GAIA_CTN_FMINDEX_H__
+#define		__GAIA_CTN_FMINDEX_H__
+
+#include "gaia_type.h"
+#include "gaia_assert.h"
+#include "gaia_algo_extend.h"
+#include "gaia_algo_sort.h"
+#include "gaia_algo_suffix.h"
+#include "gaia_ctn_vector.h"
+#include "gaia_ctn_bitset.h"
+
+namespace GAIA
+{
+	namespace CTN
+	{
+		/*!
+			@brief The substring index of key lists, it has the same insert, erase and find as GAIA::CTN::BasicDMPGraph.
+
+			@remarks
+				The key lists are kept in segments, a segment is the FM index of the text "#k0#k1...#kn#$", # is the separator.
+				The text is not kept, the BWT of the text is kept in a wavelet matrix, and the suffix array is sampled
+				every SAMPLE_RATE text positions for locating a match. A segment is about log2(key kinds + 2) bits per key,
+				and a little more for the rank indexes, the samples and the key bounds.
+
+				The inserted key lists are kept in the pending list, when the pending list is full it is built to a new
+				segment by SA-IS, and the newest segments are merged while the older one is not larger than twice of the newer one.
+				So there are O(log(n)) segments. The erased key lists are marked and dropped when their segment is merged.
+				Call build to merge all the key lists to one segment after a batch insert.
+
+				A match of bMatchLeft and bMatchRight is found by the backward search of "#keys#", and the separators are
+				removed from the searched key list if the match is not required. Same as GAIA::CTN::BasicDMPGraph,
+				if bMatchLeft and bMatchRight are both GAIA::False, every occurrence of the key list is called back.
+		*/
+		template<typename _DataType, typename _KeyType, typename _SizeType, typename _ExtendType> class BasicFMIndex : public GAIA::Base
+		{
+		public:
+			typedef _DataType _datatype;
+			typedef _KeyType _keytype;
+			typedef _SizeType _sizetype;
+			typedef _ExtendType _extendtype;
+		public:
+			static const _SizeType SAMPLE_RATE = 32; // The text position distance of the suffix array samples.
+			static const _SizeType PENDING_SIZE = 16 * 1024; // The max key count of the pending list before it is built to a segment.
+		public:
+			typedef BasicFMIndex<_DataType, _KeyType, _SizeType, _ExtendType> __MyType;
+			typedef GAIA::CTN::BasicVector<_DataType, _SizeType, _ExtendType> __DataListType;
+			typedef GAIA::CTN::BasicVector<_KeyType, _SizeType, _ExtendType> __KeyListType;
+			typedef GAIA::CTN::BasicVector<_SizeType, _SizeType, _ExtendType> __SizeListType;
+			typedef GAIA::CTN::BasicBitset<_SizeType, _ExtendType> __BitsetType;
+		public:
+			class FindCallBack : public GAIA::Base
+			{
+			public:
+				virtual GAIA::BL find(__MyType& g, const _KeyType* pKeys, const _SizeType& keysize, const _DataType& t){return GAIA::False;}
+			};
+		private:
+			static const _SizeType CODE_END = 0;
+			static const _SizeType CODE_SEPARATOR = 1;
+			static const _SizeType CODE_BASE = 2;
+		private:
+			class Part : public GAIA::Base
+			{
+			public:
+				GINL Part(){erasedcount = 0;}
+				GINL _SizeType livesize() const{return datas.size() - erasedcount;}
+			public:
+				__DataListType datas;
+				__BitsetType erased;
+				_SizeType erasedcount;
+			};
+			class Pending : public Part
+			{
+			public:
+				GINL GAIA::GVOID clear(){keys.clear(); offsets.clear(); this->datas.clear(); this->erased.resize(0); this->erasedcount = 0;}
+				GINL GAIA::GVOID destroy(){keys.destroy(); offsets.destroy(); this->datas.destroy(); this->erased.destroy(); this->erasedcount = 0;}
+				GINL GAIA::GVOID push_back(const _KeyType* pKeys, const _SizeType& keysize, const _DataType& t)
+				{
+					if(offsets.empty())
+						offsets.push_back(0);
+					for(_SizeType x = 0; x < keysize; ++x)
+						keys.push_back(pKeys[x]);
+					offsets.push_back(keys.size());
+					this->datas.push_back(t);
+					this->erased.push_back(GAIA::False);
+				}
+			public:
+				__KeyListType keys;
+				__SizeListType offsets; // The key list x is [offsets[x], offsets[x + 1]) of keys.
+			};
+			class Segment : public Part
+			{
+			public:
+				GINL Segment(){textsize = 0; levelcount = 0;}
+				GINL _SizeType code(const _KeyType& key) const
+				{
+					_SizeType sBegin = 0;
+					_SizeType sEnd = alphabet.size();
+					while(sBegin < sEnd)
+					{
+						_SizeType sMid = sBegin + (sEnd - sBegin) / 2;
+						if(alphabet[sMid] < key)
+							sBegin = sMid + 1;
+						else
+							sEnd = sMid;
+					}
+					if(sBegin < alphabet.size() && alphabet[sBegin] == key)
+						return sBegin + CODE_BASE;
+					return CODE_END;
+				}
+				GINL _SizeType access(const _SizeType& row) const
+				{
+					_SizeType ret = 0;
+					_SizeType sIndex = row;
+					for(_SizeType x = 0; x < levelcount; ++x)
+					{
+						_SizeType sRank = levels[x].rank(sIndex);
+						if(levels[x].exist(sIndex))
+						{
+							ret = (ret << 1) | 1;
+							sIndex = zeros[x] + sRank;
+						}
+						else
+						{
+							ret = ret << 1;
+							sIndex -= sRank;
+						}
+					}
+					return ret;
+				}
+				GINL _SizeType rank(const _SizeType& c, const _SizeType& row) const
+				{
+					_SizeType sBegin = 0;
+					_SizeType sIndex = row;
+					for(_SizeType x = 0; x < levelcount; ++x)
+					{
+						if((c >> (levelcount - 1 - x)) & 1)
+						{
+							sBegin = zeros[x] + levels[x].rank(sBegin);
+							sIndex = zeros[x] + levels[x].rank(sIndex);
+						}
+						else
+						{
+							sBegin -= levels[x].rank(sBegin);
+							sIndex -= levels[x].rank(sIndex);
+						}
+					}
+					return sIndex - sBegin;
+				}
+				GINL _SizeType lf(const _SizeType& c, const _SizeType& row) const{return counts[c] + this->rank(c, row);}
+				GINL _SizeType locate(const _SizeType& row) const
+				{
+					_SizeType sRow = row;
+					_SizeType sStep = 0;
+					while(!sampled.exist(sRow))
+					{
+						sRow = this->lf(this->access(sRow), sRow);
+						++sStep;
+					}
+					return samples[sampled.rank(sRow)] + sStep;
+				}
+				GINL _SizeType keyindex(const _SizeType& pos) const{return bounds.rank(pos + 1) - 1;}
+			public:
+				__KeyListType alphabet; // The sorted keys, the code of alphabet[x] is x + CODE_BASE.
+				__SizeListType counts; // The count of the text elements less than the code.
+				__BitsetType levels[sizeof(_SizeType) * 8]; // The wavelet matrix of the BWT, from the highest bit.
+				_SizeType zeros[sizeof(_SizeType) * 8];
+				_SizeType levelcount;
+				__BitsetType sampled; // The rows which suffix array value is sampled.
+				__SizeListType samples; // The sampled suffix array values in row order.
+				__BitsetType bounds; // The text positions of the separators.
+				_SizeType textsize;
+			};
+			class Visitor : public GAIA::Base
+			{
+			public:
+				virtual GAIA::BL visit(Part& part, const _SizeType& index) = 0; // Return GAIA::False for stop.
+			};
+			class FindVisitor : public Visitor
+			{
+			public:
+				GINL FindVisitor(__MyType& g, const _KeyType* pKeys, const _SizeType& keysize, FindCallBack& cb) : m_g(g), m_pKeys(pKeys), m_keysize(keysize), m_cb(cb){}
+				virtual GAIA::BL visit(Part& part, const _SizeType& index)
+				{
+					m_cb.find(m_g, m_pKeys, m_keysize, part.datas[index]);
+					return GAIA::True;
+				}
+			private:
+				__MyType& m_g;
+				const _KeyType* m_pKeys;
+				_SizeType m_keysize;
+				FindCallBack& m_cb;
+			};
+			class MatchVisitor : public Visitor
+			{
+			public:
+				GINL MatchVisitor(){pResult = GNIL;}
+				virtual GAIA::BL visit(Part& part, const _SizeType& index)
+				{
+					pResult = &part.datas[index];
+					return GAIA::False;
+				}
+			public:
+				const _DataType* pResult;
+			};
+			class EraseVisitor : public Visitor
+			{
+			public:
+				GINL EraseVisitor(const _DataType* pData){m_pData = pData; count = 0;}
+				virtual GAIA::BL visit(Part& part, const _SizeType& index)
+				{
+					if(m_pData != GNIL && !(part.datas[index] == *m_pData))
+						return GAIA::True;
+					part.erased.set(index);
+					++part.erasedcount;
+					++count;
+					return m_pData == GNIL;
+				}
+			public:
+				_SizeType count;
+			private:
+				const _DataType* m_pData;
+			};
+		public:
+			GINL BasicFMIndex(){this->init();}
+			GINL BasicFMIndex(const __MyType& src){this->init(); this->operator = (src);}
+			GINL ~BasicFMIndex(){this->destroy();}
+			GINL GAIA::GVOID clear(){this->release_segments(); m_segments.clear(); m_pending.clear(); m_size = 0;}
+			GINL GAIA::BL empty() const{return this->size() == 0;}
+			GINL _SizeType size() const{return m_size;}
+			GINL GAIA::GVOID destroy(){this->release_segments(); m_segments.destroy(); m_pending.destroy(); m_size = 0;}
+			GINL _SizeType segment_count() const{return m_segments.size();}
+			GINL GAIA::GVOID insert(const _KeyType* pKeys, const _SizeType& keysize, const _DataType& t)
+			{
+				GAST(pKeys != GNIL);
+				GAST(keysize > 0);
+				m_pending.push_back(pKeys, keysize, t);
+				++m_size;
+				if(m_pending.keys.size() >= PENDING_SIZE)
+					this->flush();
+			}
+			GINL GAIA::BL erase(const _KeyType* pKeys, const _SizeType& keysize, const _DataType& t)
+			{
+				GAST(pKeys != GNIL);
+				GAST(keysize > 0);
+				EraseVisitor v(&t);
+				this->walk(pKeys, keysize, GAIA::True, GAIA::True, v);
+				m_size -= v.count;
+				return v.count != 0;
+			}
+			GINL _SizeType erase(const _KeyType* pKeys, const _SizeType& keysize)
+			{
+				GAST(pKeys != GNIL);
+				GAST(keysize > 0);
+				return this->erase(pKeys, keysize, GAIA::True, GAIA::True);
+			}
+
+			/*!
+				@brief Erase the key lists which match the key list.
+
+				@return Return the erased key list count, a key list is erased once even if the key list occur in it many times.
+			*/
+			GINL _SizeType erase(const _KeyType* pKeys, const _SizeType& keysize, GAIA::BL bMatchLeft, GAIA::BL bMatchRight)
+			{
+				GAST(pKeys != GNIL);
+				GAST(keysize > 0);
+				EraseVisitor v(GNIL);
+				this->walk(pKeys, keysize, bMatchLeft, bMatchRight, v);
+				m_size -= v.count;
+				return v.count;
+			}
+			GINL const _DataType* find(const _KeyType* pKeys, const _SizeType& keysize) const
+			{
+				GAST(pKeys != GNIL);
+				GAST(keysize > 0);
+				MatchVisitor v;
+				GCCAST(__MyType*)(this)->walk(pKeys, keysize, GAIA::True, GAIA::True, v);
+				return v.pResult;
+			}
+			GINL _SizeType find(const _KeyType* pKeys, const _SizeType& keysize, GAIA::BL bMatchLeft, GAIA::BL bMatchRight, FindCallBack& cb) const
+			{
+				GAST(pKeys != GNIL);
+				GAST(keysize > 0);
+				FindVisitor v(*GCCAST(__MyType*)(this), pKeys, keysize, cb);
+				return GCCAST(__MyType*)(this)->walk(pKeys, keysize, bMatchLeft, bMatchRight, v);
+			}
+
+			/*!
+				@brief Merge all the key lists to one segment.
+
+				@remarks The erased key lists are dropped, call it after a batch insert or erase.
+			*/
+			GINL GAIA::GVOID build()
+			{
+				if(m_segments.size() == 1 && m_pending.datas.empty() && m_segments[0]->erasedcount == 0)
+					return;
+				Pending all;
+				for(_SizeType x = 0; x < m_segments.size(); ++x)
+					this->extract(*m_segments[x], all);
+				this->extract(m_pending, all);
+				this->release_segments();
+				m_segments.clear();
+				m_pending.clear();
+				if(!all.datas.empty())
+					m_segments.push_back(this->create(all));
+			}
+			GINL __MyType& operator = (const __MyType& src)
+			{
+				GAST(&src != this);
+				this->clear();
+				Pending all;
+				for(_SizeType x = 0; x < src.m_segments.size(); ++x)
+					this->extract(*src.m_segments[x], all);
+				this->extract(src.m_pending, all);
+				if(!all.datas.empty())
+					m_segments.push_back(this->create(all));
+				m_size = all.datas.size();
+				return *this;
+			}
+		private:
+			GINL GAIA::GVOID init(){m_size = 0;}
+			GINL GAIA::GVOID release_segments()
+			{
+				for(_SizeType x = 0; x < m_segments.size(); ++x)
+					gdel m_segments[x];
+			}
+			GINL GAIA::GVOID flush()
+			{
+				if(m_pending.livesize() > 0)
+				{
+					Pending temp;
+					this->extract(m_pending, temp);
+					m_segments.push_back(this->create(temp));
+				}
+				m_pending.clear();
+
+				// Merge the newest segments while the older one is not larger than twice of the newer one.
+				while(m_segments.size() >= 2)
+				{
+					Segment* pOld = m_segments[m_segments.size() - 2];
+					Segment* pNew = m_segments[m_segments.size() - 1];
+					if(pOld->textsize > pNew->textsize * 2)
+						break;
+					Pending temp;
+					this->extract(*pOld, temp);
+					this->extract(*pNew, temp);
+					gdel pOld;
+					gdel pNew;
+					m_segments.resize(m_segments.size() - 2);
+					if(!temp.datas.empty())
+						m_segments.push_back(this->create(temp));
+				}
+			}
+			GINL GAIA::GVOID extract(const Pending& src, Pending& dst) const
+			{
+				for(_SizeType x = 0; x < src.datas.size(); ++x)
+				{
+					if(src.erased.exist(x))
+						continue;
+					dst.push_back(src.keys.fptr() + src.offsets[x], src.offsets[x + 1] - src.offsets[x], src.datas[x]);
+				}
+			}
+			GINL GAIA::GVOID extract(const Segment& src, Pending& dst) const
+			{
+				// Restore the text from the end by LF mapping, row 0 is the suffix "$".
+				__SizeListType text;
+				text.resize(src.textsize);
+				text[src.textsize - 1] = CODE_END;
+				_SizeType sRow = 0;
+				for(_SizeType x = src.textsize - 1; x > 0; --x)
+				{
+					_SizeType c = src.access(sRow);
+					text[x - 1] = c;
+					sRow = src.lf(c, sRow);
+				}
+
+				// Split the text by the separators.
+				_SizeType sIndex = 0;
+				_SizeType sBegin = 1;
+				__KeyListType keys;
+				for(_SizeType x = 1; x < src.textsize - 1; ++x)
+				{
+					if(text[x] != CODE_SEPARATOR)
+						continue;
+					if(!src.erased.exist(sIndex))
+					{
+						keys.clear();
+						for(_SizeType y = sBegin; y < x; ++y)
+							keys.push_back(src.alphabet[text[y] - CODE_BASE]);
+						dst.push_back(keys.fptr(), keys.size(), src.datas[sIndex]);
+					}
+					++sIndex;
+					sBegin = x + 1;
+				}
+				GAST(sIndex == src.datas.size());
+			}
+			GINL Segment* create(const Pending& src) const
+			{
+				GAST(!src.datas.empty());
+				Segment* pSeg = gnew Segment;
+				Segment& seg = *pSeg;
+
+				// Collect the keys.
+				seg.alphabet = src.keys;
+				GAIA::ALGO::sort(seg.alphabet.fptr(), seg.alphabet.bptr());
+				_SizeType sUnique = 1;
+				for(_SizeType x = 1; x < seg.alphabet.size(); ++x)
+				{
+					if(seg.alphabet[sUnique - 1] != seg.alphabet[x])
+						seg.alphabet[sUnique++] = seg.alphabet[x];
+				}
+				seg.alphabet.resize(sUnique);
+				_SizeType sCodeCount = seg.alphabet.size() + CODE_BASE;
+
+				// Create the text "#k0#k1...#kn#$".
+				_SizeType sTextSize = src.keys.size() + src.datas.size() + 2;
+				__SizeListType text;
+				text.resize(sTextSize);
+				seg.bounds.resize(sTextSize);
+				_SizeType sPos = 0;
+				for(_SizeType x = 0; x < src.datas.size(); ++x)
+				{
+					seg.bounds.set(sPos);
+					text[sPos++] = CODE_SEPARATOR;
+					for(_SizeType y = src.offsets[x]; y < src.offsets[x + 1]; ++y)
+						text[sPos++] = seg.code(src.keys[y]);
+				}
+				seg.bounds.set(sPos);
+				text[sPos++] = CODE_SEPARATOR;
+				text[sPos++] = CODE_END;
+				GAST(sPos == sTextSize);
+				seg.bounds.buildindex();
+				seg.counts.resize(sCodeCount + 1);
+				for(_SizeType x = 0; x < seg.counts.size(); ++x)
+					seg.counts[x] = 0;
+				for(_SizeType x = 0; x < sTextSize; ++x)
+					++seg.counts[text[x] + 1];
+				for(_SizeType x = 1; x < seg.counts.size(); ++x)
+					seg.counts[x] += seg.counts[x - 1];
+
+				// Create the BWT and the suffix array samples.
+				__SizeListType sa;
+				sa.resize(sTextSize);
+				GAIA::ALGO::suffixarray(text.fptr(), sTextSize, sCodeCount, sa.fptr());
+				__SizeListType bwt;
+				bwt.resize(sTextSize);
+				seg.sampled.resize(sTextSize);
+				for(_SizeType x = 0; x < sTextSize; ++x)
+				{
+					bwt[x] = sa[x] == 0 ? text[sTextSize - 1] : text[sa[x] - 1];
+					if(sa[x] % SAMPLE_RATE == 0)
+					{
+						seg.sampled.set(x);
+						seg.samples.push_back(sa[x]);
+					}
+				}
+				seg.sampled.buildindex();
+				sa.destroy();
+				text.destroy();
+
+				// Create the wavelet matrix, every level is a bit of the codes, and the codes are stable partitioned by the bit.
+				seg.levelcount = 1;
+				while(((sCodeCount - 1) >> seg.levelcount) != 0)
+					++seg.levelcount;
+				__SizeListType next;
+				next.resize(sTextSize);
+				__SizeListType* pCur = &bwt;
+				__SizeListType* pNext = &next;
+				for(_SizeType x = 0; x < seg.levelcount; ++x)
+				{
+					const __SizeListType& cur = *pCur;
+					_SizeType sBit = seg.levelcount - 1 - x;
+					__BitsetType& level = seg.levels[x];
+					level.resize(sTextSize);
+					_SizeType sZero = 0;
+					for(_SizeType y = 0; y < sTextSize; ++y)
+					{
+						if((cur[y] >> sBit) & 1)
+							level.set(y);
+						else
+							++sZero;
+					}
+					level.buildindex();
+					seg.zeros[x] = sZero;
+					_SizeType sZeroPos = 0;
+					_SizeType sOnePos = sZero;
+					for(_SizeType y = 0; y < sTextSize; ++y)
+					{
+						if((cur[y] >> sBit) & 1)
+							(*pNext)[sOnePos++] = cur[y];
+						else
+							(*pNext)[sZeroPos++] = cur[y];
+					}
+					GAIA::ALGO::swap(pCur, pNext);
+				}
+
+				seg.datas = src.datas;
+				seg.erased.resize(src.datas.size());
+				seg.erasedcount = 0;
+				seg.textsize = sTextSize;
+				return pSeg;
+			}
+			GINL _SizeType walk(const _KeyType* pKeys, const _SizeType& keysize, GAIA::BL bMatchLeft, GAIA::BL bMatchRight, Visitor& v)
+			{
+				_SizeType ret = 0;
+				GAIA::BL bContinue = GAIA::True;
+				for(_SizeType x = 0; x < m_segments.size() && bContinue; ++x)
+					ret += this->walk(*m_segments[x], pKeys, keysize, bMatchLeft, bMatchRight, v, bContinue);
+				if(bContinue)
+					ret += this->walk(m_pending, pKeys, keysize, bMatchLeft, bMatchRight, v, bContinue);
+				return ret;
+			}
+			GINL _SizeType walk(Segment& seg, const _KeyType* pKeys, const _SizeType& keysize, GAIA::BL bMatchLeft, GAIA::BL bMatchRight, Visitor& v, GAIA::BL& bContinue)
+			{
+				if(seg.livesize() == 0)
+					return 0;
+
+				// Backward search, the rows [sBegin, sEnd) are the suffixes start with the searched key list.
+				_SizeType sBegin = 0;
+				_SizeType sEnd = seg.textsize;
+				if(bMatchRight)
+				{
+					sBegin = seg.lf(GSCAST(_SizeType)(CODE_SEPARATOR), sBegin);
+					sEnd = seg.lf(GSCAST(_SizeType)(CODE_SEPARATOR), sEnd);
+				}
+				for(_SizeType x = keysize; x > 0 && sBegin < sEnd; --x)
+				{
+					_SizeType c = seg.code(pKeys[x - 1]);
+					if(c == CODE_END)
+						return 0;
+					sBegin = seg.lf(c, sBegin);
+					sEnd = seg.lf(c, sEnd);
+				}
+				if(bMatchLeft && sBegin < sEnd)
+				{
+					sBegin = seg.lf(GSCAST(_SizeType)(CODE_SEPARATOR), sBegin);
+					sEnd = seg.lf(GSCAST(_SizeType)(CODE_SEPARATOR), sEnd);
+				}
+
+				// Locate the matches.
+				_SizeType ret = 0;
+				for(_SizeType x = sBegin; x < sEnd; ++x)
+				{
+					_SizeType sIndex = seg.keyindex(seg.locate(x));
+					if(seg.erased.exist(sIndex))
+						continue;
+					++ret;
+					if(!v.visit(seg, sIndex))
+					{
+						bContinue = GAIA::False;
+						break;
+					}
+				}
+				return ret;
+			}
+			GINL _SizeType walk(Pending& pending, const _KeyType* pKeys, const _SizeType& keysize, GAIA::BL bMatchLeft, GAIA::BL bMatchRight, Visitor& v, GAIA::BL& bContinue)
+			{
+				_SizeType ret = 0;
+				for(_SizeType x = 0; x < pending.datas.size(); ++x)
+				{
+					const _KeyType* p = pending.keys.fptr() + pending.offsets[x];
+					_SizeType sSize = pending.offsets[x + 1] - pending.offsets[x];
+					if(sSize < keysize)
+						continue;
+					_SizeType sFirst = bMatchRight ? sSize - keysize : 0;
+					_SizeType sLast = bMatchLeft ? 0 : sSize - keysize;
+					for(_SizeType y = sFirst; y <= sLast; ++y)
+					{
+						if(pending.erased.exist(x))
+							break;
+						_SizeType z = 0;
+						for(; z < keysize; ++z)
+						{
+							if(!(p[y + z] == pKeys[z]))
+								break;
+						}
+						if(z != keysize)
+							continue;
+						++ret;
+						if(!v.visit(pending, x))
+						{
+							bContinue = GAIA::False;
+							return ret;
+						}
+					}
+				}
+				return ret;
+			}
+		private:
+			GAIA::CTN::BasicVector<Segment*, _SizeType, _ExtendType> m_segments;
+			Pending m_pending;
+			_SizeType m_size;
+		};
+	}
+}
+
+#endif
@@ -281,7 +281,7 @@ namespace GAIA
 			{
 				this->optimize(this->size() + 1);
 				_HashType h = (_HashType)GAIA::ALGO::hash(k);
-				_SizeType hm = h % m_groups.size();
+				_SizeType hm = (_SizeType)((GAIA::U64)h % (GAIA::U64)m_groups.size());
 				Group& g = m_groups[hm];
 				Node* pNode = m_nodepool.alloc();
 				pNode->k = k;
@@ -305,7 +305,7 @@ namespace GAIA
 			GINL GAIA::BL erase(const _KeyType& k)
 			{
 				_HashType h = (_HashType)GAIA::ALGO::hash(k);
-				_SizeType hm = h % m_groups.size();
+				_SizeType hm = (_SizeType)((GAIA::U64)h % (GAIA::U64)m_groups.size());
 				Group& g = m_groups[hm];
 				Node* pNode = g.pLocalFront;
 				GAIA::BL bExist = GAIA::False;
@@ -346,7 +346,7 @@ namespace GAIA
 				Node* pNode = iter.m_pNode;
 				iter.m_pNode = pNode->pGlobalNext;
 				_HashType h = (_HashType)GAIA::ALGO::hash(pNode->k);
-				_SizeType hm = h % m_groups.size();
+				_SizeType hm = (_SizeType)((GAIA::U64)h % (GAIA::U64)m_groups.size());
 				Group& g = m_groups[hm];
 				if(pNode->pLocalPrev != GNIL)
 					pNode->pLocalPrev->pLocalNext = pNode->pLocalNext;
@@ -370,7 +370,7 @@ namespace GAIA
 				if(m_groups.empty())
 					return GNIL;
 				_HashType h = (_HashType)GAIA::ALGO::hash(k);
-				_SizeType hm = h % m_groups.size();
+				_SizeType hm = (_SizeType)((GAIA::U64)h % (GAIA::U64)m_groups.size());
 				Group& g = m_groups[hm];
 				Node* pNode = g.pLocalFront;
 				while(pNode != GNIL)
@@ -452,8 +452,9 @@ namespace GAIA
 					{
 						Node* pNextNode = pNode->pLocalNext;
 						GAST(m_groups.size() > 0);
-						_SizeType hm = pNode->h % m_groups.size();
+						_SizeType hm = (_SizeType)((GAIA::U64)pNode->h % (GAIA::U64)m_groups.size());
 						Group& gdst = m_groups[hm];
+						pNode->pLocalPrev = GNIL;
 						pNode->pLocalNext = gdst.pLocalFront;
 						if(gdst.pLocalFront != GNIL)
 							gdst.pLocalFront->pLocalPrev = pNode;
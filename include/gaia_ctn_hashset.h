@@ -277,7 +277,7 @@ namespace GAIA
 			{
 				this->optimize(this->size() + 1);
 				_HashType h = (_HashType)GAIA::ALGO::hash(t);
-				_SizeType hm = h % m_groups.size();
+				_SizeType hm = (_SizeType)((GAIA::U64)h % (GAIA::U64)m_groups.size());
 				Group& g = m_groups[hm];
 				Node* pNode = m_nodepool.alloc();
 				pNode->t = t;
@@ -300,7 +300,7 @@ namespace GAIA
 			GINL GAIA::BL erase(const _DataType& t)
 			{
 				_HashType h = (_HashType)GAIA::ALGO::hash(t);
-				_SizeType hm = h % m_groups.size();
+				_SizeType hm = (_SizeType)((GAIA::U64)h % (GAIA::U64)m_groups.size());
 				Group& g = m_groups[hm];
 				Node* pNode = g.pLocalFront;
 				GAIA::BL bExist = GAIA::False;
@@ -341,7 +341,7 @@ namespace GAIA
 				Node* pNode = iter.m_pNode;
 				iter.m_pNode = pNode->pGlobalNext;
 				_HashType h = (_HashType)GAIA::ALGO::hash(pNode->t);
-				_SizeType hm = h % m_groups.size();
+				_SizeType hm = (_SizeType)((GAIA::U64)h % (GAIA::U64)m_groups.size());
 				Group& g = m_groups[hm];
 				if(pNode->pLocalPrev != GNIL)
 					pNode->pLocalPrev->pLocalNext = pNode->pLocalNext;
@@ -365,7 +365,7 @@ namespace GAIA
 				if(m_groups.empty())
 					return GNIL;
 				_HashType h = (_HashType)GAIA::ALGO::hash(t);
-				_SizeType hm = h % m_groups.size();
+				_SizeType hm = (_SizeType)((GAIA::U64)h % (GAIA::U64)m_groups.size());
 				Group& g = m_groups[hm];
 				Node* pNode = g.pLocalFront;
 				while(pNode != GNIL)
@@ -447,8 +447,9 @@ namespace GAIA
 					{
 						Node* pNextNode = pNode->pLocalNext;
 						GAST(m_groups.size() > 0);
-						_SizeType hm = pNode->h % m_groups.size();
+						_SizeType hm = (_SizeType)((GAIA::U64)pNode->h % (GAIA::U64)m_groups.size());
 						Group& gdst = m_groups[hm];
+						pNode->pLocalPrev = GNIL;
 						pNode->pLocalNext = gdst.pLocalFront;
 						if(gdst.pLocalFront != GNIL)
 							gdst.pLocalFront->pLocalPrev = pNode;
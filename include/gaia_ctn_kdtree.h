@@ -4,119 +4,478 @@
 #include "gaia_type.h"
 #include "gaia_assert.h"
 #include "gaia_algo_extend.h"
-#include "gaia_ctn_pool.h"
-#include "gaia_ctn_avltree.h"
+#include "gaia_algo_sort.h"
+#include "gaia_ctn_vector.h"
+#include "gaia_ctn_bitset.h"
+#include "gaia_thread_pool.h"
 
 namespace GAIA
 {
 	namespace CTN
 	{
-		template<
-			typename _DataType,
-			typename _SizeType,
-			typename _HeightType,
-			typename _ExtendType
-		> class BasicKDTree : public GAIA::Base
+		/*!
+			@brief The k-d tree of points, the point type is GAIA::MATH::VEC2 or GAIA::MATH::VEC3.
+
+			@remarks
+				The tree is kept in a implicit array, the node of the item range [b, e) is the item (b + e) / 2, the left child
+				is the range [b, mid) and the right child is the range [mid + 1, e). The split dimension of a node is the
+				dimension which has the widest spread in its range, the items of the left child are not greater than the node
+				and the items of the right child are not less than the node on the split dimension.
+
+				The items inserted after build are kept after the tree as the pending items, they are scanned by the queries,
+				and the tree is rebuilt when the pending items are more than 1/8 of the tree. The erased items of the tree are
+				marked, and the tree is rebuilt when the erased items are more than half of the tree.
+
+				The query results point to the items in the tree, they are invalid after the next insert, erase or build.
+		*/
+		template<typename _DataType, typename _VecType, typename _SizeType, typename _ExtendType> class BasicKDTree : public GAIA::Base
 		{
 		public:
-			class Node;
-			class Split : public GAIA::Base
+			typedef _DataType _datatype;
+			typedef _VecType _vectype;
+			typedef _SizeType _sizetype;
+			typedef _ExtendType _extendtype;
+			typedef typename _VecType::_datatype _valuetype;
+		public:
+			static const _SizeType PENDING_MIN_SIZE = 64; // The pending item count which never cause a rebuild.
+		public:
+			class Item : public GAIA::Base
 			{
-			private:
-				friend class BasicKDTree;
 			public:
-				GINL Split(){}
-			private:
-				Node* m_pParent;
-				Node* m_pLeft;
-				Node* m_pRight;
+				_VecType pos;
+				_DataType t;
 			};
-			class Node : public GAIA::Base
+			class Neighbor : public GAIA::Base
 			{
-			private:
-				friend class BasicKDTree;
 			public:
-				typedef BasicAVLTree<_DataType*, _SizeType, _HeightType, _ExtendType> __AVLTreeType;
+				GINL Neighbor(){pItem = GNIL; distsq = 0;}
+				GCLASS_COMPARE(distsq, Neighbor)
 			public:
-				Node(){}
-			private:
-				__AVLTreeType m_avltree;
-				Split* m_pParent;
-				Split* m_pSplit;
+				const Item* pItem;
+				_valuetype distsq; // The square of the distance to the query point.
 			};
 		public:
-			typedef _DataType _datatype;
-			typedef _SizeType _sizetype;
-			typedef _HeightType _heighttype;
-			typedef _ExtendType _extendtype;
-		public:
-			typedef BasicKDTree<_DataType, _SizeType, _HeightType, _ExtendType> __MyType;
-			typedef BasicPool<Node, _SizeType, _ExtendType> __NodePoolType;
-			typedef BasicPool<Split, _SizeType, _ExtendType> __SplitPoolType;
-			typedef BasicAVLTree<Pair<_DataType, Node*>, _SizeType, _HeightType, _ExtendType> __AVLTreeType;
+			typedef BasicKDTree<_DataType, _VecType, _SizeType, _ExtendType> __MyType;
+			typedef GAIA::CTN::BasicVector<Item, _SizeType, _ExtendType> __ItemListType;
+			typedef GAIA::CTN::BasicVector<Neighbor, _SizeType, _ExtendType> __NeighborListType;
+			typedef GAIA::CTN::BasicVector<const Item*, _SizeType, _ExtendType> __ItemPtrListType;
+		private:
+			typedef GAIA::CTN::BasicVector<GAIA::U8, _SizeType, _ExtendType> __DimListType;
+			typedef GAIA::CTN::BasicBitset<_SizeType, _ExtendType> __BitsetType;
+		private:
+			class NearestFunc : public GAIA::Base
+			{
+			public:
+				GINL NearestFunc(const __MyType& tree, const _VecType* pPos, const _SizeType& k, Neighbor* pResults) : m_tree(tree)
+				{
+					m_pPos = pPos;
+					m_k = k;
+					m_pResults = pResults;
+				}
+				GINL GAIA::GVOID operator () (GAIA::NUM sBegin, GAIA::NUM sEnd) const
+				{
+					for(GAIA::NUM x = sBegin; x < sEnd; ++x)
+					{
+						Neighbor* p = m_pResults + (GAIA::N64)x * m_k;
+						_SizeType sCount = m_tree.nearest(m_pPos[x], m_k, p);
+						for(_SizeType y = sCount; y < m_k; ++y)
+							p[y] = Neighbor();
+					}
+				}
+			private:
+				const __MyType& m_tree;
+				const _VecType* m_pPos;
+				_SizeType m_k;
+				Neighbor* m_pResults;
+			};
 		public:
 			GINL BasicKDTree(){this->init();}
 			GINL BasicKDTree(const __MyType& src){this->init(); this->operator = (src);}
 			GINL GAIA::BL empty() const{return this->size() == 0;}
 			GINL const _SizeType& size() const{return m_size;}
-			GINL GAIA::GVOID clear(){m_pRoot = GNIL; m_nodepool.clear(); m_splitpool.clear(); m_avltree.clear();}
-			GINL GAIA::GVOID destroy(){m_pRoot = GNIL; m_nodepool.destroy(); m_splitpool.destroy(); m_avltree.destroy();}
-			GINL GAIA::BL insert(const _DataType& t)
+			GINL GAIA::GVOID clear(){m_items.clear(); m_dims.clear(); m_erased.resize(0); m_treesize = 0; m_erasedcount = 0; m_size = 0;}
+			GINL GAIA::GVOID destroy(){m_items.destroy(); m_dims.destroy(); m_erased.destroy(); m_treesize = 0; m_erasedcount = 0; m_size = 0;}
+			GINL GAIA::GVOID insert(const _VecType& pos, const _DataType& t)
 			{
-				return GAIA::True;
+				Item item;
+				item.pos = pos;
+				item.t = t;
+				m_items.push_back(item);
+				++m_size;
+				if(m_items.size() - m_treesize > GAIA::ALGO::gmax(GSCAST(_SizeType)(PENDING_MIN_SIZE), m_treesize / 8))
+					this->build();
 			}
-			GINL GAIA::BL erase(const _DataType& t)
+			GINL GAIA::BL erase(const _VecType& pos, const _DataType& t)
 			{
-				typename __AVLTreeType::_datatype pr(t, GNIL);
-				typename __AVLTreeType::_datatype* pGlobalRec = m_avltree.find(pr);
-				if(pGlobalRec == GNIL)
+				for(_SizeType x = m_treesize; x < m_items.size(); ++x)
+				{
+					if(m_items[x].pos == pos && m_items[x].t == t)
+					{
+						if(x != m_items.size() - 1)
+							m_items[x] = m_items[m_items.size() - 1];
+						m_items.resize(m_items.size() - 1);
+						--m_size;
+						return GAIA::True;
+					}
+				}
+				_SizeType sIndex = this->find_recursive(0, m_treesize, pos, &t);
+				if(sIndex == (_SizeType)GINVALID)
 					return GAIA::False;
-				Node* pNode = pGlobalRec->back();
-				GAST(!!pNode);
-				GAIA::BL ret = pNode->m_avltree.erase(&pGlobalRec->front());
-				if(ret)
-					--m_size;
-				Split* pSplit = GNIL;
-				while(pNode != GNIL || pSplit != GNIL)
+				m_erased.set(sIndex);
+				++m_erasedcount;
+				--m_size;
+				if(m_erasedcount * 2 > m_treesize)
+					this->build();
+				return GAIA::True;
+			}
+			GINL const _DataType* find(const _VecType& pos) const
+			{
+				_SizeType sIndex = this->find_recursive(0, m_treesize, pos, GNIL);
+				if(sIndex != (_SizeType)GINVALID)
+					return &m_items[sIndex].t;
+				for(_SizeType x = m_treesize; x < m_items.size(); ++x)
+				{
+					if(m_items[x].pos == pos)
+						return &m_items[x].t;
+				}
+				return GNIL;
+			}
+			GINL _DataType* find(const _VecType& pos){return GCCAST(_DataType*)(GCCAST(const __MyType*)(this)->find(pos));}
+
+			/*!
+				@brief Build the tree by all the items.
+
+				@remarks
+					The items are partitioned at the median of the widest dimension recursively, it is O(n log n).
+					The erased items are dropped. Call it after a batch insert to make the queries fastest.
+			*/
+			GINL GAIA::GVOID build()
+			{
+				if(m_erasedcount > 0)
 				{
-					if(pSplit != GNIL)
+					_SizeType sLive = 0;
+					for(_SizeType x = 0; x < m_items.size(); ++x)
 					{
-						if(pSplit->m_pLeft == pNode)
-							pSplit->m_pLeft = GNIL;
-						else
-							pSplit->m_pRight = GNIL;
-						if(pSplit->m_pLeft != GNIL || pSplit->m_pRight != GNIL)
-							break;
-						else
+						if(x < m_treesize && m_erased.exist(x))
+							continue;
+						if(sLive != x)
+							m_items[sLive] = m_items[x];
+						++sLive;
+					}
+					m_items.resize(sLive);
+				}
+				GAST(m_items.size() == m_size);
+				m_treesize = m_items.size();
+				m_erasedcount = 0;
+				m_erased.resize(0);
+				m_erased.resize(m_treesize);
+				m_dims.resize(m_treesize);
+				this->build_recursive(0, m_treesize);
+			}
+
+			/*!
+				@brief Find the k nearest items of a point.
+
+				@param pos [in] Specify the point.
+
+				@param k [in] Specify the max item count of the result.
+
+				@param result [out] Used for saving the nearest items, ordered by the distance from near to far.
+			*/
+			GINL GAIA::GVOID nearest(const _VecType& pos, const _SizeType& k, __NeighborListType& result) const
+			{
+				GAST(k >= 0);
+				result.resize(k);
+				if(k <= 0)
+					return;
+				result.resize(this->nearest(pos, k, result.fptr()));
+			}
+
+			/*!
+				@brief Find the k nearest items of every point in a thread pool.
+
+				@param pool [in] Specify the thread pool, if it is not begin the points are queried by the calling thread.
+
+				@param pPos [in] Specify the points.
+
+				@param count [in] Specify the point count.
+
+				@param k [in] Specify the max item count of a point.
+
+				@param result [out] Used for saving the results, the result of point x is [x * k, x * k + k),
+					ordered by the distance from near to far, and the Neighbor::pItem after the found items is GNIL.
+			*/
+			GINL GAIA::GVOID nearest(GAIA::THREAD::ThreadPool& pool, const _VecType* pPos, const _SizeType& count, const _SizeType& k, __NeighborListType& result) const
+			{
+				GAST(pPos != GNIL);
+				GAST(count >= 0);
+				GAST(k > 0);
+				result.resize(count * k);
+				if(count <= 0 || k <= 0)
+					return;
+				NearestFunc func(*this, pPos, k, result.fptr());
+				pool.ParallelFor(0, (GAIA::NUM)count, GAIA::ALGO::gmax((GAIA::NUM)count / (pool.GetThreadCount() * 8 + 1), 16), func);
+			}
+
+			/*!
+				@brief Find the items in a sphere or a circle.
+
+				@param pos [in] Specify the center point.
+
+				@param radius [in] Specify the radius, the items on the surface are found too.
+
+				@param result [out] Used for saving the found items, ordered by the distance from near to far.
+			*/
+			GINL GAIA::GVOID radius(const _VecType& pos, const _valuetype& radius, __NeighborListType& result) const
+			{
+				result.clear();
+				_valuetype radiussq = radius * radius;
+				this->radius_recursive(0, m_treesize, pos, radiussq, result);
+				for(_SizeType x = m_treesize; x < m_items.size(); ++x)
+				{
+					Neighbor n;
+					n.pItem = &m_items[x];
+					n.distsq = (m_items[x].pos - pos).lengthsq();
+					if(n.distsq <= radiussq)
+						result.push_back(n);
+				}
+				if(result.size() > 1)
+					GAIA::ALGO::sort(result.fptr(), result.bptr());
+			}
+
+			/*!
+				@brief Find the items in a box.
+
+				@param box [in] Specify the box, it is GAIA::MATH::AABR for GAIA::MATH::VEC2, and GAIA::MATH::AABB for GAIA::MATH::VEC3.
+					The items on the box faces are found too.
+
+				@param result [out] Used for saving the found items.
+			*/
+			template<typename _BoxType> GAIA::GVOID range(const _BoxType& box, __ItemPtrListType& result) const
+			{
+				result.clear();
+				this->range_recursive(0, m_treesize, box.pmin, box.pmax, result);
+				for(_SizeType x = m_treesize; x < m_items.size(); ++x)
+				{
+					if(this->inside(m_items[x].pos, box.pmin, box.pmax))
+						result.push_back(&m_items[x]);
+				}
+			}
+			GINL __MyType& operator = (const __MyType& src)
+			{
+				GAST(&src != this);
+				m_items = src.m_items;
+				m_dims = src.m_dims;
+				m_erased = src.m_erased;
+				m_treesize = src.m_treesize;
+				m_erasedcount = src.m_erasedcount;
+				m_size = src.m_size;
+				return *this;
+			}
+		private:
+			GINL GAIA::GVOID init(){m_treesize = 0; m_erasedcount = 0; m_size = 0;}
+			static GINL GAIA::NUM dimension(){return _VecType().size();}
+			static GINL GAIA::BL inside(const _VecType& pos, const _VecType& pmin, const _VecType& pmax)
+			{
+				for(GAIA::NUM x = 0; x < dimension(); ++x)
+				{
+					if(pos.fptr()[x] < pmin.fptr()[x] || pos.fptr()[x] > pmax.fptr()[x])
+						return GAIA::False;
+				}
+				return GAIA::True;
+			}
+			GINL GAIA::GVOID build_recursive(const _SizeType& sBegin, const _SizeType& sEnd)
+			{
+				if(sEnd - sBegin <= 0)
+					return;
+				_SizeType sMid = sBegin + (sEnd - sBegin) / 2;
+
+				// Choose the dimension of the widest spread.
+				GAIA::NUM sDim = 0;
+				if(sEnd - sBegin > 1)
+				{
+					_VecType vMin = m_items[sBegin].pos;
+					_VecType vMax = m_items[sBegin].pos;
+					for(_SizeType x = sBegin + 1; x < sEnd; ++x)
+					{
+						vMin.minimize(m_items[x].pos);
+						vMax.maximize(m_items[x].pos);
+					}
+					_VecType vSpread = vMax - vMin;
+					for(GAIA::NUM x = 1; x < dimension(); ++x)
+					{
+						if(vSpread.fptr()[x] > vSpread.fptr()[sDim])
+							sDim = x;
+					}
+					this->select(sBegin, sEnd, sMid, sDim);
+				}
+				m_dims[sMid] = (GAIA::U8)sDim;
+				this->build_recursive(sBegin, sMid);
+				this->build_recursive(sMid + 1, sEnd);
+			}
+			GINL GAIA::GVOID select(_SizeType sBegin, _SizeType sEnd, const _SizeType& sNth, const GAIA::NUM& sDim)
+			{
+				// Quick select, the items before sNth are not greater than it and the items after sNth are not less than it.
+				while(sEnd - sBegin > 1)
+				{
+					const _valuetype& v1 = m_items[sBegin].pos.fptr()[sDim];
+					const _valuetype& v2 = m_items[sBegin + (sEnd - sBegin) / 2].pos.fptr()[sDim];
+					const _valuetype& v3 = m_items[sEnd - 1].pos.fptr()[sDim];
+					_valuetype vPivot = v1 < v2 ? (v2 < v3 ? v2 : (v1 < v3 ? v3 : v1)) : (v1 < v3 ? v1 : (v2 < v3 ? v3 : v2));
+					_SizeType sLeft = sBegin;
+					_SizeType sRight = sEnd - 1;
+					while(sLeft <= sRight)
+					{
+						while(m_items[sLeft].pos.fptr()[sDim] < vPivot)
+							++sLeft;
+						while(vPivot < m_items[sRight].pos.fptr()[sDim])
+							--sRight;
+						if(sLeft <= sRight)
 						{
-							pSplit->m_pParent->m_pSplit = GNIL;
-							pNode = pSplit->m_pParent;
-							m_splitpool.release(pSplit);
-							pSplit = GNIL;
+							if(sLeft != sRight)
+								GAIA::ALGO::swap(m_items[sLeft], m_items[sRight]);
+							++sLeft;
+							--sRight;
 						}
 					}
-					else if(pNode != GNIL)
+					if(sNth <= sRight)
+						sEnd = sRight + 1;
+					else if(sNth >= sLeft)
+						sBegin = sLeft;
+					else
+						break;
+				}
+			}
+			GINL _SizeType find_recursive(const _SizeType& sBegin, const _SizeType& sEnd, const _VecType& pos, const _DataType* pData) const
+			{
+				if(sEnd - sBegin <= 0)
+					return (_SizeType)GINVALID;
+				_SizeType sMid = sBegin + (sEnd - sBegin) / 2;
+				const Item& item = m_items[sMid];
+				if(!m_erased.exist(sMid) && item.pos == pos && (pData == GNIL || item.t == *pData))
+					return sMid;
+				GAIA::NUM sDim = m_dims[sMid];
+				_SizeType ret = (_SizeType)GINVALID;
+				if(!(item.pos.fptr()[sDim] < pos.fptr()[sDim]))
+					ret = this->find_recursive(sBegin, sMid, pos, pData);
+				if(ret == (_SizeType)GINVALID && !(pos.fptr()[sDim] < item.pos.fptr()[sDim]))
+					ret = this->find_recursive(sMid + 1, sEnd, pos, pData);
+				return ret;
+			}
+			GINL _SizeType nearest(const _VecType& pos, const _SizeType& k, Neighbor* pHeap) const
+			{
+				// pHeap is a max heap of the distance while searching, and it is sorted at last.
+				_SizeType sCount = 0;
+				this->nearest_recursive(0, m_treesize, pos, k, pHeap, sCount);
+				for(_SizeType x = m_treesize; x < m_items.size(); ++x)
+					this->push_heap(pHeap, sCount, k, &m_items[x], (m_items[x].pos - pos).lengthsq());
+				if(sCount > 1)
+					GAIA::ALGO::sort(pHeap, pHeap + sCount - 1);
+				return sCount;
+			}
+			GINL GAIA::GVOID nearest_recursive(const _SizeType& sBegin, const _SizeType& sEnd, const _VecType& pos, const _SizeType& k, Neighbor* pHeap, _SizeType& sCount) const
+			{
+				if(sEnd - sBegin <= 0)
+					return;
+				_SizeType sMid = sBegin + (sEnd - sBegin) / 2;
+				const Item& item = m_items[sMid];
+				if(!m_erased.exist(sMid))
+					this->push_heap(pHeap, sCount, k, &item, (item.pos - pos).lengthsq());
+				GAIA::NUM sDim = m_dims[sMid];
+				_valuetype diff = pos.fptr()[sDim] - item.pos.fptr()[sDim];
+				if(diff < (_valuetype)0)
+				{
+					this->nearest_recursive(sBegin, sMid, pos, k, pHeap, sCount);
+					if(sCount < k || diff * diff < pHeap[0].distsq)
+						this->nearest_recursive(sMid + 1, sEnd, pos, k, pHeap, sCount);
+				}
+				else
+				{
+					this->nearest_recursive(sMid + 1, sEnd, pos, k, pHeap, sCount);
+					if(sCount < k || diff * diff < pHeap[0].distsq)
+						this->nearest_recursive(sBegin, sMid, pos, k, pHeap, sCount);
+				}
+			}
+			GINL GAIA::GVOID push_heap(Neighbor* pHeap, _SizeType& sCount, const _SizeType& k, const Item* pItem, const _valuetype& distsq) const
+			{
+				_SizeType sIndex;
+				if(sCount < k)
+				{
+					// Sift up.
+					sIndex = sCount++;
+					while(sIndex > 0)
 					{
-						if(!pNode->m_avltree.empty())
+						_SizeType sParent = (sIndex - 1) / 2;
+						if(!(pHeap[sParent].distsq < distsq))
 							break;
-						pSplit = pNode->m_pParent;
-						m_nodepool.release(pNode);
-						pNode = GNIL;
+						pHeap[sIndex] = pHeap[sParent];
+						sIndex = sParent;
 					}
 				}
-				return ret;
+				else
+				{
+					// Replace the farthest one and sift down.
+					if(!(distsq < pHeap[0].distsq))
+						return;
+					sIndex = 0;
+					for(;;)
+					{
+						_SizeType sChild = sIndex * 2 + 1;
+						if(sChild >= sCount)
+							break;
+						if(sChild + 1 < sCount && pHeap[sChild].distsq < pHeap[sChild + 1].distsq)
+							++sChild;
+						if(!(distsq < pHeap[sChild].distsq))
+							break;
+						pHeap[sIndex] = pHeap[sChild];
+						sIndex = sChild;
+					}
+				}
+				pHeap[sIndex].pItem = pItem;
+				pHeap[sIndex].distsq = distsq;
+			}
+			GINL GAIA::GVOID radius_recursive(const _SizeType& sBegin, const _SizeType& sEnd, const _VecType& pos, const _valuetype& radiussq, __NeighborListType& result) const
+			{
+				if(sEnd - sBegin <= 0)
+					return;
+				_SizeType sMid = sBegin + (sEnd - sBegin) / 2;
+				const Item& item = m_items[sMid];
+				if(!m_erased.exist(sMid))
+				{
+					Neighbor n;
+					n.pItem = &item;
+					n.distsq = (item.pos - pos).lengthsq();
+					if(n.distsq <= radiussq)
+						result.push_back(n);
+				}
+				GAIA::NUM sDim = m_dims[sMid];
+				_valuetype diff = pos.fptr()[sDim] - item.pos.fptr()[sDim];
+				if(diff <= (_valuetype)0 || diff * diff <= radiussq)
+					this->radius_recursive(sBegin, sMid, pos, radiussq, result);
+				if(diff >= (_valuetype)0 || diff * diff <= radiussq)
+					this->radius_recursive(sMid + 1, sEnd, pos, radiussq, result);
+			}
+			GINL GAIA::GVOID range_recursive(const _SizeType& sBegin, const _SizeType& sEnd, const _VecType& pmin, const _VecType& pmax, __ItemPtrListType& result) const
+			{
+				if(sEnd - sBegin <= 0)
+					return;
+				_SizeType sMid = sBegin + (sEnd - sBegin) / 2;
+				const Item& item = m_items[sMid];
+				if(!m_erased.exist(sMid) && this->inside(item.pos, pmin, pmax))
+					result.push_back(&item);
+				GAIA::NUM sDim = m_dims[sMid];
+				if(!(item.pos.fptr()[sDim] < pmin.fptr()[sDim]))
+					this->range_recursive(sBegin, sMid, pmin, pmax, result);
+				if(!(pmax.fptr()[sDim] < item.pos.fptr()[sDim]))
+					this->range_recursive(sMid + 1, sEnd, pmin, pmax, result);
 			}
-			GINL _DataType* find(const _DataType& t){return m_avltree.find(t);}
-			GINL const _DataType* find(const _DataType& t) const{return m_avltree.find(t);}
-			GINL __MyType& operator = (const __MyType& src){GAST(&src != this); return *this;}
-		private:
-			GINL GAIA::GVOID init(){m_pRoot = GNIL; m_size = 0;}
 		private:
-			Node* m_pRoot;
+			__ItemListType m_items; // The tree items in [0, m_treesize), and the pending items after them.
+			__DimListType m_dims; // The split dimension of the tree items.
+			__BitsetType m_erased; // The erased tree items.
+			_SizeType m_treesize;
+			_SizeType m_erasedcount;
 			_SizeType m_size;
-			__NodePoolType m_nodepool;
-			__SplitPoolType m_splitpool;
-			__AVLTreeType m_avltree;
 		};
 	}
 }
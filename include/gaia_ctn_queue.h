@@ -5,6 +5,7 @@
 #include "gaia_assert.h"
 #include "gaia_iterator.h"
 #include "gaia_algo_extend.h"
+#include "gaia_algo_search.h"
 
 namespace GAIA
 {
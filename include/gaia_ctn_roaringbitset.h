@@ -0,0 +1,633 @@
+#ifndef		__GAIA_CTN_ROARINGBITSET_H__
+#define		__GAIA_CTN_ROARINGBITSET_H__
+
+#include "gaia_type.h"
+#include "gaia_assert.h"
+#include "gaia_ctn_vector.h"
+#include "gaia_ctn_bitset.h"
+
+namespace GAIA
+{
+	namespace CTN
+	{
+		/*!
+			@brief The compressed bit set of 32 bits unsigned integers.
+
+			@remarks
+				The values are grouped by the high 16 bits, every group is a container of the low 16 bits.
+				A container which has not more than ARRAY_MAX_SIZE values is a sorted array of the low 16 bits,
+				and the others are a 65536 bits bitmap, so a sparse group costs 2 bytes per value and a dense
+				group costs 8KB at most. The containers are sorted by the high 16 bits.
+
+				The bitmap containers are combined by the word operations of BitsetImpl, the array containers are
+				combined by merging.
+		*/
+		template<typename _SizeType> class BasicRoaringBitset : public GAIA::Base
+		{
+		public:
+			typedef _SizeType _sizetype;
+		public:
+			typedef BasicRoaringBitset<_SizeType> __MyType;
+		public:
+			static const GAIA::NUM ARRAY_MAX_SIZE = 4096;
+			static const GAIA::NUM BITMAP_WORD_COUNT = 65536 / 64;
+		private:
+			class Container : public GAIA::Base
+			{
+			public:
+				GINL Container(GAIA::U16 uKey){this->init(); m_uKey = uKey;}
+				GINL Container(const Container& src)
+				{
+					this->init();
+					m_uKey = src.m_uKey;
+					m_sSize = src.m_sSize;
+					if(src.m_pBitmap != GNIL)
+					{
+						m_pBitmap = gnew GAIA::U64[BITMAP_WORD_COUNT];
+						GAIA::ALGO::gmemcpy(m_pBitmap, src.m_pBitmap, BITMAP_WORD_COUNT * sizeof(GAIA::U64));
+					}
+					else if(src.m_sSize > 0)
+					{
+						m_sCapacity = src.m_sSize;
+						m_pArray = gnew GAIA::U16[m_sCapacity];
+						GAIA::ALGO::gmemcpy(m_pArray, src.m_pArray, src.m_sSize * sizeof(GAIA::U16));
+					}
+				}
+				GINL ~Container()
+				{
+					if(m_pArray != GNIL)
+						gdel[] m_pArray;
+					if(m_pBitmap != GNIL)
+						gdel[] m_pBitmap;
+				}
+				GINL GAIA::U16 Key() const{return m_uKey;}
+				GINL GAIA::NUM Size() const{return m_sSize;}
+				GINL GAIA::BL Exist(GAIA::U16 v) const
+				{
+					if(m_pBitmap != GNIL)
+						return (m_pBitmap[v / 64] & ((GAIA::U64)1 << (v % 64))) != 0;
+					GAIA::NUM sIndex = this->LowerBound(v);
+					return sIndex < m_sSize && m_pArray[sIndex] == v;
+				}
+				GINL GAIA::BL Insert(GAIA::U16 v)
+				{
+					if(m_pBitmap != GNIL)
+					{
+						GAIA::U64 uBit = (GAIA::U64)1 << (v % 64);
+						if(m_pBitmap[v / 64] & uBit)
+							return GAIA::False;
+						m_pBitmap[v / 64] |= uBit;
+						++m_sSize;
+						return GAIA::True;
+					}
+					GAIA::NUM sIndex = this->LowerBound(v);
+					if(sIndex < m_sSize && m_pArray[sIndex] == v)
+						return GAIA::False;
+					if(m_sSize == ARRAY_MAX_SIZE)
+					{
+						this->ToBitmap();
+						return this->Insert(v);
+					}
+					if(m_sSize == m_sCapacity)
+					{
+						GAIA::NUM sNewCapacity = m_sCapacity < 4 ? 4 : m_sCapacity * 2;
+						if(sNewCapacity > ARRAY_MAX_SIZE)
+							sNewCapacity = ARRAY_MAX_SIZE;
+						GAIA::U16* pNew = gnew GAIA::U16[sNewCapacity];
+						if(m_sSize > 0)
+							GAIA::ALGO::gmemcpy(pNew, m_pArray, m_sSize * sizeof(GAIA::U16));
+						if(m_pArray != GNIL)
+							gdel[] m_pArray;
+						m_pArray = pNew;
+						m_sCapacity = sNewCapacity;
+					}
+					for(GAIA::NUM x = m_sSize; x > sIndex; --x)
+						m_pArray[x] = m_pArray[x - 1];
+					m_pArray[sIndex] = v;
+					++m_sSize;
+					return GAIA::True;
+				}
+				GINL GAIA::BL Erase(GAIA::U16 v)
+				{
+					if(m_pBitmap != GNIL)
+					{
+						GAIA::U64 uBit = (GAIA::U64)1 << (v % 64);
+						if(!(m_pBitmap[v / 64] & uBit))
+							return GAIA::False;
+						m_pBitmap[v / 64] &= ~uBit;
+						--m_sSize;
+						this->Normalize();
+						return GAIA::True;
+					}
+					GAIA::NUM sIndex = this->LowerBound(v);
+					if(sIndex >= m_sSize || m_pArray[sIndex] != v)
+						return GAIA::False;
+					for(GAIA::NUM x = sIndex + 1; x < m_sSize; ++x)
+						m_pArray[x - 1] = m_pArray[x];
+					--m_sSize;
+					return GAIA::True;
+				}
+				GINL GAIA::NUM Rank(GAIA::U16 v) const
+				{
+					if(m_pBitmap == GNIL)
+						return this->LowerBound(v);
+					GAIA::NUM sWord = v / 64;
+					GAIA::NUM ret = (GAIA::NUM)GAIA::CTN::BitsetImpl::Count(m_pBitmap, sWord);
+					if(v % 64 != 0)
+						ret += GAIA::ALGO::gpopcount(m_pBitmap[sWord] & (((GAIA::U64)1 << (v % 64)) - 1));
+					return ret;
+				}
+				GINL GAIA::U16 Select(GAIA::NUM sRank) const
+				{
+					GAST(sRank >= 0 && sRank < m_sSize);
+					if(m_pBitmap == GNIL)
+						return m_pArray[sRank];
+					for(GAIA::NUM x = 0; x < BITMAP_WORD_COUNT; ++x)
+					{
+						GAIA::NUM sCount = GAIA::ALGO::gpopcount(m_pBitmap[x]);
+						if(sRank < sCount)
+							return (GAIA::U16)(x * 64 + GAIA::CTN::BitsetImpl::Select(m_pBitmap[x], sRank));
+						sRank -= sCount;
+					}
+					GAST(GAIA::False);
+					return 0;
+				}
+				GINL GAIA::BL FindNext(GAIA::U16 v, GAIA::U16& ret) const
+				{
+					if(m_pBitmap == GNIL)
+					{
+						GAIA::NUM sIndex = this->LowerBound(v);
+						if(sIndex >= m_sSize)
+							return GAIA::False;
+						ret = m_pArray[sIndex];
+						return GAIA::True;
+					}
+					GAIA::NUM sWord = v / 64;
+					GAIA::U64 uBits = m_pBitmap[sWord] & ((GAIA::U64)GINVALID << (v % 64));
+					for(;;)
+					{
+						if(uBits != 0)
+						{
+							ret = (GAIA::U16)(sWord * 64 + GAIA::ALGO::gctz(uBits));
+							return GAIA::True;
+						}
+						if(++sWord >= BITMAP_WORD_COUNT)
+							return GAIA::False;
+						uBits = m_pBitmap[sWord];
+					}
+				}
+				GINL GAIA::GVOID Or(const Container& src)
+				{
+					if(m_pBitmap == GNIL && src.m_pBitmap == GNIL && m_sSize + src.m_sSize <= ARRAY_MAX_SIZE)
+					{
+						this->Merge(src, GAIA::True);
+						return;
+					}
+					this->ToBitmap();
+					if(src.m_pBitmap != GNIL)
+						GAIA::CTN::BitsetImpl::Or(m_pBitmap, src.m_pBitmap, BITMAP_WORD_COUNT);
+					else
+					{
+						for(GAIA::NUM x = 0; x < src.m_sSize; ++x)
+							m_pBitmap[src.m_pArray[x] / 64] |= (GAIA::U64)1 << (src.m_pArray[x] % 64);
+					}
+					m_sSize = (GAIA::NUM)GAIA::CTN::BitsetImpl::Count(m_pBitmap, BITMAP_WORD_COUNT);
+					this->Normalize();
+				}
+				GINL GAIA::GVOID And(const Container& src)
+				{
+					if(m_pBitmap == GNIL)
+						this->Filter(src, GAIA::True);
+					else if(src.m_pBitmap == GNIL)
+					{
+						Container c(src);
+						c.Filter(*this, GAIA::True);
+						this->Swap(c);
+					}
+					else
+					{
+						GAIA::CTN::BitsetImpl::And(m_pBitmap, src.m_pBitmap, BITMAP_WORD_COUNT);
+						m_sSize = (GAIA::NUM)GAIA::CTN::BitsetImpl::Count(m_pBitmap, BITMAP_WORD_COUNT);
+						this->Normalize();
+					}
+				}
+				GINL GAIA::GVOID Xor(const Container& src)
+				{
+					if(m_pBitmap == GNIL && src.m_pBitmap == GNIL && m_sSize + src.m_sSize <= ARRAY_MAX_SIZE)
+					{
+						this->Merge(src, GAIA::False);
+						return;
+					}
+					this->ToBitmap();
+					if(src.m_pBitmap != GNIL)
+						GAIA::CTN::BitsetImpl::Xor(m_pBitmap, src.m_pBitmap, BITMAP_WORD_COUNT);
+					else
+					{
+						for(GAIA::NUM x = 0; x < src.m_sSize; ++x)
+							m_pBitmap[src.m_pArray[x] / 64] ^= (GAIA::U64)1 << (src.m_pArray[x] % 64);
+					}
+					m_sSize = (GAIA::NUM)GAIA::CTN::BitsetImpl::Count(m_pBitmap, BITMAP_WORD_COUNT);
+					this->Normalize();
+				}
+				GINL GAIA::GVOID AndNot(const Container& src)
+				{
+					if(m_pBitmap == GNIL)
+					{
+						this->Filter(src, GAIA::False);
+						return;
+					}
+					if(src.m_pBitmap != GNIL)
+						GAIA::CTN::BitsetImpl::AndNot(m_pBitmap, src.m_pBitmap, BITMAP_WORD_COUNT);
+					else
+					{
+						for(GAIA::NUM x = 0; x < src.m_sSize; ++x)
+							m_pBitmap[src.m_pArray[x] / 64] &= ~((GAIA::U64)1 << (src.m_pArray[x] % 64));
+					}
+					m_sSize = (GAIA::NUM)GAIA::CTN::BitsetImpl::Count(m_pBitmap, BITMAP_WORD_COUNT);
+					this->Normalize();
+				}
+				GINL GAIA::BL Equal(const Container& src) const
+				{
+					// The container type is decided by the size, so the same size means the same type.
+					if(m_uKey != src.m_uKey || m_sSize != src.m_sSize)
+						return GAIA::False;
+					if(m_sSize == 0)
+						return GAIA::True;
+					if(m_pBitmap != GNIL)
+						return GAIA::ALGO::gmemcmp(m_pBitmap, src.m_pBitmap, BITMAP_WORD_COUNT * sizeof(GAIA::U64)) == 0;
+					return GAIA::ALGO::gmemcmp(m_pArray, src.m_pArray, m_sSize * sizeof(GAIA::U16)) == 0;
+				}
+			private:
+				GINL Container& operator = (const Container& src);
+				GINL GAIA::GVOID init(){m_uKey = 0; m_sSize = m_sCapacity = 0; m_pArray = GNIL; m_pBitmap = GNIL;}
+				GINL GAIA::NUM LowerBound(GAIA::U16 v) const
+				{
+					GAIA::NUM sBegin = 0;
+					GAIA::NUM sEnd = m_sSize;
+					while(sBegin < sEnd)
+					{
+						GAIA::NUM sMid = sBegin + (sEnd - sBegin) / 2;
+						if(m_pArray[sMid] < v)
+							sBegin = sMid + 1;
+						else
+							sEnd = sMid;
+					}
+					return sBegin;
+				}
+				GINL GAIA::GVOID Swap(Container& src)
+				{
+					GAIA::ALGO::swap(m_sSize, src.m_sSize);
+					GAIA::ALGO::swap(m_sCapacity, src.m_sCapacity);
+					GAIA::ALGO::swap(m_pArray, src.m_pArray);
+					GAIA::ALGO::swap(m_pBitmap, src.m_pBitmap);
+				}
+				GINL GAIA::GVOID ToBitmap()
+				{
+					if(m_pBitmap != GNIL)
+						return;
+					m_pBitmap = gnew GAIA::U64[BITMAP_WORD_COUNT];
+					GAIA::ALGO::gmemset(m_pBitmap, 0, BITMAP_WORD_COUNT * sizeof(GAIA::U64));
+					for(GAIA::NUM x = 0; x < m_sSize; ++x)
+						m_pBitmap[m_pArray[x] / 64] |= (GAIA::U64)1 << (m_pArray[x] % 64);
+					if(m_pArray != GNIL)
+					{
+						gdel[] m_pArray;
+						m_pArray = GNIL;
+					}
+					m_sCapacity = 0;
+				}
+				GINL GAIA::GVOID Normalize()
+				{
+					if(m_pBitmap == GNIL || m_sSize > ARRAY_MAX_SIZE)
+						return;
+					GAST(m_pArray == GNIL);
+					if(m_sSize > 0)
+					{
+						m_sCapacity = m_sSize;
+						m_pArray = gnew GAIA::U16[m_sCapacity];
+						GAIA::NUM sIndex = 0;
+						for(GAIA::NUM x = 0; x < BITMAP_WORD_COUNT; ++x)
+						{
+							GAIA::U64 uBits = m_pBitmap[x];
+							while(uBits != 0)
+							{
+								m_pArray[sIndex++] = (GAIA::U16)(x * 64 + GAIA::ALGO::gctz(uBits));
+								uBits &= uBits - 1;
+							}
+						}
+						GAST(sIndex == m_sSize);
+					}
+					gdel[] m_pBitmap;
+					m_pBitmap = GNIL;
+				}
+				GINL GAIA::GVOID Merge(const Container& src, GAIA::BL bKeepBoth)
+				{
+					GAIA::NUM sCapacity = m_sSize + src.m_sSize;
+					if(sCapacity == 0)
+						return;
+					GAIA::U16* pNew = gnew GAIA::U16[sCapacity];
+					GAIA::NUM sSize = 0;
+					GAIA::NUM x = 0;
+					GAIA::NUM y = 0;
+					while(x < m_sSize && y < src.m_sSize)
+					{
+						if(m_pArray[x] < src.m_pArray[y])
+							pNew[sSize++] = m_pArray[x++];
+						else if(m_pArray[x] > src.m_pArray[y])
+							pNew[sSize++] = src.m_pArray[y++];
+						else
+						{
+							if(bKeepBoth)
+								pNew[sSize++] = m_pArray[x];
+							++x;
+							++y;
+						}
+					}
+					while(x < m_sSize)
+						pNew[sSize++] = m_pArray[x++];
+					while(y < src.m_sSize)
+						pNew[sSize++] = src.m_pArray[y++];
+					if(m_pArray != GNIL)
+						gdel[] m_pArray;
+					m_pArray = pNew;
+					m_sSize = sSize;
+					m_sCapacity = sCapacity;
+				}
+				GINL GAIA::GVOID Filter(const Container& src, GAIA::BL bExist)
+				{
+					GAST(m_pBitmap == GNIL);
+					GAIA::NUM sSize = 0;
+					for(GAIA::NUM x = 0; x < m_sSize; ++x)
+					{
+						if(src.Exist(m_pArray[x]) == bExist)
+							m_pArray[sSize++] = m_pArray[x];
+					}
+					m_sSize = sSize;
+				}
+			private:
+				GAIA::U16 m_uKey;
+				GAIA::NUM m_sSize;
+				GAIA::NUM m_sCapacity;
+				GAIA::U16* m_pArray;
+				GAIA::U64* m_pBitmap;
+			};
+			typedef GAIA::CTN::Vector<Container*> __ContainerList;
+		public:
+			GINL BasicRoaringBitset(){this->init();}
+			GINL BasicRoaringBitset(const __MyType& src){this->init(); this->operator = (src);}
+			GINL ~BasicRoaringBitset(){this->destroy();}
+			GINL GAIA::BL empty() const{return this->size() == 0;}
+			GINL const _SizeType& size() const{return m_size;}
+			GINL GAIA::GVOID clear()
+			{
+				for(GAIA::NUM x = 0; x < m_containers.size(); ++x)
+					gdel m_containers[x];
+				m_containers.clear();
+				m_size = 0;
+			}
+			GINL GAIA::GVOID destroy(){this->clear(); m_containers.destroy();}
+			GINL GAIA::BL exist(const GAIA::U32& v) const
+			{
+				GAIA::NUM sIndex = this->find((GAIA::U16)(v >> 16));
+				if(sIndex < 0)
+					return GAIA::False;
+				return m_containers[sIndex]->Exist((GAIA::U16)v);
+			}
+			GINL GAIA::BL insert(const GAIA::U32& v)
+			{
+				GAIA::U16 uKey = (GAIA::U16)(v >> 16);
+				GAIA::NUM sIndex = this->lower_bound(uKey);
+				if(sIndex == m_containers.size() || m_containers[sIndex]->Key() != uKey)
+					m_containers.insert(gnew Container(uKey), sIndex);
+				if(!m_containers[sIndex]->Insert((GAIA::U16)v))
+					return GAIA::False;
+				++m_size;
+				return GAIA::True;
+			}
+			GINL GAIA::BL erase(const GAIA::U32& v)
+			{
+				GAIA::NUM sIndex = this->find((GAIA::U16)(v >> 16));
+				if(sIndex < 0)
+					return GAIA::False;
+				Container* pContainer = m_containers[sIndex];
+				if(!pContainer->Erase((GAIA::U16)v))
+					return GAIA::False;
+				if(pContainer->Size() == 0)
+				{
+					gdel pContainer;
+					m_containers.erase(sIndex);
+				}
+				--m_size;
+				return GAIA::True;
+			}
+
+			/*!
+				@brief Get the count of the values which are less than a value.
+
+				@remarks The container sizes before the container of v are accumulated, so it is linear to the container count.
+			*/
+			GINL _SizeType rank(const GAIA::U32& v) const
+			{
+				GAIA::U16 uKey = (GAIA::U16)(v >> 16);
+				_SizeType ret = 0;
+				for(GAIA::NUM x = 0; x < m_containers.size(); ++x)
+				{
+					const Container* pContainer = m_containers[x];
+					if(pContainer->Key() < uKey)
+						ret += pContainer->Size();
+					else
+					{
+						if(pContainer->Key() == uKey)
+							ret += pContainer->Rank((GAIA::U16)v);
+						break;
+					}
+				}
+				return ret;
+			}
+
+			/*!
+				@brief Get a value by rank.
+
+				@param rank [in] Specify the rank(from 0) of the value.
+
+				@param v [out] Used for saving the value.
+
+				@return If the size is above rank, return GAIA::True, or will return GAIA::False.
+			*/
+			GINL GAIA::BL select(const _SizeType& rank, GAIA::U32& v) const
+			{
+				GAST(rank >= 0);
+				if(rank < 0 || rank >= this->size())
+					return GAIA::False;
+				_SizeType r = rank;
+				for(GAIA::NUM x = 0; x < m_containers.size(); ++x)
+				{
+					const Container* pContainer = m_containers[x];
+					if(r < pContainer->Size())
+					{
+						v = ((GAIA::U32)pContainer->Key() << 16) | pContainer->Select((GAIA::NUM)r);
+						return GAIA::True;
+					}
+					r -= pContainer->Size();
+				}
+				return GAIA::False;
+			}
+
+			/*!
+				@brief Find the first value which is not less than a value.
+
+				@param v [in] Specify the value to find from.
+
+				@param ret [out] Used for saving the found value.
+
+				@return If found, return GAIA::True, or will return GAIA::False.
+			*/
+			GINL GAIA::BL findnext(const GAIA::U32& v, GAIA::U32& ret) const
+			{
+				GAIA::U16 uKey = (GAIA::U16)(v >> 16);
+				for(GAIA::NUM x = this->lower_bound(uKey); x < m_containers.size(); ++x)
+				{
+					const Container* pContainer = m_containers[x];
+					GAIA::U16 uLow;
+					if(pContainer->FindNext(pContainer->Key() == uKey ? (GAIA::U16)v : 0, uLow))
+					{
+						ret = ((GAIA::U32)pContainer->Key() << 16) | uLow;
+						return GAIA::True;
+					}
+				}
+				return GAIA::False;
+			}
+			GINL __MyType& operator = (const __MyType& src)
+			{
+				GAST(&src != this);
+				this->clear();
+				m_containers.reserve(src.m_containers.size());
+				for(GAIA::NUM x = 0; x < src.m_containers.size(); ++x)
+					m_containers.push_back(gnew Container(*src.m_containers[x]));
+				m_size = src.m_size;
+				return *this;
+			}
+			GINL __MyType& operator |= (const __MyType& src){return this->combine(src, OP_OR);}
+			GINL __MyType& operator &= (const __MyType& src){return this->combine(src, OP_AND);}
+			GINL __MyType& operator ^= (const __MyType& src){return this->combine(src, OP_XOR);}
+			GINL __MyType& operator -= (const __MyType& src){return this->combine(src, OP_ANDNOT);}
+			GINL GAIA::BL operator == (const __MyType& src) const
+			{
+				if(this->size() != src.size() || m_containers.size() != src.m_containers.size())
+					return GAIA::False;
+				for(GAIA::NUM x = 0; x < m_containers.size(); ++x)
+				{
+					if(!m_containers[x]->Equal(*src.m_containers[x]))
+						return GAIA::False;
+				}
+				return GAIA::True;
+			}
+			GINL GAIA::BL operator != (const __MyType& src) const{return !this->operator == (src);}
+		private:
+			GAIA_ENUM_BEGIN(OP)
+				OP_OR,
+				OP_AND,
+				OP_XOR,
+				OP_ANDNOT,
+			GAIA_ENUM_END(OP)
+		private:
+			GINL GAIA::GVOID init(){m_size = 0;}
+			GINL GAIA::NUM lower_bound(GAIA::U16 uKey) const
+			{
+				GAIA::NUM sBegin = 0;
+				GAIA::NUM sEnd = m_containers.size();
+				while(sBegin < sEnd)
+				{
+					GAIA::NUM sMid = sBegin + (sEnd - sBegin) / 2;
+					if(m_containers[sMid]->Key() < uKey)
+						sBegin = sMid + 1;
+					else
+						sEnd = sMid;
+				}
+				return sBegin;
+			}
+			GINL GAIA::NUM find(GAIA::U16 uKey) const
+			{
+				GAIA::NUM sIndex = this->lower_bound(uKey);
+				if(sIndex == m_containers.size() || m_containers[sIndex]->Key() != uKey)
+					return GINVALID;
+				return sIndex;
+			}
+			GINL __MyType& combine(const __MyType& src, OP op)
+			{
+				GAST(&src != this);
+				if(&src == this)
+				{
+					__MyType t = src;
+					return this->combine(t, op);
+				}
+				__ContainerList listNew;
+				listNew.reserve(m_containers.size() + src.m_containers.size());
+				GAIA::NUM x = 0;
+				GAIA::NUM y = 0;
+				while(x < m_containers.size() || y < src.m_containers.size())
+				{
+					Container* pContainer = GNIL;
+					if(y == src.m_containers.size() || (x < m_containers.size() && m_containers[x]->Key() < src.m_containers[y]->Key()))
+					{
+						// Only in this.
+						pContainer = m_containers[x++];
+						if(op == OP_AND)
+						{
+							gdel pContainer;
+							pContainer = GNIL;
+						}
+					}
+					else if(x == m_containers.size() || src.m_containers[y]->Key() < m_containers[x]->Key())
+					{
+						// Only in source.
+						if(op == OP_OR || op == OP_XOR)
+							pContainer = gnew Container(*src.m_containers[y]);
+						++y;
+					}
+					else
+					{
+						pContainer = m_containers[x++];
+						const Container& c = *src.m_containers[y++];
+						switch(op)
+						{
+						case OP_OR:
+							pContainer->Or(c);
+							break;
+						case OP_AND:
+							pContainer->And(c);
+							break;
+						case OP_XOR:
+							pContainer->Xor(c);
+							break;
+						case OP_ANDNOT:
+							pContainer->AndNot(c);
+							break;
+						default:
+							GAST(GAIA::False);
+							break;
+						}
+						if(pContainer->Size() == 0)
+						{
+							gdel pContainer;
+							pContainer = GNIL;
+						}
+					}
+					if(pContainer != GNIL)
+						listNew.push_back(pContainer);
+				}
+				m_containers = listNew;
+				m_size = 0;
+				for(GAIA::NUM x = 0; x < m_containers.size(); ++x)
+					m_size += m_containers[x]->Size();
+				return *this;
+			}
+		private:
+			__ContainerList m_containers;
+			_SizeType m_size;
+		};
+		class RoaringBitset : public BasicRoaringBitset<GAIA::N64>{public:};
+	}
+}
+
+#endif
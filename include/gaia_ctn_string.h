@@ -7,6 +7,7 @@
 #include "gaia_iterator.h"
 #include "gaia_algo_compare.h"
 #include "gaia_algo_extend.h"
+#include "gaia_algo_hash.h"
 #include "gaia_algo_string.h"
 #include "gaia_ctn.h"
 #include "gaia_ctn_chars.h"
@@ -242,6 +243,7 @@ namespace GAIA
 			GINL _SizeType capacity() const{if(m_capacity == 0) return 0; return m_capacity - 1;}
 			GINL _SizeType typesize() const{return sizeof(_DataType);}
 			GINL _SizeType datasize() const{return this->typesize() * this->size();}
+			GINL GAIA::U64 hash() const{return GAIA::ALGO::hash(this->fptr());}
 			GINL GAIA::GVOID resize(const _SizeType& size)
 			{
 				GAST(size >= 0);
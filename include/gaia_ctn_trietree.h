@@ -4,19 +4,365 @@
 #include "gaia_type.h"
 #include "gaia_assert.h"
 #include "gaia_algo_extend.h"
-#include "gaia_ctn_ref.h"
 #include "gaia_ctn_pool.h"
-#include "gaia_ctn_avltree.h"
+#include "gaia_ctn_vector.h"
+#include "gaia_ctn_bitset.h"
+
+#ifdef GAIA_SIMD_SSE2
+#	include <emmintrin.h>
+#endif
 
 namespace GAIA
 {
 	namespace CTN
 	{
+		/*!
+			@brief The key traits of the trie tree.
+
+			@remarks
+				SIMD_SIZE is the byte size of the key if the key is an integer which could be compared by SIMD, or it is 0.
+				DIRECT means the key is one byte, and Byte get the byte for indexing the children directly.
+		*/
+		template<typename _DataType> class TrieKey{public: static const GAIA::NUM SIMD_SIZE = 0; static const GAIA::BL DIRECT = GAIA::False; static GINL GAIA::U8 Byte(const _DataType& t){return 0;}};
+		template<> class TrieKey<GAIA::N8>{public: static const GAIA::NUM SIMD_SIZE = 1; static const GAIA::BL DIRECT = GAIA::True; static GINL GAIA::U8 Byte(const GAIA::N8& t){return GSCAST(GAIA::U8)(t);}};
+		template<> class TrieKey<GAIA::U8>{public: static const GAIA::NUM SIMD_SIZE = 1; static const GAIA::BL DIRECT = GAIA::True; static GINL GAIA::U8 Byte(const GAIA::U8& t){return t;}};
+		template<> class TrieKey<GAIA::N16>{public: static const GAIA::NUM SIMD_SIZE = 2; static const GAIA::BL DIRECT = GAIA::False; static GINL GAIA::U8 Byte(const GAIA::N16& t){return 0;}};
+		template<> class TrieKey<GAIA::U16>{public: static const GAIA::NUM SIMD_SIZE = 2; static const GAIA::BL DIRECT = GAIA::False; static GINL GAIA::U8 Byte(const GAIA::U16& t){return 0;}};
+		template<> class TrieKey<GAIA::N32>{public: static const GAIA::NUM SIMD_SIZE = 4; static const GAIA::BL DIRECT = GAIA::False; static GINL GAIA::U8 Byte(const GAIA::N32& t){return 0;}};
+		template<> class TrieKey<GAIA::U32>{public: static const GAIA::NUM SIMD_SIZE = 4; static const GAIA::BL DIRECT = GAIA::False; static GINL GAIA::U8 Byte(const GAIA::U32& t){return 0;}};
+		template<> class TrieKey<GAIA::WCH>{public: static const GAIA::NUM SIMD_SIZE = sizeof(GAIA::WCH); static const GAIA::BL DIRECT = GAIA::False; static GINL GAIA::U8 Byte(const GAIA::WCH& t){return 0;}};
+
+		/*!
+			@brief Find a key in a key list.
+
+			@remarks
+				The generic version compare the keys one by one. The SIMD version compare 16 bytes a time, the key list
+				must be readable to the 16 bytes boundary after the last key.
+		*/
+		template<GAIA::NUM _SimdSize> class TrieKeyScan
+		{
+		public:
+			template<typename _DataType, typename _SizeType> static GINL GAIA::NUM Scan(const _DataType* pKeys, const _SizeType& size, const _DataType& t)
+			{
+				for(_SizeType x = 0; x < size; ++x)
+				{
+					if(pKeys[x] == t)
+						return (GAIA::NUM)x;
+				}
+				return GINVALID;
+			}
+		};
+	#ifdef GAIA_SIMD_SSE2
+		class TrieKeyScanSimd
+		{
+		public:
+			template<GAIA::NUM _SimdSize, typename _DataType, typename _SizeType> static GINL GAIA::NUM Scan(const _DataType* pKeys, const _SizeType& size, const _DataType& t)
+			{
+				__m128i k;
+				if(_SimdSize == 1)
+					k = _mm_set1_epi8(*GRCAST(const GAIA::N8*)(&t));
+				else if(_SimdSize == 2)
+					k = _mm_set1_epi16(*GRCAST(const GAIA::N16*)(&t));
+				else
+					k = _mm_set1_epi32(*GRCAST(const GAIA::N32*)(&t));
+				const GAIA::U8* p = GRCAST(const GAIA::U8*)(pKeys);
+				GAIA::NUM sBytes = (GAIA::NUM)size * _SimdSize;
+				for(GAIA::NUM x = 0; x < sBytes; x += 16)
+				{
+					__m128i v = _mm_loadu_si128(GRCAST(const __m128i*)(p + x));
+					if(_SimdSize == 1)
+						v = _mm_cmpeq_epi8(v, k);
+					else if(_SimdSize == 2)
+						v = _mm_cmpeq_epi16(v, k);
+					else
+						v = _mm_cmpeq_epi32(v, k);
+					GAIA::U32 uMask = (GAIA::U32)_mm_movemask_epi8(v);
+					if(sBytes - x < 16)
+						uMask &= (1U << (sBytes - x)) - 1;
+					if(uMask != 0)
+						return (x + GAIA::ALGO::gctz(uMask)) / _SimdSize;
+				}
+				return GINVALID;
+			}
+		};
+		template<> class TrieKeyScan<1>{public: template<typename _DataType, typename _SizeType> static GINL GAIA::NUM Scan(const _DataType* pKeys, const _SizeType& size, const _DataType& t){return TrieKeyScanSimd::Scan<1>(pKeys, size, t);}};
+		template<> class TrieKeyScan<2>{public: template<typename _DataType, typename _SizeType> static GINL GAIA::NUM Scan(const _DataType* pKeys, const _SizeType& size, const _DataType& t){return TrieKeyScanSimd::Scan<2>(pKeys, size, t);}};
+		template<> class TrieKeyScan<4>{public: template<typename _DataType, typename _SizeType> static GINL GAIA::NUM Scan(const _DataType* pKeys, const _SizeType& size, const _DataType& t){return TrieKeyScanSimd::Scan<4>(pKeys, size, t);}};
+	#endif
+
 		template<typename _DataType, typename _SizeType, typename _ExtendType> class BasicTrieTree : public GAIA::Base
 		{
 		public:
 			class Node;
-			typedef BasicAVLTree<Ref<Node>, _SizeType, _SizeType, _ExtendType> __NodeTreeType;
+
+			/*!
+				@brief The children of a trie tree node, they are sorted by the key.
+
+				@remarks
+					It is the adaptive node of the adaptive radix tree, the capacity grows by 4, 16, 48, 256 and then doubles.
+					Not more than 16 children are found by SIMD scan if the key is a small integer. For one byte keys, 17 to 48
+					children are found by a 256 bytes index of the child slot, and more children are found by a 256 children
+					table directly. The others are found by binary search. The sorted keys and children are kept in all cases,
+					so the iteration is not changed by the layout.
+			*/
+			class NodeLinks : public GAIA::Base
+			{
+			public:
+				typedef _SizeType _sizetype;
+			public:
+				static const _SizeType SCAN_SIZE = 16;
+				static const _SizeType INDEX_SIZE = 48;
+			public:
+				class it : public GAIA::Base
+				{
+				private:
+					friend class NodeLinks;
+				public:
+					GINL it(){this->init();}
+					GINL GAIA::BL empty() const{return m_pLinks == GNIL;}
+					GINL GAIA::GVOID clear(){this->init();}
+					GINL Node* operator * () const{GAST(!!m_pLinks); return m_pLinks->m_pChilds[m_index];}
+					GINL it& operator ++ (){GAST(!!m_pLinks); ++m_index; if(m_index >= m_pLinks->size()) this->init(); return *this;}
+					GINL it& operator -- (){GAST(!!m_pLinks); if(m_index == 0) this->init(); else --m_index; return *this;}
+					GINL GAIA::BL operator == (const it& src) const{return m_pLinks == src.m_pLinks && m_index == src.m_index;}
+					GINL GAIA::BL operator != (const it& src) const{return !this->operator == (src);}
+				private:
+					GINL GAIA::GVOID init(){m_pLinks = GNIL; m_index = 0;}
+				private:
+					NodeLinks* m_pLinks;
+					_SizeType m_index;
+				};
+				class const_it : public GAIA::Base
+				{
+				private:
+					friend class NodeLinks;
+				public:
+					GINL const_it(){this->init();}
+					GINL GAIA::BL empty() const{return m_pLinks == GNIL;}
+					GINL GAIA::GVOID clear(){this->init();}
+					GINL const Node* operator * () const{GAST(!!m_pLinks); return m_pLinks->m_pChilds[m_index];}
+					GINL const_it& operator ++ (){GAST(!!m_pLinks); ++m_index; if(m_index >= m_pLinks->size()) this->init(); return *this;}
+					GINL const_it& operator -- (){GAST(!!m_pLinks); if(m_index == 0) this->init(); else --m_index; return *this;}
+					GINL GAIA::BL operator == (const const_it& src) const{return m_pLinks == src.m_pLinks && m_index == src.m_index;}
+					GINL GAIA::BL operator != (const const_it& src) const{return !this->operator == (src);}
+				private:
+					GINL GAIA::GVOID init(){m_pLinks = GNIL; m_index = 0;}
+				private:
+					const NodeLinks* m_pLinks;
+					_SizeType m_index;
+				};
+			public:
+				GINL NodeLinks(){this->init();}
+				GINL NodeLinks(const NodeLinks& src){this->init(); this->operator = (src);}
+				GINL ~NodeLinks(){this->destroy();}
+				GINL GAIA::BL empty() const{return m_size == 0;}
+				GINL const _SizeType& size() const{return m_size;}
+				GINL GAIA::GVOID clear(){m_size = 0; this->drop_table();}
+				GINL GAIA::GVOID destroy()
+				{
+					this->drop_table();
+					if(m_pKeys != GNIL)
+						gdel[] m_pKeys;
+					if(m_pChilds != GNIL)
+						gdel[] m_pChilds;
+					this->init();
+				}
+				GINL const _DataType& key(const _SizeType& index) const{GAST(index < m_size); return m_pKeys[index];}
+				GINL Node* child(const _SizeType& index) const{GAST(index < m_size); return m_pChilds[index];}
+				GINL Node* find(const _DataType& t) const
+				{
+					if(m_pDirect != GNIL)
+						return m_pDirect[GAIA::CTN::TrieKey<_DataType>::Byte(t)];
+					if(m_pIndex != GNIL)
+					{
+						GAIA::U8 uSlot = m_pIndex[GAIA::CTN::TrieKey<_DataType>::Byte(t)];
+						return uSlot == 0 ? GNIL : m_pChilds[uSlot - 1];
+					}
+					if(GAIA::CTN::TrieKey<_DataType>::SIMD_SIZE != 0 && m_size <= SCAN_SIZE)
+					{
+						GAIA::NUM sIndex = GAIA::CTN::TrieKeyScan<GAIA::CTN::TrieKey<_DataType>::SIMD_SIZE>::Scan(m_pKeys, m_size, t);
+						return sIndex < 0 ? GNIL : m_pChilds[sIndex];
+					}
+					_SizeType index = this->lower_bound(t);
+					if(index < m_size && m_pKeys[index] == t)
+						return m_pChilds[index];
+					return GNIL;
+				}
+				GINL GAIA::BL insert(const _DataType& t, Node* pNode)
+				{
+					GAST(!!pNode);
+					_SizeType index = this->lower_bound(t);
+					if(index < m_size && m_pKeys[index] == t)
+						return GAIA::False;
+					if(m_size == m_capacity)
+						this->exten();
+					for(_SizeType x = m_size; x > index; --x)
+					{
+						m_pKeys[x] = m_pKeys[x - 1];
+						m_pChilds[x] = m_pChilds[x - 1];
+					}
+					m_pKeys[index] = t;
+					m_pChilds[index] = pNode;
+					++m_size;
+					this->update_table();
+					return GAIA::True;
+				}
+				GINL GAIA::BL erase(const _DataType& t)
+				{
+					_SizeType index = this->lower_bound(t);
+					if(index >= m_size || !(m_pKeys[index] == t))
+						return GAIA::False;
+					for(_SizeType x = index + 1; x < m_size; ++x)
+					{
+						m_pKeys[x - 1] = m_pKeys[x];
+						m_pChilds[x - 1] = m_pChilds[x];
+					}
+					--m_size;
+					if(m_pDirect != GNIL)
+						m_pDirect[GAIA::CTN::TrieKey<_DataType>::Byte(t)] = GNIL;
+					this->update_table();
+					return GAIA::True;
+				}
+				GINL it upper_equal(const _DataType& t){return this->toit(this->lower_bound(t));}
+				GINL const_it upper_equal(const _DataType& t) const{return this->toit(this->lower_bound(t));}
+				GINL it frontit(){return this->toit(0);}
+				GINL it backit(){return m_size == 0 ? it() : this->toit(m_size - 1);}
+				GINL const_it const_frontit() const{return this->toit(0);}
+				GINL const_it const_backit() const{return m_size == 0 ? const_it() : this->toit(m_size - 1);}
+				GINL NodeLinks& operator = (const NodeLinks& src)
+				{
+					GAST(&src != this);
+					this->clear();
+					while(m_capacity < src.m_size)
+						this->exten();
+					for(_SizeType x = 0; x < src.m_size; ++x)
+					{
+						m_pKeys[x] = src.m_pKeys[x];
+						m_pChilds[x] = src.m_pChilds[x];
+					}
+					m_size = src.m_size;
+					this->update_table();
+					return *this;
+				}
+			private:
+				GINL GAIA::GVOID init()
+				{
+					m_pKeys = GNIL;
+					m_pChilds = GNIL;
+					m_pIndex = GNIL;
+					m_pDirect = GNIL;
+					m_size = m_capacity = 0;
+				}
+				GINL _SizeType lower_bound(const _DataType& t) const
+				{
+					_SizeType sBegin = 0;
+					_SizeType sEnd = m_size;
+					while(sBegin < sEnd)
+					{
+						_SizeType sMid = sBegin + (sEnd - sBegin) / 2;
+						if(m_pKeys[sMid] < t)
+							sBegin = sMid + 1;
+						else
+							sEnd = sMid;
+					}
+					return sBegin;
+				}
+				GINL it toit(const _SizeType& index){it ret; if(index < m_size){ret.m_pLinks = this; ret.m_index = index;} return ret;}
+				GINL const_it toit(const _SizeType& index) const{const_it ret; if(index < m_size){ret.m_pLinks = this; ret.m_index = index;} return ret;}
+				GINL GAIA::GVOID exten()
+				{
+					_SizeType newcapacity;
+					if(m_capacity < 4)
+						newcapacity = 4;
+					else if(m_capacity < SCAN_SIZE)
+						newcapacity = SCAN_SIZE;
+					else if(m_capacity < INDEX_SIZE)
+						newcapacity = INDEX_SIZE;
+					else if(m_capacity < 256)
+						newcapacity = 256;
+					else
+						newcapacity = m_capacity * 2;
+
+					// The SIMD scan reads the keys by 16 bytes.
+					_SizeType keycapacity = newcapacity;
+					if(GAIA::CTN::TrieKey<_DataType>::SIMD_SIZE != 0)
+					{
+						_SizeType block = 16 / GAIA::CTN::TrieKey<_DataType>::SIMD_SIZE;
+						keycapacity = (newcapacity + block - 1) / block * block;
+					}
+					_DataType* pNewKeys = gnew _DataType[keycapacity];
+					Node** pNewChilds = gnew Node*[newcapacity];
+					for(_SizeType x = 0; x < m_size; ++x)
+					{
+						pNewKeys[x] = m_pKeys[x];
+						pNewChilds[x] = m_pChilds[x];
+					}
+					if(m_pKeys != GNIL)
+						gdel[] m_pKeys;
+					if(m_pChilds != GNIL)
+						gdel[] m_pChilds;
+					m_pKeys = pNewKeys;
+					m_pChilds = pNewChilds;
+					m_capacity = newcapacity;
+				}
+				GINL GAIA::GVOID update_table()
+				{
+					if(!GAIA::CTN::TrieKey<_DataType>::DIRECT)
+						return;
+					if(m_size > INDEX_SIZE)
+					{
+						if(m_pIndex != GNIL)
+						{
+							gdel[] m_pIndex;
+							m_pIndex = GNIL;
+						}
+						if(m_pDirect == GNIL)
+						{
+							m_pDirect = gnew Node*[256];
+							for(GAIA::NUM x = 0; x < 256; ++x)
+								m_pDirect[x] = GNIL;
+						}
+						for(_SizeType x = 0; x < m_size; ++x)
+							m_pDirect[GAIA::CTN::TrieKey<_DataType>::Byte(m_pKeys[x])] = m_pChilds[x];
+					}
+					else if(m_size > SCAN_SIZE)
+					{
+						if(m_pDirect != GNIL)
+						{
+							gdel[] m_pDirect;
+							m_pDirect = GNIL;
+						}
+						if(m_pIndex == GNIL)
+							m_pIndex = gnew GAIA::U8[256];
+						GAIA::ALGO::gmemset(m_pIndex, 0, 256);
+						for(_SizeType x = 0; x < m_size; ++x)
+							m_pIndex[GAIA::CTN::TrieKey<_DataType>::Byte(m_pKeys[x])] = (GAIA::U8)(x + 1);
+					}
+					else
+						this->drop_table();
+				}
+				GINL GAIA::GVOID drop_table()
+				{
+					if(m_pIndex != GNIL)
+					{
+						gdel[] m_pIndex;
+						m_pIndex = GNIL;
+					}
+					if(m_pDirect != GNIL)
+					{
+						gdel[] m_pDirect;
+						m_pDirect = GNIL;
+					}
+				}
+			private:
+				_DataType* m_pKeys;
+				Node** m_pChilds;
+				GAIA::U8* m_pIndex;
+				Node** m_pDirect;
+				_SizeType m_size;
+				_SizeType m_capacity;
+			};
+			typedef NodeLinks __NodeTreeType;
 			typedef BasicVector<__NodeTreeType, _SizeType, _ExtendType> __PathListType;
 		public:
 			class Node : public GAIA::Base
@@ -41,16 +387,7 @@ namespace GAIA
 				}
 				GCLASS_COMPARE(m_t, Node)
 			private:
-				GINL Node* find_child_node(const _DataType& t) const
-				{
-					Node n;
-					n.m_t = t;
-					Ref<Node> rn = &n;
-					Ref<Node>* pResult = const_cast<Ref<Node>*>(m_links.find(rn));
-					if(pResult == GNIL)
-						return GNIL;
-					return *pResult;
-				}
+				GINL Node* find_child_node(const _DataType& t) const{return m_links.find(t);}
 			private:
 				Node* m_pParent;
 				__NodeTreeType m_links;
@@ -89,7 +426,7 @@ namespace GAIA
 							m_pNode = GNIL;
 							return *this;
 						}
-						typename __NodeTreeType::it it = m_pNode->m_pParent->m_links.upper_equal(Ref<Node>(m_pNode));
+						typename __NodeTreeType::it it = m_pNode->m_pParent->m_links.upper_equal(m_pNode->m_t);
 						GAST(!it.empty());
 						++it;
 						if(!it.empty())
@@ -112,7 +449,7 @@ namespace GAIA
 						return *this;
 					if(m_pNode->m_pParent != GNIL)
 					{
-						typename __NodeTreeType::it it = m_pNode->m_pParent->m_links.upper_equal(Ref<Node>(m_pNode));
+						typename __NodeTreeType::it it = m_pNode->m_pParent->m_links.upper_equal(m_pNode->m_t);
 						GAST(!it.empty());
 						--it;
 						if(!it.empty())
@@ -247,8 +584,7 @@ namespace GAIA
 							return *this;
 						}
 						typename __NodeTreeType::const_it it =
-							(const_cast<const Node*>(m_pNode->m_pParent))->m_links.upper_equal(
-								Ref<Node>(const_cast<Node*>(m_pNode)));
+							(const_cast<const Node*>(m_pNode->m_pParent))->m_links.upper_equal(m_pNode->m_t);
 						GAST(!it.empty());
 						++it;
 						if(!it.empty())
@@ -272,8 +608,7 @@ namespace GAIA
 					if(m_pNode->m_pParent != GNIL)
 					{
 						typename __NodeTreeType::const_it it =
-							(const_cast<const Node*>(m_pNode->m_pParent))->m_links.upper_equal(
-								Ref<Node>(const_cast<Node*>(m_pNode)));
+							(const_cast<const Node*>(m_pNode->m_pParent))->m_links.upper_equal(m_pNode->m_t);
 						GAST(!it.empty());
 						--it;
 						if(!it.empty())
@@ -422,7 +757,7 @@ namespace GAIA
 							pNode->m_category_count == 0 &&
 							pNode->m_full_count == 0)
 						{
-							pNode->m_pParent->m_links.erase(pNode);
+							pNode->m_pParent->m_links.erase(pNode->m_t);
 							m_pool.release(pNode);
 						}
 						pNode = pNode->m_pParent;
@@ -489,10 +824,7 @@ namespace GAIA
 				Node* pNode = &m_root;
 				for(_SizeType x = 0; x < size; ++x)
 				{
-					Node n;
-					n.m_t = p[x];
-					Ref<Node> rn = &n;
-					typename __NodeTreeType::it itsub = pNode->m_links.upper_equal(rn);
+					typename __NodeTreeType::it itsub = pNode->m_links.upper_equal(p[x]);
 					if(itsub.empty())
 					{
 						if(pNode->m_pParent == GNIL)
@@ -557,10 +889,7 @@ namespace GAIA
 				const Node* pNode = &m_root;
 				for(_SizeType x = 0; x < size; ++x)
 				{
-					Node n;
-					n.m_t = p[x];
-					Ref<Node> rn = &n;
-					typename __NodeTreeType::const_it itsub = pNode->m_links.upper_equal(rn);
+					typename __NodeTreeType::const_it itsub = pNode->m_links.upper_equal(p[x]);
 					if(itsub.empty())
 					{
 						if(pNode->m_pParent == GNIL)
@@ -799,7 +1128,7 @@ namespace GAIA
 					pNew->m_t = *p;
 					pNew->m_count = 0;
 					pNew->m_category_count = 1;
-					n.m_links.insert(pNew);
+					n.m_links.insert(pNew->m_t, pNew);
 					ret = GAIA::True;
 					this->insert_node(*pNew, p + 1, size - 1);
 					pNew->m_full_count = 1;
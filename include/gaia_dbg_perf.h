@@ -3,10 +3,13 @@
 
 #include "gaia_type.h"
 #include "gaia_assert.h"
+#include "gaia_algo_base.h"
 #include "gaia_stream_stdstream.h"
 #include "gaia_thread_base.h"
+#include "gaia_sync_base.h"
 #include "gaia_sync_lock.h"
 #include "gaia_sync_autolock.h"
+#include "gaia_sync_tls.h"
 #include "gaia_algo_compare.h"
 #include "gaia_algo_string.h"
 #include "gaia_ctn_ref.h"
@@ -16,13 +19,123 @@
 #include "gaia_ctn_staticstringptrpool.h"
 #include "gaia_time.h"
 
+#if GAIA_OS == GAIA_OS_WINDOWS
+#	include <windows.h>
+#elif GAIA_OS == GAIA_OS_OSX || GAIA_OS == GAIA_OS_IOS
+#	include <mach/mach_time.h>
+#else
+#	include <time.h>
+#endif
+
 namespace GAIA
 {
 	namespace DBG
 	{
+		/*!
+			@brief Performance collector.
+
+			@remarks
+				There are two ways to collect.
+
+				The items named by string, which are accessed by Begin, End and IsBegin,
+				are looked up in one global lock per call. They support the instance id.
+
+				The items registered by RegisterItem, which are accessed by BeginItem, EndItem and Record,
+				are written to the shard of current thread without any lock and any name lookup.
+				Each of them keep a log-linear latency histogram for the percentile, the shards are merged only when Get or Collect is called.
+				Statistics of a shard are written by its thread only, so Get or Collect may see a little old value while the items are being written.
+
+				Time unit is nano second, see tick.
+		*/
 		class PerfCollector : public GAIA::Base
 		{
 		public:
+			static const GAIA::NUM MAX_ITEM_COUNT = 256;
+			static const GAIA::NUM HISTOGRAM_SUB_BITS = 4;
+			static const GAIA::NUM HISTOGRAM_SUB_COUNT = 1 << HISTOGRAM_SUB_BITS;
+			static const GAIA::NUM HISTOGRAM_MAX_BITS = 40; // The time larger than 2^40 nano seconds(about 18 minutes) are counted into the last bucket.
+			static const GAIA::NUM HISTOGRAM_SIZE = (HISTOGRAM_MAX_BITS - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_COUNT;
+
+		public:
+			/*!
+				@brief Log-linear histogram.
+
+				@remarks
+					The values less than HISTOGRAM_SUB_COUNT have a bucket for each,
+					every power of 2 above is split into HISTOGRAM_SUB_COUNT buckets,
+					so the relative error of the percentile is less than 1 / HISTOGRAM_SUB_COUNT.
+			*/
+			class Histogram : public GAIA::Base
+			{
+			public:
+				GINL Histogram(){this->reset();}
+				GINL GAIA::GVOID reset()
+				{
+					for(GAIA::NUM x = 0; x < HISTOGRAM_SIZE; ++x)
+						m_buckets[x] = 0;
+					m_uCount = 0;
+				}
+				GINL GAIA::GVOID add(const GAIA::U64& uValue)
+				{
+					++m_buckets[index(uValue)];
+					++m_uCount;
+				}
+				GINL GAIA::GVOID merge(const Histogram& src)
+				{
+					for(GAIA::NUM x = 0; x < HISTOGRAM_SIZE; ++x)
+						m_buckets[x] += src.m_buckets[x];
+					m_uCount += src.m_uCount;
+				}
+				GINL const GAIA::U64& count() const{return m_uCount;}
+
+				/*!
+					@brief Get the value at specified ratio.
+
+					@param fRatio [in] Specify the ratio, 0.5 means p50, 0.999 means p999.
+
+					@return Return the upper bound of the bucket which the value is in, return 0 if the histogram is empty.
+				*/
+				GINL GAIA::U64 percentile(const GAIA::F64& fRatio) const
+				{
+					if(m_uCount == 0)
+						return 0;
+					GAIA::U64 uRank = (GAIA::U64)(fRatio * (GAIA::F64)m_uCount + 0.5);
+					if(uRank == 0)
+						uRank = 1;
+					else if(uRank > m_uCount)
+						uRank = m_uCount;
+					GAIA::U64 uSum = 0;
+					for(GAIA::NUM x = 0; x < HISTOGRAM_SIZE; ++x)
+					{
+						uSum += m_buckets[x];
+						if(uSum >= uRank)
+							return upper(x);
+					}
+					return upper(HISTOGRAM_SIZE - 1);
+				}
+				static GINL GAIA::NUM index(const GAIA::U64& uValue)
+				{
+					if(uValue < HISTOGRAM_SUB_COUNT)
+						return (GAIA::NUM)uValue;
+					GAIA::NUM sBits = 63 - GAIA::ALGO::gclz(uValue);
+					if(sBits >= HISTOGRAM_MAX_BITS)
+						return HISTOGRAM_SIZE - 1;
+					return (sBits - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_COUNT + (GAIA::NUM)((uValue >> (sBits - HISTOGRAM_SUB_BITS)) & (HISTOGRAM_SUB_COUNT - 1));
+				}
+				static GINL GAIA::U64 upper(GAIA::NUM sIndex)
+				{
+					if(sIndex < HISTOGRAM_SUB_COUNT)
+						return (GAIA::U64)sIndex;
+					GAIA::NUM sShift = sIndex / HISTOGRAM_SUB_COUNT - 1;
+					GAIA::U64 uLower = (GAIA::U64)(HISTOGRAM_SUB_COUNT + sIndex % HISTOGRAM_SUB_COUNT) << sShift;
+					return uLower + ((GAIA::U64)1 << sShift) - 1;
+				}
+			private:
+			private:
+				GAIA::U64 m_buckets[HISTOGRAM_SIZE];
+				GAIA::U64 m_uCount;
+			};
+
 			class CallBack : public GAIA::Base
 			{
 			public:
@@ -45,23 +158,181 @@ namespace GAIA
 					@return If the moduler user return GAIA::True, the collect procedule will continued, return GAIA::False, the collect procedule will breaked.
 				*/
 				virtual GAIA::BL OnCollect(const GAIA::CH* pszItemName, GAIA::UM uThreadID, const GAIA::U64& uTotalTime, const GAIA::U64& uMinTime, const GAIA::U64& uMaxTime, const GAIA::U64& uTotalCount) = 0;
+
+				/*!
+					@brief Callback per collected registered item, after OnCollect of the same item and thread.
+
+					@param pszItemName [in] Specify the item name.
+
+					@param uThreadID [in] Specify the threadid, GINVALID means the combination of all threads.
+
+					@param histogram [in] Specify the latency histogram of current performance item.
+
+					@return If the moduler user return GAIA::True, the collect procedule will continued, return GAIA::False, the collect procedule will breaked.
+				*/
+				virtual GAIA::BL OnCollectHistogram(const GAIA::CH* pszItemName, GAIA::UM uThreadID, const Histogram& histogram){return GAIA::True;}
 			};
 
 		public:
-			GINL PerfCollector()
-			{
-			}
+			GINL PerfCollector(){this->init();}
 
 			GINL ~PerfCollector()
 			{
+				while(m_pShardList != GNIL)
+				{
+					Shard* pShard = m_pShardList;
+					m_pShardList = pShard->pNext;
+					for(GAIA::NUM x = 0; x < MAX_ITEM_COUNT; ++x)
+					{
+						if(pShard->slots[x] != GNIL)
+							gdel pShard->slots[x];
+					}
+					gdel pShard;
+				}
+				m_shardslot.Destroy();
 			}
 
+			/*!
+				@brief Reset all the statistics.
+
+				@remarks
+					The registered items are keeped, so the item handles are still valid.
+					It should not be called when the registered items are being written by the other threads.
+			*/
 			GINL GAIA::GVOID Reset()
 			{
 				GAIA::SYNC::Autolock al(m_lr);
 				m_nodes.destroy();
 				m_nodepool.destroy();
 				m_strpool.destroy();
+				for(Shard* pShard = m_pShardList; pShard != GNIL; pShard = pShard->pNext)
+				{
+					for(GAIA::NUM x = 0; x < MAX_ITEM_COUNT; ++x)
+					{
+						if(pShard->slots[x] != GNIL)
+							pShard->slots[x]->reset();
+					}
+				}
+			}
+
+			/*!
+				@brief Get current time for performance.
+
+				@return Return the nano second from an unspecified start point, it is monotonic.
+			*/
+			static GINL GAIA::U64 tick()
+			{
+			#if GAIA_OS == GAIA_OS_WINDOWS
+				static GAIA::N64 nFreq = 0;
+				if(nFreq == 0)
+				{
+					::QueryPerformanceFrequency((LARGE_INTEGER*)&nFreq);
+					if(nFreq == 0)
+						nFreq = 1;
+				}
+				GAIA::N64 nCounter;
+				::QueryPerformanceCounter((LARGE_INTEGER*)&nCounter);
+				return (GAIA::U64)(nCounter / nFreq * 1000000000 + nCounter % nFreq * 1000000000 / nFreq);
+			#elif GAIA_OS == GAIA_OS_OSX || GAIA_OS == GAIA_OS_IOS
+				static mach_timebase_info_data_t tb = {0, 0};
+				if(tb.denom == 0)
+					mach_timebase_info(&tb);
+				return mach_absolute_time() * tb.numer / tb.denom;
+			#else
+				timespec ts;
+				::clock_gettime(CLOCK_MONOTONIC, &ts);
+				return (GAIA::U64)ts.tv_sec * 1000000000 + (GAIA::U64)ts.tv_nsec;
+			#endif
+			}
+
+			/*!
+				@brief Register a item for BeginItem, EndItem and Record.
+
+				@param pszItemName [in] Specify the item name.
+
+				@return Return the item handle, the same name always return the same handle.
+					If there are already MAX_ITEM_COUNT items, return GINVALID.
+
+				@remarks
+					The name is looked up in lock, so call it once and keep the handle.
+			*/
+			GINL GAIA::NUM RegisterItem(const GAIA::CH* pszItemName)
+			{
+				GAST(!GAIA::ALGO::gstremp(pszItemName));
+				GAIA::SYNC::Autolock al(m_lr);
+				GAIA::NUM sItem = this->FindItem(pszItemName);
+				if(sItem != GINVALID)
+					return sItem;
+				if(m_sItemCount == MAX_ITEM_COUNT)
+					return GINVALID;
+				m_items[m_sItemCount] = m_itemstrpool.alloc(pszItemName);
+				return m_sItemCount++;
+			}
+
+			GINL GAIA::NUM FindItem(const GAIA::CH* pszItemName) const
+			{
+				GAST(!GAIA::ALGO::gstremp(pszItemName));
+				GAIA::SYNC::Autolock al(GCCAST(PerfCollector*)(this)->m_lr);
+				for(GAIA::NUM x = 0; x < m_sItemCount; ++x)
+				{
+					if(GAIA::ALGO::gstrequal(m_items[x], pszItemName))
+						return x;
+				}
+				return GINVALID;
+			}
+
+			GINL const GAIA::CH* GetItemName(GAIA::NUM sItem) const
+			{
+				GAST(sItem >= 0 && sItem < m_sItemCount);
+				return m_items[sItem];
+			}
+
+			GINL GAIA::GVOID BeginItem(GAIA::NUM sItem)
+			{
+				this->GetSlot(sItem)->uLastStartTime = tick();
+			}
+
+			GINL GAIA::BL EndItem(GAIA::NUM sItem)
+			{
+				GAIA::U64 uEndTime = tick();
+				Slot* pSlot = this->GetSlot(sItem);
+				if(pSlot->uLastStartTime == GINVALID)
+					return GAIA::False;
+				pSlot->add(uEndTime - pSlot->uLastStartTime);
+				pSlot->uLastStartTime = GINVALID;
+				return GAIA::True;
+			}
+
+			GINL GAIA::BL IsBeginItem(GAIA::NUM sItem)
+			{
+				return this->GetSlot(sItem)->uLastStartTime != GINVALID;
+			}
+
+			/*!
+				@brief Record a time which is measured by the caller, such as the difference of two tick.
+			*/
+			GINL GAIA::GVOID Record(GAIA::NUM sItem, const GAIA::U64& uTime)
+			{
+				this->GetSlot(sItem)->add(uTime);
+			}
+
+			/*!
+				@brief Get the latency histogram of a registered item.
+
+				@param sItem [in] Specify the item handle.
+
+				@param histogram [out] Used for saving the merged histogram.
+
+				@param uThreadID [in] Specify the thread, GINVALID means all threads.
+			*/
+			GINL GAIA::GVOID GetHistogram(GAIA::NUM sItem, Histogram& histogram, GAIA::UM uThreadID = GINVALID) const
+			{
+				GAIA::SYNC::Autolock al(GCCAST(PerfCollector*)(this)->m_lr);
+				GAST(sItem >= 0 && sItem < m_sItemCount);
+				Slot* pMerged = gnew Slot;
+				this->MergeItem(sItem, uThreadID, *pMerged);
+				histogram = pMerged->histogram;
+				gdel pMerged;
 			}
 
 			GINL GAIA::GVOID Begin(const GAIA::CH* pszItemName, const GAIA::N64& nInstanceID = GINVALID)
@@ -145,8 +416,7 @@ namespace GAIA
 				finder.uThreadID = 0;
 				finder.nInstanceID = 0;
 				__NodeSetType::it itfront = GCCAST(PerfCollector*)(this)->m_nodes.upper_equal(GAIA::CTN::Ref<Node>(&finder));
-				if(itfront.empty())
-					return GAIA::False;
+				GAIA::BL bFinded = GAIA::False;
 				Node finded;
 				finded.reset();
 				while(!itfront.empty())
@@ -155,6 +425,7 @@ namespace GAIA
 					GAST(pNode != GNIL);
 					if(!GAIA::ALGO::gstrequal(pNode->pszItemName, pszItemName))
 						break;
+					bFinded = GAIA::True;
 					finded.pszItemName = pNode->pszItemName;
 					finded.uThreadID = pNode->uThreadID;
 					finded.uTotalTime += pNode->uTotalTime;
@@ -163,6 +434,14 @@ namespace GAIA
 					finded.uTotalCount += pNode->uTotalCount;
 					++itfront;
 				}
+				GAIA::NUM sItem = this->FindItem(pszItemName);
+				if(sItem != GINVALID)
+				{
+					bFinded = GAIA::True;
+					this->MergeItem(sItem, GINVALID, finded);
+				}
+				if(!bFinded)
+					return GAIA::False;
 				if(pTotalTime != GNIL)
 					*pTotalTime = finded.uTotalTime;
 				if(pMinTime != GNIL)
@@ -180,17 +459,29 @@ namespace GAIA
 				if(uThreadID == GINVALID)
 					uThreadID = GAIA::THREAD::threadid();
 				GAIA::SYNC::Autolock al(GCCAST(PerfCollector*)(this)->m_lr);
+				Node finded;
+				finded.reset();
 				Node* pNode = GCCAST(PerfCollector*)(this)->GetNode(pszItemName, uThreadID, GAIA::False);
-				if(pNode == GNIL)
+				if(pNode != GNIL)
+				{
+					finded.uTotalTime = pNode->uTotalTime;
+					finded.uMinTime = pNode->uMinTime;
+					finded.uMaxTime = pNode->uMaxTime;
+					finded.uTotalCount = pNode->uTotalCount;
+				}
+				GAIA::NUM sItem = this->FindItem(pszItemName);
+				if(sItem != GINVALID)
+					this->MergeItem(sItem, uThreadID, finded);
+				else if(pNode == GNIL)
 					return GAIA::False;
 				if(pTotalTime != GNIL)
-					*pTotalTime = pNode->uTotalTime;
+					*pTotalTime = finded.uTotalTime;
 				if(pMinTime != GNIL)
-					*pMinTime = pNode->uMinTime;
+					*pMinTime = finded.uMinTime;
 				if(pMaxTime != GNIL)
-					*pMaxTime = pNode->uMaxTime;
+					*pMaxTime = finded.uMaxTime;
 				if(pTotalCount != GNIL)
-					*pTotalCount = pNode->uTotalCount;
+					*pTotalCount = finded.uTotalCount;
 				return GAIA::True;
 			}
 
@@ -203,6 +494,21 @@ namespace GAIA
 					GAST(pNode != GNIL);
 					listResult.push_back(pNode->pszItemName);
 				}
+				for(GAIA::NUM x = 0; x < m_sItemCount; ++x)
+				{
+					Node finder;
+					finder.pszItemName = m_items[x];
+					finder.uThreadID = 0;
+					finder.nInstanceID = 0;
+					__NodeSetType::it it = GCCAST(PerfCollector*)(this)->m_nodes.upper_equal(GAIA::CTN::Ref<Node>(&finder));
+					if(!it.empty())
+					{
+						const Node* pNode = *it;
+						if(GAIA::ALGO::gstrequal(pNode->pszItemName, m_items[x]))
+							continue;
+					}
+					listResult.push_back(m_items[x]);
+				}
 			}
 
 			GINL GAIA::BL Collect(GAIA::DBG::PerfCollector::CallBack& cb) const
@@ -250,7 +556,35 @@ namespace GAIA
 					if(!cb.OnCollect(pszLastItemName, GINVALID, uTotalTime, uMinTime, uMaxTime, uTotalCount))
 						return GAIA::False;
 				}
-				return GAIA::True;
+
+				// Registered items, merge the shards.
+				GAIA::BL bRet = GAIA::True;
+				Slot* pMerged = gnew Slot;
+				for(GAIA::NUM x = 0; x < m_sItemCount && bRet; ++x)
+				{
+					pMerged->reset();
+					for(Shard* pShard = m_pShardList; pShard != GNIL; pShard = pShard->pNext)
+					{
+						const Slot* pSlot = pShard->slots[x];
+						if(pSlot == GNIL)
+							continue;
+						GAIA::SYNC::gmembarrier();
+						if(!cb.OnCollect(m_items[x], pShard->uThreadID, pSlot->uTotalTime, pSlot->uMinTime, pSlot->uMaxTime, pSlot->histogram.count()) ||
+							!cb.OnCollectHistogram(m_items[x], pShard->uThreadID, pSlot->histogram))
+						{
+							bRet = GAIA::False;
+							break;
+						}
+						pMerged->merge(*pSlot);
+					}
+					if(!bRet)
+						break;
+					if(!cb.OnCollect(m_items[x], GINVALID, pMerged->uTotalTime, pMerged->uMinTime, pMerged->uMaxTime, pMerged->histogram.count()) ||
+						!cb.OnCollectHistogram(m_items[x], GINVALID, pMerged->histogram))
+						bRet = GAIA::False;
+				}
+				gdel pMerged;
+				return bRet;
 			}
 
 		private:
@@ -306,10 +640,115 @@ namespace GAIA
 				GAIA::U64 uLastStartTime; // GINVALID means not startupped.
 			};
 
+			/*
+			*	Statistics of a registered item on a thread.
+			*/
+			class Slot : public GAIA::Base
+			{
+			public:
+				GINL GAIA::GVOID reset()
+				{
+					uLastStartTime = GINVALID;
+					uTotalTime = 0;
+					uMinTime = GAIA::U64MAX;
+					uMaxTime = 0;
+					histogram.reset();
+				}
+				GINL GAIA::GVOID add(const GAIA::U64& uTime)
+				{
+					uTotalTime += uTime;
+					if(uTime < uMinTime)
+						uMinTime = uTime;
+					if(uTime > uMaxTime)
+						uMaxTime = uTime;
+					histogram.add(uTime);
+				}
+				GINL GAIA::GVOID merge(const Slot& src)
+				{
+					uTotalTime += src.uTotalTime;
+					uMinTime = GAIA::ALGO::gmin(uMinTime, src.uMinTime);
+					uMaxTime = GAIA::ALGO::gmax(uMaxTime, src.uMaxTime);
+					histogram.merge(src.histogram);
+				}
+			public:
+				GAIA::U64 uLastStartTime; // GINVALID means not startupped.
+				GAIA::U64 uTotalTime;
+				GAIA::U64 uMinTime;
+				GAIA::U64 uMaxTime;
+				Histogram histogram;
+			};
+
+			/*
+			*	All the registered items of a thread, it is only written by its thread, and keeped after the thread exit.
+			*/
+			class Shard : public GAIA::Base
+			{
+			public:
+				Shard* pNext;
+				GAIA::UM uThreadID;
+				Slot* volatile slots[MAX_ITEM_COUNT];
+			};
+
 		private:
 			typedef GAIA::CTN::Set<GAIA::CTN::Ref<Node> > __NodeSetType;
 
 		private:
+			GINL GAIA::GVOID init()
+			{
+				m_sItemCount = 0;
+				m_pShardList = GNIL;
+				m_shardslot.Create();
+			}
+			GINL Slot* GetSlot(GAIA::NUM sItem)
+			{
+				GAST(sItem >= 0 && sItem < MAX_ITEM_COUNT);
+				Shard* pShard = GSCAST(Shard*)(m_shardslot.Get());
+				if(pShard == GNIL)
+					pShard = this->NewShard();
+				Slot* pSlot = pShard->slots[sItem];
+				if(pSlot != GNIL)
+					return pSlot;
+				pSlot = gnew Slot;
+				pSlot->reset();
+				GAIA::SYNC::gmembarrier();
+				pShard->slots[sItem] = pSlot;
+				return pSlot;
+			}
+			GINL Shard* NewShard()
+			{
+				Shard* pShard = gnew Shard;
+				pShard->uThreadID = GAIA::THREAD::threadid();
+				for(GAIA::NUM x = 0; x < MAX_ITEM_COUNT; ++x)
+					pShard->slots[x] = GNIL;
+				{
+					GAIA::SYNC::Autolock al(m_lr);
+					pShard->pNext = m_pShardList;
+					m_pShardList = pShard;
+				}
+				m_shardslot.Set(pShard);
+				return pShard;
+			}
+			template<typename _DataType> GINL GAIA::GVOID MergeItem(GAIA::NUM sItem, GAIA::UM uThreadID, _DataType& result) const
+			{
+				for(Shard* pShard = m_pShardList; pShard != GNIL; pShard = pShard->pNext)
+				{
+					if(uThreadID != GINVALID && pShard->uThreadID != uThreadID)
+						continue;
+					const Slot* pSlot = pShard->slots[sItem];
+					if(pSlot == GNIL)
+						continue;
+					GAIA::SYNC::gmembarrier();
+					this->MergeSlot(*pSlot, result);
+				}
+			}
+			static GINL GAIA::GVOID MergeSlot(const Slot& src, Slot& result){result.merge(src);}
+			static GINL GAIA::GVOID MergeSlot(const Slot& src, Node& result)
+			{
+				result.uTotalTime += src.uTotalTime;
+				result.uMinTime = GAIA::ALGO::gmin(result.uMinTime, src.uMinTime);
+				result.uMaxTime = GAIA::ALGO::gmax(result.uMaxTime, src.uMaxTime);
+				result.uTotalCount += src.histogram.count();
+			}
 			GINL Node* GetNode(const GAIA::CH* pszItemName, GAIA::UM uThreadID, GAIA::BL bNotExistCreate, const GAIA::N64& nInstanceID = GINVALID)
 			{
 				Node finder;
@@ -340,6 +779,11 @@ namespace GAIA
 			__NodeSetType m_nodes;
 			GAIA::CTN::Pool<Node> m_nodepool;
 			GAIA::CTN::StaticStringPtrPool<GAIA::CH> m_strpool;
+			const GAIA::CH* m_items[MAX_ITEM_COUNT];
+			GAIA::NUM m_sItemCount;
+			GAIA::CTN::StaticStringPtrPool<GAIA::CH> m_itemstrpool;
+			Shard* m_pShardList;
+			GAIA::SYNC::TlsSlot m_shardslot;
 		};
 	}
 }
@@ -161,10 +161,12 @@ namespace GAIA
 							return GAIA::False;
 					#elif GAIA_OS == GAIA_OS_OSX
 						if(ftruncate(fileno((FILE*)m_pFile), size) != 0)
+							return GAIA::False;
 					#else
 						if(ftruncate64(fileno((FILE*)m_pFile), size) != 0)
 							return GAIA::False;
 					#endif
+						m_size = size;
 						return GAIA::True;
 					}
 					else
@@ -285,6 +287,7 @@ namespace GAIA
 					return GAIA::True;
 				return GAIA::False;
 			}
+			GINL virtual GAIA::GVOID* GetHandle() const{return m_pFile;}
 		private:
 			GAIA::CTN::TCharsString m_strFileKey;
 			GAIA::UM m_fileopentype;
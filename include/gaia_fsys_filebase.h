@@ -135,6 +135,14 @@ namespace GAIA
 			*/
 			virtual GAIA::BL Flush() = 0;
 
+			/*!
+				@brief Get the native handle of the file.
+
+				@return GAIA::FSYS::File return the FILE* of the C runtime.
+					If the file is not based on a native file, return GNIL.
+			*/
+			virtual GAIA::GVOID* GetHandle() const{return GNIL;}
+
 			/*!
 				@brief
 			*/
@@ -27,6 +27,7 @@
 #include "gaia_fsys_file.h"
 #include "gaia_html_htmlbase.h"
 #include "gaia_html_htmlnode.h"
+#include "gaia_html_htmlreader.h"
 
 namespace GAIA
 {
@@ -39,9 +40,26 @@ namespace GAIA
 			{
 				friend class HTML;
 			public:
-				GINL Cursor(){pCurrentNode = GNIL;}
+				GINL Cursor(){pCurrentNode = GNIL; pReader = GNIL; sReadDepth = 0; ntRead = ntLeaf = GAIA::HTML::HTML_NODE_INVALID; bReadPeeked = bLeafReaded = GAIA::False;}
+
+				/*!
+					@brief Bind a reader to the cursor, the BeginReadNode, EndReadNode and ReadNode will pull the nodes from it.
+				*/
+				GINL GAIA::GVOID BindReader(GAIA::HTML::HTMLReader* pReader){this->pReader = pReader; sReadDepth = 0; ntRead = ntLeaf = GAIA::HTML::HTML_NODE_INVALID; bReadPeeked = bLeafReaded = GAIA::False;}
+
+				/*!
+					@brief Get the node type of the last node readed by BeginReadNode or ReadNode.
+				*/
+				GINL GAIA::HTML::HTML_NODE GetReadType() const{return ntRead;}
 			private:
 				HTMLNode* pCurrentNode;
+				GAIA::HTML::HTMLReader* pReader;
+				GAIA::NUM sReadDepth;
+				GAIA::HTML::HTML_NODE ntRead;
+				GAIA::HTML::HTML_NODE ntLeaf;
+				GAIA::BL bReadPeeked;
+				GAIA::BL bLeafReaded;
+				GAIA::CTN::WString strRead;
 			};
 		public:
 			GINL HTML();
@@ -73,12 +91,7 @@ namespace GAIA
 			GINL GAIA::GVOID save_node(GAIA::HTML::HTMLNode& n, GAIA::HTML::HTML_SAVE st, GAIA::FSYS::FileBase& f);
 			GINL GAIA::GVOID save_child_node(GAIA::HTML::HTMLNode& n, GAIA::HTML::HTML_SAVE st, GAIA::FSYS::FileBase& f);
 			GINL GAIA::GVOID save_child_node_value(GAIA::HTML::HTMLNode& n, GAIA::HTML::HTML_SAVE st, GAIA::FSYS::FileBase& f);
-			GINL GAIA::NUM load_node(GAIA::U8* pBuf, GAIA::NUM sSize, GAIA::HTML::HTML_NODE& nt, GAIA::U8*& pBegin, GAIA::U8*& pEnd, GAIA::BL& bBegin) const;
-			GINL GAIA::NUM load_head(GAIA::U8* pBuf, GAIA::NUM sSize, GAIA::NUM sOffset, GAIA::NUM& sNext) const;
-			GINL GAIA::NUM load_comment(GAIA::U8* pBuf, GAIA::NUM sSize, GAIA::NUM sOffset, GAIA::NUM& sNext) const;
-			GINL GAIA::NUM load_node_name(GAIA::U8* pBuf, GAIA::NUM sSize, GAIA::NUM sOffset, GAIA::NUM& sNext) const;
-			GINL GAIA::NUM load_name(GAIA::U8* pBuf, GAIA::NUM sSize, GAIA::NUM sOffset, GAIA::NUM& sNext) const;
-			GINL GAIA::NUM load_value(GAIA::U8* pBuf, GAIA::NUM sSize, GAIA::NUM sOffset, GAIA::NUM& sNext) const;
+			GINL GAIA::BL load(GAIA::HTML::HTMLReader& reader);
 			GINL GAIA::GVOID read_string(const GAIA::U8* pBegin, const GAIA::U8* pEnd, GAIA::CTN::WString& strResult) const;
 
 		private:
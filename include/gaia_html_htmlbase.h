@@ -22,6 +22,17 @@ namespace GAIA
 			HTML_SAVE_BESTREAD,
 		GAIA_ENUM_END(HTML_SAVE)
 
+		GAIA_ENUM_BEGIN(HTML_EVENT)
+			HTML_EVENT_HEAD,			// Like <!DOCTYPE html>
+			HTML_EVENT_STARTELEMENT,	// Like <NODE1> or <NODE1/> 's begin
+			HTML_EVENT_ATTRIBUTE,		// Like a="abc"
+			HTML_EVENT_TEXT,			// Like abcdef in <NODE3>abcdef</NODE3>
+			HTML_EVENT_ENDELEMENT,		// Like </NODE1> or <NODE1/> 's end
+			HTML_EVENT_COMMENT,			// Like <!--comment content-->
+			HTML_EVENT_END,				// The source is end
+			HTML_EVENT_ERROR,			// The source is invalid
+		GAIA_ENUM_END(HTML_EVENT)
+
 		static const GAIA::TCH HTML_DEFAULT_ROOT_NODE_NAME[] = _T("html");
 
 		GINL GAIA::BL HTMLCheckNodeName(GAIA::HTML::HTML_NODE nt, const GAIA::TCH* pszNodeName)
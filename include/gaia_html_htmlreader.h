@@ -0,0 +1,544 @@
+﻿#ifndef		__GAIA_HTML_HTMLREADER_H__
+#define		__GAIA_HTML_HTMLREADER_H__
+
+#include "gaia_type.h"
+#include "gaia_assert.h"
+#include "gaia_algo_string.h"
+#include "gaia_ctn_vector.h"
+#include "gaia_fsys_file.h"
+#include "gaia_html_htmlbase.h"
+
+namespace GAIA
+{
+	namespace HTML
+	{
+		/*!
+			@brief Streaming pull reader of html source.
+
+			@remarks The reader never build the node tree, it scan a fixed size window of the source and
+				return the events one by one. The name and value of a event is a slice of the window which
+				is not copied and not unescaped, it is valid until the next call of Read.
+
+				A tag or a comment must fit in the window, text longer than the window is returned by
+				several HTML_EVENT_TEXT events.
+		*/
+		class HTMLReader : public GAIA::Base
+		{
+		public:
+			static const GAIA::NUM DEFAULT_WINDOW_SIZE = 1024 * 64;
+			static const GAIA::NUM MIN_WINDOW_SIZE = 64;
+
+		public:
+			GINL HTMLReader(){this->init();}
+			GINL ~HTMLReader(){this->Close();}
+
+			/*!
+				@brief Open a file as the source.
+
+				@param pszFileName [in] Specify the file name.
+
+				@param sWindowSize [in] Specify the window size in bytes, it is the max size of a tag.
+
+				@return If open successfully, return GAIA::True, or will return GAIA::False.
+			*/
+			GINL GAIA::BL OpenFile(const GAIA::TCH* pszFileName, GAIA::NUM sWindowSize = DEFAULT_WINDOW_SIZE)
+			{
+				GAST(!GAIA::ALGO::gstremp(pszFileName));
+				if(GAIA::ALGO::gstremp(pszFileName))
+					return GAIA::False;
+				GAST(sWindowSize >= MIN_WINDOW_SIZE);
+				if(sWindowSize < MIN_WINDOW_SIZE)
+					return GAIA::False;
+				this->Close();
+				if(!m_file.Open(pszFileName, GAIA::FSYS::File::OPEN_TYPE_READ))
+					return GAIA::False;
+				m_window.resize(sWindowSize);
+				m_pData = m_window.fptr();
+				m_bEOF = GAIA::False;
+				m_bOpen = GAIA::True;
+				return GAIA::True;
+			}
+
+			/*!
+				@brief Open a memory buffer as the source.
+
+				@param pSrc [in] Specify the source buffer, it must be valid until the reader closed.
+
+				@param sSize [in] Specify the source size in bytes.
+
+				@return If open successfully, return GAIA::True, or will return GAIA::False.
+
+				@remarks The whole buffer is the window, the events is slices of the caller's buffer.
+			*/
+			GINL GAIA::BL OpenMem(const GAIA::GVOID* pSrc, GAIA::NUM sSize)
+			{
+				GAST(pSrc != GNIL);
+				if(pSrc == GNIL)
+					return GAIA::False;
+				GAST(sSize >= 0);
+				if(sSize < 0)
+					return GAIA::False;
+				this->Close();
+				m_pData = GSCAST(const GAIA::U8*)(pSrc);
+				m_sDataSize = sSize;
+				m_bEOF = GAIA::True;
+				m_bOpen = GAIA::True;
+				return GAIA::True;
+			}
+
+			GINL GAIA::GVOID Close()
+			{
+				if(m_file.IsOpen())
+					m_file.Close();
+				m_window.destroy();
+				m_names.destroy();
+				m_nameoffsets.destroy();
+				this->init();
+			}
+			GINL GAIA::BL IsOpen() const{return m_bOpen;}
+
+			/*!
+				@brief Read the next event.
+
+				@return Return the event type, after HTML_EVENT_END or HTML_EVENT_ERROR returned, it will be
+					returned always.
+			*/
+			GINL GAIA::HTML::HTML_EVENT Read()
+			{
+				if(!m_bOpen)
+					return GAIA::HTML::HTML_EVENT_ERROR;
+				if(m_event == GAIA::HTML::HTML_EVENT_END || m_event == GAIA::HTML::HTML_EVENT_ERROR)
+					return m_event;
+				m_pName = m_pValue = GNIL;
+				m_sNameLen = m_sValueLen = 0;
+				if(m_bInTag)
+					return this->read_tag();
+				return this->read_content();
+			}
+
+			GINL GAIA::HTML::HTML_EVENT GetEvent() const{return m_event;}
+
+			/*!
+				@brief Get the name of current event.
+
+				@remarks It is the element name of HTML_EVENT_STARTELEMENT and HTML_EVENT_ENDELEMENT, and the
+					attribute name of HTML_EVENT_ATTRIBUTE, other events have no name.
+			*/
+			GINL const GAIA::U8* GetName(GAIA::NUM& sLen) const{sLen = m_sNameLen; return m_pName;}
+
+			/*!
+				@brief Get the value of current event.
+
+				@remarks It is the attribute value of HTML_EVENT_ATTRIBUTE, the content of HTML_EVENT_TEXT,
+					HTML_EVENT_COMMENT and HTML_EVENT_HEAD.
+			*/
+			GINL const GAIA::U8* GetValue(GAIA::NUM& sLen) const{sLen = m_sValueLen; return m_pValue;}
+
+			/*!
+				@brief Check the current HTML_EVENT_STARTELEMENT is a empty element like <NODE1/>.
+			*/
+			GINL GAIA::BL IsEmptyElement() const{return m_bEmpty;}
+
+			/*!
+				@brief Get the count of the elements which contain the current event.
+			*/
+			GINL GAIA::NUM GetDepth() const{return m_sDepth;}
+
+			/*!
+				@brief Get the offset in bytes of the current event in the source.
+			*/
+			GINL GAIA::N64 GetOffset() const{return m_nEventOffset;}
+
+		private:
+			typedef GAIA::CTN::Vector<GAIA::U8> __WindowType;
+			typedef GAIA::CTN::Vector<GAIA::NUM> __OffsetListType;
+
+		private:
+			GINL GAIA::GVOID init()
+			{
+				m_pData = GNIL;
+				m_sDataSize = 0;
+				m_sPos = 0;
+				m_nDataOffset = 0;
+				m_nEventOffset = 0;
+				m_bOpen = GAIA::False;
+				m_bEOF = GAIA::True;
+				m_bInTag = GAIA::False;
+				m_bEmpty = GAIA::False;
+				m_sTagEnd = 0;
+				m_sDepth = 0;
+				m_event = GAIA::HTML::HTML_EVENT_INVALID;
+				m_pName = m_pValue = GNIL;
+				m_sNameLen = m_sValueLen = 0;
+			}
+			GINL GAIA::HTML::HTML_EVENT error()
+			{
+				m_pName = m_pValue = GNIL;
+				m_sNameLen = m_sValueLen = 0;
+				m_nEventOffset = m_nDataOffset + m_sPos;
+				return m_event = GAIA::HTML::HTML_EVENT_ERROR;
+			}
+			GINL GAIA::HTML::HTML_EVENT event(GAIA::HTML::HTML_EVENT e, GAIA::NUM sOffset)
+			{
+				m_nEventOffset = m_nDataOffset + sOffset;
+				return m_event = e;
+			}
+			/*!
+				@brief Move the unread bytes to the front of the window and fill the window by the file.
+
+				@return If any byte readed, return GAIA::True.
+			*/
+			GINL GAIA::BL fill()
+			{
+				if(m_bEOF)
+					return GAIA::False;
+				if(m_sPos > 0)
+				{
+					GAIA::U8* pWindow = m_window.fptr();
+					GAIA::NUM sRemain = m_sDataSize - m_sPos;
+					for(GAIA::NUM x = 0; x < sRemain; ++x)
+						pWindow[x] = pWindow[m_sPos + x];
+					m_nDataOffset += m_sPos;
+					m_sDataSize = sRemain;
+					m_sPos = 0;
+				}
+				if(m_sDataSize == m_window.size())
+					return GAIA::False;
+				GAIA::N32 nReaded = m_file.Read(m_window.fptr() + m_sDataSize, m_window.size() - m_sDataSize);
+				if(nReaded <= 0)
+				{
+					m_bEOF = GAIA::True;
+					return GAIA::False;
+				}
+				m_sDataSize += nReaded;
+				return GAIA::True;
+			}
+			/*!
+				@brief Find a string from the offset of window, fill the window if need.
+
+				@return Return the offset of the string in window, or return GINVALID if not found.
+					The bytes from m_sPos is kept, the offsets before the fill is adjusted by caller
+					by m_sPos being zero after fill.
+			*/
+			GINL GAIA::NUM find(GAIA::NUM sOffset, const GAIA::CH* pszFind, GAIA::NUM sFindLen)
+			{
+				GAIA::NUM sScan = sOffset;
+				for(;;)
+				{
+					for(; sScan + sFindLen <= m_sDataSize; ++sScan)
+					{
+						if(m_pData[sScan] != (GAIA::U8)pszFind[0])
+							continue;
+						GAIA::NUM x = 1;
+						for(; x < sFindLen; ++x)
+						{
+							if(m_pData[sScan + x] != (GAIA::U8)pszFind[x])
+								break;
+						}
+						if(x == sFindLen)
+							return sScan;
+					}
+					GAIA::NUM sOldPos = m_sPos;
+					if(!this->fill())
+						return GINVALID;
+					sScan -= sOldPos - m_sPos;
+				}
+			}
+			/*!
+				@brief Find the '>' of the tag begin at m_sPos, the '>' in quoted value is skipped.
+			*/
+			GINL GAIA::NUM find_tag_end()
+			{
+				GAIA::NUM sScan = m_sPos + 1;
+				GAIA::U8 uQuote = 0;
+				for(;;)
+				{
+					for(; sScan < m_sDataSize; ++sScan)
+					{
+						GAIA::U8 ch = m_pData[sScan];
+						if(uQuote != 0)
+						{
+							if(ch == uQuote)
+								uQuote = 0;
+						}
+						else if(ch == '\"' || ch == '\'')
+							uQuote = ch;
+						else if(ch == '>')
+							return sScan;
+						else if(ch == '<')
+							return GINVALID;
+					}
+					GAIA::NUM sOldPos = m_sPos;
+					if(!this->fill())
+						return GINVALID;
+					sScan -= sOldPos - m_sPos;
+				}
+			}
+			GINL GAIA::BL is_space(GAIA::U8 ch) const{return GAIA::ALGO::isblank(ch) || GAIA::ALGO::isspecial(ch);}
+			GINL GAIA::BL is_name_end(GAIA::U8 ch) const{return this->is_space(ch) || ch == '/' || ch == '>' || ch == '=';}
+			GINL GAIA::GVOID push_name(const GAIA::U8* p, GAIA::NUM sLen)
+			{
+				m_nameoffsets.push_back(m_names.size());
+				for(GAIA::NUM x = 0; x < sLen; ++x)
+					m_names.push_back(p[x]);
+			}
+			GINL GAIA::BL pop_name(const GAIA::U8* p, GAIA::NUM sLen)
+			{
+				if(m_nameoffsets.empty())
+					return GAIA::False;
+				GAIA::NUM sOffset = m_nameoffsets.back();
+				if(m_names.size() - sOffset != sLen)
+					return GAIA::False;
+				for(GAIA::NUM x = 0; x < sLen; ++x)
+				{
+					if(m_names[sOffset + x] != p[x])
+						return GAIA::False;
+				}
+				m_names.resize_keep(sOffset);
+				m_nameoffsets.pop_back();
+				return GAIA::True;
+			}
+			GINL GAIA::HTML::HTML_EVENT read_content()
+			{
+				for(;;)
+				{
+					while(m_sPos < m_sDataSize && this->is_space(m_pData[m_sPos]))
+						++m_sPos;
+					if(m_sPos == m_sDataSize)
+					{
+						m_sPos = m_sDataSize;
+						if(this->fill())
+							continue;
+						if(!m_nameoffsets.empty())
+							return this->error();
+						m_sDepth = 0;
+						return this->event(GAIA::HTML::HTML_EVENT_END, m_sPos);
+					}
+					if(m_pData[m_sPos] != '<')
+						return this->read_text();
+					if(m_sPos + 4 > m_sDataSize)
+						this->fill();
+					if(m_sPos + 1 >= m_sDataSize)
+						return this->error();
+					GAIA::U8 ch = m_pData[m_sPos + 1];
+					if(ch == '?') // Head like <?xml version="1.0" encoding="utf-8"?>.
+					{
+						GAIA::NUM sEnd = this->find(m_sPos + 2, "?>", 2);
+						if(sEnd == GINVALID)
+							return this->error();
+						m_pValue = m_pData + m_sPos + 2;
+						m_sValueLen = sEnd - m_sPos - 2;
+						GAIA::NUM sBegin = m_sPos;
+						m_sPos = sEnd + 2;
+						m_sDepth = m_nameoffsets.size();
+						return this->event(GAIA::HTML::HTML_EVENT_HEAD, sBegin);
+					}
+					else if(ch == '!')
+					{
+						if(m_sPos + 4 <= m_sDataSize && m_pData[m_sPos + 2] == '-' && m_pData[m_sPos + 3] == '-') // Comment like <!--comment content-->.
+						{
+							GAIA::NUM sEnd = this->find(m_sPos + 4, "-->", 3);
+							if(sEnd == GINVALID)
+								return this->error();
+							m_pValue = m_pData + m_sPos + 4;
+							m_sValueLen = sEnd - m_sPos - 4;
+							GAIA::NUM sBegin = m_sPos;
+							m_sPos = sEnd + 3;
+							m_sDepth = m_nameoffsets.size();
+							return this->event(GAIA::HTML::HTML_EVENT_COMMENT, sBegin);
+						}
+						if(m_sPos + 9 > m_sDataSize)
+							this->fill();
+						static const GAIA::CH CDATA_BEGIN[] = "<![CDATA[";
+						GAIA::NUM x = 0;
+						for(; x < 9 && m_sPos + x < m_sDataSize; ++x)
+						{
+							if(m_pData[m_sPos + x] != (GAIA::U8)CDATA_BEGIN[x])
+								break;
+						}
+						if(x == 9) // CDATA like <![CDATA[text]]>.
+						{
+							GAIA::NUM sEnd = this->find(m_sPos + 9, "]]>", 3);
+							if(sEnd == GINVALID)
+								return this->error();
+							m_pValue = m_pData + m_sPos + 9;
+							m_sValueLen = sEnd - m_sPos - 9;
+							GAIA::NUM sBegin = m_sPos;
+							m_sPos = sEnd + 3;
+							m_sDepth = m_nameoffsets.size();
+							return this->event(GAIA::HTML::HTML_EVENT_TEXT, sBegin);
+						}
+
+						// Head like <!DOCTYPE html>.
+						GAIA::NUM sEnd = this->find_tag_end();
+						if(sEnd == GINVALID)
+							return this->error();
+						m_pValue = m_pData + m_sPos + 2;
+						m_sValueLen = sEnd - m_sPos - 2;
+						GAIA::NUM sBegin = m_sPos;
+						m_sPos = sEnd + 1;
+						m_sDepth = m_nameoffsets.size();
+						return this->event(GAIA::HTML::HTML_EVENT_HEAD, sBegin);
+					}
+					else if(ch == '/') // Multi-Container node end like </NODE1>.
+					{
+						GAIA::NUM sEnd = this->find_tag_end();
+						if(sEnd == GINVALID)
+							return this->error();
+						GAIA::NUM sNameEnd = sEnd;
+						while(sNameEnd > m_sPos + 2 && this->is_space(m_pData[sNameEnd - 1]))
+							--sNameEnd;
+						m_pName = m_pData + m_sPos + 2;
+						m_sNameLen = sNameEnd - m_sPos - 2;
+						if(!this->pop_name(m_pName, m_sNameLen))
+							return this->error();
+						GAIA::NUM sBegin = m_sPos;
+						m_sPos = sEnd + 1;
+						m_sDepth = m_nameoffsets.size();
+						return this->event(GAIA::HTML::HTML_EVENT_ENDELEMENT, sBegin);
+					}
+					else // Container or Multi-Container node begin.
+						return this->read_tag_begin();
+				}
+			}
+			GINL GAIA::HTML::HTML_EVENT read_tag_begin()
+			{
+				GAIA::NUM sEnd = this->find_tag_end();
+				if(sEnd == GINVALID)
+					return this->error();
+				GAIA::NUM sNameEnd = m_sPos + 1;
+				while(sNameEnd < sEnd && !this->is_name_end(m_pData[sNameEnd]))
+					++sNameEnd;
+				if(sNameEnd == m_sPos + 1)
+					return this->error();
+				m_pName = m_pData + m_sPos + 1;
+				m_sNameLen = sNameEnd - m_sPos - 1;
+				m_bEmpty = m_pData[sEnd - 1] == '/';
+				m_sDepth = m_nameoffsets.size();
+				this->push_name(m_pName, m_sNameLen);
+				m_bInTag = GAIA::True;
+				m_sTagEnd = sEnd;
+				GAIA::NUM sBegin = m_sPos;
+				m_sPos = sNameEnd;
+				return this->event(GAIA::HTML::HTML_EVENT_STARTELEMENT, sBegin);
+			}
+			GINL GAIA::HTML::HTML_EVENT read_tag()
+			{
+				// The whole tag is in the window, so the window will not be filled until the tag end.
+				while(m_sPos < m_sTagEnd && this->is_space(m_pData[m_sPos]))
+					++m_sPos;
+				if(m_sPos == m_sTagEnd || m_pData[m_sPos] == '/')
+				{
+					m_bInTag = GAIA::False;
+					if(m_sPos != m_sTagEnd && m_sPos + 1 != m_sTagEnd)
+						return this->error();
+					GAIA::NUM sBegin = m_sPos;
+					m_sPos = m_sTagEnd + 1;
+					if(!m_bEmpty)
+						return this->read_content();
+					GAIA::NUM sOffset = m_nameoffsets.back();
+					m_pName = m_names.fptr() + sOffset;
+					m_sNameLen = m_names.size() - sOffset;
+					m_names.resize_keep(sOffset);
+					m_nameoffsets.pop_back();
+					m_bEmpty = GAIA::False;
+					m_sDepth = m_nameoffsets.size();
+					return this->event(GAIA::HTML::HTML_EVENT_ENDELEMENT, sBegin);
+				}
+
+				// Attribute like a="abc".
+				GAIA::NUM sBegin = m_sPos;
+				GAIA::NUM sNameEnd = m_sPos;
+				while(sNameEnd < m_sTagEnd && !this->is_name_end(m_pData[sNameEnd]))
+					++sNameEnd;
+				if(sNameEnd == m_sPos)
+					return this->error();
+				GAIA::NUM sValue = sNameEnd;
+				while(sValue < m_sTagEnd && this->is_space(m_pData[sValue]))
+					++sValue;
+				if(sValue == m_sTagEnd || m_pData[sValue] != '=')
+					return this->error();
+				++sValue;
+				while(sValue < m_sTagEnd && this->is_space(m_pData[sValue]))
+					++sValue;
+				if(sValue == m_sTagEnd || (m_pData[sValue] != '\"' && m_pData[sValue] != '\''))
+					return this->error();
+				GAIA::U8 uQuote = m_pData[sValue++];
+				GAIA::NUM sValueEnd = sValue;
+				while(sValueEnd < m_sTagEnd && m_pData[sValueEnd] != uQuote)
+					++sValueEnd;
+				if(sValueEnd == m_sTagEnd)
+					return this->error();
+				m_pName = m_pData + m_sPos;
+				m_sNameLen = sNameEnd - m_sPos;
+				m_pValue = m_pData + sValue;
+				m_sValueLen = sValueEnd - sValue;
+				m_sPos = sValueEnd + 1;
+				m_sDepth = m_nameoffsets.size();
+				return this->event(GAIA::HTML::HTML_EVENT_ATTRIBUTE, sBegin);
+			}
+			GINL GAIA::HTML::HTML_EVENT read_text()
+			{
+				GAIA::NUM sEnd = m_sPos;
+				for(;;)
+				{
+					while(sEnd < m_sDataSize && m_pData[sEnd] != '<')
+						++sEnd;
+					if(sEnd < m_sDataSize)
+						break;
+					GAIA::NUM sOldPos = m_sPos;
+					if(!this->fill())
+						break;
+					sEnd -= sOldPos - m_sPos;
+				}
+				GAIA::NUM sTextEnd = sEnd;
+				if(sEnd == m_sDataSize && !m_bEOF)
+				{
+					// The window is full of text, return a part of it which not end in a utf-8 sequence.
+					while(sTextEnd > m_sPos && (m_pData[sTextEnd - 1] & 0xC0) == 0x80)
+						--sTextEnd;
+					if(sTextEnd > m_sPos && m_pData[sTextEnd - 1] >= 0xC0)
+						--sTextEnd;
+					if(sTextEnd == m_sPos)
+						sTextEnd = sEnd;
+					sEnd = sTextEnd;
+				}
+				else
+				{
+					while(sTextEnd > m_sPos && this->is_space(m_pData[sTextEnd - 1]))
+						--sTextEnd;
+				}
+				m_pValue = m_pData + m_sPos;
+				m_sValueLen = sTextEnd - m_sPos;
+				GAIA::NUM sBegin = m_sPos;
+				m_sPos = sEnd;
+				m_sDepth = m_nameoffsets.size();
+				return this->event(GAIA::HTML::HTML_EVENT_TEXT, sBegin);
+			}
+
+		private:
+			GAIA::FSYS::File m_file;
+			__WindowType m_window;
+			const GAIA::U8* m_pData;
+			GAIA::NUM m_sDataSize;
+			GAIA::NUM m_sPos;
+			GAIA::N64 m_nDataOffset;
+			GAIA::N64 m_nEventOffset;
+			GAIA::BL m_bOpen;
+			GAIA::BL m_bEOF;
+			GAIA::BL m_bInTag;
+			GAIA::BL m_bEmpty;
+			GAIA::NUM m_sTagEnd;
+			GAIA::NUM m_sDepth;
+			__WindowType m_names;
+			__OffsetListType m_nameoffsets;
+			GAIA::HTML::HTML_EVENT m_event;
+			const GAIA::U8* m_pName;
+			const GAIA::U8* m_pValue;
+			GAIA::NUM m_sNameLen;
+			GAIA::NUM m_sValueLen;
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,1025 @@
+﻿#ifndef		__GAIA_JSON_JSONDOC_H__
+#define		__GAIA_JSON_JSONDOC_H__
+
+#include "gaia_type.h"
+#include "gaia_assert.h"
+#include "gaia_algo_base.h"
+#include "gaia_algo_memory.h"
+#include "gaia_algo_string.h"
+#include "gaia_algo_extend.h"
+#include "gaia_math_base.h"
+#include "gaia_ctn_vector.h"
+#include "gaia_fsys_file.h"
+
+#if defined(GAIA_SIMD_AVX2)
+#	include <immintrin.h>
+#elif defined(GAIA_SIMD_SSE2)
+#	include <emmintrin.h>
+#endif
+
+namespace GAIA
+{
+	namespace JSON
+	{
+		/*!
+			@brief The characters classify of a 64 bytes block of json source.
+
+			@remarks Every match function return a bit mask of the bytes in block.
+		*/
+		class JsonBlock : public GAIA::Base
+		{
+		public:
+			static const GAIA::NUM BLOCK_SIZE = 64;
+		public:
+			GINL JsonBlock(const GAIA::U8* p)
+			{
+			#if defined(GAIA_SIMD_AVX2)
+				m_data[0] = _mm256_loadu_si256(GRCAST(const __m256i*)(p));
+				m_data[1] = _mm256_loadu_si256(GRCAST(const __m256i*)(p + 32));
+			#elif defined(GAIA_SIMD_SSE2)
+				for(GAIA::NUM x = 0; x < 4; ++x)
+					m_data[x] = _mm_loadu_si128(GRCAST(const __m128i*)(p + x * 16));
+			#else
+				m_p = p;
+			#endif
+			}
+			GINL GAIA::U64 Match(GAIA::U8 ch) const
+			{
+			#if defined(GAIA_SIMD_AVX2)
+				__m256i v = _mm256_set1_epi8((GAIA::N8)ch);
+				GAIA::U64 uLow = (GAIA::U32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(m_data[0], v));
+				GAIA::U64 uHigh = (GAIA::U32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(m_data[1], v));
+				return uLow | (uHigh << 32);
+			#elif defined(GAIA_SIMD_SSE2)
+				__m128i v = _mm_set1_epi8((GAIA::N8)ch);
+				GAIA::U64 ret = 0;
+				for(GAIA::NUM x = 0; x < 4; ++x)
+					ret |= (GAIA::U64)(GAIA::U16)_mm_movemask_epi8(_mm_cmpeq_epi8(m_data[x], v)) << (x * 16);
+				return ret;
+			#else
+				GAIA::U64 ret = 0;
+				for(GAIA::NUM x = 0; x < BLOCK_SIZE; ++x)
+				{
+					if(m_p[x] == ch)
+						ret |= (GAIA::U64)1 << x;
+				}
+				return ret;
+			#endif
+			}
+			GINL GAIA::U64 MatchStructural() const
+			{
+				return this->Match('{') | this->Match('}') | this->Match('[') | this->Match(']') | this->Match(':') | this->Match(',');
+			}
+			GINL GAIA::U64 MatchSpace() const
+			{
+				return this->Match(' ') | this->Match('\t') | this->Match('\n') | this->Match('\r');
+			}
+		private:
+		#if defined(GAIA_SIMD_AVX2)
+			__m256i m_data[2];
+		#elif defined(GAIA_SIMD_SSE2)
+			__m128i m_data[4];
+		#else
+			const GAIA::U8* m_p;
+		#endif
+		};
+
+		/*!
+			@brief Json document parsed to a tape.
+
+			@remarks
+				The parse have two stages.
+				The first stage classify the source by 64 bytes a block(with SSE2 or AVX2 if supported),
+				find the escaped characters and the string ranges by bit operations, and collect the offset of
+				the structural characters, the string begin quotes and the scalar begin characters to a index list.
+				The second stage walk the index list and write every value to a tape of 64 bit words.
+
+				The strings are unescaped and terminated by '\0' in the source buffer, so the string values point to
+				the source buffer directly, and there is no heap allocation for every value.
+				The source buffer is owned by the document when LoadFromFile or LoadFromMem, and owned by the caller
+				when LoadInSitu, the caller's buffer will be modified and must be valid while the document is used.
+
+				The source size is limited to 4GB. UTF-8 is not validated, the bytes not in ASCII are kept as it is.
+
+				Tape word layout, the high 8 bits is the type character.
+					'{' or '[' : bits 32-55 is the child count(saturated), bits 0-31 is the tape index after the matched end word.
+					'}' or ']' : bits 0-55 is the tape index of the matched begin word.
+					'"' : bits 0-55 is the offset of the string in source, the next word is the string length.
+					'l' : the next word is a 64 bit signed integer.
+					'd' : the next word is a 64 bit real.
+					't', 'f', 'n' : true, false and null.
+		*/
+		class JsonDoc : public GAIA::Base
+		{
+		public:
+			class Value;
+			friend class Value;
+
+		public:
+			typedef GAIA::CTN::BasicVector<GAIA::U8, GAIA::N64, GAIA::ALGO::ExtendGold<GAIA::N64> > __BufferType;
+			typedef GAIA::CTN::BasicVector<GAIA::U64, GAIA::N64, GAIA::ALGO::ExtendGold<GAIA::N64> > __TapeType;
+			typedef GAIA::CTN::BasicVector<GAIA::U32, GAIA::N64, GAIA::ALGO::ExtendGold<GAIA::N64> > __IndexListType;
+			typedef GAIA::CTN::BasicVector<GAIA::N64, GAIA::N64, GAIA::ALGO::ExtendGold<GAIA::N64> > __ScopeListType;
+
+		public:
+			static const GAIA::N64 MAX_SOURCE_SIZE = (GAIA::N64)0xFFFFFFFF;
+			static const GAIA::U64 MAX_CHILD_COUNT = 0xFFFFFF;
+
+		public:
+			GAIA_ENUM_BEGIN(VALUE_TYPE)
+				VALUE_TYPE_OBJECT,
+				VALUE_TYPE_ARRAY,
+				VALUE_TYPE_STRING,
+				VALUE_TYPE_INT,
+				VALUE_TYPE_REAL,
+				VALUE_TYPE_BOOL,
+				VALUE_TYPE_NULL,
+			GAIA_ENUM_END(VALUE_TYPE)
+
+		public:
+			/*!
+				@brief The view of a value in the tape.
+
+				@remarks
+					The children of array are the elements, the children of object are the member names and values alternately,
+					so the next of a member name is the member value.
+					The value is valid until the document reset or load again.
+			*/
+			class Value : public GAIA::Base
+			{
+				friend class JsonDoc;
+			public:
+				GINL Value(){m_pDoc = GNIL; m_nIndex = GINVALID;}
+				GINL GAIA::BL empty() const{return m_pDoc == GNIL;}
+				GINL GAIA::JSON::JsonDoc::VALUE_TYPE GetType() const;
+				GINL const GAIA::CH* GetString() const;
+				GINL GAIA::N64 GetStringLength() const;
+				GINL GAIA::N64 GetInt() const;
+				GINL GAIA::F64 GetReal() const;
+				GINL GAIA::BL GetBool() const;
+				GINL GAIA::N64 GetChildCount() const;
+				GINL GAIA::JSON::JsonDoc::Value GetFirstChild() const;
+				GINL GAIA::JSON::JsonDoc::Value GetNext() const;
+				GINL GAIA::JSON::JsonDoc::Value GetMember(const GAIA::CH* pszName) const;
+				GINL GAIA::JSON::JsonDoc::Value GetElement(GAIA::N64 nIndex) const;
+			private:
+				GINL Value(const JsonDoc* pDoc, GAIA::N64 nIndex){m_pDoc = pDoc; m_nIndex = nIndex;}
+				GINL GAIA::U8 GetTapeType() const{return (GAIA::U8)(m_pDoc->m_tape[m_nIndex] >> 56);}
+			private:
+				const JsonDoc* m_pDoc;
+				GAIA::N64 m_nIndex;
+			};
+
+		public:
+			GINL JsonDoc(){this->init();}
+			GINL ~JsonDoc(){this->Destroy();}
+
+			/*!
+				@brief Reset the document, the memory is kept for next load.
+			*/
+			GINL GAIA::GVOID Reset()
+			{
+				m_pSrc = GNIL;
+				m_nSrcSize = 0;
+				m_indexes.clear();
+				m_tape.clear();
+				m_scopes.clear();
+				m_nErrorOffset = GINVALID;
+			}
+
+			/*!
+				@brief Reset the document and release all memory.
+			*/
+			GINL GAIA::GVOID Destroy()
+			{
+				this->Reset();
+				m_buf.destroy();
+				m_indexes.destroy();
+				m_tape.destroy();
+				m_scopes.destroy();
+			}
+
+			/*!
+				@brief Load json from file.
+
+				@param pszFileName [in] Specify the file name.
+
+				@return If load successfully, return GAIA::True, or will return GAIA::False.
+			*/
+			GINL GAIA::BL LoadFromFile(const GAIA::TCH* pszFileName)
+			{
+				GAST(!GAIA::ALGO::gstremp(pszFileName));
+				if(GAIA::ALGO::gstremp(pszFileName))
+					return GAIA::False;
+
+				this->Reset();
+
+				GAIA::FSYS::File f;
+				if(!f.Open(pszFileName, GAIA::FSYS::File::OPEN_TYPE_READ))
+					return GAIA::False;
+				GAIA::N64 nSize = f.Size();
+				if(nSize <= 0 || nSize > MAX_SOURCE_SIZE)
+					return GAIA::False;
+
+				m_buf.resize(nSize);
+				GAIA::N64 nReaded = 0;
+				while(nReaded < nSize)
+				{
+					GAIA::N32 nPart = (GAIA::N32)GAIA::ALGO::gmin(nSize - nReaded, (GAIA::N64)1024 * 1024 * 64);
+					GAIA::N32 nRet = f.Read(m_buf.fptr() + nReaded, nPart);
+					if(nRet <= 0)
+						return GAIA::False;
+					nReaded += nRet;
+				}
+
+				return this->parse(m_buf.fptr(), nSize);
+			}
+
+			/*!
+				@brief Load json from memory, the source is copied to the document.
+
+				@param p [in] Specify the source.
+
+				@param nSize [in] Specify the source size in bytes.
+
+				@return If load successfully, return GAIA::True, or will return GAIA::False.
+			*/
+			GINL GAIA::BL LoadFromMem(const GAIA::GVOID* p, GAIA::N64 nSize)
+			{
+				GAST(p != GNIL);
+				if(p == GNIL)
+					return GAIA::False;
+				GAST(nSize > 0 && nSize <= MAX_SOURCE_SIZE);
+				if(nSize <= 0 || nSize > MAX_SOURCE_SIZE)
+					return GAIA::False;
+
+				this->Reset();
+
+				m_buf.resize(nSize);
+				GAIA::ALGO::gmemcpy(m_buf.fptr(), p, nSize);
+				return this->parse(m_buf.fptr(), nSize);
+			}
+
+			/*!
+				@brief Load json in the source buffer directly.
+
+				@param p [in] Specify the source, it will be modified by the parse.
+
+				@param nSize [in] Specify the source size in bytes.
+
+				@return If load successfully, return GAIA::True, or will return GAIA::False.
+
+				@remarks The source buffer must be valid while the document and it's values are used.
+			*/
+			GINL GAIA::BL LoadInSitu(GAIA::GVOID* p, GAIA::N64 nSize)
+			{
+				GAST(p != GNIL);
+				if(p == GNIL)
+					return GAIA::False;
+				GAST(nSize > 0 && nSize <= MAX_SOURCE_SIZE);
+				if(nSize <= 0 || nSize > MAX_SOURCE_SIZE)
+					return GAIA::False;
+
+				this->Reset();
+
+				return this->parse(GSCAST(GAIA::U8*)(p), nSize);
+			}
+
+			/*!
+				@brief Get the root value.
+
+				@return If the document is loaded, return the root value, or will return a empty value.
+			*/
+			GINL GAIA::JSON::JsonDoc::Value GetRoot() const
+			{
+				if(m_tape.empty())
+					return GAIA::JSON::JsonDoc::Value();
+				return GAIA::JSON::JsonDoc::Value(this, 0);
+			}
+
+			/*!
+				@brief Get the source offset where the last load failed.
+
+				@return If the last load failed, return the offset in bytes, or will return GINVALID.
+			*/
+			GINL GAIA::N64 GetErrorOffset() const{return m_nErrorOffset;}
+
+			GINL GAIA::N64 GetStructuralCount() const{return m_indexes.size();}
+			GINL GAIA::N64 GetTapeSize() const{return m_tape.size();}
+
+		private:
+			GINL GAIA::GVOID init()
+			{
+				m_pSrc = GNIL;
+				m_nSrcSize = 0;
+				m_nErrorOffset = GINVALID;
+			}
+			GINL GAIA::BL parse(GAIA::U8* p, GAIA::N64 nSize)
+			{
+				m_pSrc = p;
+				m_nSrcSize = nSize;
+				if(!this->build_index() || !this->build_tape())
+				{
+					m_indexes.clear();
+					m_tape.clear();
+					return GAIA::False;
+				}
+				return GAIA::True;
+			}
+			GINL GAIA::BL error(GAIA::N64 nOffset)
+			{
+				m_nErrorOffset = nOffset;
+				return GAIA::False;
+			}
+
+			static GINL GAIA::U64 PrefixXor(GAIA::U64 u)
+			{
+				u ^= u << 1;
+				u ^= u << 2;
+				u ^= u << 4;
+				u ^= u << 8;
+				u ^= u << 16;
+				u ^= u << 32;
+				return u;
+			}
+
+			/*!
+				@brief Find the characters escaped by odd length backslash sequences.
+
+				@param uBackslash [in] Specify the backslash mask of current block.
+
+				@param uPrevOddBackslash [in,out] Specify the block before current block is end by a odd length backslash sequence or not(0 or 1).
+
+				@return Return the mask of escaped characters.
+			*/
+			static GINL GAIA::U64 FindEscaped(GAIA::U64 uBackslash, GAIA::U64& uPrevOddBackslash)
+			{
+				static const GAIA::U64 EVEN_BITS = 0x5555555555555555ULL;
+				static const GAIA::U64 ODD_BITS = ~EVEN_BITS;
+				GAIA::U64 uStartEdges = uBackslash & ~(uBackslash << 1);
+				GAIA::U64 uEvenStartMask = EVEN_BITS ^ uPrevOddBackslash;
+				GAIA::U64 uEvenStarts = uStartEdges & uEvenStartMask;
+				GAIA::U64 uOddStarts = uStartEdges & ~uEvenStartMask;
+				GAIA::U64 uEvenCarries = uBackslash + uEvenStarts;
+				GAIA::U64 uOddCarries = uBackslash + uOddStarts;
+				GAIA::BL bOddOverflow = uOddCarries < uBackslash;
+				uOddCarries |= uPrevOddBackslash;
+				uPrevOddBackslash = bOddOverflow ? 1 : 0;
+				GAIA::U64 uEvenCarryEnds = uEvenCarries & ~uBackslash;
+				GAIA::U64 uOddCarryEnds = uOddCarries & ~uBackslash;
+				return (uEvenCarryEnds & ODD_BITS) | (uOddCarryEnds & EVEN_BITS);
+			}
+			static GINL GAIA::BL IsTerminator(GAIA::U8 ch)
+			{
+				switch(ch)
+				{
+				case ' ':
+				case '\t':
+				case '\n':
+				case '\r':
+				case ',':
+				case ':':
+				case '[':
+				case ']':
+				case '{':
+				case '}':
+					return GAIA::True;
+				default:
+					return GAIA::False;
+				}
+			}
+			static GINL GAIA::BL IsDigit(GAIA::U8 ch){return ch >= '0' && ch <= '9';}
+			static GINL GAIA::NUM HexValue(GAIA::U8 ch)
+			{
+				if(ch >= '0' && ch <= '9')
+					return ch - '0';
+				if(ch >= 'a' && ch <= 'f')
+					return ch - 'a' + 10;
+				if(ch >= 'A' && ch <= 'F')
+					return ch - 'A' + 10;
+				return GINVALID;
+			}
+
+			/*!
+				@brief Find the first quote, backslash or control character in a string.
+			*/
+			static GINL GAIA::U8* FindStringSpecial(GAIA::U8* p, const GAIA::U8* pEnd)
+			{
+			#if defined(GAIA_SIMD_SSE2) || defined(GAIA_SIMD_AVX2)
+				const __m128i vQuote = _mm_set1_epi8('"');
+				const __m128i vBackslash = _mm_set1_epi8('\\');
+				const __m128i vControl = _mm_set1_epi8(0x1F);
+				while(pEnd - p >= 16)
+				{
+					__m128i v = _mm_loadu_si128(GRCAST(const __m128i*)(p));
+					__m128i vMatch = _mm_or_si128(_mm_cmpeq_epi8(v, vQuote), _mm_cmpeq_epi8(v, vBackslash));
+					vMatch = _mm_or_si128(vMatch, _mm_cmpeq_epi8(_mm_max_epu8(v, vControl), vControl));
+					GAIA::U32 uMask = (GAIA::U32)_mm_movemask_epi8(vMatch);
+					if(uMask != 0)
+						return p + GAIA::ALGO::gctz(uMask);
+					p += 16;
+				}
+			#endif
+				while(p < pEnd && *p != '"' && *p != '\\' && *p >= 0x20)
+					++p;
+				return p;
+			}
+
+			GINL GAIA::BL build_index()
+			{
+				GAIA::U64 uPrevOddBackslash = 0;
+				GAIA::U64 uPrevInString = 0;
+				GAIA::U64 uPrevScalar = 0;
+				GAIA::N64 nCount = 0;
+				GAIA::U8 tail[JsonBlock::BLOCK_SIZE];
+				for(GAIA::N64 nOffset = 0; nOffset < m_nSrcSize; nOffset += JsonBlock::BLOCK_SIZE)
+				{
+					const GAIA::U8* p = m_pSrc + nOffset;
+					if(m_nSrcSize - nOffset < JsonBlock::BLOCK_SIZE)
+					{
+						GAIA::ALGO::gmemset(tail, ' ', sizeof(tail));
+						GAIA::ALGO::gmemcpy(tail, p, m_nSrcSize - nOffset);
+						p = tail;
+					}
+					JsonBlock block(p);
+
+					/* The quotes not escaped are the string begin and end, the string range include the begin quote. */
+					GAIA::U64 uEscaped = FindEscaped(block.Match('\\'), uPrevOddBackslash);
+					GAIA::U64 uQuote = block.Match('"') & ~uEscaped;
+					GAIA::U64 uInString = PrefixXor(uQuote) ^ uPrevInString;
+					uPrevInString = (GAIA::U64)((GAIA::N64)uInString >> 63);
+
+					/* The scalar begin are the characters not space, structural or quote, and not follow a scalar character. */
+					GAIA::U64 uOp = block.MatchStructural();
+					GAIA::U64 uScalar = ~(uOp | block.MatchSpace() | uQuote);
+					GAIA::U64 uScalarBegin = uScalar & ~((uScalar << 1) | uPrevScalar);
+					uPrevScalar = uScalar >> 63;
+
+					GAIA::U64 uStructural = ((uOp | uScalarBegin) & ~uInString) | (uQuote & uInString);
+					if(m_indexes.size() < nCount + JsonBlock::BLOCK_SIZE)
+						m_indexes.resize_keep(GAIA::ALGO::gmax(m_indexes.size() * 2, nCount + JsonBlock::BLOCK_SIZE));
+					GAIA::U32* pIndex = m_indexes.fptr();
+					while(uStructural != 0)
+					{
+						pIndex[nCount++] = (GAIA::U32)(nOffset + GAIA::ALGO::gctz(uStructural));
+						uStructural &= uStructural - 1;
+					}
+				}
+				m_indexes.resize_keep(nCount);
+				if(uPrevInString != 0)
+					return this->error(m_nSrcSize);
+				return GAIA::True;
+			}
+			GINL GAIA::BL build_tape()
+			{
+				GAIA::N64 nCount = m_indexes.size();
+				if(nCount == 0)
+					return this->error(0);
+				if(nCount * 2 > (GAIA::N64)GAIA::U32MAX)
+					return this->error(0);
+
+				/* Every structural write 2 tape words at most. */
+				m_tape.resize(nCount * 2);
+				m_scopes.clear();
+				const GAIA::U32* pIndex = m_indexes.fptr();
+				GAIA::U64* pTape = m_tape.fptr();
+				GAIA::N64 nTape = 0;
+				GAIA::N64 i = 0;
+
+			PARSE_VALUE:
+				{
+					if(i >= nCount)
+						return this->error(m_nSrcSize);
+					GAIA::N64 nOffset = pIndex[i];
+					GAIA::U8 ch = m_pSrc[nOffset];
+					switch(ch)
+					{
+					case '{':
+					case '[':
+						{
+							m_scopes.push_back(nTape);
+							pTape[nTape++] = (GAIA::U64)ch << 56;
+							++i;
+							if(i < nCount && m_pSrc[pIndex[i]] == ch + 2)
+							{
+								this->close_scope(pTape, nTape);
+								++i;
+								goto PARSE_AFTER_VALUE;
+							}
+							if(ch == '{')
+								goto PARSE_MEMBER_NAME;
+							goto PARSE_VALUE;
+						}
+					case '"':
+						{
+							if(!this->parse_string(nOffset, pTape, nTape))
+								return this->error(nOffset);
+						}
+						break;
+					case 't':
+						{
+							if(!this->parse_literal(nOffset, "true", 4))
+								return this->error(nOffset);
+							pTape[nTape++] = (GAIA::U64)'t' << 56;
+						}
+						break;
+					case 'f':
+						{
+							if(!this->parse_literal(nOffset, "false", 5))
+								return this->error(nOffset);
+							pTape[nTape++] = (GAIA::U64)'f' << 56;
+						}
+						break;
+					case 'n':
+						{
+							if(!this->parse_literal(nOffset, "null", 4))
+								return this->error(nOffset);
+							pTape[nTape++] = (GAIA::U64)'n' << 56;
+						}
+						break;
+					default:
+						{
+							if(ch != '-' && !IsDigit(ch))
+								return this->error(nOffset);
+							if(!this->parse_number(nOffset, pTape, nTape))
+								return this->error(nOffset);
+						}
+						break;
+					}
+					++i;
+					goto PARSE_AFTER_VALUE;
+				}
+
+			PARSE_MEMBER_NAME:
+				{
+					if(i >= nCount)
+						return this->error(m_nSrcSize);
+					GAIA::N64 nOffset = pIndex[i];
+					if(m_pSrc[nOffset] != '"')
+						return this->error(nOffset);
+					if(!this->parse_string(nOffset, pTape, nTape))
+						return this->error(nOffset);
+					++i;
+					if(i >= nCount)
+						return this->error(m_nSrcSize);
+					if(m_pSrc[pIndex[i]] != ':')
+						return this->error(pIndex[i]);
+					++i;
+					goto PARSE_VALUE;
+				}
+
+			PARSE_AFTER_VALUE:
+				{
+					if(m_scopes.empty())
+					{
+						if(i != nCount)
+							return this->error(pIndex[i]);
+						m_tape.resize_keep(nTape);
+						return GAIA::True;
+					}
+					GAIA::U64& uBegin = pTape[m_scopes.back()];
+					if(((uBegin >> 32) & MAX_CHILD_COUNT) != MAX_CHILD_COUNT)
+						uBegin += (GAIA::U64)1 << 32;
+					if(i >= nCount)
+						return this->error(m_nSrcSize);
+					GAIA::U8 ch = m_pSrc[pIndex[i]];
+					GAIA::U8 chBegin = (GAIA::U8)(uBegin >> 56);
+					if(ch == ',')
+					{
+						++i;
+						if(chBegin == '{')
+							goto PARSE_MEMBER_NAME;
+						goto PARSE_VALUE;
+					}
+					if(ch != chBegin + 2)
+						return this->error(pIndex[i]);
+					this->close_scope(pTape, nTape);
+					++i;
+					goto PARSE_AFTER_VALUE;
+				}
+			}
+			GINL GAIA::GVOID close_scope(GAIA::U64* pTape, GAIA::N64& nTape)
+			{
+				GAIA::N64 nBegin = m_scopes.back();
+				m_scopes.pop_back();
+				GAIA::U8 chEnd = (GAIA::U8)((pTape[nBegin] >> 56) + 2);
+				pTape[nTape++] = ((GAIA::U64)chEnd << 56) | (GAIA::U64)nBegin;
+				pTape[nBegin] |= (GAIA::U64)nTape;
+			}
+			GINL GAIA::BL parse_literal(GAIA::N64 nOffset, const GAIA::CH* pszLiteral, GAIA::N64 nLen) const
+			{
+				if(m_nSrcSize - nOffset < nLen)
+					return GAIA::False;
+				for(GAIA::N64 x = 0; x < nLen; ++x)
+				{
+					if(m_pSrc[nOffset + x] != (GAIA::U8)pszLiteral[x])
+						return GAIA::False;
+				}
+				if(nOffset + nLen < m_nSrcSize && !IsTerminator(m_pSrc[nOffset + nLen]))
+					return GAIA::False;
+				return GAIA::True;
+			}
+			GINL GAIA::BL parse_string(GAIA::N64 nOffset, GAIA::U64* pTape, GAIA::N64& nTape)
+			{
+				GAIA::U8* pBegin = m_pSrc + nOffset + 1;
+				const GAIA::U8* pEnd = m_pSrc + m_nSrcSize;
+				GAIA::U8* pSrc = FindStringSpecial(pBegin, pEnd);
+				GAIA::U8* pDst = pSrc;
+				while(pSrc < pEnd)
+				{
+					GAIA::U8 ch = *pSrc;
+					if(ch == '"')
+					{
+						*pDst = '\0';
+						pTape[nTape++] = ((GAIA::U64)'"' << 56) | (GAIA::U64)(pBegin - m_pSrc);
+						pTape[nTape++] = (GAIA::U64)(pDst - pBegin);
+						return GAIA::True;
+					}
+					else if(ch == '\\')
+					{
+						if(pEnd - pSrc < 2)
+							return GAIA::False;
+						switch(pSrc[1])
+						{
+						case '"': *pDst++ = '"'; break;
+						case '\\': *pDst++ = '\\'; break;
+						case '/': *pDst++ = '/'; break;
+						case 'b': *pDst++ = '\b'; break;
+						case 'f': *pDst++ = '\f'; break;
+						case 'n': *pDst++ = '\n'; break;
+						case 'r': *pDst++ = '\r'; break;
+						case 't': *pDst++ = '\t'; break;
+						case 'u':
+							{
+								GAIA::U32 uCode;
+								if(!this->parse_unicode(pSrc, pEnd, uCode))
+									return GAIA::False;
+								if(uCode < 0x80)
+									*pDst++ = (GAIA::U8)uCode;
+								else if(uCode < 0x800)
+								{
+									*pDst++ = (GAIA::U8)(0xC0 | (uCode >> 6));
+									*pDst++ = (GAIA::U8)(0x80 | (uCode & 0x3F));
+								}
+								else if(uCode < 0x10000)
+								{
+									*pDst++ = (GAIA::U8)(0xE0 | (uCode >> 12));
+									*pDst++ = (GAIA::U8)(0x80 | ((uCode >> 6) & 0x3F));
+									*pDst++ = (GAIA::U8)(0x80 | (uCode & 0x3F));
+								}
+								else
+								{
+									*pDst++ = (GAIA::U8)(0xF0 | (uCode >> 18));
+									*pDst++ = (GAIA::U8)(0x80 | ((uCode >> 12) & 0x3F));
+									*pDst++ = (GAIA::U8)(0x80 | ((uCode >> 6) & 0x3F));
+									*pDst++ = (GAIA::U8)(0x80 | (uCode & 0x3F));
+								}
+							}
+							continue;
+						default:
+							return GAIA::False;
+						}
+						pSrc += 2;
+					}
+					else if(ch < 0x20)
+						return GAIA::False;
+					else
+						*pDst++ = *pSrc++;
+				}
+				return GAIA::False;
+			}
+			GINL GAIA::BL parse_unicode(GAIA::U8*& pSrc, const GAIA::U8* pEnd, GAIA::U32& uCode) const
+			{
+				if(!this->parse_hex4(pSrc, pEnd, uCode))
+					return GAIA::False;
+				pSrc += 6;
+				if(uCode >= 0xDC00 && uCode <= 0xDFFF)
+					return GAIA::False;
+				if(uCode >= 0xD800 && uCode <= 0xDBFF)
+				{
+					if(pEnd - pSrc < 2 || pSrc[0] != '\\' || pSrc[1] != 'u')
+						return GAIA::False;
+					GAIA::U32 uLow;
+					if(!this->parse_hex4(pSrc, pEnd, uLow))
+						return GAIA::False;
+					if(uLow < 0xDC00 || uLow > 0xDFFF)
+						return GAIA::False;
+					pSrc += 6;
+					uCode = 0x10000 + ((uCode - 0xD800) << 10) + (uLow - 0xDC00);
+				}
+				return GAIA::True;
+			}
+			GINL GAIA::BL parse_hex4(const GAIA::U8* pSrc, const GAIA::U8* pEnd, GAIA::U32& uCode) const
+			{
+				if(pEnd - pSrc < 6)
+					return GAIA::False;
+				uCode = 0;
+				for(GAIA::NUM x = 2; x < 6; ++x)
+				{
+					GAIA::NUM sHex = HexValue(pSrc[x]);
+					if(sHex == GINVALID)
+						return GAIA::False;
+					uCode = (uCode << 4) | (GAIA::U32)sHex;
+				}
+				return GAIA::True;
+			}
+			GINL GAIA::BL parse_number(GAIA::N64 nOffset, GAIA::U64* pTape, GAIA::N64& nTape) const
+			{
+				static const GAIA::F64 POW10[] =
+				{
+					1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+					1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+				};
+				static const GAIA::NUM MAX_DIGITS = 19;
+
+				const GAIA::U8* p = m_pSrc + nOffset;
+				const GAIA::U8* pEnd = m_pSrc + m_nSrcSize;
+				GAIA::BL bNegative = GAIA::False;
+				if(*p == '-')
+				{
+					bNegative = GAIA::True;
+					++p;
+				}
+				if(p == pEnd || !IsDigit(*p))
+					return GAIA::False;
+
+				/* Integer part, the digits more than MAX_DIGITS are dropped and counted to exponent. */
+				GAIA::U64 uMantissa = 0;
+				GAIA::NUM sDigits = 0;
+				GAIA::N64 nExponent = 0;
+				if(*p == '0')
+				{
+					++p;
+					if(p != pEnd && IsDigit(*p))
+						return GAIA::False;
+				}
+				else
+				{
+					while(p != pEnd && IsDigit(*p))
+					{
+						if(sDigits < MAX_DIGITS)
+						{
+							uMantissa = uMantissa * 10 + (*p - '0');
+							++sDigits;
+						}
+						else
+							++nExponent;
+						++p;
+					}
+				}
+
+				/* Fraction part. */
+				GAIA::BL bReal = GAIA::False;
+				if(p != pEnd && *p == '.')
+				{
+					bReal = GAIA::True;
+					++p;
+					if(p == pEnd || !IsDigit(*p))
+						return GAIA::False;
+					while(p != pEnd && IsDigit(*p))
+					{
+						if(sDigits < MAX_DIGITS)
+						{
+							uMantissa = uMantissa * 10 + (*p - '0');
+							if(uMantissa != 0)
+								++sDigits;
+							--nExponent;
+						}
+						++p;
+					}
+				}
+
+				/* Exponent part. */
+				if(p != pEnd && (*p == 'e' || *p == 'E'))
+				{
+					bReal = GAIA::True;
+					++p;
+					GAIA::BL bNegativeExponent = GAIA::False;
+					if(p != pEnd && (*p == '-' || *p == '+'))
+					{
+						bNegativeExponent = *p == '-';
+						++p;
+					}
+					if(p == pEnd || !IsDigit(*p))
+						return GAIA::False;
+					GAIA::N64 nExp = 0;
+					while(p != pEnd && IsDigit(*p))
+					{
+						if(nExp < 100000)
+							nExp = nExp * 10 + (*p - '0');
+						++p;
+					}
+					nExponent += bNegativeExponent ? -nExp : nExp;
+				}
+				if(p != pEnd && !IsTerminator(*p))
+					return GAIA::False;
+
+				if(!bReal && nExponent == 0)
+				{
+					if(!bNegative && uMantissa <= (GAIA::U64)GAIA::N64MAX)
+					{
+						pTape[nTape++] = (GAIA::U64)'l' << 56;
+						pTape[nTape++] = uMantissa;
+						return GAIA::True;
+					}
+					if(bNegative && uMantissa <= (GAIA::U64)GAIA::N64MAX + 1)
+					{
+						pTape[nTape++] = (GAIA::U64)'l' << 56;
+						pTape[nTape++] = 0 - uMantissa;
+						return GAIA::True;
+					}
+				}
+
+				/* The mantissa and the power of 10 are exact in double when both are small. */
+				GAIA::F64 fValue = (GAIA::F64)uMantissa;
+				if(uMantissa < ((GAIA::U64)1 << 53) && nExponent >= -22 && nExponent <= 22)
+				{
+					if(nExponent < 0)
+						fValue /= POW10[-nExponent];
+					else
+						fValue *= POW10[nExponent];
+				}
+				else if(uMantissa != 0)
+				{
+					if(nExponent < -300)
+					{
+						fValue *= GAIA::MATH::gpow(10.0, -300.0);
+						nExponent += 300;
+					}
+					fValue *= GAIA::MATH::gpow(10.0, (GAIA::F64)nExponent);
+				}
+				if(bNegative)
+					fValue = -fValue;
+				pTape[nTape++] = (GAIA::U64)'d' << 56;
+				GAIA::ALGO::gmemcpy(&pTape[nTape++], &fValue, sizeof(fValue));
+				return GAIA::True;
+			}
+
+		private:
+			__BufferType m_buf;
+			GAIA::U8* m_pSrc;
+			GAIA::N64 m_nSrcSize;
+			__IndexListType m_indexes;
+			__TapeType m_tape;
+			__ScopeListType m_scopes;
+			GAIA::N64 m_nErrorOffset;
+		};
+
+		GINL GAIA::JSON::JsonDoc::VALUE_TYPE JsonDoc::Value::GetType() const
+		{
+			if(this->empty())
+				return GAIA::JSON::JsonDoc::VALUE_TYPE_INVALID;
+			switch(this->GetTapeType())
+			{
+			case '{':
+				return GAIA::JSON::JsonDoc::VALUE_TYPE_OBJECT;
+			case '[':
+				return GAIA::JSON::JsonDoc::VALUE_TYPE_ARRAY;
+			case '"':
+				return GAIA::JSON::JsonDoc::VALUE_TYPE_STRING;
+			case 'l':
+				return GAIA::JSON::JsonDoc::VALUE_TYPE_INT;
+			case 'd':
+				return GAIA::JSON::JsonDoc::VALUE_TYPE_REAL;
+			case 't':
+			case 'f':
+				return GAIA::JSON::JsonDoc::VALUE_TYPE_BOOL;
+			case 'n':
+				return GAIA::JSON::JsonDoc::VALUE_TYPE_NULL;
+			default:
+				GASTFALSE;
+				return GAIA::JSON::JsonDoc::VALUE_TYPE_INVALID;
+			}
+		}
+		GINL const GAIA::CH* JsonDoc::Value::GetString() const
+		{
+			if(this->GetType() != GAIA::JSON::JsonDoc::VALUE_TYPE_STRING)
+				return GNIL;
+			GAIA::U64 uOffset = m_pDoc->m_tape[m_nIndex] & ((((GAIA::U64)1) << 56) - 1);
+			return GRCAST(const GAIA::CH*)(m_pDoc->m_pSrc + uOffset);
+		}
+		GINL GAIA::N64 JsonDoc::Value::GetStringLength() const
+		{
+			if(this->GetType() != GAIA::JSON::JsonDoc::VALUE_TYPE_STRING)
+				return 0;
+			return (GAIA::N64)m_pDoc->m_tape[m_nIndex + 1];
+		}
+		GINL GAIA::N64 JsonDoc::Value::GetInt() const
+		{
+			switch(this->GetType())
+			{
+			case GAIA::JSON::JsonDoc::VALUE_TYPE_INT:
+				return (GAIA::N64)m_pDoc->m_tape[m_nIndex + 1];
+			case GAIA::JSON::JsonDoc::VALUE_TYPE_REAL:
+				return (GAIA::N64)this->GetReal();
+			case GAIA::JSON::JsonDoc::VALUE_TYPE_BOOL:
+				return this->GetBool() ? 1 : 0;
+			default:
+				return 0;
+			}
+		}
+		GINL GAIA::F64 JsonDoc::Value::GetReal() const
+		{
+			switch(this->GetType())
+			{
+			case GAIA::JSON::JsonDoc::VALUE_TYPE_INT:
+				return (GAIA::F64)this->GetInt();
+			case GAIA::JSON::JsonDoc::VALUE_TYPE_REAL:
+				{
+					GAIA::F64 ret;
+					GAIA::ALGO::gmemcpy(&ret, &m_pDoc->m_tape[m_nIndex + 1], sizeof(ret));
+					return ret;
+				}
+			case GAIA::JSON::JsonDoc::VALUE_TYPE_BOOL:
+				return this->GetBool() ? 1.0 : 0.0;
+			default:
+				return 0.0;
+			}
+		}
+		GINL GAIA::BL JsonDoc::Value::GetBool() const
+		{
+			if(this->empty())
+				return GAIA::False;
+			return this->GetTapeType() == 't';
+		}
+		GINL GAIA::N64 JsonDoc::Value::GetChildCount() const
+		{
+			GAIA::JSON::JsonDoc::VALUE_TYPE type = this->GetType();
+			if(type != GAIA::JSON::JsonDoc::VALUE_TYPE_OBJECT && type != GAIA::JSON::JsonDoc::VALUE_TYPE_ARRAY)
+				return 0;
+			GAIA::N64 ret = (GAIA::N64)((m_pDoc->m_tape[m_nIndex] >> 32) & GAIA::JSON::JsonDoc::MAX_CHILD_COUNT);
+			if(ret == (GAIA::N64)GAIA::JSON::JsonDoc::MAX_CHILD_COUNT)
+			{
+				ret = 0;
+				for(GAIA::JSON::JsonDoc::Value v = this->GetFirstChild(); !v.empty(); v = v.GetNext())
+					++ret;
+				if(type == GAIA::JSON::JsonDoc::VALUE_TYPE_OBJECT)
+					ret /= 2;
+			}
+			return ret;
+		}
+		GINL GAIA::JSON::JsonDoc::Value JsonDoc::Value::GetFirstChild() const
+		{
+			GAIA::JSON::JsonDoc::VALUE_TYPE type = this->GetType();
+			if(type != GAIA::JSON::JsonDoc::VALUE_TYPE_OBJECT && type != GAIA::JSON::JsonDoc::VALUE_TYPE_ARRAY)
+				return GAIA::JSON::JsonDoc::Value();
+			GAIA::JSON::JsonDoc::Value ret(m_pDoc, m_nIndex + 1);
+			GAIA::U8 ch = ret.GetTapeType();
+			if(ch == '}' || ch == ']')
+				return GAIA::JSON::JsonDoc::Value();
+			return ret;
+		}
+		GINL GAIA::JSON::JsonDoc::Value JsonDoc::Value::GetNext() const
+		{
+			if(this->empty())
+				return GAIA::JSON::JsonDoc::Value();
+			GAIA::U64 uWord = m_pDoc->m_tape[m_nIndex];
+			GAIA::N64 nNext;
+			switch(uWord >> 56)
+			{
+			case '{':
+			case '[':
+				nNext = (GAIA::N64)(uWord & GAIA::U32MAX);
+				break;
+			case '"':
+			case 'l':
+			case 'd':
+				nNext = m_nIndex + 2;
+				break;
+			default:
+				nNext = m_nIndex + 1;
+				break;
+			}
+			if(nNext >= m_pDoc->m_tape.size())
+				return GAIA::JSON::JsonDoc::Value();
+			GAIA::JSON::JsonDoc::Value ret(m_pDoc, nNext);
+			GAIA::U8 ch = ret.GetTapeType();
+			if(ch == '}' || ch == ']')
+				return GAIA::JSON::JsonDoc::Value();
+			return ret;
+		}
+		GINL GAIA::JSON::JsonDoc::Value JsonDoc::Value::GetMember(const GAIA::CH* pszName) const
+		{
+			GAST(pszName != GNIL);
+			if(this->GetType() != GAIA::JSON::JsonDoc::VALUE_TYPE_OBJECT)
+				return GAIA::JSON::JsonDoc::Value();
+			for(GAIA::JSON::JsonDoc::Value v = this->GetFirstChild(); !v.empty(); v = v.GetNext().GetNext())
+			{
+				if(GAIA::ALGO::gstrcmp(v.GetString(), pszName) == 0)
+					return v.GetNext();
+			}
+			return GAIA::JSON::JsonDoc::Value();
+		}
+		GINL GAIA::JSON::JsonDoc::Value JsonDoc::Value::GetElement(GAIA::N64 nIndex) const
+		{
+			if(this->GetType() != GAIA::JSON::JsonDoc::VALUE_TYPE_ARRAY)
+				return GAIA::JSON::JsonDoc::Value();
+			GAIA::JSON::JsonDoc::Value v = this->GetFirstChild();
+			for(; !v.empty() && nIndex > 0; --nIndex)
+				v = v.GetNext();
+			return v;
+		}
+	}
+}
+
+#endif
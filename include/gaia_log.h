@@ -3,23 +3,57 @@
 
 #include "gaia_type.h"
 #include "gaia_assert.h"
+#include "gaia_sync_base.h"
 #include "gaia_sync_atomic.h"
+#include "gaia_sync_lock.h"
 #include "gaia_sync_autolock.h"
+#include "gaia_sync_event.h"
+#include "gaia_sync_tls.h"
+#include "gaia_algo_memory.h"
 #include "gaia_algo_string.h"
 #include "gaia_ctn_chars.h"
 #include "gaia_ctn_string.h"
 #include "gaia_ctn_vector.h"
 #include "gaia_stream_stringstream.h"
 #include "gaia_time.h"
+#include "gaia_thread.h"
+#include "gaia_fsys_file.h"
 
 namespace GAIA
 {
 	namespace LOG
 	{
+		/*!
+			@brief Log.
+
+			@remarks
+				By default, Write call the callback in lock, or cache the log and call the callback when the cache is full.
+
+				In async mode which is begun by BeginAsync, the logs are written to a file by a background writer thread.
+				Each thread format its logs into its own lock free ring buffer, with the time stamp from a coarse clock,
+				so Write never lock, never call localtime and never do any I/O.
+				The writer thread collect the rings and write them to the file by large batches.
+		*/
 		class Log : public GAIA::Base
 		{
 		public:
 			typedef GAIA::U32 __FilterType;
+
+			/*!
+				@brief Default ring buffer size of each thread in async mode.
+			*/
+			static const GAIA::NUM ASYNC_RING_SIZE = 1024 * 64;
+
+			/*!
+				@brief The batch size in bytes of the writer thread in async mode.
+			*/
+			static const GAIA::NUM ASYNC_WRITE_SIZE = 1024 * 256;
+
+			/*!
+				@brief The interval in milliseconds of the writer thread, the coarse clock is updated by the same interval.
+			*/
+			static const GAIA::U32 ASYNC_INTERVAL = 10;
+
 			GAIA_ENUM_BEGIN(TYPE)
 				TYPE_LOG = 1 << 0,
 				TYPE_WARNING = 1 << 1,
@@ -48,6 +82,33 @@ namespace GAIA
 				GAIA::CTN::TString strLog;
 			};
 			typedef GAIA::CTN::Vector<Node> __NodeList;
+			class AsyncRing : public GAIA::Base
+			{
+			public:
+				GAIA::U8* p;
+				GAIA::UM uSize; // Power of 2.
+				volatile GAIA::UM uHead; // Written by the owner thread.
+				volatile GAIA::UM uTail; // Written by the writer thread.
+				volatile GAIA::BL bAbandon; // The owner thread is exited.
+				AsyncRing* pNext;
+			};
+			class AsyncRecord : public GAIA::Base
+			{
+			public:
+				AsyncRing* pRing;
+				GAIA::UM uBegin;
+				GAIA::UM uHead;
+				GAIA::UM uLimit;
+			};
+			class AsyncThread : public GAIA::THREAD::Thread
+			{
+			public:
+				GINL AsyncThread(Log& logobj) : m_logobj(logobj){}
+				virtual GAIA::GVOID Run(){m_logobj.AsyncProc();}
+			private:
+				Log& m_logobj;
+			};
+			friend class AsyncThread;
 		public:
 			/* Stream output flag. */
 			class FlagType : public GAIA::Base
@@ -69,8 +130,13 @@ namespace GAIA
 			};
 		public:
 			/* Base function. */
-			GINL Log(){this->init();}
-			GINL ~Log(){this->Flush();}
+			GINL Log() : m_asyncthread(*this){this->init();}
+			GINL ~Log()
+			{
+				if(this->IsAsync())
+					this->EndAsync();
+				this->Flush();
+			}
 			GINL GAIA::GVOID Clean()
 			{
 				m_linebreak.clear();
@@ -109,6 +175,76 @@ namespace GAIA
 				return GAIA::True;
 			}
 			GINL const GAIA::TCH* GetLineBreak() const{return m_linebreak;}
+
+			/*!
+				@brief Begin async mode.
+
+				@param pszFileName [in] Specify the file to write the logs, it will be created always.
+
+				@param sRingSize [in] Specify the ring buffer size in bytes of each thread, it will be rounded up to power of 2.
+					A log longer than half of the ring is truncated.
+
+				@return If success return GAIA::True, or return GAIA::False.
+
+				@remarks
+					In async mode the callback is not used, each log is written as a line of
+					time, type, user filter and the log in utf-8.
+					When the ring of a thread is full, Write wait the writer thread to make room.
+			*/
+			GINL GAIA::BL BeginAsync(const GAIA::TCH* pszFileName, GAIA::NUM sRingSize = ASYNC_RING_SIZE)
+			{
+				GAST(!GAIA::ALGO::gstremp(pszFileName));
+				GAST(sRingSize > 0);
+				if(this->IsAsync())
+					return GAIA::False;
+				this->Flush();
+				if(!m_asyncfile.Open(pszFileName, GAIA::FSYS::File::OPEN_TYPE_CREATEALWAYS | GAIA::FSYS::File::OPEN_TYPE_WRITE))
+					return GAIA::False;
+				m_uAsyncRingSize = 1024 * 4;
+				while(m_uAsyncRingSize < (GAIA::UM)sRingSize)
+					m_uAsyncRingSize <<= 1;
+				m_pAsyncBuf = gnew GAIA::U8[ASYNC_WRITE_SIZE];
+				m_sAsyncBufSize = 0;
+				m_asyncslot.Create(OnAsyncThreadExit);
+				this->UpdateAsyncClock();
+				m_asyncflushreq = 0;
+				m_lAsyncFlushAck = 0;
+				m_bAsyncStop = GAIA::False;
+				m_bAsyncSignaled = GAIA::False;
+				m_bAsync = GAIA::True;
+				if(!m_asyncthread.Start())
+				{
+					m_bAsync = GAIA::False;
+					this->ReleaseAsync();
+					return GAIA::False;
+				}
+				return GAIA::True;
+			}
+
+			/*!
+				@brief End async mode.
+
+				@remarks
+					All the logs in rings are written to the file before the file closed.
+					It should not be called when other threads are writing logs.
+			*/
+			GINL GAIA::BL EndAsync()
+			{
+				if(!this->IsAsync())
+					return GAIA::False;
+				m_bAsync = GAIA::False;
+				m_bAsyncStop = GAIA::True;
+				m_asyncevent.Fire();
+				m_asyncthread.Wait();
+				this->ReleaseAsync();
+				return GAIA::True;
+			}
+
+			/*!
+				@brief Check current log is in async mode or not.
+			*/
+			GINL GAIA::BL IsAsync() const{return m_bAsync;}
+
 			GINL GAIA::BL Write(TYPE type, __FilterType userfilter, const GAIA::TCH* pszLog)
 			{
 				if(!(type & this->GetTypeFilter()))
@@ -117,6 +253,8 @@ namespace GAIA
 					return GAIA::False;
 				if(GAIA::ALGO::gstremp(pszLog))
 					return GAIA::False;
+				if(m_bAsync)
+					return this->WriteAsync(type, userfilter, pszLog);
 				GAIA::TIME::Time logtime;
 				logtime.localtime();
 				GAIA::SYNC::Autolock al(m_lock);
@@ -150,6 +288,17 @@ namespace GAIA
 			}
 			GINL GAIA::GVOID Flush()
 			{
+				if(m_bAsync)
+				{
+					// Wait the writer thread write all the logs before now to the file.
+					GAIA::N64 lReq = m_asyncflushreq.Increase();
+					while(m_lAsyncFlushAck < lReq && m_bAsync)
+					{
+						this->SignalAsync();
+						GAIA::SYNC::gsleep(1);
+					}
+					return;
+				}
 				if(m_nodes.empty())
 					return;
 				GAIA::SYNC::Autolock al(m_lock);
@@ -270,6 +419,17 @@ namespace GAIA
 				m_bCallBacking = GAIA::False;
 				m_flagtype.m_type = TYPE_LOG;
 				m_flaguserfilter.m_filter = (__FilterType)GINVALID;
+				m_bAsync = GAIA::False;
+				m_bAsyncStop = GAIA::False;
+				m_bAsyncSignaled = GAIA::False;
+				m_uAsyncRingSize = 0;
+				m_pAsyncRingList = GNIL;
+				m_pAsyncBuf = GNIL;
+				m_sAsyncBufSize = 0;
+				m_lAsyncFlushAck = 0;
+				m_asyncclock[0][0] = '\0';
+				m_asyncclock[1][0] = '\0';
+				m_sAsyncClockIndex = 0;
 			}
 			template<typename _ParamDataType> GAIA::GVOID WriteToStringStream(_ParamDataType t)
 			{
@@ -281,6 +441,216 @@ namespace GAIA
 				m_lock.Enter();
 				m_lockcnt.Increase();
 			}
+			GINL GAIA::BL WriteAsync(TYPE type, __FilterType userfilter, const GAIA::TCH* pszLog)
+			{
+				AsyncRecord rec;
+				rec.pRing = this->GetAsyncRing();
+				rec.uBegin = rec.uHead = rec.uLimit = rec.pRing->uHead;
+
+				// Time.
+				GAIA::NUM sClockIndex = m_sAsyncClockIndex;
+				GAIA::SYNC::gmembarrier();
+				for(const GAIA::CH* p = m_asyncclock[sClockIndex]; *p != '\0'; ++p)
+					this->PutAsync(rec, *p);
+				this->PutAsync(rec, ' ');
+
+				// Type and user filter.
+				this->PutAsync(rec, this->GetLogTypeString(type));
+				this->PutAsync(rec, ' ');
+				GAIA::CH szFilter[sizeof(userfilter) * 2 + 1];
+				GAIA::ALGO::hex2str(GRCAST(const GAIA::U8*)(&userfilter), sizeof(userfilter), szFilter);
+				for(GAIA::NUM x = 0; x < (GAIA::NUM)sizeof(userfilter) * 2; ++x)
+					this->PutAsync(rec, szFilter[x]);
+				this->PutAsync(rec, ' ');
+
+				// Log, truncate it if it is too long, and keep the line break.
+				this->PutAsync(rec, pszLog, rec.pRing->uSize / 2);
+				this->PutAsync(rec, m_linebreak.fptr());
+
+				// Commit.
+				GAIA::SYNC::gmembarrier();
+				rec.pRing->uHead = rec.uHead;
+				if(rec.uHead - rec.pRing->uTail > rec.pRing->uSize / 2)
+					this->SignalAsync();
+				return GAIA::True;
+			}
+			GINL GAIA::GVOID PutAsync(AsyncRecord& rec, GAIA::CH ch)
+			{
+				if(rec.uHead == rec.uLimit)
+				{
+					for(;;)
+					{
+						rec.uLimit = rec.pRing->uTail + rec.pRing->uSize;
+						GAIA::SYNC::gmembarrier();
+						if(rec.uHead != rec.uLimit)
+							break;
+						this->SignalAsync();
+						GAIA::SYNC::gsleep(1);
+					}
+				}
+				rec.pRing->p[rec.uHead & (rec.pRing->uSize - 1)] = (GAIA::U8)ch;
+				++rec.uHead;
+			}
+			GINL GAIA::GVOID PutAsync(AsyncRecord& rec, const GAIA::TCH* psz, GAIA::UM uMaxRecordSize = 0)
+			{
+				// Encode to utf-8.
+				for(; *psz != '\0'; ++psz)
+				{
+					if(uMaxRecordSize != 0 && rec.uHead - rec.uBegin >= uMaxRecordSize)
+						break;
+					GAIA::U32 u = (GAIA::U32)*psz;
+					if(sizeof(GAIA::TCH) == sizeof(GAIA::CH))
+						u &= 0xFF;
+					else if(sizeof(GAIA::TCH) == 2 && u >= 0xD800 && u < 0xDC00 && psz[1] >= 0xDC00 && psz[1] < 0xE000)
+					{
+						++psz;
+						u = 0x10000 + ((u - 0xD800) << 10) + ((GAIA::U32)*psz - 0xDC00);
+					}
+					if(sizeof(GAIA::TCH) == sizeof(GAIA::CH) || u < 0x80)
+						this->PutAsync(rec, (GAIA::CH)u);
+					else if(u < 0x800)
+					{
+						this->PutAsync(rec, (GAIA::CH)(0xC0 | (u >> 6)));
+						this->PutAsync(rec, (GAIA::CH)(0x80 | (u & 0x3F)));
+					}
+					else if(u < 0x10000)
+					{
+						this->PutAsync(rec, (GAIA::CH)(0xE0 | (u >> 12)));
+						this->PutAsync(rec, (GAIA::CH)(0x80 | ((u >> 6) & 0x3F)));
+						this->PutAsync(rec, (GAIA::CH)(0x80 | (u & 0x3F)));
+					}
+					else
+					{
+						this->PutAsync(rec, (GAIA::CH)(0xF0 | ((u >> 18) & 0x07)));
+						this->PutAsync(rec, (GAIA::CH)(0x80 | ((u >> 12) & 0x3F)));
+						this->PutAsync(rec, (GAIA::CH)(0x80 | ((u >> 6) & 0x3F)));
+						this->PutAsync(rec, (GAIA::CH)(0x80 | (u & 0x3F)));
+					}
+				}
+			}
+			GINL GAIA::GVOID SignalAsync()
+			{
+				if(m_bAsyncSignaled)
+					return;
+				m_bAsyncSignaled = GAIA::True;
+				m_asyncevent.Fire();
+			}
+			GINL AsyncRing* GetAsyncRing()
+			{
+				AsyncRing* pRing = GSCAST(AsyncRing*)(m_asyncslot.Get());
+				if(pRing != GNIL)
+					return pRing;
+				pRing = gnew AsyncRing;
+				pRing->p = gnew GAIA::U8[m_uAsyncRingSize];
+				pRing->uSize = m_uAsyncRingSize;
+				pRing->uHead = 0;
+				pRing->uTail = 0;
+				pRing->bAbandon = GAIA::False;
+				{
+					GAIA::SYNC::Autolock al(m_asynclock);
+					pRing->pNext = m_pAsyncRingList;
+					m_pAsyncRingList = pRing;
+				}
+				m_asyncslot.Set(pRing);
+				return pRing;
+			}
+			static GAIA::GVOID GAIA_TLS_CALLBACK OnAsyncThreadExit(GAIA::GVOID* p)
+			{
+				// The ring is released by the writer thread after it is drained.
+				if(p != GNIL)
+					GSCAST(AsyncRing*)(p)->bAbandon = GAIA::True;
+			}
+			GINL GAIA::GVOID UpdateAsyncClock()
+			{
+				GAIA::TIME::Time t;
+				t.localtime();
+				GAIA::CH szTime[64];
+				t.to(szTime);
+				GAIA::NUM sIndex = 1 - m_sAsyncClockIndex;
+				GAIA::TIME::timemkaux(szTime, m_asyncclock[sIndex]);
+				GAIA::SYNC::gmembarrier();
+				m_sAsyncClockIndex = sIndex;
+			}
+			GINL GAIA::GVOID AsyncProc()
+			{
+				for(;;)
+				{
+					GAIA::BL bStop = m_bAsyncStop;
+					m_asyncevent.Wait(ASYNC_INTERVAL);
+					m_bAsyncSignaled = GAIA::False;
+					this->UpdateAsyncClock();
+					GAIA::N64 lReq = m_asyncflushreq;
+					this->DrainAsync();
+					if(lReq != m_lAsyncFlushAck)
+					{
+						m_asyncfile.Flush();
+						m_lAsyncFlushAck = lReq;
+					}
+					if(bStop)
+						break;
+				}
+			}
+			GINL GAIA::GVOID DrainAsync()
+			{
+				GAIA::SYNC::Autolock al(m_asynclock);
+				AsyncRing** ppRing = &m_pAsyncRingList;
+				while(*ppRing != GNIL)
+				{
+					AsyncRing* pRing = *ppRing;
+					GAIA::BL bAbandon = pRing->bAbandon;
+					GAIA::SYNC::gmembarrier();
+					GAIA::UM uHead = pRing->uHead;
+					GAIA::SYNC::gmembarrier();
+					GAIA::UM uTail = pRing->uTail;
+					while(uTail != uHead)
+					{
+						if(m_sAsyncBufSize == ASYNC_WRITE_SIZE)
+							this->WriteAsyncBuf();
+						GAIA::UM uOffset = uTail & (pRing->uSize - 1);
+						GAIA::UM uLen = GAIA::ALGO::gmin(uHead - uTail, pRing->uSize - uOffset);
+						uLen = GAIA::ALGO::gmin(uLen, (GAIA::UM)(ASYNC_WRITE_SIZE - m_sAsyncBufSize));
+						GAIA::ALGO::gmemcpy(m_pAsyncBuf + m_sAsyncBufSize, pRing->p + uOffset, uLen);
+						m_sAsyncBufSize += (GAIA::NUM)uLen;
+						uTail += uLen;
+						GAIA::SYNC::gmembarrier();
+						pRing->uTail = uTail;
+					}
+					if(bAbandon)
+					{
+						*ppRing = pRing->pNext;
+						gdel[] pRing->p;
+						gdel pRing;
+						continue;
+					}
+					ppRing = &pRing->pNext;
+				}
+				this->WriteAsyncBuf();
+			}
+			GINL GAIA::GVOID WriteAsyncBuf()
+			{
+				if(m_sAsyncBufSize == 0)
+					return;
+				m_asyncfile.Write(m_pAsyncBuf, (GAIA::N32)m_sAsyncBufSize);
+				m_sAsyncBufSize = 0;
+			}
+			GINL GAIA::GVOID ReleaseAsync()
+			{
+				m_asyncslot.Destroy();
+				while(m_pAsyncRingList != GNIL)
+				{
+					AsyncRing* pNext = m_pAsyncRingList->pNext;
+					gdel[] m_pAsyncRingList->p;
+					gdel m_pAsyncRingList;
+					m_pAsyncRingList = pNext;
+				}
+				if(m_pAsyncBuf != GNIL)
+				{
+					gdel[] m_pAsyncBuf;
+					m_pAsyncBuf = GNIL;
+				}
+				m_sAsyncBufSize = 0;
+				m_asyncfile.Close();
+			}
 		private:
 			__LineBreakFlagType m_linebreak;
 			CallBack* m_pCallBack;
@@ -293,6 +663,22 @@ namespace GAIA
 			GAIA::STREAM::StringStream m_stm;
 			FlagType m_flagtype;
 			FlagUserFilter m_flaguserfilter;
+			volatile GAIA::BL m_bAsync;
+			volatile GAIA::BL m_bAsyncStop;
+			volatile GAIA::BL m_bAsyncSignaled;
+			GAIA::UM m_uAsyncRingSize;
+			AsyncRing* m_pAsyncRingList;
+			GAIA::SYNC::Lock m_asynclock;
+			GAIA::SYNC::Event m_asyncevent;
+			AsyncThread m_asyncthread;
+			GAIA::FSYS::File m_asyncfile;
+			GAIA::U8* m_pAsyncBuf;
+			GAIA::NUM m_sAsyncBufSize;
+			GAIA::SYNC::Atomic m_asyncflushreq;
+			volatile GAIA::N64 m_lAsyncFlushAck;
+			GAIA::CH m_asyncclock[2][64]; // Double buffered coarse clock, updated by the writer thread.
+			volatile GAIA::NUM m_sAsyncClockIndex;
+			GAIA::SYNC::TlsSlot m_asyncslot;
 		};
 
 		class InvalidLog : public GAIA::Base
@@ -6,12 +6,28 @@
 #include "gaia_msys_base.h"
 #include "gaia_sync_atomic.h"
 #include "gaia_sync_lock.h"
+#include "gaia_sync_tls.h"
 #include <stdlib.h>
 
 namespace GAIA
 {
 	namespace MSYS
 	{
+		/*!
+			@brief Section heap with thread caches.
+
+			@remarks
+				The small buffer is allocated from a size class, named section.
+				Each thread hold a cache of free buffer lists, one list per section,
+				so the common alloc and release never lock and never write any shared memory.
+
+				When the list of thread cache is empty, it is refilled by a batch from the lock free central list of the section,
+				or from the origin buffers of the section in lock if the central list is empty.
+				When the list of thread cache is too long, a batch is returned in the same way.
+
+				The statistics are counted by each thread, and summed when they are queried,
+				so the statistics are approximate when the other threads are allocating.
+		*/
 		class HeapESG : public GAIA::MSYS::Heap
 		{
 		public:
@@ -19,148 +35,71 @@ namespace GAIA
 			GINL ~HeapESG(){this->ReleaseHeap();}
 			GINL virtual GAIA::GVOID* memory_alloc(const GAIA::UM& uSize)
 			{
-				m_piecesize.Increase();
-				m_alloctimes.Increase();
+				ThreadCache& tc = this->GetThreadCache();
+				++tc.stat.lPieceSize;
+				++tc.stat.lAllocTimes;
+				tc.stat.lUseSize += (GAIA::N64)uSize;
 
 				GAIA::UM uSectionIndex = this->GetSectionIndex(uSize + HEAP_BUFFER_HEADERSIZE);
 				if(uSectionIndex == (GAIA::UM)GINVALID)
 				{
 					m_capacity.Add(uSize + HEAP_BUFFER_HEADERSIZE);
-					m_size.Add(uSize + HEAP_BUFFER_HEADERSIZE);
-					m_usesize.Add(uSize);
+					tc.stat.lSize += (GAIA::N64)(uSize + HEAP_BUFFER_HEADERSIZE);
 
-					GAIA::GVOID* pTemp = (GAIA::U8*)malloc(uSize + HEAP_BUFFER_HEADERSIZE);
-					*GSCAST(GAIA::UM*)(pTemp) = uSize;
-					*GRCAST(GAIA::U16*)(GSCAST(GAIA::U8*)(pTemp) + sizeof(GAIA::UM)) = (GAIA::U16)GINVALID;
-					return GSCAST(GAIA::U8*)(pTemp) + sizeof(GAIA::UM) + sizeof(GAIA::U16);
+					GAIA::U8* pTemp = (GAIA::U8*)malloc(uSize + HEAP_BUFFER_HEADERSIZE);
+					BufferHeader& header = *GRCAST(BufferHeader*)(pTemp);
+					header.uSize = uSize;
+					header.uOriginBufferIndex = (GAIA::U16)GINVALID;
+					header.uSectionIndex = (GAIA::U8)GINVALID;
+					return pTemp + HEAP_BUFFER_HEADERSIZE;
 				}
-				else
-				{
-					m_size.Add(m_secsizelist[uSectionIndex]);
-					m_usesize.Add(uSize);
-				}
-				GAIA::GVOID* pRet;
-			#ifdef GAIA_HEAP_THREADSAFE
-				m_lr.Enter();
-			#endif
-				{
-					Section& hs = m_seclist[uSectionIndex];
-					if(hs.uMinFreeIndex == (GAIA::UM)GINVALID)
-					{
-						hs.uMinFreeSize = (GAIA::UM)GINVALID;
-						for(GAIA::UM x = 0; x < hs.uObListSize; ++x)
-						{
-							OriginBuffer& ob = hs.oblist[x];
-							if(ob.buf != GNIL && ob.uFreeStackSize != 0 && ob.uFreeStackSize < hs.uMinFreeSize)
-							{
-								hs.uMinFreeSize = (GAIA::UM)ob.uFreeStackSize;
-								hs.uMinFreeIndex = x;
-							}
-						}
-					}
-					if(hs.uMinFreeIndex == (GAIA::UM)GINVALID)
-					{
-						GAIA::U16 uOriginBufferIndex;
-						if(hs.uFreeStackSize == 0)
-						{
-							OriginBuffer newob;
-							newob.buf = GNIL;
-							newob.freestack = GNIL;
-							newob.uFreeStackSize = 0;
-							newob.uFreeStackCapacity = 0;
-							uOriginBufferIndex = (GAIA::U16)hs.uObListSize;
-							this->push(newob, hs.oblist, hs.uObListSize, hs.uObListCapacity);
-						}
-						else
-						{
-							uOriginBufferIndex = (GAIA::U16)hs.freestack[hs.uFreeStackSize - 1];
-							--hs.uFreeStackSize;
-						}
-						OriginBuffer& newobref = hs.oblist[uOriginBufferIndex];
-						GAIA::UM uSectionPatchCount = this->GetSectionPatchCount(uSectionIndex);
-						GAIA::UM uSectionPatchSize = m_secsizelist[uSectionIndex];
-						newobref.buf = (GAIA::U8*)malloc(uSectionPatchSize * uSectionPatchCount);
-						m_capacity.Add(uSectionPatchSize * uSectionPatchCount);
-						for(GAIA::UM x = 0; x < uSectionPatchCount; ++x)
-						{
-							GAIA::U8* pTemp = (GAIA::U8*)newobref.buf + uSectionPatchSize * x;
-							*GRCAST(GAIA::UM*)(pTemp) = uSectionPatchSize;
-							*GRCAST(GAIA::U16*)(pTemp + sizeof(GAIA::UM)) = uOriginBufferIndex;
-							this->push(pTemp, newobref.freestack, newobref.uFreeStackSize, newobref.uFreeStackCapacity);
-						}
-						pRet = newobref.freestack[newobref.uFreeStackSize - 1];
-						--newobref.uFreeStackSize;
-						hs.uMinFreeIndex = uOriginBufferIndex;
-						hs.uMinFreeSize = uSectionPatchCount - 1;
-					}
-					else
-					{
-						OriginBuffer& ob = hs.oblist[hs.uMinFreeIndex];
-						pRet = ob.freestack[ob.uFreeStackSize - 1];
-						--ob.uFreeStackSize;
-						--hs.uMinFreeSize;
-						if(hs.uMinFreeSize == 0)
-						{
-							hs.uMinFreeIndex = (GAIA::UM)GINVALID;
-							hs.uMinFreeSize = (GAIA::UM)GINVALID;
-						}
-					}
-				}
-			#ifdef GAIA_HEAP_THREADSAFE
-				m_lr.Leave();
-			#endif
-				*GSCAST(GAIA::UM*)(pRet) = uSize;
-				return GSCAST(GAIA::U8*)(pRet) + sizeof(GAIA::UM) + sizeof(GAIA::U16);
+				tc.stat.lSize += (GAIA::N64)m_secsizelist[uSectionIndex];
+
+				FreeList& fl = tc.lists[uSectionIndex];
+				if(fl.pHead == GNIL)
+					this->FetchBatch(tc, uSectionIndex);
+				GAIA::U8* pRet = fl.pHead;
+				fl.pHead = nextbuf(pRet);
+				--fl.uSize;
+				tc.uCachedSize -= m_secsizelist[uSectionIndex];
+				GRCAST(BufferHeader*)(pRet)->uSize = uSize;
+				return pRet + HEAP_BUFFER_HEADERSIZE;
 			}
 			GINL virtual GAIA::GVOID memory_release(GAIA::GVOID* p)
 			{
-				GAIA::U8* pOriginP = GSCAST(GAIA::U8*)(p) - sizeof(GAIA::UM) - sizeof(GAIA::U16);
-				GAIA::U16 uOBIndex = *GRCAST(GAIA::U16*)(pOriginP + sizeof(GAIA::UM));
-				if(uOBIndex == (GAIA::U16)GINVALID)
+				GAIA::U8* pOriginP = GSCAST(GAIA::U8*)(p) - HEAP_BUFFER_HEADERSIZE;
+				BufferHeader& header = *GRCAST(BufferHeader*)(pOriginP);
+				ThreadCache& tc = this->GetThreadCache();
+				--tc.stat.lPieceSize;
+				tc.stat.lUseSize -= (GAIA::N64)header.uSize;
+
+				if(header.uOriginBufferIndex == (GAIA::U16)GINVALID)
 				{
-					m_capacity.Add(-(GAIA::N64)this->memory_size(p) - (GAIA::N64)HEAP_BUFFER_HEADERSIZE);
-					m_size.Add(-(GAIA::N64)this->memory_size(p) - (GAIA::N64)HEAP_BUFFER_HEADERSIZE);
-					m_usesize.Add(-(GAIA::N64)this->memory_size(p));
-					m_piecesize.Decrease();
+					m_capacity.Add(-(GAIA::N64)header.uSize - (GAIA::N64)HEAP_BUFFER_HEADERSIZE);
+					tc.stat.lSize -= (GAIA::N64)(header.uSize + HEAP_BUFFER_HEADERSIZE);
 					free(pOriginP);
 					return;
 				}
-				GAIA::UM uSectionIndex = this->GetSectionIndex(*GRCAST(GAIA::UM*)(pOriginP) + HEAP_BUFFER_HEADERSIZE);
-				GAST(uSectionIndex != (GAIA::UM)GINVALID);
-				m_size.Add(-(GAIA::N64)m_secsizelist[uSectionIndex]);
-				m_usesize.Add(-(GAIA::N64)this->memory_size(p));
-				m_piecesize.Decrease();
-			#ifdef GAIA_HEAP_THREADSAFE
-				m_lr.Enter();
-			#endif
-				{
-					Section& hs = m_seclist[uSectionIndex];
-					OriginBuffer& ob = hs.oblist[uOBIndex];
-					this->push(pOriginP, ob.freestack, ob.uFreeStackSize, ob.uFreeStackCapacity);
-					if(ob.uFreeStackSize == this->GetSectionPatchCount(uSectionIndex))
-					{
-						m_capacity.Add(-((GAIA::N64)m_secsizelist[uSectionIndex] * (GAIA::N64)ob.uFreeStackSize));
-						if(uOBIndex == hs.uMinFreeIndex)
-						{
-							hs.uMinFreeIndex = (GAIA::UM)GINVALID;
-							hs.uMinFreeSize = (GAIA::UM)GINVALID;
-						}
-						free(ob.freestack);
-						ob.freestack = GNIL;
-						ob.uFreeStackSize = 0;
-						ob.uFreeStackCapacity = 0;
-						free(ob.buf);
-						ob.buf = GNIL;
-						this->push(uOBIndex, hs.freestack, hs.uFreeStackSize, hs.uFreeStackCapacity);
-					}
-				}
-			#ifdef GAIA_HEAP_THREADSAFE
-				m_lr.Leave();
-			#endif
+
+				GAIA::UM uSectionIndex = header.uSectionIndex;
+				GAST(uSectionIndex < HEAP_SECTION_COUNT);
+				tc.stat.lSize -= (GAIA::N64)m_secsizelist[uSectionIndex];
+
+				FreeList& fl = tc.lists[uSectionIndex];
+				nextbuf(pOriginP) = fl.pHead;
+				fl.pHead = pOriginP;
+				++fl.uSize;
+				tc.uCachedSize += m_secsizelist[uSectionIndex];
+
+				const Section& hs = m_seclist[uSectionIndex];
+				if(fl.uSize > hs.uBatchCount * 2)
+					this->ReleaseBatch(tc, uSectionIndex, hs.uBatchCount);
+				else if(tc.uCachedSize > HEAP_THREADCACHE_SIZE)
+					this->ScavengeCache(tc);
 			}
 			GINL virtual GAIA::UM memory_size(GAIA::GVOID* p)
 			{
-				return *GRCAST(GAIA::UM*)(GSCAST(GAIA::U8*)(p) - sizeof(GAIA::UM) - sizeof(GAIA::U16));
+				return GRCAST(BufferHeader*)(GSCAST(GAIA::U8*)(p) - HEAP_BUFFER_HEADERSIZE)->uSize;
 			}
 			GINL virtual GAIA::UM capacity()
 			{
@@ -168,21 +107,44 @@ namespace GAIA
 			}
 			GINL virtual GAIA::UM size()
 			{
-				return (GAIA::UM)m_size;
+				Statistics stat;
+				this->SumStatistics(stat);
+				return (GAIA::UM)stat.lSize;
 			}
 			GINL virtual GAIA::UM use_size()
 			{
-				return (GAIA::UM)m_usesize;
+				Statistics stat;
+				this->SumStatistics(stat);
+				return (GAIA::UM)stat.lUseSize;
 			}
 			GINL virtual GAIA::UM piece_size()
 			{
-				return (GAIA::UM)m_piecesize;
+				Statistics stat;
+				this->SumStatistics(stat);
+				return (GAIA::UM)stat.lPieceSize;
 			}
 			GINL virtual GAIA::U64 alloc_times()
 			{
-				return m_alloctimes;
+				Statistics stat;
+				this->SumStatistics(stat);
+				return (GAIA::U64)stat.lAllocTimes;
 			}
 		private:
+			static const GAIA::UM HEAP_SECTION_COUNT = 100;
+			static const GAIA::UM HEAP_BUFFER_HEADERSIZE = 16; // BufferHeader is padded to 16 bytes, so the buffer returned is aligned as malloc.
+			static const GAIA::UM HEAP_BATCH_SIZE = 1024 * 16; // The bytes moved between thread cache and section by one batch.
+			static const GAIA::UM HEAP_BATCH_MINCOUNT = 2;
+			static const GAIA::UM HEAP_BATCH_MAXCOUNT = 32;
+			static const GAIA::UM HEAP_CENTRAL_SIZE = 1024 * 256; // The max bytes of each lock free central list.
+			static const GAIA::UM HEAP_THREADCACHE_SIZE = 1024 * 1024 * 2; // The max bytes cached by each thread.
+		private:
+			class BufferHeader
+			{
+			public:
+				GAIA::UM uSize; // The size of the buffer, it is the batch size when the buffer is the first of a batch in central list.
+				GAIA::U16 uOriginBufferIndex;
+				GAIA::U8 uSectionIndex;
+			};
 			class OriginBuffer
 			{
 			public:
@@ -190,6 +152,8 @@ namespace GAIA
 				GAIA::U8** freestack;
 				GAIA::UM uFreeStackSize;
 				GAIA::UM uFreeStackCapacity;
+				GAIA::UM uPrev; // The origin buffers which have free buffer are linked in partial list.
+				GAIA::UM uNext;
 			};
 			class Section
 			{
@@ -200,8 +164,45 @@ namespace GAIA
 				GAIA::U16* freestack;
 				GAIA::UM uFreeStackSize;
 				GAIA::UM uFreeStackCapacity;
-				GAIA::UM uMinFreeIndex;
-				GAIA::UM uMinFreeSize;
+				GAIA::UM uPartialHead;
+				GAIA::UM uPartialTail;
+				GAIA::UM uBatchCount;
+				GAIA::UM uCentralBatchLimit;
+				GAIA::U8* volatile pCentralTop; // Lock free stack of batches.
+				GAIA::SYNC::Atomic uCentralBatchCount;
+			};
+			class FreeList
+			{
+			public:
+				GAIA::U8* pHead;
+				GAIA::UM uSize;
+			};
+			class Statistics
+			{
+			public:
+				GINL GAIA::GVOID reset(){lSize = lUseSize = lPieceSize = lAllocTimes = 0;}
+				GINL GAIA::GVOID add(const Statistics& src)
+				{
+					lSize += src.lSize;
+					lUseSize += src.lUseSize;
+					lPieceSize += src.lPieceSize;
+					lAllocTimes += src.lAllocTimes;
+				}
+			public:
+				volatile GAIA::N64 lSize;
+				volatile GAIA::N64 lUseSize;
+				volatile GAIA::N64 lPieceSize;
+				volatile GAIA::N64 lAllocTimes;
+			};
+			class ThreadCache
+			{
+			public:
+				HeapESG* pHeap;
+				ThreadCache* pPrev;
+				ThreadCache* pNext;
+				GAIA::UM uCachedSize;
+				Statistics stat; // Written by the owner thread only.
+				FreeList lists[HEAP_SECTION_COUNT];
 			};
 		private:
 			GINL GAIA::GVOID init()
@@ -210,6 +211,8 @@ namespace GAIA
 				m_uSecListSize = 0;
 				m_secsizelist = GNIL;
 				m_uSecSizeListSize = 0;
+				m_pThreadCacheList = GNIL;
+				m_retired.reset();
 			}
 			GINL GAIA::UM GetSectionPatchSize(GAIA::UM uIndex) const{return 32 + 32 * uIndex * uIndex;}
 			GINL GAIA::UM GetSectionPatchCount(GAIA::UM uIndex) const{if(uIndex == 0) uIndex = 1; return 40000 / (uIndex * uIndex);}
@@ -244,7 +247,9 @@ namespace GAIA
 			GINL GAIA::GVOID InitHeap()
 			{
 				GAST(HEAP_SECTION_COUNT == 100);
+				GAST(sizeof(BufferHeader) <= HEAP_BUFFER_HEADERSIZE);
 			#ifdef GAIA_HEAP_THREADSAFE
+				m_tls.Create(OnThreadExit);
 				m_lr.Enter();
 			#endif
 				{
@@ -252,17 +257,26 @@ namespace GAIA
 					m_secsizelist = (GAIA::UM*)malloc(sizeof(GAIA::UM) * HEAP_SECTION_COUNT);
 					for(GAIA::UM x = 0; x < HEAP_SECTION_COUNT; ++x)
 					{
-						Section temp;
-						temp.oblist = GNIL;
-						temp.uObListSize = 0;
-						temp.uObListCapacity = 0;
-						temp.freestack = GNIL;
-						temp.uFreeStackSize = 0;
-						temp.uFreeStackCapacity = 0;
-						temp.uMinFreeIndex = (GAIA::UM)GINVALID;
-						temp.uMinFreeSize = (GAIA::UM)GINVALID;
-						m_seclist[x] = temp;
 						m_secsizelist[x] = this->GetSectionPatchSize(x);
+						Section& hs = m_seclist[x];
+						hs.oblist = GNIL;
+						hs.uObListSize = 0;
+						hs.uObListCapacity = 0;
+						hs.freestack = GNIL;
+						hs.uFreeStackSize = 0;
+						hs.uFreeStackCapacity = 0;
+						hs.uPartialHead = (GAIA::UM)GINVALID;
+						hs.uPartialTail = (GAIA::UM)GINVALID;
+						hs.uBatchCount = HEAP_BATCH_SIZE / m_secsizelist[x];
+						if(hs.uBatchCount < HEAP_BATCH_MINCOUNT)
+							hs.uBatchCount = HEAP_BATCH_MINCOUNT;
+						if(hs.uBatchCount > HEAP_BATCH_MAXCOUNT)
+							hs.uBatchCount = HEAP_BATCH_MAXCOUNT;
+						hs.uCentralBatchLimit = HEAP_CENTRAL_SIZE / (m_secsizelist[x] * hs.uBatchCount);
+						if(hs.uCentralBatchLimit == 0)
+							hs.uCentralBatchLimit = 1;
+						hs.pCentralTop = GNIL;
+						hs.uCentralBatchCount = 0;
 					}
 				}
 			#ifdef GAIA_HEAP_THREADSAFE
@@ -272,9 +286,17 @@ namespace GAIA
 			GINL GAIA::GVOID ReleaseHeap()
 			{
 			#ifdef GAIA_HEAP_THREADSAFE
+				m_tls.Destroy();
 				m_lr.Enter();
 			#endif
 				{
+					// The buffers in thread caches and central lists are owned by origin buffers, so free the caches only.
+					while(m_pThreadCacheList != GNIL)
+					{
+						ThreadCache* pNext = m_pThreadCacheList->pNext;
+						free(m_pThreadCacheList);
+						m_pThreadCacheList = pNext;
+					}
 					if(m_seclist != GNIL)
 					{
 						for(GAIA::UM x = 0; x < HEAP_SECTION_COUNT; ++x)
@@ -310,6 +332,305 @@ namespace GAIA
 				m_lr.Leave();
 			#endif
 			}
+			GINL ThreadCache& GetThreadCache()
+			{
+			#ifdef GAIA_HEAP_THREADSAFE
+				ThreadCache* pCache = GSCAST(ThreadCache*)(m_tls.Get());
+			#else
+				ThreadCache* pCache = m_pThreadCacheList;
+			#endif
+				if(pCache == GNIL)
+					pCache = this->NewThreadCache();
+				return *pCache;
+			}
+			GINL ThreadCache* NewThreadCache()
+			{
+				ThreadCache* pCache = (ThreadCache*)calloc(1, sizeof(ThreadCache));
+				pCache->pHeap = this;
+				pCache->pPrev = GNIL;
+			#ifdef GAIA_HEAP_THREADSAFE
+				m_lr.Enter();
+			#endif
+				{
+					pCache->pNext = m_pThreadCacheList;
+					if(m_pThreadCacheList != GNIL)
+						m_pThreadCacheList->pPrev = pCache;
+					m_pThreadCacheList = pCache;
+				}
+			#ifdef GAIA_HEAP_THREADSAFE
+				m_lr.Leave();
+				m_tls.Set(pCache);
+			#endif
+				return pCache;
+			}
+			GINL GAIA::GVOID DeleteThreadCache(ThreadCache* pCache)
+			{
+			#ifdef GAIA_HEAP_THREADSAFE
+				m_lr.Enter();
+			#endif
+				{
+					for(GAIA::UM x = 0; x < HEAP_SECTION_COUNT; ++x)
+					{
+						FreeList& fl = pCache->lists[x];
+						if(fl.pHead != GNIL)
+							this->ReturnToSection(x, fl.pHead);
+					}
+					m_retired.add(pCache->stat);
+					if(pCache->pPrev != GNIL)
+						pCache->pPrev->pNext = pCache->pNext;
+					else
+						m_pThreadCacheList = pCache->pNext;
+					if(pCache->pNext != GNIL)
+						pCache->pNext->pPrev = pCache->pPrev;
+				}
+			#ifdef GAIA_HEAP_THREADSAFE
+				m_lr.Leave();
+			#endif
+				free(pCache);
+			}
+		#ifdef GAIA_HEAP_THREADSAFE
+			static GAIA::GVOID GAIA_TLS_CALLBACK OnThreadExit(GAIA::GVOID* p)
+			{
+				if(p == GNIL)
+					return;
+				ThreadCache* pCache = GSCAST(ThreadCache*)(p);
+				pCache->pHeap->DeleteThreadCache(pCache);
+			}
+		#endif
+			GINL GAIA::GVOID SumStatistics(Statistics& stat)
+			{
+				stat.reset();
+			#ifdef GAIA_HEAP_THREADSAFE
+				m_lr.Enter();
+			#endif
+				{
+					stat.add(m_retired);
+					for(ThreadCache* pCache = m_pThreadCacheList; pCache != GNIL; pCache = pCache->pNext)
+						stat.add(pCache->stat);
+				}
+			#ifdef GAIA_HEAP_THREADSAFE
+				m_lr.Leave();
+			#endif
+			}
+			GINL GAIA::GVOID FetchBatch(ThreadCache& tc, GAIA::UM uSectionIndex)
+			{
+				Section& hs = m_seclist[uSectionIndex];
+				FreeList& fl = tc.lists[uSectionIndex];
+				GAST(fl.pHead == GNIL);
+				GAIA::U8* pBatch = this->PopCentralBatch(hs);
+				if(pBatch != GNIL)
+				{
+					fl.pHead = pBatch;
+					fl.uSize = GRCAST(BufferHeader*)(pBatch)->uSize;
+				}
+				else
+				{
+				#ifdef GAIA_HEAP_THREADSAFE
+					m_lr.Enter();
+				#endif
+					fl.uSize = this->FetchFromSection(uSectionIndex, fl.pHead, hs.uBatchCount);
+				#ifdef GAIA_HEAP_THREADSAFE
+					m_lr.Leave();
+				#endif
+				}
+				tc.uCachedSize += fl.uSize * m_secsizelist[uSectionIndex];
+			}
+			GINL GAIA::GVOID ReleaseBatch(ThreadCache& tc, GAIA::UM uSectionIndex, GAIA::UM uCount)
+			{
+				FreeList& fl = tc.lists[uSectionIndex];
+				if(uCount > fl.uSize)
+					uCount = fl.uSize;
+				if(uCount == 0)
+					return;
+				GAIA::U8* pFirst = fl.pHead;
+				GAIA::U8* pLast = pFirst;
+				for(GAIA::UM x = 1; x < uCount; ++x)
+					pLast = nextbuf(pLast);
+				fl.pHead = nextbuf(pLast);
+				fl.uSize -= uCount;
+				nextbuf(pLast) = GNIL;
+				tc.uCachedSize -= uCount * m_secsizelist[uSectionIndex];
+
+				Section& hs = m_seclist[uSectionIndex];
+				if((GAIA::UM)(GAIA::N64)hs.uCentralBatchCount < hs.uCentralBatchLimit)
+				{
+					hs.uCentralBatchCount.Increase();
+					GRCAST(BufferHeader*)(pFirst)->uSize = uCount;
+					this->PushCentralBatch(hs, pFirst, pFirst);
+				}
+				else
+				{
+				#ifdef GAIA_HEAP_THREADSAFE
+					m_lr.Enter();
+				#endif
+					this->ReturnToSection(uSectionIndex, pFirst);
+				#ifdef GAIA_HEAP_THREADSAFE
+					m_lr.Leave();
+				#endif
+				}
+			}
+			GINL GAIA::GVOID ScavengeCache(ThreadCache& tc)
+			{
+				for(GAIA::UM x = 0; x < HEAP_SECTION_COUNT; ++x)
+				{
+					FreeList& fl = tc.lists[x];
+					if(fl.uSize != 0)
+						this->ReleaseBatch(tc, x, (fl.uSize + 1) / 2);
+				}
+			}
+			GINL GAIA::GVOID PushCentralBatch(Section& hs, GAIA::U8* pFirst, GAIA::U8* pLast)
+			{
+				// Push is not affected by ABA, because it depends on the value of the top only.
+				for(;;)
+				{
+					GAIA::U8* pTop = hs.pCentralTop;
+					nextbatch(pLast) = pTop;
+					if(cas(&hs.pCentralTop, pTop, pFirst))
+						break;
+				}
+			}
+			GINL GAIA::U8* PopCentralBatch(Section& hs)
+			{
+				// Take the whole stack, so the next link is read after the batch is owned, and it is not affected by ABA.
+				GAIA::U8* pTop;
+				for(;;)
+				{
+					pTop = hs.pCentralTop;
+					if(pTop == GNIL)
+						return GNIL;
+					if(cas(&hs.pCentralTop, pTop, GNIL))
+						break;
+				}
+				hs.uCentralBatchCount.Decrease();
+
+				// Give the other batches back.
+				GAIA::U8* pRest = nextbatch(pTop);
+				if(pRest != GNIL)
+				{
+					GAIA::U8* pLast = pRest;
+					while(nextbatch(pLast) != GNIL)
+						pLast = nextbatch(pLast);
+					this->PushCentralBatch(hs, pRest, pLast);
+				}
+				return pTop;
+			}
+			GINL GAIA::UM FetchFromSection(GAIA::UM uSectionIndex, GAIA::U8*& pHead, GAIA::UM uCount)
+			{
+				Section& hs = m_seclist[uSectionIndex];
+				GAIA::UM uRet = 0;
+				while(uRet < uCount)
+				{
+					if(hs.uPartialHead == (GAIA::UM)GINVALID)
+					{
+						if(uRet != 0)
+							break;
+						this->NewOriginBuffer(uSectionIndex);
+					}
+					GAIA::UM uOBIndex = hs.uPartialHead;
+					OriginBuffer& ob = hs.oblist[uOBIndex];
+					while(uRet < uCount && ob.uFreeStackSize != 0)
+					{
+						GAIA::U8* pBuf = ob.freestack[--ob.uFreeStackSize];
+						nextbuf(pBuf) = pHead;
+						pHead = pBuf;
+						++uRet;
+					}
+					if(ob.uFreeStackSize == 0)
+						this->UnlinkPartial(hs, uOBIndex);
+				}
+				return uRet;
+			}
+			GINL GAIA::GVOID ReturnToSection(GAIA::UM uSectionIndex, GAIA::U8* pList)
+			{
+				Section& hs = m_seclist[uSectionIndex];
+				GAIA::UM uSectionPatchCount = this->GetSectionPatchCount(uSectionIndex);
+				while(pList != GNIL)
+				{
+					GAIA::U8* pBuf = pList;
+					pList = nextbuf(pList);
+					GAIA::UM uOBIndex = GRCAST(BufferHeader*)(pBuf)->uOriginBufferIndex;
+					OriginBuffer& ob = hs.oblist[uOBIndex];
+					if(ob.uFreeStackSize == 0)
+						this->LinkPartial(hs, uOBIndex);
+					this->push(pBuf, ob.freestack, ob.uFreeStackSize, ob.uFreeStackCapacity);
+					if(ob.uFreeStackSize == uSectionPatchCount)
+					{
+						this->UnlinkPartial(hs, uOBIndex);
+						m_capacity.Add(-((GAIA::N64)m_secsizelist[uSectionIndex] * (GAIA::N64)uSectionPatchCount));
+						free(ob.freestack);
+						ob.freestack = GNIL;
+						ob.uFreeStackSize = 0;
+						ob.uFreeStackCapacity = 0;
+						free(ob.buf);
+						ob.buf = GNIL;
+						this->push((GAIA::U16)uOBIndex, hs.freestack, hs.uFreeStackSize, hs.uFreeStackCapacity);
+					}
+				}
+			}
+			GINL GAIA::GVOID NewOriginBuffer(GAIA::UM uSectionIndex)
+			{
+				Section& hs = m_seclist[uSectionIndex];
+				GAIA::U16 uOriginBufferIndex;
+				if(hs.uFreeStackSize == 0)
+				{
+					GAST(hs.uObListSize < (GAIA::U16)GINVALID);
+					OriginBuffer newob;
+					newob.buf = GNIL;
+					newob.freestack = GNIL;
+					newob.uFreeStackSize = 0;
+					newob.uFreeStackCapacity = 0;
+					newob.uPrev = (GAIA::UM)GINVALID;
+					newob.uNext = (GAIA::UM)GINVALID;
+					uOriginBufferIndex = (GAIA::U16)hs.uObListSize;
+					this->push(newob, hs.oblist, hs.uObListSize, hs.uObListCapacity);
+				}
+				else
+				{
+					uOriginBufferIndex = hs.freestack[hs.uFreeStackSize - 1];
+					--hs.uFreeStackSize;
+				}
+				OriginBuffer& newobref = hs.oblist[uOriginBufferIndex];
+				GAIA::UM uSectionPatchCount = this->GetSectionPatchCount(uSectionIndex);
+				GAIA::UM uSectionPatchSize = m_secsizelist[uSectionIndex];
+				newobref.buf = (GAIA::U8*)malloc(uSectionPatchSize * uSectionPatchCount);
+				m_capacity.Add(uSectionPatchSize * uSectionPatchCount);
+				for(GAIA::UM x = 0; x < uSectionPatchCount; ++x)
+				{
+					GAIA::U8* pTemp = (GAIA::U8*)newobref.buf + uSectionPatchSize * x;
+					BufferHeader& header = *GRCAST(BufferHeader*)(pTemp);
+					header.uSize = uSectionPatchSize;
+					header.uOriginBufferIndex = uOriginBufferIndex;
+					header.uSectionIndex = (GAIA::U8)uSectionIndex;
+					this->push(pTemp, newobref.freestack, newobref.uFreeStackSize, newobref.uFreeStackCapacity);
+				}
+				this->LinkPartial(hs, uOriginBufferIndex);
+			}
+			GINL GAIA::GVOID LinkPartial(Section& hs, GAIA::UM uOBIndex)
+			{
+				// Link to tail, so the head which is used for allocating is drained first, and the tail has more time to be free.
+				OriginBuffer& ob = hs.oblist[uOBIndex];
+				ob.uPrev = hs.uPartialTail;
+				ob.uNext = (GAIA::UM)GINVALID;
+				if(hs.uPartialTail != (GAIA::UM)GINVALID)
+					hs.oblist[hs.uPartialTail].uNext = uOBIndex;
+				else
+					hs.uPartialHead = uOBIndex;
+				hs.uPartialTail = uOBIndex;
+			}
+			GINL GAIA::GVOID UnlinkPartial(Section& hs, GAIA::UM uOBIndex)
+			{
+				OriginBuffer& ob = hs.oblist[uOBIndex];
+				if(ob.uPrev != (GAIA::UM)GINVALID)
+					hs.oblist[ob.uPrev].uNext = ob.uNext;
+				else
+					hs.uPartialHead = ob.uNext;
+				if(ob.uNext != (GAIA::UM)GINVALID)
+					hs.oblist[ob.uNext].uPrev = ob.uPrev;
+				else
+					hs.uPartialTail = ob.uPrev;
+				ob.uPrev = (GAIA::UM)GINVALID;
+				ob.uNext = (GAIA::UM)GINVALID;
+			}
 			template<typename _DataType> GAIA::GVOID push(const _DataType& t, _DataType*& p, GAIA::UM& uSize, GAIA::UM& uCapacity)
 			{
 				if(uSize == uCapacity)
@@ -328,20 +649,28 @@ namespace GAIA
 				GAST(uSize < uCapacity);
 				p[uSize++] = t;
 			}
-		private:
-			static const GAIA::UM HEAP_SECTION_COUNT = 100;
-			static const GAIA::UM HEAP_BUFFER_HEADERSIZE = sizeof(GAIA::UM) + sizeof(GAIA::U16); // First is the buffer's size, second is the origin buffer index.
+			static GINL GAIA::U8*& nextbuf(GAIA::U8* p){return *GRCAST(GAIA::U8**)(p + HEAP_BUFFER_HEADERSIZE);}
+			static GINL GAIA::U8*& nextbatch(GAIA::U8* p){return *GRCAST(GAIA::U8**)(p + HEAP_BUFFER_HEADERSIZE + sizeof(GAIA::U8*));}
+			static GINL GAIA::BL cas(GAIA::U8* volatile* p, GAIA::U8* oldvalue, GAIA::U8* newvalue)
+			{
+			#if GAIA_OS == GAIA_OS_WINDOWS
+				return InterlockedCompareExchangePointer((PVOID volatile*)p, newvalue, oldvalue) == oldvalue;
+			#elif GAIA_OS == GAIA_OS_OSX || GAIA_OS == GAIA_OS_IOS
+				return OSAtomicCompareAndSwapPtrBarrier(oldvalue, newvalue, (GAIA::GVOID* volatile*)p);
+			#else
+				return __sync_bool_compare_and_swap(p, oldvalue, newvalue);
+			#endif
+			}
 		private:
 			Section* m_seclist;
 			GAIA::UM m_uSecListSize;
 			GAIA::UM* m_secsizelist;
 			GAIA::UM m_uSecSizeListSize;
 			GAIA::SYNC::Atomic m_capacity;
-			GAIA::SYNC::Atomic m_size;
-			GAIA::SYNC::Atomic m_usesize;
-			GAIA::SYNC::Atomic m_piecesize;
-			GAIA::SYNC::Atomic m_alloctimes;
+			ThreadCache* m_pThreadCacheList;
+			Statistics m_retired; // The statistics of the exited threads.
 		#ifdef GAIA_HEAP_THREADSAFE
+			GAIA::SYNC::TlsSlot m_tls;
 			GAIA::SYNC::Lock m_lr;
 		#endif
 		};
@@ -3,6 +3,7 @@
 
 #include "gaia_type.h"
 #include "gaia_assert.h"
+#include "gaia_algo_hash.h"
 #include "gaia_network_ip.h"
 
 namespace GAIA
@@ -52,6 +53,7 @@ namespace GAIA
 				return 0;
 			}
 			GCLASS_COMPARE_BYCOMPARE(GAIA::NETWORK::Addr)
+			GINL GAIA::U64 hash() const{return GAIA::ALGO::hash_int(((GAIA::U64)ip.u << 16) | uPort);}
 		public:
 			GAIA::NETWORK::IP ip;
 			GAIA::U16 uPort;
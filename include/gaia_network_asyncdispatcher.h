@@ -3,10 +3,15 @@
 
 #include "gaia_type.h"
 #include "gaia_assert.h"
+#include "gaia_sync_lock.h"
+#include "gaia_sync_autolock.h"
+#include "gaia_sync_event.h"
 #include "gaia_sync_lockrw.h"
 #include "gaia_sync_autolockr.h"
 #include "gaia_sync_autolockw.h"
 #include "gaia_ctn_set.h"
+#include "gaia_ctn_vector.h"
+#include "gaia_thread.h"
 #include "gaia_network_asyncsocket.h"
 
 namespace GAIA
@@ -16,28 +21,94 @@ namespace GAIA
 		/*!
 			@brief Used for dispatch AsyncSocket.
 
+			@remarks
+				The dispatcher wait the socket events by some dispatch threads.
+				In linux, the sockets are registered to a epoll in edge triggered and one shot mode,
+				every dispatch thread wait on the same epoll, read and write the ready sockets until they would block.
+				A fetched socket is disabled until the dispatch thread arm it again after the callbacks,
+				so a socket is never dispatched by two threads at the same time, and it could be closed in it's own callbacks.
+				The writable event is watched only when the socket is connecting or there is data queued,
+				so the idle sockets will not wake up the dispatch threads.
+
 			@see GAIA::NETWORK::AsyncSocket
 		*/
 		class AsyncDispatcher : public GAIA::Base
 		{
+			friend class AsyncSocket;
+
 		public:
 			/*!
-				@brief 
+				@brief Default dispatch thread count.
+			*/
+			static const GAIA::NUM DEFAULT_THREAD_COUNT = 2;
+
+			/*!
+				@brief The receive buffer size of each dispatch thread in bytes.
+			*/
+			static const GAIA::NUM DISPATCH_BUFFER_SIZE = 1024 * 64;
+
+			/*!
+				@brief The max event count each dispatch thread wait at one time.
+			*/
+			static const GAIA::NUM DISPATCH_EVENT_COUNT = 128;
+
+			/*!
+				@brief Used for collect sockets.
 			*/
 			class CallBack : public GAIA::Base
 			{
 			public:
+				/*!
+					@brief Collect socket callback.
+
+					@return If want to stop collect, return GAIA::False, or return GAIA::True.
+				*/
 				virtual GAIA::BL OnCollect(GAIA::NETWORK::AsyncDispatcher& disp, GAIA::NETWORK::AsyncSocket& sock) = 0;
 			};
 		public:
 			AsyncDispatcher();
 			~AsyncDispatcher();
 
+			/*!
+				@brief Set dispatch thread count.
+
+				@return If the dispatcher is begin or sThreadCount is invalid, return GAIA::False, or return GAIA::True.
+			*/
+			GAIA::BL SetThreadCount(GAIA::NUM sThreadCount);
+
+			/*!
+				@brief Get dispatch thread count.
+			*/
+			GAIA::NUM GetThreadCount() const;
+
+			/*!
+				@brief Create the OS async controller and start the dispatch threads.
+			*/
 			GAIA::BL Begin();
+
+			/*!
+				@brief Remove all sockets, stop the dispatch threads and close the OS async controller.
+
+				@remarks
+					This function can't be called in dispatch thread(the callbacks of async socket).
+			*/
 			GAIA::BL End();
 			GAIA::BL IsBegin() const;
 
+			/*!
+				@brief Add a created async socket to dispatcher.
+
+				@return If the dispatcher is not begin, or the socket is dispatched already, return GAIA::False.
+			*/
 			GAIA::BL AddAsyncSocket(GAIA::NETWORK::AsyncSocket& sock);
+
+			/*!
+				@brief Remove a async socket from dispatcher.
+
+				@remarks
+					When this function return, the socket is not in dispatching by other threads,
+					so it could be deleted safely.
+			*/
 			GAIA::BL RemoveAsyncSocket(GAIA::NETWORK::AsyncSocket& sock);
 			GAIA::BL RemoveAsyncSocketAll();
 			GAIA::BL IsExistAsyncSocket(GAIA::NETWORK::AsyncSocket& sock) const;
@@ -51,13 +122,9 @@ namespace GAIA
 				GINL GAIA::GVOID reset()
 				{
 					pSock = GNIL;
-					sIndex = GINVALID;
 				}
 				GINL GAIA::N32 compare(const Node& src) const
 				{
-					GAIA::N32 nCmp = addrLocal.compare(src.addrLocal);
-					if(nCmp != 0)
-						return nCmp;
 					if(pSock < src.pSock)
 						return -1;
 					else if(pSock > src.pSock)
@@ -66,17 +133,45 @@ namespace GAIA
 				}
 				GCLASS_COMPARE_BYCOMPARE(Node)
 			public:
-				GAIA::NETWORK::Addr addrLocal;
 				GAIA::NETWORK::AsyncSocket* pSock;
-				GAIA::NUM sIndex;
+			};
+
+			class DispatchThread : public GAIA::THREAD::Thread
+			{
+			public:
+				GINL DispatchThread(AsyncDispatcher& disp) : m_disp(disp)
+				{
+					m_uThreadID = 0;
+					m_pDispatching = GNIL;
+					m_sWaitCount = 0;
+				}
+				virtual GAIA::GVOID Run()
+				{
+					m_uThreadID = GAIA::THREAD::threadid();
+					m_disp.Execute(*this);
+				}
+			public:
+				AsyncDispatcher& m_disp;
+				volatile GAIA::UM m_uThreadID;
+				GAIA::SYNC::Lock m_lrDispatching;
+				GAIA::NETWORK::AsyncSocket* m_pDispatching; // Guarded by m_lrDispatching.
+				GAIA::NUM m_sWaitCount; // The count of the threads waiting for m_pDispatching, guarded by m_lrDispatching.
+				GAIA::SYNC::Event m_evtDispatched;
+				GAIA::U8 m_buf[DISPATCH_BUFFER_SIZE];
 			};
 
 		private:
 			GAIA::GVOID init();
+			GAIA::GVOID Execute(DispatchThread& th);
+			GAIA::BL WatchAsyncSocket(GAIA::NETWORK::AsyncSocket& sock, GAIA::BL bAdd);
+			GAIA::GVOID WaitDispatching(GAIA::NETWORK::AsyncSocket* pSock);
 
 		private:
 			GAIA::SYNC::LockRW m_rwSockets;
-			GAIA::CTN::Set<Node> m_nodes_byaddrptr;
+			GAIA::CTN::Set<Node> m_nodes_byptr;
+			GAIA::CTN::Vector<DispatchThread*> m_threads;
+			GAIA::NUM m_sThreadCount;
+			volatile GAIA::BL m_bStopCmd;
 
 		#if GAIA_OS == GAIA_OS_WINDOWS
 
@@ -84,6 +179,7 @@ namespace GAIA
 			GAIA::N32 m_kqueue;
 		#elif GAIA_OS == GAIA_OS_LINUX || GAIA_OS == GAIA_OS_ANDROID
 			GAIA::N32 m_epoll;
+			GAIA::N32 m_wakepipe[2];
 		#endif
 		};
 	}
@@ -3,6 +3,9 @@
 
 #include "gaia_type.h"
 #include "gaia_assert.h"
+#include "gaia_sync_lock.h"
+#include "gaia_sync_autolock.h"
+#include "gaia_ctn_queue.h"
 #include "gaia_network_ip.h"
 #include "gaia_network_addr.h"
 #include "gaia_network_base.h"
@@ -12,15 +15,66 @@ namespace GAIA
 {
 	namespace NETWORK
 	{
+		class AsyncDispatcher;
+
 		/*!
 			@brief Async socket.
 
 				This async socket class support stream socket only(TCP).
+
+			@remarks
+				After the socket added to a GAIA::NETWORK::AsyncDispatcher, all the callbacks will be called in the dispatch threads.
+				Callbacks of the same socket could be called by different dispatch threads, but never at the same time,
+				so the socket could be closed in it's own callbacks.
+				The socket must be closed or removed from the dispatcher before the derived class destructed.
 		*/
 		class AsyncSocket : public GAIA::Base
 		{
 			friend class AsyncDispatcher;
 
+		public:
+
+			/*!
+				@brief The max slice count written by one system call.
+			*/
+			static const GAIA::NUM MAX_SLICE_BATCH = 64;
+
+			/*!
+				@brief The max bytes sent by one sendfile call.
+			*/
+			static const GAIA::NUM SENDFILE_BLOCK_SIZE = 1024 * 1024;
+
+			/*!
+				@brief Used for release the slice sent by SendV.
+			*/
+			class SendCallBack : public GAIA::Base
+			{
+			public:
+				/*!
+					@brief Called when the slice is not used by the socket anymore.
+
+					@param pData [in] The data of the slice.
+
+					@param sSize [in] The size of the slice in bytes.
+
+					@remarks
+						This function is called after the slice sent, or discarded because of error or close.
+						It maybe called in the lock of the socket, so it should not block.
+				*/
+				virtual GAIA::GVOID OnRelease(const GAIA::GVOID* pData, GAIA::NUM sSize) = 0;
+			};
+
+			/*!
+				@brief A piece of data to send.
+			*/
+			class Slice : public GAIA::Base
+			{
+			public:
+				const GAIA::GVOID* pData;
+				GAIA::NUM sSize;
+				SendCallBack* pCallBack; // If it is GNIL, the slice will be copied when it need to be queued.
+			};
+
 		public:
 
 			/*!
@@ -34,7 +88,7 @@ namespace GAIA
 				@remarks
 					If current async socket is created, it will be close automatically.
 			*/
-			~AsyncSocket();
+			virtual ~AsyncSocket();
 
 			/*!
 				@brief Create async socket.
@@ -43,7 +97,7 @@ namespace GAIA
 					GAIA::ECT::EctIllegal If async socket is created.
 
 				@remarks
-					This function is async call.
+					The socket is created in not block mode.
 			*/
 			GAIA::GVOID Create();
 
@@ -51,23 +105,23 @@ namespace GAIA
 				@brief Close async socket.
 
 				@remarks
-					This function is async call.
+					If the socket is dispatched by a GAIA::NETWORK::AsyncDispatcher, it will be removed from the dispatcher first.
+					All the data in send queue will be discarded.
 			*/
 			GAIA::GVOID Close();
 
 			/*!
-				@brief Shutdown current async socket.
+				@brief Check the socket is created or not.
+			*/
+			GAIA::BL IsCreated() const;
 
-				@remarks
-					This function is async call.
+			/*!
+				@brief Shutdown current async socket.
 			*/
 			GAIA::GVOID Shutdown(GAIA::N32 nShutdownFlag = GAIA::NETWORK::Socket::SSDF_RECV | GAIA::NETWORK::Socket::SSDF_SEND);
 
 			/*!
 				@brief Bind async socket to a network address, include IP and port.
-
-				@remarks
-					This function is async call.
 			*/
 			GAIA::GVOID Bind(const GAIA::NETWORK::Addr& addr);
 
@@ -78,19 +132,31 @@ namespace GAIA
 			*/
 			GAIA::BL IsBind() const;
 
+			/*!
+				@brief Listen on the bound address.
+
+				@remarks
+					When a connection come, the dispatcher will call OnAccepting to get a socket for it,
+					and the new socket will be added to the same dispatcher.
+			*/
+			GAIA::GVOID Listen();
+
+			/*!
+				@brief Check the socket is listening or not.
+			*/
+			GAIA::BL IsListen() const;
+
 			/*!
 				@brief Connect async socket to a network address, include IP and port.
 
 				@remarks
-					This function is async call.
+					This function is async call, OnConnected will be called when the connection established,
+					and OnError will be called when the connection failed.
 			*/
 			GAIA::GVOID Connect(const GAIA::NETWORK::Addr& addr);
 
 			/*!
 				@brief Disconnect from a network address.
-
-				@remarks
-					This function is async call.
 			*/
 			GAIA::GVOID Disconnect();
 
@@ -102,27 +168,81 @@ namespace GAIA
 			/*!
 				@brief Send data to peer.
 
+				@param pData [in] Specify the data to send.
+
+				@param sSize [in] Specify the data size in bytes.
+
 				@remarks
 					This function is async call.
+					The data will be written to the socket directly when the send queue is empty,
+					the data not written will be copied to the send queue and flushed when the socket writable.
+					OnSent will be called when the whole data is written.
 			*/
 			GAIA::GVOID Send(const GAIA::GVOID* pData, GAIA::NUM sSize);
 
 			/*!
-				@brief Recv data from peer.
+				@brief Send some slices to peer by one gather write.
+
+				@param pSlices [in] Specify the slices.
+
+				@param sCount [in] Specify the slice count.
 
 				@remarks
 					This function is async call.
+					The slices are written by writev like system call without copy.
+					The slice which has a callback is owned by the socket until SendCallBack::OnRelease called,
+					the slice without callback is copied if it can't be written at once.
+					OnSent will be called for each slice written completely.
 			*/
-			GAIA::GVOID Recv(GAIA::GVOID* pData, GAIA::NUM sSize);
+			GAIA::GVOID SendV(const Slice* pSlices, GAIA::NUM sCount);
+
+			/*!
+				@brief Send a range of file to peer.
+
+				@param nFile [in] Specify the file descriptor, it must be readable and seekable.
+
+				@param lOffset [in] Specify the offset of the range in file.
+
+				@param lSize [in] Specify the size of the range in bytes.
+
+				@remarks
+					This function is async call, the file is sent by sendfile in linux without copy to user space.
+					The file descriptor must keep opened until OnSentFile called, or the socket closed.
+			*/
+			GAIA::GVOID SendFile(GAIA::N32 nFile, const GAIA::N64& lOffset, const GAIA::N64& lSize);
+
+			/*!
+				@brief Recv data from peer directly.
+
+				@return Return the size of received data in bytes, return 0 if there is no data now.
+
+				@remarks
+					This function is used for the socket not dispatched,
+					the data of the dispatched socket will be received by OnRecved.
+			*/
+			GAIA::NUM Recv(GAIA::GVOID* pData, GAIA::NUM sSize);
 
 			/*!
 				@brief Flush send buffer.
 
 				@remarks
-					This function is async call.
+					This function write the send queue until it is empty or the socket is not writable.
+					OnFlushed will be called when the send queue become empty.
 			*/
 			GAIA::GVOID Flush();
 
+			/*!
+				@brief Get the size of data in send queue in bytes.
+			*/
+			GAIA::NUM GetSendingSize() const;
+
+			/*!
+				@brief Get the dispatcher which current socket added to.
+
+				@return If the socket is not dispatched, return GNIL.
+			*/
+			GAIA::NETWORK::AsyncDispatcher* GetDispatcher() const{return m_pDispatcher;}
+
 			/*!
 				@brief Get socket file descriptor.
 			*/
@@ -161,6 +281,22 @@ namespace GAIA
 			*/
 			virtual GAIA::GVOID OnBound(const GAIA::NETWORK::Addr& addr){}
 
+			/*!
+				@brief On listen socket accepting a connection callback.
+
+				@param addr [in] Specify the address of the peer.
+
+				@return Return a not created async socket to hold the connection, return GNIL to refuse it.
+			*/
+			virtual GAIA::NETWORK::AsyncSocket* OnAccepting(const GAIA::NETWORK::Addr& addr){return GNIL;}
+
+			/*!
+				@brief On listen socket accepted a connection callback.
+
+				@param sock [in] The socket returned by OnAccepting, it is connected and dispatched.
+			*/
+			virtual GAIA::GVOID OnAccepted(GAIA::NETWORK::AsyncSocket& sock){}
+
 			/*!
 				@brief On async socket connected callback.
 			*/
@@ -176,6 +312,11 @@ namespace GAIA
 			*/
 			virtual GAIA::GVOID OnSent(const GAIA::GVOID* pData, GAIA::NUM sSize){}
 
+			/*!
+				@brief On async socket sent a file range callback.
+			*/
+			virtual GAIA::GVOID OnSentFile(GAIA::N32 nFile, const GAIA::N64& lOffset, const GAIA::N64& lSize){}
+
 			/*!
 				@brief On async socket recv callback.
 			*/
@@ -196,11 +337,54 @@ namespace GAIA
 			*/
 			virtual GAIA::GVOID OnError(){}
 
+		private:
+			class SendNode : public GAIA::Base
+			{
+			public:
+				GINL GAIA::GVOID init()
+				{
+					p = GNIL;
+					pCallBack = GNIL;
+					nFile = GINVALID;
+					lFileOffset = 0;
+					lSize = 0;
+					lOffset = 0;
+				}
+			public:
+				const GAIA::U8* p;
+				SendCallBack* pCallBack;
+				GAIA::N32 nFile;
+				GAIA::N64 lFileOffset;
+				GAIA::N64 lSize;
+				GAIA::N64 lOffset;
+			};
+			typedef GAIA::CTN::Queue<SendNode> __SendQueueType;
+
 		private:
 			GAIA::GVOID init();
+			GAIA::GVOID ClearSendQueue();
+			GAIA::GVOID ReleaseSendNode(SendNode& n);
+			GAIA::NUM SendRawV(const Slice* pSlices, GAIA::NUM sCount);
+			GAIA::N64 SendRawFile(GAIA::N32 nFile, const GAIA::N64& lOffset, const GAIA::N64& lSize);
+			GAIA::BL FlushSendQueue();
+			GAIA::GVOID DispatchAccept();
+			GAIA::GVOID DispatchRead(GAIA::U8* pBuf, GAIA::NUM sBufSize);
+			GAIA::GVOID DispatchWrite();
+			GAIA::GVOID WatchWrite();
 
 		private:
 			GAIA::NETWORK::Socket m_sock;
+			GAIA::NETWORK::AsyncDispatcher* m_pDispatcher;
+			GAIA::NETWORK::Addr m_addrPeer;
+			GAIA::SYNC::Lock m_lrSend;
+			GAIA::SYNC::Lock m_lrRecv;
+			__SendQueueType m_sendqueue;
+			GAIA::NUM m_sSendingSize;
+			volatile GAIA::BL m_bListen;
+			volatile GAIA::BL m_bConnecting;
+			volatile GAIA::BL m_bConnected;
+			GAIA::BL m_bDispatching; // Fetched by a dispatch thread and not armed again, guarded by m_lrSend.
+			GAIA::U32 m_uPendingEvents; // The events fetched by other thread while dispatching, guarded by m_lrSend.
 		};
 	}
 }
@@ -0,0 +1,383 @@
+﻿#ifndef		__GAIA_NETWORK_CONGESTION_H__
+#define		__GAIA_NETWORK_CONGESTION_H__
+
+#include "gaia_type.h"
+#include "gaia_assert.h"
+#include "gaia_network_base.h"
+
+namespace GAIA
+{
+	namespace NETWORK
+	{
+		/*!
+			@brief Congestion controller of a reliable datagram flow to one peer.
+
+			@remarks
+				All the sizes are in bytes, all the times are in microseconds.\n
+				The owner of the flow report the acknowledged, lost and timeout events, and ask the controller
+				how many bytes could be in flight(the congestion window) and how long to wait between two datagrams(pacing).\n
+				Derive from this class to plug a custom congestion control algorithm, see SUDPSocket::OnCreateCongestionControl.\n
+		*/
+		class CongestionControl : public GAIA::Base
+		{
+		public:
+			static const GAIA::U64 DEFAULT_MSS = GAIA::NETWORK::GAIA_NETWORK_MTU;
+			static const GAIA::U64 INVALID_RTT = GAIA::U64MAX;
+
+		public:
+			GINL CongestionControl(){m_uMSS = DEFAULT_MSS;}
+			virtual ~CongestionControl(){}
+
+			/*!
+				@brief Set the max segment size, the unit of the window.
+
+				@param uMSS [in] Specify the max segment size in bytes, if zero, reset to DEFAULT_MSS.
+			*/
+			GINL GAIA::GVOID SetMSS(GAIA::U64 uMSS){m_uMSS = uMSS == 0 ? DEFAULT_MSS : uMSS;}
+
+			/*!
+				@brief Get the max segment size.
+			*/
+			GINL GAIA::U64 GetMSS() const{return m_uMSS;}
+
+			/*!
+				@brief Some datagrams are acknowledged.
+
+				@param uInflightSize [in] Specify the bytes still in flight after the acknowledged datagrams removed.
+
+				@param uAckedSize [in] Specify the bytes acknowledged.
+
+				@param uRTT [in] Specify a round trip time sample, INVALID_RTT means there is not a valid sample(Karn's algorithm).
+
+				@param uCurrentTime [in] Specify the current time.
+			*/
+			virtual GAIA::GVOID OnAck(GAIA::U64 uInflightSize, GAIA::U64 uAckedSize, GAIA::U64 uRTT, const GAIA::U64& uCurrentTime) = 0;
+
+			/*!
+				@brief Some datagrams are detected lost by the selective acknowledgement, they will be resent.
+
+				@param uInflightSize [in] Specify the bytes in flight, include the lost bytes.
+
+				@param uLostSize [in] Specify the bytes detected lost.
+
+				@param uCurrentTime [in] Specify the current time.
+			*/
+			virtual GAIA::GVOID OnLoss(GAIA::U64 uInflightSize, GAIA::U64 uLostSize, const GAIA::U64& uCurrentTime) = 0;
+
+			/*!
+				@brief The retransmission timer expired, nothing is acknowledged for a whole retransmission timeout.
+
+				@param uInflightSize [in] Specify the bytes in flight.
+
+				@param uCurrentTime [in] Specify the current time.
+			*/
+			virtual GAIA::GVOID OnTimeout(GAIA::U64 uInflightSize, const GAIA::U64& uCurrentTime) = 0;
+
+			/*!
+				@brief Get the congestion window, the max bytes could be in flight.
+			*/
+			virtual GAIA::U64 GetWindow() const = 0;
+
+			/*!
+				@brief Get the pacing interval.
+
+				@param nSize [in] Specify the size of the datagram will be sent.
+
+				@return Return the time should be waited after the datagram sent, zero means not paced.
+			*/
+			virtual GAIA::U64 GetPacingInterval(GAIA::N32 nSize) const = 0;
+
+		protected:
+			GAIA::U64 m_uMSS;
+		};
+
+		/*!
+			@brief NewReno congestion control(RFC 5681 and RFC 6582).
+
+			@remarks
+				Slow start from 10 segments(RFC 6928), the window is halved once per loss recovery(one round trip),
+				and collapse to one segment when the retransmission timer expired.\n
+				The datagrams are paced at 2 times(slow start) or 1.2 times(congestion avoidance) of window / srtt.\n
+		*/
+		class CongestionControlNewReno : public GAIA::NETWORK::CongestionControl
+		{
+		public:
+			static const GAIA::U64 INITIAL_WINDOW_SEGMENTS = 10;
+
+		public:
+			GINL CongestionControlNewReno(){this->init();}
+			virtual GAIA::GVOID OnAck(GAIA::U64 uInflightSize, GAIA::U64 uAckedSize, GAIA::U64 uRTT, const GAIA::U64& uCurrentTime)
+			{
+				if(uRTT != INVALID_RTT)
+				{
+					if(m_bRTTValid)
+						m_uSRTT = (m_uSRTT * 7 + uRTT) / 8;
+					else
+					{
+						m_uSRTT = uRTT;
+						m_bRTTValid = GAIA::True;
+					}
+				}
+				if(uCurrentTime < m_uRecoveryEndTime)
+					return;
+				if(m_uWindow < m_uSSThresh)
+					m_uWindow += uAckedSize;
+				else
+				{
+					m_uAckedSize += uAckedSize;
+					if(m_uAckedSize >= m_uWindow)
+					{
+						m_uAckedSize -= m_uWindow;
+						m_uWindow += m_uMSS;
+					}
+				}
+			}
+			virtual GAIA::GVOID OnLoss(GAIA::U64 uInflightSize, GAIA::U64 uLostSize, const GAIA::U64& uCurrentTime)
+			{
+				if(uCurrentTime < m_uRecoveryEndTime)
+					return;
+				m_uSSThresh = this->halfwindow();
+				m_uWindow = m_uSSThresh;
+				m_uAckedSize = 0;
+				m_uRecoveryEndTime = uCurrentTime + this->recoverytime();
+			}
+			virtual GAIA::GVOID OnTimeout(GAIA::U64 uInflightSize, const GAIA::U64& uCurrentTime)
+			{
+				m_uSSThresh = this->halfwindow();
+				m_uWindow = m_uMSS;
+				m_uAckedSize = 0;
+				m_uRecoveryEndTime = uCurrentTime + this->recoverytime();
+			}
+			virtual GAIA::U64 GetWindow() const{return m_uWindow;}
+			virtual GAIA::U64 GetPacingInterval(GAIA::N32 nSize) const
+			{
+				if(!m_bRTTValid || m_uSRTT == 0 || m_uWindow == 0)
+					return 0;
+				GAIA::U64 uGainPercent = m_uWindow < m_uSSThresh ? 200 : 120;
+				return (GAIA::U64)nSize * m_uSRTT * 100 / (m_uWindow * uGainPercent);
+			}
+
+			/*!
+				@brief Get the slow start threshold in bytes.
+			*/
+			GINL GAIA::U64 GetSSThresh() const{return m_uSSThresh;}
+
+			/*!
+				@brief Check the controller is in slow start.
+			*/
+			GINL GAIA::BL IsSlowStart() const{return m_uWindow < m_uSSThresh;}
+
+		private:
+			GINL GAIA::GVOID init()
+			{
+				m_uWindow = m_uMSS * INITIAL_WINDOW_SEGMENTS;
+				m_uSSThresh = GAIA::U64MAX;
+				m_uAckedSize = 0;
+				m_uSRTT = 0;
+				m_bRTTValid = GAIA::False;
+				m_uRecoveryEndTime = 0;
+			}
+			GINL GAIA::U64 halfwindow() const
+			{
+				// Halve the window instead of the flight size, the paced flight is often less than the window.
+				GAIA::U64 uHalf = m_uWindow / 2;
+				if(uHalf < m_uMSS * 2)
+					uHalf = m_uMSS * 2;
+				return uHalf;
+			}
+			GINL GAIA::U64 recoverytime() const{return m_bRTTValid && m_uSRTT > 0 ? m_uSRTT : 1;}
+
+		private:
+			GAIA::U64 m_uWindow;
+			GAIA::U64 m_uSSThresh;
+			GAIA::U64 m_uAckedSize; // Acknowledged bytes accumulated in congestion avoidance.
+			GAIA::U64 m_uSRTT;
+			GAIA::BL m_bRTTValid;
+			GAIA::U64 m_uRecoveryEndTime; // The losses before this time belong to the same loss recovery.
+		};
+
+		/*!
+			@brief BBR like congestion control.
+
+			@remarks
+				The model of the path is the max delivery rate(bottleneck bandwidth) of the recent rounds and the min round trip time of the recent 10 seconds,
+				the window is 2 times of the bandwidth delay product, and the datagrams are paced at the bottleneck bandwidth with a gain.\n
+				STARTUP pace at 2.885 times until the bandwidth stop growing 25% for 3 rounds,
+				DRAIN pace at 1 / 2.885 times until the bytes in flight fall to the bandwidth delay product,
+				then PROBEBW cycle the gain by 1.25, 0.75, 1, 1, 1, 1, 1, 1 each round.\n
+				The losses are not congestion signal, but the retransmission timeout limit the window to one segment until the next acknowledgement.\n
+		*/
+		class CongestionControlBBR : public GAIA::NETWORK::CongestionControl
+		{
+		public:
+			GAIA_ENUM_BEGIN(MODE)
+				MODE_STARTUP,
+				MODE_DRAIN,
+				MODE_PROBEBW,
+			GAIA_ENUM_END(MODE)
+
+			static const GAIA::U64 INITIAL_WINDOW_SEGMENTS = 10;
+			static const GAIA::U64 MIN_WINDOW_SEGMENTS = 4;
+			static const GAIA::U64 MIN_RTT_WINDOW = 10 * 1000 * 1000;
+			static const GAIA::NUM BANDWIDTH_FILTER_SIZE = 10;
+			static const GAIA::NUM GAIN_CYCLE_SIZE = 8;
+
+		public:
+			GINL CongestionControlBBR(){this->init();}
+			virtual GAIA::GVOID OnAck(GAIA::U64 uInflightSize, GAIA::U64 uAckedSize, GAIA::U64 uRTT, const GAIA::U64& uCurrentTime)
+			{
+				m_bTimeout = GAIA::False;
+
+				// Min rtt filter.
+				if(uRTT != INVALID_RTT)
+				{
+					if(m_uMinRTT == INVALID_RTT || uRTT <= m_uMinRTT || uCurrentTime - m_uMinRTTTime > MIN_RTT_WINDOW)
+					{
+						m_uMinRTT = uRTT;
+						m_uMinRTTTime = uCurrentTime;
+					}
+				}
+
+				// Delivery rate sample, one per round.
+				m_uDelivered += uAckedSize;
+				if(m_uSampleTime == GAIA::U64MAX)
+				{
+					m_uSampleTime = uCurrentTime;
+					m_uSampleDelivered = m_uDelivered;
+				}
+				GAIA::U64 uRound = m_uMinRTT == INVALID_RTT || m_uMinRTT == 0 ? 1 : m_uMinRTT;
+				GAIA::U64 uInterval = uCurrentTime - m_uSampleTime;
+				if(uInterval >= uRound)
+				{
+					m_bandwidths[m_sBandwidthIndex] = (m_uDelivered - m_uSampleDelivered) * 1000 * 1000 / uInterval;
+					m_sBandwidthIndex = (m_sBandwidthIndex + 1) % BANDWIDTH_FILTER_SIZE;
+					m_uSampleTime = uCurrentTime;
+					m_uSampleDelivered = m_uDelivered;
+					this->round();
+				}
+
+				if(m_mode == MODE_DRAIN && uInflightSize <= this->bdp())
+				{
+					m_mode = MODE_PROBEBW;
+					m_sCycleIndex = 0;
+				}
+			}
+			virtual GAIA::GVOID OnLoss(GAIA::U64 uInflightSize, GAIA::U64 uLostSize, const GAIA::U64& uCurrentTime){}
+			virtual GAIA::GVOID OnTimeout(GAIA::U64 uInflightSize, const GAIA::U64& uCurrentTime){m_bTimeout = GAIA::True;}
+			virtual GAIA::U64 GetWindow() const
+			{
+				if(m_bTimeout)
+					return m_uMSS;
+				GAIA::U64 uBandwidth = this->GetBandwidth();
+				if(uBandwidth == 0 || m_uMinRTT == INVALID_RTT)
+					return m_uMSS * INITIAL_WINDOW_SEGMENTS;
+				GAIA::F64 dGain = m_mode == MODE_PROBEBW ? 2.0 : 2.885;
+				GAIA::U64 uWindow = (GAIA::U64)((GAIA::F64)this->bdp() * dGain);
+				if(uWindow < m_uMSS * MIN_WINDOW_SEGMENTS)
+					uWindow = m_uMSS * MIN_WINDOW_SEGMENTS;
+				return uWindow;
+			}
+			virtual GAIA::U64 GetPacingInterval(GAIA::N32 nSize) const
+			{
+				GAIA::U64 uBandwidth = this->GetBandwidth();
+				if(uBandwidth == 0)
+					return 0;
+				return (GAIA::U64)((GAIA::F64)nSize * 1000 * 1000 / ((GAIA::F64)uBandwidth * this->pacinggain()));
+			}
+
+			/*!
+				@brief Get current mode, see MODE.
+			*/
+			GINL MODE GetMode() const{return m_mode;}
+
+			/*!
+				@brief Get the bottleneck bandwidth estimation in bytes per second.
+			*/
+			GINL GAIA::U64 GetBandwidth() const
+			{
+				GAIA::U64 uRet = 0;
+				for(GAIA::NUM x = 0; x < BANDWIDTH_FILTER_SIZE; ++x)
+				{
+					if(m_bandwidths[x] > uRet)
+						uRet = m_bandwidths[x];
+				}
+				return uRet;
+			}
+
+			/*!
+				@brief Get the min round trip time estimation, INVALID_RTT if there is not any sample.
+			*/
+			GINL GAIA::U64 GetMinRTT() const{return m_uMinRTT;}
+
+		private:
+			GINL GAIA::GVOID init()
+			{
+				m_mode = MODE_STARTUP;
+				m_uMinRTT = INVALID_RTT;
+				m_uMinRTTTime = 0;
+				for(GAIA::NUM x = 0; x < BANDWIDTH_FILTER_SIZE; ++x)
+					m_bandwidths[x] = 0;
+				m_sBandwidthIndex = 0;
+				m_uDelivered = 0;
+				m_uSampleDelivered = 0;
+				m_uSampleTime = GAIA::U64MAX;
+				m_uFullBandwidth = 0;
+				m_sFullBandwidthCount = 0;
+				m_sCycleIndex = 0;
+				m_bTimeout = GAIA::False;
+			}
+			GINL GAIA::GVOID round()
+			{
+				if(m_mode == MODE_STARTUP)
+				{
+					GAIA::U64 uBandwidth = this->GetBandwidth();
+					if(uBandwidth >= m_uFullBandwidth + m_uFullBandwidth / 4)
+					{
+						m_uFullBandwidth = uBandwidth;
+						m_sFullBandwidthCount = 0;
+					}
+					else if(++m_sFullBandwidthCount >= 3)
+						m_mode = MODE_DRAIN;
+				}
+				else if(m_mode == MODE_PROBEBW)
+				{
+					m_sCycleIndex = (m_sCycleIndex + 1) % GAIN_CYCLE_SIZE;
+				}
+			}
+			GINL GAIA::U64 bdp() const
+			{
+				if(m_uMinRTT == INVALID_RTT)
+					return m_uMSS * INITIAL_WINDOW_SEGMENTS;
+				return this->GetBandwidth() * m_uMinRTT / (1000 * 1000);
+			}
+			GINL GAIA::F64 pacinggain() const
+			{
+				if(m_mode == MODE_STARTUP)
+					return 2.885;
+				else if(m_mode == MODE_DRAIN)
+					return 1.0 / 2.885;
+				if(m_sCycleIndex == 0)
+					return 1.25;
+				else if(m_sCycleIndex == 1)
+					return 0.75;
+				return 1.0;
+			}
+
+		private:
+			MODE m_mode;
+			GAIA::U64 m_uMinRTT;
+			GAIA::U64 m_uMinRTTTime;
+			GAIA::U64 m_bandwidths[BANDWIDTH_FILTER_SIZE]; // Delivery rate samples in bytes per second, the max one is the bottleneck bandwidth.
+			GAIA::NUM m_sBandwidthIndex;
+			GAIA::U64 m_uDelivered;
+			GAIA::U64 m_uSampleDelivered;
+			GAIA::U64 m_uSampleTime;
+			GAIA::U64 m_uFullBandwidth;
+			GAIA::NUM m_sFullBandwidthCount;
+			GAIA::NUM m_sCycleIndex;
+			GAIA::BL m_bTimeout;
+		};
+	}
+}
+
+#endif
@@ -343,9 +343,9 @@ namespace GAIA
 				GAIA::CTN::ACharsString strValue;
 				while(*p != '\0')
 				{
-					if(*p == ':') // Name end.
+					if(*p == ':' && strName.empty()) // Name end.
 					{
-						if(!strName.empty() || p - pLast == 0)
+						if(p - pLast == 0)
 						{
 							this->Reset();
 							return GAIA::False;
@@ -368,6 +368,8 @@ namespace GAIA
 						p += 2;
 						pLast = p;
 					}
+					else
+						++p;
 				}
 				if(p != pLast)
 				{
@@ -462,7 +464,7 @@ namespace GAIA
 				GAIA::NUM sFinded = m_nodes.binary_search(finder);
 				if(sFinded == GINVALID)
 					return GNIL;
-				return m_nodes[sFinded].pszName;
+				return m_nodes[sFinded].pszValue;
 			}
 			GINL GAIA::BL Exist(const GAIA::CH* pszName) const
 			{
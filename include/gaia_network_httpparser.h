@@ -0,0 +1,506 @@
+#ifndef	 __GAIA_NETWORK_HTTPPARSER_H__
+#define	 __GAIA_NETWORK_HTTPPARSER_H__
+
+#include "gaia_type.h"
+#include "gaia_assert.h"
+#include "gaia_algo_string.h"
+
+namespace GAIA
+{
+	namespace NETWORK
+	{
+		/*!
+			@brief Incremental http/1.1 request parser.
+
+			@remarks
+				The parser never copy and never allocate, all the strings passed to callback are views into the input buffer,
+				so the views are valid in the callback only.
+
+				Execute could be called with any part of the stream.
+				If a line of head is not complete, the parser stop at the begin of the line and report the consumed size,
+				the caller should keep the bytes not consumed, and call Execute again with the more data appended to them.
+				The body is streamed to callback without waiting the whole body.
+				The pipelined requests in one buffer are parsed one by one.
+		*/
+		class HttpParser : public GAIA::Base
+		{
+		public:
+			/*!
+				@brief The max size of a line in head, include request line, head field, chunk size line and trailer field.
+			*/
+			static const GAIA::NUM MAX_LINE_SIZE = 1024 * 8;
+
+			/*!
+				@brief A string view into the input buffer, it is not NUL-terminated.
+			*/
+			class View : public GAIA::Base
+			{
+			public:
+				GINL GAIA::GVOID reset(){p = GNIL; sLen = 0;}
+				GINL GAIA::BL empty() const{return sLen == 0;}
+				GINL GAIA::BL equals(const GAIA::CH* psz) const
+				{
+					GAST(psz != GNIL);
+					for(GAIA::NUM x = 0; x < sLen; ++x)
+					{
+						if(psz[x] != p[x] || psz[x] == '\0')
+							return GAIA::False;
+					}
+					return psz[sLen] == '\0';
+				}
+				GINL GAIA::BL iequals(const GAIA::CH* psz) const
+				{
+					GAST(psz != GNIL);
+					for(GAIA::NUM x = 0; x < sLen; ++x)
+					{
+						if(psz[x] == '\0' || GAIA::ALGO::tolower(psz[x]) != GAIA::ALGO::tolower(p[x]))
+							return GAIA::False;
+					}
+					return psz[sLen] == '\0';
+				}
+			public:
+				const GAIA::CH* p;
+				GAIA::NUM sLen;
+			};
+
+			/*!
+				@brief Parse event receiver.
+			*/
+			class CallBack : public GAIA::Base
+			{
+			public:
+				virtual GAIA::GVOID OnRequestLine(GAIA::NETWORK::HttpParser& parser, const View& method, const View& url, const View& version){}
+				virtual GAIA::GVOID OnHead(GAIA::NETWORK::HttpParser& parser, const View& name, const View& value){}
+				virtual GAIA::GVOID OnHeadComplete(GAIA::NETWORK::HttpParser& parser){}
+				virtual GAIA::GVOID OnBody(GAIA::NETWORK::HttpParser& parser, const GAIA::CH* p, GAIA::NUM sSize){}
+				virtual GAIA::GVOID OnMessageComplete(GAIA::NETWORK::HttpParser& parser){}
+			};
+
+		public:
+			GINL HttpParser(){m_pCallBack = GNIL; this->Reset();}
+			GINL ~HttpParser(){}
+
+			GINL GAIA::GVOID SetCallBack(CallBack* pCallBack){m_pCallBack = pCallBack;}
+			GINL CallBack* GetCallBack() const{return m_pCallBack;}
+
+			/*!
+				@brief Reset the parser to wait a new request, the error state is cleared.
+			*/
+			GINL GAIA::GVOID Reset()
+			{
+				m_state = STATE_REQUESTLINE;
+				m_bError = GAIA::False;
+				this->reset_message();
+			}
+
+			/*!
+				@brief Parse a piece of stream.
+
+				@param p [in] Specify the data, it is the bytes not consumed by last call and the new received bytes.
+
+				@param sSize [in] Specify the data size in bytes.
+
+				@param sConsumed [out] Used for saving the size of bytes consumed.
+					The bytes from sConsumed to sSize is a part of a line, and should be passed again in next call.
+
+				@return If the stream is not a valid http request, return GAIA::False, and the parser is in error state until Reset.
+			*/
+			GINL GAIA::BL Execute(const GAIA::CH* p, GAIA::NUM sSize, GAIA::NUM& sConsumed)
+			{
+				GAST(p != GNIL || sSize == 0);
+				GAST(sSize >= 0);
+				sConsumed = 0;
+				if(m_bError)
+					return GAIA::False;
+
+				const GAIA::CH* pCur = p;
+				const GAIA::CH* pEnd = p + sSize;
+				while(pCur < pEnd)
+				{
+					switch(m_state)
+					{
+					case STATE_BODY:
+					case STATE_CHUNKDATA:
+						{
+							GAIA::NUM sAvail = (GAIA::NUM)(pEnd - pCur);
+							GAIA::NUM sPiece = m_lRemain < (GAIA::N64)sAvail ? (GAIA::NUM)m_lRemain : sAvail;
+							if(m_pCallBack != GNIL)
+								m_pCallBack->OnBody(*this, pCur, sPiece);
+							pCur += sPiece;
+							m_lRemain -= sPiece;
+							if(m_lRemain == 0)
+							{
+								if(m_state == STATE_BODY)
+									this->complete_message();
+								else
+									m_state = STATE_CHUNKDATAEND;
+							}
+						}
+						break;
+					default:
+						{
+							// The line based states, a line is parsed when it is complete only.
+							const GAIA::CH* pLineEnd = pCur;
+							while(pLineEnd < pEnd && *pLineEnd != '\n')
+								++pLineEnd;
+							if(pLineEnd == pEnd)
+							{
+								if(pEnd - pCur > MAX_LINE_SIZE)
+									return this->error();
+								sConsumed = (GAIA::NUM)(pCur - p);
+								return GAIA::True;
+							}
+							const GAIA::CH* pLineStop = pLineEnd;
+							if(pLineStop > pCur && *(pLineStop - 1) == '\r')
+								--pLineStop;
+							if(pLineStop - pCur > MAX_LINE_SIZE)
+								return this->error();
+							if(!this->parse_line(pCur, pLineStop))
+								return this->error();
+							pCur = pLineEnd + 1;
+						}
+						break;
+					}
+				}
+				sConsumed = (GAIA::NUM)(pCur - p);
+				return GAIA::True;
+			}
+
+			/*!
+				@brief Check the parser is in error state or not.
+			*/
+			GINL GAIA::BL IsError() const{return m_bError;}
+
+			/*!
+				@brief Check the parser is waiting a new request or not.
+
+				@remarks
+					If the connection closed when the parser is not idle, the last request is truncated.
+			*/
+			GINL GAIA::BL IsIdle() const{return m_state == STATE_REQUESTLINE && !m_bError;}
+
+			GINL GAIA::N32 GetVersionMajor() const{return m_nVersionMajor;}
+			GINL GAIA::N32 GetVersionMinor() const{return m_nVersionMinor;}
+
+			/*!
+				@brief Get the content length of current request.
+
+				@return If there is no Content-Length field or the body is chunked, return GINVALID.
+			*/
+			GINL GAIA::N64 GetContentLength() const{return m_bChunked ? GINVALID : m_lContentLength;}
+			GINL GAIA::BL IsChunked() const{return m_bChunked;}
+
+			/*!
+				@brief Check the connection should be kept after current request.
+
+				@remarks
+					Http/1.1 keep alive by default, and http/1.0 close by default, the Connection field override it.
+			*/
+			GINL GAIA::BL IsKeepAlive() const{return m_bKeepAlive;}
+
+		private:
+			GAIA_ENUM_BEGIN(STATE)
+				STATE_REQUESTLINE,
+				STATE_HEAD,
+				STATE_BODY,
+				STATE_CHUNKSIZE,
+				STATE_CHUNKDATA,
+				STATE_CHUNKDATAEND,
+				STATE_TRAILER,
+			GAIA_ENUM_END(STATE)
+
+		private:
+			GINL GAIA::GVOID reset_message()
+			{
+				m_lContentLength = GINVALID;
+				m_lRemain = 0;
+				m_nVersionMajor = 0;
+				m_nVersionMinor = 0;
+				m_bChunked = GAIA::False;
+				m_bTransferEncoding = GAIA::False;
+				m_bKeepAlive = GAIA::False;
+			}
+			GINL GAIA::BL error()
+			{
+				m_bError = GAIA::True;
+				return GAIA::False;
+			}
+			GINL GAIA::GVOID complete_message()
+			{
+				m_state = STATE_REQUESTLINE;
+				if(m_pCallBack != GNIL)
+					m_pCallBack->OnMessageComplete(*this);
+			}
+			GINL GAIA::BL parse_line(const GAIA::CH* p, const GAIA::CH* pEnd)
+			{
+				switch(m_state)
+				{
+				case STATE_REQUESTLINE:
+					return this->parse_requestline(p, pEnd);
+				case STATE_HEAD:
+					if(p == pEnd)
+						return this->parse_headend();
+					return this->parse_head(p, pEnd, GAIA::False);
+				case STATE_CHUNKSIZE:
+					return this->parse_chunksize(p, pEnd);
+				case STATE_CHUNKDATAEND:
+					if(p != pEnd)
+						return GAIA::False;
+					m_state = STATE_CHUNKSIZE;
+					return GAIA::True;
+				case STATE_TRAILER:
+					if(p == pEnd)
+					{
+						this->complete_message();
+						return GAIA::True;
+					}
+					return this->parse_head(p, pEnd, GAIA::True);
+				default:
+					GASTFALSE;
+					return GAIA::False;
+				}
+			}
+			GINL GAIA::BL parse_requestline(const GAIA::CH* p, const GAIA::CH* pEnd)
+			{
+				// The empty lines before request line should be ignored.
+				if(p == pEnd)
+					return GAIA::True;
+
+				this->reset_message();
+
+				View method, url, version;
+				method.p = p;
+				while(p < pEnd && *p != ' ')
+				{
+					if(!this->istoken(*p))
+						return GAIA::False;
+					++p;
+				}
+				method.sLen = (GAIA::NUM)(p - method.p);
+				if(method.sLen == 0 || p == pEnd)
+					return GAIA::False;
+				++p;
+
+				url.p = p;
+				while(p < pEnd && *p != ' ')
+				{
+					if((GAIA::U8)*p <= ' ' || *p == 0x7F)
+						return GAIA::False;
+					++p;
+				}
+				url.sLen = (GAIA::NUM)(p - url.p);
+				if(url.sLen == 0 || p == pEnd)
+					return GAIA::False;
+				++p;
+
+				// Version must be HTTP/x.y.
+				version.p = p;
+				version.sLen = (GAIA::NUM)(pEnd - p);
+				if(version.sLen != 8)
+					return GAIA::False;
+				if(p[0] != 'H' || p[1] != 'T' || p[2] != 'T' || p[3] != 'P' || p[4] != '/' || p[6] != '.')
+					return GAIA::False;
+				if(p[5] < '0' || p[5] > '9' || p[7] < '0' || p[7] > '9')
+					return GAIA::False;
+				m_nVersionMajor = p[5] - '0';
+				m_nVersionMinor = p[7] - '0';
+				if(m_nVersionMajor != 1)
+					return GAIA::False;
+				m_bKeepAlive = m_nVersionMinor >= 1;
+
+				if(m_pCallBack != GNIL)
+					m_pCallBack->OnRequestLine(*this, method, url, version);
+				m_state = STATE_HEAD;
+				return GAIA::True;
+			}
+			GINL GAIA::BL parse_head(const GAIA::CH* p, const GAIA::CH* pEnd, GAIA::BL bTrailer)
+			{
+				// Obsolete line folding is not supported.
+				if(*p == ' ' || *p == '\t')
+					return GAIA::False;
+
+				View name, value;
+				name.p = p;
+				while(p < pEnd && *p != ':')
+				{
+					if(!this->istoken(*p))
+						return GAIA::False;
+					++p;
+				}
+				name.sLen = (GAIA::NUM)(p - name.p);
+				if(name.sLen == 0 || p == pEnd)
+					return GAIA::False;
+				++p;
+
+				// Trim the optional white spaces.
+				while(p < pEnd && (*p == ' ' || *p == '\t'))
+					++p;
+				while(pEnd > p && (*(pEnd - 1) == ' ' || *(pEnd - 1) == '\t'))
+					--pEnd;
+				value.p = p;
+				value.sLen = (GAIA::NUM)(pEnd - p);
+
+				if(!bTrailer)
+				{
+					if(name.iequals("Content-Length"))
+					{
+						if(value.sLen == 0 || value.sLen > 18)
+							return GAIA::False;
+						GAIA::N64 lLen = 0;
+						for(GAIA::NUM x = 0; x < value.sLen; ++x)
+						{
+							if(value.p[x] < '0' || value.p[x] > '9')
+								return GAIA::False;
+							lLen = lLen * 10 + (value.p[x] - '0');
+						}
+						if(m_lContentLength != GINVALID && m_lContentLength != lLen)
+							return GAIA::False;
+						m_lContentLength = lLen;
+					}
+					else if(name.iequals("Transfer-Encoding"))
+					{
+						// The codings of the repeated fields are combined in order, the chunked must be the last one and only once.
+						const GAIA::CH* pToken = value.p;
+						const GAIA::CH* pValueEnd = value.p + value.sLen;
+						while(pToken < pValueEnd)
+						{
+							while(pToken < pValueEnd && (*pToken == ',' || *pToken == ' ' || *pToken == '\t'))
+								++pToken;
+							View token;
+							token.p = pToken;
+							while(pToken < pValueEnd && *pToken != ',' && *pToken != ';' && *pToken != ' ' && *pToken != '\t')
+								++pToken;
+							token.sLen = (GAIA::NUM)(pToken - token.p);
+							while(pToken < pValueEnd && (*pToken == ' ' || *pToken == '\t'))
+								++pToken;
+							if(pToken < pValueEnd && *pToken == ';')
+							{
+								// The parameters of coding are ignored.
+								while(pToken < pValueEnd && *pToken != ',')
+									++pToken;
+							}
+							else if(pToken < pValueEnd && *pToken != ',')
+								return GAIA::False;
+							if(token.empty())
+								continue;
+							if(m_bChunked)
+								return GAIA::False;
+							m_bChunked = token.iequals("chunked");
+							m_bTransferEncoding = GAIA::True;
+						}
+					}
+					else if(name.iequals("Connection"))
+					{
+						const GAIA::CH* pToken = value.p;
+						const GAIA::CH* pValueEnd = value.p + value.sLen;
+						while(pToken < pValueEnd)
+						{
+							while(pToken < pValueEnd && (*pToken == ',' || *pToken == ' ' || *pToken == '\t'))
+								++pToken;
+							View token;
+							token.p = pToken;
+							while(pToken < pValueEnd && *pToken != ',' && *pToken != ' ' && *pToken != '\t')
+								++pToken;
+							token.sLen = (GAIA::NUM)(pToken - token.p);
+							if(token.iequals("close"))
+								m_bKeepAlive = GAIA::False;
+							else if(token.iequals("keep-alive"))
+								m_bKeepAlive = GAIA::True;
+						}
+					}
+				}
+
+				if(m_pCallBack != GNIL)
+					m_pCallBack->OnHead(*this, name, value);
+				return GAIA::True;
+			}
+			GINL GAIA::BL parse_headend()
+			{
+				// The body length of a request is ambiguous if the last coding is not chunked or there is Content-Length too,
+				// a proxy may frame it in other way and smuggle a request, so it is rejected(RFC 7230 3.3.3).
+				if(m_bTransferEncoding && (!m_bChunked || m_lContentLength != GINVALID))
+					return GAIA::False;
+				if(m_pCallBack != GNIL)
+					m_pCallBack->OnHeadComplete(*this);
+				if(m_bChunked)
+					m_state = STATE_CHUNKSIZE;
+				else if(m_lContentLength > 0)
+				{
+					m_lRemain = m_lContentLength;
+					m_state = STATE_BODY;
+				}
+				else
+					this->complete_message();
+				return GAIA::True;
+			}
+			GINL GAIA::BL parse_chunksize(const GAIA::CH* p, const GAIA::CH* pEnd)
+			{
+				GAIA::N64 lSize = 0;
+				const GAIA::CH* pBegin = p;
+				for(; p < pEnd; ++p)
+				{
+					GAIA::N32 nDigit;
+					if(*p >= '0' && *p <= '9')
+						nDigit = *p - '0';
+					else if(*p >= 'a' && *p <= 'f')
+						nDigit = *p - 'a' + 10;
+					else if(*p >= 'A' && *p <= 'F')
+						nDigit = *p - 'A' + 10;
+					else
+						break;
+					if(p - pBegin >= 15)
+						return GAIA::False;
+					lSize = (lSize << 4) | nDigit;
+				}
+				if(p == pBegin)
+					return GAIA::False;
+
+				// The chunk extensions are ignored.
+				while(p < pEnd && (*p == ' ' || *p == '\t'))
+					++p;
+				if(p != pEnd && *p != ';')
+					return GAIA::False;
+
+				if(lSize == 0)
+					m_state = STATE_TRAILER;
+				else
+				{
+					m_lRemain = lSize;
+					m_state = STATE_CHUNKDATA;
+				}
+				return GAIA::True;
+			}
+			GINL GAIA::BL istoken(GAIA::CH c) const
+			{
+				if(c >= 'a' && c <= 'z')
+					return GAIA::True;
+				if(c >= 'A' && c <= 'Z')
+					return GAIA::True;
+				if(c >= '0' && c <= '9')
+					return GAIA::True;
+				switch(c)
+				{
+				case '!': case '#': case '$': case '%': case '&': case '\'': case '*':
+				case '+': case '-': case '.': case '^': case '_': case '`': case '|': case '~':
+					return GAIA::True;
+				default:
+					return GAIA::False;
+				}
+			}
+
+		private:
+			CallBack* m_pCallBack;
+			STATE m_state;
+			GAIA::N64 m_lContentLength;
+			GAIA::N64 m_lRemain;
+			GAIA::N32 m_nVersionMajor;
+			GAIA::N32 m_nVersionMinor;
+			GAIA::BL m_bChunked : 1;
+			GAIA::BL m_bTransferEncoding : 1;
+			GAIA::BL m_bKeepAlive : 1;
+			GAIA::BL m_bError : 1;
+		};
+	}
+}
+
+#endif
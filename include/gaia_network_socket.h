@@ -16,6 +16,8 @@ namespace GAIA
 		*/
 		class Socket : public GAIA::Base
 		{
+			friend class AsyncSocket;
+
 		public:
 			/*!
 				@brief Socket type.
@@ -62,6 +64,23 @@ namespace GAIA
 				SSDF_RECV = 0x10000000,
 				SSDF_SEND = 0x20000000,
 			GAIA_ENUM_END(SOCKET_SHUTDOWN_FLAG)
+
+			/*!
+				@brief Max datagram count of one system call in SendToBatch and RecvFromBatch.
+			*/
+			static const GAIA::N32 MAX_BATCH_SIZE = 64;
+
+			/*!
+				@brief Datagram for SendToBatch and RecvFromBatch.
+			*/
+			class Datagram : public GAIA::Base
+			{
+			public:
+				GAIA::NETWORK::Addr addr; // Destination address for send, source address for receive.
+				GAIA::GVOID* p; // Data buffer.
+				GAIA::N32 nSize; // Data size for send, buffer size for receive, and it is changed to the received size after receive.
+			};
+
 		public:
 
 			/*!
@@ -250,6 +269,51 @@ namespace GAIA
 			*/
 			GINL GAIA::N32 RecvFrom(GAIA::NETWORK::Addr& addr, GAIA::GVOID* p, GAIA::N32 nSize, GAIA::N32 nRecvFlag = GAIA::NETWORK::Socket::SRF_DEFAULT);
 
+			/*!
+				@brief Send datagrams to peers.(Datagram socket only)
+
+				@param pDatagrams [in] Specify the datagrams.
+
+				@param nCount [in] Specify the datagram count.
+
+				@return Return the count of datagrams which are sent, the datagrams are sent by order.
+					If the socket is a non-block socket and the send buffer is full, return value could below than nCount.
+
+				@exception
+					GAIA::ECT::EctIllegal If socket is not created.
+
+				@exception
+					GAIA::ECT::EctNetwork If send datagram socket data failed.
+
+				@remarks
+					On linux, it send MAX_BATCH_SIZE datagrams per system call by sendmmsg,
+					on other platforms, it is the same as call SendTo for each datagram.
+			*/
+			GINL GAIA::N32 SendToBatch(const GAIA::NETWORK::Socket::Datagram* pDatagrams, GAIA::N32 nCount);
+
+			/*!
+				@brief Receive datagrams from peers.(Datagram socket only)
+
+				@param pDatagrams [inout] Specify the datagrams, the p and nSize of each datagram specify the receive buffer.
+					When return, the addr and nSize of received datagrams is changed to the source address and the received size.
+
+				@param nCount [in] Specify the datagram count.
+
+				@return Return the count of datagrams which are received.
+					It wait for the first datagram when the socket is a block socket, and never wait for the others.
+
+				@exception
+					GAIA::ECT::EctIllegal If socket is not created.
+
+				@exception
+					GAIA::ECT::EctNetwork If recv datagram socket data failed.
+
+				@remarks
+					On linux, it receive MAX_BATCH_SIZE datagrams per system call by recvmmsg,
+					on other platforms, it is the same as call RecvFrom for each datagram, so it could wait for each datagram when the socket is a block socket.
+			*/
+			GINL GAIA::N32 RecvFromBatch(GAIA::NETWORK::Socket::Datagram* pDatagrams, GAIA::N32 nCount);
+
 			/*!
 				@brief Get socket file descriptor.
 			*/
@@ -694,6 +694,138 @@ namespace GAIA
 			return nRecved;
 		}
 
+		GINL GAIA::N32 Socket::SendToBatch(const GAIA::NETWORK::Socket::Datagram* pDatagrams, GAIA::N32 nCount)
+		{
+			if(pDatagrams == GNIL)
+				GTHROW(InvalidParam);
+			if(nCount < 0)
+				GTHROW(InvalidParam);
+
+			if(!this->IsCreated())
+				GTHROW(Illegal);
+
+		#if GAIA_OS == GAIA_OS_LINUX
+			mmsghdr msgs[MAX_BATCH_SIZE];
+			iovec iovs[MAX_BATCH_SIZE];
+			sockaddr_in saddrs[MAX_BATCH_SIZE];
+			GAIA::N32 nSended = 0;
+			while(nSended < nCount)
+			{
+				GAIA::N32 nBatchSize = nCount - nSended;
+				if(nBatchSize > MAX_BATCH_SIZE)
+					nBatchSize = MAX_BATCH_SIZE;
+				for(GAIA::N32 x = 0; x < nBatchSize; ++x)
+				{
+					const GAIA::NETWORK::Socket::Datagram& dg = pDatagrams[nSended + x];
+					if(!dg.addr.check() || dg.p == GNIL || dg.nSize <= 0)
+						GTHROW(InvalidParam);
+					zeromem(&saddrs[x]);
+					saddrs[x].sin_family = AF_INET;
+					addr2saddr(dg.addr, &saddrs[x]);
+					iovs[x].iov_base = dg.p;
+					iovs[x].iov_len = dg.nSize;
+					zeromem(&msgs[x]);
+					msgs[x].msg_hdr.msg_name = &saddrs[x];
+					msgs[x].msg_hdr.msg_namelen = sizeof(saddrs[x]);
+					msgs[x].msg_hdr.msg_iov = &iovs[x];
+					msgs[x].msg_hdr.msg_iovlen = 1;
+				}
+				GAIA::N32 nRet = sendmmsg(m_nSocket, msgs, nBatchSize, MSG_NOSIGNAL);
+				if(nRet == GINVALID)
+				{
+					GAIA::N32 nOSError = errno;
+					if(nOSError == EWOULDBLOCK)
+						break;
+					if(nSended > 0)
+						break;
+					THROW_LASTERROR;
+				}
+				nSended += nRet;
+				if(nRet < nBatchSize)
+					break;
+			}
+			return nSended;
+		#else
+			for(GAIA::N32 x = 0; x < nCount; ++x)
+			{
+				const GAIA::NETWORK::Socket::Datagram& dg = pDatagrams[x];
+				if(this->SendTo(dg.addr, dg.p, dg.nSize) != dg.nSize)
+					return x;
+			}
+			return nCount;
+		#endif
+		}
+
+		GINL GAIA::N32 Socket::RecvFromBatch(GAIA::NETWORK::Socket::Datagram* pDatagrams, GAIA::N32 nCount)
+		{
+			if(pDatagrams == GNIL)
+				GTHROW(InvalidParam);
+			if(nCount < 0)
+				GTHROW(InvalidParam);
+
+			if(!this->IsCreated())
+				GTHROW(Illegal);
+
+		#if GAIA_OS == GAIA_OS_LINUX
+			mmsghdr msgs[MAX_BATCH_SIZE];
+			iovec iovs[MAX_BATCH_SIZE];
+			sockaddr_in saddrs[MAX_BATCH_SIZE];
+			GAIA::N32 nRecved = 0;
+			while(nRecved < nCount)
+			{
+				GAIA::N32 nBatchSize = nCount - nRecved;
+				if(nBatchSize > MAX_BATCH_SIZE)
+					nBatchSize = MAX_BATCH_SIZE;
+				for(GAIA::N32 x = 0; x < nBatchSize; ++x)
+				{
+					const GAIA::NETWORK::Socket::Datagram& dg = pDatagrams[nRecved + x];
+					if(dg.p == GNIL || dg.nSize <= 0)
+						GTHROW(InvalidParam);
+					zeromem(&saddrs[x]);
+					saddrs[x].sin_family = AF_INET;
+					iovs[x].iov_base = dg.p;
+					iovs[x].iov_len = dg.nSize;
+					zeromem(&msgs[x]);
+					msgs[x].msg_hdr.msg_name = &saddrs[x];
+					msgs[x].msg_hdr.msg_namelen = sizeof(saddrs[x]);
+					msgs[x].msg_hdr.msg_iov = &iovs[x];
+					msgs[x].msg_hdr.msg_iovlen = 1;
+				}
+				GAIA::N32 nRet = recvmmsg(m_nSocket, msgs, nBatchSize, nRecved == 0 ? MSG_WAITFORONE : MSG_DONTWAIT, GNIL);
+				if(nRet == GINVALID)
+				{
+					GAIA::N32 nOSError = errno;
+					if(nOSError == EWOULDBLOCK)
+						break;
+					if(nRecved > 0)
+						break;
+					THROW_LASTERROR;
+				}
+				for(GAIA::N32 x = 0; x < nRet; ++x)
+				{
+					GAIA::NETWORK::Socket::Datagram& dg = pDatagrams[nRecved + x];
+					saddr2addr(&saddrs[x], dg.addr);
+					dg.nSize = (GAIA::N32)msgs[x].msg_len;
+				}
+				nRecved += nRet;
+				if(nRet < nBatchSize)
+					break;
+			}
+			return nRecved;
+		#else
+			for(GAIA::N32 x = 0; x < nCount; ++x)
+			{
+				GAIA::NETWORK::Socket::Datagram& dg = pDatagrams[x];
+				dg.addr.reset();
+				GAIA::N32 nRecved = this->RecvFrom(dg.addr, dg.p, dg.nSize);
+				if(nRecved <= 0)
+					return x;
+				dg.nSize = nRecved;
+			}
+			return nCount;
+		#endif
+		}
+
 		GINL GAIA::N32 Socket::GetFileDescriptor() const
 		{
 			return m_nSocket;
@@ -5,16 +5,19 @@
 #include "gaia_assert.h"
 #include "gaia_sync_lock.h"
 #include "gaia_sync_autolock.h"
+#include "gaia_sync_atomic.h"
 #include "gaia_ctn_ref.h"
 #include "gaia_ctn_vector.h"
 #include "gaia_ctn_queue.h"
 #include "gaia_ctn_buffer.h"
 #include "gaia_ctn_pool.h"
 #include "gaia_ctn_set.h"
+#include "gaia_ctn_flathashmap.h"
 #include "gaia_network_ip.h"
 #include "gaia_network_addr.h"
 #include "gaia_network_base.h"
 #include "gaia_network_socket.h"
+#include "gaia_network_congestion.h"
 
 namespace GAIA
 {
@@ -26,6 +29,10 @@ namespace GAIA
 			@remarks
 				Feature 1 : Use serial number solve udp datagram lose, datagram repeat, datagram order mistake problem.\n
 				Feature 2 : Support safe udp datagram and unsafe udp datagram mix usage.\n
+				Feature 3 : Send and receive datagrams by batches, one system call per batch where the platform support.\n
+				Feature 4 : The peers are hashed by network address into shards, each shard own the links, objects and lock of it's peers, so the shards could be executed by different threads.\n
+				Feature 5 : Selective acknowledgement of a configurable window, retransmission timeout estimated from round trip time(RFC 6298),
+					pluggable congestion control(NewReno by default) and pacing of the safe datagrams.\n
 		*/
 		class SUDPSocket : public GAIA::Base
 		{
@@ -34,6 +41,11 @@ namespace GAIA
 			static const GAIA::U64 DEFAULT_RESEND_TIME = 1 * 1000 * 1000;
 			static const GAIA::U64 DEFAULT_RERECV_TIME = 10 * 1000;
 			static const GAIA::U64 DEFAULT_RECYCLE_TIME = 10 * 1000 * 1000;
+			static const GAIA::NUM DEFAULT_BATCH_SIZE = GAIA::NETWORK::Socket::MAX_BATCH_SIZE;
+			static const GAIA::NUM DEFAULT_SHARD_COUNT = 16;
+			static const GAIA::U64 DEFAULT_MIN_RESEND_TIME = 200 * 1000;
+			static const GAIA::U64 DEFAULT_MAX_RESEND_TIME = 60 * 1000 * 1000;
+			static const GAIA::NUM DEFAULT_ACK_WINDOW_SIZE = 1024;
 
 		public:
 			class State : public GAIA::Base
@@ -59,6 +71,26 @@ namespace GAIA
 					uRecvBackMsgCount = 0;
 					uRecvBackMsgSize = 0;
 				}
+				GINL GAIA::GVOID add(const State& src)
+				{
+					uSendUnserialMsgCount += src.uSendUnserialMsgCount;
+					uSendSerialMsgCount += src.uSendSerialMsgCount;
+					uSendUnserialMsgSize += src.uSendUnserialMsgSize;
+					uSendSerialMsgSize += src.uSendSerialMsgSize;
+
+					uRecvUnserialMsgCount += src.uRecvUnserialMsgCount;
+					uRecvSerialMsgCount += src.uRecvSerialMsgCount;
+					uRecvUnserialMsgSize += src.uRecvUnserialMsgSize;
+					uRecvSerialMsgSize += src.uRecvSerialMsgSize;
+
+					uResendSerialMsgCount += src.uResendSerialMsgCount;
+					uResendSerialMsgSize += src.uResendSerialMsgSize;
+
+					uSendBackMsgCount += src.uSendBackMsgCount;
+					uSendBackMsgSize += src.uSendBackMsgSize;
+					uRecvBackMsgCount += src.uRecvBackMsgCount;
+					uRecvBackMsgSize += src.uRecvBackMsgSize;
+				}
 
 			public:
 				GAIA::U64 uSendUnserialMsgCount;
@@ -80,6 +112,21 @@ namespace GAIA
 				GAIA::U64 uRecvBackMsgSize;
 			};
 
+			/*!
+				@brief The reliable delivery state of the safe datagrams sent to a peer.
+			*/
+			class LinkInfo : public GAIA::Base
+			{
+			public:
+				GAIA::BL bRTTValid; // If GAIA::False, there is not any round trip time sample yet.
+				GAIA::U64 uSRTT; // Smoothed round trip time in microseconds.
+				GAIA::U64 uRTTVar; // Round trip time variation in microseconds.
+				GAIA::U64 uRTO; // Retransmission timeout in microseconds.
+				GAIA::U64 uInflightSize; // The bytes sent and not acknowledged.
+				GAIA::U64 uWindow; // The congestion window in bytes, GAIA::U64MAX if there is not a congestion controller.
+				GAIA::NUM sInflightCount; // The datagrams sent and not acknowledged.
+			};
+
 		public:
 			/*!
 				@brief Constructor.
@@ -215,7 +262,10 @@ namespace GAIA
 
 				@param uResendTime [in] Specify the resend time in microseconds. Default value is 1 * 1000 * 1000(1 second).
 
-				@remarks If parameter uResendTime equal zero, will reset resend time to default.
+				@remarks
+					If parameter uResendTime equal zero, will reset resend time to default.\n
+					It is the initial retransmission timeout of a peer, after the first round trip time sample,
+					the retransmission timeout is calculated by RFC 6298 and limited by the min and max resend time.\n
 			*/
 			GAIA::GVOID SetResendTime(const GAIA::U64& uResentTime);
 
@@ -226,12 +276,44 @@ namespace GAIA
 			*/
 			const GAIA::U64& GetResendTime() const;
 
+			/*!
+				@brief Set SUDPSocket min retransmission timeout in microseconds.
+
+				@param uMinResendTime [in] Specify the min resend time in microseconds. Default value is DEFAULT_MIN_RESEND_TIME(200 milliseconds).
+
+				@remarks If parameter uMinResendTime equal zero, will reset min resend time to default.
+			*/
+			GAIA::GVOID SetMinResendTime(const GAIA::U64& uMinResendTime);
+
+			/*!
+				@brief Get SUDPSocket min retransmission timeout in microseconds.
+			*/
+			const GAIA::U64& GetMinResendTime() const;
+
+			/*!
+				@brief Set SUDPSocket max retransmission timeout in microseconds.
+
+				@param uMaxResendTime [in] Specify the max resend time in microseconds. Default value is DEFAULT_MAX_RESEND_TIME(60 seconds).
+
+				@remarks
+					If parameter uMaxResendTime equal zero, will reset max resend time to default.\n
+					The retransmission timeout is doubled each time it expired, until this value.\n
+			*/
+			GAIA::GVOID SetMaxResendTime(const GAIA::U64& uMaxResendTime);
+
+			/*!
+				@brief Get SUDPSocket max retransmission timeout in microseconds.
+			*/
+			const GAIA::U64& GetMaxResendTime() const;
+
 			/*!
 				@brief Set SUDPSocket datagram rerecv time in microseconds.
 
 				@param uRerecvTime [in] Specify the rerecv time in microseconds. Default value is 10 * 1000(10 milliseconds).
 
-				@remarks If parameter uRerecvTime equal zero, will reset rerecv time to default.
+				@remarks
+					If parameter uRerecvTime equal zero, will reset rerecv time to default.\n
+					The received safe datagrams are acknowledged at most this time later, so it is also the clock granularity in the retransmission timeout calculation.\n
 			*/
 			GAIA::GVOID SetRerecvTime(const GAIA::U64& uRerecvTime);
 
@@ -258,6 +340,91 @@ namespace GAIA
 			*/
 			const GAIA::U64& GetRecycleTime() const;
 
+			/*!
+				@brief Set SUDPSocket datagram count per socket send or receive batch.
+
+				@param sBatchSize [in] Specify the datagram count. Default value is DEFAULT_BATCH_SIZE.
+
+				@exception
+					GAIA::ECT::EctInvalidParam If sBatchSize below zero.
+
+				@remarks
+					If parameter sBatchSize equal zero, will reset batch size to default.\n
+					SUDPSocket::Execute send and receive datagrams by batches, each batch is sent or received by one system call where the platform support.\n
+					The receive buffers of a batch are keeped by the socket, so it cost sBatchSize * GAIA::NETWORK::GAIA_NETWORK_MTU bytes memory.\n
+			*/
+			GAIA::GVOID SetBatchSize(GAIA::NUM sBatchSize);
+
+			/*!
+				@brief Get SUDPSocket datagram count per socket send or receive batch.
+
+				@return Return SUDPSocket datagram count per socket send or receive batch.
+			*/
+			GAIA::NUM GetBatchSize() const;
+
+			/*!
+				@brief Set SUDPSocket selective acknowledgement window size.
+
+				@param sAckWindowSize [in] Specify the count of serial numbers a peer could acknowledge in a window. Default value is DEFAULT_ACK_WINDOW_SIZE.
+
+				@exception
+					GAIA::ECT::EctInvalidParam If sAckWindowSize below zero.
+
+				@remarks
+					If parameter sAckWindowSize equal zero, will reset window size to default, it is rounded up to times of 64.\n
+					Each continuous range of received serial numbers in the window is acknowledged by one SUDPSocket::OnBack datagram,
+					the serial numbers out of the window are acknowledged after they are resent.\n
+					It cost sAckWindowSize / 8 bytes memory of each receiving peer.\n
+			*/
+			GAIA::GVOID SetAckWindowSize(GAIA::NUM sAckWindowSize);
+
+			/*!
+				@brief Get SUDPSocket selective acknowledgement window size.
+			*/
+			GAIA::NUM GetAckWindowSize() const;
+
+			/*!
+				@brief Set SUDPSocket shard count.
+
+				@param sShardCount [in] Specify the shard count. Default value is DEFAULT_SHARD_COUNT.
+
+				@exception
+					GAIA::ECT::EctInvalidParam If sShardCount below zero.
+
+				@exception
+					GAIA::ECT::EctIllegal If socket is created.
+
+				@remarks
+					If parameter sShardCount equal zero, will reset shard count to default.\n
+					The peers are hashed by network address into shards, each shard have it's own lock, links and object pools,
+					so the work of different shards never contend with each other, see SUDPSocket::ExecuteShard.\n
+			*/
+			GAIA::GVOID SetShardCount(GAIA::NUM sShardCount);
+
+			/*!
+				@brief Get SUDPSocket shard count.
+
+				@return Return SUDPSocket shard count.
+			*/
+			GAIA::NUM GetShardCount() const;
+
+			/*!
+				@brief Get the shard index of a network address.
+
+				@param addr [in] Specify the network address of peer.
+
+				@return Return the shard index in [0, SUDPSocket::GetShardCount()).
+
+				@exception
+					GAIA::ECT::EctInvalidParam If addr is invalid.
+
+				@exception
+					GAIA::ECT::EctIllegal If socket is not created.
+
+				@remarks The hash seed is random per socket, so the peers can't choose which shard they will be hashed to.
+			*/
+			GAIA::NUM GetShardIndex(const GAIA::NETWORK::Addr& addr) const;
+
 			/*!
 				@brief Send a udp datagram to peer.
 
@@ -355,13 +522,43 @@ namespace GAIA
 
 				@remarks
 					The moduler-user could call this function in other threads for performance optimize.\n
-					There is no effect for performance optimize when call this function in multi threads with same parameter(bSend and bRecv and bResend) at same time.
-						But you can create three thread, one to send(with parameter bSend = GAIA::True), one to recv(with parameter bRecv = GAIA::True),
-						and one to resend(with parameter bResend = GAIA::True), these three thread could improve the performance.\n
+					The receive work is serialized by the socket, the other works are executed shard by shard, see SUDPSocket::ExecuteShard.
+						You can create one thread to recv(with parameter bRecv = GAIA::True), and some threads call SUDPSocket::ExecuteShard with different shards.\n
+					The delta time is added to the clock of each shard, so only one thread should pass a none zero uDeltaTime for a shard.\n
 					This function could blocked when origin socket send and recv blocked(When origin socket is a block able socket).\n
 			*/
 			GAIA::BL Execute(GAIA::U64 uDeltaTime, GAIA::BL bSend = GAIA::True, GAIA::BL bRecv = GAIA::True, GAIA::BL bResend = GAIA::True, GAIA::BL bRerecv = GAIA::True, GAIA::BL bTimeout = GAIA::True);
 
+			/*!
+				@brief Execute one shard of the SUDPSocket.
+
+				@param sShardIndex [in] Specify the shard index in [0, SUDPSocket::GetShardCount()).
+
+				@param uDeltaTime [in] Delta time in microsecond between two execution of the shard.
+
+				@param bSend [in] Execute flush the send cache of the shard or not.
+
+				@param bResend [in] Execute resend the safe datagrams of the shard or not.
+
+				@param bRerecv [in] Execute receive notify back operation of the shard or not.
+
+				@param bTimeout [in] Execute timeout link dispatch of the shard or not.
+
+				@return
+					If there are some datagram be sent.
+
+				@exception
+					GAIA::ECT::EctInvalidParam If sShardIndex is not a valid shard index.
+
+				@exception
+					GAIA::ECT::EctIllegal If socket is not created.
+
+				@remarks
+					Only the lock of the shard is acquired, so the threads which execute different shards run in parallel without any shared lock.\n
+					The datagrams are received by SUDPSocket::Execute with parameter bRecv = GAIA::True.\n
+			*/
+			GAIA::BL ExecuteShard(GAIA::NUM sShardIndex, GAIA::U64 uDeltaTime, GAIA::BL bSend = GAIA::True, GAIA::BL bResend = GAIA::True, GAIA::BL bRerecv = GAIA::True, GAIA::BL bTimeout = GAIA::True);
+
 			/*!
 				@brief Reset the connection with a network address.
 
@@ -383,9 +580,26 @@ namespace GAIA
 			/*!
 				@brief Get socket state.
 
-				@return Return socket state.
+				@return Return socket state, it is the sum of the states of all the shards.
+			*/
+			GAIA::NETWORK::SUDPSocket::State GetState() const;
+
+			/*!
+				@brief Get the reliable delivery state of the safe datagrams sent to a peer.
+
+				@param addr [in] Specify the network address of peer.
+
+				@param info [out] Used for saving the state.
+
+				@return If there is not any safe datagram sent to the peer, return GAIA::False, or return GAIA::True.
+
+				@exception
+					GAIA::ECT::EctInvalidParam If addr is invalid.
+
+				@exception
+					GAIA::ECT::EctIllegal If socket is not created.
 			*/
-			const GAIA::NETWORK::SUDPSocket::State& GetState() const;
+			GAIA::BL GetLinkInfo(const GAIA::NETWORK::Addr& addr, LinkInfo& info) const;
 
 		public:
 			/*!
@@ -472,6 +686,8 @@ namespace GAIA
 					If you not overwrite any of SUDPSocket::OnSent or SUDPSocket::OnRecv or SUDPSocket::OnBack or SUDPSocket::OnRecvBack,
 					current socket will like a normal(original) udp socket.\n
 					This funciton will be called when SUDPSocket::Execute be called.\n
+					Each acknowledgement begin with a cumulative range [0, lEndSerial] of all the serials received continuously,
+					so a lost acknowledgement datagram is recovered by the next one.\n
 			*/
 			virtual GAIA::BL OnBack(const GAIA::NETWORK::Addr& addr, const GAIA::N64& lBeginSerial, const GAIA::N64& lEndSerial, GAIA::GVOID* p, GAIA::N32 nSize, GAIA::N32& nResultSize){return GAIA::False;}
 
@@ -517,6 +733,23 @@ namespace GAIA
 			*/
 			virtual GAIA::GVOID OnTimeout(const GAIA::NETWORK::Addr& addr, GAIA::BL bLostConnection){}
 
+			/*!
+				@brief On create the congestion controller of a peer.
+
+					When the first safe datagram is sent to a peer, this function will be called.
+
+				@param addr [in] Specify the network address of peer.
+
+				@return
+					Return a congestion controller allocated by gnew, the socket take the ownership and delete it by gdel when the connection is reset.\n
+					If return GNIL, the safe datagrams to the peer are not limited by any window or pacing.\n
+
+				@remarks
+					The default implementation return a GAIA::NETWORK::CongestionControlNewReno.\n
+					This function is called with the lock of the peer's shard, so it can't call the member functions of the socket.\n
+			*/
+			virtual GAIA::NETWORK::CongestionControl* OnCreateCongestionControl(const GAIA::NETWORK::Addr& addr){return gnew GAIA::NETWORK::CongestionControlNewReno;}
+
 		private:
 			class Node : public GAIA::Base
 			{
@@ -551,6 +784,7 @@ namespace GAIA
 				GAIA::U64 uFirstTime; // The time when first sent or recv. In microseconds.
 				GAIA::U64 uLastTime; // The time when last sent(include resend) or recv. In microseconds.
 				GAIA::N64 lSerial; // GINVALID means it is not a serial able datagram.
+				GAIA::U32 uSendCount; // Sent times include resend, the round trip time is sampled from the datagrams sent once only(Karn's algorithm).
 				GAIA::NETWORK::Addr addr;
 				GAIA::CTN::Buffer* pBuf;
 			};
@@ -567,34 +801,109 @@ namespace GAIA
 				GAIA::U64 uLastTime; // In microseconds.
 				GAIA::NETWORK::Addr addr; // Peer address.
 				__NodeSetType nodes;
+
+				/* Recv link. */
 				GAIA::N64 lNextSerial;
-				GAIA::U64 lNeedBackSerialBegin;
-				GAIA::U64 lNeedBackSerialFlags; // Must cache 64 difference serial.
+				GAIA::N64 lContinuousSerial; // All the serials below it are received.
+				GAIA::N64 lNeedBackSerialBegin;
+				GAIA::CTN::Vector<GAIA::U64> needbackflags; // The bit x means serial lNeedBackSerialBegin + x need back.
+				GAIA::U64 uNeedBackTime; // The time when the first serial need back received.
+
+				/* Sent link. */
+				GAIA::BL bRTTValid;
+				GAIA::U64 uSRTT;
+				GAIA::U64 uRTTVar;
+				GAIA::U64 uRTO;
+				GAIA::U64 uTimerTime; // The time when the retransmission timer started.
+				GAIA::U64 uLatestAckedTime; // The sent time of the latest sent datagram which is acknowledged, the datagrams sent before it are lost after a reorder time.
+				GAIA::U64 uInflightSize;
+				GAIA::U64 uNextSendTime; // Pacing.
+				GAIA::BL bBlocked; // Blocked by congestion window or pacing in current send dispatch.
+				GAIA::NETWORK::CongestionControl* pCC;
+			};
+
+		private:
+			typedef GAIA::CTN::Set<GAIA::CTN::Ref<Link> > __LinkSetType;
+			typedef GAIA::CTN::FlatHashMap<GAIA::NETWORK::Addr, Link*> __LinkMapType;
+			typedef GAIA::CTN::Vector<Node*> __NodeVectorType;
+			typedef GAIA::CTN::Vector<GAIA::NETWORK::Addr> __AddrVectorType;
+			typedef GAIA::CTN::Vector<Link*> __LinkVectorType;
+			typedef GAIA::CTN::Vector<GAIA::NUM> __IndexVectorType;
+			typedef GAIA::CTN::Set<GAIA::NETWORK::Addr> __AddrSetType;
+			typedef GAIA::CTN::Vector<GAIA::CTN::Buffer*> __BufferVectorType;
+			typedef GAIA::CTN::Vector<GAIA::NETWORK::Socket::Datagram> __DatagramVectorType;
+
+			/*
+			*	All the peers hashed to a shard, every member is guarded by the shard lock.
+			*/
+			class Shard : public GAIA::Base
+			{
+			public:
+				GINL Shard(){uLastExecuteTime = 0; state.reset();}
+			public:
+				GAIA::SYNC::Lock lr;
+				GAIA::U64 uLastExecuteTime; // The clock of the shard, in microseconds.
+				GAIA::NETWORK::SUDPSocket::State state;
+
+				/* Send cache. */
+				__NodeVectorType sendcache;
+
+				/* Send history. */
+				__LinkMapType sentlinks; // Hashed by network address(Link::addr).
+
+				/* Recv cache. */
+				__LinkMapType recvlinks; // Hashed by network address(Link::addr).
+				__LinkSetType recvablelinks; // Ordered by network address(Link::addr).
+
+				/* Timeout links. */
+				__AddrSetType disconnected;
+
+				/* Object pools. */
+				GAIA::CTN::Pool<GAIA::CTN::Buffer> bufpool;
+				GAIA::CTN::Pool<Node> nodepool;
+				GAIA::CTN::Pool<Link> linkpool;
+
+				/* Temporary container. */
+				__NodeVectorType listTempNode;
+				__IndexVectorType listTempIndex;
+				__LinkVectorType listTempLink;
+				__DatagramVectorType listTempDatagram;
 			};
 
 		private:
 			GINL GAIA::GVOID init()
 			{
-				m_state.reset();
 				m_uTimeout = DEFAULT_TIMEOUT_TIME;
 				m_uResendTime = DEFAULT_RESEND_TIME;
+				m_uMinResendTime = DEFAULT_MIN_RESEND_TIME;
+				m_uMaxResendTime = DEFAULT_MAX_RESEND_TIME;
 				m_uRerecvTime = DEFAULT_RERECV_TIME;
 				m_uRecycleTime = DEFAULT_RECYCLE_TIME;
-				m_uLastExecuteTime = 0;
+				m_sBatchSize = DEFAULT_BATCH_SIZE;
+				m_sAckWindowSize = DEFAULT_ACK_WINDOW_SIZE;
+				m_shards = GNIL;
+				m_sShardCount = DEFAULT_SHARD_COUNT;
+				m_uShardSeed = 0;
+				m_sRecvShardCursor = 0;
 			}
+			GAIA::GVOID CreateShards();
+			GAIA::GVOID DestroyShards();
+			GINL GAIA::NUM ShardIndex(const GAIA::NETWORK::Addr& addr) const{return (GAIA::NUM)(GAIA::ALGO::hash_int(addr.hash(), m_uShardSeed) % (GAIA::U64)m_sShardCount);}
+			GINL Shard& GetShard(const GAIA::NETWORK::Addr& addr) const{return m_shards[this->ShardIndex(addr)];}
+			GAIA::N32 RecvFromShard(Shard& shard, GAIA::NETWORK::Addr& addr, GAIA::GVOID* p, GAIA::N32 nSize);
+			GAIA::BL RecvDatagram(const GAIA::NETWORK::Addr& addrRecvFrom, GAIA::CTN::Buffer& recvbuf, GAIA::N32 nRecvSize);
+			GAIA::GVOID ResetShard(Shard& shard, const GAIA::NETWORK::Addr* pAddr, GAIA::BL bSend, GAIA::BL bRecv);
+			GAIA::GVOID ResetLink(Shard& shard, Link* pLink);
+			GAIA::GVOID ReleaseNode(Shard& shard, Node* pNode);
+			Link* AllocLink(Shard& shard, const GAIA::NETWORK::Addr& addr);
+			Link* GetSentLink(Shard& shard, const GAIA::NETWORK::Addr& addr);
+			GAIA::BL IsSendAble(Link* pLink, GAIA::N32 nSize, const GAIA::U64& uCurrentTime);
+			GAIA::GVOID UpdateRTO(Link* pLink, GAIA::U64 uRTT);
+			GAIA::GVOID NeedBack(Link* pLink, GAIA::N64 lSerial, const GAIA::U64& uCurrentTime);
+			GAIA::BL SendBack(Shard& shard, Link* pLink);
+			GAIA::BL SendBackRange(Shard& shard, Link* pLink, GAIA::N64 lSerialBegin, GAIA::N64 lSerialEnd);
 
 		private:
-			typedef GAIA::CTN::Queue<Node*> __NodeQueueType;
-			typedef GAIA::CTN::Set<GAIA::CTN::Ref<Link> > __LinkSetType;
-			typedef GAIA::CTN::Vector<Node*> __NodeVectorType;
-			typedef GAIA::CTN::Vector<GAIA::NETWORK::Addr> __AddrVectorType;
-			typedef GAIA::CTN::Vector<Link*> __LinkVectorType;
-			typedef GAIA::CTN::Set<GAIA::NETWORK::Addr> __AddrSetType;
-
-		private:
-
-			/* State. */
-			GAIA::NETWORK::SUDPSocket::State m_state;
 
 			/* Socket. */
 			GAIA::NETWORK::Socket m_sock;
@@ -602,51 +911,25 @@ namespace GAIA
 			/* Work parameter. */
 			GAIA::U64 m_uTimeout;
 			GAIA::U64 m_uResendTime;
+			GAIA::U64 m_uMinResendTime;
+			GAIA::U64 m_uMaxResendTime;
 			GAIA::U64 m_uRerecvTime;
 			GAIA::U64 m_uRecycleTime;
-			GAIA::U64 m_uLastExecuteTime;
+			GAIA::NUM m_sBatchSize;
+			GAIA::NUM m_sAckWindowSize;
 
-			/* Send cache. */
-			GAIA::SYNC::Lock m_lrSendCache;
-			__NodeVectorType m_sendcache;
-
-			/* Send history. */
-			GAIA::SYNC::Lock m_lrSent;
-			__LinkSetType m_sentlinks_byaddr; // Ordered by network address(Node::addr).
-
-			/* Recv cache. */
-			GAIA::SYNC::Lock m_lrRecv;
-			__LinkSetType m_recvlinks_byaddr; // Ordered by network address(Link::addr).
-			__LinkSetType m_recvablelinks_byaddr; // Ordered by network address(Link::addr).
-
-			/* Object pools. */
-			GAIA::SYNC::Lock m_lrBufferPool;
-			GAIA::CTN::Pool<GAIA::CTN::Buffer> m_bufpool;
-			GAIA::SYNC::Lock m_lrNodePool;
-			GAIA::CTN::Pool<Node> m_nodepool;
-			GAIA::SYNC::Lock m_lrLinkPool;
-			GAIA::CTN::Pool<Link> m_linkpool;
+			/* Shards. */
+			Shard* m_shards;
+			GAIA::NUM m_sShardCount;
+			GAIA::U64 m_uShardSeed;
+			GAIA::SYNC::Atomic m_sRecvShardCursor; // The shard RecvFrom begin to search when parameter addr is invalid, RecvFrom could be called by multi threads.
 
 			/* Execute mutex. */
-			GAIA::SYNC::Lock m_lrExecuteSend;
 			GAIA::SYNC::Lock m_lrExecuteRecv;
-			GAIA::SYNC::Lock m_lrExecuteResend;
-			GAIA::SYNC::Lock m_lrExecuteRerecv;
-			GAIA::SYNC::Lock m_lrExecuteTimeout;
-
-			/* Temporary container. */
-			__NodeVectorType m_listTempNodeForSend0;
-			__LinkVectorType m_listTempLinkForSend1;
-			__NodeVectorType m_listTempNodeForRecv0;
-			__LinkVectorType m_listTempLinkForRecv1;
-			__NodeVectorType m_listTempNodeForExecuteSend0;
-			__NodeVectorType m_listTempNodeForExecuteSend1;
-			__AddrVectorType m_listTempAddrForExecuteTimeout0;
-			GAIA::CTN::Buffer m_recvbuf;
-
-			/* Swap container. */
-			GAIA::SYNC::Lock m_lrDisconnected;
-			__AddrSetType m_listDisconnected;
+
+			/* Receive context, guarded by m_lrExecuteRecv. */
+			__DatagramVectorType m_listTempDatagramForExecuteRecv;
+			__BufferVectorType m_recvbufs; // Receive buffers of a batch, the received datagram is swapped to a buffer of the shard.
 		};
 	}
 }
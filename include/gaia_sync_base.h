@@ -8,6 +8,9 @@
 #	include <winsock2.h>
 #	include <ws2tcpip.h>
 #	include <windows.h>
+#elif GAIA_OS == GAIA_OS_OSX || GAIA_OS == GAIA_OS_IOS
+#	include <unistd.h>
+#	include <libkern/OSAtomic.h>
 #else
 #	include <unistd.h>
 #endif
@@ -51,6 +54,27 @@ namespace GAIA
 			return uMicroSeconds;
 		#endif
 		}
+
+		/*!
+			@brief Full memory barrier, the memory access before it will not be reordered after it by compiler and CPU.
+		*/
+		GINL GAIA::GVOID gmembarrier()
+		{
+		#if GAIA_OS == GAIA_OS_WINDOWS
+			MemoryBarrier();
+		#elif GAIA_OS == GAIA_OS_OSX || GAIA_OS == GAIA_OS_IOS
+		#	ifdef __APPLE__
+		#		pragma clang diagnostic push
+		#		pragma clang diagnostic ignored"-Wdeprecated-declarations"
+		#	endif
+			OSMemoryBarrier();
+		#	ifdef __APPLE__
+		#		pragma clang diagnostic pop
+		#	endif
+		#else
+			__sync_synchronize();
+		#endif
+		}
 	}
 }
 
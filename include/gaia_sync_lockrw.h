@@ -4,7 +4,7 @@
 #include "gaia_type.h"
 #include "gaia_assert.h"
 #include "gaia_sync_lock.h"
-#include "gaia_sync_lockfree.h"
+#include "gaia_sync_event.h"
 
 namespace GAIA
 {
@@ -12,40 +12,75 @@ namespace GAIA
 	{
 		/*!
 			@brief Sync recursive read write lock.
+
+			@remarks
+				The writer could enter read and write again.
+				A reader could enter write only when no other thread entered read after it, otherwise it will wait for itself.
+				The lock is not owned by the first reader, a thread left read will wait the other readers when it enter write.
 		*/
 		class LockRW : public GAIA::Base
 		{
 		public:
-			GINL LockRW(){m_nRCount = 0;}
+			GINL LockRW(){m_nRCount = 0; m_nWCount = 0; m_nWaitCount = 0; m_uReader = GINVALID; m_uWriter = GINVALID;}
 			GINL GAIA::GVOID EnterRead()
 			{
-				m_lockr.Enter();
+				GAIA::UM uThreadID = GAIA::THREAD::threadid();
+				m_lr.Enter();
 				{
+					while(m_uWriter != GINVALID && m_uWriter != uThreadID)
+						this->WaitChange();
 					GAST(m_nRCount >= 0);
 					if(m_nRCount == 0)
-						m_lockw.Enter();
+						m_uReader = uThreadID;
+					else if(m_uReader != uThreadID)
+						m_uReader = GINVALID;
 					m_nRCount++;
 				}
-				m_lockr.Leave();
+				m_lr.Leave();
 			}
 			GINL GAIA::GVOID LeaveRead()
 			{
-				m_lockr.Enter();
+				m_lr.Enter();
 				{
 					GAST(m_nRCount > 0);
 					--m_nRCount;
 					if(m_nRCount == 0)
-						m_lockw.Leave();
+					{
+						m_uReader = GINVALID;
+						this->FireChange();
+					}
 				}
-				m_lockr.Leave();
+				m_lr.Leave();
 			}
 			GINL GAIA::GVOID EnterWrite()
 			{
-				m_lockw.Enter();
+				GAIA::UM uThreadID = GAIA::THREAD::threadid();
+				m_lr.Enter();
+				{
+					if(m_uWriter != uThreadID)
+					{
+						while(m_uWriter != GINVALID || (m_nRCount != 0 && m_uReader != uThreadID))
+							this->WaitChange();
+						m_uWriter = uThreadID;
+					}
+					++m_nWCount;
+				}
+				m_lr.Leave();
 			}
 			GINL GAIA::GVOID LeaveWrite()
 			{
-				m_lockw.Leave();
+				m_lr.Enter();
+				{
+					GAST(m_nWCount > 0);
+					GAST(m_uWriter == GAIA::THREAD::threadid());
+					--m_nWCount;
+					if(m_nWCount == 0)
+					{
+						m_uWriter = GINVALID;
+						this->FireChange();
+					}
+				}
+				m_lr.Leave();
 			}
 
 			/*!
@@ -57,10 +92,28 @@ namespace GAIA
 			GINL GAIA::NM GetReaderCount() const{return m_nRCount;}
 		private:
 			GINL LockRW(const LockRW& src){}
+
+			// The m_lr must be locked, it is left while waiting.
+			GINL GAIA::GVOID WaitChange()
+			{
+				++m_nWaitCount;
+				m_lr.Leave();
+				m_evtChange.Wait((GAIA::U32)GINVALID);
+				m_lr.Enter();
+			}
+			GINL GAIA::GVOID FireChange()
+			{
+				for(; m_nWaitCount > 0; --m_nWaitCount)
+					m_evtChange.Fire();
+			}
 		private:
-			GAIA::SYNC::LockFree m_lockw;
-			GAIA::SYNC::Lock m_lockr;
+			GAIA::SYNC::Lock m_lr;
+			GAIA::SYNC::Event m_evtChange;
 			GAIA::NM m_nRCount;
+			GAIA::NM m_nWCount;
+			GAIA::NM m_nWaitCount;
+			GAIA::UM m_uReader;
+			GAIA::UM m_uWriter;
 		};
 	}
 }
@@ -0,0 +1,108 @@
+#ifndef		__GAIA_SYNC_TLS_H__
+#define		__GAIA_SYNC_TLS_H__
+
+#include "gaia_type.h"
+#include "gaia_assert.h"
+
+#if GAIA_OS == GAIA_OS_WINDOWS
+#	include <winsock2.h>
+#	include <ws2tcpip.h>
+#	include <windows.h>
+#	define GAIA_TLS_CALLBACK WINAPI
+#else
+#	include <pthread.h>
+#	define GAIA_TLS_CALLBACK
+#endif
+
+namespace GAIA
+{
+	namespace SYNC
+	{
+		/*!
+			@brief Thread local storage slot, every thread has it's own pointer in the slot.
+
+			@remarks
+				The release callback is called in the exiting thread when the pointer of the thread is not GNIL,
+				declare it as static GAIA::GVOID GAIA_TLS_CALLBACK OnRelease(GAIA::GVOID* p).
+				The fiber local storage is used in windows, because only it call back when the thread exit.
+				The slot not allocate memory, so it could be used by the heap.
+		*/
+		class TlsSlot : public GAIA::Base
+		{
+		public:
+			typedef GAIA::GVOID (GAIA_TLS_CALLBACK *ReleaseCallBack)(GAIA::GVOID* p);
+
+		public:
+			GINL TlsSlot(){m_bCreated = GAIA::False;}
+			GINL ~TlsSlot(){if(m_bCreated) this->Destroy();}
+
+			/*!
+				@brief Allocate the slot from OS.
+
+				@param pCallBack [in] Specify the callback called when a thread exit, it could be GNIL.
+			*/
+			GINL GAIA::BL Create(ReleaseCallBack pCallBack = GNIL)
+			{
+				GAST(!m_bCreated);
+				if(m_bCreated)
+					return GAIA::False;
+			#if GAIA_OS == GAIA_OS_WINDOWS
+				m_key = ::FlsAlloc(pCallBack);
+				if(m_key == FLS_OUT_OF_INDEXES)
+					return GAIA::False;
+			#else
+				if(pthread_key_create(&m_key, pCallBack) != 0)
+					return GAIA::False;
+			#endif
+				m_bCreated = GAIA::True;
+				return GAIA::True;
+			}
+
+			/*!
+				@brief Free the slot.
+
+				@remarks In windows the release callback is called for the pointers left in the slot, but not in other OS.
+			*/
+			GINL GAIA::GVOID Destroy()
+			{
+				GAST(m_bCreated);
+				if(!m_bCreated)
+					return;
+			#if GAIA_OS == GAIA_OS_WINDOWS
+				::FlsFree(m_key);
+			#else
+				pthread_key_delete(m_key);
+			#endif
+				m_bCreated = GAIA::False;
+			}
+			GINL GAIA::BL IsCreated() const{return m_bCreated;}
+			GINL GAIA::GVOID* Get() const
+			{
+			#if GAIA_OS == GAIA_OS_WINDOWS
+				return ::FlsGetValue(m_key);
+			#else
+				return pthread_getspecific(m_key);
+			#endif
+			}
+			GINL GAIA::GVOID Set(GAIA::GVOID* p)
+			{
+			#if GAIA_OS == GAIA_OS_WINDOWS
+				::FlsSetValue(m_key, p);
+			#else
+				pthread_setspecific(m_key, p);
+			#endif
+			}
+		private:
+			GINL TlsSlot(const TlsSlot& src){}
+		private:
+			GAIA::BL m_bCreated;
+		#if GAIA_OS == GAIA_OS_WINDOWS
+			DWORD m_key;
+		#else
+			pthread_key_t m_key;
+		#endif
+		};
+	}
+}
+
+#endif
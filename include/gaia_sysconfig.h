@@ -161,6 +161,16 @@
 #	define GAIA_MAX_UNSIGNED_INTEGER 0xFFFFFFFF
 #endif
 
+/* SIMD instruction set. */
+#ifndef __GAIA_NO_SIMD__
+#	if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#		define GAIA_SIMD_SSE2
+#	endif
+#	if defined(__AVX2__)
+#		define GAIA_SIMD_AVX2
+#	endif
+#endif
+
 /* Heap. */
 #ifndef __GAIA_NO_HEAP__
 #	define GAIA_HEAP
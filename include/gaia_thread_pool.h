@@ -3,12 +3,14 @@
 
 #include "gaia_type.h"
 #include "gaia_assert.h"
+#include "gaia_sync_base.h"
 #include "gaia_sync_atomic.h"
 #include "gaia_sync_lock.h"
 #include "gaia_sync_autolock.h"
 #include "gaia_sync_event.h"
 #include "gaia_ctn_vector.h"
 #include "gaia_ctn_queue.h"
+#include "gaia_algo_sort.h"
 #include "gaia_thread_base.h"
 #include "gaia_thread.h"
 
@@ -23,17 +25,506 @@ namespace GAIA
 			{
 				friend class ThreadPool;
 			public:
-				GINL Task(){m_uGroupIndex = GINVALID;}
+				GINL Task(){m_uGroupIndex = GINVALID; m_bOrdered = GAIA::False;}
 				virtual GAIA::GVOID Run() = 0;
 				GINL GAIA::GVOID SetGroupIndex(GAIA::U32 uGroupIndex){m_uGroupIndex = uGroupIndex;}
 				GINL GAIA::U32 GetGroupIndex() const{return m_uGroupIndex;}
+
+				/*!
+					@brief Specify the task must be executed in push order with the other ordered tasks of the same group.
+
+					@remarks
+						Only used by ThreadPool::SCHEDULE_MODE_STEAL, an ordered task is pinned to the work thread
+						selected by it's group index and never been stolen.
+						In ThreadPool::SCHEDULE_MODE_STATIC every task is pinned by it's group index.
+				*/
+				GINL GAIA::GVOID SetOrdered(GAIA::BL bOrdered){m_bOrdered = bOrdered;}
+				GINL GAIA::BL IsOrdered() const{return m_bOrdered;}
 				GINL GAIA::GVOID Wait(){m_event.Wait((GAIA::U32)GINVALID);}
 			private:
 				GINL GAIA::GVOID FireComplete(){m_event.Fire();}
 			private:
 				GAIA::U32 m_uGroupIndex;
 				GAIA::SYNC::Event m_event;
+				GAIA::U8 m_bOrdered : 1;
+			};
+		private:
+			/*!
+				@brief Lock free work stealing deque(Chase-Lev).
+
+				@remarks
+					Only the owner thread can call push_back and pop_back, any thread can call steal.
+			*/
+			class TaskDeque : public GAIA::Base
+			{
+			public:
+				GINL TaskDeque(){this->init();}
+				GINL ~TaskDeque(){this->destroy();}
+				GINL GAIA::BL empty() const{return m_bottom <= m_top;}
+				GINL GAIA::GVOID push_back(GAIA::THREAD::ThreadPool::Task* pTask)
+				{
+					GAIA::N64 b = m_bottom;
+					GAIA::N64 t = m_top;
+					Buffer* pBuffer = m_pBuffer;
+					if(b - t >= pBuffer->capacity - 1)
+						pBuffer = this->grow(pBuffer, b, t);
+					pBuffer->p[b & (pBuffer->capacity - 1)] = pTask;
+					GAIA::SYNC::gmembarrier();
+					m_bottom = b + 1;
+				}
+				GINL GAIA::THREAD::ThreadPool::Task* pop_back()
+				{
+					GAIA::N64 b = m_bottom - 1;
+					Buffer* pBuffer = m_pBuffer;
+					m_bottom = b;
+					GAIA::SYNC::gmembarrier();
+					GAIA::N64 t = m_top;
+					if(t > b)
+					{
+						m_bottom = b + 1;
+						return GNIL;
+					}
+					GAIA::THREAD::ThreadPool::Task* pTask = pBuffer->p[b & (pBuffer->capacity - 1)];
+					if(t == b)
+					{
+						// Last element, race with the thieves.
+						if(!TaskDeque::cas(&m_top, t, t + 1))
+							pTask = GNIL;
+						m_bottom = b + 1;
+					}
+					return pTask;
+				}
+				GINL GAIA::THREAD::ThreadPool::Task* steal()
+				{
+					GAIA::N64 t = m_top;
+					GAIA::SYNC::gmembarrier();
+					GAIA::N64 b = m_bottom;
+					if(t >= b)
+						return GNIL;
+					Buffer* pBuffer = m_pBuffer;
+					GAIA::THREAD::ThreadPool::Task* pTask = pBuffer->p[t & (pBuffer->capacity - 1)];
+					if(!TaskDeque::cas(&m_top, t, t + 1))
+						return GNIL;
+					return pTask;
+				}
+				static GINL GAIA::BL cas(volatile GAIA::N64* p, GAIA::N64 oldvalue, GAIA::N64 newvalue)
+				{
+				#if GAIA_OS == GAIA_OS_WINDOWS
+					return InterlockedCompareExchange64(p, newvalue, oldvalue) == oldvalue;
+				#elif GAIA_OS == GAIA_OS_OSX || GAIA_OS == GAIA_OS_IOS
+					return OSAtomicCompareAndSwap64Barrier(oldvalue, newvalue, p);
+				#else
+					return __sync_bool_compare_and_swap(p, oldvalue, newvalue);
+				#endif
+				}
+			private:
+				class Buffer : public GAIA::Base
+				{
+				public:
+					GAIA::N64 capacity;
+					GAIA::THREAD::ThreadPool::Task** p;
+				};
+			private:
+				GINL GAIA::GVOID init()
+				{
+					m_top = 0;
+					m_bottom = 0;
+					m_pBuffer = gnew Buffer;
+					m_pBuffer->capacity = 64;
+					m_pBuffer->p = gnew GAIA::THREAD::ThreadPool::Task*[64];
+				}
+				GINL GAIA::GVOID destroy()
+				{
+					Buffer* pCurrent = m_pBuffer;
+					m_retired.push_back(pCurrent);
+					for(__BufferListType::it it = m_retired.frontit(); !it.empty(); ++it)
+					{
+						Buffer* pBuffer = *it;
+						gdel[] pBuffer->p;
+						gdel pBuffer;
+					}
+					m_retired.clear();
+					m_pBuffer = GNIL;
+				}
+				GINL Buffer* grow(Buffer* pOld, GAIA::N64 b, GAIA::N64 t)
+				{
+					Buffer* pNew = gnew Buffer;
+					pNew->capacity = pOld->capacity * 2;
+					pNew->p = gnew GAIA::THREAD::ThreadPool::Task*[pNew->capacity];
+					for(GAIA::N64 x = t; x < b; ++x)
+						pNew->p[x & (pNew->capacity - 1)] = pOld->p[x & (pOld->capacity - 1)];
+					GAIA::SYNC::gmembarrier();
+					m_pBuffer = pNew;
+
+					// The thieves maybe reading the old buffer, release it when the deque destruct.
+					m_retired.push_back(pOld);
+					return pNew;
+				}
+			private:
+				typedef GAIA::CTN::Vector<Buffer*> __BufferListType;
+			private:
+				volatile GAIA::N64 m_top;
+				volatile GAIA::N64 m_bottom;
+				Buffer* volatile m_pBuffer;
+				__BufferListType m_retired;
+			};
+
+			/*!
+				@brief Lock free task inbox, any thread can push and take.
+
+				@remarks
+					The tasks are always taken all at once, so the head is only swapped with GNIL and there is no ABA problem.
+					A node is created for every push, because a task could be pushed again before it executed.
+			*/
+			class TaskInbox : public GAIA::Base
+			{
+			public:
+				class Node : public GAIA::Base
+				{
+				public:
+					GAIA::THREAD::ThreadPool::Task* pTask;
+					Node* pNext;
+				};
+			public:
+				GINL TaskInbox(){m_pHead = GNIL;}
+				GINL ~TaskInbox(){GAST(m_pHead == GNIL);}
+				GINL GAIA::BL empty() const{return m_pHead == GNIL;}
+				GINL GAIA::GVOID push(GAIA::THREAD::ThreadPool::Task* pTask)
+				{
+					Node* pNode = gnew Node;
+					pNode->pTask = pTask;
+					for(;;)
+					{
+						Node* pHead = m_pHead;
+						pNode->pNext = pHead;
+						if(TaskInbox::cas(&m_pHead, pHead, pNode))
+							break;
+					}
+				}
+
+				/*!
+					@brief Take all the tasks.
+
+					@return Return the first node in push order, or GNIL if the inbox is empty.
+						The nodes are owned by the caller, and must be released by gdel.
+				*/
+				GINL Node* take()
+				{
+					Node* pHead;
+					for(;;)
+					{
+						pHead = m_pHead;
+						if(pHead == GNIL)
+							return GNIL;
+						if(TaskInbox::cas(&m_pHead, pHead, GNIL))
+							break;
+					}
+					Node* pFirst = GNIL;
+					while(pHead != GNIL)
+					{
+						Node* pNext = pHead->pNext;
+						pHead->pNext = pFirst;
+						pFirst = pHead;
+						pHead = pNext;
+					}
+					return pFirst;
+				}
+			private:
+				static GINL GAIA::BL cas(Node* volatile* p, Node* oldvalue, Node* newvalue)
+				{
+				#if GAIA_OS == GAIA_OS_WINDOWS
+					return InterlockedCompareExchangePointer((PVOID volatile*)p, newvalue, oldvalue) == oldvalue;
+				#elif GAIA_OS == GAIA_OS_OSX || GAIA_OS == GAIA_OS_IOS
+					return OSAtomicCompareAndSwapPtrBarrier(oldvalue, newvalue, (GAIA::GVOID* volatile*)p);
+				#else
+					return __sync_bool_compare_and_swap(p, oldvalue, newvalue);
+				#endif
+				}
+			private:
+				Node* volatile m_pHead;
+			};
+
+			class ParallelJob;
+
+			/*!
+				@brief A sub range of ThreadPool::ParallelFor or ThreadPool::ParallelReduce.
+
+				@remarks
+					The task is pushed to the work threads and to the pending list of it's job at the same time,
+					whoever claim it first(a work thread or the joining thread) execute it, the other one just release it.
+			*/
+			class ParallelRangeTask : public GAIA::THREAD::ThreadPool::Task
+			{
+			public:
+				GINL ParallelRangeTask(ParallelJob& job, GAIA::NUM sBegin, GAIA::NUM sEnd)
+				{
+					m_pJob = &job;
+					m_pJob->rise_ref();
+					m_sBegin = sBegin;
+					m_sEnd = sEnd;
+					m_nClaimed = 0;
+				}
+				GINL ~ParallelRangeTask(){m_pJob->drop_ref();}
+				virtual GAIA::GVOID Run()
+				{
+					if(!TaskDeque::cas(&m_nClaimed, 0, 1))
+						return;
+					m_pJob->Execute(m_sBegin, m_sEnd);
+					m_pJob->Finish();
+				}
+			private:
+				ParallelJob* m_pJob;
+				GAIA::NUM m_sBegin;
+				GAIA::NUM m_sEnd;
+				volatile GAIA::N64 m_nClaimed;
+			};
+
+			/*!
+				@brief The shared state of a ThreadPool::ParallelFor or ThreadPool::ParallelReduce call.
+			*/
+			class ParallelJob : public GAIA::RefObject
+			{
+			public:
+				GINL ParallelJob(GAIA::THREAD::ThreadPool& pool, GAIA::NUM sGrain)
+				{
+					m_pPool = &pool;
+					m_sGrain = sGrain;
+					m_remain = 1; // The root range executed by the joining thread.
+				}
+				GINL ~ParallelJob()
+				{
+					for(; !m_pending.empty(); m_pending.pop_back())
+						m_pending.back()->drop_ref();
+				}
+
+				/*!
+					@brief Split the range by half until it is not bigger than the grain, the right halves are spawned
+						and the left most one is executed by current thread.
+				*/
+				GINL GAIA::GVOID Execute(GAIA::NUM sBegin, GAIA::NUM sEnd)
+				{
+					while(sEnd - sBegin > m_sGrain)
+					{
+						GAIA::NUM sMiddle = sBegin + (sEnd - sBegin) / 2;
+						this->Spawn(sMiddle, sEnd);
+						sEnd = sMiddle;
+					}
+					this->ExecuteRange(sBegin, sEnd);
+				}
+				GINL GAIA::GVOID Finish()
+				{
+					if(m_remain.Decrease() == 0)
+						m_event.Fire();
+				}
+
+				/*!
+					@brief Help to execute the pending ranges until all the ranges complete.
+
+					@remarks
+						Only block when the remaining ranges are executing by the other threads,
+						every spawned range and the last finished one wake the joining thread.
+				*/
+				GINL GAIA::GVOID Join()
+				{
+					for(;;)
+					{
+						GAIA::THREAD::ThreadPool::ParallelRangeTask* pTask = this->PopPending();
+						if(pTask != GNIL)
+						{
+							pTask->Run();
+							pTask->drop_ref();
+							continue;
+						}
+						if((GAIA::N64)m_remain == 0)
+							break;
+						m_event.Wait((GAIA::U32)GINVALID);
+					}
+				}
+			protected:
+				virtual GAIA::GVOID ExecuteRange(GAIA::NUM sBegin, GAIA::NUM sEnd) = 0;
+			private:
+				GINL GAIA::GVOID Spawn(GAIA::NUM sBegin, GAIA::NUM sEnd)
+				{
+					m_remain.Increase();
+					GAIA::THREAD::ThreadPool::ParallelRangeTask* pTask = gnew GAIA::THREAD::ThreadPool::ParallelRangeTask(*this, sBegin, sEnd);
+					{
+						GAIA::SYNC::Autolock al(m_lrPending);
+						pTask->rise_ref();
+						m_pending.push_back(pTask);
+					}
+					m_event.Fire();
+					m_pPool->SpawnTask(*pTask);
+					pTask->drop_ref();
+				}
+				GINL GAIA::THREAD::ThreadPool::ParallelRangeTask* PopPending()
+				{
+					GAIA::SYNC::Autolock al(m_lrPending);
+					if(m_pending.empty())
+						return GNIL;
+					GAIA::THREAD::ThreadPool::ParallelRangeTask* pTask = m_pending.back();
+					m_pending.pop_back();
+					return pTask;
+				}
+			private:
+				typedef GAIA::CTN::Vector<GAIA::THREAD::ThreadPool::ParallelRangeTask*> __TaskListType;
+			private:
+				GAIA::THREAD::ThreadPool* m_pPool;
+				GAIA::NUM m_sGrain;
+				GAIA::SYNC::Atomic m_remain;
+				GAIA::SYNC::Event m_event;
+				GAIA::SYNC::Lock m_lrPending;
+				__TaskListType m_pending;
+			};
+
+			template<typename _FuncType> class ParallelForJob : public ParallelJob
+			{
+			public:
+				GINL ParallelForJob(GAIA::THREAD::ThreadPool& pool, GAIA::NUM sGrain, _FuncType& func) : ParallelJob(pool, sGrain), m_func(func){}
+			protected:
+				virtual GAIA::GVOID ExecuteRange(GAIA::NUM sBegin, GAIA::NUM sEnd){m_func(sBegin, sEnd);}
+			private:
+				_FuncType& m_func;
+			};
+
+			template<typename _DataType, typename _FuncType, typename _JoinType> class ParallelReduceJob : public ParallelJob
+			{
+			public:
+				GINL ParallelReduceJob(GAIA::THREAD::ThreadPool& pool, GAIA::NUM sGrain, const _DataType& identity, _FuncType& func, _JoinType& join)
+					: ParallelJob(pool, sGrain), m_result(identity), m_func(func), m_join(join){}
+				GINL const _DataType& GetResult() const{return m_result;}
+			protected:
+				virtual GAIA::GVOID ExecuteRange(GAIA::NUM sBegin, GAIA::NUM sEnd)
+				{
+					_DataType t = m_func(sBegin, sEnd);
+					GAIA::SYNC::Autolock al(m_lrResult);
+					m_result = m_join(m_result, t);
+				}
+			private:
+				_DataType m_result;
+				_FuncType& m_func;
+				_JoinType& m_join;
+				GAIA::SYNC::Lock m_lrResult;
+			};
+
+			/*!
+				@brief Sort the blocks of sGrain elements, it is the functor of ThreadPool::ParallelFor by block index.
+			*/
+			template<typename _DataType> class ParallelSortFunc : public GAIA::Base
+			{
+			public:
+				GINL ParallelSortFunc(_DataType* p, GAIA::NUM sSize, GAIA::NUM sGrain){m_p = p; m_sSize = sSize; m_sGrain = sGrain;}
+				GINL GAIA::GVOID operator () (GAIA::NUM sBegin, GAIA::NUM sEnd) const
+				{
+					for(GAIA::NUM x = sBegin; x < sEnd; ++x)
+					{
+						GAIA::N64 nFirst = GSCAST(GAIA::N64)(x) * m_sGrain;
+						GAIA::N64 nLast = GAIA::ALGO::gmin(nFirst + m_sGrain, GSCAST(GAIA::N64)(m_sSize)) - 1;
+						GAIA::ALGO::sort(m_p + nFirst, m_p + nLast);
+					}
+				}
+			private:
+				_DataType* m_p;
+				GAIA::NUM m_sSize;
+				GAIA::NUM m_sGrain;
+			};
+
+			/*!
+				@brief Merge the sorted runs of sWidth elements by pairs, it is the functor of ThreadPool::ParallelFor by output block index.
+
+				@remarks
+					A output block may be in the middle of a pair, it's begin and end are found in the both runs by binary search,
+					so the last passes which have few pairs are parallel too. The equal elements of the left run are output first.
+			*/
+			template<typename _DataType> class ParallelMergeFunc : public GAIA::Base
+			{
+			public:
+				GINL ParallelMergeFunc(const _DataType* pSrc, _DataType* pDst, GAIA::NUM sSize, GAIA::NUM sWidth, GAIA::NUM sGrain)
+				{
+					m_pSrc = pSrc;
+					m_pDst = pDst;
+					m_sSize = sSize;
+					m_sWidth = sWidth;
+					m_sGrain = sGrain;
+				}
+				GINL GAIA::GVOID operator () (GAIA::NUM sBegin, GAIA::NUM sEnd) const
+				{
+					GAIA::N64 nOutBegin = GSCAST(GAIA::N64)(sBegin) * m_sGrain;
+					GAIA::N64 nOutEnd = GAIA::ALGO::gmin(GSCAST(GAIA::N64)(sEnd) * m_sGrain, GSCAST(GAIA::N64)(m_sSize));
+					while(nOutBegin < nOutEnd)
+					{
+						GAIA::N64 nPairBegin = nOutBegin / (m_sWidth * 2) * (m_sWidth * 2);
+						GAIA::N64 nMiddle = GAIA::ALGO::gmin(nPairBegin + m_sWidth, GSCAST(GAIA::N64)(m_sSize));
+						GAIA::N64 nPairEnd = GAIA::ALGO::gmin(nPairBegin + m_sWidth * 2, GSCAST(GAIA::N64)(m_sSize));
+						GAIA::N64 nPartEnd = GAIA::ALGO::gmin(nOutEnd, nPairEnd);
+						const _DataType* pA = m_pSrc + nPairBegin;
+						const _DataType* pB = m_pSrc + nMiddle;
+						GAIA::NUM sSizeA = GSCAST(GAIA::NUM)(nMiddle - nPairBegin);
+						GAIA::NUM sSizeB = GSCAST(GAIA::NUM)(nPairEnd - nMiddle);
+						GAIA::NUM sA = this->corank(GSCAST(GAIA::NUM)(nOutBegin - nPairBegin), pA, sSizeA, pB, sSizeB);
+						GAIA::NUM sB = GSCAST(GAIA::NUM)(nOutBegin - nPairBegin) - sA;
+						GAIA::NUM sAEnd = this->corank(GSCAST(GAIA::NUM)(nPartEnd - nPairBegin), pA, sSizeA, pB, sSizeB);
+						GAIA::NUM sBEnd = GSCAST(GAIA::NUM)(nPartEnd - nPairBegin) - sAEnd;
+						_DataType* pDst = m_pDst + nOutBegin;
+						while(sA < sAEnd && sB < sBEnd)
+						{
+							if(pB[sB] < pA[sA])
+								*pDst++ = pB[sB++];
+							else
+								*pDst++ = pA[sA++];
+						}
+						while(sA < sAEnd)
+							*pDst++ = pA[sA++];
+						while(sB < sBEnd)
+							*pDst++ = pB[sB++];
+						nOutBegin = nPartEnd;
+					}
+				}
+			private:
+				/*!
+					@brief Find the count of the elements of pA in the first sK merged elements.
+				*/
+				GINL GAIA::NUM corank(GAIA::NUM sK, const _DataType* pA, GAIA::NUM sSizeA, const _DataType* pB, GAIA::NUM sSizeB) const
+				{
+					GAIA::NUM sLow = GAIA::ALGO::gmax(0, sK - sSizeB);
+					GAIA::NUM sHigh = GAIA::ALGO::gmin(sK, sSizeA);
+					while(sLow < sHigh)
+					{
+						GAIA::NUM sA = sLow + (sHigh - sLow) / 2;
+						GAIA::NUM sB = sK - sA;
+
+						// pA[sA] is output before pB[sB - 1], so it is in the first sK elements.
+						if(sB > 0 && !(pB[sB - 1] < pA[sA]))
+							sLow = sA + 1;
+						else
+							sHigh = sA;
+					}
+					return sLow;
+				}
+			private:
+				const _DataType* m_pSrc;
+				_DataType* m_pDst;
+				GAIA::NUM m_sSize;
+				GAIA::NUM m_sWidth;
+				GAIA::NUM m_sGrain;
+			};
+
+			template<typename _DataType> class ParallelCopyFunc : public GAIA::Base
+			{
+			public:
+				GINL ParallelCopyFunc(const _DataType* pSrc, _DataType* pDst, GAIA::NUM sSize, GAIA::NUM sGrain){m_pSrc = pSrc; m_pDst = pDst; m_sSize = sSize; m_sGrain = sGrain;}
+				GINL GAIA::GVOID operator () (GAIA::NUM sBegin, GAIA::NUM sEnd) const
+				{
+					GAIA::N64 nLast = GAIA::ALGO::gmin(GSCAST(GAIA::N64)(sEnd) * m_sGrain, GSCAST(GAIA::N64)(m_sSize));
+					for(GAIA::N64 x = GSCAST(GAIA::N64)(sBegin) * m_sGrain; x < nLast; ++x)
+						m_pDst[x] = m_pSrc[x];
+				}
+			private:
+				const _DataType* m_pSrc;
+				_DataType* m_pDst;
+				GAIA::NUM m_sSize;
+				GAIA::NUM m_sGrain;
 			};
+		public:
 			class WorkThread : public GAIA::THREAD::Thread
 			{
 				friend class ThreadPool;
@@ -47,15 +538,27 @@ namespace GAIA
 				~WorkThread(){this->destruct();}
 				GINL GAIA::GVOID SetStopCmd(STOP_TYPE stoptype){m_stoptype = stoptype;}
 				GINL STOP_TYPE GetStopCmd() const{return m_stoptype;}
-				GINL GAIA::GVOID BeginPushTask(){m_lrTaskQueue.Enter();}
-				GINL GAIA::GVOID EndPushTask(){m_lrTaskQueue.Leave();}
 				GINL GAIA::GVOID FireTask(){m_event.Fire();}
 				GINL GAIA::GVOID PushTask(GAIA::THREAD::ThreadPool::Task& task)
 				{
 					task.rise_ref();
+					if(m_pPool->GetScheduleMode() == GAIA::THREAD::ThreadPool::SCHEDULE_MODE_STEAL && !task.IsOrdered())
+					{
+						m_taskinbox.push(&task);
+						return;
+					}
+					GAIA::SYNC::Autolock al(m_lrTaskQueue);
 					m_taskqueue.push_back(&task);
 				}
 				virtual GAIA::GVOID Run()
+				{
+					m_uThreadID = GAIA::THREAD::threadid();
+					if(m_pPool->GetScheduleMode() == GAIA::THREAD::ThreadPool::SCHEDULE_MODE_STEAL)
+						this->RunSteal();
+					else
+						this->RunStatic();
+				}
+				GINL GAIA::GVOID RunStatic()
 				{
 					for(;;)
 					{
@@ -88,10 +591,120 @@ namespace GAIA
 							break;
 					}
 				}
+				GINL GAIA::GVOID RunSteal()
+				{
+					for(;;)
+					{
+						// If the ThreadPool want stop, stop it.
+						STOP_TYPE stoptype = this->GetStopCmd();
+						if(stoptype == STOP_TYPE_IMMEDIATELY)
+							break;
+
+						// Ordered tasks to swapqueue, the inbox tasks to the stealable deque.
+						this->SwapTaskQueue();
+
+						// Do swapqueue first, then local deque, then steal from the other work threads.
+						GAIA::THREAD::ThreadPool::Task* pTask = GNIL;
+						if(!m_taskqueueswap.empty())
+						{
+							pTask = m_taskqueueswap.front();
+							m_taskqueueswap.pop_front();
+						}
+						else
+							pTask = m_taskdeque.pop_back();
+						if(pTask == GNIL)
+							pTask = m_pPool->StealTask(*this);
+						if(pTask != GNIL)
+						{
+							m_pPool->ExecuteTask(*pTask);
+							continue;
+						}
+
+						if(stoptype == STOP_TYPE_WAITCOMPLETE && m_pPool->IsTaskComplete())
+							break;
+
+						// Mark idle before check again, so the work thread which push new task will fire this thread.
+						m_bIdle = GAIA::True;
+						GAIA::SYNC::gmembarrier();
+						if(!this->IsTaskQueueEmpty() || m_pPool->IsStealable(*this))
+						{
+							m_bIdle = GAIA::False;
+							continue;
+						}
+						m_event.Wait((GAIA::U32)GINVALID);
+						m_bIdle = GAIA::False;
+					}
+				}
+				GINL GAIA::GVOID SwapTaskQueue()
+				{
+					{
+						GAIA::SYNC::Autolock al(m_lrTaskQueue);
+						for(; !m_taskqueue.empty(); m_taskqueue.pop_front())
+							m_taskqueueswap.push_back(m_taskqueue.front());
+					}
+					if(this->MoveInbox(m_taskinbox.take()) > 1)
+						m_pPool->FireIdleThread(*this);
+				}
+				GINL GAIA::BL IsTaskQueueEmpty()
+				{
+					if(!m_taskinbox.empty())
+						return GAIA::False;
+					GAIA::SYNC::Autolock al(m_lrTaskQueue);
+					return m_taskqueue.empty();
+				}
+
+				/*!
+					@brief Steal the tasks which are pushed to this work thread but not moved to the deque yet.
+
+					@param thief [in] Specify the current work thread, the stolen tasks except the returned one are moved to it's deque.
+
+					@remarks
+						The inbox is only moved to the deque when the owner finish it's current task,
+						so the tasks pushed to a busy work thread are stolen from here.
+				*/
+				GINL GAIA::THREAD::ThreadPool::Task* StealInbox(GAIA::THREAD::ThreadPool::WorkThread& thief)
+				{
+					TaskInbox::Node* pNode = m_taskinbox.take();
+					if(pNode == GNIL)
+						return GNIL;
+					GAIA::THREAD::ThreadPool::Task* pTask = pNode->pTask;
+					TaskInbox::Node* pNext = pNode->pNext;
+					gdel pNode;
+					if(thief.MoveInbox(pNext) > 1)
+						m_pPool->FireIdleThread(thief);
+					return pTask;
+				}
+				GINL GAIA::BL IsTaskInboxEmpty() const{return m_taskinbox.empty();}
+				GINL GAIA::BL IsIdle() const{return m_bIdle;}
 			private:
-				GINL GAIA::GVOID init(){m_stoptype = STOP_TYPE_INVALID;}
+				// Only called by the work thread itself, because it push to the deque.
+				GINL GAIA::NUM MoveInbox(TaskInbox::Node* pNode)
+				{
+					GAIA::NUM sCount = 0;
+					while(pNode != GNIL)
+					{
+						TaskInbox::Node* pNext = pNode->pNext;
+						m_taskdeque.push_back(pNode->pTask);
+						gdel pNode;
+						pNode = pNext;
+						++sCount;
+					}
+					return sCount;
+				}
+				GINL GAIA::GVOID init()
+				{
+					m_pPool = GNIL;
+					m_sIndex = 0;
+					m_uStealSeed = 0;
+					m_uThreadID = 0;
+					m_bIdle = GAIA::False;
+					m_stoptype = STOP_TYPE_INVALID;
+				}
 				GINL GAIA::GVOID destruct()
 				{
+					this->MoveInbox(m_taskinbox.take());
+					for(GAIA::THREAD::ThreadPool::Task* pTask = m_taskdeque.pop_back(); pTask != GNIL; pTask = m_taskdeque.pop_back())
+						pTask->drop_ref();
 					GAIA::SYNC::Autolock al(m_lrTaskQueue);
 					for(; !m_taskqueue.empty(); m_taskqueue.pop_front())
 					{
@@ -109,12 +722,24 @@ namespace GAIA
 			private:
 				typedef GAIA::CTN::Queue<GAIA::THREAD::ThreadPool::Task*> __TaskQueueType;
 			private:
+				GAIA::THREAD::ThreadPool* m_pPool;
+				GAIA::NUM m_sIndex;
+				GAIA::U32 m_uStealSeed;
+				volatile GAIA::UM m_uThreadID;
 				GAIA::SYNC::Lock m_lrTaskQueue;
 				GAIA::SYNC::Event m_event;
 				__TaskQueueType m_taskqueue;
 				__TaskQueueType m_taskqueueswap;
+				TaskInbox m_taskinbox; // The not ordered tasks of SCHEDULE_MODE_STEAL, they could be stolen before moved to the deque.
+				TaskDeque m_taskdeque;
+				volatile GAIA::BL m_bIdle;
 				STOP_TYPE m_stoptype;
 			};
+		public:
+			GAIA_ENUM_BEGIN(SCHEDULE_MODE)
+				SCHEDULE_MODE_STATIC, // Every task is pinned to the work thread selected by it's group index.
+				SCHEDULE_MODE_STEAL, // Idle work thread steal the not ordered tasks from the busy ones.
+			GAIA_ENUM_END(SCHEDULE_MODE)
 		public:
 			GINL ThreadPool()
 			{
@@ -138,6 +763,14 @@ namespace GAIA
 			{
 				return m_threads.size();
 			}
+			GINL GAIA::BL SetScheduleMode(SCHEDULE_MODE mode)
+			{
+				if(this->IsBegin())
+					return GAIA::False;
+				m_schedulemode = mode;
+				return GAIA::True;
+			}
+			GINL SCHEDULE_MODE GetScheduleMode() const{return m_schedulemode;}
 			GINL GAIA::GVOID SetStackSize(GAIA::NUM size){m_uStackSize = size;}
 			GINL GAIA::NUM GetStackSize() const{return m_uStackSize;}
 			GINL GAIA::BL Begin()
@@ -147,13 +780,21 @@ namespace GAIA
 				GAST(this->GetThreadCount() != 0);
 				if(this->GetThreadCount() == 0)
 					return GAIA::False;
+				m_nextthreadindex = 0;
+				m_pending = 0;
+				GAIA::NUM sIndex = 0;
 				for(__ThreadListType::it it = m_threads.frontit(); !it.empty(); ++it)
 				{
 					GAIA::THREAD::ThreadPool::WorkThread* pThread = gnew GAIA::THREAD::ThreadPool::WorkThread;
+					pThread->m_pPool = this;
+					pThread->m_sIndex = sIndex++;
 					*it = pThread;
 					pThread->SetStackSize(m_uStackSize);
-					pThread->Start();
 				}
+
+				// Start after all work threads created, because the thief will visit every work thread.
+				for(__ThreadListType::it it = m_threads.frontit(); !it.empty(); ++it)
+					(*it)->Start();
 				m_bBegin = GAIA::True;
 				return GAIA::True;
 			}
@@ -178,18 +819,23 @@ namespace GAIA
 					GAIA::THREAD::ThreadPool::WorkThread* pThread = *it;
 					GAST(pThread != GNIL);
 					pThread->Wait();
-					gdel pThread;
+				}
+
+				// Release after all work threads exit, because the thief will visit every work thread.
+				for(__ThreadListType::it it = m_threads.frontit(); !it.empty(); ++it)
+				{
+					gdel *it;
 					*it = GNIL;
 				}
-				m_uLastGroupIndex = 0;
+				m_lastgroupindex = 0;
+				m_pending = 0;
 				m_bBegin = GAIA::False;
 				return GAIA::True;
 			}
 			GINL GAIA::BL IsBegin() const{return m_bBegin;}
 			GINL GAIA::U32 ReserveGroupIndex()
 			{
-				GAIA::SYNC::Autolock al(m_lrTaskQueue);
-				GAIA::U32 uGroupIndex = m_uLastGroupIndex++;
+				GAIA::U32 uGroupIndex = GSCAST(GAIA::U32)(m_lastgroupindex++);
 				if(uGroupIndex == GINVALID)
 					uGroupIndex = 0;
 				return uGroupIndex;
@@ -204,14 +850,12 @@ namespace GAIA
 			{
 				task.rise_ref();
 				GAIA::U32 uGroupIndex = task.GetGroupIndex();
-				GAIA::SYNC::Autolock al(m_lrTaskQueue);
 				if(uGroupIndex == GINVALID)
 				{
-					uGroupIndex = m_uLastGroupIndex++;
-					if(uGroupIndex == GINVALID)
-						uGroupIndex = 0;
+					uGroupIndex = this->ReserveGroupIndex();
 					task.SetGroupIndex(uGroupIndex);
 				}
+				GAIA::SYNC::Autolock al(m_lrTaskQueue);
 				m_taskqueue.push_back(&task);
 				return uGroupIndex;
 			}
@@ -228,16 +872,14 @@ namespace GAIA
 					GAIA::THREAD::ThreadPool::Task* pTask = m_taskqueue.front();
 					GAST(pTask != GNIL);
 					m_taskqueue.pop_front();
-					GAIA::U32 uThreadIndex = pTask->GetGroupIndex() % m_threads.size();
-					GAIA::THREAD::ThreadPool::WorkThread* pThread = m_threads[uThreadIndex];
+					GAIA::THREAD::ThreadPool::WorkThread* pThread = this->SelectThread(*pTask);
 					GAST(pThread != GNIL);
-					pThread->BeginPushTask();
-					{
-						pThread->PushTask(*pTask);
-						pTask->drop_ref();
-					}
-					pThread->EndPushTask();
+					GAIA::BL bStealable = m_schedulemode == SCHEDULE_MODE_STEAL && !pTask->IsOrdered();
+					pThread->PushTask(*pTask);
+					pTask->drop_ref();
 					pThread->FireTask();
+					if(bStealable)
+						this->FireThiefThread(*pThread);
 				}
 				return GAIA::True;
 			}
@@ -249,29 +891,142 @@ namespace GAIA
 				GAIA::U32 uGroupIndex = task.GetGroupIndex();
 				if(uGroupIndex == GINVALID)
 				{
-					GAIA::SYNC::Autolock al(m_lrTaskQueue);
-					uGroupIndex = m_uLastGroupIndex++;
-					if(uGroupIndex == GINVALID)
-						uGroupIndex = 0;
+					uGroupIndex = this->ReserveGroupIndex();
 					task.SetGroupIndex(uGroupIndex);
 				}
 
-				GAIA::U32 uThreadIndex = uGroupIndex % m_threads.size();
-				GAIA::THREAD::ThreadPool::WorkThread* pThread = m_threads[uThreadIndex];
+				GAIA::THREAD::ThreadPool::WorkThread* pThread = this->SelectThread(task);
 				GAST(pThread != GNIL);
-				pThread->BeginPushTask();
-				{
-					pThread->PushTask(task);
-				}
-				pThread->EndPushTask();
+				GAIA::BL bStealable = m_schedulemode == SCHEDULE_MODE_STEAL && !task.IsOrdered();
+				pThread->PushTask(task);
 				pThread->FireTask();
+				if(bStealable)
+					this->FireThiefThread(*pThread);
 				return uGroupIndex;
 			}
+
+			/*!
+				@brief Execute func on the sub ranges of [sBegin, sEnd) in parallel, and return after all sub ranges complete.
+
+				@param sBegin [in] Specify the begin of the range.
+
+				@param sEnd [in] Specify the end of the range, not included.
+
+				@param sGrain [in] Specify the max size of a sub range, the range is splitted by half recursively until not bigger than it.
+
+				@param func [in] Specify the functor called as func(sSubBegin, sSubEnd), it will be called by multi threads at the same time.
+
+				@remarks
+					The calling thread execute the sub ranges too and only block when all the remaining sub ranges are executing
+					by the work threads, so it could be called in a task of the same thread pool.
+					If the thread pool is not begin, the whole range is executed by the calling thread.
+			*/
+			template<typename _FuncType> GAIA::GVOID ParallelFor(GAIA::NUM sBegin, GAIA::NUM sEnd, GAIA::NUM sGrain, _FuncType& func)
+			{
+				if(sEnd <= sBegin)
+					return;
+				if(sGrain < 1)
+					sGrain = 1;
+				if(!this->IsBegin() || sEnd - sBegin <= sGrain)
+				{
+					func(sBegin, sEnd);
+					return;
+				}
+				ParallelForJob<_FuncType>* pJob = gnew ParallelForJob<_FuncType>(*this, sGrain, func);
+				pJob->Execute(sBegin, sEnd);
+				pJob->Finish();
+				pJob->Join();
+				pJob->drop_ref();
+			}
+
+			/*!
+				@brief Reduce the sub ranges of [sBegin, sEnd) in parallel.
+
+				@param sBegin [in] Specify the begin of the range.
+
+				@param sEnd [in] Specify the end of the range, not included.
+
+				@param sGrain [in] Specify the max size of a sub range, see ThreadPool::ParallelFor.
+
+				@param identity [in] Specify the identity value of join, it is the result of a empty range.
+
+				@param func [in] Specify the functor called as func(sSubBegin, sSubEnd) and return the partial result of the sub range.
+
+				@param join [in] Specify the functor called as join(a, b) and return the combined result.
+					The partial results are combined in completion order, so join must be associative and commutative.
+
+				@return Return the combined result of all sub ranges.
+			*/
+			template<typename _DataType, typename _FuncType, typename _JoinType> _DataType ParallelReduce(GAIA::NUM sBegin, GAIA::NUM sEnd, GAIA::NUM sGrain, const _DataType& identity, _FuncType& func, _JoinType& join)
+			{
+				if(sEnd <= sBegin)
+					return identity;
+				if(sGrain < 1)
+					sGrain = 1;
+				if(!this->IsBegin() || sEnd - sBegin <= sGrain)
+					return join(identity, func(sBegin, sEnd));
+				ParallelReduceJob<_DataType, _FuncType, _JoinType>* pJob = gnew ParallelReduceJob<_DataType, _FuncType, _JoinType>(*this, sGrain, identity, func, join);
+				pJob->Execute(sBegin, sEnd);
+				pJob->Finish();
+				pJob->Join();
+				_DataType ret = pJob->GetResult();
+				pJob->drop_ref();
+				return ret;
+			}
+
+			/*!
+				@brief Sort the elements in parallel, the result is the same as GAIA::ALGO::sort.
+
+				@param p [in] Specify the elements.
+
+				@param sSize [in] Specify the element count.
+
+				@param sGrain [in] Specify the element count of a block, every block is sorted by a task,
+					then the sorted blocks are merged by passes, and every pass is splitted to tasks of sGrain output elements.
+
+				@remarks
+					It need a temporary buffer of sSize elements, and the element type must be default constructible and assignable.
+					If the thread pool is not begin or sSize is not above sGrain, the elements are sorted by the calling thread.
+			*/
+			template<typename _DataType> GAIA::GVOID ParallelSort(_DataType* p, GAIA::NUM sSize, GAIA::NUM sGrain)
+			{
+				GAST(!!p);
+				if(sSize <= 1)
+					return;
+				if(sGrain < 1)
+					sGrain = 1;
+				if(!this->IsBegin() || sSize <= sGrain)
+				{
+					GAIA::ALGO::sort(p, p + sSize - 1);
+					return;
+				}
+				GAIA::NUM sBlockCount = (sSize + sGrain - 1) / sGrain;
+				ParallelSortFunc<_DataType> sortfunc(p, sSize, sGrain);
+				this->ParallelFor(0, sBlockCount, 1, sortfunc);
+
+				_DataType* pBuf = gnew _DataType[sSize];
+				_DataType* pSrc = p;
+				_DataType* pDst = pBuf;
+				for(GAIA::N64 nWidth = sGrain; nWidth < sSize; nWidth *= 2)
+				{
+					ParallelMergeFunc<_DataType> mergefunc(pSrc, pDst, sSize, GSCAST(GAIA::NUM)(nWidth), sGrain);
+					this->ParallelFor(0, sBlockCount, 1, mergefunc);
+					GAIA::ALGO::swap(pSrc, pDst);
+				}
+				if(pSrc != p)
+				{
+					ParallelCopyFunc<_DataType> copyfunc(pSrc, p, sSize, sGrain);
+					this->ParallelFor(0, sBlockCount, 1, copyfunc);
+				}
+				gdel[] pBuf;
+			}
 		private:
 			GINL GAIA::GVOID init()
 			{
+				m_schedulemode = SCHEDULE_MODE_STATIC;
 				m_uStackSize = GAIA::THREAD_STACK_SIZE;
-				m_uLastGroupIndex = 0;
+				m_lastgroupindex = 0;
+				m_nextthreadindex = 0;
 				m_bBegin = GAIA::False;
 			}
 			GINL GAIA::GVOID destruct()
@@ -283,15 +1038,123 @@ namespace GAIA
 					pTask->drop_ref();
 				}
 			}
+			GINL GAIA::THREAD::ThreadPool::WorkThread* SelectThread(GAIA::THREAD::ThreadPool::Task& task)
+			{
+				if(m_schedulemode != SCHEDULE_MODE_STEAL)
+					return m_threads[task.GetGroupIndex() % m_threads.size()];
+				m_pending.Increase();
+				if(task.IsOrdered())
+					return m_threads[task.GetGroupIndex() % m_threads.size()];
+				GAIA::U32 uThreadIndex = GSCAST(GAIA::U32)(m_nextthreadindex++);
+				return m_threads[uThreadIndex % m_threads.size()];
+			}
+			GINL GAIA::THREAD::ThreadPool::Task* StealTask(GAIA::THREAD::ThreadPool::WorkThread& thief)
+			{
+				GAIA::NUM sThreadCount = m_threads.size();
+				GAIA::NUM sBegin = GSCAST(GAIA::NUM)((thief.m_sIndex + 1 + thief.m_uStealSeed++) % sThreadCount);
+				for(GAIA::NUM x = 0; x < sThreadCount; ++x)
+				{
+					GAIA::THREAD::ThreadPool::WorkThread* pThread = m_threads[(sBegin + x) % sThreadCount];
+					if(pThread == &thief)
+						continue;
+					GAIA::THREAD::ThreadPool::Task* pTask = pThread->m_taskdeque.steal();
+					if(pTask == GNIL)
+						pTask = pThread->StealInbox(thief);
+					if(pTask != GNIL)
+						return pTask;
+				}
+				return GNIL;
+			}
+			GINL GAIA::BL IsStealable(const GAIA::THREAD::ThreadPool::WorkThread& thief) const
+			{
+				for(__ThreadListType::const_it it = m_threads.const_frontit(); !it.empty(); ++it)
+				{
+					GAIA::THREAD::ThreadPool::WorkThread* pThread = *it;
+					if(pThread != &thief && (!pThread->m_taskdeque.empty() || !pThread->IsTaskInboxEmpty()))
+						return GAIA::True;
+				}
+				return GAIA::False;
+			}
+			GINL GAIA::GVOID FireIdleThread(GAIA::THREAD::ThreadPool::WorkThread& except)
+			{
+				for(__ThreadListType::it it = m_threads.frontit(); !it.empty(); ++it)
+				{
+					GAIA::THREAD::ThreadPool::WorkThread* pThread = *it;
+					if(pThread != &except && pThread->IsIdle())
+						pThread->FireTask();
+				}
+			}
+			GINL GAIA::GVOID FireThiefThread(GAIA::THREAD::ThreadPool::WorkThread& owner)
+			{
+				// The owner is busy, the idle work threads could steal the task from it's inbox.
+				GAIA::SYNC::gmembarrier();
+				if(!owner.IsIdle())
+					this->FireIdleThread(owner);
+			}
+			GINL GAIA::GVOID ExecuteTask(GAIA::THREAD::ThreadPool::Task& task)
+			{
+				task.Run();
+				task.FireComplete();
+				task.drop_ref();
+				if(m_pending.Decrease() == 0)
+				{
+					// Wake the work threads which are waiting for the stop command.
+					for(__ThreadListType::it it = m_threads.frontit(); !it.empty(); ++it)
+					{
+						GAIA::THREAD::ThreadPool::WorkThread* pThread = *it;
+						if(pThread->GetStopCmd() == GAIA::THREAD::ThreadPool::WorkThread::STOP_TYPE_WAITCOMPLETE)
+							pThread->FireTask();
+					}
+				}
+			}
+			GINL GAIA::BL IsTaskComplete() const{return (GAIA::N64)m_pending == 0;}
+			GINL GAIA::THREAD::ThreadPool::WorkThread* GetCurrentWorkThread()
+			{
+				GAIA::UM uThreadID = GAIA::THREAD::threadid();
+				for(__ThreadListType::it it = m_threads.frontit(); !it.empty(); ++it)
+				{
+					GAIA::THREAD::ThreadPool::WorkThread* pThread = *it;
+					if(pThread->m_uThreadID == uThreadID)
+						return pThread;
+				}
+				return GNIL;
+			}
+
+			/*!
+				@brief Push a task spawned by a running task.
+
+				@remarks
+					In SCHEDULE_MODE_STEAL a work thread push it's spawned task to the local deque directly,
+					the idle work threads will steal it.
+			*/
+			GINL GAIA::GVOID SpawnTask(GAIA::THREAD::ThreadPool::Task& task)
+			{
+				if(m_schedulemode == SCHEDULE_MODE_STEAL)
+				{
+					GAIA::THREAD::ThreadPool::WorkThread* pThread = this->GetCurrentWorkThread();
+					if(pThread != GNIL)
+					{
+						m_pending.Increase();
+						task.rise_ref();
+						pThread->m_taskdeque.push_back(&task);
+						this->FireIdleThread(*pThread);
+						return;
+					}
+				}
+				this->RunTask(task);
+			}
 		private:
 			typedef GAIA::CTN::Vector<GAIA::THREAD::ThreadPool::WorkThread*> __ThreadListType;
 			typedef GAIA::CTN::Queue<GAIA::THREAD::ThreadPool::Task*> __TaskQueueType;
 		private:
+			SCHEDULE_MODE m_schedulemode;
 			__ThreadListType m_threads;
 			GAIA::SYNC::Lock m_lrTaskQueue;
 			__TaskQueueType m_taskqueue;
+			GAIA::SYNC::Atomic m_pending;
 			GAIA::NUM m_uStackSize;
-			GAIA::U32 m_uLastGroupIndex;
+			GAIA::SYNC::Atomic m_lastgroupindex;
+			GAIA::SYNC::Atomic m_nextthreadindex;
 			GAIA::U8 m_bBegin : 1;
 		};
 	}
@@ -9,6 +9,7 @@
 #	include <time.h>
 #	include <windows.h>
 #else
+#	include <time.h>
 #	include <sys/time.h>
 #endif
 
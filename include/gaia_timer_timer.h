@@ -3,8 +3,7 @@
 
 #include "gaia_type.h"
 #include "gaia_assert.h"
-#include "gaia_math_base.h"
-#include "gaia_ctn_vector.h"
+#include "gaia_algo_compare.h"
 #include "gaia_ctn_book.h"
 
 namespace GAIA
@@ -147,8 +146,10 @@ namespace GAIA
 				m_nLastUpdateTime = 0;
 				m_nUpdateTimes = 0;
 				m_pTimerMgr = GNIL;
-				m_sGroupIndex = GINVALID;
-				m_sIndex = GINVALID;
+				m_pWheelPrev = GNIL;
+				m_pWheelNext = GNIL;
+				m_ppWheelHead = GNIL;
+				m_uWheelTick = 0;
 				m_bPaused = GAIA::False;
 				m_bUnregisting = GAIA::False;
 			}
@@ -156,10 +157,6 @@ namespace GAIA
 			GINL GAIA::GVOID SetRegistTime(const __MicroSecType& t){m_nRegistTime = t;}
 			GINL GAIA::GVOID SetLastUpdateTime(const __MicroSecType& t){m_nLastUpdateTime = t;}
 			GINL GAIA::GVOID SetUpdateTimes(const __UpdateTimesType& t){m_nUpdateTimes = t;}
-			GINL GAIA::GVOID SetGroupIndex(const GAIA::NUM& index){m_sGroupIndex = index;}
-			GINL const GAIA::NUM& GetGroupIndex() const{return m_sGroupIndex;}
-			GINL GAIA::GVOID SetIndex(const GAIA::NUM& index){m_sIndex = index;}
-			GINL const GAIA::NUM& GetIndex() const{return m_sIndex;}
 			GINL GAIA::GVOID SetUnregisting(GAIA::BL bUnregisting){m_bUnregisting = bUnregisting;}
 			GINL GAIA::BL GetUnregisting() const{return m_bUnregisting;}
 
@@ -169,16 +166,31 @@ namespace GAIA
 			__MicroSecType m_nLastUpdateTime;
 			__UpdateTimesType m_nUpdateTimes;
 			GAIA::TIME::TimerMgr* m_pTimerMgr;
-			GAIA::NUM m_sGroupIndex;
-			GAIA::NUM m_sIndex;
+			Timer* m_pWheelPrev; // The previous timer in the same wheel list.
+			Timer* m_pWheelNext; // The next timer in the same wheel list.
+			Timer** m_ppWheelHead; // The head of the wheel list which the timer linked in, GNIL means not linked.
+			GAIA::U64 m_uWheelTick; // The wheel tick which the timer will expire at.
 			GAIA::U8 m_bPaused : 1;
 			GAIA::U8 m_bUnregisting : 1;
 		};
 
+		/*!
+			@brief Timer manager based on hierarchical timing wheel.
+
+			@remarks The wheel have a root level with 256 slots and 4 upper levels with 64 slots each,
+				the timer will be linked to the slot of it's expire tick, and cascade to the lower level when the lower level rotate a round.
+				So regist, unregist and fire a timer are O(1), the timers expired in the same tick are collected and fired in a batch.
+				The timer fire at the first update which the time escape reached exactly(not rounded to the tick).
+		*/
 		class TimerMgr : public GAIA::RefObject
 		{
 		public:
-			typedef GAIA::CTN::Vector<Timer*> __TimerList;
+			static const GAIA::NUM WHEEL_ROOT_BITS = 8;
+			static const GAIA::NUM WHEEL_LEVEL_BITS = 6;
+			static const GAIA::NUM WHEEL_LEVEL_COUNT = 5;
+			static const GAIA::NUM WHEEL_ROOT_SIZE = 1 << WHEEL_ROOT_BITS;
+			static const GAIA::NUM WHEEL_LEVEL_SIZE = 1 << WHEEL_LEVEL_BITS;
+			static const GAIA::NUM WHEEL_SLOT_COUNT = WHEEL_ROOT_SIZE + WHEEL_LEVEL_SIZE * (WHEEL_LEVEL_COUNT - 1);
 
 		public:
 			class Desc : public GAIA::Base
@@ -186,15 +198,15 @@ namespace GAIA
 			public:
 				GINL GAIA::GVOID reset()
 				{
-					sGroupCount = 32;
+					nTickUSec = 1000;
 				}
 				GINL GAIA::BL check() const
 				{
-					if(sGroupCount <= 0)
+					if(nTickUSec <= 0)
 						return GAIA::False;
 					return GAIA::True;
 				}
-				GAIA::NUM sGroupCount;
+				GAIA::TIME::Timer::__MicroSecType nTickUSec; // The time escape of one wheel tick in micro second.
 			};
 
 		public:
@@ -205,28 +217,24 @@ namespace GAIA
 			{
 				if(!desc.check())
 					return GAIA::False;
-				this->init_groups();
+				if(m_sTimerCount != 0)
+					return GAIA::False;
+				m_desc = desc;
+				m_uWheelTick = GSCAST(GAIA::U64)(m_nLastUpdateTime / m_desc.nTickUSec);
 				return GAIA::True;
 			}
 			GINL GAIA::GVOID Destroy()
 			{
-				for(GAIA::NUM x = 0; x < m_groups.size(); ++x)
-				{
-					Group& g = m_groups[x];
-					GAIA::TIME::Timer::__TimerBook::it it = g.timers.frontit();
-					for(; !it.empty(); ++it)
-					{
-						GAIA::TIME::Timer* pTimer = *it;
-						if(pTimer->GetDesc().bAutoRelease)
-						{
-							if(pTimer->get_ref() > 1)
-								pTimer->drop_ref();
-						}
-						GAIA_RELEASE_SAFE(pTimer);
-					}
-				}
-				m_groups.destroy();
+				for(GAIA::NUM x = 0; x < WHEEL_SLOT_COUNT; ++x)
+					this->ReleaseTimerList(m_wheel[x]);
+				this->ReleaseTimerList(m_pPendingTimers);
+				this->ReleaseTimerList(m_pFiringTimers);
+				this->ReleaseTimerList(m_pAlwaysTimers);
+				GAST(m_sTimerCount == 0);
+				GAST(m_sWheelTimerCount == 0);
+				GAST(m_sRootTimerCount == 0);
 				m_nLastUpdateTime = 0;
+				m_uWheelTick = 0;
 				m_desc.reset();
 			}
 			GINL const GAIA::TIME::TimerMgr::Desc& GetDesc() const{return m_desc;}
@@ -240,17 +248,11 @@ namespace GAIA
 				timer.rise_ref();
 
 				/* Regist. */
-				GAIA::NUM sGroupIndex = this->GetGroupIndexByTime(timer.GetDesc().nEscapeUSec);
-				GAST(sGroupIndex != GINVALID);
-				if(sGroupIndex >= m_groups.size())
-					sGroupIndex = m_groups.size() - 1;
-				Group& g = m_groups[sGroupIndex];
-				GAIA::NUM sUsedIndex = g.timers.insert(&timer);
 				timer.SetTimerMgr(this);
 				timer.SetRegistTime(this->GetLastUpdateTime());
 				timer.SetLastUpdateTime(this->GetLastUpdateTime());
-				timer.SetGroupIndex(sGroupIndex);
-				timer.SetIndex(g.timers.fixedindex(sUsedIndex));
+				this->AddTimer(timer);
+				++m_sTimerCount;
 
 				/* Regist fire. */
 				if(timer.GetDesc().descFire.bRegistFire)
@@ -271,21 +273,10 @@ namespace GAIA
 					if(timer.GetDesc().descFire.bUnregistFire)
 						timer.Update(GAIA::TIME::Timer::FIRE_REASON_UNREGIST);
 
-					/* Unregist. */
-					GAIA::NUM sGroupIndex = timer.GetGroupIndex();
-					GAIA::NUM sFixedIndex = timer.GetIndex();
-					GAST(sGroupIndex != GINVALID);
-					GAST(sFixedIndex != GINVALID);
-					Group& g = m_groups[sGroupIndex];
-					GAIA::NUM sUsedIndex = g.timers.usedindex(sFixedIndex);
-					if(!g.timers.erase(sUsedIndex))
-					{
-						GASTFALSE;
-						return GAIA::False;
-					}
+					/* Unregist, the timer is not linked when it is firing. */
+					this->UnlinkTimer(timer);
 					timer.SetTimerMgr(GNIL);
-					timer.SetGroupIndex(GINVALID);
-					timer.SetIndex(GINVALID);
+					--m_sTimerCount;
 				}
 				timer.SetUnregisting(GAIA::False);
 
@@ -303,179 +294,274 @@ namespace GAIA
 				if(pTimerMgr != this)
 					return GAIA::False;
 			#ifdef GAIA_DEBUG_SELFCHECKROUTINE
-				GAST(timer.GetGroupIndex() != GINVALID);
-				GAST(timer.GetGroupIndex() < m_groups.size());
-				const Group& g = m_groups[timer.GetGroupIndex()];
-				GAIA::NUM sUseIndex = g.timers.usedindex(timer.GetIndex());
-				GAST(sUseIndex != GINVALID);
-				GAST(g.timers[sUseIndex] == &timer);
+				if(timer.m_ppWheelHead != GNIL)
+				{
+					GAST(*timer.m_ppWheelHead != GNIL);
+					GAST(timer.m_pWheelPrev != GNIL || *timer.m_ppWheelHead == &timer);
+					GAST(timer.m_pWheelNext == GNIL || timer.m_pWheelNext->m_pWheelPrev == &timer);
+				}
 			#endif
 				return GAIA::True;
 			}
+			GINL GAIA::NUM GetTimerCount() const{return m_sTimerCount;}
 
 			GINL GAIA::GVOID Update(const GAIA::TIME::Timer::__MicroSecType& nEscape)
 			{
 				m_nLastUpdateTime += nEscape;
-				for(GAIA::NUM x = 0; x < m_groups.size(); ++x)
+
+				/* Update the timers which time escape is zero. */
+				GAST(m_pFiringTimers == GNIL);
+				this->MoveTimerList(m_pAlwaysTimers, m_pFiringTimers);
+				while(m_pFiringTimers != GNIL)
 				{
-					Group& g = m_groups[x];
-					if(x == 0)
+					GAIA::TIME::Timer* pTimer = m_pFiringTimers;
+					this->UnlinkTimer(*pTimer);
+					this->LinkTimer(*pTimer, m_pAlwaysTimers);
+					pTimer->SetLastUpdateTime(this->GetLastUpdateTime());
+					pTimer->Update(GAIA::TIME::Timer::FIRE_REASON_UPDATE);
+				}
+
+				/* Turn the wheel, collect the expired timers to pending list. */
+				GAIA::U64 uNowTick = GSCAST(GAIA::U64)(this->GetLastUpdateTime() / m_desc.nTickUSec);
+				while(m_uWheelTick <= uNowTick)
+				{
+					if(m_sWheelTimerCount == 0)
 					{
-						this->SwitchToTempTimerList(g);
-						{
-							for(__TimerList::it it = m_TempTimerList.frontit(); !it.empty(); ++it)
-							{
-								GAIA::TIME::Timer* pTimer = *it;
-								GAST(pTimer != GNIL);
-								pTimer->SetLastUpdateTime(this->GetLastUpdateTime());
-								pTimer->Update(GAIA::TIME::Timer::FIRE_REASON_UPDATE);
-							}
-							g.nLastUpdate = this->GetLastUpdateTime();
-						}
-						this->SwitchToTempTimerListEnd();
+						m_uWheelTick = uNowTick + 1;
+						break;
 					}
-					else
+					GAIA::NUM sRootIndex = GSCAST(GAIA::NUM)(m_uWheelTick & (WHEEL_ROOT_SIZE - 1));
+					if(sRootIndex == 0)
 					{
-						/* Get need update for current group. */
-						GAIA::BL bNeedUpdate = GAIA::False;
-						GAIA::TIME::Timer::__MicroSecType nGroupOffsetTime = this->GetLastUpdateTime() - g.nLastUpdate;
-						if(nGroupOffsetTime > m_groups[x - 1].nEscape)
-							bNeedUpdate = GAIA::True;
-
-						/* If current group need update, update it. */
-						if(bNeedUpdate)
+						for(GAIA::NUM x = 1; x < WHEEL_LEVEL_COUNT; ++x)
 						{
-							this->SwitchToTempTimerList(g);
-							{
-								for(__TimerList::it it = m_TempTimerList.frontit(); !it.empty(); ++it)
-								{
-									GAIA::TIME::Timer* pTimer = *it;
-									GAIA::TIME::Timer::__MicroSecType nOffsetTime = this->GetLastUpdateTime() - pTimer->GetLastUpdateTime();
-									const GAIA::TIME::Timer::Desc& descTimer = pTimer->GetDesc();
-									GAIA::BL bUnregistInCallBack = GAIA::False;
-									if(nOffsetTime > descTimer.nEscapeUSec)
-									{
-										if(pTimer->GetDesc().bMultiCallBack)
-										{
-											while(this->GetLastUpdateTime() - pTimer->GetLastUpdateTime() > descTimer.nEscapeUSec)
-											{
-												pTimer->SetLastUpdateTime(pTimer->GetLastUpdateTime() + pTimer->GetDesc().nEscapeUSec);
-												pTimer->rise_ref();
-												{
-													pTimer->Update(GAIA::TIME::Timer::FIRE_REASON_UPDATE);
-													if(!pTimer->IsRegisted())
-													{
-														bUnregistInCallBack = GAIA::True;
-														pTimer->drop_ref();
-														break;
-													}
-												}
-												pTimer->drop_ref();
-											}
-										}
-										else
-										{
-											GAIA::TIME::Timer::__MicroSecType nFireTimes = nOffsetTime / descTimer.nEscapeUSec;
-											pTimer->SetLastUpdateTime(pTimer->GetLastUpdateTime() + nFireTimes * pTimer->GetDesc().nEscapeUSec);
-											pTimer->rise_ref();
-											{
-												pTimer->Update(GAIA::TIME::Timer::FIRE_REASON_UPDATE);
-												if(!pTimer->IsRegisted())
-													bUnregistInCallBack = GAIA::True;
-											}
-											pTimer->drop_ref();
-										}
-									}
-									if(!bUnregistInCallBack)
-										this->SwitchTimerToNewGroup(*pTimer);
-								}
-							}
-							this->SwitchToTempTimerListEnd();
+							GAIA::NUM sLevelIndex = GSCAST(GAIA::NUM)((m_uWheelTick >> (WHEEL_ROOT_BITS + (x - 1) * WHEEL_LEVEL_BITS)) & (WHEEL_LEVEL_SIZE - 1));
+							this->CascadeTimers(this->GetWheelSlot(x, sLevelIndex));
+							if(sLevelIndex != 0)
+								break;
 						}
 					}
+					else if(m_sRootTimerCount == 0)
+					{
+						/* Skip the empty root slots to the next round. */
+						GAIA::U64 uNextRoundTick = (m_uWheelTick | (WHEEL_ROOT_SIZE - 1)) + 1;
+						m_uWheelTick = GAIA::ALGO::gmin(uNextRoundTick, uNowTick + 1);
+						continue;
+					}
+					++m_uWheelTick;
+					this->MoveTimerList(m_wheel[sRootIndex], m_pPendingTimers);
+				}
+
+				/* Fire the pending timers in a batch. */
+				this->MoveTimerList(m_pPendingTimers, m_pFiringTimers);
+				while(m_pFiringTimers != GNIL)
+				{
+					GAIA::TIME::Timer* pTimer = m_pFiringTimers;
+					this->UnlinkTimer(*pTimer);
+					this->FireTimer(*pTimer);
 				}
 			}
 			GINL const GAIA::TIME::Timer::__MicroSecType& GetLastUpdateTime() const{return m_nLastUpdateTime;}
 
-		private:
-			class Group : public GAIA::Base
-			{
-			public:
-				GAIA::TIME::Timer::__MicroSecType nEscape;
-				GAIA::TIME::Timer::__MicroSecType nLastUpdate;
-				GAIA::TIME::Timer::__TimerBook timers;
-			};
-
 		private:
 			GINL GAIA::GVOID init()
 			{
 				m_desc.reset();
+				for(GAIA::NUM x = 0; x < WHEEL_SLOT_COUNT; ++x)
+					m_wheel[x] = GNIL;
+				m_pPendingTimers = GNIL;
+				m_pFiringTimers = GNIL;
+				m_pAlwaysTimers = GNIL;
+				m_sTimerCount = 0;
+				m_sWheelTimerCount = 0;
+				m_sRootTimerCount = 0;
 				m_nLastUpdateTime = 0;
+				m_uWheelTick = 0;
 			}
-			GINL GAIA::GVOID init_groups()
+
+			GINL GAIA::TIME::Timer*& GetWheelSlot(GAIA::NUM sLevel, GAIA::NUM sIndex)
+			{
+				if(sLevel == 0)
+					return m_wheel[sIndex];
+				return m_wheel[WHEEL_ROOT_SIZE + (sLevel - 1) * WHEEL_LEVEL_SIZE + sIndex];
+			}
+			GINL GAIA::GVOID LinkTimer(GAIA::TIME::Timer& timer, GAIA::TIME::Timer*& pHead)
 			{
-				GAST(m_groups.empty());
-				m_groups.resize(m_desc.sGroupCount);
-				for(GAIA::NUM x = 0; x < m_desc.sGroupCount; ++x)
+				GAST(timer.m_ppWheelHead == GNIL);
+				timer.m_pWheelPrev = GNIL;
+				timer.m_pWheelNext = pHead;
+				timer.m_ppWheelHead = &pHead;
+				if(pHead != GNIL)
+					pHead->m_pWheelPrev = &timer;
+				pHead = &timer;
+				if(&pHead >= m_wheel && &pHead < m_wheel + WHEEL_SLOT_COUNT)
 				{
-					Group& g = m_groups[x];
-					g.nEscape = x * x * 1000 * 1000; // The first group's escape must zero for always update.
-					g.nLastUpdate = 0;
+					++m_sWheelTimerCount;
+					if(&pHead < m_wheel + WHEEL_ROOT_SIZE)
+						++m_sRootTimerCount;
 				}
-				m_groups.back().nEscape = GAIA::N64MAX;
 			}
-
-			GINL GAIA::NUM GetGroupIndexByTime(const GAIA::TIME::Timer::__MicroSecType& nEscapeUSec) const
+			GINL GAIA::GVOID UnlinkTimer(GAIA::TIME::Timer& timer)
 			{
-				if(nEscapeUSec == 0)
-					return 0;
-				GAIA::F64 fGroupIndex = GAIA::MATH::gsqrt(GSCAST(GAIA::F64)(nEscapeUSec) / 1000.0 / 1000.0);
-				return GSCAST(GAIA::NUM)(GAIA::MATH::gceil(fGroupIndex));
+				GAIA::TIME::Timer** ppHead = timer.m_ppWheelHead;
+				if(ppHead == GNIL)
+					return;
+				if(timer.m_pWheelPrev != GNIL)
+					timer.m_pWheelPrev->m_pWheelNext = timer.m_pWheelNext;
+				else
+					*ppHead = timer.m_pWheelNext;
+				if(timer.m_pWheelNext != GNIL)
+					timer.m_pWheelNext->m_pWheelPrev = timer.m_pWheelPrev;
+				timer.m_pWheelPrev = GNIL;
+				timer.m_pWheelNext = GNIL;
+				timer.m_ppWheelHead = GNIL;
+				if(ppHead >= m_wheel && ppHead < m_wheel + WHEEL_SLOT_COUNT)
+				{
+					--m_sWheelTimerCount;
+					if(ppHead < m_wheel + WHEEL_ROOT_SIZE)
+						--m_sRootTimerCount;
+				}
 			}
-			GINL GAIA::GVOID SwitchTimerToNewGroup(GAIA::TIME::Timer& timer)
+			GINL GAIA::GVOID MoveTimerList(GAIA::TIME::Timer*& pSrcHead, GAIA::TIME::Timer*& pDstHead)
 			{
-				GAST(timer.IsRegisted());
-				GAIA::TIME::Timer::__MicroSecType nOffsetTime = this->GetLastUpdateTime() - timer.GetLastUpdateTime();
-				GAIA::NUM sNewGroupIndex = this->GetGroupIndexByTime(nOffsetTime);
-				GAST(sNewGroupIndex != GINVALID);
-				if(sNewGroupIndex != timer.GetGroupIndex())
+				while(pSrcHead != GNIL)
 				{
-					GAST(sNewGroupIndex < m_groups.size());
-
-					/* Erase from old group. */
-					Group& gold = m_groups[timer.GetGroupIndex()];
-					GAIA::NUM sOldUsedIndex = gold.timers.usedindex(timer.GetIndex());
-					GAST(sOldUsedIndex != GINVALID);
-					gold.timers.erase(sOldUsedIndex);
-
-					/* Add to new group. */
-					Group& g = m_groups[sNewGroupIndex];
-					GAIA::NUM sNewUsedIndex = g.timers.insert(&timer);
-					GAIA::NUM sNewFixedIndex = g.timers.fixedindex(sNewUsedIndex);
-
-					/* Update index. */
-					timer.SetGroupIndex(sNewGroupIndex);
-					timer.SetIndex(sNewFixedIndex);
+					GAIA::TIME::Timer* pTimer = pSrcHead;
+					this->UnlinkTimer(*pTimer);
+					this->LinkTimer(*pTimer, pDstHead);
 				}
 			}
-			GINL GAIA::GVOID SwitchToTempTimerList(Group& g)
+			GINL GAIA::GVOID ReleaseTimerList(GAIA::TIME::Timer*& pHead)
 			{
-				GAST(m_TempTimerList.empty());
-				for(GAIA::TIME::Timer::__TimerBook::it it = g.timers.frontit(); !it.empty(); ++it)
-					m_TempTimerList.push_back(*it);
+				while(pHead != GNIL)
+				{
+					GAIA::TIME::Timer* pTimer = pHead;
+					this->UnlinkTimer(*pTimer);
+					pTimer->SetTimerMgr(GNIL);
+					--m_sTimerCount;
+					if(pTimer->GetDesc().bAutoRelease)
+					{
+						if(pTimer->get_ref() > 1)
+							pTimer->drop_ref();
+					}
+					GAIA_RELEASE_SAFE(pTimer);
+				}
 			}
-			GINL GAIA::GVOID SwitchToTempTimerListEnd()
+			GINL GAIA::GVOID AddTimer(GAIA::TIME::Timer& timer)
 			{
-				m_TempTimerList.clear();
+				const GAIA::TIME::Timer::Desc& descTimer = timer.GetDesc();
+				if(descTimer.nEscapeUSec == 0)
+				{
+					this->LinkTimer(timer, m_pAlwaysTimers);
+					return;
+				}
+
+				/* The timer fire when the time escape greater than the escape of timer. */
+				GAIA::U64 uExpireTick;
+				if(descTimer.nEscapeUSec < GAIA::N64MAX - timer.GetLastUpdateTime())
+					uExpireTick = GSCAST(GAIA::U64)((timer.GetLastUpdateTime() + descTimer.nEscapeUSec + 1) / m_desc.nTickUSec);
+				else
+					uExpireTick = GAIA::U64MAX;
+				if(uExpireTick < m_uWheelTick)
+				{
+					/* The expire tick had been turned, the timer will be checked at the next update. */
+					timer.m_uWheelTick = m_uWheelTick;
+					this->LinkTimer(timer, m_pPendingTimers);
+					return;
+				}
+
+				GAIA::U64 uOffset = uExpireTick - m_uWheelTick;
+				if(uOffset < GSCAST(GAIA::U64)(WHEEL_ROOT_SIZE))
+				{
+					timer.m_uWheelTick = uExpireTick;
+					this->LinkTimer(timer, this->GetWheelSlot(0, GSCAST(GAIA::NUM)(uExpireTick & (WHEEL_ROOT_SIZE - 1))));
+					return;
+				}
+				for(GAIA::NUM x = 1; x < WHEEL_LEVEL_COUNT; ++x)
+				{
+					GAIA::NUM sShift = WHEEL_ROOT_BITS + x * WHEEL_LEVEL_BITS;
+					GAIA::U64 uLevelRange = GSCAST(GAIA::U64)(1) << sShift;
+					if(uOffset >= uLevelRange)
+					{
+						if(x != WHEEL_LEVEL_COUNT - 1)
+							continue;
+
+						/* Out of the wheel range, link to the farthest slot and recheck when it expired. */
+						uExpireTick = m_uWheelTick + uLevelRange - 1;
+					}
+					timer.m_uWheelTick = uExpireTick;
+					this->LinkTimer(timer, this->GetWheelSlot(x, GSCAST(GAIA::NUM)((uExpireTick >> (sShift - WHEEL_LEVEL_BITS)) & (WHEEL_LEVEL_SIZE - 1))));
+					return;
+				}
+				GASTFALSE;
+			}
+			GINL GAIA::GVOID CascadeTimers(GAIA::TIME::Timer*& pHead)
+			{
+				GAIA::TIME::Timer* pCascade = GNIL;
+				this->MoveTimerList(pHead, pCascade);
+				while(pCascade != GNIL)
+				{
+					GAIA::TIME::Timer* pTimer = pCascade;
+					this->UnlinkTimer(*pTimer);
+					this->AddTimer(*pTimer);
+				}
+			}
+			GINL GAIA::GVOID FireTimer(GAIA::TIME::Timer& timer)
+			{
+				GAIA::TIME::Timer* pTimer = &timer;
+				GAIA::TIME::Timer::__MicroSecType nOffsetTime = this->GetLastUpdateTime() - pTimer->GetLastUpdateTime();
+				const GAIA::TIME::Timer::Desc& descTimer = pTimer->GetDesc();
+				GAIA::BL bUnregistInCallBack = GAIA::False;
+				if(nOffsetTime > descTimer.nEscapeUSec)
+				{
+					if(pTimer->GetDesc().bMultiCallBack)
+					{
+						while(this->GetLastUpdateTime() - pTimer->GetLastUpdateTime() > descTimer.nEscapeUSec)
+						{
+							pTimer->SetLastUpdateTime(pTimer->GetLastUpdateTime() + pTimer->GetDesc().nEscapeUSec);
+							pTimer->rise_ref();
+							{
+								pTimer->Update(GAIA::TIME::Timer::FIRE_REASON_UPDATE);
+								if(pTimer->m_pTimerMgr != this)
+								{
+									bUnregistInCallBack = GAIA::True;
+									pTimer->drop_ref();
+									break;
+								}
+							}
+							pTimer->drop_ref();
+						}
+					}
+					else
+					{
+						GAIA::TIME::Timer::__MicroSecType nFireTimes = nOffsetTime / descTimer.nEscapeUSec;
+						pTimer->SetLastUpdateTime(pTimer->GetLastUpdateTime() + nFireTimes * pTimer->GetDesc().nEscapeUSec);
+						pTimer->rise_ref();
+						{
+							pTimer->Update(GAIA::TIME::Timer::FIRE_REASON_UPDATE);
+							if(pTimer->m_pTimerMgr != this)
+								bUnregistInCallBack = GAIA::True;
+						}
+						pTimer->drop_ref();
+					}
+				}
+
+				/* Link to the wheel again, if the timer had been registed again in callback, it is linked already. */
+				if(!bUnregistInCallBack && pTimer->m_ppWheelHead == GNIL)
+					this->AddTimer(*pTimer);
 			}
-		private:
-			typedef GAIA::CTN::Vector<Group> __GroupList;
 
 		private:
 			Desc m_desc;
-			__GroupList m_groups;
-			__TimerList m_TempTimerList;
+			GAIA::TIME::Timer* m_wheel[WHEEL_SLOT_COUNT];
+			GAIA::TIME::Timer* m_pPendingTimers; // The timers which expire tick had been turned.
+			GAIA::TIME::Timer* m_pFiringTimers; // The timers which will be fired in current update.
+			GAIA::TIME::Timer* m_pAlwaysTimers; // The timers which time escape is zero, fired in every update.
+			GAIA::NUM m_sTimerCount;
+			GAIA::NUM m_sWheelTimerCount;
+			GAIA::NUM m_sRootTimerCount;
 			GAIA::TIME::Timer::__MicroSecType m_nLastUpdateTime;
+			GAIA::U64 m_uWheelTick; // The next wheel tick to turn.
 		};
 	}
 }
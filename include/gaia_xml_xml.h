@@ -26,6 +26,7 @@
 #include "gaia_fsys_file.h"
 #include "gaia_xml_xmlbase.h"
 #include "gaia_xml_xmlnode.h"
+#include "gaia_xml_xmlreader.h"
 
 namespace GAIA
 {
@@ -38,9 +39,26 @@ namespace GAIA
 			{
 				friend class XML;
 			public:
-				GINL Cursor(){pCurrentNode = GNIL;}
+				GINL Cursor(){pCurrentNode = GNIL; pReader = GNIL; sReadDepth = 0; ntRead = ntLeaf = GAIA::XML::XML_NODE_INVALID; bReadPeeked = bLeafReaded = GAIA::False;}
+
+				/*!
+					@brief Bind a reader to the cursor, the BeginReadNode, EndReadNode and ReadNode will pull the nodes from it.
+				*/
+				GINL GAIA::GVOID BindReader(GAIA::XML::XMLReader* pReader){this->pReader = pReader; sReadDepth = 0; ntRead = ntLeaf = GAIA::XML::XML_NODE_INVALID; bReadPeeked = bLeafReaded = GAIA::False;}
+
+				/*!
+					@brief Get the node type of the last node readed by BeginReadNode or ReadNode.
+				*/
+				GINL GAIA::XML::XML_NODE GetReadType() const{return ntRead;}
 			private:
 				XMLNode* pCurrentNode;
+				GAIA::XML::XMLReader* pReader;
+				GAIA::NUM sReadDepth;
+				GAIA::XML::XML_NODE ntRead;
+				GAIA::XML::XML_NODE ntLeaf;
+				GAIA::BL bReadPeeked;
+				GAIA::BL bLeafReaded;
+				GAIA::CTN::WString strRead;
 			};
 		public:
 			GINL XML();
@@ -72,12 +90,7 @@ namespace GAIA
 			GINL GAIA::GVOID save_node(GAIA::XML::XMLNode& n, GAIA::XML::XML_SAVE st, GAIA::FSYS::FileBase& f);
 			GINL GAIA::GVOID save_child_node(GAIA::XML::XMLNode& n, GAIA::XML::XML_SAVE st, GAIA::FSYS::FileBase& f);
 			GINL GAIA::GVOID save_child_node_value(GAIA::XML::XMLNode& n, GAIA::XML::XML_SAVE st, GAIA::FSYS::FileBase& f);
-			GINL GAIA::NUM load_node(GAIA::U8* pBuf, GAIA::NUM sSize, GAIA::XML::XML_NODE& nt, GAIA::U8*& pBegin, GAIA::U8*& pEnd, GAIA::BL& bBegin) const;
-			GINL GAIA::NUM load_head(GAIA::U8* pBuf, GAIA::NUM sSize, GAIA::NUM sOffset, GAIA::NUM& sNext) const;
-			GINL GAIA::NUM load_comment(GAIA::U8* pBuf, GAIA::NUM sSize, GAIA::NUM sOffset, GAIA::NUM& sNext) const;
-			GINL GAIA::NUM load_node_name(GAIA::U8* pBuf, GAIA::NUM sSize, GAIA::NUM sOffset, GAIA::NUM& sNext) const;
-			GINL GAIA::NUM load_name(GAIA::U8* pBuf, GAIA::NUM sSize, GAIA::NUM sOffset, GAIA::NUM& sNext) const;
-			GINL GAIA::NUM load_value(GAIA::U8* pBuf, GAIA::NUM sSize, GAIA::NUM sOffset, GAIA::NUM& sNext) const;
+			GINL GAIA::BL load(GAIA::XML::XMLReader& reader);
 			GINL GAIA::GVOID read_string(const GAIA::U8* pBegin, const GAIA::U8* pEnd, GAIA::CTN::WString& strResult) const;
 
 		private:
@@ -36,105 +36,11 @@ namespace GAIA
 			if(GAIA::ALGO::gstremp(pszFileName))
 				return GAIA::False;
 
-			GAIA::FSYS::File f;
-			if(!f.Open(pszFileName, GAIA::FSYS::File::OPEN_TYPE_READ))
-				return GAIA::False;
-
-			this->Reset();
-
-			m_strTempW.reserve(1024);
-
-			GAIA::CTN::Buffer buf;
-
-			GAIA::XML::XML::Cursor cur;
-			for(;;)
-			{
-				buf.resize(1024 * 64);
-				GAIA::NUM sReaded = (GAIA::NUM)f.Read(buf.fptr() + buf.read_size(), buf.write_size() - buf.read_size());
-				if(sReaded <= 0)
-				{
-					buf.seek_write(buf.read_size());
-					buf.seek_read(0);
-					break;
-				}
-				buf.seek_write(buf.read_size() + sReaded);
-				buf.seek_read(0);
-
-				for(;;)
-				{
-					GAIA::XML::XML_NODE nt;
-					GAIA::U8* pBegin;
-					GAIA::U8* pEnd;
-					GAIA::BL bBegin;
-					GAIA::NUM sOffset = this->load_node(buf.read_ptr(), buf.remain(), nt, pBegin, pEnd, bBegin);
-					if(sOffset <= 0)
-						break;
-					else
-					{
-						this->read_string(pBegin, pEnd, m_strTempW);
-						buf.seek_read(sOffset, GAIA::SEEK_TYPE_FORWARD);
-						switch(nt)
-						{
-						case GAIA::XML::XML_NODE_CONTAINER:
-							{
-								if(bBegin)
-									this->BeginWriteNode(cur, nt, m_strTempW.fptr());
-								else
-								{
-									if(cur.pCurrentNode != GNIL)
-										cur.pCurrentNode->SetType(GAIA::XML::XML_NODE_CONTAINER);
-									this->EndWriteNode(cur);
-								}
-							}
-							break;
-						case GAIA::XML::XML_NODE_MULTICONTAINER:
-							{
-								if(bBegin)
-									this->BeginWriteNode(cur, nt, m_strTempW.fptr());
-								else
-								{
-									if(cur.pCurrentNode != GNIL)
-										cur.pCurrentNode->SetType(GAIA::XML::XML_NODE_MULTICONTAINER);
-									this->EndWriteNode(cur);
-								}
-							}
-							break;
-						case GAIA::XML::XML_NODE_NAME:
-							{
-								this->BeginWriteNode(cur, nt, m_strTempW.fptr());
-							}
-							break;
-						case GAIA::XML::XML_NODE_VALUE:
-							{
-								this->WriteNode(cur, nt, m_strTempW.fptr());
-								this->EndWriteNode(cur);
-							}
-							break;
-						case GAIA::XML::XML_NODE_HEAD:
-							break;
-						case GAIA::XML::XML_NODE_COMMENT:
-							{
-								this->WriteNode(cur, nt, m_strTempW.fptr());
-							}
-							break;
-						default:
-							GASTFALSE;
-							m_strTempW.destroy();
-							return GAIA::False;
-						}
-						if(buf.remain() == 0)
-							break;
-					}
-				}
-				buf.keep_remain();
-			}
-
-			m_strTempW.destroy();
-
-			if(buf.remain() != 0)
+			GAIA::XML::XMLReader reader;
+			if(!reader.OpenFile(pszFileName))
 				return GAIA::False;
 
-			return GAIA::True;
+			return this->load(reader);
 		}
 		GINL GAIA::BL XML::SaveToFile(const GAIA::TCH* pszFileName, GAIA::XML::XML_SAVE st)
 		{
@@ -173,7 +79,24 @@ namespace GAIA
 			if(sSize <= 0 || sSize > 1024 * 1024 * 1024)
 				return GAIA::False;
 
-			return GAIA::True;
+			GAIA::XML::XMLReader reader;
+		#if GAIA_CHARSET == GAIA_CHARSET_UNICODE
+			GAIA::NUM sMaxUtf8Len = sSize * 6;
+			m_strTempA.resize(sMaxUtf8Len);
+			GAIA::NUM sLenUTF8 = GAIA::LOCALE::w2m(pszSrc, sSize, m_strTempA.fptr(), sMaxUtf8Len, GAIA::CHARSET_TYPE_UTF8);
+			if(sLenUTF8 <= 0)
+			{
+				m_strTempA.destroy();
+				return GAIA::False;
+			}
+			reader.OpenMem(m_strTempA.fptr(), sLenUTF8);
+		#elif GAIA_CHARSET == GAIA_CHARSET_ANSI
+			reader.OpenMem(pszSrc, sSize);
+		#endif
+
+			GAIA::BL bRet = this->load(reader);
+			m_strTempA.destroy();
+			return bRet;
 		}
 		GINL GAIA::BL XML::SaveToMem(GAIA::TCH* pszDst, const GAIA::NUM& sSize, GAIA::XML::XML_SAVE st)
 		{
@@ -245,15 +168,113 @@ namespace GAIA
 		}
 		GINL const GAIA::TCH* XML::BeginReadNode(GAIA::XML::XML::Cursor& cur) const
 		{
-			return GNIL;
+			GAST(cur.pReader != GNIL);
+			if(cur.pReader == GNIL)
+				return GNIL;
+
+			const GAIA::U8* p;
+			GAIA::NUM sLen;
+
+			// The value node of a name node.
+			if(cur.ntLeaf == GAIA::XML::XML_NODE_NAME && !cur.bLeafReaded)
+			{
+				p = cur.pReader->GetValue(sLen);
+				this->read_string(p, p + sLen, cur.strRead);
+				cur.ntLeaf = cur.ntRead = GAIA::XML::XML_NODE_VALUE;
+				return cur.strRead.fptr();
+			}
+			if(cur.ntLeaf != GAIA::XML::XML_NODE_INVALID)
+				return GNIL;
+
+			for(;;)
+			{
+				GAIA::XML::XML_EVENT e = cur.bReadPeeked ? cur.pReader->GetEvent() : cur.pReader->Read();
+				cur.bReadPeeked = GAIA::True;
+				switch(e)
+				{
+				case GAIA::XML::XML_EVENT_STARTELEMENT:
+					{
+						p = cur.pReader->GetName(sLen);
+						cur.ntRead = cur.pReader->IsEmptyElement() ? GAIA::XML::XML_NODE_CONTAINER : GAIA::XML::XML_NODE_MULTICONTAINER;
+						++cur.sReadDepth;
+					}
+					break;
+				case GAIA::XML::XML_EVENT_ATTRIBUTE:
+					{
+						p = cur.pReader->GetName(sLen);
+						cur.ntLeaf = cur.ntRead = GAIA::XML::XML_NODE_NAME;
+					}
+					break;
+				case GAIA::XML::XML_EVENT_COMMENT:
+					{
+						p = cur.pReader->GetValue(sLen);
+						cur.ntLeaf = cur.ntRead = GAIA::XML::XML_NODE_COMMENT;
+					}
+					break;
+				case GAIA::XML::XML_EVENT_HEAD:
+				case GAIA::XML::XML_EVENT_TEXT:
+					cur.bReadPeeked = GAIA::False;
+					continue;
+				default: // The end of current node is keeped for EndReadNode.
+					return GNIL;
+				}
+				cur.bReadPeeked = GAIA::False;
+				this->read_string(p, p + sLen, cur.strRead);
+				return cur.strRead.fptr();
+			}
 		}
 		GINL GAIA::BL XML::EndReadNode(GAIA::XML::XML::Cursor& cur) const
 		{
+			GAST(cur.pReader != GNIL);
+			if(cur.pReader == GNIL)
+				return GAIA::False;
+
+			if(cur.ntLeaf == GAIA::XML::XML_NODE_VALUE)
+			{
+				cur.ntLeaf = GAIA::XML::XML_NODE_NAME;
+				cur.bLeafReaded = GAIA::True;
+				return GAIA::True;
+			}
+			if(cur.ntLeaf != GAIA::XML::XML_NODE_INVALID)
+			{
+				cur.ntLeaf = GAIA::XML::XML_NODE_INVALID;
+				cur.bLeafReaded = GAIA::False;
+				return GAIA::True;
+			}
+			if(cur.sReadDepth == 0)
+				return GAIA::False;
+
+			// Skip the nodes not readed until the end of current node.
+			GAIA::NUM sNested = 0;
+			for(;;)
+			{
+				GAIA::XML::XML_EVENT e = cur.bReadPeeked ? cur.pReader->GetEvent() : cur.pReader->Read();
+				cur.bReadPeeked = GAIA::False;
+				if(e == GAIA::XML::XML_EVENT_STARTELEMENT)
+					++sNested;
+				else if(e == GAIA::XML::XML_EVENT_ENDELEMENT)
+				{
+					if(sNested == 0)
+						break;
+					--sNested;
+				}
+				else if(e == GAIA::XML::XML_EVENT_END || e == GAIA::XML::XML_EVENT_ERROR)
+				{
+					cur.bReadPeeked = GAIA::True;
+					return GAIA::False;
+				}
+			}
+			--cur.sReadDepth;
 			return GAIA::True;
 		}
 		GINL const GAIA::TCH* XML::ReadNode(GAIA::XML::XML::Cursor& cur) const
 		{
-			return GNIL;
+			const GAIA::TCH* pszRet = this->BeginReadNode(cur);
+			if(pszRet == GNIL)
+				return GNIL;
+			if(!this->EndReadNode(cur))
+				return GNIL;
+			return pszRet;
 		}
 		GINL GAIA::GVOID XML::write_linebreak(GAIA::XML::XML_SAVE st, GAIA::FSYS::FileBase& f)
 		{
@@ -404,222 +425,77 @@ namespace GAIA
 				this->save_node(*pChild, st, f);
 			}
 		}
-		GINL GAIA::NUM XML::load_node(GAIA::U8* pBuf, GAIA::NUM sSize, GAIA::XML::XML_NODE& nt, GAIA::U8*& pBegin, GAIA::U8*& pEnd, GAIA::BL& bBegin) const
+		GINL GAIA::BL XML::load(GAIA::XML::XMLReader& reader)
 		{
-			GAST(pBuf != GNIL);
-			if(pBuf == GNIL)
-				return GINVALID;
-			GAST(sSize > 0);
-			if(sSize <= 0)
-				return GINVALID;
-			GAST(pBegin != GNIL);
-			if(pBegin == GNIL)
-				return GINVALID;
-			GAST(pEnd != GNIL);
-			if(pEnd == GNIL)
-				return GINVALID;
-			for(GAIA::NUM x = 0; x < sSize; ++x)
+			this->Reset();
+
+			m_strTempW.reserve(1024);
+
+			GAIA::BL bRet = GAIA::False;
+			GAIA::XML::XML::Cursor cur;
+			for(;;)
 			{
-				if(pBuf[x] == '<')
-				{
-					if(x + 1 >= sSize)
-						return GINVALID;
-					if(pBuf[x + 1] == '?') // Head begin.
-					{
-						if(x + 4 >= sSize)
-							return GINVALID;
-						GAIA::NUM sRet;
-						GAIA::NUM sLen = this->load_head(pBuf, sSize, x + 2, sRet);
-						if(sLen > 0)
-						{
-							pBegin = pBuf + x + 2;
-							pEnd = pBegin + sLen;
-							nt = GAIA::XML::XML_NODE_HEAD;
-							bBegin = GAIA::True;
-							return sRet;
-						}
-						else
-							return GINVALID;
-					}
-					else if(pBuf[x + 1] == '/') // Multi-Container node end.
-					{
-						if(x + 3 >= sSize)
-							return GINVALID;
-						GAIA::NUM sRet;
-						GAIA::NUM sLen = this->load_node_name(pBuf, sSize, x + 2, sRet);
-						if(sLen > 0)
-						{
-							pBegin = pBuf + x + 2;
-							pEnd = pBegin + sLen;
-							nt = GAIA::XML::XML_NODE_MULTICONTAINER;
-							bBegin = GAIA::False;
-							return sRet;
-						}
-						else
-							return GINVALID;
-					}
-					else if(pBuf[x + 1] == '!') // Commen node.
-					{
-						if(x + 6 >= sSize)
-							return GINVALID;
-						if(pBuf[x + 2] != '-' || pBuf[x + 3] != '-')
-							return GINVALID;
-						GAIA::NUM sRet;
-						GAIA::NUM sLen = this->load_comment(pBuf, sSize, x + 4, sRet);
-						if(sLen > 0)
-						{
-							pBegin = pBuf + x + 4;
-							pEnd = pBegin + sLen;
-							nt = GAIA::XML::XML_NODE_COMMENT;
-							bBegin = GAIA::True;
-							return sRet;
-						}
-						else
-							return GINVALID;
-					}
-					else // Container or Multi-Container node begin.
-					{
-						GAIA::NUM sRet;
-						GAIA::NUM sLen = this->load_node_name(pBuf, sSize, x + 1, sRet);
-						if(sLen > 0)
-						{
-							pBegin = pBuf + x + 1;
-							pEnd = pBegin + sLen;
-							nt = GAIA::XML::XML_NODE_MULTICONTAINER;
-							bBegin = GAIA::True;
-							return sRet;
-						}
-						else
-							return GINVALID;
-					}
-				}
-				else if(pBuf[x] == '/') // Container node end.
-				{
-					if(x + 1 >= sSize)
-						return GINVALID;
-					if(pBuf[x + 1] != '>')
-						return GINVALID;
-					pBegin = pEnd = GNIL;
-					bBegin = GAIA::False;
-					nt = GAIA::XML::XML_NODE_CONTAINER;
-					return x + 2;
-				}
-				else if(pBuf[x] == '\"') // Value node.
-				{
-					if(x + 1 >= sSize)
-						return GINVALID;
-					GAIA::NUM sRet;
-					GAIA::NUM sLen = this->load_value(pBuf, sSize, x + 1, sRet);
-					if(sLen > 0)
-					{
-						pBegin = pBuf + x + 1;
-						pEnd = pBegin + sLen;
-						nt = GAIA::XML::XML_NODE_VALUE;
-						bBegin = GAIA::True;
-						return sRet;
-					}
-					else
-						return GINVALID;
-				}
-				else if(GAIA::ALGO::isblank(pBuf[x]) || GAIA::ALGO::isspecial(pBuf[x]))
-				{
-				}
-				else if(pBuf[x] == '>') // Multi container end.
+				GAIA::XML::XML_EVENT e = reader.Read();
+				if(e == GAIA::XML::XML_EVENT_END)
 				{
+					bRet = GAIA::True;
+					break;
 				}
-				else // Name node.
+				if(e == GAIA::XML::XML_EVENT_ERROR)
+					break;
+
+				const GAIA::U8* p;
+				GAIA::NUM sLen;
+				switch(e)
 				{
-					GAIA::NUM sRet;
-					GAIA::NUM sLen = this->load_name(pBuf, sSize, x, sRet);
-					if(sLen > 0)
+				case GAIA::XML::XML_EVENT_STARTELEMENT:
 					{
-						pBegin = pBuf + x;
-						pEnd = pBegin + sLen;
-						nt = GAIA::XML::XML_NODE_NAME;
-						bBegin = GAIA::True;
-						return sRet;
+						p = reader.GetName(sLen);
+						this->read_string(p, p + sLen, m_strTempW);
+						GAIA::XML::XML_NODE nt = reader.IsEmptyElement() ? GAIA::XML::XML_NODE_CONTAINER : GAIA::XML::XML_NODE_MULTICONTAINER;
+						this->BeginWriteNode(cur, nt, m_strTempW.fptr());
 					}
-					else
-						return GINVALID;
-				}
-			}
-			return GINVALID;
-		}
-		GINL GAIA::NUM XML::load_head(GAIA::U8* pBuf, GAIA::NUM sSize, GAIA::NUM sOffset, GAIA::NUM& sNext) const
-		{
-			for(GAIA::NUM x = sOffset; x < sSize; ++x)
-			{
-				if(pBuf[x] == '>')
-				{
-					if(x - sOffset > 1)
+					break;
+				case GAIA::XML::XML_EVENT_ATTRIBUTE:
 					{
-						if(pBuf[x - 1] == '?')
-						{
-							sNext = x + 1;
-							return x - sOffset - 1;
-						}
+						p = reader.GetName(sLen);
+						this->read_string(p, p + sLen, m_strTempW);
+						this->BeginWriteNode(cur, GAIA::XML::XML_NODE_NAME, m_strTempW.fptr());
+						p = reader.GetValue(sLen);
+						this->read_string(p, p + sLen, m_strTempW);
+						this->WriteNode(cur, GAIA::XML::XML_NODE_VALUE, m_strTempW.fptr());
+						this->EndWriteNode(cur);
 					}
-				}
-			}
-			return GINVALID;
-		}
-		GINL GAIA::NUM XML::load_comment(GAIA::U8* pBuf, GAIA::NUM sSize, GAIA::NUM sOffset, GAIA::NUM& sNext) const
-		{
-			for(GAIA::NUM x = sOffset; x < sSize; ++x)
-			{
-				if(pBuf[x] == '>')
-				{
-					if(x - sOffset > 1)
+					break;
+				case GAIA::XML::XML_EVENT_ENDELEMENT:
+					this->EndWriteNode(cur);
+					break;
+				case GAIA::XML::XML_EVENT_COMMENT:
 					{
-						if(pBuf[x - 1] == '-' && pBuf[x - 2] == '-')
-						{
-							sNext = x + 1;
-							return x - sOffset - 2;
-						}
+						if(cur.pCurrentNode == GNIL)
+							break;
+						p = reader.GetValue(sLen);
+						this->read_string(p, p + sLen, m_strTempW);
+						this->WriteNode(cur, GAIA::XML::XML_NODE_COMMENT, m_strTempW.fptr());
 					}
+					break;
+				default:
+					break;
 				}
 			}
-			return GINVALID;
-		}
-		GINL GAIA::NUM XML::load_node_name(GAIA::U8* pBuf, GAIA::NUM sSize, GAIA::NUM sOffset, GAIA::NUM& sNext) const
-		{
-			for(GAIA::NUM x = sOffset; x < sSize; ++x)
-			{
-				if(GAIA::ALGO::isblank(pBuf[x]) || GAIA::ALGO::isspecial(pBuf[x]))
-				{
-					sNext = x + 1;
-					return x - sOffset;
-				}
-			}
-			return GINVALID;
-		}
-		GINL GAIA::NUM XML::load_name(GAIA::U8* pBuf, GAIA::NUM sSize, GAIA::NUM sOffset, GAIA::NUM& sNext) const
-		{
-			for(GAIA::NUM x = sOffset; x < sSize; ++x)
-			{
-				if(GAIA::ALGO::isblank(pBuf[x]) || GAIA::ALGO::isspecial(pBuf[x]) || pBuf[x] == '=')
-				{
-					sNext = x + 1;
-					return x - sOffset;
-				}
-			}
-			return GINVALID;
+
+			m_strTempW.destroy();
+
+			return bRet;
 		}
-		GINL GAIA::NUM XML::load_value(GAIA::U8* pBuf, GAIA::NUM sSize, GAIA::NUM sOffset, GAIA::NUM& sNext) const
+		GINL GAIA::GVOID XML::read_string(const GAIA::U8* pBegin, const GAIA::U8* pEnd, GAIA::CTN::WString& strResult) const
 		{
-			for(GAIA::NUM x = sOffset; x < sSize; ++x)
+			GAST(pEnd - pBegin >= 0);
+			if(pEnd == pBegin)
 			{
-				if(pBuf[x] == '\"')
-				{
-					sNext = x + 1;
-					return x - sOffset;
-				}
+				strResult.clear();
+				return;
 			}
-			return GINVALID;
-		}
-		GINL GAIA::GVOID XML::read_string(const GAIA::U8* pBegin, const GAIA::U8* pEnd, GAIA::CTN::WString& strResult) const
-		{
-			GAST(pEnd - pBegin > 0);
 			strResult.resize(GSCAST(GAIA::NUM)(pEnd - pBegin));
 			GAIA::NUM sLenWChar = GAIA::LOCALE::m2w(pBegin, GSCAST(GAIA::NUM)(pEnd - pBegin), strResult.fptr(), strResult.size(), GAIA::CHARSET_TYPE_UTF8);
 			strResult.resize(sLenWChar);
@@ -23,6 +23,17 @@ namespace GAIA
 			XML_SAVE_BESTREAD,
 		GAIA_ENUM_END(XML_SAVE)
 
+		GAIA_ENUM_BEGIN(XML_EVENT)
+			XML_EVENT_HEAD,			// Like <?xml version="1.0" encoding="utf-8"?>
+			XML_EVENT_STARTELEMENT,	// Like <NODE1> or <NODE1/> 's begin
+			XML_EVENT_ATTRIBUTE,	// Like a="abc"
+			XML_EVENT_TEXT,			// Like abcdef in <NODE3>abcdef</NODE3>
+			XML_EVENT_ENDELEMENT,	// Like </NODE1> or <NODE1/> 's end
+			XML_EVENT_COMMENT,		// Like <!--comment content-->
+			XML_EVENT_END,			// The source is end
+			XML_EVENT_ERROR,		// The source is invalid
+		GAIA_ENUM_END(XML_EVENT)
+
 		static const GAIA::TCH XML_DEFAULT_ROOT_NODE_NAME[] = _T("XML_ROOT");
 
 		GINL GAIA::BL XMLCheckNodeName(GAIA::XML::XML_NODE nt, const GAIA::TCH* pszNodeName)
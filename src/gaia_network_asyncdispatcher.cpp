@@ -2,6 +2,7 @@
 #include <gaia_assert.h>
 #include <gaia_network_asyncdispatcher.h>
 #include <gaia_assert_impl.h>
+#include <gaia_sync_base.h>
 #include <gaia_thread_base_impl.h>
 
 #if GAIA_OS == GAIA_OS_WINDOWS
@@ -12,7 +13,10 @@
 #	include <sys/time.h>
 #	include <unistd.h>
 #elif GAIA_OS == GAIA_OS_LINUX || GAIA_OS == GAIA_OS_ANDROID
-
+#	include <sys/epoll.h>
+#	include <unistd.h>
+#	include <fcntl.h>
+#	include <errno.h>
 #endif
 
 namespace GAIA
@@ -30,6 +34,21 @@ namespace GAIA
 				this->End();
 		}
 
+		GAIA::BL AsyncDispatcher::SetThreadCount(GAIA::NUM sThreadCount)
+		{
+			if(this->IsBegin())
+				return GAIA::False;
+			if(sThreadCount <= 0)
+				return GAIA::False;
+			m_sThreadCount = sThreadCount;
+			return GAIA::True;
+		}
+
+		GAIA::NUM AsyncDispatcher::GetThreadCount() const
+		{
+			return m_sThreadCount;
+		}
+
 		GAIA::BL AsyncDispatcher::Begin()
 		{
 			if(this->IsBegin())
@@ -41,8 +60,39 @@ namespace GAIA
 		#elif GAIA_OS == GAIA_OS_OSX || GAIA_OS == GAIA_OS_IOS || GAIA_OS == GAIA_OS_UNIX
 			m_kqueue = kqueue();
 		#elif GAIA_OS == GAIA_OS_LINUX || GAIA_OS == GAIA_OS_ANDROID
-			m_epoll = epoll_create();
+			m_epoll = epoll_create(DISPATCH_EVENT_COUNT);
+			if(m_epoll == GINVALID)
+				return GAIA::False;
+
+			// The wake pipe is registered in level triggered mode and never be read,
+			// so after End write it, all the dispatch threads will be wake up.
+			if(pipe(m_wakepipe) != 0)
+			{
+				close(m_epoll);
+				m_epoll = GINVALID;
+				return GAIA::False;
+			}
+			epoll_event e;
+			e.events = EPOLLIN;
+			e.data.ptr = GNIL;
+			if(epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wakepipe[0], &e) != 0)
+			{
+				close(m_wakepipe[0]);
+				close(m_wakepipe[1]);
+				close(m_epoll);
+				m_epoll = GINVALID;
+				return GAIA::False;
+			}
 		#endif
+
+			// Start dispatch threads.
+			m_bStopCmd = GAIA::False;
+			for(GAIA::NUM x = 0; x < m_sThreadCount; ++x)
+			{
+				DispatchThread* pThread = gnew DispatchThread(*this);
+				m_threads.push_back(pThread);
+				pThread->Start();
+			}
 			return GAIA::True;
 		}
 
@@ -51,6 +101,24 @@ namespace GAIA
 			if(!this->IsBegin())
 				return GAIA::False;
 
+			this->RemoveAsyncSocketAll();
+
+			// Stop dispatch threads.
+			m_bStopCmd = GAIA::True;
+		#if GAIA_OS == GAIA_OS_LINUX || GAIA_OS == GAIA_OS_ANDROID
+			GAIA::U8 uWake = 0;
+			while(write(m_wakepipe[1], &uWake, sizeof(uWake)) < 0 && errno == EINTR)
+			{
+			}
+		#endif
+			for(GAIA::NUM x = 0; x < m_threads.size(); ++x)
+			{
+				DispatchThread* pThread = m_threads[x];
+				pThread->Wait();
+				gdel pThread;
+			}
+			m_threads.clear();
+
 			// Close async controller in OS.
 		#if GAIA_OS == GAIA_OS_WINDOWS
 
@@ -58,9 +126,13 @@ namespace GAIA
 			close(m_kqueue);
 			m_kqueue = GINVALID;
 		#elif GAIA_OS == GAIA_OS_LINUX || GAIA_OS == GAIA_OS_ANDROID
+			close(m_wakepipe[0]);
+			close(m_wakepipe[1]);
+			m_wakepipe[0] = m_wakepipe[1] = GINVALID;
 			close(m_epoll);
 			m_epoll = GINVALID;
 		#endif
+			m_bStopCmd = GAIA::False;
 			return GAIA::True;
 		}
 
@@ -80,54 +152,101 @@ namespace GAIA
 
 		GAIA::BL AsyncDispatcher::AddAsyncSocket(GAIA::NETWORK::AsyncSocket& sock)
 		{
+			if(!this->IsBegin())
+				return GAIA::False;
+			if(!sock.IsCreated())
+				return GAIA::False;
+
 			GAIA::SYNC::AutolockW al(m_rwSockets);
 
-			// 
+			if(sock.m_pDispatcher != GNIL)
+				return GAIA::False;
+
+			// Hold the send lock until m_pDispatcher is set, a Send in other thread will watch the writable event after it.
+			GAIA::SYNC::Autolock alSend(sock.m_lrSend);
+			sock.m_bDispatching = GAIA::False;
+			sock.m_uPendingEvents = 0;
 
-			//
+			// Register to OS.
 		#if GAIA_OS == GAIA_OS_WINDOWS
 
 		#elif GAIA_OS == GAIA_OS_OSX || GAIA_OS == GAIA_OS_IOS || GAIA_OS == GAIA_OS_UNIX
 
 		#elif GAIA_OS == GAIA_OS_LINUX || GAIA_OS == GAIA_OS_ANDROID
-
+			if(!this->WatchAsyncSocket(sock, GAIA::True))
+				return GAIA::False;
 		#endif
 
+			// The event maybe come before here, the dispatch thread will wait the lock and find the node.
+			Node n;
+			n.pSock = &sock;
+			m_nodes_byptr.insert(n);
+			sock.m_pDispatcher = this;
+
 			return GAIA::True;
 		}
 
 		GAIA::BL AsyncDispatcher::RemoveAsyncSocket(GAIA::NETWORK::AsyncSocket& sock)
 		{
-			GAIA::SYNC::AutolockW al(m_rwSockets);
+			{
+				GAIA::SYNC::AutolockW al(m_rwSockets);
 
-			//
-		#if GAIA_OS == GAIA_OS_WINDOWS
+				if(sock.m_pDispatcher != this)
+					return GAIA::False;
+				Node n;
+				n.pSock = &sock;
+				if(!m_nodes_byptr.erase(n))
+					return GAIA::False;
 
-		#elif GAIA_OS == GAIA_OS_OSX || GAIA_OS == GAIA_OS_IOS || GAIA_OS == GAIA_OS_UNIX
+				// Unregister from OS.
+			#if GAIA_OS == GAIA_OS_WINDOWS
 
-		#elif GAIA_OS == GAIA_OS_LINUX || GAIA_OS == GAIA_OS_ANDROID
+			#elif GAIA_OS == GAIA_OS_OSX || GAIA_OS == GAIA_OS_IOS || GAIA_OS == GAIA_OS_UNIX
 
-		#endif
+			#elif GAIA_OS == GAIA_OS_LINUX || GAIA_OS == GAIA_OS_ANDROID
+				epoll_event e;
+				e.events = 0;
+				e.data.ptr = GNIL;
+				epoll_ctl(m_epoll, EPOLL_CTL_DEL, sock.GetFileDescriptor(), &e);
+			#endif
+
+				sock.m_pDispatcher = GNIL;
+			}
 
-			//
+			// The events fetched already will be discarded because the node is not exist,
+			// but the socket maybe in dispatching now.
+			this->WaitDispatching(&sock);
 
 			return GAIA::True;
 		}
 
 		GAIA::BL AsyncDispatcher::RemoveAsyncSocketAll()
 		{
-			GAIA::SYNC::AutolockW al(m_rwSockets);
+			{
+				GAIA::SYNC::AutolockW al(m_rwSockets);
 
-			//
-		#if GAIA_OS == GAIA_OS_WINDOWS
+				for(GAIA::CTN::Set<Node>::it it = m_nodes_byptr.frontit(); !it.empty(); ++it)
+				{
+					GAIA::NETWORK::AsyncSocket* pSock = (*it).pSock;
 
-		#elif GAIA_OS == GAIA_OS_OSX || GAIA_OS == GAIA_OS_IOS || GAIA_OS == GAIA_OS_UNIX
+					// Unregister from OS.
+				#if GAIA_OS == GAIA_OS_WINDOWS
 
-		#elif GAIA_OS == GAIA_OS_LINUX || GAIA_OS == GAIA_OS_ANDROID
+				#elif GAIA_OS == GAIA_OS_OSX || GAIA_OS == GAIA_OS_IOS || GAIA_OS == GAIA_OS_UNIX
 
-		#endif
+				#elif GAIA_OS == GAIA_OS_LINUX || GAIA_OS == GAIA_OS_ANDROID
+					epoll_event e;
+					e.events = 0;
+					e.data.ptr = GNIL;
+					epoll_ctl(m_epoll, EPOLL_CTL_DEL, pSock->GetFileDescriptor(), &e);
+				#endif
 
-			//
+					pSock->m_pDispatcher = GNIL;
+				}
+				m_nodes_byptr.clear();
+			}
+
+			this->WaitDispatching(GNIL);
 
 			return GAIA::True;
 		}
@@ -135,29 +254,174 @@ namespace GAIA
 		GAIA::BL AsyncDispatcher::IsExistAsyncSocket(GAIA::NETWORK::AsyncSocket& sock) const
 		{
 			GAIA::SYNC::AutolockR al(GCCAST(AsyncDispatcher*)(this)->m_rwSockets);
-
-			//
-
-			//
-
-			return GAIA::True;
+			Node n;
+			n.pSock = &sock;
+			return m_nodes_byptr.find(n) != GNIL;
 		}
 
 		GAIA::NUM AsyncDispatcher::GetAsyncSocketCount() const
 		{
 			GAIA::SYNC::AutolockR al(GCCAST(AsyncDispatcher*)(this)->m_rwSockets);
-			return m_nodes_byaddrptr.size();
+			return m_nodes_byptr.size();
+		}
+
+		GAIA::BL AsyncDispatcher::CollectSocket(CallBack& cb) const
+		{
+			GAIA::SYNC::AutolockR al(GCCAST(AsyncDispatcher*)(this)->m_rwSockets);
+			for(GAIA::CTN::Set<Node>::const_it it = m_nodes_byptr.const_frontit(); !it.empty(); ++it)
+			{
+				if(!cb.OnCollect(*GCCAST(AsyncDispatcher*)(this), *(*it).pSock))
+					break;
+			}
+			return GAIA::True;
 		}
 
 		GAIA::GVOID AsyncDispatcher::init()
 		{
+			m_sThreadCount = DEFAULT_THREAD_COUNT;
+			m_bStopCmd = GAIA::False;
 		#if GAIA_OS == GAIA_OS_WINDOWS
 			
 		#elif GAIA_OS == GAIA_OS_OSX || GAIA_OS == GAIA_OS_IOS || GAIA_OS == GAIA_OS_UNIX
 			m_kqueue = GINVALID;
 		#elif GAIA_OS == GAIA_OS_LINUX || GAIA_OS == GAIA_OS_ANDROID
 			m_epoll = GINVALID;
+			m_wakepipe[0] = m_wakepipe[1] = GINVALID;
+		#endif
+		}
+
+		GAIA::GVOID AsyncDispatcher::Execute(DispatchThread& th)
+		{
+		#if GAIA_OS == GAIA_OS_WINDOWS
+
+		#elif GAIA_OS == GAIA_OS_OSX || GAIA_OS == GAIA_OS_IOS || GAIA_OS == GAIA_OS_UNIX
+
+		#elif GAIA_OS == GAIA_OS_LINUX || GAIA_OS == GAIA_OS_ANDROID
+			epoll_event events[DISPATCH_EVENT_COUNT];
+			for(;;)
+			{
+				GAIA::N32 nCount = epoll_wait(m_epoll, events, DISPATCH_EVENT_COUNT, -1);
+				if(nCount < 0)
+				{
+					if(errno == EINTR)
+						continue;
+					break;
+				}
+				for(GAIA::N32 x = 0; x < nCount; ++x)
+				{
+					epoll_event& e = events[x];
+
+					// Wake up by End.
+					if(e.data.ptr == GNIL)
+					{
+						if(m_bStopCmd)
+							return;
+						continue;
+					}
+
+					// The socket maybe removed after the event fetched.
+					// It maybe fetched by other thread too when a send armed it before the dispatching flag set,
+					// the events are left to the dispatching thread.
+					GAIA::NETWORK::AsyncSocket* pSock = GSCAST(GAIA::NETWORK::AsyncSocket*)(e.data.ptr);
+					{
+						GAIA::SYNC::AutolockR al(m_rwSockets);
+						Node n;
+						n.pSock = pSock;
+						if(m_nodes_byptr.find(n) == GNIL)
+							continue;
+						GAIA::SYNC::Autolock alsend(pSock->m_lrSend);
+						if(pSock->m_bDispatching)
+						{
+							pSock->m_uPendingEvents |= e.events;
+							continue;
+						}
+						pSock->m_bDispatching = GAIA::True;
+						GAIA::SYNC::Autolock alth(th.m_lrDispatching);
+						th.m_pDispatching = pSock;
+					}
+
+					GAIA::U32 uEvents = e.events;
+					for(;;)
+					{
+						// Write first, the connecting socket need to be confirmed before read.
+						if(uEvents & (EPOLLOUT | EPOLLERR | EPOLLHUP))
+							pSock->DispatchWrite();
+						if(uEvents & (EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLHUP))
+							pSock->DispatchRead(th.m_buf, sizeof(th.m_buf));
+
+						// The socket is disabled by EPOLLONESHOT until armed again, so no other thread dispatch it at the same time.
+						// If it is removed in the callbacks, it is not armed.
+						GAIA::SYNC::AutolockR al(m_rwSockets);
+						Node n;
+						n.pSock = pSock;
+						if(m_nodes_byptr.find(n) == GNIL)
+							break;
+						GAIA::SYNC::Autolock alsend(pSock->m_lrSend);
+						if(pSock->m_uPendingEvents != 0)
+						{
+							uEvents = pSock->m_uPendingEvents;
+							pSock->m_uPendingEvents = 0;
+							continue;
+						}
+						this->WatchAsyncSocket(*pSock, GAIA::False);
+						pSock->m_bDispatching = GAIA::False;
+						break;
+					}
+
+					// Wake the threads which are waiting for the dispatching socket.
+					{
+						GAIA::SYNC::Autolock al(th.m_lrDispatching);
+						th.m_pDispatching = GNIL;
+						for(; th.m_sWaitCount > 0; --th.m_sWaitCount)
+							th.m_evtDispatched.Fire();
+					}
+				}
+			}
+		#endif
+		}
+
+		GAIA::BL AsyncDispatcher::WatchAsyncSocket(GAIA::NETWORK::AsyncSocket& sock, GAIA::BL bAdd)
+		{
+			// The m_lrSend of the socket must be locked, the writable event is watched only if there is something to write.
+		#if GAIA_OS == GAIA_OS_WINDOWS
+
+		#elif GAIA_OS == GAIA_OS_OSX || GAIA_OS == GAIA_OS_IOS || GAIA_OS == GAIA_OS_UNIX
+
+		#elif GAIA_OS == GAIA_OS_LINUX || GAIA_OS == GAIA_OS_ANDROID
+			epoll_event e;
+			e.events = EPOLLIN | EPOLLRDHUP | EPOLLET | EPOLLONESHOT;
+			if(sock.m_bConnecting || !sock.m_sendqueue.empty())
+				e.events |= EPOLLOUT;
+			e.data.ptr = &sock;
+			if(epoll_ctl(m_epoll, bAdd ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, sock.GetFileDescriptor(), &e) != 0)
+				return GAIA::False;
 		#endif
+			return GAIA::True;
+		}
+
+		GAIA::GVOID AsyncDispatcher::WaitDispatching(GAIA::NETWORK::AsyncSocket* pSock)
+		{
+			// The socket could be removed by it's own callback, so skip current thread.
+			GAIA::UM uThreadID = GAIA::THREAD::threadid();
+			for(GAIA::NUM x = 0; x < m_threads.size(); ++x)
+			{
+				DispatchThread* pThread = m_threads[x];
+				if(pThread->m_uThreadID == uThreadID)
+					continue;
+				for(;;)
+				{
+					{
+						GAIA::SYNC::Autolock al(pThread->m_lrDispatching);
+						GAIA::NETWORK::AsyncSocket* pDispatching = pThread->m_pDispatching;
+						if(pDispatching == GNIL)
+							break;
+						if(pSock != GNIL && pDispatching != pSock)
+							break;
+						++pThread->m_sWaitCount;
+					}
+					pThread->m_evtDispatched.Wait((GAIA::U32)GINVALID);
+				}
+			}
 		}
 	}
 }
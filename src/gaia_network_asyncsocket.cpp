@@ -1,13 +1,37 @@
 ﻿#include <gaia_type.h>
 #include <gaia_assert.h>
 #include <gaia_network_asyncsocket.h>
+#include <gaia_network_asyncdispatcher.h>
 #include <gaia_assert_impl.h>
 #include <gaia_thread_base_impl.h>
+#include <gaia_network_base_impl.h>
+#include <gaia_network_socket_impl.h>
+
+#if GAIA_OS == GAIA_OS_WINDOWS
+#	define GAIA_ASYNCSOCKET_WOULDBLOCK(err) ((err) == WSAEWOULDBLOCK)
+#	include <io.h>
+#else
+#	include <errno.h>
+#	include <sys/uio.h>
+#	if GAIA_OS == GAIA_OS_LINUX || GAIA_OS == GAIA_OS_ANDROID
+#		include <sys/sendfile.h>
+#	endif
+#	define GAIA_ASYNCSOCKET_WOULDBLOCK(err) ((err) == EAGAIN || (err) == EWOULDBLOCK)
+#endif
 
 namespace GAIA
 {
 	namespace NETWORK
 	{
+		static GAIA::N32 async_socket_lasterror()
+		{
+		#if GAIA_OS == GAIA_OS_WINDOWS
+			return WSAGetLastError();
+		#else
+			return errno;
+		#endif
+		}
+
 		AsyncSocket::AsyncSocket()
 		{
 			this->init();
@@ -15,116 +39,316 @@ namespace GAIA
 
 		AsyncSocket::~AsyncSocket()
 		{
-
+			GTRY
+			{
+				if(this->IsCreated())
+					this->Close();
+			}
+			GCATCH(Network)
+			{
+				e.SetDispatched(GAIA::True);
+			}
 		}
 
 		GAIA::GVOID AsyncSocket::Create()
 		{
-		#if GAIA_OS == GAIA_OS_WINDOWS
-
-		#elif GAIA_OS == GAIA_OS_OSX || GAIA_OS == GAIA_OS_IOS || GAIA_OS == GAIA_OS_UNIX
-
-		#elif GAIA_OS == GAIA_OS_LINUX || GAIA_OS == GAIA_OS_ANDROID
-
-		#endif
+			if(this->IsCreated())
+				GTHROW(Illegal);
+			m_sock.Create(GAIA::NETWORK::Socket::SOCKET_TYPE_STREAM);
+			m_sock.SetOption(GAIA::NETWORK::Socket::SOCKET_OPTION_NOBLOCK, GAIA::True);
+			this->OnCreated();
 		}
 
 		GAIA::GVOID AsyncSocket::Close()
 		{
-		#if GAIA_OS == GAIA_OS_WINDOWS
-
-		#elif GAIA_OS == GAIA_OS_OSX || GAIA_OS == GAIA_OS_IOS || GAIA_OS == GAIA_OS_UNIX
-
-		#elif GAIA_OS == GAIA_OS_LINUX || GAIA_OS == GAIA_OS_ANDROID
+			if(!this->IsCreated())
+				GTHROW(Illegal);
+
+			// Stop dispatch before the file descriptor closed, the descriptor maybe reused by other socket.
+			if(m_pDispatcher != GNIL)
+				m_pDispatcher->RemoveAsyncSocket(*this);
+
+			{
+				GAIA::SYNC::Autolock al(m_lrSend);
+				m_sock.Close();
+				this->ClearSendQueue();
+				m_bListen = GAIA::False;
+				m_bConnecting = GAIA::False;
+				m_bConnected = GAIA::False;
+			}
+
+			this->OnClosed();
+		}
 
-		#endif
+		GAIA::BL AsyncSocket::IsCreated() const
+		{
+			return m_sock.IsCreated();
 		}
 
 		GAIA::GVOID AsyncSocket::Shutdown(GAIA::N32 nShutdownFlag)
 		{
-		#if GAIA_OS == GAIA_OS_WINDOWS
-
-		#elif GAIA_OS == GAIA_OS_OSX || GAIA_OS == GAIA_OS_IOS || GAIA_OS == GAIA_OS_UNIX
-
-		#elif GAIA_OS == GAIA_OS_LINUX || GAIA_OS == GAIA_OS_ANDROID
-
-		#endif
+			m_sock.Shutdown(nShutdownFlag);
+			this->OnShutdowned(nShutdownFlag);
 		}
 
 		GAIA::GVOID AsyncSocket::Bind(const GAIA::NETWORK::Addr& addr)
 		{
-		#if GAIA_OS == GAIA_OS_WINDOWS
-
-		#elif GAIA_OS == GAIA_OS_OSX || GAIA_OS == GAIA_OS_IOS || GAIA_OS == GAIA_OS_UNIX
-
-		#elif GAIA_OS == GAIA_OS_LINUX || GAIA_OS == GAIA_OS_ANDROID
-
-		#endif
+			m_sock.Bind(addr);
+			this->OnBound(addr);
 		}
 
 		GAIA::BL AsyncSocket::IsBind() const
 		{
-			return GAIA::False;
+			if(!this->IsCreated())
+				return GAIA::False;
+			return m_sock.IsBinded();
 		}
 
-		GAIA::GVOID AsyncSocket::Connect(const GAIA::NETWORK::Addr& addr)
+		GAIA::GVOID AsyncSocket::Listen()
 		{
-		#if GAIA_OS == GAIA_OS_WINDOWS
-
-		#elif GAIA_OS == GAIA_OS_OSX || GAIA_OS == GAIA_OS_IOS || GAIA_OS == GAIA_OS_UNIX
+			if(!this->IsCreated())
+				GTHROW(Illegal);
+			if(m_bConnecting || m_bConnected)
+				GTHROW(Illegal);
+			m_sock.Listen();
+			m_bListen = GAIA::True;
+		}
 
-		#elif GAIA_OS == GAIA_OS_LINUX || GAIA_OS == GAIA_OS_ANDROID
+		GAIA::BL AsyncSocket::IsListen() const
+		{
+			return m_bListen;
+		}
 
-		#endif
+		GAIA::GVOID AsyncSocket::Connect(const GAIA::NETWORK::Addr& addr)
+		{
+			if(!addr.check())
+				GTHROW(InvalidParam);
+			if(!this->IsCreated())
+				GTHROW(Illegal);
+			if(m_bListen)
+				GTHROW(Illegal);
+
+			{
+				GAIA::SYNC::Autolock al(m_lrSend);
+
+				if(m_bConnecting || m_bConnected)
+					GTHROW(Illegal);
+
+				sockaddr_in saddr;
+				zeromem(&saddr);
+				saddr.sin_family = AF_INET;
+				addr2saddr(addr, &saddr);
+				m_addrPeer = addr;
+
+				if(connect(m_sock.m_nSocket, (sockaddr*)&saddr, sizeof(saddr)) == GINVALID)
+				{
+					GAIA::N32 nOSError = async_socket_lasterror();
+				#if GAIA_OS == GAIA_OS_WINDOWS
+					if(nOSError != WSAEWOULDBLOCK)
+				#else
+					if(nOSError != EINPROGRESS && nOSError != EINTR)
+				#endif
+						THROW_LASTERROR;
+
+					// The result will be confirmed when the socket writable.
+					m_bConnecting = GAIA::True;
+					this->WatchWrite();
+					return;
+				}
+
+				m_sock.m_bConnected = GAIA::True;
+				m_bConnected = GAIA::True;
+			}
+
+			this->OnConnected(addr);
+			this->FlushSendQueue();
 		}
 
 		GAIA::GVOID AsyncSocket::Disconnect()
 		{
-		#if GAIA_OS == GAIA_OS_WINDOWS
-
-		#elif GAIA_OS == GAIA_OS_OSX || GAIA_OS == GAIA_OS_IOS || GAIA_OS == GAIA_OS_UNIX
-
-		#elif GAIA_OS == GAIA_OS_LINUX || GAIA_OS == GAIA_OS_ANDROID
-
-		#endif
+			if(!this->IsCreated())
+				GTHROW(Illegal);
+			{
+				GAIA::SYNC::Autolock al(m_lrSend);
+				if(!m_bConnecting && !m_bConnected)
+					return;
+				m_sock.Shutdown(GAIA::NETWORK::Socket::SSDF_RECV | GAIA::NETWORK::Socket::SSDF_SEND);
+				m_sock.m_bConnected = GAIA::False;
+				m_bConnecting = GAIA::False;
+				m_bConnected = GAIA::False;
+			}
+			this->OnDisconnected();
 		}
 
 		GAIA::BL AsyncSocket::IsConnected() const
 		{
-			return GAIA::False;
+			return m_bConnected;
 		}
 
 		GAIA::GVOID AsyncSocket::Send(const GAIA::GVOID* pData, GAIA::NUM sSize)
 		{
-		#if GAIA_OS == GAIA_OS_WINDOWS
-
-		#elif GAIA_OS == GAIA_OS_OSX || GAIA_OS == GAIA_OS_IOS || GAIA_OS == GAIA_OS_UNIX
-
-		#elif GAIA_OS == GAIA_OS_LINUX || GAIA_OS == GAIA_OS_ANDROID
-
-		#endif
+			Slice s;
+			s.pData = pData;
+			s.sSize = sSize;
+			s.pCallBack = GNIL;
+			this->SendV(&s, 1);
 		}
 
-		GAIA::GVOID AsyncSocket::Recv(GAIA::GVOID* pData, GAIA::NUM sSize)
+		GAIA::GVOID AsyncSocket::SendV(const Slice* pSlices, GAIA::NUM sCount)
 		{
-		#if GAIA_OS == GAIA_OS_WINDOWS
-
-		#elif GAIA_OS == GAIA_OS_OSX || GAIA_OS == GAIA_OS_IOS || GAIA_OS == GAIA_OS_UNIX
+			if(pSlices == GNIL)
+				GTHROW(InvalidParam);
+			if(sCount <= 0)
+				GTHROW(InvalidParam);
+			for(GAIA::NUM x = 0; x < sCount; ++x)
+			{
+				if(pSlices[x].pData == GNIL)
+					GTHROW(InvalidParam);
+				if(pSlices[x].sSize <= 0)
+					GTHROW(InvalidParam);
+			}
+			if(!this->IsCreated())
+				GTHROW(Illegal);
+
+			GAIA::NUM sDone = 0;
+			GAIA::BL bError = GAIA::False;
+			{
+				GAIA::SYNC::Autolock al(m_lrSend);
+
+				// Write directly when there is no data queued, keep the data in order.
+				GAIA::NUM sOffset = 0;
+				if(m_sendqueue.empty() && m_bConnected)
+				{
+					while(sDone < sCount)
+					{
+						Slice batch[MAX_SLICE_BATCH];
+						GAIA::NUM sBatchCount = GAIA::ALGO::gmin(sCount - sDone, (GAIA::NUM)MAX_SLICE_BATCH);
+						GAIA::NUM sBatchSize = 0;
+						for(GAIA::NUM x = 0; x < sBatchCount; ++x)
+						{
+							batch[x] = pSlices[sDone + x];
+							sBatchSize += batch[x].sSize;
+						}
+						batch[0].pData = GSCAST(const GAIA::U8*)(batch[0].pData) + sOffset;
+						batch[0].sSize -= sOffset;
+						sBatchSize -= sOffset;
+
+						GAIA::NUM sSent = this->SendRawV(batch, sBatchCount);
+						if(sSent == GINVALID)
+						{
+							m_bConnected = GAIA::False;
+							m_sock.m_bConnected = GAIA::False;
+							bError = GAIA::True;
+							break;
+						}
+						sOffset += sSent;
+						while(sDone < sCount && sOffset >= pSlices[sDone].sSize)
+						{
+							sOffset -= pSlices[sDone].sSize;
+							++sDone;
+						}
+						if(sSent < sBatchSize)
+							break;
+					}
+				}
+
+				// Queue the slices not written, the slice without callback will be copied.
+				if(!bError)
+				{
+					for(GAIA::NUM x = sDone; x < sCount; ++x)
+					{
+						const Slice& s = pSlices[x];
+						SendNode n;
+						n.init();
+						if(s.pCallBack == GNIL)
+						{
+							GAIA::U8* p = gnew GAIA::U8[s.sSize];
+							GAIA::ALGO::gmemcpy(p, s.pData, s.sSize);
+							n.p = p;
+						}
+						else
+						{
+							n.p = GSCAST(const GAIA::U8*)(s.pData);
+							n.pCallBack = s.pCallBack;
+						}
+						n.lSize = s.sSize;
+						n.lOffset = x == sDone ? sOffset : 0;
+						m_sendqueue.push_back(n);
+						m_sSendingSize += (GAIA::NUM)(n.lSize - n.lOffset);
+					}
+					if(sDone < sCount && m_bConnected)
+						this->WatchWrite();
+				}
+			}
+
+			// The callbacks is called out of lock.
+			for(GAIA::NUM x = 0; x < sDone; ++x)
+			{
+				const Slice& s = pSlices[x];
+				this->OnSent(s.pData, s.sSize);
+				if(s.pCallBack != GNIL)
+					s.pCallBack->OnRelease(s.pData, s.sSize);
+			}
+			if(bError)
+			{
+				for(GAIA::NUM x = sDone; x < sCount; ++x)
+				{
+					const Slice& s = pSlices[x];
+					if(s.pCallBack != GNIL)
+						s.pCallBack->OnRelease(s.pData, s.sSize);
+				}
+				this->OnError();
+			}
+		}
 
-		#elif GAIA_OS == GAIA_OS_LINUX || GAIA_OS == GAIA_OS_ANDROID
+		GAIA::GVOID AsyncSocket::SendFile(GAIA::N32 nFile, const GAIA::N64& lOffset, const GAIA::N64& lSize)
+		{
+			if(nFile == GINVALID)
+				GTHROW(InvalidParam);
+			if(lOffset < 0)
+				GTHROW(InvalidParam);
+			if(lSize <= 0)
+				GTHROW(InvalidParam);
+			if(!this->IsCreated())
+				GTHROW(Illegal);
+
+			// The file is always queued, it will be sent now if the queue is empty.
+			{
+				GAIA::SYNC::Autolock al(m_lrSend);
+				SendNode n;
+				n.init();
+				n.nFile = nFile;
+				n.lFileOffset = lOffset;
+				n.lSize = lSize;
+				m_sendqueue.push_back(n);
+				m_sSendingSize += (GAIA::NUM)lSize;
+			}
+			this->FlushSendQueue();
+		}
 
-		#endif
+		GAIA::NUM AsyncSocket::Recv(GAIA::GVOID* pData, GAIA::NUM sSize)
+		{
+			if(pData == GNIL)
+				GTHROW(InvalidParam);
+			if(sSize <= 0)
+				GTHROW(InvalidParam);
+			if(!this->IsCreated())
+				GTHROW(Illegal);
+
+			GAIA::SYNC::Autolock al(m_lrRecv);
+			return m_sock.Recv(pData, (GAIA::N32)sSize);
 		}
 
 		GAIA::GVOID AsyncSocket::Flush()
 		{
-		#if GAIA_OS == GAIA_OS_WINDOWS
-
-		#elif GAIA_OS == GAIA_OS_OSX || GAIA_OS == GAIA_OS_IOS || GAIA_OS == GAIA_OS_UNIX
+			if(!this->IsCreated())
+				GTHROW(Illegal);
+			this->DispatchWrite();
+		}
 
-		#elif GAIA_OS == GAIA_OS_LINUX || GAIA_OS == GAIA_OS_ANDROID
-			
-		#endif
+		GAIA::NUM AsyncSocket::GetSendingSize() const
+		{
+			return m_sSendingSize;
 		}
 
 		GAIA::N32 AsyncSocket::GetFileDescriptor() const
@@ -144,7 +368,391 @@ namespace GAIA
 
 		GAIA::GVOID AsyncSocket::init()
 		{
+			m_pDispatcher = GNIL;
+			m_sSendingSize = 0;
+			m_bListen = GAIA::False;
+			m_bConnecting = GAIA::False;
+			m_bConnected = GAIA::False;
+			m_bDispatching = GAIA::False;
+			m_uPendingEvents = 0;
+		}
 
+		GAIA::GVOID AsyncSocket::ClearSendQueue()
+		{
+			for(; !m_sendqueue.empty(); m_sendqueue.pop_front())
+				this->ReleaseSendNode(m_sendqueue.front());
+			m_sSendingSize = 0;
+		}
+
+		GAIA::GVOID AsyncSocket::ReleaseSendNode(SendNode& n)
+		{
+			if(n.nFile != GINVALID)
+				return;
+			if(n.pCallBack != GNIL)
+				n.pCallBack->OnRelease(n.p, (GAIA::NUM)n.lSize);
+			else
+				gdel[] GCCAST(GAIA::U8*)(n.p);
+		}
+
+		GAIA::NUM AsyncSocket::SendRawV(const Slice* pSlices, GAIA::NUM sCount)
+		{
+			GAST(sCount > 0 && sCount <= MAX_SLICE_BATCH);
+
+		#if GAIA_OS == GAIA_OS_WINDOWS
+			WSABUF bufs[MAX_SLICE_BATCH];
+			for(GAIA::NUM x = 0; x < sCount; ++x)
+			{
+				bufs[x].buf = (GAIA::CH*)pSlices[x].pData;
+				bufs[x].len = (ULONG)pSlices[x].sSize;
+			}
+			DWORD dwSent = 0;
+			if(WSASend(m_sock.m_nSocket, bufs, (DWORD)sCount, &dwSent, 0, GNIL, GNIL) != 0)
+			{
+				if(GAIA_ASYNCSOCKET_WOULDBLOCK(async_socket_lasterror()))
+					return 0;
+				return GINVALID;
+			}
+			return (GAIA::NUM)dwSent;
+		#else
+			iovec bufs[MAX_SLICE_BATCH];
+			for(GAIA::NUM x = 0; x < sCount; ++x)
+			{
+				bufs[x].iov_base = (GAIA::GVOID*)pSlices[x].pData;
+				bufs[x].iov_len = (size_t)pSlices[x].sSize;
+			}
+			msghdr msg;
+			zeromem(&msg);
+			msg.msg_iov = bufs;
+			msg.msg_iovlen = sCount;
+
+			// The kernel could accept part of the data, the caller will try again when the socket writable.
+			for(;;)
+			{
+			#if GAIA_OS == GAIA_OS_LINUX || GAIA_OS == GAIA_OS_ANDROID
+				ssize_t nResult = sendmsg(m_sock.m_nSocket, &msg, MSG_NOSIGNAL);
+			#else
+				ssize_t nResult = sendmsg(m_sock.m_nSocket, &msg, 0);
+			#endif
+				if(nResult >= 0)
+					return (GAIA::NUM)nResult;
+				GAIA::N32 nOSError = async_socket_lasterror();
+				if(nOSError == EINTR)
+					continue;
+				if(GAIA_ASYNCSOCKET_WOULDBLOCK(nOSError))
+					return 0;
+				return GINVALID;
+			}
+		#endif
+		}
+
+		GAIA::N64 AsyncSocket::SendRawFile(GAIA::N32 nFile, const GAIA::N64& lOffset, const GAIA::N64& lSize)
+		{
+			GAIA::N64 lSent = 0;
+			while(lSent < lSize)
+			{
+				GAIA::N64 lResult;
+			#if GAIA_OS == GAIA_OS_LINUX || GAIA_OS == GAIA_OS_ANDROID
+				off_t nOffset = (off_t)(lOffset + lSent);
+				size_t sCount = (size_t)GAIA::ALGO::gmin(lSize - lSent, (GAIA::N64)SENDFILE_BLOCK_SIZE);
+				lResult = (GAIA::N64)sendfile(m_sock.m_nSocket, nFile, &nOffset, sCount);
+				if(lResult == 0)
+					return GINVALID; // The file is shorter than the range.
+			#else
+				// Without sendfile, read the file to a stack buffer and send it.
+				GAIA::U8 buf[1024 * 16];
+				GAIA::N32 nCount = (GAIA::N32)GAIA::ALGO::gmin(lSize - lSent, (GAIA::N64)sizeof(buf));
+			#	if GAIA_OS == GAIA_OS_WINDOWS
+				if(_lseeki64(nFile, lOffset + lSent, SEEK_SET) < 0)
+					return GINVALID;
+				GAIA::N32 nRead = _read(nFile, buf, nCount);
+			#	else
+				GAIA::N32 nRead = (GAIA::N32)pread(nFile, buf, nCount, (off_t)(lOffset + lSent));
+			#	endif
+				if(nRead <= 0)
+					return GINVALID;
+				Slice s;
+				s.pData = buf;
+				s.sSize = nRead;
+				s.pCallBack = GNIL;
+				lResult = this->SendRawV(&s, 1);
+				if(lResult == 0)
+					break;
+			#endif
+				if(lResult < 0)
+				{
+					GAIA::N32 nOSError = async_socket_lasterror();
+				#if GAIA_OS != GAIA_OS_WINDOWS
+					if(nOSError == EINTR)
+						continue;
+				#endif
+					if(GAIA_ASYNCSOCKET_WOULDBLOCK(nOSError))
+						break;
+					return GINVALID;
+				}
+				lSent += lResult;
+			}
+			return lSent;
+		}
+
+		GAIA::BL AsyncSocket::FlushSendQueue()
+		{
+			GAIA::BL bFlushed = GAIA::False;
+			for(;;)
+			{
+				SendNode done[MAX_SLICE_BATCH];
+				GAIA::NUM sDoneCount = 0;
+				GAIA::BL bError = GAIA::False;
+				GAIA::BL bBlocked = GAIA::False;
+				{
+					GAIA::SYNC::Autolock al(m_lrSend);
+					if(!m_bConnected || m_sendqueue.empty())
+						break;
+
+					SendNode& front = m_sendqueue.front();
+					if(front.nFile != GINVALID)
+					{
+						GAIA::N64 lSent = this->SendRawFile(front.nFile, front.lFileOffset + front.lOffset, front.lSize - front.lOffset);
+						if(lSent == GINVALID)
+							bError = GAIA::True;
+						else
+						{
+							front.lOffset += lSent;
+							m_sSendingSize -= (GAIA::NUM)lSent;
+							if(front.lOffset < front.lSize)
+								bBlocked = GAIA::True;
+							else
+							{
+								done[sDoneCount++] = front;
+								m_sendqueue.pop_front();
+							}
+						}
+					}
+					else
+					{
+						// Gather the continuous memory nodes, and write them by one call.
+						Slice batch[MAX_SLICE_BATCH];
+						GAIA::NUM sBatchCount = 0;
+						GAIA::NUM sBatchSize = 0;
+						for(; sBatchCount < m_sendqueue.size() && sBatchCount < MAX_SLICE_BATCH; ++sBatchCount)
+						{
+							const SendNode& n = m_sendqueue[sBatchCount];
+							if(n.nFile != GINVALID)
+								break;
+							batch[sBatchCount].pData = n.p + n.lOffset;
+							batch[sBatchCount].sSize = (GAIA::NUM)(n.lSize - n.lOffset);
+							batch[sBatchCount].pCallBack = GNIL;
+							sBatchSize += batch[sBatchCount].sSize;
+						}
+						GAIA::NUM sSent = this->SendRawV(batch, sBatchCount);
+						if(sSent == GINVALID)
+							bError = GAIA::True;
+						else
+						{
+							if(sSent < sBatchSize)
+								bBlocked = GAIA::True;
+							m_sSendingSize -= sSent;
+							while(sSent > 0)
+							{
+								SendNode& n = m_sendqueue.front();
+								GAIA::NUM sRemain = (GAIA::NUM)(n.lSize - n.lOffset);
+								if(sSent < sRemain)
+								{
+									n.lOffset += sSent;
+									break;
+								}
+								sSent -= sRemain;
+								n.lOffset = n.lSize;
+								done[sDoneCount++] = n;
+								m_sendqueue.pop_front();
+							}
+						}
+					}
+
+					if(bError)
+					{
+						this->ClearSendQueue();
+						m_bConnected = GAIA::False;
+						m_sock.m_bConnected = GAIA::False;
+					}
+					else if(m_sendqueue.empty())
+						bFlushed = GAIA::True;
+					else if(bBlocked)
+						this->WatchWrite();
+				}
+
+				// The callbacks is called out of lock.
+				for(GAIA::NUM x = 0; x < sDoneCount; ++x)
+				{
+					SendNode& n = done[x];
+					if(n.nFile != GINVALID)
+						this->OnSentFile(n.nFile, n.lFileOffset, n.lSize);
+					else
+						this->OnSent(n.p, (GAIA::NUM)n.lSize);
+					this->ReleaseSendNode(n);
+				}
+				if(bError)
+				{
+					this->OnError();
+					return GAIA::False;
+				}
+				if(bBlocked)
+					return GAIA::False;
+			}
+			if(bFlushed)
+				this->OnFlushed();
+			return GAIA::True;
+		}
+
+		GAIA::GVOID AsyncSocket::DispatchAccept()
+		{
+			for(;;)
+			{
+				sockaddr_in saddr;
+				socklen_t saddrlen = sizeof(saddr);
+				GAIA::N32 nNewSocket = (GAIA::N32)accept(m_sock.m_nSocket, (sockaddr*)&saddr, &saddrlen);
+				if(nNewSocket == GINVALID)
+				{
+					GAIA::N32 nOSError = async_socket_lasterror();
+					if(GAIA_ASYNCSOCKET_WOULDBLOCK(nOSError))
+						break;
+				#if GAIA_OS != GAIA_OS_WINDOWS
+					// The connection aborted before accepted, try next one.
+					if(nOSError == EINTR || nOSError == ECONNABORTED)
+						continue;
+				#endif
+					this->OnError();
+					break;
+				}
+
+				GAIA::NETWORK::Addr addrPeer;
+				saddr2addr(&saddr, addrPeer);
+
+				// Refused by user.
+				GAIA::NETWORK::AsyncSocket* pNewSock = this->OnAccepting(addrPeer);
+				if(pNewSock == GNIL || pNewSock->IsCreated())
+				{
+				#if GAIA_OS == GAIA_OS_WINDOWS
+					closesocket(nNewSocket);
+				#else
+					close(nNewSocket);
+				#endif
+					continue;
+				}
+
+				// Attach the descriptor to new socket.
+				GAIA::NETWORK::Socket& sock = pNewSock->m_sock;
+				sock.m_nSocket = nNewSocket;
+				sock.m_SockType = GAIA::NETWORK::Socket::SOCKET_TYPE_STREAM;
+				sock.m_bBinded = GAIA::True;
+				sock.m_bConnected = GAIA::True;
+				sock.SetOption(GAIA::NETWORK::Socket::SOCKET_OPTION_NOBLOCK, GAIA::True);
+				pNewSock->m_addrPeer = addrPeer;
+				pNewSock->m_bConnected = GAIA::True;
+				pNewSock->OnConnected(addrPeer);
+
+				// Dispatch after OnConnected, so the recv callback will not come before it.
+				if(m_pDispatcher != GNIL)
+					m_pDispatcher->AddAsyncSocket(*pNewSock);
+				this->OnAccepted(*pNewSock);
+			}
+		}
+
+		GAIA::GVOID AsyncSocket::DispatchRead(GAIA::U8* pBuf, GAIA::NUM sBufSize)
+		{
+			if(m_bListen)
+			{
+				GAIA::SYNC::Autolock al(m_lrRecv);
+				this->DispatchAccept();
+				return;
+			}
+
+			GAIA::SYNC::Autolock al(m_lrRecv);
+
+			// In edge triggered mode, must read until would block.
+			while(m_bConnected)
+			{
+				GAIA::N32 nRecved = (GAIA::N32)recv(m_sock.m_nSocket, (GAIA::CH*)pBuf, (GAIA::N32)sBufSize, 0);
+				if(nRecved > 0)
+				{
+					this->OnRecved(pBuf, nRecved);
+					continue;
+				}
+
+				if(nRecved < 0)
+				{
+					GAIA::N32 nOSError = async_socket_lasterror();
+					if(GAIA_ASYNCSOCKET_WOULDBLOCK(nOSError))
+						break;
+				#if GAIA_OS != GAIA_OS_WINDOWS
+					if(nOSError == EINTR)
+						continue;
+				#endif
+				}
+
+				// Closed by peer or error occurred.
+				{
+					GAIA::SYNC::Autolock alSend(m_lrSend);
+					if(!m_bConnected)
+						break;
+					m_bConnected = GAIA::False;
+					m_sock.m_bConnected = GAIA::False;
+				}
+				if(nRecved < 0)
+					this->OnError();
+				this->OnDisconnected();
+				break;
+			}
+		}
+
+		GAIA::GVOID AsyncSocket::DispatchWrite()
+		{
+			// Confirm the connect result.
+			GAIA::BL bConnected = GAIA::False;
+			GAIA::BL bConnectFailed = GAIA::False;
+			{
+				GAIA::SYNC::Autolock al(m_lrSend);
+				if(m_bConnecting)
+				{
+					GAIA::N32 nError = 0;
+					socklen_t nErrorLen = sizeof(nError);
+					if(getsockopt(m_sock.m_nSocket, SOL_SOCKET, SO_ERROR, (GAIA::CH*)&nError, &nErrorLen) != 0)
+						nError = async_socket_lasterror();
+					if(nError == 0)
+					{
+						m_bConnecting = GAIA::False;
+						m_bConnected = GAIA::True;
+						m_sock.m_bConnected = GAIA::True;
+						bConnected = GAIA::True;
+					}
+				#if GAIA_OS != GAIA_OS_WINDOWS
+					else if(nError == EINPROGRESS)
+					{
+					}
+				#endif
+					else
+					{
+						m_bConnecting = GAIA::False;
+						bConnectFailed = GAIA::True;
+					}
+				}
+			}
+			if(bConnectFailed)
+			{
+				this->OnError();
+				return;
+			}
+			if(bConnected)
+				this->OnConnected(m_addrPeer);
+
+			this->FlushSendQueue();
+		}
+
+		GAIA::GVOID AsyncSocket::WatchWrite()
+		{
+			// The m_lrSend must be locked. The dispatching socket will be armed by the dispatch thread after the callbacks.
+			GAIA::NETWORK::AsyncDispatcher* pDispatcher = m_pDispatcher;
+			if(pDispatcher != GNIL && !m_bDispatching)
+				pDispatcher->WatchAsyncSocket(*this, GAIA::False);
 		}
 	}
 }
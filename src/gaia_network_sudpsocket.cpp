@@ -1,44 +1,25 @@
 ﻿/*
 	[Lock sequence]
 
-	========================================================================================================================================
-	Flow\Lock		m_lrExecute		m_rwSendCache	m_rwSent	m_rwRecv	m_lrLinkPool	m_lrNodePool	m_lrBufferPool	m_rwDisconnected
-
-	SendTo
-
-	RecvFrom													|-------------------------->|
-																|------------------------------------------>|
-
-	Execute			|-------------->|
-					|------------------------------>|---------------------------------------------------------------------->|
-					|------------------------------------------>|
-					|------------------------------------------------------>|
-					|---------------------------------------------------------------------->|
-					|-------------------------------------------------------------------------------------->|
-					|------------------------------------------>|---------->|
-					|------------------------------------------>|-------------------------->|
-					|------------------------------------------>|------------------------------------------>|
-					|------------------------------>|---------------------->|
-					|------------------------------>|-------------------------------------->|
-					|------------------------------>|------------------------------------------------------>|
-					|------------------------------------------------------------------------------------------------------>|
-
-	ResetConnection	|-------------->|------------------------------------------------------>|
-					|-------------->|---------------------------------------------------------------------->|
-					|------------------------------>|-------------------------------------->|
-					|------------------------------>|------------------------------------------------------>|
-					|------------------------------------------>|---------->|
-					|------------------------------------------>|-------------------------->|
-					|------------------------------------------>|------------------------------------------>|
+	The peers are hashed by network address into shards, all the state of a peer is guarded by the lock of it's shard(Shard::lr).
+	A flow never hold two shard locks at the same time, and the callbacks which could call back into the socket
+	(SUDPSocket::OnTimeout) are called out of the shard lock.
 
 	========================================================================================================================================
-	Flow\Lock		m_lrExecuteTimeout	m_lrExecuteSend		m_lrExecuteRecv		m_lrExecuteResend	m_lrExecuteRerecv
-
-	Full-Execute	|------------------>|------------------>|------------------>|------------------>|
+	Flow\Lock		m_lrExecuteRecv	Shard::lr
+
+	SendTo							|
+	RecvFrom						|
+	Execute(Recv)	|-------------->|
+	ExecuteShard					|
+	ResetConnection					|
+	GetState						|
+	GetLinkInfo						|
 */
 
 #include <gaia_type.h>
 #include <gaia_assert.h>
+#include <gaia_time.h>
 #include <gaia_network_sudpsocket.h>
 #include <gaia_assert_impl.h>
 #include <gaia_thread_base_impl.h>
@@ -55,12 +36,15 @@ namespace GAIA
 		}
 		SUDPSocket::~SUDPSocket()
 		{
-
+			for(__BufferVectorType::it it = m_recvbufs.frontit(); !it.empty(); ++it)
+				gdel *it;
+			m_recvbufs.clear();
+			this->DestroyShards();
 		}
 		GAIA::GVOID SUDPSocket::Create()
 		{
-			m_recvbuf.resize(GAIA::NETWORK::GAIA_NETWORK_MTU);
 			m_sock.Create(GAIA::NETWORK::Socket::SOCKET_TYPE_DATAGRAM);
+			this->CreateShards();
 		}
 		GAIA::GVOID SUDPSocket::Close()
 		{
@@ -112,6 +96,28 @@ namespace GAIA
 		{
 			return m_uResendTime;
 		}
+		GAIA::GVOID SUDPSocket::SetMinResendTime(const GAIA::U64& uMinResendTime)
+		{
+			if(uMinResendTime == 0)
+				m_uMinResendTime = DEFAULT_MIN_RESEND_TIME;
+			else
+				m_uMinResendTime = uMinResendTime;
+		}
+		const GAIA::U64& SUDPSocket::GetMinResendTime() const
+		{
+			return m_uMinResendTime;
+		}
+		GAIA::GVOID SUDPSocket::SetMaxResendTime(const GAIA::U64& uMaxResendTime)
+		{
+			if(uMaxResendTime == 0)
+				m_uMaxResendTime = DEFAULT_MAX_RESEND_TIME;
+			else
+				m_uMaxResendTime = uMaxResendTime;
+		}
+		const GAIA::U64& SUDPSocket::GetMaxResendTime() const
+		{
+			return m_uMaxResendTime;
+		}
 		GAIA::GVOID SUDPSocket::SetRerecvTime(const GAIA::U64& uRerecvTime)
 		{
 			if(uRerecvTime == 0)
@@ -134,6 +140,56 @@ namespace GAIA
 		{
 			return m_uRecycleTime;
 		}
+		GAIA::GVOID SUDPSocket::SetBatchSize(GAIA::NUM sBatchSize)
+		{
+			if(sBatchSize < 0)
+				GTHROW(InvalidParam);
+			GAIA::SYNC::Autolock alexec(m_lrExecuteRecv);
+			if(sBatchSize == 0)
+				m_sBatchSize = DEFAULT_BATCH_SIZE;
+			else
+				m_sBatchSize = sBatchSize;
+		}
+		GAIA::NUM SUDPSocket::GetBatchSize() const
+		{
+			return m_sBatchSize;
+		}
+		GAIA::GVOID SUDPSocket::SetAckWindowSize(GAIA::NUM sAckWindowSize)
+		{
+			if(sAckWindowSize < 0)
+				GTHROW(InvalidParam);
+			if(sAckWindowSize == 0)
+				sAckWindowSize = DEFAULT_ACK_WINDOW_SIZE;
+			m_sAckWindowSize = (sAckWindowSize + 63) / 64 * 64;
+		}
+		GAIA::NUM SUDPSocket::GetAckWindowSize() const
+		{
+			return m_sAckWindowSize;
+		}
+		GAIA::GVOID SUDPSocket::SetShardCount(GAIA::NUM sShardCount)
+		{
+			if(sShardCount < 0)
+				GTHROW(InvalidParam);
+			if(this->IsCreated())
+				GTHROW(Illegal);
+			this->DestroyShards();
+			if(sShardCount == 0)
+				m_sShardCount = DEFAULT_SHARD_COUNT;
+			else
+				m_sShardCount = sShardCount;
+		}
+		GAIA::NUM SUDPSocket::GetShardCount() const
+		{
+			return m_sShardCount;
+		}
+		GAIA::NUM SUDPSocket::GetShardIndex(const GAIA::NETWORK::Addr& addr) const
+		{
+			if(!addr.check())
+				GTHROW(InvalidParam);
+			if(!this->IsCreated())
+				GTHROW(Illegal);
+			return this->ShardIndex(addr);
+		}
 		GAIA::N32 SUDPSocket::SendTo(const GAIA::NETWORK::Addr& addr, const GAIA::GVOID* p, GAIA::N32 nSize)
 		{
 			if(!addr.check())
@@ -145,36 +201,28 @@ namespace GAIA
 			if(!this->IsCreated())
 				GTHROW(Illegal);
 
-			// Allocate node.
-			Node* pNode;
-			{
-				GAIA::SYNC::Autolock al(m_lrNodePool);
-				pNode = m_nodepool.alloc();
-			}
+			GAIA::N64 lSerial;
+			GAIA::BL bSerial = this->OnSend(addr, p, nSize, lSerial);
 
-			// Allocate buffer.
-			{
-				GAIA::SYNC::Autolock al(m_lrBufferPool);
-				pNode->pBuf = m_bufpool.alloc();
-			}
+			Shard& shard = this->GetShard(addr);
+			GAIA::SYNC::Autolock al(shard.lr);
+
+			// Allocate node and buffer.
+			Node* pNode = shard.nodepool.alloc();
+			pNode->pBuf = shard.bufpool.alloc();
 
 			// Copy data to node.
-			pNode->uFirstTime = m_uLastExecuteTime;
-			pNode->uLastTime = m_uLastExecuteTime;
+			pNode->uFirstTime = shard.uLastExecuteTime;
+			pNode->uLastTime = shard.uLastExecuteTime;
 			pNode->addr = addr;
 			pNode->pBuf->assign(p, nSize);
-			GAIA::N64 lSerial;
-			GAIA::BL bSerial = this->OnSend(addr, p, nSize, lSerial);
 			if(bSerial)
 				pNode->lSerial = lSerial;
 			else
 				pNode->lSerial = GINVALID;
 
 			// Push to send cache.
-			{
-				GAIA::SYNC::Autolock al(m_lrSendCache);
-				m_sendcache.push_back(pNode);
-			}
+			shard.sendcache.push_back(pNode);
 
 			return nSize;
 		}
@@ -187,84 +235,22 @@ namespace GAIA
 			if(!this->IsCreated())
 				GTHROW(Illegal);
 
-			// Check empty.
-			GAIA::SYNC::Autolock al(m_lrRecv);
-			if(m_recvablelinks_byaddr.empty())
-				return 0;
-
-			// Get link.
-			__LinkSetType::it itlink;
 			if(addr.check())
-			{
-				Link linkfinder;
-				linkfinder.addr = addr;
-				__LinkSetType::it itfinded = m_recvablelinks_byaddr.lower_equal(GAIA::CTN::Ref<Link>(&linkfinder));
-				if(itfinded.empty())
-					return 0;
-				GAIA::CTN::Ref<Link> findedlinkref = *itfinded;
-				Link* pFindedLink = findedlinkref;
-				GAST(pFindedLink != GNIL);
-				if(*pFindedLink != linkfinder)
-					return 0;
-				itlink = itfinded;
-			}
-			else
-				itlink = m_recvablelinks_byaddr.frontit();
-
-			// Get node.
-			GAIA::CTN::Ref<Link>& reflink = *itlink;
-			Link* pLink = reflink;
-			GAST(pLink != GNIL);
-			__NodeSetType::it itnode = pLink->nodes.frontit();
-			GAST(!itnode.empty());
-			GAIA::CTN::Ref<Node>& refnode = *itnode;
-			Node* pNode = refnode;
-			GAST(pNode != GNIL);
-
-			// Check serial.
-			GAST(pNode->lSerial == GINVALID || pNode->lSerial == pLink->lNextSerial);
-
-			// Fill result.
-			GAST(pNode->pBuf != GNIL);
-			if(nSize < pNode->pBuf->write_size())
-				return 0;
-			GAIA::CTN::Buffer& buf = *pNode->pBuf;
-			GAIA::ALGO::gmemcpy(p, buf.fptr(), buf.write_size());
-			if(pNode->lSerial != GINVALID)
-				pLink->lNextSerial++;
-			addr = pNode->addr;
+				return this->RecvFromShard(this->GetShard(addr), addr, p, nSize);
 
-			// Clear and recycle.
+			// Search the shards round robin, so the peers of all the shards have the same chance.
+			GAIA::NUM sCursor = (GAIA::NUM)(GAIA::N64)m_sRecvShardCursor;
+			for(GAIA::NUM x = 0; x < m_sShardCount; ++x)
 			{
-				// Remove node from link's recv nodes container.
-				itnode.erase();
-
-				// Recycle buffer.
+				GAIA::NUM sShardIndex = (sCursor + x) % m_sShardCount;
+				GAIA::N32 nRecv = this->RecvFromShard(m_shards[sShardIndex], addr, p, nSize);
+				if(nRecv > 0)
 				{
-					GAIA::SYNC::Autolock al(m_lrBufferPool);
-					m_bufpool.release(pNode->pBuf);
+					m_sRecvShardCursor = (sShardIndex + 1) % m_sShardCount;
+					return nRecv;
 				}
-
-				// Recycle node.
-				{
-					GAIA::SYNC::Autolock al(m_lrNodePool);
-					m_nodepool.release(pNode);
-				}
-			}
-
-			//
-			if(itnode.empty())
-				itlink.erase();
-			else
-			{
-				GAIA::CTN::Ref<Node>& refnodenext = *itnode;
-				Node* pNodeNext = refnodenext;
-				GAST(pNodeNext != GNIL);
-				if(pNodeNext->lSerial != GINVALID && pNodeNext->lSerial != pLink->lNextSerial)
-					itlink.erase();
 			}
-
-			return buf.write_size();
+			return 0;
 		}
 		GAIA::N32 SUDPSocket::GetFileDescriptor() const
 		{
@@ -289,52 +275,137 @@ namespace GAIA
 			//
 			GAIA::BL bRet = GAIA::False;
 
-			//
-			m_uLastExecuteTime += uDeltaTime;
-			GAIA::U64 uCurrentTime = m_uLastExecuteTime;
-
-			// Resend dispatch.
-			if(bResend)
+			// Receive dispatch.
+			if(bRecv)
 			{
 				//
-				GAIA::SYNC::Autolock alexec(m_lrExecuteResend);
+				GAIA::SYNC::Autolock alexec(m_lrExecuteRecv);
 
-				// Resent.
-				GAIA::SYNC::Autolock al(m_lrSent);
-				for(__LinkSetType::it it = m_sentlinks_byaddr.frontit(); !it.empty(); ++it)
+				// Prepare the receive buffers.
+				if(m_recvbufs.size() != m_sBatchSize)
 				{
-					Link* pLink = *it;
-					GAST(pLink != GNIL);
-					if(pLink->nodes.empty())
-						continue;
+					while(m_recvbufs.size() > m_sBatchSize)
+					{
+						gdel m_recvbufs.back();
+						m_recvbufs.pop_back();
+					}
+					while(m_recvbufs.size() < m_sBatchSize)
+						m_recvbufs.push_back(gnew GAIA::CTN::Buffer);
+					m_listTempDatagramForExecuteRecv.resize(m_sBatchSize);
+				}
 
-					GAIA::NUM sCurrentLinkResentCount = 0;
-					GAIA::BL bExistFailed = GAIA::False;
-					for(__NodeSetType::it itt = pLink->nodes.frontit(); !itt.empty(); ++itt)
+				// Receive by batches.
+				for(;;)
+				{
+					for(GAIA::NUM x = 0; x < m_recvbufs.size(); ++x)
+					{
+						GAIA::CTN::Buffer* pBuf = m_recvbufs[x];
+						pBuf->resize(GAIA::NETWORK::GAIA_NETWORK_MTU);
+						GAIA::NETWORK::Socket::Datagram& dg = m_listTempDatagramForExecuteRecv[x];
+						dg.addr.reset();
+						dg.p = pBuf->fptr();
+						dg.nSize = pBuf->write_size();
+					}
+					GAIA::N32 nRecvCount = m_sock.RecvFromBatch(m_listTempDatagramForExecuteRecv.fptr(), m_recvbufs.size());
+					if(nRecvCount <= 0)
+						break;
+					for(GAIA::NUM x = 0; x < nRecvCount; ++x)
 					{
-						Node* pNode = *itt;
-						GAST(pNode != GNIL);
+						GAIA::NETWORK::Socket::Datagram& dg = m_listTempDatagramForExecuteRecv[x];
+						if(dg.nSize <= 0)
+							continue;
+						else if(dg.nSize < GAIA::NETWORK::GAIA_NETWORK_MTU) // Must below to MTU, because MTU size is a unknown size, maybe exist more data in this datagram.
+						{
+							if(this->RecvDatagram(dg.addr, *m_recvbufs[x], dg.nSize))
+								bRet = GAIA::True;
+						}
+						else // Ignored invalid datagram here. YOU CAN ADD SOME LOG OR OTHER CODE HERE FOR DEBUG.
+						{
+						}
+					}
+				}
+			}
 
-						if(uCurrentTime - pNode->uLastTime < m_uResendTime)
-							break;
-						if(uCurrentTime - pNode->uFirstTime >= m_uTimeout)
+			// Dispatch the other works shard by shard.
+			for(GAIA::NUM x = 0; x < m_sShardCount; ++x)
+			{
+				if(this->ExecuteShard(x, uDeltaTime, bSend, bResend, bRerecv, bTimeout))
+					bRet = GAIA::True;
+			}
+
+			return bRet;
+		}
+		GAIA::BL SUDPSocket::ExecuteShard(GAIA::NUM sShardIndex, GAIA::U64 uDeltaTime, GAIA::BL bSend, GAIA::BL bResend, GAIA::BL bRerecv, GAIA::BL bTimeout)
+		{
+			GAST(uDeltaTime >= 0);
+			if(uDeltaTime < 0)
+				GTHROW(InvalidParam);
+			if(!this->IsCreated())
+				GTHROW(Illegal);
+			if(sShardIndex < 0 || sShardIndex >= m_sShardCount)
+				GTHROW(InvalidParam);
+
+			//
+			GAIA::BL bRet = GAIA::False;
+			Shard& shard = m_shards[sShardIndex];
+			__AddrVectorType listDisconnected;
+			__AddrVectorType listUseless;
+			{
+				GAIA::SYNC::Autolock al(shard.lr);
+
+				//
+				shard.uLastExecuteTime += uDeltaTime;
+				GAIA::U64 uCurrentTime = shard.uLastExecuteTime;
+
+				// Resend dispatch.
+				if(bResend)
+				{
+					for(__LinkMapType::it it = shard.sentlinks.frontit(); !it.empty(); ++it)
+					{
+						Link* pLink = *it;
+						GAST(pLink != GNIL);
+						if(pLink->nodes.empty())
+							continue;
+
+						// A datagram is lost if a datagram sent after it is acknowledged and it is not acknowledged after a reorder time,
+						// the others are resent only when the retransmission timer expired.
+						GAIA::BL bTimerExpired = uCurrentTime - pLink->uTimerTime >= pLink->uRTO;
+						// The reorder time include the acknowledgement delay of the peer.
+						GAIA::U64 uReorderTime = pLink->uRTO;
+						if(pLink->bRTTValid)
+							uReorderTime = pLink->uSRTT + (pLink->uSRTT / 4 > m_uRerecvTime ? pLink->uSRTT / 4 : m_uRerecvTime);
+						GAIA::U64 uLostSize = 0;
+						GAIA::BL bTimeoutResent = GAIA::False;
+						GAIA::NUM sCurrentLinkResentCount = 0;
+						GAIA::BL bExistFailed = GAIA::False;
+						for(__NodeSetType::it itt = pLink->nodes.frontit(); !itt.empty(); ++itt)
 						{
-							// Push to disconnected link list.
+							Node* pNode = *itt;
+							GAST(pNode != GNIL);
+
+							if(uCurrentTime - pNode->uFirstTime >= m_uTimeout)
 							{
-								GAIA::SYNC::Autolock al(m_lrDisconnected);
-								m_listDisconnected.insert(pNode->addr);
+								// Push to disconnected link list.
+								shard.disconnected.insert(pNode->addr);
 								break;
 							}
-						}
-						else
-						{
+
+							GAIA::BL bLost = pNode->uLastTime < pLink->uLatestAckedTime && uCurrentTime - pNode->uLastTime >= uReorderTime;
+							if(!bLost && !(bTimerExpired && uCurrentTime - pNode->uLastTime >= pLink->uRTO))
+								continue;
+
 							GAIA::N32 nSent = m_sock.SendTo(pNode->addr, pNode->pBuf->fptr(), pNode->pBuf->write_size());
 							if(nSent == pNode->pBuf->write_size())
 							{
+								if(bLost)
+									uLostSize += pNode->pBuf->write_size();
+								else
+									bTimeoutResent = GAIA::True;
 								pNode->uLastTime = uCurrentTime;
+								pNode->uSendCount++;
 								bRet = GAIA::True;
-								m_state.uResendSerialMsgCount++;
-								m_state.uResendSerialMsgSize += pNode->pBuf->write_size();
+								shard.state.uResendSerialMsgCount++;
+								shard.state.uResendSerialMsgSize += pNode->pBuf->write_size();
 								sCurrentLinkResentCount++;
 								if(sCurrentLinkResentCount > 1000)
 									break;
@@ -345,492 +416,188 @@ namespace GAIA
 								break;
 							}
 						}
-					}
-					if(bExistFailed)
-						break;
-				}
-			}
-
-			// Send dispatch.
-			if(bSend)
-			{
-				//
-				GAIA::SYNC::Autolock alexec(m_lrExecuteSend);
-
-				// Collect.
-				{
-					GAIA::SYNC::Autolock al(m_lrSendCache);
-					m_listTempNodeForExecuteSend0 = m_sendcache;
-					m_sendcache.clear();
-				}
-
-				// Send.
-				m_listTempNodeForExecuteSend1.clear();
-				for(__NodeVectorType::it it = m_listTempNodeForExecuteSend0.frontit(); !it.empty(); ++it)
-				{
-					Node* pNode = *it;
-					GAST(pNode != GNIL);
 
-					GAIA::N32 nSent = m_sock.SendTo(pNode->addr, pNode->pBuf->fptr(), pNode->pBuf->write_size());
-					if(nSent == pNode->pBuf->write_size())
-					{
-						if(pNode->lSerial == GINVALID)
+						if(bTimerExpired && !bTimeoutResent)
 						{
-							m_state.uSendUnserialMsgCount++;
-							m_state.uSendUnserialMsgSize += pNode->pBuf->write_size();
+							// All the datagrams are sent in a retransmission timeout, the timer is restarted.
+							pLink->uTimerTime = uCurrentTime;
 						}
-						else
+						else if(bTimerExpired)
 						{
-							m_state.uSendSerialMsgCount++;
-							m_state.uSendSerialMsgSize += pNode->pBuf->write_size();
+							// Back off the timer(RFC 6298 5.5 and 5.6).
+							pLink->uRTO = pLink->uRTO * 2 < m_uMaxResendTime ? pLink->uRTO * 2 : m_uMaxResendTime;
+							pLink->uTimerTime = uCurrentTime;
+							if(pLink->pCC != GNIL)
+								pLink->pCC->OnTimeout(pLink->uInflightSize, uCurrentTime);
 						}
-
-						pNode->uFirstTime = pNode->uLastTime = uCurrentTime;
-						m_listTempNodeForExecuteSend1.push_back(pNode);
-						*it = GNIL;
-						bRet = GAIA::True;
-					}
-					else
-						break;
-				}
-
-				// Push sent failed datagram back to the send cache.
-				{
-					GAIA::SYNC::Autolock al(m_lrSendCache);
-					m_listTempNodeForSend0 = m_sendcache;
-					m_sendcache.clear();
-					for(__NodeVectorType::it it = m_listTempNodeForExecuteSend0.frontit(); !it.empty(); ++it)
-					{
-						Node* pNode = *it;
-						if(pNode != GNIL)
-							m_sendcache.push_back(pNode);
-					}
-					m_sendcache += m_listTempNodeForSend0;
-				}
-
-				// Recycle no-serial datagram.
-				{
-					// Recycle buffer.
-					{
-						GAIA::SYNC::Autolock al(m_lrBufferPool);
-						for(__NodeVectorType::it it = m_listTempNodeForExecuteSend1.frontit(); !it.empty(); ++it)
+						else if(uLostSize > 0)
 						{
-							Node* pNode = *it;
-							GAST(pNode != GNIL);
-							GAST(pNode->pBuf != GNIL);
-							if(pNode->lSerial == GINVALID)
-								m_bufpool.release(pNode->pBuf);
+							if(pLink->pCC != GNIL)
+								pLink->pCC->OnLoss(pLink->uInflightSize, uLostSize, uCurrentTime);
 						}
+						if(bExistFailed)
+							break;
 					}
+				}
 
-					// Recycle node.
+				// Send dispatch.
+				if(bSend)
+				{
+					// Send by batches, the safe datagrams wait for the congestion window and pacing of their links.
+					// A blocked link is skipped for the rest of the dispatch, so the datagrams of a link are sent in order.
+					GAIA::NUM sCacheIndex = 0;
+					GAIA::BL bExistFailed = GAIA::False;
+					shard.listTempLink.clear();
+					while(sCacheIndex < shard.sendcache.size() && !bExistFailed)
 					{
-						GAIA::SYNC::Autolock al(m_lrNodePool);
-						for(__NodeVectorType::it it = m_listTempNodeForExecuteSend1.frontit(); !it.empty(); ++it)
+						shard.listTempNode.clear();
+						shard.listTempIndex.clear();
+						for(; sCacheIndex < shard.sendcache.size() && shard.listTempNode.size() < m_sBatchSize; ++sCacheIndex)
 						{
-							Node* pNode = *it;
+							Node* pNode = shard.sendcache[sCacheIndex];
 							GAST(pNode != GNIL);
-							if(pNode->lSerial == GINVALID)
+							if(pNode->lSerial != GINVALID)
 							{
-								m_nodepool.release(pNode);
-								*it = GNIL;
+								Link* pLink = this->GetSentLink(shard, pNode->addr);
+								if(pLink->bBlocked)
+									continue;
+								if(!this->IsSendAble(pLink, pNode->pBuf->write_size(), uCurrentTime))
+								{
+									pLink->bBlocked = GAIA::True;
+									shard.listTempLink.push_back(pLink);
+									continue;
+								}
+								pLink->uInflightSize += pNode->pBuf->write_size();
+								if(pLink->pCC != GNIL)
+									pLink->uNextSendTime += pLink->pCC->GetPacingInterval(pNode->pBuf->write_size());
 							}
+							shard.listTempNode.push_back(pNode);
+							shard.listTempIndex.push_back(sCacheIndex);
 						}
-					}
-				}
+						if(shard.listTempNode.empty())
+							break;
 
-				// Push serial datagram to sent container for later resend operation.
-				{
-					GAIA::SYNC::Autolock al(m_lrSent);
-					for(__NodeVectorType::it it = m_listTempNodeForExecuteSend1.frontit(); !it.empty(); ++it)
-					{
-						Node* pNode = *it;
-						if(pNode != GNIL)
+						GAIA::NUM sBatchSize = shard.listTempNode.size();
+						shard.listTempDatagram.resize(sBatchSize);
+						for(GAIA::NUM x = 0; x < sBatchSize; ++x)
 						{
-							GAST(pNode->lSerial != GINVALID);
-
-							Link linkfinder;
-							linkfinder.addr = pNode->addr;
-							GAIA::CTN::Ref<Link> linkreffinder = &linkfinder;
-							GAIA::CTN::Ref<Link>* pFindedLinkRef = m_sentlinks_byaddr.find(linkreffinder);
-							if(pFindedLinkRef == GNIL)
-							{
-								GAIA::SYNC::Autolock al(m_lrLinkPool);
-								Link* pNewLink = m_linkpool.alloc();
-								pNewLink->uLastTime = uCurrentTime;
-								pNewLink->addr = pNode->addr;
-								pNewLink->nodes.clear();
-								pNewLink->lNextSerial = 0;
-								pNewLink->lNeedBackSerialBegin = GINVALID;
-								pNewLink->lNeedBackSerialFlags = 0;
-								linkreffinder = pNewLink;
-								m_sentlinks_byaddr.insert(linkreffinder);
-								pFindedLinkRef = &linkreffinder;
-							}
-							GAST(pFindedLinkRef != GNIL);
-							Link* pFindedLink = *pFindedLinkRef;
-							GAST(pFindedLink != GNIL);
-
-							pFindedLink->nodes.insert(GAIA::CTN::Ref<Node>(pNode));
+							Node* pNode = shard.listTempNode[x];
+							GAIA::NETWORK::Socket::Datagram& dg = shard.listTempDatagram[x];
+							dg.addr = pNode->addr;
+							dg.p = pNode->pBuf->fptr();
+							dg.nSize = pNode->pBuf->write_size();
 						}
-					}
-				}
-			}
-
-			// Receive dispatch.
-			if(bRecv)
-			{
-				//
-				GAIA::SYNC::Autolock alexec(m_lrExecuteRecv);
 
-				//
-				GAIA::NETWORK::Addr addrRecvFrom;
-				for(;;)
-				{
-					addrRecvFrom.reset();
-					GAIA::N32 nRecvSize = m_sock.RecvFrom(addrRecvFrom, m_recvbuf.fptr(), m_recvbuf.write_size());
-					if(nRecvSize <= 0)
-						break;
-					else if(nRecvSize < m_recvbuf.write_size()) // Must below to MTU, because MTU size is a unknown size, maybe exist more data in this datagram.
-					{
-						GAIA::N64 lSerialBegin, lSerialEnd;
-						GAIA::BL bOnRecvBack = this->OnRecvBack(addrRecvFrom, m_recvbuf.fptr(), nRecvSize, lSerialBegin, lSerialEnd);
-						if(bOnRecvBack)
+						GAIA::N32 nSentCount = m_sock.SendToBatch(shard.listTempDatagram.fptr(), sBatchSize);
+						if(nSentCount < 0)
+							nSentCount = 0;
+						for(GAIA::NUM x = 0; x < sBatchSize; ++x)
 						{
-							m_state.uRecvBackMsgCount++;
-							m_state.uRecvBackMsgSize += nRecvSize;
-
-							GAST(lSerialBegin <= lSerialEnd);
-							GAIA::SYNC::Autolock al(m_lrSent);
-							Link linkfinder;
-							linkfinder.addr = addrRecvFrom;
-							GAIA::CTN::Ref<Link>* pFindedLinkRef = m_sentlinks_byaddr.find(GAIA::CTN::Ref<Link>(&linkfinder));
-							if(pFindedLinkRef != GNIL)
+							Node* pNode = shard.listTempNode[x];
+							if(x >= nSentCount)
 							{
-								Link* pFindedLink = *pFindedLinkRef;
-
-								Node nodefinder;
-								nodefinder.addr = addrRecvFrom;
-								nodefinder.lSerial = lSerialBegin;
-								__NodeSetType::it itnodefront = pFindedLink->nodes.upper_equal(GAIA::CTN::Ref<Node>(&nodefinder));
-								nodefinder.lSerial = lSerialEnd;
-								__NodeSetType::it itnodeback = pFindedLink->nodes.lower_equal(GAIA::CTN::Ref<Node>(&nodefinder));
-								if(!itnodefront.empty() && !itnodeback.empty())
+								// Keep the sent failed datagram in the send cache, and give back the reserved window.
+								if(pNode->lSerial != GINVALID)
 								{
-									GAIA::BL bBoundMatch = GAIA::True;
-									{
-										GAIA::CTN::Ref<Node>& refnodefront = *itnodefront;
-										GAIA::CTN::Ref<Node>& refnodeback = *itnodeback;
-										Node* pNodeFront = refnodefront;
-										Node* pNodeBack = refnodeback;
-										GAST(pNodeFront != GNIL);
-										GAST(pNodeBack != GNIL);
-										if((*pNodeFront) > (*pNodeBack))
-											bBoundMatch = GAIA::False;
-									}
-									if(bBoundMatch)
-									{
-										while(!itnodefront.empty())
-										{
-											GAIA::CTN::Ref<Node>& refnode = *itnodefront;
-											Node* pNode = refnode;
-											GAST(pNode != GNIL);
-											GAST(pNode->addr == addrRecvFrom && pNode->lSerial >= lSerialBegin && pNode->lSerial <= lSerialEnd);
-
-											GAIA::BL bEnded;
-											if(itnodefront == itnodeback)
-												bEnded = GAIA::True;
-											else
-												bEnded = GAIA::False;
-											itnodefront.erase();
-
-											// Recycle buffer.
-											{
-												GAIA::SYNC::Autolock al(m_lrBufferPool);
-												m_bufpool.release(pNode->pBuf);
-											}
-
-											// Recycle node.
-											{
-												GAIA::SYNC::Autolock al(m_lrNodePool);
-												m_nodepool.release(pNode);
-											}
-
-											bRet = GAIA::True;
-											if(bEnded)
-												break;
-										}
-									}
+									Link* pLink = *shard.sentlinks.find(pNode->addr);
+									pLink->uInflightSize -= pNode->pBuf->write_size();
 								}
+								bExistFailed = GAIA::True;
+								continue;
 							}
-						}
-						else
-						{
-							//
-							GAIA::N64 lSerial;
-							GAIA::BL bOnRecv = this->OnRecv(addrRecvFrom, m_recvbuf.fptr(), nRecvSize, lSerial);
-							GAIA::SYNC::Autolock al(m_lrRecv);
-							if(bOnRecv)
+							shard.sendcache[shard.listTempIndex[x]] = GNIL;
+							if(pNode->lSerial == GINVALID)
 							{
-								m_state.uRecvSerialMsgCount++;
-								m_state.uRecvSerialMsgSize += nRecvSize;
+								shard.state.uSendUnserialMsgCount++;
+								shard.state.uSendUnserialMsgSize += pNode->pBuf->write_size();
+
+								// Recycle no-serial datagram.
+								this->ReleaseNode(shard, pNode);
 							}
 							else
 							{
-								m_state.uRecvUnserialMsgCount++;
-								m_state.uRecvUnserialMsgSize += nRecvSize;
-							}
-
-							// If link not exist, create link.
-							Link linkfinder;
-							linkfinder.addr = addrRecvFrom;
-							GAIA::CTN::Ref<Link> linkreffinder = &linkfinder;
-							GAIA::CTN::Ref<Link>* pFindedLinkRef = m_recvlinks_byaddr.find(linkreffinder);
-							if(pFindedLinkRef == GNIL)
-							{
-								GAIA::SYNC::Autolock al(m_lrLinkPool);
-								Link* pNewLink = m_linkpool.alloc();
-								pNewLink->uLastTime = uCurrentTime;
-								pNewLink->addr = addrRecvFrom;
-								pNewLink->nodes.clear();
-								pNewLink->lNextSerial = 0;
-								pNewLink->lNeedBackSerialBegin = GINVALID;
-								pNewLink->lNeedBackSerialFlags = 0;
-								linkreffinder = pNewLink;
-								m_recvlinks_byaddr.insert(linkreffinder);
-								pFindedLinkRef = &linkreffinder;
+								shard.state.uSendSerialMsgCount++;
+								shard.state.uSendSerialMsgSize += pNode->pBuf->write_size();
+
+								// Push serial datagram to sent container for later resend operation.
+								pNode->uFirstTime = pNode->uLastTime = uCurrentTime;
+								pNode->uSendCount = 1;
+								Link* pLink = *shard.sentlinks.find(pNode->addr);
+								if(pLink->nodes.empty())
+									pLink->uTimerTime = uCurrentTime;
+								pLink->nodes.insert(GAIA::CTN::Ref<Node>(pNode));
 							}
-							GAST(pFindedLinkRef != GNIL);
-							Link* pFindedLink = *pFindedLinkRef;
-							GAST(pFindedLink != GNIL);
+							bRet = GAIA::True;
+						}
+					}
 
-							//
-							if(bOnRecv)
-							{
-								if(pFindedLink->lNeedBackSerialBegin == GINVALID)
-								{
-									pFindedLink->lNeedBackSerialBegin = lSerial;
-									pFindedLink->lNeedBackSerialFlags = pFindedLink->lNeedBackSerialFlags | (GAIA::U64)(((GAIA::U64)1) << 0);
-								}
-								else
-								{
-									GAIA::N64 lSerialOffset = lSerial - pFindedLink->lNeedBackSerialBegin;
-									if(lSerialOffset >= 0 && lSerialOffset < sizeof(pFindedLink->lNeedBackSerialFlags) * 8)
-										pFindedLink->lNeedBackSerialFlags = pFindedLink->lNeedBackSerialFlags | (GAIA::U64)(((GAIA::U64)1) << lSerialOffset);
-									else // Ignored because the moduler-user not call execute with bRerecv = GAIA::True at the same time.
-									{
-									}
-								}
-							}
+					// Unblock the links.
+					for(__LinkVectorType::it it = shard.listTempLink.frontit(); !it.empty(); ++it)
+						(*it)->bBlocked = GAIA::False;
+					shard.listTempLink.clear();
 
-							// Calculate bInsertAble.
-							GAIA::BL bInsertAble;
-							if(bOnRecv)
-							{
-								if(pFindedLink->lNextSerial <= lSerial)
-								{
-									Node nodefinder;
-									nodefinder.addr = addrRecvFrom;
-									nodefinder.lSerial = lSerial;
-									if(pFindedLink->nodes.find(GAIA::CTN::Ref<Node>(&nodefinder)) == GNIL)
-										bInsertAble = GAIA::True;
-									else
-										bInsertAble = GAIA::False;
-								}
-								else
-									bInsertAble = GAIA::False;
-							}
-							else
-								bInsertAble = GAIA::True;
+					// Keep the unsent datagram in the send cache.
+					shard.listTempNode.clear();
+					for(GAIA::NUM x = 0; x < shard.sendcache.size(); ++x)
+					{
+						if(shard.sendcache[x] != GNIL)
+							shard.listTempNode.push_back(shard.sendcache[x]);
+					}
+					if(shard.listTempNode.size() != shard.sendcache.size())
+						shard.sendcache = shard.listTempNode;
+				}
 
-							// Insert.
-							if(bInsertAble)
-							{
-								// Alloc node and fill it.
-								Node* pNode;
-								{
-									GAIA::SYNC::Autolock al(m_lrNodePool);
-									pNode = m_nodepool.alloc();
-									pNode->uFirstTime = pNode->uLastTime = uCurrentTime;
-									if(bOnRecv)
-										pNode->lSerial = lSerial;
-									else
-										pNode->lSerial = GINVALID;
-									pNode->addr = addrRecvFrom;
-									pNode->pBuf = GNIL;
-								}
-
-								// Alloc buffer and fill it.
-								{
-									GAIA::SYNC::Autolock al(m_lrBufferPool);
-									pNode->pBuf = m_bufpool.alloc();
-									pNode->pBuf->assign(m_recvbuf.fptr(), nRecvSize);
-								}
-
-								// Push node to link.
-								pFindedLink->uLastTime = uCurrentTime;
-								pFindedLink->nodes.insert(GAIA::CTN::Ref<Node>(pNode));
-
-								// Ready for user RecvFrom.
-								if(pNode->lSerial == GINVALID || pNode->lSerial == pFindedLink->lNextSerial)
-									m_recvablelinks_byaddr.insert(GAIA::CTN::Ref<Link>(pFindedLink));
-
-								//
-								bRet = GAIA::True;
-							}
-						}
-					}
-					else // Ignored invalid datagram here. YOU CAN ADD SOME LOG OR OTHER CODE HERE FOR DEBUG.
-					{
-					}
-				}
-			}
-
-			//
-			if(bRerecv)
-			{
-				//
-				GAIA::SYNC::Autolock alexec(m_lrExecuteRerecv);
-
-				//
-				GAIA::SYNC::Autolock al(m_lrRecv);
-				for(__LinkSetType::it it = m_recvlinks_byaddr.frontit(); !it.empty(); ++it)
+				// Acknowledge the received safe datagrams, at most m_uRerecvTime later.
+				if(bRerecv)
 				{
-					GAIA::CTN::Ref<Link> reflink = *it;
-					Link* pLink = reflink;
-					GAST(pLink != GNIL);
-					if(uCurrentTime - pLink->uLastTime >= m_uRerecvTime)
+					for(__LinkMapType::it it = shard.recvlinks.frontit(); !it.empty(); ++it)
 					{
-						GAIA::N64 lLastSerialOffset = GINVALID;
-						if(pLink->lNeedBackSerialBegin != GINVALID)
+						Link* pLink = *it;
+						GAST(pLink != GNIL);
+						if(pLink->lNeedBackSerialBegin == GINVALID)
+							continue;
+						if(uCurrentTime - pLink->uNeedBackTime < m_uRerecvTime)
+							continue;
+						if(this->SendBack(shard, pLink))
 						{
-							GAIA::BL bSendBackSucces = GAIA::True;
-							for(GAIA::NUM x = 0; x < sizeof(pLink->lNeedBackSerialFlags) * 8; ++x)
-							{
-								if(pLink->lNeedBackSerialFlags & (GAIA::U64)(((GAIA::U64)1) << x))
-								{
-									if(lLastSerialOffset == GINVALID)
-										lLastSerialOffset = x;
-								}
-								else
-								{
-									if(lLastSerialOffset != GINVALID)
-									{
-										GAIA::U8 buf[GAIA::NETWORK::GAIA_NETWORK_MTU];
-										GAIA::N32 nResultSize;
-										GAIA::N64 lSerialBegin = pLink->lNeedBackSerialBegin + lLastSerialOffset;
-										GAIA::N64 lSerialEnd = pLink->lNeedBackSerialBegin + x - 1;
-										GAST(lSerialBegin <= lSerialEnd);
-										if(this->OnBack(pLink->addr, lSerialBegin, lSerialEnd, buf, sizeof(buf), nResultSize))
-										{
-											GAST(nResultSize > 0);
-											if(m_sock.SendTo(pLink->addr, buf, nResultSize) != nResultSize)
-												bSendBackSucces = GAIA::False;
-											else
-											{
-												m_state.uSendBackMsgCount++;
-												m_state.uSendBackMsgSize += nResultSize;
-											}
-										}
-										else
-											bSendBackSucces = GAIA::False;
-										lLastSerialOffset = GINVALID;
-									}
-								}
-							}
-							if(lLastSerialOffset != GINVALID)
-							{
-								GAIA::U8 buf[GAIA::NETWORK::GAIA_NETWORK_MTU];
-								GAIA::N32 nResultSize;
-								GAIA::N64 lSerialBegin = pLink->lNeedBackSerialBegin + lLastSerialOffset;
-								GAIA::N64 lSerialEnd = pLink->lNeedBackSerialBegin + sizeof(pLink->lNeedBackSerialFlags) * 8 - 1;
-								GAST(lSerialBegin <= lSerialEnd);
-								if(this->OnBack(pLink->addr, lSerialBegin, lSerialEnd, buf, sizeof(buf), nResultSize))
-								{
-									GAST(nResultSize > 0);
-									if(m_sock.SendTo(pLink->addr, buf, nResultSize) != nResultSize)
-										bSendBackSucces = GAIA::False;
-									else
-									{
-										m_state.uSendBackMsgCount++;
-										m_state.uSendBackMsgSize += nResultSize;
-									}
-								}
-								else
-									bSendBackSucces = GAIA::False;
-							}
-							if(bSendBackSucces)
-							{
-								pLink->lNeedBackSerialBegin = GINVALID;
-								pLink->lNeedBackSerialFlags = 0;
-								bRet = GAIA::True;
-							}
+							pLink->lNeedBackSerialBegin = GINVALID;
+							bRet = GAIA::True;
 						}
 					}
 				}
-			}
-
-			//
-			if(bTimeout)
-			{
-				//
-				GAIA::SYNC::Autolock alexec(m_lrExecuteTimeout);
 
-				// Recycle disconnect links.
+				// Collect the links to recycle, they are recycled out of the shard lock.
+				if(bTimeout)
 				{
-					m_listTempAddrForExecuteTimeout0.clear();
-
-					// Collect.
-					{
-						GAIA::SYNC::Autolock al(m_lrDisconnected);
-						for(__AddrSetType::it it = m_listDisconnected.frontit(); !it.empty(); ++it)
-						{
-							const GAIA::NETWORK::Addr& addr = *it;
-							m_listTempAddrForExecuteTimeout0.push_back(addr);
-						}
-						m_listDisconnected.clear();
-					}
-
-					// Recycle.
+					for(__AddrSetType::it it = shard.disconnected.frontit(); !it.empty(); ++it)
+						listDisconnected.push_back(*it);
+					shard.disconnected.clear();
+					for(__LinkMapType::it it = shard.recvlinks.frontit(); !it.empty(); ++it)
 					{
-						for(__AddrVectorType::it it = m_listTempAddrForExecuteTimeout0.frontit(); !it.empty(); ++it)
-						{
-							const GAIA::NETWORK::Addr& addr = *it;
-							this->OnTimeout(addr, GAIA::True);
-							this->ResetConnection(&addr);
-							bRet = GAIA::True;
-						}
+						Link* pLink = *it;
+						GAST(pLink != GNIL);
+						if(uCurrentTime - pLink->uLastTime > m_uRecycleTime)
+							listUseless.push_back(pLink->addr);
 					}
 				}
+			}
 
-				// Recycle useless links.
-				{
-					m_listTempAddrForExecuteTimeout0.clear();
-
-					// Collect.
-					{
-						GAIA::SYNC::Autolock al(m_lrRecv);
-						for(__LinkSetType::it it = m_recvlinks_byaddr.frontit(); !it.empty(); ++it)
-						{
-							GAIA::CTN::Ref<Link> reflink = *it;
-							Link* pLink = reflink;
-							GAST(pLink != GNIL);
-							if(uCurrentTime - pLink->uLastTime > m_uRecycleTime)
-								m_listTempAddrForExecuteTimeout0.push_back(pLink->addr);
-						}
-					}
+			// Recycle disconnect links.
+			for(__AddrVectorType::it it = listDisconnected.frontit(); !it.empty(); ++it)
+			{
+				const GAIA::NETWORK::Addr& addr = *it;
+				this->OnTimeout(addr, GAIA::True);
+				this->ResetConnection(&addr);
+				bRet = GAIA::True;
+			}
 
-					// Recycle.
-					{
-						for(__AddrVectorType::it it = m_listTempAddrForExecuteTimeout0.frontit(); !it.empty(); ++it)
-						{
-							const GAIA::NETWORK::Addr& addr = *it;
-							this->OnTimeout(addr, GAIA::False);
-							this->ResetConnection(&addr);
-							bRet = GAIA::True;
-						}
-					}
-				}
+			// Recycle useless links.
+			for(__AddrVectorType::it it = listUseless.frontit(); !it.empty(); ++it)
+			{
+				const GAIA::NETWORK::Addr& addr = *it;
+				this->OnTimeout(addr, GAIA::False);
+				this->ResetConnection(&addr);
+				bRet = GAIA::True;
 			}
 
 			return bRet;
@@ -846,280 +613,606 @@ namespace GAIA
 			if(!bSend && !bRecv)
 				GTHROW(InvalidParam);
 
-			GAIA::SYNC::Autolock alexec1(m_lrExecuteTimeout);
-			GAIA::SYNC::Autolock alexec2(m_lrExecuteSend);
-			GAIA::SYNC::Autolock alexec3(m_lrExecuteRecv);
-			GAIA::SYNC::Autolock alexec4(m_lrExecuteResend);
-			GAIA::SYNC::Autolock alexec5(m_lrExecuteRerecv);
-
 			//
+			if(m_shards == GNIL)
+				return GAIA::True;
 			if(pAddr == GNIL)
 			{
-				// Reset send cache.
-				if(bSend)
+				for(GAIA::NUM x = 0; x < m_sShardCount; ++x)
+					this->ResetShard(m_shards[x], GNIL, bSend, bRecv);
+			}
+			else
+				this->ResetShard(this->GetShard(*pAddr), pAddr, bSend, bRecv);
+
+			return GAIA::True;
+		}
+		GAIA::NETWORK::SUDPSocket::State SUDPSocket::GetState() const
+		{
+			GAIA::NETWORK::SUDPSocket::State ret;
+			ret.reset();
+			if(m_shards != GNIL)
+			{
+				for(GAIA::NUM x = 0; x < m_sShardCount; ++x)
+				{
+					Shard& shard = m_shards[x];
+					GAIA::SYNC::Autolock al(shard.lr);
+					ret.add(shard.state);
+				}
+			}
+			return ret;
+		}
+		GAIA::BL SUDPSocket::GetLinkInfo(const GAIA::NETWORK::Addr& addr, LinkInfo& info) const
+		{
+			if(!addr.check())
+				GTHROW(InvalidParam);
+			if(!this->IsCreated())
+				GTHROW(Illegal);
+			Shard& shard = this->GetShard(addr);
+			GAIA::SYNC::Autolock al(shard.lr);
+			Link** ppFindedLink = shard.sentlinks.find(addr);
+			if(ppFindedLink == GNIL)
+				return GAIA::False;
+			Link* pLink = *ppFindedLink;
+			info.bRTTValid = pLink->bRTTValid;
+			info.uSRTT = pLink->uSRTT;
+			info.uRTTVar = pLink->uRTTVar;
+			info.uRTO = pLink->uRTO;
+			info.uInflightSize = pLink->uInflightSize;
+			info.uWindow = pLink->pCC != GNIL ? pLink->pCC->GetWindow() : GAIA::U64MAX;
+			info.sInflightCount = pLink->nodes.size();
+			return GAIA::True;
+		}
+		GAIA::GVOID SUDPSocket::CreateShards()
+		{
+			if(m_shards != GNIL)
+				return;
+			m_shards = gnew Shard[m_sShardCount];
+			m_uShardSeed = GAIA::ALGO::hash_int(GAIA::TIME::tick_time(), (GAIA::U64)(GAIA::UM)this);
+			m_sRecvShardCursor = 0;
+		}
+		GAIA::GVOID SUDPSocket::DestroyShards()
+		{
+			if(m_shards == GNIL)
+				return;
+			for(GAIA::NUM x = 0; x < m_sShardCount; ++x)
+			{
+				Shard& shard = m_shards[x];
+				for(__LinkMapType::it it = shard.sentlinks.frontit(); !it.empty(); ++it)
 				{
-					GAIA::SYNC::Autolock al(m_lrSendCache);
-					for(__NodeVectorType::it it = m_sendcache.frontit(); !it.empty(); ++it)
+					Link* pLink = *it;
+					if(pLink->pCC != GNIL)
 					{
-						Node* pNode = *it;
-						GAST(pNode != GNIL);
-
-						// Recycle buffer.
-						{
-							GAIA::SYNC::Autolock al(m_lrBufferPool);
-							m_bufpool.release(pNode->pBuf);
-						}
-
-						// Recycle node.
-						{
-							GAIA::SYNC::Autolock al(m_lrNodePool);
-							m_nodepool.release(pNode);
-						}
+						gdel pLink->pCC;
+						pLink->pCC = GNIL;
 					}
-					m_sendcache.clear();
 				}
+			}
+			gdel[] m_shards;
+			m_shards = GNIL;
+		}
+		GAIA::N32 SUDPSocket::RecvFromShard(Shard& shard, GAIA::NETWORK::Addr& addr, GAIA::GVOID* p, GAIA::N32 nSize)
+		{
+			// Check empty.
+			GAIA::SYNC::Autolock al(shard.lr);
+			if(shard.recvablelinks.empty())
+				return 0;
 
-				// Reset sent history.
-				if(bSend)
-				{
-					GAIA::SYNC::Autolock al(m_lrSent);
-					m_listTempLinkForSend1.clear();
-					for(__LinkSetType::it it = m_sentlinks_byaddr.frontit(); !it.empty(); ++it)
-					{
-						Link* pLink = *it;
-						GAST(pLink != GNIL);
-						m_listTempLinkForSend1.push_back(pLink);
+			// Get link.
+			__LinkSetType::it itlink;
+			if(addr.check())
+			{
+				Link linkfinder;
+				linkfinder.addr = addr;
+				__LinkSetType::it itfinded = shard.recvablelinks.lower_equal(GAIA::CTN::Ref<Link>(&linkfinder));
+				if(itfinded.empty())
+					return 0;
+				GAIA::CTN::Ref<Link> findedlinkref = *itfinded;
+				Link* pFindedLink = findedlinkref;
+				GAST(pFindedLink != GNIL);
+				if(*pFindedLink != linkfinder)
+					return 0;
+				itlink = itfinded;
+			}
+			else
+				itlink = shard.recvablelinks.frontit();
 
-						m_listTempNodeForSend0.clear();
-						for(__NodeSetType::it itt = pLink->nodes.frontit(); !itt.empty(); ++itt)
-						{
-							Node* pNode = *itt;
-							GAST(pNode != GNIL);
-							m_listTempNodeForSend0.push_back(pNode);
-						}
-						pLink->nodes.clear();
-						for(__NodeVectorType::it itt = m_listTempNodeForSend0.frontit(); !itt.empty(); ++itt)
-						{
-							Node* pNode = *itt;
+			// Get node.
+			GAIA::CTN::Ref<Link>& reflink = *itlink;
+			Link* pLink = reflink;
+			GAST(pLink != GNIL);
+			__NodeSetType::it itnode = pLink->nodes.frontit();
+			GAST(!itnode.empty());
+			GAIA::CTN::Ref<Node>& refnode = *itnode;
+			Node* pNode = refnode;
+			GAST(pNode != GNIL);
 
-							// Recycle buffer.
-							{
-								GAIA::SYNC::Autolock al(m_lrBufferPool);
-								m_bufpool.release(pNode->pBuf);
-							}
+			// Check serial.
+			GAST(pNode->lSerial == GINVALID || pNode->lSerial == pLink->lNextSerial);
 
-							// Recycle node.
-							{
-								GAIA::SYNC::Autolock al(m_lrNodePool);
-								m_nodepool.release(pNode);
-							}
-						}
-					}
-					m_sentlinks_byaddr.clear();
-					for(__LinkVectorType::it it = m_listTempLinkForSend1.frontit(); !it.empty(); ++it)
-					{
-						Link* pLink = *it;
+			// Fill result.
+			GAST(pNode->pBuf != GNIL);
+			GAIA::N32 nRecvSize = (GAIA::N32)pNode->pBuf->write_size();
+			if(nSize < nRecvSize)
+				return 0;
+			GAIA::ALGO::gmemcpy(p, pNode->pBuf->fptr(), nRecvSize);
+			if(pNode->lSerial != GINVALID)
+				pLink->lNextSerial++;
+			addr = pNode->addr;
 
-						// Recycle link.
-						{
-							GAIA::SYNC::Autolock al(m_lrLinkPool);
-							m_linkpool.release(pLink);
-						}
-					}
-				}
+			// Clear and recycle.
+			itnode.erase();
+			this->ReleaseNode(shard, pNode);
 
-				// Reset recv context.
-				if(bRecv)
+			//
+			if(itnode.empty())
+				itlink.erase();
+			else
+			{
+				GAIA::CTN::Ref<Node>& refnodenext = *itnode;
+				Node* pNodeNext = refnodenext;
+				GAST(pNodeNext != GNIL);
+				if(pNodeNext->lSerial != GINVALID && pNodeNext->lSerial != pLink->lNextSerial)
+					itlink.erase();
+			}
+
+			return nRecvSize;
+		}
+		GAIA::BL SUDPSocket::RecvDatagram(const GAIA::NETWORK::Addr& addrRecvFrom, GAIA::CTN::Buffer& recvbuf, GAIA::N32 nRecvSize)
+		{
+			GAIA::BL bRet = GAIA::False;
+
+			GAIA::N64 lSerialBegin, lSerialEnd;
+			GAIA::BL bOnRecvBack = this->OnRecvBack(addrRecvFrom, recvbuf.fptr(), nRecvSize, lSerialBegin, lSerialEnd);
+			if(bOnRecvBack)
+			{
+				GAST(lSerialBegin <= lSerialEnd);
+				Shard& shard = this->GetShard(addrRecvFrom);
+				GAIA::SYNC::Autolock al(shard.lr);
+				shard.state.uRecvBackMsgCount++;
+				shard.state.uRecvBackMsgSize += nRecvSize;
+
+				GAIA::U64 uCurrentTime = shard.uLastExecuteTime;
+				Link** ppFindedLink = shard.sentlinks.find(addrRecvFrom);
+				if(ppFindedLink != GNIL)
 				{
-					GAIA::SYNC::Autolock al(m_lrRecv);
-					m_listTempLinkForRecv1.clear();
-					for(__LinkSetType::it it = m_recvlinks_byaddr.frontit(); !it.empty(); ++it)
+					Link* pFindedLink = *ppFindedLink;
+					GAIA::U64 uAckedSize = 0;
+					GAIA::U64 uRTT = GAIA::NETWORK::CongestionControl::INVALID_RTT;
+					GAIA::U64 uRTTSentTime = 0;
+
+					Node nodefinder;
+					nodefinder.addr = addrRecvFrom;
+					nodefinder.lSerial = lSerialBegin;
+					__NodeSetType::it itnodefront = pFindedLink->nodes.upper_equal(GAIA::CTN::Ref<Node>(&nodefinder));
+					nodefinder.lSerial = lSerialEnd;
+					__NodeSetType::it itnodeback = pFindedLink->nodes.lower_equal(GAIA::CTN::Ref<Node>(&nodefinder));
+					if(!itnodefront.empty() && !itnodeback.empty())
 					{
-						GAIA::CTN::Ref<Link> reflink = *it;
-						Link* pLink = reflink;
-						GAST(pLink != GNIL);
-						m_listTempLinkForRecv1.push_back(pLink);
-
-						m_listTempNodeForRecv0.clear();
-						for(__NodeSetType::it itt = pLink->nodes.frontit(); !itt.empty(); ++itt)
+						GAIA::BL bBoundMatch = GAIA::True;
 						{
-							GAIA::CTN::Ref<Node>& refnode = *itt;
-							Node* pNode = refnode;
-							GAST(pNode != GNIL);
-							m_listTempNodeForRecv0.push_back(pNode);
+							GAIA::CTN::Ref<Node>& refnodefront = *itnodefront;
+							GAIA::CTN::Ref<Node>& refnodeback = *itnodeback;
+							Node* pNodeFront = refnodefront;
+							Node* pNodeBack = refnodeback;
+							GAST(pNodeFront != GNIL);
+							GAST(pNodeBack != GNIL);
+							if((*pNodeFront) > (*pNodeBack))
+								bBoundMatch = GAIA::False;
 						}
-						pLink->nodes.clear();
-						for(__NodeVectorType::it itt = m_listTempNodeForRecv0.frontit(); !itt.empty(); ++itt)
+						if(bBoundMatch)
 						{
-							Node* pNode = *itt;
-							GAST(pNode != GNIL);
-
-							// Recycle buffer.
+							while(!itnodefront.empty())
 							{
-								GAIA::SYNC::Autolock al(m_lrBufferPool);
-								m_bufpool.release(pNode->pBuf);
-							}
+								GAIA::CTN::Ref<Node>& refnode = *itnodefront;
+								Node* pNode = refnode;
+								GAST(pNode != GNIL);
+								GAST(pNode->addr == addrRecvFrom && pNode->lSerial >= lSerialBegin && pNode->lSerial <= lSerialEnd);
+
+								GAIA::BL bEnded;
+								if(itnodefront == itnodeback)
+									bEnded = GAIA::True;
+								else
+									bEnded = GAIA::False;
+								itnodefront.erase();
+
+								// Sample the round trip time from the latest sent datagram which is not resent(Karn's algorithm).
+								uAckedSize += pNode->pBuf->write_size();
+								if(pNode->uLastTime > pFindedLink->uLatestAckedTime)
+									pFindedLink->uLatestAckedTime = pNode->uLastTime;
+								if(pNode->uSendCount == 1 && (uRTT == GAIA::NETWORK::CongestionControl::INVALID_RTT || pNode->uLastTime >= uRTTSentTime))
+								{
+									uRTT = uCurrentTime - pNode->uLastTime;
+									uRTTSentTime = pNode->uLastTime;
+								}
+								this->ReleaseNode(shard, pNode);
 
-							// Recycle node.
-							{
-								GAIA::SYNC::Autolock al(m_lrNodePool);
-								m_nodepool.release(pNode);
+								bRet = GAIA::True;
+								if(bEnded)
+									break;
 							}
 						}
 					}
-					m_recvlinks_byaddr.clear();
-					m_recvablelinks_byaddr.clear();
-					for(__LinkVectorType::it it = m_listTempLinkForRecv1.frontit(); !it.empty(); ++it)
-					{
-						Link* pLink = *it;
-						GAST(pLink != GNIL);
 
-						// Recycle link.
-						{
-							GAIA::SYNC::Autolock al(m_lrLinkPool);
-							m_linkpool.release(pLink);
-						}
+					if(uAckedSize > 0)
+					{
+						GAST(pFindedLink->uInflightSize >= uAckedSize);
+						pFindedLink->uInflightSize -= uAckedSize;
+						if(uRTT != GAIA::NETWORK::CongestionControl::INVALID_RTT)
+							this->UpdateRTO(pFindedLink, uRTT);
+
+						// Restart the retransmission timer(RFC 6298 5.3).
+						pFindedLink->uTimerTime = uCurrentTime;
+						if(pFindedLink->pCC != GNIL)
+							pFindedLink->pCC->OnAck(pFindedLink->uInflightSize, uAckedSize, uRTT, uCurrentTime);
 					}
 				}
 			}
 			else
 			{
-				// Reset send cache.
-				if(bSend)
+				//
+				GAIA::N64 lSerial;
+				GAIA::BL bOnRecv = this->OnRecv(addrRecvFrom, recvbuf.fptr(), nRecvSize, lSerial);
+				Shard& shard = this->GetShard(addrRecvFrom);
+				GAIA::SYNC::Autolock al(shard.lr);
+				GAIA::U64 uCurrentTime = shard.uLastExecuteTime;
+				if(bOnRecv)
 				{
-					GAIA::SYNC::Autolock al(m_lrSendCache);
-					m_listTempNodeForSend0 = m_sendcache;
-					m_sendcache.clear();
-					for(__NodeVectorType::it it = m_listTempNodeForSend0.frontit(); !it.empty(); ++it)
-					{
-						Node* pNode = *it;
-						GAST(pNode != GNIL);
-						if(pNode->addr == *pAddr)
-						{
-							// Recycle buffer.
-							{
-								GAIA::SYNC::Autolock al(m_lrBufferPool);
-								m_bufpool.release(pNode->pBuf);
-							}
+					shard.state.uRecvSerialMsgCount++;
+					shard.state.uRecvSerialMsgSize += nRecvSize;
+				}
+				else
+				{
+					shard.state.uRecvUnserialMsgCount++;
+					shard.state.uRecvUnserialMsgSize += nRecvSize;
+				}
 
-							// Recycle node.
-							{
-								GAIA::SYNC::Autolock al(m_lrNodePool);
-								m_nodepool.release(pNode);
-							}
-						}
-						else
-							m_sendcache.push_back(pNode);
-					}
+				// If link not exist, create link.
+				Link** ppFindedLink = shard.recvlinks.find(addrRecvFrom);
+				Link* pFindedLink;
+				if(ppFindedLink == GNIL)
+				{
+					pFindedLink = this->AllocLink(shard, addrRecvFrom);
+					shard.recvlinks.insert(pFindedLink->addr, pFindedLink);
 				}
+				else
+					pFindedLink = *ppFindedLink;
+				GAST(pFindedLink != GNIL);
 
-				// Reset sent history.
-				if(bSend)
+				//
+				if(bOnRecv)
+					this->NeedBack(pFindedLink, lSerial, uCurrentTime);
+
+				// Calculate bInsertAble.
+				GAIA::BL bInsertAble;
+				if(bOnRecv)
 				{
-					GAIA::SYNC::Autolock al(m_lrSent);
-					Link linkfinder;
-					linkfinder.addr = *pAddr;
-					GAIA::CTN::Ref<Link>* pFindedLinkRef = m_sentlinks_byaddr.find(GAIA::CTN::Ref<Link>(&linkfinder));
-					if(pFindedLinkRef != GNIL)
+					if(pFindedLink->lNextSerial <= lSerial)
 					{
-						Link* pFindedLink = *pFindedLinkRef;
-						GAST(pFindedLink != GNIL);
-						GAST(pFindedLink->addr == *pAddr);
-
-						m_listTempNodeForSend0.clear();
-						for(__NodeSetType::it itt = pFindedLink->nodes.frontit(); !itt.empty(); ++itt)
-						{
-							Node* pNode = *itt;
-							GAST(pNode != GNIL);
-							m_listTempNodeForSend0.push_back(pNode);
-						}
-						pFindedLink->nodes.clear();
-						for(__NodeVectorType::it itt = m_listTempNodeForSend0.frontit(); !itt.empty(); ++itt)
-						{
-							Node* pNode = *itt;
+						Node nodefinder;
+						nodefinder.addr = addrRecvFrom;
+						nodefinder.lSerial = lSerial;
+						if(pFindedLink->nodes.find(GAIA::CTN::Ref<Node>(&nodefinder)) == GNIL)
+							bInsertAble = GAIA::True;
+						else
+							bInsertAble = GAIA::False;
+					}
+					else
+						bInsertAble = GAIA::False;
+				}
+				else
+					bInsertAble = GAIA::True;
 
-							// Recycle buffer.
-							{
-								GAIA::SYNC::Autolock al(m_lrBufferPool);
-								m_bufpool.release(pNode->pBuf);
-							}
+				// Insert.
+				if(bInsertAble)
+				{
+					// Alloc node and fill it.
+					Node* pNode = shard.nodepool.alloc();
+					pNode->uFirstTime = pNode->uLastTime = uCurrentTime;
+					if(bOnRecv)
+						pNode->lSerial = lSerial;
+					else
+						pNode->lSerial = GINVALID;
+					pNode->addr = addrRecvFrom;
 
-							// Recycle node.
-							{
-								GAIA::SYNC::Autolock al(m_lrNodePool);
-								m_nodepool.release(pNode);
-							}
-						}
+					// Take the storage of the receive buffer, the receive buffer get the old storage of the node buffer.
+					pNode->pBuf = shard.bufpool.alloc();
+					pNode->pBuf->swap(recvbuf);
+					pNode->pBuf->resize(nRecvSize);
 
-						m_sentlinks_byaddr.erase(GAIA::CTN::Ref<Link>(&linkfinder));
+					// Push node to link.
+					pFindedLink->uLastTime = uCurrentTime;
+					pFindedLink->nodes.insert(GAIA::CTN::Ref<Node>(pNode));
 
-						// Recycle link.
+					// Advance the continuous serial.
+					if(pNode->lSerial != GINVALID && pNode->lSerial == pFindedLink->lContinuousSerial)
+					{
+						Node nodefinder;
+						nodefinder.addr = addrRecvFrom;
+						do
 						{
-							GAIA::SYNC::Autolock al(m_lrLinkPool);
-							m_linkpool.release(pFindedLink);
+							nodefinder.lSerial = ++pFindedLink->lContinuousSerial;
 						}
+						while(pFindedLink->nodes.find(GAIA::CTN::Ref<Node>(&nodefinder)) != GNIL);
 					}
+
+					// Ready for user RecvFrom.
+					if(pNode->lSerial == GINVALID || pNode->lSerial == pFindedLink->lNextSerial)
+						shard.recvablelinks.insert(GAIA::CTN::Ref<Link>(pFindedLink));
+
+					//
+					bRet = GAIA::True;
 				}
+			}
+
+			return bRet;
+		}
+		GAIA::GVOID SUDPSocket::ResetShard(Shard& shard, const GAIA::NETWORK::Addr* pAddr, GAIA::BL bSend, GAIA::BL bRecv)
+		{
+			GAIA::SYNC::Autolock al(shard.lr);
 
-				// Reset recv context.
-				if(bRecv)
+			if(bSend)
+			{
+				// Reset send cache.
+				shard.listTempNode = shard.sendcache;
+				shard.sendcache.clear();
+				for(__NodeVectorType::it it = shard.listTempNode.frontit(); !it.empty(); ++it)
 				{
-					GAIA::SYNC::Autolock al(m_lrRecv);
+					Node* pNode = *it;
+					GAST(pNode != GNIL);
+					if(pAddr == GNIL || pNode->addr == *pAddr)
+						this->ReleaseNode(shard, pNode);
+					else
+						shard.sendcache.push_back(pNode);
+				}
 
-					Link linkfinder;
-					linkfinder.addr = *pAddr;
-					GAIA::CTN::Ref<Link> linkreffinder = &linkfinder;
-					GAIA::CTN::Ref<Link>* pFindedLinkRef = m_recvlinks_byaddr.find(linkreffinder);
-					if(pFindedLinkRef != GNIL)
+				// Reset sent history.
+				if(pAddr == GNIL)
+				{
+					for(__LinkMapType::it it = shard.sentlinks.frontit(); !it.empty(); ++it)
+						this->ResetLink(shard, *it);
+					shard.sentlinks.clear();
+				}
+				else
+				{
+					Link** ppFindedLink = shard.sentlinks.find(*pAddr);
+					if(ppFindedLink != GNIL)
 					{
-						m_recvlinks_byaddr.erase(linkreffinder);
-						m_recvablelinks_byaddr.erase(linkreffinder);
-
-						Link* pFindedLink = *pFindedLinkRef;
-						GAST(pFindedLink != GNIL);
-
-						m_listTempNodeForRecv0.clear();
-						for(__NodeSetType::it it = pFindedLink->nodes.frontit(); !it.empty(); ++it)
-						{
-							GAIA::CTN::Ref<Node>& refnode = *it;
-							Node* pNode = refnode;
-							GAST(pNode != GNIL);
-							m_listTempNodeForRecv0.push_back(pNode);
-						}
-						pFindedLink->nodes.clear();
-						for(__NodeVectorType::it it = m_listTempNodeForRecv0.frontit(); !it.empty(); ++it)
-						{
-							Node* pNode = *it;
-							GAST(pNode != GNIL);
+						Link* pFindedLink = *ppFindedLink;
+						GAST(pFindedLink->addr == *pAddr);
+						shard.sentlinks.erase(*pAddr);
+						this->ResetLink(shard, pFindedLink);
+					}
+				}
+			}
 
-							// Recycle buffer.
-							{
-								GAIA::SYNC::Autolock al(m_lrBufferPool);
-								m_bufpool.release(pNode->pBuf);
-							}
+			// Reset recv context.
+			if(bRecv)
+			{
+				if(pAddr == GNIL)
+				{
+					for(__LinkMapType::it it = shard.recvlinks.frontit(); !it.empty(); ++it)
+						this->ResetLink(shard, *it);
+					shard.recvlinks.clear();
+					shard.recvablelinks.clear();
+				}
+				else
+				{
+					Link** ppFindedLink = shard.recvlinks.find(*pAddr);
+					if(ppFindedLink != GNIL)
+					{
+						Link* pFindedLink = *ppFindedLink;
+						GAST(pFindedLink->addr == *pAddr);
+						shard.recvlinks.erase(*pAddr);
+						shard.recvablelinks.erase(GAIA::CTN::Ref<Link>(pFindedLink));
+						this->ResetLink(shard, pFindedLink);
+					}
+				}
+			}
+		}
+		GAIA::GVOID SUDPSocket::ResetLink(Shard& shard, Link* pLink)
+		{
+			GAST(pLink != GNIL);
+			for(__NodeSetType::it it = pLink->nodes.frontit(); !it.empty(); ++it)
+			{
+				Node* pNode = *it;
+				GAST(pNode != GNIL);
+				this->ReleaseNode(shard, pNode);
+			}
+			pLink->nodes.clear();
+			if(pLink->pCC != GNIL)
+			{
+				gdel pLink->pCC;
+				pLink->pCC = GNIL;
+			}
+			shard.linkpool.release(pLink);
+		}
+		GAIA::GVOID SUDPSocket::ReleaseNode(Shard& shard, Node* pNode)
+		{
+			GAST(pNode != GNIL);
+			GAST(pNode->pBuf != GNIL);
+			shard.bufpool.release(pNode->pBuf);
+			shard.nodepool.release(pNode);
+		}
+		SUDPSocket::Link* SUDPSocket::AllocLink(Shard& shard, const GAIA::NETWORK::Addr& addr)
+		{
+			Link* pLink = shard.linkpool.alloc();
+			pLink->uLastTime = shard.uLastExecuteTime;
+			pLink->addr = addr;
+			pLink->nodes.clear();
+			pLink->lNextSerial = 0;
+			pLink->lContinuousSerial = 0;
+			pLink->lNeedBackSerialBegin = GINVALID;
+			pLink->uNeedBackTime = 0;
+			pLink->bRTTValid = GAIA::False;
+			pLink->uSRTT = 0;
+			pLink->uRTTVar = 0;
+			pLink->uRTO = m_uResendTime;
+			pLink->uTimerTime = shard.uLastExecuteTime;
+			pLink->uLatestAckedTime = 0;
+			pLink->uInflightSize = 0;
+			pLink->uNextSendTime = shard.uLastExecuteTime;
+			pLink->bBlocked = GAIA::False;
+			pLink->pCC = GNIL;
+			return pLink;
+		}
+		SUDPSocket::Link* SUDPSocket::GetSentLink(Shard& shard, const GAIA::NETWORK::Addr& addr)
+		{
+			Link** ppFindedLink = shard.sentlinks.find(addr);
+			if(ppFindedLink != GNIL)
+				return *ppFindedLink;
+			Link* pLink = this->AllocLink(shard, addr);
+			pLink->pCC = this->OnCreateCongestionControl(addr);
+			shard.sentlinks.insert(pLink->addr, pLink);
+			return pLink;
+		}
+		GAIA::BL SUDPSocket::IsSendAble(Link* pLink, GAIA::N32 nSize, const GAIA::U64& uCurrentTime)
+		{
+			if(pLink->pCC == GNIL)
+				return GAIA::True;
+
+			// One datagram is always allowed when nothing in flight, so the link never stalls.
+			if(pLink->uInflightSize > 0 && pLink->uInflightSize + nSize > pLink->pCC->GetWindow())
+				return GAIA::False;
+
+			// The pacing is not accumulated when the link is idle.
+			if(pLink->uInflightSize == 0 && pLink->uNextSendTime < uCurrentTime)
+				pLink->uNextSendTime = uCurrentTime;
+			if(pLink->uNextSendTime > uCurrentTime)
+				return GAIA::False;
+			return GAIA::True;
+		}
+		GAIA::GVOID SUDPSocket::UpdateRTO(Link* pLink, GAIA::U64 uRTT)
+		{
+			// RFC 6298 2.2 and 2.3.
+			if(!pLink->bRTTValid)
+			{
+				pLink->uSRTT = uRTT;
+				pLink->uRTTVar = uRTT / 2;
+				pLink->bRTTValid = GAIA::True;
+			}
+			else
+			{
+				GAIA::U64 uDiff = pLink->uSRTT > uRTT ? pLink->uSRTT - uRTT : uRTT - pLink->uSRTT;
+				pLink->uRTTVar = (pLink->uRTTVar * 3 + uDiff) / 4;
+				pLink->uSRTT = (pLink->uSRTT * 7 + uRTT) / 8;
+			}
 
-							// Recycle node.
-							{
-								GAIA::SYNC::Autolock al(m_lrNodePool);
-								m_nodepool.release(pNode);
-							}
-						}
+			// The clock granularity is the acknowledgement delay of the peer.
+			GAIA::U64 uVar = pLink->uRTTVar * 4;
+			if(uVar < m_uRerecvTime)
+				uVar = m_uRerecvTime;
+			pLink->uRTO = pLink->uSRTT + uVar;
+			if(pLink->uRTO < m_uMinResendTime)
+				pLink->uRTO = m_uMinResendTime;
+			if(pLink->uRTO > m_uMaxResendTime)
+				pLink->uRTO = m_uMaxResendTime;
+		}
+		GAIA::GVOID SUDPSocket::NeedBack(Link* pLink, GAIA::N64 lSerial, const GAIA::U64& uCurrentTime)
+		{
+			GAIA::NUM sWordCount = m_sAckWindowSize / 64;
+			if(pLink->lNeedBackSerialBegin == GINVALID)
+			{
+				if(pLink->needbackflags.size() != sWordCount)
+					pLink->needbackflags.resize(sWordCount);
+				for(GAIA::NUM x = 0; x < pLink->needbackflags.size(); ++x)
+					pLink->needbackflags[x] = 0;
+				pLink->lNeedBackSerialBegin = lSerial;
+				pLink->uNeedBackTime = uCurrentTime;
+				pLink->needbackflags[0] = 1;
+				return;
+			}
 
-						// Recycle link.
-						{
-							GAIA::SYNC::Autolock al(m_lrLinkPool);
-							m_linkpool.release(pFindedLink);
-						}
+			GAIA::N64 lWindowSize = (GAIA::N64)pLink->needbackflags.size() * 64;
+			if(lSerial < pLink->lNeedBackSerialBegin)
+			{
+				// Move the window begin to the serial if all the recorded serials are still in the window.
+				GAIA::N64 lShift = pLink->lNeedBackSerialBegin - lSerial;
+				GAIA::N64 lHighest = 0;
+				for(GAIA::NUM x = pLink->needbackflags.size() - 1; x >= 0; --x)
+				{
+					GAIA::U64 u = pLink->needbackflags[x];
+					if(u == 0)
+						continue;
+					GAIA::N64 lBit = 63;
+					while(!(u & ((GAIA::U64)1 << lBit)))
+						--lBit;
+					lHighest = (GAIA::N64)x * 64 + lBit;
+					break;
+				}
+				if(lHighest + lShift >= lWindowSize) // Ignored, it will be acknowledged after resent.
+					return;
+				GAIA::NUM sWordShift = (GAIA::NUM)(lShift / 64);
+				GAIA::NUM sBitShift = (GAIA::NUM)(lShift % 64);
+				for(GAIA::NUM x = pLink->needbackflags.size() - 1; x >= 0; --x)
+				{
+					GAIA::U64 u = 0;
+					GAIA::NUM sSrc = x - sWordShift;
+					if(sSrc >= 0)
+					{
+						u = pLink->needbackflags[sSrc] << sBitShift;
+						if(sBitShift != 0 && sSrc > 0)
+							u |= pLink->needbackflags[sSrc - 1] >> (64 - sBitShift);
 					}
+					pLink->needbackflags[x] = u;
 				}
+				pLink->lNeedBackSerialBegin = lSerial;
 			}
 
-			return GAIA::True;
+			GAIA::N64 lOffset = lSerial - pLink->lNeedBackSerialBegin;
+			if(lOffset >= lWindowSize) // Ignored, it will be acknowledged after resent.
+				return;
+			pLink->needbackflags[(GAIA::NUM)(lOffset / 64)] |= (GAIA::U64)1 << (lOffset % 64);
 		}
-
-		const GAIA::NETWORK::SUDPSocket::State& SUDPSocket::GetState() const
+		GAIA::BL SUDPSocket::SendBack(Shard& shard, Link* pLink)
 		{
-			return m_state;
+			// The cumulative range, then each continuous range of serials above it.
+			GAIA::BL bRet = GAIA::True;
+			if(pLink->lContinuousSerial > 0)
+			{
+				if(!this->SendBackRange(shard, pLink, 0, pLink->lContinuousSerial - 1))
+					bRet = GAIA::False;
+			}
+			GAIA::N64 lWindowSize = (GAIA::N64)pLink->needbackflags.size() * 64;
+			GAIA::N64 lRangeBegin = GINVALID;
+			for(GAIA::N64 x = 0; x <= lWindowSize; ++x)
+			{
+				if(x < lWindowSize && lRangeBegin == GINVALID && x % 64 == 0 && pLink->needbackflags[(GAIA::NUM)(x / 64)] == 0)
+				{
+					x += 63;
+					continue;
+				}
+				GAIA::BL bNeedBack = x < lWindowSize && (pLink->needbackflags[(GAIA::NUM)(x / 64)] & ((GAIA::U64)1 << (x % 64))) != 0;
+				if(bNeedBack)
+				{
+					if(lRangeBegin == GINVALID)
+						lRangeBegin = x;
+					continue;
+				}
+				if(lRangeBegin == GINVALID)
+					continue;
+				GAIA::N64 lSerialBegin = pLink->lNeedBackSerialBegin + lRangeBegin;
+				GAIA::N64 lSerialEnd = pLink->lNeedBackSerialBegin + x - 1;
+				lRangeBegin = GINVALID;
+				if(lSerialEnd < pLink->lContinuousSerial) // Acknowledged by the cumulative range.
+					continue;
+				if(!this->SendBackRange(shard, pLink, lSerialBegin, lSerialEnd))
+					bRet = GAIA::False;
+			}
+			return bRet;
+		}
+		GAIA::BL SUDPSocket::SendBackRange(Shard& shard, Link* pLink, GAIA::N64 lSerialBegin, GAIA::N64 lSerialEnd)
+		{
+			GAST(lSerialBegin <= lSerialEnd);
+			GAIA::U8 buf[GAIA::NETWORK::GAIA_NETWORK_MTU];
+			GAIA::N32 nResultSize;
+			if(!this->OnBack(pLink->addr, lSerialBegin, lSerialEnd, buf, sizeof(buf), nResultSize))
+				return GAIA::False;
+			GAST(nResultSize > 0);
+			if(m_sock.SendTo(pLink->addr, buf, nResultSize) != nResultSize)
+				return GAIA::False;
+			shard.state.uSendBackMsgCount++;
+			shard.state.uSendBackMsgSize += nResultSize;
+			return GAIA::True;
 		}
 	}
 }
@@ -0,0 +1,170 @@
+#include "preheader.h"
+#include "t_common.h"
+
+namespace TEST
+{
+	class TESortElement
+	{
+	public:
+		GAIA::U32 uKey;
+		GAIA::U32 uIndex;
+	};
+
+	class TESortGreater
+	{
+	public:
+		GAIA::BL operator () (const TESortElement& t1, const TESortElement& t2) const{return t1.uKey > t2.uKey;}
+	};
+
+	GINL GAIA::GVOID t_algo_extsort_filename(GAIA::TCH* pszFileName, const GAIA::CH* pszName)
+	{
+		if(GAIA::ALGO::gstremp(g_gaia_appdocdir))
+			GAIA::ALGO::gstrcpy(pszFileName, "../testres/");
+		else
+			GAIA::ALGO::gstrcpy(pszFileName, g_gaia_appdocdir);
+		GAIA::ALGO::gstrcat(pszFileName, pszName);
+	}
+
+	template<typename _DataType> GAIA::BL t_algo_extsort_write(const GAIA::TCH* pszFileName, const GAIA::CTN::Vector<_DataType>& listData)
+	{
+		GAIA::FSYS::File file;
+		if(!file.Open(pszFileName, GAIA::FSYS::File::OPEN_TYPE_WRITE | GAIA::FSYS::File::OPEN_TYPE_CREATEALWAYS))
+			return GAIA::False;
+		if(listData.empty())
+			return GAIA::True;
+		return file.Write(listData.fptr(), listData.datasize()) == listData.datasize();
+	}
+
+	template<typename _DataType> GAIA::BL t_algo_extsort_read(const GAIA::TCH* pszFileName, GAIA::CTN::Vector<_DataType>& listData)
+	{
+		GAIA::FSYS::File file;
+		if(!file.Open(pszFileName, GAIA::FSYS::File::OPEN_TYPE_READ))
+			return GAIA::False;
+		if(file.Size() % sizeof(_DataType) != 0)
+			return GAIA::False;
+		listData.resize(GSCAST(GAIA::NUM)(file.Size() / sizeof(_DataType)));
+		if(listData.empty())
+			return GAIA::True;
+		return file.Read(listData.fptr(), listData.datasize()) == listData.datasize();
+	}
+
+	template<typename _DataType, typename _CompareType> GAIA::BL t_algo_extsort_file(
+		const GAIA::TCH* pszSrc, const GAIA::TCH* pszDst, const GAIA::TCH* pszTmp, GAIA::U64 uMemorySize, GAIA::THREAD::ThreadPool* pPool)
+	{
+		GAIA::FSYS::File src, dst, tmp;
+		if(!src.Open(pszSrc, GAIA::FSYS::File::OPEN_TYPE_READ))
+			return GAIA::False;
+		if(!dst.Open(pszDst, GAIA::FSYS::File::OPEN_TYPE_READ | GAIA::FSYS::File::OPEN_TYPE_WRITE | GAIA::FSYS::File::OPEN_TYPE_CREATEALWAYS))
+			return GAIA::False;
+		if(!tmp.Open(pszTmp, GAIA::FSYS::File::OPEN_TYPE_READ | GAIA::FSYS::File::OPEN_TYPE_WRITE | GAIA::FSYS::File::OPEN_TYPE_CREATEALWAYS))
+			return GAIA::False;
+		return GAIA::ALGO::esort<_DataType, _CompareType>(src, dst, tmp, uMemorySize, pPool);
+	}
+
+	extern GAIA::GVOID t_algo_extsort(GAIA::LOG::Log& logobj)
+	{
+		GAIA::TCH szSrc[GAIA::MAXPL];
+		GAIA::TCH szDst[GAIA::MAXPL];
+		GAIA::TCH szTmp[GAIA::MAXPL];
+		t_algo_extsort_filename(szSrc, "esort_src.bin");
+		t_algo_extsort_filename(szDst, "esort_dst.bin");
+		t_algo_extsort_filename(szTmp, "esort_tmp.bin");
+
+		GAIA::MATH::RandomLCG lcg;
+		GAIA::THREAD::ThreadPool pool;
+		pool.SetThreadCount(4);
+		TAST(pool.Begin());
+
+		// Integer elements, a run, a merge pass and multi merge passes.
+		{
+			static const GAIA::NUM SIZES[] = {0, 1, 1000, 100000, 300001};
+			static const GAIA::U64 MEMORYS[] = {1024 * 1024 * 16, 1024 * 256, 1024 * 64, 1024 * 8};
+			for(GAIA::NUM x = 0; x < sizeofarray(SIZES); ++x)
+			{
+				GAIA::CTN::Vector<GAIA::N32> listData;
+				listData.resize(SIZES[x]);
+				for(GAIA::NUM y = 0; y < listData.size(); ++y)
+					listData[y] = GSCAST(GAIA::N32)(lcg.random_u32());
+				TAST(t_algo_extsort_write(szSrc, listData));
+				GAIA::CTN::Vector<GAIA::N32> listSorted = listData;
+				if(!listSorted.empty())
+					GAIA::ALGO::sort(listSorted.fptr(), listSorted.bptr());
+				for(GAIA::NUM y = 0; y < sizeofarray(MEMORYS); ++y)
+				{
+					for(GAIA::NUM z = 0; z < 2; ++z)
+					{
+						if(!t_algo_extsort_file<GAIA::N32, GAIA::ALGO::ESortLess<GAIA::N32> >(szSrc, szDst, szTmp, MEMORYS[y], z == 0 ? GNIL : &pool))
+						{
+							TERROR;
+							continue;
+						}
+						GAIA::CTN::Vector<GAIA::N32> listResult;
+						TAST(t_algo_extsort_read(szDst, listResult));
+						if(listResult.size() != listSorted.size())
+						{
+							TERROR;
+							continue;
+						}
+						for(GAIA::NUM w = 0; w < listResult.size(); ++w)
+						{
+							if(listResult[w] != listSorted[w])
+							{
+								TERROR;
+								break;
+							}
+						}
+					}
+				}
+			}
+		}
+
+		// Plain data elements with a comparer.
+		{
+			GAIA::CTN::Vector<TESortElement> listData;
+			listData.resize(50000);
+			for(GAIA::NUM x = 0; x < listData.size(); ++x)
+			{
+				listData[x].uKey = lcg.random_u16() % 1000;
+				listData[x].uIndex = x;
+			}
+			TAST(t_algo_extsort_write(szSrc, listData));
+			TAST((t_algo_extsort_file<TESortElement, TESortGreater>(szSrc, szDst, szTmp, 1024 * 32, &pool)));
+			GAIA::CTN::Vector<TESortElement> listResult;
+			TAST(t_algo_extsort_read(szDst, listResult));
+			if(listResult.size() != listData.size())
+				TERROR;
+			else
+			{
+				GAIA::U64 uIndexSum = 0;
+				for(GAIA::NUM x = 0; x < listResult.size(); ++x)
+				{
+					if(x > 0 && listResult[x - 1].uKey < listResult[x].uKey)
+					{
+						TERROR;
+						break;
+					}
+					uIndexSum += listResult[x].uIndex;
+				}
+				if(uIndexSum != GSCAST(GAIA::U64)(listData.size()) * (listData.size() - 1) / 2)
+					TERROR;
+			}
+		}
+
+		// The source size is not a multiple of the element size.
+		{
+			GAIA::CTN::Vector<GAIA::U8> listData;
+			listData.resize(7);
+			for(GAIA::NUM x = 0; x < listData.size(); ++x)
+				listData[x] = (GAIA::U8)x;
+			TAST(t_algo_extsort_write(szSrc, listData));
+			if(t_algo_extsort_file<GAIA::N32, GAIA::ALGO::ESortLess<GAIA::N32> >(szSrc, szDst, szTmp, 1024 * 64, GNIL))
+				TERROR;
+		}
+
+		TAST(pool.End());
+		GAIA::FSYS::Dir dir;
+		TAST(dir.RemoveFile(szSrc));
+		TAST(dir.RemoveFile(szDst));
+		TAST(dir.RemoveFile(szTmp));
+	}
+}
@@ -5,5 +5,64 @@ namespace TEST
 {
 	extern GAIA::GVOID t_algo_hash(GAIA::LOG::Log& logobj)
 	{
+		// String hash.
+		{
+			const GAIA::CH* psz = "Hello World";
+			TAST(GAIA::ALGO::hash(psz) == GAIA::ALGO::hash("Hello World"));
+			TAST(GAIA::ALGO::hash(psz) == GAIA::ALGO::hash(psz, GAIA::ALGO::gstrlen(psz)));
+			TAST(GAIA::ALGO::hash(psz) == GAIA::ALGO::hash_bytes(psz, GAIA::ALGO::gstrlen(psz)));
+			TAST(GAIA::ALGO::hash(psz) != GAIA::ALGO::hash(psz, GAIA::ALGO::gstrlen(psz) - 1));
+			TAST(GAIA::ALGO::hash("abc") != GAIA::ALGO::hash("cba"));
+			TAST(GAIA::ALGO::hash("ab") != GAIA::ALGO::hash("ba"));
+			TAST(GAIA::ALGO::hash("") != GAIA::ALGO::hash("a"));
+			TAST(GAIA::ALGO::hash(L"abc") != GAIA::ALGO::hash(L"cba"));
+			TAST(GAIA::ALGO::hash(L"abc") == GAIA::ALGO::hash(L"abc", 3));
+
+			// Seeded hash.
+			TAST(GAIA::ALGO::hash_seed(psz, 0) == GAIA::ALGO::hash(psz));
+			TAST(GAIA::ALGO::hash_seed(psz, 1) != GAIA::ALGO::hash_seed(psz, 2));
+			TAST(GAIA::ALGO::hash_seed(psz, 1) == GAIA::ALGO::hash_seed(psz, 1));
+		}
+
+		// Every length of a long buffer, include the word-wide loops.
+		{
+			GAIA::U8 buf[256];
+			for(GAIA::NUM x = 0; x < sizeofarray(buf); ++x)
+				buf[x] = (GAIA::U8)(x * 7);
+			GAIA::NUM sCollide = 0;
+			for(GAIA::NUM x = 1; x < sizeofarray(buf); ++x)
+			{
+				GAIA::U64 h = GAIA::ALGO::hash_bytes(buf, x);
+				if(h == GAIA::ALGO::hash_bytes(buf, x - 1))
+					++sCollide;
+				buf[x - 1] ^= 1;
+				if(h == GAIA::ALGO::hash_bytes(buf, x))
+					++sCollide;
+				buf[x - 1] ^= 1;
+			}
+			TAST(sCollide == 0);
+		}
+
+		// Integer hash.
+		{
+			TAST(GAIA::ALGO::hash((GAIA::N32)1) != GAIA::ALGO::hash((GAIA::N32)-1));
+			TAST(GAIA::ALGO::hash((GAIA::N32)-1) == GAIA::ALGO::hash((GAIA::N64)-1));
+			TAST(GAIA::ALGO::hash((GAIA::U32)1) == GAIA::ALGO::hash((GAIA::U64)1));
+			TAST(GAIA::ALGO::hash_int(1, 1) != GAIA::ALGO::hash_int(1, 2));
+
+			// Sequence keys spread to the low bits.
+			GAIA::NUM listCount[16];
+			GAIA::ALGO::gmemset(listCount, 0, sizeof(listCount));
+			for(GAIA::N32 x = 0; x < 1600; ++x)
+				++listCount[GAIA::ALGO::hash(x * 16) & 15];
+			for(GAIA::NUM x = 0; x < sizeofarray(listCount); ++x)
+			{
+				if(listCount[x] < 50 || listCount[x] > 150)
+				{
+					TERROR;
+					break;
+				}
+			}
+		}
 	}
 }
@@ -14,5 +14,154 @@ namespace TEST
 		GAIA::U64 u64 = 1234567812345678;
 		if(GAIA::ALGO::swapendian(GAIA::ALGO::swapendian(u64)) != 1234567812345678)
 			TERROR;
+
+		// Every size class and alignment, compare to the byte by byte result.
+		{
+			static const GAIA::NUM BUFFER_SIZE = 1024;
+			GAIA::U8 src[BUFFER_SIZE];
+			GAIA::U8 dst[BUFFER_SIZE];
+			GAIA::U8 ref[BUFFER_SIZE];
+			for(GAIA::NUM x = 0; x < BUFFER_SIZE; ++x)
+				src[x] = (GAIA::U8)(x * 7 + 3);
+			GAIA::BL bError = GAIA::False;
+			for(GAIA::NUM sSize = 1; sSize < 600 && !bError; sSize += (sSize < 80 ? 1 : 13))
+			{
+				for(GAIA::NUM sOffset = 0; sOffset < 64 && !bError; sOffset += (sOffset < 8 ? 1 : 9))
+				{
+					GAIA::NUM sSrcOffset = (sOffset * 5) % 64;
+					for(GAIA::NUM x = 0; x < BUFFER_SIZE; ++x)
+						dst[x] = ref[x] = 0xCD;
+					for(GAIA::NUM x = 0; x < sSize; ++x)
+						ref[sOffset + x] = src[sSrcOffset + x];
+					GAIA::ALGO::gmemcpy(dst + sOffset, src + sSrcOffset, sSize);
+					for(GAIA::NUM x = 0; x < BUFFER_SIZE; ++x)
+					{
+						if(dst[x] != ref[x])
+							bError = GAIA::True;
+					}
+					if(GAIA::ALGO::gmemcmp(dst + sOffset, src + sSrcOffset, sSize) != 0)
+						bError = GAIA::True;
+					GAIA::NUM sDiff = (sOffset * 31 + sSize) % sSize;
+					++dst[sOffset + sDiff];
+					GAIA::N32 nExpect = dst[sOffset + sDiff] > src[sSrcOffset + sDiff] ? +1 : -1;
+					if(GAIA::ALGO::gmemcmp(dst + sOffset, src + sSrcOffset, sSize) != nExpect)
+						bError = GAIA::True;
+					if(GAIA::ALGO::gmemcmp(src + sSrcOffset, dst + sOffset, sSize) != -nExpect)
+						bError = GAIA::True;
+					--dst[sOffset + sDiff];
+
+					for(GAIA::NUM x = 0; x < sSize; ++x)
+						ref[sOffset + x] = (GAIA::U8)sSize;
+					GAIA::ALGO::gmemset(dst + sOffset, (GAIA::U8)sSize, sSize);
+					for(GAIA::NUM x = 0; x < BUFFER_SIZE; ++x)
+					{
+						if(dst[x] != ref[x])
+							bError = GAIA::True;
+					}
+				}
+			}
+			if(bError)
+				TERROR;
+
+			// The unsigned bytes order, and the last byte is compared.
+			GAIA::U8 a[3] = {1, 2, 0x80};
+			GAIA::U8 b[3] = {1, 2, 0x7F};
+			if(GAIA::ALGO::gmemcmp(a, b, 3) <= 0 || GAIA::ALGO::gmemcmp(b, a, 3) >= 0)
+				TERROR;
+			if(GAIA::ALGO::gmemcmp(a, b, 2) != 0)
+				TERROR;
+
+			// The overlapped memory which dst is before src.
+			for(GAIA::NUM x = 0; x < BUFFER_SIZE; ++x)
+				dst[x] = (GAIA::U8)x;
+			GAIA::ALGO::gmemcpy(dst, dst + 3, 500);
+			for(GAIA::NUM x = 0; x < 500; ++x)
+			{
+				if(dst[x] != (GAIA::U8)(x + 3))
+				{
+					TERROR;
+					break;
+				}
+			}
+		}
+
+		// Every fill size of the size classes, the guard bytes of both sides are not written.
+		{
+			static const GAIA::NUM GUARD_SIZE = 64;
+			static const GAIA::NUM MAX_SIZE = 129;
+			GAIA::U8 buf[GUARD_SIZE + MAX_SIZE + GUARD_SIZE];
+			GAIA::BL bError = GAIA::False;
+			for(GAIA::NUM sSize = 1; sSize <= MAX_SIZE && !bError; ++sSize)
+			{
+				for(GAIA::NUM x = 0; x < sizeofarray(buf); ++x)
+					buf[x] = 0xCD;
+				GAIA::ALGO::gmemset(buf + GUARD_SIZE, 0x5A, sSize);
+				for(GAIA::NUM x = 0; x < sizeofarray(buf); ++x)
+				{
+					GAIA::U8 uExpect = (x >= GUARD_SIZE && x < GUARD_SIZE + sSize) ? 0x5A : 0xCD;
+					if(buf[x] != uExpect)
+					{
+						bError = GAIA::True;
+						break;
+					}
+				}
+			}
+			if(bError)
+				TERROR;
+		}
+
+		// Strided copy, the rows with gap and without gap.
+		{
+			static const GAIA::NUM WIDTH = 67;
+			static const GAIA::NUM HEIGHT = 9;
+			static const GAIA::NUM SRC_STRIDE = 80;
+			GAIA::U8 src[SRC_STRIDE * HEIGHT];
+			GAIA::U8 dst[SRC_STRIDE * HEIGHT];
+			for(GAIA::NUM x = 0; x < sizeofarray(src); ++x)
+				src[x] = (GAIA::U8)(x * 13);
+			GAIA::ALGO::gmemset(dst, 0, (GAIA::NUM)sizeof(dst));
+			GAIA::ALGO::gmemcpy(dst, src, WIDTH, SRC_STRIDE, WIDTH, HEIGHT);
+			for(GAIA::NUM y = 0; y < HEIGHT; ++y)
+			{
+				if(GAIA::ALGO::gmemcmp(dst + y * WIDTH, src + y * SRC_STRIDE, WIDTH) != 0)
+				{
+					TERROR;
+					break;
+				}
+			}
+			if(GAIA::ALGO::gmemcmp(dst, src, WIDTH, SRC_STRIDE, WIDTH, HEIGHT) != 0)
+				TERROR;
+			if(dst[WIDTH * HEIGHT] != 0)
+				TERROR;
+			GAIA::ALGO::gmemcpy(dst, src, SRC_STRIDE, SRC_STRIDE, SRC_STRIDE, HEIGHT);
+			if(GAIA::ALGO::gmemcmp(dst, src, (GAIA::NUM)sizeof(src)) != 0)
+				TERROR;
+			GAIA::ALGO::gmemset(dst, 1, SRC_STRIDE, WIDTH, HEIGHT);
+			for(GAIA::NUM y = 0; y < HEIGHT; ++y)
+			{
+				if(dst[y * SRC_STRIDE] != 1 || dst[y * SRC_STRIDE + WIDTH - 1] != 1 || dst[y * SRC_STRIDE + WIDTH] != src[y * SRC_STRIDE + WIDTH])
+				{
+					TERROR;
+					break;
+				}
+			}
+		}
+
+		// The big memory is written by non-temporal store.
+		{
+			GAIA::NUM sSize = GAIA::ALGO::MemImpl::NONTEMPORAL_SIZE + 77;
+			GAIA::U8* pSrc = gnew GAIA::U8[sSize + 1];
+			GAIA::U8* pDst = gnew GAIA::U8[sSize + 1];
+			for(GAIA::NUM x = 0; x < sSize; ++x)
+				pSrc[x] = (GAIA::U8)(x % 251);
+			GAIA::ALGO::gmemcpy(pDst + 1, pSrc, sSize);
+			if(GAIA::ALGO::gmemcmp(pDst + 1, pSrc, sSize) != 0)
+				TERROR;
+			GAIA::ALGO::gmemset(pDst, 0x5A, sSize);
+			if(pDst[0] != 0x5A || pDst[sSize / 2] != 0x5A || pDst[sSize - 1] != 0x5A || pDst[sSize] != pSrc[sSize - 1])
+				TERROR;
+			gdel[] pSrc;
+			gdel[] pDst;
+		}
 	}
 }
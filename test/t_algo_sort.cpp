@@ -3,6 +3,63 @@
 
 namespace TEST
 {
+	class TSortElement
+	{
+	public:
+		GAIA::BL operator < (const TSortElement& src) const{return nKey < src.nKey;}
+		GAIA::BL operator > (const TSortElement& src) const{return nKey > src.nKey;}
+	public:
+		GAIA::N32 nKey;
+		GAIA::N32 nIndex;
+	};
+
+	GINL GAIA::GVOID t_algo_sort_pattern(GAIA::MATH::RandomLCG& lcg, GAIA::CTN::Vector<GAIA::N32>& listData, GAIA::NUM sPattern, GAIA::NUM sSize)
+	{
+		listData.resize(sSize);
+		for(GAIA::NUM x = 0; x < sSize; ++x)
+		{
+			switch(sPattern)
+			{
+			case 0: // Random.
+				listData[x] = (GAIA::N32)lcg.random_u32();
+				break;
+			case 1: // Sorted.
+				listData[x] = x;
+				break;
+			case 2: // Reverse sorted.
+				listData[x] = sSize - x;
+				break;
+			case 3: // All equal.
+				listData[x] = 7;
+				break;
+			case 4: // Few unique.
+				listData[x] = lcg.random_u8() % 4 - 2;
+				break;
+			case 5: // Organ pipe.
+				listData[x] = x < sSize / 2 ? x : sSize - x;
+				break;
+			case 6: // Sawtooth.
+				listData[x] = x % 37;
+				break;
+			default: // Sorted with a few random.
+				listData[x] = (lcg.random_u8() % 32 == 0) ? (GAIA::N32)lcg.random_u16() : x;
+				break;
+			}
+		}
+	}
+
+	GINL GAIA::BL t_algo_sort_check(const GAIA::CTN::Vector<GAIA::N32>& listData, const GAIA::CTN::Vector<GAIA::N32>& listSorted)
+	{
+		if(listData.size() != listSorted.size())
+			return GAIA::False;
+		for(GAIA::NUM x = 0; x < listData.size(); ++x)
+		{
+			if(listData[x] != listSorted[x])
+				return GAIA::False;
+		}
+		return GAIA::True;
+	}
+
 	extern GAIA::GVOID t_algo_sort(GAIA::LOG::Log& logobj)
 	{
 		// Generate test data.
@@ -36,5 +93,100 @@ namespace TEST
 			if(listData[x] != listDataSorted[x])
 				TERROR;
 		}
+
+		// Insertion, selection, heap and radix sort.
+		listData = listDataOrigin;
+		GAIA::ALGO::isort(listData.fptr(), listData.bptr());
+		if(!GAIA::ALGO::issorted(listData.fptr(), listData.bptr()))
+			TERROR;
+		listData = listDataOrigin;
+		GAIA::ALGO::ssort(listData.fptr(), listData.bptr());
+		if(!GAIA::ALGO::issorted(listData.fptr(), listData.bptr()))
+			TERROR;
+		listData = listDataOrigin;
+		GAIA::ALGO::hsort(listData.fptr(), listData.bptr());
+		if(!GAIA::ALGO::issorted(listData.fptr(), listData.bptr()))
+			TERROR;
+		listData = listDataOrigin;
+		if(!GAIA::ALGO::rsort(listData.fptr(), listData.bptr()))
+			TERROR;
+		for(GAIA::NUM x = 0; x < listData.size(); ++x)
+		{
+			if(listData[x] != listDataSorted[x])
+			{
+				TERROR;
+				break;
+			}
+		}
+
+		// The patterns which make the simple quick sort quadratic, compare the quick sort with the radix sort.
+		{
+			static const GAIA::NUM SIZES[] = {0, 1, 2, 23, 24, 25, 129, 1000, 50000};
+			GAIA::CTN::Vector<GAIA::N32> listPattern;
+			GAIA::CTN::Vector<GAIA::N32> listSorted;
+			for(GAIA::NUM sPattern = 0; sPattern < 8; ++sPattern)
+			{
+				for(GAIA::NUM x = 0; x < sizeofarray(SIZES); ++x)
+				{
+					t_algo_sort_pattern(lcg, listPattern, sPattern, SIZES[x]);
+					if(listPattern.empty())
+						continue;
+					listSorted = listPattern;
+					if(!GAIA::ALGO::rsort(listSorted.fptr(), listSorted.bptr()))
+						TERROR;
+					GAIA::CTN::Vector<GAIA::N32> listQuick = listPattern;
+					GAIA::ALGO::qsort(listQuick.fptr(), listQuick.bptr());
+					if(!t_algo_sort_check(listQuick, listSorted))
+						TERROR;
+					if(SIZES[x] <= 1000)
+					{
+						GAIA::CTN::Vector<GAIA::N32> listHeap = listPattern;
+						GAIA::ALGO::hsort(listHeap.fptr(), listHeap.bptr());
+						if(!t_algo_sort_check(listHeap, listSorted))
+							TERROR;
+						GAIA::CTN::Vector<GAIA::N32> listInsertion = listPattern;
+						GAIA::ALGO::isort(listInsertion.fptr(), listInsertion.bptr());
+						if(!t_algo_sort_check(listInsertion, listSorted))
+							TERROR;
+					}
+				}
+			}
+		}
+
+		// The class type is sorted by the partition with branch, and the radix sort don't support it.
+		{
+			GAIA::CTN::Vector<TSortElement> listElement;
+			listElement.resize(10000);
+			for(GAIA::NUM x = 0; x < listElement.size(); ++x)
+			{
+				listElement[x].nKey = lcg.random_u8() % 100;
+				listElement[x].nIndex = x;
+			}
+			if(GAIA::ALGO::rsort(listElement.fptr(), listElement.bptr()))
+				TERROR;
+			GAIA::ALGO::sort(listElement.fptr(), listElement.bptr());
+			if(!GAIA::ALGO::issorted(listElement.fptr(), listElement.bptr()))
+				TERROR;
+		}
+
+		// The radix sort of unsigned and 64 bits keys.
+		{
+			GAIA::CTN::Vector<GAIA::U64> listU64;
+			listU64.resize(3000);
+			for(GAIA::NUM x = 0; x < listU64.size(); ++x)
+				listU64[x] = lcg.random_u64();
+			GAIA::CTN::Vector<GAIA::U64> listU64Sorted = listU64;
+			GAIA::ALGO::qsort(listU64Sorted.fptr(), listU64Sorted.bptr());
+			if(!GAIA::ALGO::rsort(listU64.fptr(), listU64.bptr()))
+				TERROR;
+			for(GAIA::NUM x = 0; x < listU64.size(); ++x)
+			{
+				if(listU64[x] != listU64Sorted[x])
+				{
+					TERROR;
+					break;
+				}
+			}
+		}
 	}
 }
@@ -3,6 +3,113 @@
 
 namespace TEST
 {
+	/*!
+		@brief A string pointer which is not a raw pointer, so the string functions use the element by element path.
+	*/
+	template<typename _CharType> class TStrScalarPtr
+	{
+	public:
+		TStrScalarPtr(const _CharType* p = GNIL){m_p = p;}
+		const _CharType& operator * () const{return *m_p;}
+		const _CharType& operator [] (GAIA::NUM sIndex) const{return m_p[sIndex];}
+		TStrScalarPtr& operator ++ (){++m_p; return *this;}
+		GAIA::BL operator ! () const{return m_p == GNIL;}
+		const _CharType* ptr() const{return m_p;}
+	private:
+		const _CharType* m_p;
+	};
+
+	template<typename _CharType> GAIA::GVOID t_algo_string_simd(GAIA::LOG::Log& logobj)
+	{
+		typedef TStrScalarPtr<_CharType> __ScalarPtr;
+		static const GAIA::NUM BUFFER_SIZE = 4096 * 3;
+		static const GAIA::NUM MAX_LEN = 100;
+		_CharType* pBuf = gnew _CharType[BUFFER_SIZE / sizeof(_CharType)];
+		_CharType szTemp[MAX_LEN + 1];
+		_CharType szKeys[16];
+
+		// The strings end in the page end too.
+		GAIA::NUM sPageEnd = (GAIA::NUM)((4096 * 2 - ((GAIA::U64)pBuf & 4095)) / sizeof(_CharType));
+
+		GAIA::NUM sErrorCount = 0;
+		for(GAIA::NUM x = 0; x < 20000 && sErrorCount == 0; ++x)
+		{
+			GAIA::NUM sLen = GAIA::MATH::xrandom() % (MAX_LEN + 1);
+			GAIA::NUM sOffset = (x % 2 == 0) ? (GAIA::MATH::xrandom() % 64) : (sPageEnd - sLen - 1);
+			_CharType* p = pBuf + sOffset;
+			for(GAIA::NUM y = 0; y < sLen; ++y)
+				p[y] = (_CharType)('a' + GAIA::MATH::xrandom() % 4);
+			p[sLen] = '\0';
+			for(GAIA::NUM y = 1; y < 64 && sLen + y < BUFFER_SIZE / (GAIA::NUM)sizeof(_CharType) - sOffset; ++y)
+				p[sLen + y] = (_CharType)('a' + GAIA::MATH::xrandom() % 4);
+
+			// The same string, a different string and a prefix.
+			GAIA::NUM sTempLen = sLen;
+			for(GAIA::NUM y = 0; y <= sLen; ++y)
+				szTemp[y] = p[y];
+			if(x % 3 == 1 && sLen > 0)
+				szTemp[GAIA::MATH::xrandom() % sLen] = (_CharType)('a' + GAIA::MATH::xrandom() % 5);
+			else if(x % 3 == 2)
+			{
+				sTempLen = GAIA::MATH::xrandom() % (sLen + 1);
+				szTemp[sTempLen] = '\0';
+			}
+
+			const _CharType* cp = p;
+			__ScalarPtr sp(p);
+			__ScalarPtr st(szTemp);
+
+			if(GAIA::ALGO::gstrlen(cp) != sLen || GAIA::ALGO::gstrlen(sp) != sLen)
+				++sErrorCount;
+			if(GAIA::ALGO::gstrend(p) != p + sLen)
+				++sErrorCount;
+			for(GAIA::NUM c = 'a'; c <= 'e'; ++c)
+			{
+				if(GAIA::ALGO::gstrch(cp, (_CharType)c) != GAIA::ALGO::gstrch(sp, (_CharType)c).ptr())
+					++sErrorCount;
+				if(GAIA::ALGO::gstrcnt(cp, (_CharType)c) != GAIA::ALGO::gstrcnt(sp, (_CharType)c))
+					++sErrorCount;
+			}
+			if(GAIA::ALGO::gstrch(cp, 'a' + 256) != GNIL || GAIA::ALGO::gstrch(cp, '\0') != GNIL)
+				++sErrorCount;
+			GAIA::NUM sKeyCount = 1 + GAIA::MATH::xrandom() % 10;
+			for(GAIA::NUM y = 0; y < sKeyCount; ++y)
+				szKeys[y] = (_CharType)('c' + GAIA::MATH::xrandom() % 10);
+			szKeys[sKeyCount] = '\0';
+			const _CharType* pKeys = szKeys;
+			if(GAIA::ALGO::gstrchs(cp, pKeys) != GAIA::ALGO::gstrchs(sp, __ScalarPtr(szKeys)).ptr())
+				++sErrorCount;
+			if(GAIA::ALGO::gstrdrop(cp, pKeys) != GAIA::ALGO::gstrdrop(sp, __ScalarPtr(szKeys)).ptr())
+				++sErrorCount;
+			if(GAIA::ALGO::gstrcmp(cp, (const _CharType*)szTemp) != GAIA::ALGO::gstrcmp(sp, st))
+				++sErrorCount;
+			if(GAIA::ALGO::gstrcmp((const _CharType*)szTemp, cp) != GAIA::ALGO::gstrcmp(st, sp))
+				++sErrorCount;
+			GAIA::NUM sCmpLen = GAIA::MATH::xrandom() % (MAX_LEN + 2);
+			if(GAIA::ALGO::gstrcmp(cp, (const _CharType*)szTemp, sCmpLen) != GAIA::ALGO::gstrcmp(sp, st, sCmpLen))
+				++sErrorCount;
+			if(GAIA::ALGO::gstrstr(cp, (const _CharType*)szTemp) != GAIA::ALGO::gstrstr(sp, st).ptr())
+				++sErrorCount;
+
+			// The needle from the string.
+			if(sLen > 0)
+			{
+				GAIA::NUM sBegin = GAIA::MATH::xrandom() % sLen;
+				GAIA::NUM sNeedleLen = 1 + GAIA::MATH::xrandom() % GAIA::ALGO::gmin(sLen - sBegin, (GAIA::NUM)20);
+				for(GAIA::NUM y = 0; y < sNeedleLen; ++y)
+					szTemp[y] = p[sBegin + y];
+				szTemp[sNeedleLen] = '\0';
+				const _CharType* pFinded = GAIA::ALGO::gstrstr(cp, (const _CharType*)szTemp);
+				if(pFinded == GNIL || pFinded > p + sBegin || pFinded != GAIA::ALGO::gstrstr(sp, st).ptr())
+					++sErrorCount;
+			}
+		}
+		if(sErrorCount != 0)
+			TERROR;
+
+		gdel[] pBuf;
+	}
+
 	extern GAIA::GVOID t_algo_string(GAIA::LOG::Log& logobj)
 	{
 		/* start and end with */
@@ -72,5 +179,30 @@ namespace TEST
 				}
 			}
 		}
+
+		// SIMD test, compare to the element by element path.
+		{
+			t_algo_string_simd<GAIA::CH>(logobj);
+			t_algo_string_simd<GAIA::WCH>(logobj);
+
+			GAIA::CH szLong[256];
+			for(GAIA::NUM x = 0; x < 255; ++x)
+				szLong[x] = (GAIA::CH)(1 + x);
+			szLong[255] = '\0';
+			if(GAIA::ALGO::gstrlen(szLong) != 255)
+				TERROR;
+			if(GAIA::ALGO::gstrch(szLong, (GAIA::CH)-1) != szLong + 254)
+				TERROR;
+			if(GAIA::ALGO::gstrch(szLong, 255) != GNIL)
+				TERROR;
+			if(GAIA::ALGO::gstrcmp(szLong, "\x01\x02") <= 0 || GAIA::ALGO::gstrcmp("\x01\x02", szLong) >= 0)
+				TERROR;
+			if(GAIA::ALGO::gstrcmp("abc\x80", "abc\x7F") >= 0)
+				TERROR;
+			if(GAIA::ALGO::gstrstr("Hello World", L"World") == GNIL)
+				TERROR;
+			if(GAIA::ALGO::gstrstr("Hello World", "") == GNIL || GAIA::ALGO::gstrstr("", "") != GNIL)
+				TERROR;
+		}
 	}
 }
@@ -0,0 +1,73 @@
+#include "preheader.h"
+#include "t_common.h"
+
+namespace TEST
+{
+	template<typename _DataType> GAIA::BL t_algo_suffix_check(const _DataType* p, const GAIA::NUM& size, const GAIA::NUM* pSA)
+	{
+		for(GAIA::NUM x = 1; x < size; ++x)
+		{
+			const _DataType* p1 = p + pSA[x - 1];
+			const _DataType* p2 = p + pSA[x];
+			GAIA::NUM sSize1 = size - pSA[x - 1];
+			GAIA::NUM sSize2 = size - pSA[x];
+			GAIA::NUM y = 0;
+			for(; y < sSize1 && y < sSize2; ++y)
+			{
+				if(p1[y] != p2[y])
+					break;
+			}
+			if(y == sSize1 || y == sSize2)
+				return GAIA::False;
+			if(!(p1[y] < p2[y]))
+				return GAIA::False;
+		}
+		return GAIA::True;
+	}
+
+	extern GAIA::GVOID t_algo_suffix(GAIA::LOG::Log& logobj)
+	{
+		GAIA::NUM sa[4096];
+
+		GAIA::U8 szBanana[] = {'b', 'a', 'n', 'a', 'n', 'a', 0};
+		GAIA::ALGO::suffixarray(szBanana, (GAIA::NUM)sizeofarray(szBanana), (GAIA::NUM)256, sa);
+		static const GAIA::NUM BANANA_SA[] = {6, 5, 3, 1, 0, 4, 2};
+		for(GAIA::NUM x = 0; x < sizeofarray(BANANA_SA); ++x)
+		{
+			if(sa[x] != BANANA_SA[x])
+			{
+				TERROR;
+				break;
+			}
+		}
+
+		GAIA::U8 szOne[] = {0};
+		GAIA::ALGO::suffixarray(szOne, (GAIA::NUM)1, (GAIA::NUM)1, sa);
+		if(sa[0] != 0)
+			TERROR;
+
+		/* Random strings of small and large alphabets, and the repeated strings which need the recursion. */
+		{
+			GAIA::MATH::RandomLCG lcg;
+			static const GAIA::NUM ALPHABETS[] = {2, 3, 4, 26, 1000};
+			GAIA::NUM text[sizeofarray(sa)];
+			for(GAIA::NUM x = 0; x < sizeofarray(ALPHABETS); ++x)
+			{
+				for(GAIA::NUM y = 0; y < 10; ++y)
+				{
+					GAIA::NUM sSize = 2 + lcg.random_u32() % (sizeofarray(text) - 1);
+					GAIA::NUM sPeriod = y % 2 == 0 ? sSize : 1 + lcg.random_u32() % 7;
+					for(GAIA::NUM z = 0; z < sSize - 1; ++z)
+						text[z] = z < sPeriod ? 1 + lcg.random_u32() % (ALPHABETS[x] - 1) : text[z - sPeriod];
+					text[sSize - 1] = 0;
+					GAIA::ALGO::suffixarray(text, sSize, ALPHABETS[x], sa);
+					if(!t_algo_suffix_check(text, sSize, sa))
+					{
+						TERROR;
+						break;
+					}
+				}
+			}
+		}
+	}
+}
@@ -548,6 +548,166 @@ namespace TEST
 				}
 				gdel acc.bindfile();
 			}
+
+			/* Expandable accesser in page cache mode, the dirty pages are not written to the released temporary file. */
+			{
+				typedef GAIA::CTN::Accesser<GAIA::NUM, GAIA::NUM, GAIA::ALGO::ExtendGold<GAIA::NUM> > __AccType;
+				__AccType acc;
+				TAST(acc.bindfile(GNIL, __AccType::ACCESS_TYPE_READ | __AccType::ACCESS_TYPE_WRITE, GAIA::False, 2));
+				for(GAIA::NUM x = 0; x < ACCESS_ELEMENT_COUNT; ++x)
+				{
+					if(acc.write(&x, sizeof(x)) != sizeof(x))
+					{
+						TERROR;
+						break;
+					}
+				}
+				acc.index(ACCESS_ELEMENT_COUNT / 2);
+				GAIA::NUM t = GINVALID;
+				if(acc.read(&t, sizeof(t)) != sizeof(t) || t != ACCESS_ELEMENT_COUNT / 2)
+					TERROR;
+				gdel acc.bindfile();
+			}
+
+			/* Mapping and page cache accesser test. */
+			for(GAIA::NUM x = 0; x < 2; ++x)
+			{
+				static const GAIA::NUM ELEMENT_COUNT = 100000;
+				GAIA::BL bMapping = x == 0;
+				typedef GAIA::CTN::Accesser<GAIA::N32, GAIA::NM, GAIA::ALGO::ExtendGold<GAIA::NM> > __AccType;
+				{
+					GAIA::FSYS::File accfile;
+					if(!accfile.Open(strFileName,
+						GAIA::FSYS::File::OPEN_TYPE_READ |
+						GAIA::FSYS::File::OPEN_TYPE_WRITE |
+						GAIA::FSYS::File::OPEN_TYPE_CREATEALWAYS))
+					{
+						TERROR;
+					}
+					__AccType acc;
+					acc.expandable(GAIA::True);
+					TAST(acc.bindfile(&accfile, __AccType::ACCESS_TYPE_READ | __AccType::ACCESS_TYPE_WRITE, bMapping, 2));
+					if(acc.bindpager()->IsMapping() != bMapping)
+						TERROR;
+					TAST(acc.advise(GAIA::CTN::AccesserPager::ADVISE_TYPE_SEQUENTIAL));
+					for(GAIA::NUM y = 0; y < ELEMENT_COUNT; ++y)
+						acc[y] = y * 3;
+					__AccType acc1 = acc;
+					for(GAIA::NUM y = ELEMENT_COUNT - 1; y >= 0; y -= 7)
+					{
+						if(acc1[y] != y * 3)
+						{
+							TERROR;
+							break;
+						}
+					}
+					TAST(acc.flush());
+					if(accfile.Size() != ELEMENT_COUNT * sizeof(GAIA::N32))
+						TERROR;
+				}
+				{
+					GAIA::FSYS::File accfile;
+					if(!accfile.Open(strFileName, GAIA::FSYS::File::OPEN_TYPE_READ))
+						TERROR;
+					if(accfile.Size() != ELEMENT_COUNT * sizeof(GAIA::N32))
+						TERROR;
+					GAIA::CTN::Vector<GAIA::N32> listEle;
+					listEle.resize(ELEMENT_COUNT);
+					if(accfile.Read(listEle.fptr(), listEle.datasize()) != listEle.datasize())
+						TERROR;
+					for(GAIA::NUM y = 0; y < listEle.size(); ++y)
+					{
+						if(listEle[y] != y * 3)
+						{
+							TERROR;
+							break;
+						}
+					}
+				}
+
+				/* The elements cross the pages. */
+				{
+					GAIA::FSYS::File accfile;
+					if(!accfile.Open(strFileName,
+						GAIA::FSYS::File::OPEN_TYPE_READ |
+						GAIA::FSYS::File::OPEN_TYPE_WRITE |
+						GAIA::FSYS::File::OPEN_TYPE_CREATEALWAYS))
+					{
+						TERROR;
+					}
+					accfile.Resize(ELEMENT_COUNT * 5 + 1);
+					__AccType acc;
+					TAST(acc.bindfile(&accfile, __AccType::ACCESS_TYPE_READ | __AccType::ACCESS_TYPE_WRITE, bMapping, 1));
+					TAST(acc.offset(1));
+					TAST(acc.stride(5));
+					for(GAIA::NUM y = 0; y < ELEMENT_COUNT; ++y)
+						acc[y] = -y;
+					for(GAIA::NUM y = 0; y < ELEMENT_COUNT; ++y)
+					{
+						if(acc[y] != -y)
+						{
+							TERROR;
+							break;
+						}
+					}
+					TAST(acc.flush());
+				}
+
+				/* The reserved tail is cut when the accesser is destroyed without flush. */
+				{
+					GAIA::FSYS::File accfile;
+					if(!accfile.Open(strFileName,
+						GAIA::FSYS::File::OPEN_TYPE_READ |
+						GAIA::FSYS::File::OPEN_TYPE_WRITE |
+						GAIA::FSYS::File::OPEN_TYPE_CREATEALWAYS))
+					{
+						TERROR;
+					}
+					{
+						__AccType acc;
+						acc.expandable(GAIA::True);
+						TAST(acc.bindfile(&accfile, __AccType::ACCESS_TYPE_READ | __AccType::ACCESS_TYPE_WRITE, bMapping, 2));
+						for(GAIA::NUM y = 0; y < 1000; ++y)
+							acc[y] = y;
+					}
+					if(accfile.Size() != 1000 * sizeof(GAIA::N32))
+						TERROR;
+				}
+			}
+
+			/* Page cache accesser of a file without native handle. */
+			{
+				typedef GAIA::CTN::Accesser<GAIA::N64, GAIA::NM, GAIA::ALGO::ExtendGold<GAIA::NM> > __AccType;
+				GAIA::FSYS::MemFile accfile;
+				TAST(accfile.Open(_T("accesser_memfile"), GAIA::FSYS::FileBase::OPEN_TYPE_READ | GAIA::FSYS::FileBase::OPEN_TYPE_WRITE));
+				{
+					__AccType acc;
+					acc.expandable(GAIA::True);
+					TAST(acc.bindfile(&accfile, __AccType::ACCESS_TYPE_READ | __AccType::ACCESS_TYPE_WRITE, GAIA::True, 3));
+					if(acc.bindpager()->IsMapping())
+						TERROR;
+					for(GAIA::N64 x = 0; x < 50000; ++x)
+					{
+						if(acc.write(&x, sizeof(x)) != sizeof(x))
+						{
+							TERROR;
+							break;
+						}
+					}
+				}
+				if(accfile.Size() != 50000 * sizeof(GAIA::N64))
+					TERROR;
+				__AccType acc;
+				TAST(acc.bindfile(&accfile, __AccType::ACCESS_TYPE_READ, GAIA::True, 3));
+				for(GAIA::NUM x = 0; x < 50000; x += 3)
+				{
+					if(acc[x] != x)
+					{
+						TERROR;
+						break;
+					}
+				}
+			}
 		}
 	}
 }
@@ -121,5 +121,113 @@ namespace TEST
 			TERROR;
 		if(b.one())
 			TERROR;
+
+		/* Word operations, rank, select and find next. */
+		{
+			typedef GAIA::CTN::BasicBitset<GAIA::N64, GAIA::ALGO::ExtendGold<GAIA::N64> > __BigBitsetType;
+			static const GAIA::N64 SIZES[] = {1, 63, 64, 65, 511, 512, 513, 65536, 70000, 200003};
+			GAIA::MATH::RandomLCG lcg;
+			for(GAIA::NUM x = 0; x < sizeofarray(SIZES); ++x)
+			{
+				__BigBitsetType bs, bs1;
+				bs.resize(SIZES[x]);
+				bs1.resize(SIZES[x] / 2 + 1);
+				GAIA::CTN::Vector<GAIA::BL> listRef;
+				listRef.resize((GAIA::NUM)SIZES[x]);
+				for(GAIA::NUM y = 0; y < listRef.size(); ++y)
+				{
+					listRef[y] = (lcg.random_u32() % (x + 2)) == 0;
+					if(listRef[y])
+						bs.set(y);
+				}
+				for(GAIA::N64 y = 0; y < bs1.size(); y += 3)
+					bs1.set(y);
+				for(GAIA::NUM z = 0; z < 2; ++z)
+				{
+					if(z == 1)
+						bs.buildindex();
+					if(bs.isindex() != (z == 1))
+						TERROR;
+					GAIA::N64 count = 0;
+					for(GAIA::NUM y = 0; y < listRef.size(); ++y)
+					{
+						if(bs.rank(y) != count)
+						{
+							TERROR;
+							break;
+						}
+						if(listRef[y])
+						{
+							if(bs.select(count) != y)
+							{
+								TERROR;
+								break;
+							}
+							++count;
+						}
+					}
+					if(bs.count() != count || bs.rank(bs.size()) != count)
+						TERROR;
+					if(bs.select(count) != GINVALID)
+						TERROR;
+				}
+				GAIA::N64 next = GINVALID;
+				for(GAIA::NUM y = listRef.size() - 1; y >= 0; --y)
+				{
+					if(listRef[y])
+						next = y;
+					if(bs.findnext(y) != next)
+					{
+						TERROR;
+						break;
+					}
+				}
+				if(bs.findnext(bs.size()) != GINVALID)
+					TERROR;
+
+				__BigBitsetType bsOr = bs, bsAnd = bs, bsXor = bs;
+				bsOr |= bs1;
+				bsAnd &= bs1;
+				bsXor ^= bs1;
+				if(bsOr.size() != GAIA::ALGO::gmax(bs.size(), bs1.size()) || bsAnd.size() != bs.size() || bsXor.size() != bsOr.size())
+					TERROR;
+				for(GAIA::N64 y = 0; y < bsOr.size(); ++y)
+				{
+					GAIA::BL b0 = y < bs.size() && bs.exist(y);
+					GAIA::BL b1 = y < bs1.size() && bs1.exist(y);
+					if(bsOr.exist(y) != (b0 || b1) || bsXor.exist(y) != (b0 != b1) || (y < bsAnd.size() && bsAnd.exist(y) != (b0 && b1)))
+					{
+						TERROR;
+						break;
+					}
+				}
+
+				__BigBitsetType bsNot = ~bs;
+				if(bsNot.count() + bs.count() != bs.size())
+					TERROR;
+				bsNot |= bs;
+				TAST(bsNot.one());
+				bsNot.resize(bsNot.size() - 1);
+				if(bsNot.count() != bsNot.size())
+					TERROR;
+				bsNot.resize(bsNot.size() + 100);
+				if(bsNot.count() != bsNot.size() - 100)
+					TERROR;
+			}
+
+			__BitsetType bp;
+			for(GAIA::NUM x = 0; x < 100; ++x)
+				bp.push_back(x % 3 == 0);
+			if(bp.size() != 100 || bp.count() != 34)
+				TERROR;
+			for(GAIA::NUM x = 0; x < 100; ++x)
+			{
+				if(bp.exist(x) != (x % 3 == 0))
+				{
+					TERROR;
+					break;
+				}
+			}
+		}
 	}
 }
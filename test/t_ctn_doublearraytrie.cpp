@@ -0,0 +1,148 @@
+#include "preheader.h"
+#include "t_common.h"
+
+namespace TEST
+{
+	template<typename _TrieType, typename _DATrieType> GAIA::BL t_ctn_doublearraytrie_check(
+		const _TrieType& t, const _DATrieType& dat, const typename _TrieType::_datatype* p, const typename _TrieType::_sizetype& size)
+	{
+		for(typename _TrieType::_sizetype x = 1; x <= size; ++x)
+		{
+			const typename _TrieType::Node* pNode = t.find(GNIL, p, x);
+			typename _DATrieType::_sizetype state = dat.find(p, x);
+			if(pNode == GNIL)
+			{
+				if(state != (typename _DATrieType::_sizetype)GINVALID || dat.exist(p, x))
+					return GAIA::False;
+				continue;
+			}
+			if(state == (typename _DATrieType::_sizetype)GINVALID || !dat.exist(p, x))
+				return GAIA::False;
+			if(dat.count(state) != t.count(*pNode) ||
+				dat.catagory_count(state) != t.catagory_count(*pNode) ||
+				dat.full_count(state) != t.full_count(*pNode))
+				return GAIA::False;
+		}
+		return GAIA::True;
+	}
+
+	extern GAIA::GVOID t_ctn_doublearraytrie(GAIA::LOG::Log& logobj)
+	{
+		typedef GAIA::CTN::BasicTrieTree<GAIA::N8, GAIA::NUM, GAIA::ALGO::ExtendGold<GAIA::NUM> > __TrieType;
+		typedef GAIA::CTN::BasicDoubleArrayTrie<GAIA::N8, GAIA::NUM, GAIA::ALGO::ExtendGold<GAIA::NUM> > __DATrieType;
+
+		__DATrieType dat;
+		TAST(dat.empty());
+		GAIA::N8 szEmpty[] = "abc";
+		if(dat.exist(szEmpty, 3) || dat.longest(szEmpty, 3) != 0)
+			TERROR;
+		__TrieType t;
+		dat.build(t);
+		TAST(dat.empty());
+		if(dat.exist(szEmpty, 1))
+			TERROR;
+
+		/* Words of one byte keys. */
+		{
+			static const GAIA::NUM WORD_COUNT = 3000;
+			static const GAIA::NUM WORD_MAX_SIZE = 12;
+			GAIA::MATH::RandomLCG lcg;
+			GAIA::CTN::Vector<GAIA::N8> listWord;
+			for(GAIA::NUM x = 0; x < WORD_COUNT; ++x)
+			{
+				GAIA::NUM sSize = 1 + lcg.random_u32() % WORD_MAX_SIZE;
+				for(GAIA::NUM y = 0; y < sSize; ++y)
+				{
+					GAIA::U32 u = lcg.random_u32() % 40;
+					listWord.push_back(u < 26 ? (GAIA::N8)('a' + u) : (GAIA::N8)(0x80 + u));
+				}
+				listWord.push_back(0);
+				t.insert(listWord.fptr() + listWord.size() - sSize - 1, sSize);
+			}
+			GAIA::N8 szAgain[] = "ab";
+			t.insert(szAgain, 2);
+			t.insert(szAgain, 2);
+			dat.build(t);
+			if(dat.size() != t.size())
+				TERROR;
+			const GAIA::N8* p = listWord.fptr();
+			for(GAIA::NUM x = 0; x < WORD_COUNT; ++x)
+			{
+				GAIA::NUM sSize = GAIA::ALGO::gstrlen(p);
+				if(!t_ctn_doublearraytrie_check(t, dat, p, sSize))
+				{
+					TERROR;
+					break;
+				}
+				if(dat.longest(p, sSize) != sSize)
+				{
+					TERROR;
+					break;
+				}
+				p += sSize + 1;
+			}
+			if(dat.count(dat.find(szAgain, 2)) < 2 || dat.count(dat.find(szAgain, 2)) != t.count(*t.find(GNIL, szAgain, 2)))
+				TERROR;
+			for(GAIA::NUM x = 0; x < 1000; ++x)
+			{
+				GAIA::N8 key[WORD_MAX_SIZE + 4];
+				GAIA::NUM sSize = 1 + lcg.random_u32() % (WORD_MAX_SIZE + 4);
+				for(GAIA::NUM y = 0; y < sSize; ++y)
+					key[y] = (GAIA::N8)('a' + lcg.random_u32() % 27);
+				if(!t_ctn_doublearraytrie_check(t, dat, key, sSize))
+				{
+					TERROR;
+					break;
+				}
+				GAIA::NUM sLongest = 0;
+				for(GAIA::NUM y = 1; y <= sSize; ++y)
+				{
+					const __TrieType::Node* pNode = t.find(GNIL, key, y);
+					if(pNode == GNIL)
+						break;
+					if(t.count(*pNode) > 0)
+						sLongest = y;
+				}
+				if(dat.longest(key, sSize) != sLongest)
+				{
+					TERROR;
+					break;
+				}
+			}
+			dat.clear();
+			TAST(dat.empty());
+			if(dat.exist(szAgain, 2))
+				TERROR;
+		}
+
+		/* Integer keys. */
+		{
+			typedef GAIA::CTN::BasicTrieTree<GAIA::N32, GAIA::NUM, GAIA::ALGO::ExtendGold<GAIA::NUM> > __IntTrieType;
+			typedef GAIA::CTN::BasicDoubleArrayTrie<GAIA::N32, GAIA::NUM, GAIA::ALGO::ExtendGold<GAIA::NUM> > __IntDATrieType;
+			__IntTrieType it;
+			__IntDATrieType idat;
+			GAIA::MATH::RandomLCG lcg;
+			GAIA::N32 keys[100][5];
+			for(GAIA::NUM x = 0; x < 100; ++x)
+			{
+				for(GAIA::NUM y = 0; y < 5; ++y)
+					keys[x][y] = (GAIA::N32)(lcg.random_u32() % 10) * 100000 - 300000;
+				it.insert(keys[x], 5);
+			}
+			idat.build(it);
+			if(idat.size() != it.size())
+				TERROR;
+			for(GAIA::NUM x = 0; x < 100; ++x)
+			{
+				if(!t_ctn_doublearraytrie_check(it, idat, keys[x], 5))
+				{
+					TERROR;
+					break;
+				}
+			}
+			GAIA::N32 keyn[2] = {keys[0][0], 1};
+			if(idat.exist(keyn, 2))
+				TERROR;
+		}
+	}
+}
@@ -0,0 +1,110 @@
+#include "preheader.h"
+#include "t_common.h"
+
+namespace TEST
+{
+	extern GAIA::GVOID t_ctn_flathashmap(GAIA::LOG::Log& logobj)
+	{
+		static const GAIA::NUM ELEMENT_COUNT = 1000;
+		typedef GAIA::CTN::BasicFlatHashMap<GAIA::N32, GAIA::N32, GAIA::N32> __HashMapType;
+		__HashMapType hm, hm1;
+		TAST(hm.empty());
+		TAST(hm.capacity() == 0);
+		TAST(hm.size() == 0);
+		for(__HashMapType::_keytype x = 0; x < ELEMENT_COUNT; ++x)
+		{
+			if(!hm.insert(x, -x))
+			{
+				TERROR;
+				break;
+			}
+		}
+		TAST(!hm.empty());
+		TAST(!hm.insert(0, 1));
+		TAST(*hm.find(0) == 0);
+		for(__HashMapType::_keytype x = 0; x < ELEMENT_COUNT; ++x)
+		{
+			__HashMapType::_datatype* pFinded = hm.find(x);
+			if(pFinded == GNIL)
+			{
+				TERROR;
+				break;
+			}
+			if(*pFinded != -x)
+			{
+				TERROR;
+				break;
+			}
+		}
+		hm1 = hm;
+		TAST(hm1.size() == hm.size());
+		for(__HashMapType::_keytype x = 0; x < ELEMENT_COUNT; ++x)
+		{
+			if(!hm.erase(x))
+			{
+				TERROR;
+				break;
+			}
+		}
+		TAST(hm.empty());
+		TAST(hm.size() == 0);
+		TAST(hm.capacity() != 0);
+		TAST(!hm.erase(-1));
+		hm = hm1;
+		__HashMapType::it itfront = hm.frontit();
+		TAST(!itfront.empty());
+		__HashMapType::it itback = hm.backit();
+		TAST(!itback.empty());
+		__HashMapType::const_it citfront = hm.const_frontit();
+		TAST(!citfront.empty());
+		__HashMapType::const_it citback = hm.const_backit();
+		TAST(!citback.empty());
+		GAIA::N64 nSum = 0;
+		for(__HashMapType::_datatype x = 0; x < ELEMENT_COUNT; ++x)
+		{
+			TAST(!itfront.empty());
+			TAST(!itback.empty());
+			TAST(!citfront.empty());
+			TAST(!citback.empty());
+			nSum += *citfront;
+			++itfront;
+			--itback;
+			++citfront;
+			--citback;
+		}
+		TAST(itfront.empty());
+		TAST(itback.empty());
+		TAST(citfront.empty());
+		TAST(citback.empty());
+		TAST(nSum == -(GAIA::N64)ELEMENT_COUNT * (ELEMENT_COUNT - 1) / 2);
+		for(itfront = hm.frontit(); !itfront.empty(); )
+			hm.erase(itfront);
+		TAST(hm.empty());
+		hm.clear();
+		hm.destroy();
+		hm1.destroy();
+		hm1.clear();
+		TAST(hm.empty());
+		TAST(hm1.empty());
+
+		GAIA::CTN::FlatHashMap<GAIA::CTN::AString, GAIA::NUM> hm_string;
+		for(GAIA::NUM x = 0; x < ELEMENT_COUNT; ++x)
+		{
+			GAIA::CTN::AString str = "Key";
+			str += x;
+			hm_string.insert(str, x);
+		}
+		TAST(hm_string.size() == ELEMENT_COUNT);
+		for(GAIA::NUM x = 0; x < ELEMENT_COUNT; ++x)
+		{
+			GAIA::CTN::AString str = "Key";
+			str += x;
+			GAIA::NUM* pFinded = hm_string.find(str);
+			if(pFinded == GNIL || *pFinded != x)
+			{
+				TERROR;
+				break;
+			}
+		}
+	}
+}
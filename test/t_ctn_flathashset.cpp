@@ -0,0 +1,171 @@
+#include "preheader.h"
+#include "t_common.h"
+
+namespace TEST
+{
+	class FlatCustomData : public GAIA::Base
+	{
+	public:
+		GAIA::U64 hash() const
+		{
+			return m_v;
+		}
+		GAIA::BL operator == (const FlatCustomData& src) const
+		{
+			return m_v == src.m_v;
+		}
+		GAIA::BL operator != (const FlatCustomData& src) const
+		{
+			return m_v != src.m_v;
+		}
+	public:
+		GAIA::N64 m_v;
+	};
+	extern GAIA::GVOID t_ctn_flathashset(GAIA::LOG::Log& logobj)
+	{
+		static const GAIA::NUM ELEMENT_COUNT = 1000;
+		typedef GAIA::CTN::BasicFlatHashSet<GAIA::N32, GAIA::N32> __HashSetType;
+		__HashSetType hs, hs1;
+		TAST(hs.empty());
+		TAST(hs.capacity() == 0);
+		TAST(hs.size() == 0);
+		TAST(hs.find(0) == GNIL);
+		for(__HashSetType::_datatype x = 0; x < ELEMENT_COUNT; ++x)
+		{
+			if(!hs.insert(x))
+			{
+				TERROR;
+				break;
+			}
+		}
+		TAST(!hs.empty());
+		TAST(hs.size() == ELEMENT_COUNT);
+		TAST(hs.capacity() >= ELEMENT_COUNT);
+		TAST(!hs.insert(0));
+		TAST(hs.size() == ELEMENT_COUNT);
+		for(__HashSetType::_datatype x = 0; x < ELEMENT_COUNT; ++x)
+		{
+			__HashSetType::_datatype* pFinded = hs.find(x);
+			if(pFinded == GNIL)
+			{
+				TERROR;
+				break;
+			}
+			if(*pFinded != x)
+			{
+				TERROR;
+				break;
+			}
+		}
+		TAST(hs.find(ELEMENT_COUNT) == GNIL);
+		hs1 = hs;
+		TAST(hs1.size() == hs.size());
+		for(__HashSetType::_datatype x = 0; x < ELEMENT_COUNT; ++x)
+		{
+			if(!hs.erase(x))
+			{
+				TERROR;
+				break;
+			}
+		}
+		TAST(hs.empty());
+		TAST(hs.size() == 0);
+		TAST(hs.capacity() != 0);
+		TAST(!hs.erase(-1));
+		hs = hs1;
+		__HashSetType::it itfront = hs.frontit();
+		TAST(!itfront.empty());
+		__HashSetType::it itback = hs.backit();
+		TAST(!itback.empty());
+		__HashSetType::const_it citfront = hs.const_frontit();
+		TAST(!citfront.empty());
+		__HashSetType::const_it citback = hs.const_backit();
+		TAST(!citback.empty());
+		for(__HashSetType::_datatype x = 0; x < ELEMENT_COUNT; ++x)
+		{
+			TAST(!itfront.empty());
+			TAST(!itback.empty());
+			TAST(!citfront.empty());
+			TAST(!citback.empty());
+			++itfront;
+			--itback;
+			++citfront;
+			--citback;
+		}
+		TAST(itfront.empty());
+		TAST(itback.empty());
+		TAST(citfront.empty());
+		TAST(citback.empty());
+
+		// Erase by iterator and reuse the deleted slots.
+		for(itfront = hs.frontit(); !itfront.empty(); )
+		{
+			if(*itfront % 2 == 0)
+				hs.erase(itfront);
+			else
+				++itfront;
+		}
+		TAST(hs.size() == ELEMENT_COUNT / 2);
+		for(__HashSetType::_datatype x = 0; x < ELEMENT_COUNT; ++x)
+		{
+			if((hs.find(x) != GNIL) != (x % 2 != 0))
+			{
+				TERROR;
+				break;
+			}
+		}
+		for(GAIA::NUM sRound = 0; sRound < 10; ++sRound)
+		{
+			for(__HashSetType::_datatype x = 0; x < ELEMENT_COUNT; x += 2)
+				hs.insert(x + sRound * ELEMENT_COUNT);
+			for(__HashSetType::_datatype x = 0; x < ELEMENT_COUNT; x += 2)
+				hs.erase(x + sRound * ELEMENT_COUNT);
+		}
+		TAST(hs.size() == ELEMENT_COUNT / 2);
+		GAIA::NUM sCount = 0;
+		for(citfront = hs.const_frontit(); !citfront.empty(); ++citfront)
+			++sCount;
+		TAST(sCount == hs.size());
+
+		hs.SetMaxLoadFactor(0.5F);
+		TAST(hs.GetMaxLoadFactor() == 0.5F);
+		hs.reserve(ELEMENT_COUNT * 4);
+		TAST(hs.capacity() >= ELEMENT_COUNT * 8);
+		TAST(hs.size() == ELEMENT_COUNT / 2);
+		TAST(hs.find(1) != GNIL);
+		hs1.clear();
+		hs1 += hs;
+		TAST(hs1.size() == hs.size());
+
+		hs.clear();
+		hs.destroy();
+		hs1.destroy();
+		hs1.clear();
+		TAST(hs.empty());
+		TAST(hs1.empty());
+
+		GAIA::CTN::FlatHashSet<FlatCustomData> hs_userdecl;
+		for(__HashSetType::_datatype x = 0; x < ELEMENT_COUNT; ++x)
+		{
+			FlatCustomData cd;
+			cd.m_v = x;
+			hs_userdecl.insert(cd);
+		}
+		for(__HashSetType::_datatype x = 0; x < ELEMENT_COUNT; ++x)
+		{
+			FlatCustomData cd;
+			cd.m_v = x;
+			FlatCustomData* pFinded = hs_userdecl.find(cd);
+			if(pFinded == GNIL)
+			{
+				TERROR;
+				break;
+			}
+			if(pFinded->m_v != x)
+			{
+				TERROR;
+				break;
+			}
+		}
+	}
+}
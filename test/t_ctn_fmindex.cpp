@@ -0,0 +1,231 @@
+#include "preheader.h"
+#include "t_common.h"
+
+namespace TEST
+{
+	typedef GAIA::CTN::BasicFMIndex<GAIA::CTN::AString, GAIA::CH, GAIA::NUM, GAIA::ALGO::ExtendGold<GAIA::NUM> > __FMIndexType;
+	typedef GAIA::CTN::BasicFMIndex<GAIA::NUM, GAIA::CH, GAIA::NUM, GAIA::ALGO::ExtendGold<GAIA::NUM> > __FMIndexNumType;
+
+	class TestFMIndexFindCallBack : public __FMIndexType::FindCallBack
+	{
+	public:
+		virtual GAIA::BL find(__FMIndexType& g,
+			const GAIA::CH* pKeys, const GAIA::NUM& keysize, const GAIA::CTN::AString& t)
+		{
+			listData.push_back(t);
+			return GAIA::True;
+		}
+	public:
+		GINL GAIA::GVOID clear(){listData.clear();}
+		GINL GAIA::GVOID sort(){listData.sort();}
+	public:
+		GAIA::CTN::Vector<GAIA::CTN::AString> listData;
+	};
+
+	class TestFMIndexCountCallBack : public __FMIndexNumType::FindCallBack
+	{
+	public:
+		virtual GAIA::BL find(__FMIndexNumType& g,
+			const GAIA::CH* pKeys, const GAIA::NUM& keysize, const GAIA::NUM& t)
+		{
+			listData.push_back(t);
+			return GAIA::True;
+		}
+	public:
+		GAIA::CTN::Vector<GAIA::NUM> listData;
+	};
+
+	GINL GAIA::NUM t_ctn_fmindex_match(const GAIA::CH* p, GAIA::NUM size, const GAIA::CH* pKeys, GAIA::NUM keysize, GAIA::BL bMatchLeft, GAIA::BL bMatchRight)
+	{
+		GAIA::NUM ret = 0;
+		for(GAIA::NUM x = 0; x + keysize <= size; ++x)
+		{
+			if(bMatchLeft && x != 0)
+				break;
+			if(bMatchRight && x + keysize != size)
+				continue;
+			if(GAIA::ALGO::gmemcmp(p + x, pKeys, keysize) == 0)
+				++ret;
+		}
+		return ret;
+	}
+
+	extern GAIA::GVOID t_ctn_fmindex(GAIA::LOG::Log& logobj)
+	{
+		__FMIndexType fmi;
+		TAST(fmi.empty());
+		if(fmi.size() != 0)
+			TERROR;
+		if(fmi.find("HelloWorld", 10) != GNIL)
+			TERROR;
+
+		/* The same matches as GAIA::CTN::BasicDMPGraph. */
+		fmi.insert("HelloWorld", 10, "HelloWorld");
+		if(fmi.size() != 1)
+			TERROR;
+		for(GAIA::NUM x = 0; x < 2; ++x)
+		{
+			if(x == 1)
+			{
+				fmi.build();
+				if(fmi.segment_count() != 1)
+					TERROR;
+			}
+			if(fmi.find("HelloWorld", 10) == GNIL)
+				TERROR;
+			if(fmi.find("HelloWor", 8) != GNIL || fmi.find("lloWorld", 8) != GNIL || fmi.find("l", 1) != GNIL)
+				TERROR;
+			TestFMIndexFindCallBack cb;
+			if(fmi.find("HelloWorld", 10, GAIA::True, GAIA::True, cb) != 1 || cb.listData.size() != 1 || cb.listData[0] != "HelloWorld")
+				TERROR;
+			cb.clear();
+			if(fmi.find("HelloWor", 8, GAIA::True, GAIA::False, cb) != 1 || cb.listData.size() != 1)
+				TERROR;
+			cb.clear();
+			if(fmi.find("HelloWor", 8, GAIA::False, GAIA::True, cb) != 0 || cb.listData.size() != 0)
+				TERROR;
+			cb.clear();
+			if(fmi.find("lloWorld", 8, GAIA::False, GAIA::True, cb) != 1 || cb.listData.size() != 1)
+				TERROR;
+			cb.clear();
+			if(fmi.find("lloWor", 6, GAIA::False, GAIA::False, cb) != 1 || cb.listData.size() != 1)
+				TERROR;
+			cb.clear();
+			if(fmi.find("l", 1, GAIA::False, GAIA::False, cb) != 3 || cb.listData.size() != 3)
+				TERROR;
+			cb.clear();
+			if(fmi.find("x", 1, GAIA::False, GAIA::False, cb) != 0 || cb.listData.size() != 0)
+				TERROR;
+		}
+
+		fmi.insert("ll", 2, "ll");
+		if(fmi.size() != 2)
+			TERROR;
+		{
+			TestFMIndexFindCallBack cb;
+			if(fmi.find("ll", 2, GAIA::False, GAIA::False, cb) != 2)
+				TERROR;
+			cb.sort();
+			if(cb.listData.size() != 2 || cb.listData[0] != "HelloWorld" || cb.listData[1] != "ll")
+				TERROR;
+			cb.clear();
+			if(fmi.find("ll", 2, GAIA::True, GAIA::False, cb) != 1 || cb.listData[0] != "ll")
+				TERROR;
+			cb.clear();
+			if(fmi.find("ll", 2, GAIA::False, GAIA::True, cb) != 1 || cb.listData[0] != "ll")
+				TERROR;
+		}
+		__FMIndexType fmiCopy = fmi;
+		if(fmiCopy.size() != 2 || fmiCopy.find("ll", 2) == GNIL)
+			TERROR;
+		TAST(fmi.erase("ll", 2, "ll"));
+		if(fmi.erase("ll", 2, "ll"))
+			TERROR;
+		if(fmi.size() != 1 || fmi.find("ll", 2) != GNIL)
+			TERROR;
+		if(fmi.erase("l", 1, GAIA::False, GAIA::False) != 1)
+			TERROR;
+		TAST(fmi.empty());
+		if(fmiCopy.erase("ll", 2) != 1 || fmiCopy.size() != 1)
+			TERROR;
+		fmi.destroy();
+		TAST(fmi.empty());
+
+		/* Many key lists in several segments, compared with the brute force matches. */
+		{
+			static const GAIA::NUM SAMPLE_COUNT = 12000;
+			static const GAIA::NUM KEY_MAX_SIZE = 8;
+			GAIA::MATH::RandomLCG lcg;
+			__FMIndexNumType fmin;
+			GAIA::CTN::Vector<GAIA::CH> listKey;
+			GAIA::CTN::Vector<GAIA::NUM> listOffset;
+			GAIA::CTN::Vector<GAIA::BL> listErased;
+			listOffset.push_back(0);
+			for(GAIA::NUM x = 0; x < SAMPLE_COUNT; ++x)
+			{
+				GAIA::NUM sSize = 1 + lcg.random_u32() % KEY_MAX_SIZE;
+				for(GAIA::NUM y = 0; y < sSize; ++y)
+					listKey.push_back((GAIA::CH)('a' + lcg.random_u32() % 6));
+				listOffset.push_back(listKey.size());
+				listErased.push_back(GAIA::False);
+				fmin.insert(listKey.fptr() + listKey.size() - sSize, sSize, x);
+			}
+			if(fmin.size() != SAMPLE_COUNT)
+				TERROR;
+			if(fmin.segment_count() < 2)
+				TERROR;
+			for(GAIA::NUM x = 0; x < SAMPLE_COUNT; x += 3)
+			{
+				if(!fmin.erase(listKey.fptr() + listOffset[x], listOffset[x + 1] - listOffset[x], x))
+				{
+					TERROR;
+					break;
+				}
+				listErased[x] = GAIA::True;
+			}
+			for(GAIA::NUM z = 0; z < 2; ++z)
+			{
+				if(z == 1)
+				{
+					fmin.build();
+					if(fmin.segment_count() != 1)
+						TERROR;
+				}
+				GAIA::NUM sLive = 0;
+				for(GAIA::NUM x = 0; x < SAMPLE_COUNT; ++x)
+				{
+					if(!listErased[x])
+						++sLive;
+				}
+				if(fmin.size() != sLive)
+					TERROR;
+				for(GAIA::NUM x = 0; x < 200; ++x)
+				{
+					GAIA::CH key[4];
+					GAIA::NUM sSize = 1 + lcg.random_u32() % sizeofarray(key);
+					for(GAIA::NUM y = 0; y < sSize; ++y)
+						key[y] = (GAIA::CH)('a' + lcg.random_u32() % 7);
+					GAIA::BL bMatchLeft = (x & 1) != 0;
+					GAIA::BL bMatchRight = (x & 2) != 0;
+					GAIA::NUM sExpect = 0;
+					for(GAIA::NUM y = 0; y < SAMPLE_COUNT; ++y)
+					{
+						if(!listErased[y])
+							sExpect += t_ctn_fmindex_match(listKey.fptr() + listOffset[y], listOffset[y + 1] - listOffset[y], key, sSize, bMatchLeft, bMatchRight);
+					}
+					TestFMIndexCountCallBack cb;
+					if(fmin.find(key, sSize, bMatchLeft, bMatchRight, cb) != sExpect || cb.listData.size() != sExpect)
+					{
+						TERROR;
+						break;
+					}
+					for(GAIA::NUM y = 0; y < cb.listData.size(); ++y)
+					{
+						GAIA::NUM sIndex = cb.listData[y];
+						if(listErased[sIndex] || t_ctn_fmindex_match(listKey.fptr() + listOffset[sIndex], listOffset[sIndex + 1] - listOffset[sIndex], key, sSize, bMatchLeft, bMatchRight) == 0)
+						{
+							TERROR;
+							break;
+						}
+					}
+				}
+			}
+			for(GAIA::NUM x = 0; x < SAMPLE_COUNT; ++x)
+			{
+				if(listErased[x])
+					continue;
+				const GAIA::NUM* pFinded = fmin.find(listKey.fptr() + listOffset[x], listOffset[x + 1] - listOffset[x]);
+				if(pFinded == GNIL || t_ctn_fmindex_match(listKey.fptr() + listOffset[*pFinded], listOffset[*pFinded + 1] - listOffset[*pFinded],
+					listKey.fptr() + listOffset[x], listOffset[x + 1] - listOffset[x], GAIA::True, GAIA::True) != 1)
+				{
+					TERROR;
+					break;
+				}
+			}
+			GAIA::NUM sErased = fmin.erase("ab", 2, GAIA::True, GAIA::False);
+			TestFMIndexCountCallBack cb;
+			if(sErased == 0 || fmin.find("ab", 2, GAIA::True, GAIA::False, cb) != 0)
+				TERROR;
+		}
+	}
+}
@@ -0,0 +1,192 @@
+#include "preheader.h"
+#include "t_common.h"
+
+namespace TEST
+{
+	template<typename _TreeType, typename _VecType> GAIA::BL t_ctn_kdtree_check(const _TreeType& kdt, const GAIA::CTN::Vector<_VecType>& listPos, const GAIA::CTN::Vector<GAIA::BL>& listErased, GAIA::MATH::RandomLCG& lcg)
+	{
+		typedef typename _TreeType::_valuetype __ValueType;
+		typename _TreeType::__NeighborListType result;
+		GAIA::CTN::Vector<__ValueType> listDist;
+		for(GAIA::NUM x = 0; x < 50; ++x)
+		{
+			_VecType pos;
+			for(GAIA::NUM y = 0; y < pos.size(); ++y)
+				pos[y] = (__ValueType)(lcg.random_u32() % 1200) - (__ValueType)100;
+			listDist.clear();
+			for(GAIA::NUM y = 0; y < listPos.size(); ++y)
+			{
+				if(!listErased[y])
+					listDist.push_back((listPos[y] - pos).lengthsq());
+			}
+			listDist.sort();
+
+			// K nearest.
+			GAIA::NUM k = 1 + x % 20;
+			kdt.nearest(pos, k, result);
+			if(result.size() != GAIA::ALGO::gmin(k, listDist.size()))
+				return GAIA::False;
+			for(GAIA::NUM y = 0; y < result.size(); ++y)
+			{
+				if(result[y].distsq != listDist[y] || result[y].distsq != (result[y].pItem->pos - pos).lengthsq())
+					return GAIA::False;
+				if(listErased[result[y].pItem->t] || listPos[result[y].pItem->t] != result[y].pItem->pos)
+					return GAIA::False;
+			}
+
+			// Radius.
+			__ValueType r = (__ValueType)(lcg.random_u32() % 200);
+			kdt.radius(pos, r, result);
+			GAIA::NUM sExpect = 0;
+			while(sExpect < listDist.size() && listDist[sExpect] <= r * r)
+				++sExpect;
+			if(result.size() != sExpect)
+				return GAIA::False;
+			for(GAIA::NUM y = 0; y < result.size(); ++y)
+			{
+				if(result[y].distsq != listDist[y] || listErased[result[y].pItem->t])
+					return GAIA::False;
+			}
+		}
+		return GAIA::True;
+	}
+
+	extern GAIA::GVOID t_ctn_kdtree(GAIA::LOG::Log& logobj)
+	{
+		typedef GAIA::MATH::VEC3<GAIA::F32> __Vec3Type;
+		typedef GAIA::MATH::VEC2<GAIA::N32> __Vec2Type;
+		typedef GAIA::CTN::BasicKDTree<GAIA::NUM, __Vec3Type, GAIA::NUM, GAIA::ALGO::ExtendGold<GAIA::NUM> > __KDTree3Type;
+		typedef GAIA::CTN::BasicKDTree<GAIA::NUM, __Vec2Type, GAIA::NUM, GAIA::ALGO::ExtendGold<GAIA::NUM> > __KDTree2Type;
+
+		__KDTree3Type kdt;
+		TAST(kdt.empty());
+		__KDTree3Type::__NeighborListType result;
+		kdt.nearest(__Vec3Type(0, 0, 0), 3, result);
+		if(!result.empty())
+			TERROR;
+		if(kdt.find(__Vec3Type(0, 0, 0)) != GNIL || kdt.erase(__Vec3Type(0, 0, 0), 0))
+			TERROR;
+		kdt.insert(__Vec3Type(1, 2, 3), 10);
+		kdt.insert(__Vec3Type(1, 2, 3), 11);
+		kdt.insert(__Vec3Type(-1, 0, 0), 12);
+		if(kdt.size() != 3)
+			TERROR;
+		for(GAIA::NUM x = 0; x < 2; ++x)
+		{
+			if(x == 1)
+				kdt.build();
+			const GAIA::NUM* pFinded = kdt.find(__Vec3Type(1, 2, 3));
+			if(pFinded == GNIL || (*pFinded != 10 && *pFinded != 11))
+				TERROR;
+			kdt.nearest(__Vec3Type(-1, 0, 1), 2, result);
+			if(result.size() != 2 || result[0].pItem->t != 12 || result[0].distsq != 1.0F || result[1].distsq != 12.0F)
+				TERROR;
+			GAIA::CTN::BasicVector<const __KDTree3Type::Item*, GAIA::NUM, GAIA::ALGO::ExtendGold<GAIA::NUM> > listItem;
+			kdt.range(GAIA::MATH::AABB<GAIA::F32>(0, 0, 0, 1, 2, 3), listItem);
+			if(listItem.size() != 2)
+				TERROR;
+		}
+		TAST(kdt.erase(__Vec3Type(1, 2, 3), 11));
+		if(kdt.erase(__Vec3Type(1, 2, 3), 11))
+			TERROR;
+		const GAIA::NUM* pFinded = kdt.find(__Vec3Type(1, 2, 3));
+		if(pFinded == GNIL || *pFinded != 10 || kdt.size() != 2)
+			TERROR;
+		__KDTree3Type kdtCopy = kdt;
+		if(kdtCopy.size() != 2 || kdtCopy.find(__Vec3Type(-1, 0, 0)) == GNIL)
+			TERROR;
+		kdt.clear();
+		TAST(kdt.empty());
+
+		/* Bulk build, pending insert and erase, compared with the brute force. */
+		{
+			static const GAIA::NUM SAMPLE_COUNT = 5000;
+			GAIA::MATH::RandomLCG lcg;
+			__KDTree2Type kdt2;
+			GAIA::CTN::Vector<__Vec2Type> listPos;
+			GAIA::CTN::Vector<GAIA::BL> listErased;
+			for(GAIA::NUM x = 0; x < SAMPLE_COUNT; ++x)
+			{
+				__Vec2Type pos(lcg.random_u32() % 1000, x < SAMPLE_COUNT / 2 ? lcg.random_u32() % 1000 : lcg.random_u32() % 10);
+				listPos.push_back(pos);
+				listErased.push_back(GAIA::False);
+				kdt2.insert(pos, x);
+			}
+			kdt2.build();
+			TAST(t_ctn_kdtree_check(kdt2, listPos, listErased, lcg));
+			for(GAIA::NUM x = 0; x < 100; ++x)
+			{
+				__Vec2Type pos(lcg.random_u32() % 1000, lcg.random_u32() % 1000);
+				listPos.push_back(pos);
+				listErased.push_back(GAIA::False);
+				kdt2.insert(pos, listPos.size() - 1);
+			}
+			TAST(t_ctn_kdtree_check(kdt2, listPos, listErased, lcg));
+			for(GAIA::NUM x = 0; x < listPos.size(); x += 3)
+			{
+				if(!kdt2.erase(listPos[x], x))
+				{
+					TERROR;
+					break;
+				}
+				listErased[x] = GAIA::True;
+			}
+			GAIA::NUM sLive = 0;
+			for(GAIA::NUM x = 0; x < listErased.size(); ++x)
+			{
+				if(!listErased[x])
+					++sLive;
+			}
+			if(kdt2.size() != sLive)
+				TERROR;
+			TAST(t_ctn_kdtree_check(kdt2, listPos, listErased, lcg));
+
+			GAIA::CTN::BasicVector<const __KDTree2Type::Item*, GAIA::NUM, GAIA::ALGO::ExtendGold<GAIA::NUM> > listItem;
+			GAIA::MATH::AABR<GAIA::N32> box(100, 2, 400, 600);
+			kdt2.range(box, listItem);
+			GAIA::NUM sExpect = 0;
+			for(GAIA::NUM x = 0; x < listPos.size(); ++x)
+			{
+				if(!listErased[x] && listPos[x].x >= 100 && listPos[x].x <= 400 && listPos[x].y >= 2 && listPos[x].y <= 600)
+					++sExpect;
+			}
+			if(listItem.size() != sExpect)
+				TERROR;
+			for(GAIA::NUM x = 0; x < listItem.size(); ++x)
+			{
+				const __Vec2Type& pos = listItem[x]->pos;
+				if(listErased[listItem[x]->t] || pos.x < 100 || pos.x > 400 || pos.y < 2 || pos.y > 600)
+				{
+					TERROR;
+					break;
+				}
+			}
+
+			// Batch query in the thread pool.
+			GAIA::CTN::Vector<__Vec2Type> listQuery;
+			for(GAIA::NUM x = 0; x < 1000; ++x)
+				listQuery.push_back(__Vec2Type(lcg.random_u32() % 1000, lcg.random_u32() % 1000));
+			GAIA::THREAD::ThreadPool tp;
+			tp.SetThreadCount(4);
+			TAST(tp.Begin());
+			__KDTree2Type::__NeighborListType listResult;
+			kdt2.nearest(tp, listQuery.fptr(), listQuery.size(), 5, listResult);
+			TAST(tp.End());
+			if(listResult.size() != listQuery.size() * 5)
+				TERROR;
+			__KDTree2Type::__NeighborListType single;
+			for(GAIA::NUM x = 0; x < listQuery.size(); ++x)
+			{
+				kdt2.nearest(listQuery[x], 5, single);
+				for(GAIA::NUM y = 0; y < 5; ++y)
+				{
+					if(listResult[x * 5 + y].pItem == GNIL || listResult[x * 5 + y].distsq != single[y].distsq)
+					{
+						TERROR;
+						break;
+					}
+				}
+			}
+		}
+	}
+}
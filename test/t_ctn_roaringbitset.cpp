@@ -0,0 +1,161 @@
+#include "preheader.h"
+#include "t_common.h"
+
+namespace TEST
+{
+	typedef GAIA::CTN::BasicBitset<GAIA::N64, GAIA::ALGO::ExtendGold<GAIA::N64> > __RoaringRefType;
+
+	GINL GAIA::BL t_ctn_roaringbitset_check(const GAIA::CTN::RoaringBitset& rb, const __RoaringRefType& ref)
+	{
+		if(rb.size() != ref.count())
+			return GAIA::False;
+		GAIA::U32 v = 0;
+		GAIA::N64 index = ref.findnext(0);
+		GAIA::N64 rank = 0;
+		while(rb.findnext(v, v))
+		{
+			if(index != v || rb.rank(v) != rank)
+				return GAIA::False;
+			GAIA::U32 s;
+			if(!rb.select(rank, s) || s != v)
+				return GAIA::False;
+			++rank;
+			index = index + 1 < ref.size() ? ref.findnext(index + 1) : GINVALID;
+			if(v == 0xFFFFFFFF)
+				break;
+			++v;
+		}
+		return index == GINVALID && rank == rb.size();
+	}
+
+	GINL GAIA::GVOID t_ctn_roaringbitset_fill(GAIA::CTN::RoaringBitset& rb, __RoaringRefType& ref, GAIA::MATH::RandomLCG& lcg, const GAIA::NUM* pCounts)
+	{
+		for(GAIA::NUM x = 0; x < 4; ++x)
+		{
+			for(GAIA::NUM y = 0; y < pCounts[x]; ++y)
+			{
+				GAIA::U32 v = (GAIA::U32)(x * 65536 + lcg.random_u32() % 65536);
+				if(rb.insert(v) == ref.exist(v))
+					return;
+				ref.set(v);
+			}
+		}
+	}
+
+	extern GAIA::GVOID t_ctn_roaringbitset(GAIA::LOG::Log& logobj)
+	{
+		typedef GAIA::CTN::RoaringBitset __RoaringType;
+		__RoaringType rb;
+		TAST(rb.empty());
+		if(rb.exist(0) || rb.erase(0))
+			TERROR;
+		GAIA::U32 v;
+		if(rb.findnext(0, v) || rb.select(0, v) || rb.rank(100) != 0)
+			TERROR;
+		TAST(rb.insert(0xFFFFFFFF));
+		TAST(rb.insert(0));
+		TAST(rb.insert(65536));
+		if(rb.insert(65536))
+			TERROR;
+		if(rb.size() != 3)
+			TERROR;
+		TAST(rb.exist(0xFFFFFFFF) && rb.exist(0) && rb.exist(65536));
+		if(rb.exist(1) || rb.exist(65537))
+			TERROR;
+		if(!rb.findnext(1, v) || v != 65536)
+			TERROR;
+		if(!rb.findnext(65537, v) || v != 0xFFFFFFFF)
+			TERROR;
+		if(rb.rank(0xFFFFFFFF) != 2)
+			TERROR;
+		if(!rb.select(2, v) || v != 0xFFFFFFFF)
+			TERROR;
+		TAST(rb.erase(65536));
+		if(rb.erase(65536))
+			TERROR;
+		if(rb.size() != 2 || rb.exist(65536))
+			TERROR;
+		rb.clear();
+		TAST(rb.empty());
+
+		/* Array containers, bitmap containers and the conversion between them. */
+		{
+			__RoaringType rbDense;
+			for(GAIA::U32 x = 0; x < 10000; ++x)
+				TAST(rbDense.insert(x * 2));
+			if(rbDense.size() != 10000)
+				TERROR;
+			for(GAIA::U32 x = 0; x < 20000; ++x)
+			{
+				if(rbDense.exist(x) != (x % 2 == 0))
+				{
+					TERROR;
+					break;
+				}
+			}
+			for(GAIA::U32 x = 0; x < 10000; x += 2)
+				TAST(rbDense.erase(x * 2));
+			if(rbDense.size() != 5000)
+				TERROR;
+			for(GAIA::U32 x = 0; x < 20000; ++x)
+			{
+				if(rbDense.exist(x) != (x % 4 == 2))
+				{
+					TERROR;
+					break;
+				}
+			}
+			if(rbDense.rank(10) != 2)
+				TERROR;
+			__RoaringType rbCopy = rbDense;
+			TAST(rbCopy == rbDense);
+			TAST(rbCopy.erase(2));
+			TAST(rbCopy != rbDense);
+		}
+
+		/* Combination of the containers. */
+		{
+			static const GAIA::NUM COUNTS[][4] =
+			{
+				{100, 30000, 4000, 0},
+				{3000, 20, 5000, 50000},
+				{0, 0, 2000, 2500},
+			};
+			GAIA::MATH::RandomLCG lcg;
+			for(GAIA::NUM x = 0; x < sizeofarray(COUNTS); ++x)
+			{
+				for(GAIA::NUM y = 0; y < sizeofarray(COUNTS); ++y)
+				{
+					__RoaringType rb1, rb2;
+					__RoaringRefType ref1, ref2;
+					ref1.resize(4 * 65536);
+					ref2.resize(4 * 65536);
+					t_ctn_roaringbitset_fill(rb1, ref1, lcg, COUNTS[x]);
+					t_ctn_roaringbitset_fill(rb2, ref2, lcg, COUNTS[y]);
+					TAST(t_ctn_roaringbitset_check(rb1, ref1));
+					TAST(t_ctn_roaringbitset_check(rb2, ref2));
+
+					__RoaringType rbOr = rb1, rbAnd = rb1, rbXor = rb1, rbAndNot = rb1;
+					rbOr |= rb2;
+					rbAnd &= rb2;
+					rbXor ^= rb2;
+					rbAndNot -= rb2;
+					__RoaringRefType refOr = ref1, refAnd = ref1, refXor = ref1, refAndNot = ref1;
+					refOr |= ref2;
+					refAnd &= ref2;
+					refXor ^= ref2;
+					refAndNot &= ~ref2;
+					TAST(t_ctn_roaringbitset_check(rbOr, refOr));
+					TAST(t_ctn_roaringbitset_check(rbAnd, refAnd));
+					TAST(t_ctn_roaringbitset_check(rbXor, refXor));
+					TAST(t_ctn_roaringbitset_check(rbAndNot, refAndNot));
+
+					rbXor ^= rb2;
+					TAST(rbXor == rb1);
+					rbAndNot |= rbAnd;
+					TAST(rbAndNot == rb1);
+				}
+			}
+		}
+	}
+}
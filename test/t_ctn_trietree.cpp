@@ -369,5 +369,87 @@ namespace TEST
 			++it;
 			++cit;
 		}
+
+		/* Adaptive children layout, the one byte keys go through all layouts. */
+		{
+			typedef GAIA::CTN::BasicTrieTree<GAIA::N8, GAIA::NUM, GAIA::ALGO::ExtendGold<GAIA::NUM> > __ByteTrieType;
+			typedef GAIA::CTN::BasicTrieTree<GAIA::U16, GAIA::NUM, GAIA::ALGO::ExtendGold<GAIA::NUM> > __WordTrieType;
+			__ByteTrieType bt;
+			__WordTrieType wt;
+			for(GAIA::NUM x = 0; x < 256; ++x)
+			{
+				GAIA::N8 key[2] = {(GAIA::N8)(x * 7), (GAIA::N8)x};
+				bt.insert(key, 2);
+				GAIA::U16 wkey[2] = {(GAIA::U16)(x * 263), (GAIA::U16)x};
+				wt.insert(wkey, 2);
+				for(GAIA::NUM y = 0; y <= x; ++y)
+				{
+					GAIA::N8 k[2] = {(GAIA::N8)(y * 7), (GAIA::N8)y};
+					GAIA::U16 wk[2] = {(GAIA::U16)(y * 263), (GAIA::U16)y};
+					if(!bt.exist(k, 2) || !wt.exist(wk, 2))
+					{
+						TERROR;
+						break;
+					}
+				}
+				GAIA::N8 kn = (GAIA::N8)((x + 1) * 7);
+				if(x < 255 && bt.exist(&kn, 1))
+					TERROR;
+			}
+			if(bt.catagory_count(bt.root()) != 256 || bt.full_count(bt.root()) != 256)
+				TERROR;
+			__ByteTrieType::const_it bcit = bt.const_frontit();
+			GAIA::N8 prev = 0;
+			GAIA::NUM sCount = 0;
+			for(; !bcit.empty(); ++bcit)
+			{
+				if(bt.root(bt.parent_it(bcit)))
+				{
+					if(sCount > 0 && !(prev < *bcit))
+					{
+						TERROR;
+						break;
+					}
+					prev = *bcit;
+				}
+				++sCount;
+			}
+			if(sCount != 512)
+				TERROR;
+			__ByteTrieType bt1 = bt;
+			TAST(bt1 == bt);
+			for(GAIA::NUM x = 255; x >= 0; --x)
+			{
+				GAIA::N8 key[2] = {(GAIA::N8)(x * 7), (GAIA::N8)x};
+				TAST(bt.erase(key, 2));
+				TAST(!bt.exist(key, 2));
+				GAIA::N8 k0[2] = {0, 0};
+				if(x > 0 && !bt.exist(k0, 2))
+				{
+					TERROR;
+					break;
+				}
+				if(bt.size() != (__ByteTrieType::_sizetype)x * 2)
+				{
+					TERROR;
+					break;
+				}
+			}
+			TAST(bt.empty());
+			for(GAIA::NUM x = 0; x < 256; ++x)
+			{
+				GAIA::N8 key[2] = {(GAIA::N8)(x * 7), (GAIA::N8)x};
+				if(!bt1.exist(key, 2))
+				{
+					TERROR;
+					break;
+				}
+				if(bt1.count(*bt1.find(GNIL, key, 2)) != 1)
+				{
+					TERROR;
+					break;
+				}
+			}
+		}
 	}
 }
@@ -3,13 +3,42 @@
 
 namespace TEST
 {
+	static const GAIA::NUM PERF_THREAD_COUNT = 4;
+	static const GAIA::NUM PERF_RECORD_COUNT = 10000;
+
 	class PerfCallBack : public GAIA::DBG::PerfCollector::CallBack
 	{
 	public:
+		PerfCallBack(){uCombinedCount = 0; sHistogramCount = 0;}
 		virtual GAIA::BL OnCollect(const GAIA::CH* pszItemName, GAIA::UM uThreadID, const GAIA::U64& uTotalTime, const GAIA::U64& uMinTime, const GAIA::U64& uMaxTime, const GAIA::U64& uTotalCount)
 		{
+			if(uThreadID == GINVALID && GAIA::ALGO::gstrequal(pszItemName, "TestItem"))
+				uCombinedCount = uTotalCount;
+			return GAIA::True;
+		}
+		virtual GAIA::BL OnCollectHistogram(const GAIA::CH* pszItemName, GAIA::UM uThreadID, const GAIA::DBG::PerfCollector::Histogram& histogram)
+		{
+			++sHistogramCount;
 			return GAIA::True;
 		}
+	public:
+		GAIA::U64 uCombinedCount;
+		GAIA::NUM sHistogramCount;
+	};
+
+	class PerfThread : public GAIA::THREAD::Thread
+	{
+	public:
+		PerfThread(){m_pPerf = GNIL; m_sItem = GINVALID;}
+		GAIA::GVOID SetPerf(GAIA::DBG::PerfCollector* pPerf, GAIA::NUM sItem){m_pPerf = pPerf; m_sItem = sItem;}
+		virtual GAIA::GVOID Run()
+		{
+			for(GAIA::NUM x = 0; x < PERF_RECORD_COUNT; ++x)
+				m_pPerf->Record(m_sItem, x % 1000 + 1);
+		}
+	private:
+		GAIA::DBG::PerfCollector* m_pPerf;
+		GAIA::NUM m_sItem;
 	};
 
 	extern GAIA::GVOID t_dbg_perfcollector(GAIA::LOG::Log& logobj)
@@ -30,5 +59,83 @@ namespace TEST
 		TAST(listResult.front() != GNIL);
 		TAST(GAIA::ALGO::gstrequal(listResult.front(), "TestPerf"));
 		perf.Reset();
+
+		// Histogram.
+		{
+			for(GAIA::U64 x = 0; x < 100000; x = x * 2 + 1)
+			{
+				GAIA::NUM sIndex = GAIA::DBG::PerfCollector::Histogram::index(x);
+				TAST(sIndex >= 0 && sIndex < GAIA::DBG::PerfCollector::HISTOGRAM_SIZE);
+				GAIA::U64 uUpper = GAIA::DBG::PerfCollector::Histogram::upper(sIndex);
+				TAST(uUpper >= x);
+				TAST(uUpper - x <= x / GAIA::DBG::PerfCollector::HISTOGRAM_SUB_COUNT);
+				if(sIndex > 0)
+					TAST(GAIA::DBG::PerfCollector::Histogram::upper(sIndex - 1) < x);
+			}
+			TAST(GAIA::DBG::PerfCollector::Histogram::index(GAIA::U64MAX) == GAIA::DBG::PerfCollector::HISTOGRAM_SIZE - 1);
+		}
+
+		// Registered items.
+		{
+			GAIA::U64 uTick = GAIA::DBG::PerfCollector::tick();
+			TAST(GAIA::DBG::PerfCollector::tick() >= uTick);
+
+			GAIA::NUM sItem = perf.RegisterItem("TestItem");
+			TAST(sItem != GINVALID);
+			TAST(perf.RegisterItem("TestItem") == sItem);
+			TAST(perf.FindItem("TestItem") == sItem);
+			TAST(perf.FindItem("NotExist") == GINVALID);
+			TAST(GAIA::ALGO::gstrequal(perf.GetItemName(sItem), "TestItem"));
+
+			GAIA::NUM sBeginItem = perf.RegisterItem("TestBeginItem");
+			TAST(sBeginItem != sItem);
+			TAST(!perf.EndItem(sBeginItem));
+			perf.BeginItem(sBeginItem);
+			TAST(perf.IsBeginItem(sBeginItem));
+			TAST(perf.EndItem(sBeginItem));
+			TAST(!perf.IsBeginItem(sBeginItem));
+			TAST(perf.Get("TestBeginItem", GNIL, GNIL, GNIL, &uTotalCount));
+			TAST(uTotalCount == 1);
+
+			PerfThread threads[PERF_THREAD_COUNT];
+			for(GAIA::NUM x = 0; x < PERF_THREAD_COUNT; ++x)
+			{
+				threads[x].SetPerf(&perf, sItem);
+				TAST(threads[x].Start());
+			}
+			for(GAIA::NUM x = 0; x < PERF_THREAD_COUNT; ++x)
+				TAST(threads[x].Wait());
+
+			TAST(perf.Get("TestItem", &uTotalTime, &uMinTime, &uMaxTime, &uTotalCount));
+			TAST(uTotalCount == PERF_THREAD_COUNT * PERF_RECORD_COUNT);
+			TAST(uTotalTime == (GAIA::U64)PERF_THREAD_COUNT * PERF_RECORD_COUNT / 1000 * 500500);
+			TAST(uMinTime == 1);
+			TAST(uMaxTime == 1000);
+			TAST(!perf.GetOnThread("TestItem", GNIL, GNIL, GNIL, &uTotalCount) || uTotalCount == 0);
+
+			GAIA::DBG::PerfCollector::Histogram histogram;
+			perf.GetHistogram(sItem, histogram);
+			TAST(histogram.count() == PERF_THREAD_COUNT * PERF_RECORD_COUNT);
+			GAIA::U64 uP50 = histogram.percentile(0.5);
+			GAIA::U64 uP99 = histogram.percentile(0.99);
+			GAIA::U64 uP999 = histogram.percentile(0.999);
+			TAST(uP50 >= 500 && uP50 <= 500 + 500 / GAIA::DBG::PerfCollector::HISTOGRAM_SUB_COUNT);
+			TAST(uP99 >= 990 && uP99 <= 990 + 990 / GAIA::DBG::PerfCollector::HISTOGRAM_SUB_COUNT);
+			TAST(uP999 >= 999 && uP999 <= 999 + 999 / GAIA::DBG::PerfCollector::HISTOGRAM_SUB_COUNT);
+			TAST(uP50 <= uP99 && uP99 <= uP999);
+
+			listResult.clear();
+			perf.Collect(listResult);
+			TAST(listResult.size() == 2);
+			PerfCallBack itemcb;
+			TAST(perf.Collect(itemcb));
+			TAST(itemcb.uCombinedCount == PERF_THREAD_COUNT * PERF_RECORD_COUNT);
+			TAST(itemcb.sHistogramCount == PERF_THREAD_COUNT + 1 + 2);
+
+			perf.Reset();
+			TAST(perf.FindItem("TestItem") == sItem);
+			TAST(perf.Get("TestItem", GNIL, GNIL, GNIL, &uTotalCount));
+			TAST(uTotalCount == 0);
+		}
 	}
 }
@@ -38,6 +38,8 @@ namespace TEST
 	extern GAIA::GVOID t_algo_base(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_algo_compare(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_algo_sort(GAIA::LOG::Log& logobj);
+	extern GAIA::GVOID t_algo_extsort(GAIA::LOG::Log& logobj);
+	extern GAIA::GVOID t_algo_suffix(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_algo_search(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_algo_replace(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_algo_unique(GAIA::LOG::Log& logobj);
@@ -72,17 +74,23 @@ namespace TEST
 	extern GAIA::GVOID t_ctn_charsstring(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_ctn_stackbitset(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_ctn_bitset(GAIA::LOG::Log& logobj);
+	extern GAIA::GVOID t_ctn_roaringbitset(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_ctn_trietree(GAIA::LOG::Log& logobj);
+	extern GAIA::GVOID t_ctn_doublearraytrie(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_ctn_avltree(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_ctn_set(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_ctn_map(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_ctn_hashset(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_ctn_hashmap(GAIA::LOG::Log& logobj);
+	extern GAIA::GVOID t_ctn_flathashset(GAIA::LOG::Log& logobj);
+	extern GAIA::GVOID t_ctn_flathashmap(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_ctn_tree(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_ctn_orderless(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_ctn_book(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_ctn_graph(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_ctn_dmpgraph(GAIA::LOG::Log& logobj);
+	extern GAIA::GVOID t_ctn_fmindex(GAIA::LOG::Log& logobj);
+	extern GAIA::GVOID t_ctn_kdtree(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_ctn_pool(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_ctn_storage(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_ctn_secset(GAIA::LOG::Log& logobj);
@@ -102,6 +110,8 @@ namespace TEST
 
 	extern GAIA::GVOID t_dbg_perfcollector(GAIA::LOG::Log& logobj);
 
+	extern GAIA::GVOID t_msys_heapesg(GAIA::LOG::Log& logobj);
+
 	extern GAIA::GVOID t_sync_atomic(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_sync_event(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_sync_lock(GAIA::LOG::Log& logobj);
@@ -125,8 +135,10 @@ namespace TEST
 	extern GAIA::GVOID t_network_base(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_network_socket(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_network_sudpsocket(GAIA::LOG::Log& logobj);
+	extern GAIA::GVOID t_network_congestion(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_network_asyncsocket(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_network_httpbase(GAIA::LOG::Log& logobj);
+	extern GAIA::GVOID t_network_httpparser(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_network_httpserver(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID t_network_http(GAIA::LOG::Log& logobj);
 
@@ -194,6 +206,8 @@ namespace TEST
 			TITEM("Algorithm: Base test begin!"); t_algo_base(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Algorithm: Compare test begin!"); t_algo_compare(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Algorithm: Sort test begin!"); t_algo_sort(logobj); TITEM("End"); TTEXT("\t");
+			TITEM("Algorithm: ExtSort test begin!"); t_algo_extsort(logobj); TITEM("End"); TTEXT("\t");
+			TITEM("Algorithm: Suffix test begin!"); t_algo_suffix(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Algorithm: Search test begin!"); t_algo_search(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Algorithm: Replace test begin!"); t_algo_replace(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Algorithm: Unique test begin!"); t_algo_unique(logobj); TITEM("End"); TTEXT("\t");
@@ -228,18 +242,24 @@ namespace TEST
 			TITEM("Container: CharsString test begin!"); t_ctn_charsstring(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Container: StackBitset test begin!"); t_ctn_stackbitset(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Container: Bitset test begin!"); t_ctn_bitset(logobj); TITEM("End"); TTEXT("\t");
+			TITEM("Container: RoaringBitset test begin!"); t_ctn_roaringbitset(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Container: TrieTree test begin!"); t_ctn_trietree(logobj); TITEM("End"); TTEXT("\t");
+			TITEM("Container: DoubleArrayTrie test begin!"); t_ctn_doublearraytrie(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Container: AVLTree test begin!"); t_ctn_avltree(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Container: Set test begin!"); t_ctn_set(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Container: Map test begin!"); t_ctn_map(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Container: HashSet test begin!"); t_ctn_hashset(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Container: HashMap test begin!"); t_ctn_hashmap(logobj); TITEM("End"); TTEXT("\t");
+			TITEM("Container: FlatHashSet test begin!"); t_ctn_flathashset(logobj); TITEM("End"); TTEXT("\t");
+			TITEM("Container: FlatHashMap test begin!"); t_ctn_flathashmap(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Container: Tree test begin!"); t_ctn_tree(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Container: Orderless test begin!"); t_ctn_orderless(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Container: Book test begin!"); t_ctn_book(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Container: Pool test begin!"); t_ctn_pool(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Container: Graph test begin!"); t_ctn_graph(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Container: DMPGraph test begin!"); t_ctn_dmpgraph(logobj); TITEM("End"); TTEXT("\t");
+			TITEM("Container: FMIndex test begin!"); t_ctn_fmindex(logobj); TITEM("End"); TTEXT("\t");
+			TITEM("Container: KDTree test begin!"); t_ctn_kdtree(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Container: Storage test begin!"); t_ctn_storage(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Container: Secset test begin!"); t_ctn_secset(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Container: Accesser test begin!"); t_ctn_accesser(logobj); TITEM("End"); TTEXT("\t");
@@ -258,6 +278,8 @@ namespace TEST
 
 			TITEM("Dbg: PerfCollector test begin!"); t_dbg_perfcollector(logobj); TITEM("End"); TTEXT("\t");
 
+			TITEM("MSys: HeapESG test begin!"); t_msys_heapesg(logobj); TITEM("End"); TTEXT("\t");
+
 			TITEM("Sync: Atomic test begin!"); t_sync_atomic(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Sync: Event test begin!"); t_sync_event(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Sync: Lock test begin!"); t_sync_lock(logobj); TITEM("End"); TTEXT("\t");
@@ -279,8 +301,10 @@ namespace TEST
 			TITEM("Network: Network base test begin!"); t_network_base(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Network: Network socket test begin!"); t_network_socket(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Network: Network sudpsocket test begin!"); t_network_sudpsocket(logobj); TITEM("End"); TTEXT("\t");
+			TITEM("Network: Network congestion test begin!"); t_network_congestion(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Network: Network async socket test begin!"); t_network_asyncsocket(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Network: Network http base test begin!"); t_network_httpbase(logobj); TITEM("End"); TTEXT("\t");
+			TITEM("Network: Network http parser test begin!"); t_network_httpparser(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Network: Network http server test begin!"); t_network_httpserver(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Network: Network http test begin!"); t_network_http(logobj); TITEM("End"); TTEXT("\t");
 
@@ -312,6 +336,9 @@ namespace TEST
 	}
 
 	// GAIA performance test proc.
+	extern GAIA::GVOID tperf_algo_hash(GAIA::LOG::Log& logobj);
+	extern GAIA::GVOID tperf_algo_memory(GAIA::LOG::Log& logobj);
+	extern GAIA::GVOID tperf_algo_string(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID tperf_ctn(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID tperf_ctn_avltree(GAIA::LOG::Log& logobj);
 	extern GAIA::GVOID tperf_ctn_dmpgraph(GAIA::LOG::Log& logobj);
@@ -324,6 +351,9 @@ namespace TEST
 		// Every test procedure.
 		TTEXT("[GAIA PERF TEST BEGIN]");
 		{
+			TITEM("Algorithm: Hash perf test begin!"); tperf_algo_hash(logobj); TITEM("End"); TTEXT("\t");
+			TITEM("Algorithm: Memory perf test begin!"); tperf_algo_memory(logobj); TITEM("End"); TTEXT("\t");
+			TITEM("Algorithm: String perf test begin!"); tperf_algo_string(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Container: Ctn perf test begin!"); tperf_ctn(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Container: AVLTree perf test begin!"); tperf_ctn_avltree(logobj); TITEM("End"); TTEXT("\t");
 			TITEM("Container: DmpGraph perf test begin!"); tperf_ctn_dmpgraph(logobj); TITEM("End"); TTEXT("\t");
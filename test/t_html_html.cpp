@@ -3,6 +3,262 @@
 
 namespace TEST
 {
+	static GAIA::BL IsSlice(const GAIA::U8* p, GAIA::NUM sLen, const GAIA::CH* psz)
+	{
+		if(psz == GNIL)
+			return p == GNIL;
+		if(p == GNIL || sLen != GAIA::ALGO::gstrlen(psz))
+			return GAIA::False;
+		for(GAIA::NUM x = 0; x < sLen; ++x)
+		{
+			if(p[x] != (GAIA::U8)psz[x])
+				return GAIA::False;
+		}
+		return GAIA::True;
+	}
+	static GAIA::BL WriteTestFile(const GAIA::TCH* pszFileName, const GAIA::GVOID* p, GAIA::NUM sSize)
+	{
+		GAIA::FSYS::File f;
+		if(!f.Open(pszFileName, GAIA::FSYS::File::OPEN_TYPE_CREATEALWAYS | GAIA::FSYS::File::OPEN_TYPE_WRITE))
+			return GAIA::False;
+		return f.Write(p, sSize) == sSize;
+	}
+	static GAIA::GVOID ReadHTMLNode(GAIA::HTML::HTML& html, GAIA::HTML::HTML::Cursor& cur, GAIA::NUM& sNodeCount, GAIA::NUM& sNameCount, GAIA::NUM& sCommentCount)
+	{
+		for(;;)
+		{
+			const GAIA::TCH* pszName = html.BeginReadNode(cur);
+			if(pszName == GNIL)
+				break;
+			switch(cur.GetReadType())
+			{
+			case GAIA::HTML::HTML_NODE_CONTAINER:
+			case GAIA::HTML::HTML_NODE_MULTICONTAINER:
+				++sNodeCount;
+				ReadHTMLNode(html, cur, sNodeCount, sNameCount, sCommentCount);
+				break;
+			case GAIA::HTML::HTML_NODE_NAME:
+				{
+					++sNameCount;
+					const GAIA::TCH* pszValue = html.BeginReadNode(cur);
+					if(pszValue == GNIL || cur.GetReadType() != GAIA::HTML::HTML_NODE_VALUE)
+						sNameCount = GINVALID;
+					else
+						html.EndReadNode(cur);
+				}
+				break;
+			case GAIA::HTML::HTML_NODE_COMMENT:
+				++sCommentCount;
+				break;
+			default:
+				break;
+			}
+			html.EndReadNode(cur);
+		}
+	}
+	static GAIA::GVOID ReadHTML(GAIA::LOG::Log& logobj, GAIA::HTML::HTML& html, const GAIA::TCH* pszFileName)
+	{
+		GAIA::HTML::HTMLReader reader;
+		if(!reader.OpenFile(pszFileName, 256))
+			TERROR;
+		GAIA::HTML::HTML::Cursor cur;
+		cur.BindReader(&reader);
+		GAIA::NUM sNodeCount = 0, sNameCount = 0, sCommentCount = 0;
+		ReadHTMLNode(html, cur, sNodeCount, sNameCount, sCommentCount);
+		if(sNodeCount != 40 || sNameCount != 120 || sCommentCount != 40)
+			TERROR;
+		if(reader.GetEvent() != GAIA::HTML::HTML_EVENT_END)
+			TERROR;
+
+		if(!reader.OpenFile(pszFileName))
+			TERROR;
+		cur.BindReader(&reader);
+		const GAIA::TCH* pszName = html.BeginReadNode(cur);
+		if(pszName == GNIL || GAIA::ALGO::gstrcmp(pszName, _T("Root")) != 0)
+			TERROR;
+		pszName = html.BeginReadNode(cur);
+		if(pszName == GNIL || GAIA::ALGO::gstrcmp(pszName, _T("Name0")) != 0)
+			TERROR;
+		pszName = html.ReadNode(cur);
+		if(pszName == GNIL || GAIA::ALGO::gstrcmp(pszName, _T("Value0")) != 0)
+			TERROR;
+		if(html.BeginReadNode(cur) != GNIL)
+			TERROR;
+		html.EndReadNode(cur);
+		GAIA::NUM sChildCount = 1;
+		while(html.ReadNode(cur) != GNIL)
+			++sChildCount;
+		if(sChildCount != 7)
+			TERROR;
+		if(!html.EndReadNode(cur))
+			TERROR;
+		if(html.BeginReadNode(cur) != GNIL)
+			TERROR;
+	}
+	class HTMLEventCheck
+	{
+	public:
+		GAIA::HTML::HTML_EVENT e;
+		const GAIA::CH* pszName;
+		const GAIA::CH* pszValue;
+		GAIA::NUM sDepth;
+	};
+	static GAIA::GVOID CheckHTMLEvents(GAIA::LOG::Log& logobj, GAIA::HTML::HTMLReader& reader, const HTMLEventCheck* pChecks, GAIA::NUM sCount)
+	{
+		for(GAIA::NUM x = 0; x < sCount; ++x)
+		{
+			const HTMLEventCheck& c = pChecks[x];
+			if(reader.Read() != c.e)
+			{
+				TERROR;
+				break;
+			}
+			const GAIA::U8* p;
+			GAIA::NUM sLen;
+			p = reader.GetName(sLen);
+			if(!IsSlice(p, sLen, c.pszName))
+				TERROR;
+			p = reader.GetValue(sLen);
+			if(!IsSlice(p, sLen, c.pszValue))
+				TERROR;
+			if(reader.GetDepth() != c.sDepth)
+				TERROR;
+		}
+		if(reader.Read() != GAIA::HTML::HTML_EVENT_END)
+			TERROR;
+	}
+	static GAIA::GVOID ReadHTMLEvents(GAIA::LOG::Log& logobj)
+	{
+		static const GAIA::CH HTML_SOURCE[] =
+			"<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+			"<!DOCTYPE note>\n"
+			"<Root a=\"1\" b = 'x>y'>\n"
+			"\t<!--comment content-->\n"
+			"\t<Node1/>\n"
+			"\t<Node2 c=\"\"></Node2 >\n"
+			"\t<Node3>\n\t\tabc def\n\t</Node3>\n"
+			"\t<Node4><![CDATA[<raw>]]></Node4>\n"
+			"</Root>\n";
+		static const HTMLEventCheck HTML_EVENTS[] =
+		{
+			{GAIA::HTML::HTML_EVENT_HEAD, GNIL, "xml version=\"1.0\" encoding=\"utf-8\"", 0},
+			{GAIA::HTML::HTML_EVENT_HEAD, GNIL, "DOCTYPE note", 0},
+			{GAIA::HTML::HTML_EVENT_STARTELEMENT, "Root", GNIL, 0},
+			{GAIA::HTML::HTML_EVENT_ATTRIBUTE, "a", "1", 1},
+			{GAIA::HTML::HTML_EVENT_ATTRIBUTE, "b", "x>y", 1},
+			{GAIA::HTML::HTML_EVENT_COMMENT, GNIL, "comment content", 1},
+			{GAIA::HTML::HTML_EVENT_STARTELEMENT, "Node1", GNIL, 1},
+			{GAIA::HTML::HTML_EVENT_ENDELEMENT, "Node1", GNIL, 1},
+			{GAIA::HTML::HTML_EVENT_STARTELEMENT, "Node2", GNIL, 1},
+			{GAIA::HTML::HTML_EVENT_ATTRIBUTE, "c", "", 2},
+			{GAIA::HTML::HTML_EVENT_ENDELEMENT, "Node2", GNIL, 1},
+			{GAIA::HTML::HTML_EVENT_STARTELEMENT, "Node3", GNIL, 1},
+			{GAIA::HTML::HTML_EVENT_TEXT, GNIL, "abc def", 2},
+			{GAIA::HTML::HTML_EVENT_ENDELEMENT, "Node3", GNIL, 1},
+			{GAIA::HTML::HTML_EVENT_STARTELEMENT, "Node4", GNIL, 1},
+			{GAIA::HTML::HTML_EVENT_TEXT, GNIL, "<raw>", 2},
+			{GAIA::HTML::HTML_EVENT_ENDELEMENT, "Node4", GNIL, 1},
+			{GAIA::HTML::HTML_EVENT_ENDELEMENT, "Root", GNIL, 0},
+		};
+
+		GAIA::HTML::HTMLReader reader;
+		if(!reader.OpenMem(HTML_SOURCE, sizeof(HTML_SOURCE) - 1))
+			TERROR;
+		CheckHTMLEvents(logobj, reader, HTML_EVENTS, sizeofarray(HTML_EVENTS));
+
+		GAIA::TCH szFileName[GAIA::MAXPL];
+		GAIA::ALGO::gstrcpy(szFileName, g_gaia_appdocdir);
+		GAIA::ALGO::gstrcat(szFileName, "test_reader.html");
+		if(!WriteTestFile(szFileName, HTML_SOURCE, sizeof(HTML_SOURCE) - 1))
+			TERROR;
+		if(!reader.OpenFile(szFileName, GAIA::HTML::HTMLReader::MIN_WINDOW_SIZE))
+			TERROR;
+		CheckHTMLEvents(logobj, reader, HTML_EVENTS, sizeofarray(HTML_EVENTS));
+
+		// The text longer than the window.
+		GAIA::CTN::AString strSource = "<Root>";
+		GAIA::CTN::AString strText;
+		for(GAIA::NUM x = 0; x < 300; ++x)
+			strText += "ab\xE4\xB8\xAD";
+		strSource += strText;
+		strSource += "</Root>";
+		if(!WriteTestFile(szFileName, strSource.fptr(), strSource.size()))
+			TERROR;
+		if(!reader.OpenFile(szFileName, GAIA::HTML::HTMLReader::MIN_WINDOW_SIZE))
+			TERROR;
+		if(reader.Read() != GAIA::HTML::HTML_EVENT_STARTELEMENT)
+			TERROR;
+		GAIA::CTN::Vector<GAIA::U8> listReaded;
+		GAIA::NUM sTextCount = 0;
+		while(reader.Read() == GAIA::HTML::HTML_EVENT_TEXT)
+		{
+			GAIA::NUM sLen;
+			const GAIA::U8* p = reader.GetValue(sLen);
+			if(sLen <= 0 || sLen > GAIA::HTML::HTMLReader::MIN_WINDOW_SIZE || (p[0] & 0xC0) == 0x80)
+				TERROR;
+			for(GAIA::NUM y = 0; y < sLen; ++y)
+				listReaded.push_back(p[y]);
+			++sTextCount;
+		}
+		if(reader.GetEvent() != GAIA::HTML::HTML_EVENT_ENDELEMENT)
+			TERROR;
+		if(reader.Read() != GAIA::HTML::HTML_EVENT_END)
+			TERROR;
+		if(sTextCount <= 1 || !IsSlice(listReaded.fptr(), listReaded.size(), strText.fptr()))
+			TERROR;
+
+		// The tag longer than the window.
+		strSource = "<Root a=\"";
+		strSource += strText;
+		strSource += "\"/>";
+		if(!WriteTestFile(szFileName, strSource.fptr(), strSource.size()))
+			TERROR;
+		if(!reader.OpenFile(szFileName, GAIA::HTML::HTMLReader::MIN_WINDOW_SIZE))
+			TERROR;
+		if(reader.Read() != GAIA::HTML::HTML_EVENT_ERROR)
+			TERROR;
+		reader.Close();
+
+		GAIA::FSYS::Dir dir;
+		dir.RemoveFile(szFileName);
+
+		static const GAIA::CH* INVALID_SOURCES[] =
+		{
+			"<Root><A></B></Root>",
+			"<Root>",
+			"</Root>",
+			"<Root a=1/>",
+			"<Root a=\"1\"",
+			"<Root><!--abc</Root>",
+			"<Root/></Root>",
+			"<Root a=\"1\" / >",
+		};
+		for(GAIA::NUM x = 0; x < sizeofarray(INVALID_SOURCES); ++x)
+		{
+			if(!reader.OpenMem(INVALID_SOURCES[x], GAIA::ALGO::gstrlen(INVALID_SOURCES[x])))
+				TERROR;
+			GAIA::HTML::HTML_EVENT e;
+			do
+			{
+				e = reader.Read();
+			}
+			while(e != GAIA::HTML::HTML_EVENT_END && e != GAIA::HTML::HTML_EVENT_ERROR);
+			if(e != GAIA::HTML::HTML_EVENT_ERROR)
+				TERROR;
+		}
+
+		GAIA::HTML::HTML html;
+		static const GAIA::TCH HTML_MEM_SOURCE[] = _T("<Root a=\"1\"><Node/><!--c--></Root>");
+		if(!html.LoadFromMem(HTML_MEM_SOURCE, GAIA::ALGO::gstrlen(HTML_MEM_SOURCE)))
+			TERROR;
+		if(GAIA::ALGO::gstrcmp(html.GetRootNode().GetName(), _T("Root")) != 0)
+			TERROR;
+		if(html.GetRootNode().GetChildCount() != 3)
+			TERROR;
+		static const GAIA::TCH HTML_MEM_INVALID_SOURCE[] = _T("<Root><Node></Root>");
+		if(html.LoadFromMem(HTML_MEM_INVALID_SOURCE, GAIA::ALGO::gstrlen(HTML_MEM_INVALID_SOURCE)))
+			TERROR;
+	}
 	static GAIA::GVOID SaveLoadHTML(GAIA::LOG::Log& logobj, GAIA::HTML::HTML& html)
 	{
 		GAIA::CTN::TChars strTemp, strTemp1, strTemp2;
@@ -112,6 +368,7 @@ namespace TEST
 			TERROR;
 		if(!html.SaveToFile(szFileName, GAIA::HTML::HTML_SAVE_BESTREAD))
 			TERROR;
+		ReadHTML(logobj, html, szFileName);
 		GAIA::FSYS::Dir dir;
 		dir.RemoveFile(szFileName);
 	}
@@ -135,5 +392,7 @@ namespace TEST
 			SaveLoadHTML(logobj, *pHTML);
 		}
 		gdel pHTML;
+
+		ReadHTMLEvents(logobj);
 	}
 }
@@ -110,8 +110,260 @@ namespace TEST
 		GAIA::FSYS::Dir dir;
 		dir.RemoveFile(szFileName);
 	}
+	static GAIA::BL ParseJsonDoc(GAIA::JSON::JsonDoc& doc, const GAIA::CH* psz)
+	{
+		return doc.LoadFromMem(psz, GAIA::ALGO::gstrlen(psz));
+	}
+	static GAIA::GVOID ParseJsonDoc(GAIA::LOG::Log& logobj)
+	{
+		GAIA::JSON::JsonDoc doc;
+
+		/* Values. */
+		{
+			static const GAIA::CH SRC[] =
+				"{\n"
+				"	\"a\":1,\n"
+				"	\"b\":[\n"
+				"		{\"c\":1, \"d\":\"f\"},\n"
+				"		{\"c\":2, \"d\":\"g\"}\n"
+				"	],\n"
+				"	\"h\":[1,2,3,\"4\",{\"k\":5}],\n"
+				"	\"i\":{\"m\":\"n\"},\n"
+				"	\"x\":[],\n"
+				"	\"y\":{},\n"
+				"	\"z\":[true, false, null, -0, -12.5e-1, 1E3, 9223372036854775807, -9223372036854775808, 18446744073709551616],\n"
+				"	\"s\":\"q\\\"\\\\\\/\\b\\f\\n\\r\\t\\u0041\\u00e9\\u4e2d\\ud83d\\ude00\"\n"
+				"}";
+			if(!ParseJsonDoc(doc, SRC))
+				TERROR;
+			GAIA::JSON::JsonDoc::Value root = doc.GetRoot();
+			if(root.GetType() != GAIA::JSON::JsonDoc::VALUE_TYPE_OBJECT)
+				TERROR;
+			if(root.GetChildCount() != 8)
+				TERROR;
+			if(root.GetMember("a").GetInt() != 1)
+				TERROR;
+			GAIA::JSON::JsonDoc::Value b = root.GetMember("b");
+			if(b.GetType() != GAIA::JSON::JsonDoc::VALUE_TYPE_ARRAY || b.GetChildCount() != 2)
+				TERROR;
+			if(b.GetElement(1).GetMember("c").GetInt() != 2)
+				TERROR;
+			if(GAIA::ALGO::gstrcmp(b.GetElement(1).GetMember("d").GetString(), "g") != 0)
+				TERROR;
+			GAIA::JSON::JsonDoc::Value h = root.GetMember("h");
+			if(h.GetChildCount() != 5)
+				TERROR;
+			if(h.GetElement(3).GetType() != GAIA::JSON::JsonDoc::VALUE_TYPE_STRING)
+				TERROR;
+			if(h.GetElement(4).GetMember("k").GetInt() != 5)
+				TERROR;
+			if(!h.GetElement(5).empty())
+				TERROR;
+			if(GAIA::ALGO::gstrcmp(root.GetMember("i").GetMember("m").GetString(), "n") != 0)
+				TERROR;
+			if(root.GetMember("x").GetChildCount() != 0 || !root.GetMember("x").GetFirstChild().empty())
+				TERROR;
+			if(root.GetMember("y").GetType() != GAIA::JSON::JsonDoc::VALUE_TYPE_OBJECT || root.GetMember("y").GetChildCount() != 0)
+				TERROR;
+			if(!root.GetMember("nothing").empty())
+				TERROR;
+
+			GAIA::JSON::JsonDoc::Value z = root.GetMember("z");
+			if(z.GetChildCount() != 9)
+				TERROR;
+			if(z.GetElement(0).GetType() != GAIA::JSON::JsonDoc::VALUE_TYPE_BOOL || !z.GetElement(0).GetBool())
+				TERROR;
+			if(z.GetElement(1).GetType() != GAIA::JSON::JsonDoc::VALUE_TYPE_BOOL || z.GetElement(1).GetBool())
+				TERROR;
+			if(z.GetElement(2).GetType() != GAIA::JSON::JsonDoc::VALUE_TYPE_NULL)
+				TERROR;
+			if(z.GetElement(3).GetType() != GAIA::JSON::JsonDoc::VALUE_TYPE_INT || z.GetElement(3).GetInt() != 0)
+				TERROR;
+			if(z.GetElement(4).GetType() != GAIA::JSON::JsonDoc::VALUE_TYPE_REAL || z.GetElement(4).GetReal() != -1.25)
+				TERROR;
+			if(z.GetElement(5).GetReal() != 1000.0)
+				TERROR;
+			if(z.GetElement(6).GetInt() != GAIA::N64MAX)
+				TERROR;
+			if(z.GetElement(7).GetInt() != GAIA::N64MIN)
+				TERROR;
+			if(z.GetElement(8).GetType() != GAIA::JSON::JsonDoc::VALUE_TYPE_REAL || z.GetElement(8).GetReal() != 18446744073709551616.0)
+				TERROR;
+
+			static const GAIA::CH RESULT[] = "q\"\\/\b\f\n\r\tA\xC3\xA9\xE4\xB8\xAD\xF0\x9F\x98\x80";
+			GAIA::JSON::JsonDoc::Value str = root.GetMember("s");
+			if(str.GetStringLength() != sizeof(RESULT) - 1)
+				TERROR;
+			if(GAIA::ALGO::gstrcmp(str.GetString(), RESULT) != 0)
+				TERROR;
+
+			GAIA::N64 nMemberCount = 0;
+			for(GAIA::JSON::JsonDoc::Value v = root.GetFirstChild(); !v.empty(); v = v.GetNext().GetNext())
+				++nMemberCount;
+			if(nMemberCount != root.GetChildCount())
+				TERROR;
+		}
+
+		/* Scalar root and in situ. */
+		{
+			GAIA::CH szSrc[] = " \"a\\nb\" ";
+			if(!doc.LoadInSitu(szSrc, sizeof(szSrc) - 1))
+				TERROR;
+			if(GAIA::ALGO::gstrcmp(doc.GetRoot().GetString(), "a\nb") != 0)
+				TERROR;
+			if(doc.GetRoot().GetString() != szSrc + 2)
+				TERROR;
+			if(!ParseJsonDoc(doc, "-3.5"))
+				TERROR;
+			if(doc.GetRoot().GetReal() != -3.5)
+				TERROR;
+		}
+
+		/* Invalid json. */
+		{
+			static const GAIA::CH* INVALIDS[] =
+			{
+				" ",
+				"{",
+				"[1,]",
+				"[1 2]",
+				"{\"a\" 1}",
+				"{\"a\":}",
+				"{1:2}",
+				"[\"abc]",
+				"[\"a\\x\"]",
+				"[\"\\ud800\"]",
+				"[tru]",
+				"[truex]",
+				"[01]",
+				"[1.]",
+				"[-]",
+				"[1e]",
+				"[\"a\"\"b\"]",
+				"[1]]",
+				"{}{}",
+				"[\"\t\"]",
+			};
+			for(GAIA::NUM x = 0; x < sizeofarray(INVALIDS); ++x)
+			{
+				if(ParseJsonDoc(doc, INVALIDS[x]))
+					TERROR;
+				if(doc.GetErrorOffset() == GINVALID)
+					TERROR;
+				if(!doc.GetRoot().empty())
+					TERROR;
+			}
+		}
+
+		/* Escapes and strings cross the blocks. */
+		{
+			GAIA::CTN::AString strSrc;
+			strSrc = "[";
+			for(GAIA::NUM x = 0; x < 300; ++x)
+			{
+				if(x != 0)
+					strSrc += ",";
+				strSrc += "\"";
+				for(GAIA::NUM y = 0; y < x; ++y)
+				{
+					if(y % 7 == 0)
+						strSrc += "\\\\";
+					else if(y % 11 == 0)
+						strSrc += "\\\"";
+					else
+						strSrc += "x";
+				}
+				strSrc += "\"";
+			}
+			strSrc += "]";
+			if(!ParseJsonDoc(doc, strSrc.fptr()))
+				TERROR;
+			GAIA::JSON::JsonDoc::Value root = doc.GetRoot();
+			if(root.GetChildCount() != 300)
+				TERROR;
+			GAIA::JSON::JsonDoc::Value v = root.GetFirstChild();
+			for(GAIA::NUM x = 0; x < 300; ++x)
+			{
+				if(v.GetType() != GAIA::JSON::JsonDoc::VALUE_TYPE_STRING)
+				{
+					TERROR;
+					break;
+				}
+				if(v.GetStringLength() != x)
+					TERROR;
+				const GAIA::CH* psz = v.GetString();
+				for(GAIA::NUM y = 0; y < x; ++y)
+				{
+					GAIA::CH ch = (y % 7 == 0) ? '\\' : ((y % 11 == 0) ? '\"' : 'x');
+					if(psz[y] != ch)
+					{
+						TERROR;
+						break;
+					}
+				}
+				v = v.GetNext();
+			}
+			if(!v.empty())
+				TERROR;
+		}
+
+		/* Large file. */
+		{
+			static const GAIA::NUM EVENT_COUNT = 20000;
+			GAIA::TCH szFileName[GAIA::MAXPL];
+			GAIA::ALGO::gstrcpy(szFileName, g_gaia_appdocdir);
+			GAIA::ALGO::gstrcat(szFileName, "test_jsondoc.json");
+			{
+				GAIA::FSYS::File f;
+				if(!f.Open(szFileName, GAIA::FSYS::File::OPEN_TYPE_CREATEALWAYS | GAIA::FSYS::File::OPEN_TYPE_WRITE))
+					TERROR;
+				f.WriteText("[\r\n");
+				GAIA::CTN::AString str;
+				for(GAIA::NUM x = 0; x < EVENT_COUNT; ++x)
+				{
+					str = "\t{\"id\":";
+					str += x;
+					str += ", \"name\":\"event";
+					str += x;
+					str += "\", \"value\":";
+					str += x;
+					str += ".5, \"tags\":[\"a\", \"b\"], \"ok\":true}";
+					if(x != EVENT_COUNT - 1)
+						str += ",";
+					str += "\r\n";
+					f.WriteText(str.fptr());
+				}
+				f.WriteText("]");
+			}
+			if(!doc.LoadFromFile(szFileName))
+				TERROR;
+			GAIA::JSON::JsonDoc::Value root = doc.GetRoot();
+			if(root.GetChildCount() != EVENT_COUNT)
+				TERROR;
+			GAIA::N64 nIDSum = 0;
+			GAIA::F64 fValueSum = 0;
+			GAIA::NUM sIndex = 0;
+			for(GAIA::JSON::JsonDoc::Value v = root.GetFirstChild(); !v.empty(); v = v.GetNext(), ++sIndex)
+			{
+				nIDSum += v.GetMember("id").GetInt();
+				fValueSum += v.GetMember("value").GetReal();
+				if(v.GetMember("tags").GetChildCount() != 2)
+					TERROR;
+				if(sIndex == EVENT_COUNT / 2 && GAIA::ALGO::gstrcmp(v.GetMember("name").GetString(), "event10000") != 0)
+					TERROR;
+			}
+			if(nIDSum != (GAIA::N64)EVENT_COUNT * (EVENT_COUNT - 1) / 2)
+				TERROR;
+			if(fValueSum != (GAIA::F64)EVENT_COUNT * (EVENT_COUNT - 1) / 2 + EVENT_COUNT * 0.5)
+				TERROR;
+			GAIA::FSYS::Dir dir;
+			dir.RemoveFile(szFileName);
+		}
+	}
 	extern GAIA::GVOID t_json_json(GAIA::LOG::Log& logobj)
 	{
+		ParseJsonDoc(logobj);
+
 		GAIA::JSON::JsonFactory fac;
 		GAIA::JSON::JsonFactoryDesc desc;
 		desc.reset();
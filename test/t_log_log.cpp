@@ -3,6 +3,29 @@
 
 namespace TEST
 {
+	static const GAIA::NUM ASYNC_LOG_THREAD_COUNT = 4;
+	static const GAIA::NUM ASYNC_LOG_COUNT = 10000;
+
+	class AsyncLogThread : public GAIA::THREAD::Thread
+	{
+	public:
+		GINL AsyncLogThread(){m_pLog = GNIL; m_sIndex = 0;}
+		GINL GAIA::GVOID SetLog(GAIA::LOG::Log* pLog, GAIA::NUM sIndex){m_pLog = pLog; m_sIndex = sIndex;}
+		virtual GAIA::GVOID Run()
+		{
+			for(GAIA::NUM x = 0; x < ASYNC_LOG_COUNT; ++x)
+			{
+				if(x % 2 == 0)
+					m_pLog->Write(GAIA::LOG::Log::TYPE_LOG, 0x12345678, _T("async log"));
+				else
+					(*m_pLog) << m_pLog->Type(GAIA::LOG::Log::TYPE_WARNING) << "async " << m_sIndex << " " << x << m_pLog->End();
+			}
+		}
+	private:
+		GAIA::LOG::Log* m_pLog;
+		GAIA::NUM m_sIndex;
+	};
+
 	extern GAIA::GVOID t_log_log(GAIA::LOG::Log& logobj)
 	{
 		for(GAIA::NUM x = 0; x < 10; ++x)
@@ -28,5 +51,105 @@ namespace TEST
 				(GAIA::WCH*)L"unicode string" <<
 				g_gaia_log.End();
 		}
+
+		// Async mode.
+		{
+			GAIA::TCH szFileName[GAIA::MAXPL];
+			if(GAIA::ALGO::gstremp(g_gaia_appdocdir))
+				GAIA::ALGO::gstrcpy(szFileName, "../testres/asynclog.txt");
+			else
+			{
+				GAIA::ALGO::gstrcpy(szFileName, g_gaia_appdocdir);
+				GAIA::ALGO::gstrcat(szFileName, "asynclog.txt");
+			}
+
+			GAIA::LOG::Log asynclog;
+			asynclog.SetLineBreak(_T("\n"));
+			if(!asynclog.BeginAsync(szFileName, 1024 * 4))
+				TERROR;
+			if(!asynclog.IsAsync())
+				TERROR;
+			if(asynclog.BeginAsync(szFileName))
+				TERROR;
+
+			// The log is truncated if it is longer than half of the ring.
+			GAIA::CTN::TString strLong;
+			for(GAIA::NUM x = 0; x < 1024 * 8; ++x)
+				strLong += _T("a");
+			if(!asynclog.Write(GAIA::LOG::Log::TYPE_ERROR, 1, strLong.fptr()))
+				TERROR;
+			const GAIA::TCH* pszUnicode = sizeof(GAIA::TCH) == sizeof(GAIA::WCH) ? (const GAIA::TCH*)L"\x4E2D\x6587" : (const GAIA::TCH*)"\xE4\xB8\xAD\xE6\x96\x87";
+			if(!asynclog.Write(GAIA::LOG::Log::TYPE_LOG, 1, pszUnicode))
+				TERROR;
+			asynclog.Flush();
+
+			AsyncLogThread threads[ASYNC_LOG_THREAD_COUNT];
+			for(GAIA::NUM x = 0; x < ASYNC_LOG_THREAD_COUNT; ++x)
+			{
+				threads[x].SetLog(&asynclog, x);
+				if(!threads[x].Start())
+					TERROR;
+			}
+			for(GAIA::NUM x = 0; x < ASYNC_LOG_THREAD_COUNT; ++x)
+			{
+				if(!threads[x].Wait())
+					TERROR;
+			}
+			if(!asynclog.EndAsync())
+				TERROR;
+			if(asynclog.IsAsync())
+				TERROR;
+
+			// Each log is a complete line.
+			GAIA::FSYS::File file;
+			if(!file.Open(szFileName, GAIA::FSYS::File::OPEN_TYPE_READ))
+				TERROR;
+			else
+			{
+				GAIA::NUM sSize = (GAIA::NUM)file.Size();
+				GAIA::CH* pBuf = gnew GAIA::CH[sSize + 1];
+				if(file.Read(pBuf, sSize) != sSize)
+					TERROR;
+				pBuf[sSize] = '\0';
+				file.Close();
+
+				GAIA::NUM sLineCount = 0;
+				GAIA::NUM sWarningCount = 0;
+				GAIA::CH* pLine = pBuf;
+				for(GAIA::CH* p = pBuf; *p != '\0'; ++p)
+				{
+					if(*p != '\n')
+						continue;
+					*p = '\0';
+					if(sLineCount == 0)
+					{
+						if(GAIA::ALGO::gstrstr(pLine, " Err 00000001 aaaa") == GNIL)
+							TERROR;
+						if(p - pLine > 1024 * 2 + 64)
+							TERROR;
+					}
+					else if(sLineCount == 1)
+					{
+						if(GAIA::ALGO::gstrstr(pLine, " Log 00000001 \xE4\xB8\xAD\xE6\x96\x87") == GNIL)
+							TERROR;
+					}
+					else if(GAIA::ALGO::gstrstr(pLine, " War ") != GNIL)
+					{
+						if(GAIA::ALGO::gstrstr(pLine, " async ") == GNIL)
+							TERROR;
+						++sWarningCount;
+					}
+					else if(GAIA::ALGO::gstrstr(pLine, " Log 12345678 async log") == GNIL)
+						TERROR;
+					++sLineCount;
+					pLine = p + 1;
+				}
+				if(sLineCount != ASYNC_LOG_THREAD_COUNT * ASYNC_LOG_COUNT + 2)
+					TERROR;
+				if(sWarningCount != ASYNC_LOG_THREAD_COUNT * ASYNC_LOG_COUNT / 2)
+					TERROR;
+				gdel[] pBuf;
+			}
+		}
 	}
 }
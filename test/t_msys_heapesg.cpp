@@ -0,0 +1,203 @@
+#include "preheader.h"
+#include "t_common.h"
+
+namespace TEST
+{
+	static const GAIA::NUM HEAPESG_THREAD_COUNT = 8;
+	static const GAIA::NUM HEAPESG_LOOP_COUNT = 20000;
+	static const GAIA::NUM HEAPESG_LIVE_COUNT = 256;
+
+	static GAIA::BL t_msys_heapesg_check(GAIA::MSYS::HeapESG& heap, GAIA::U8* p, GAIA::UM uSize)
+	{
+		if((GAIA::UM)p % (sizeof(GAIA::UM) * 2) != 0)
+			return GAIA::False;
+		if(heap.memory_size(p) != uSize)
+			return GAIA::False;
+		for(GAIA::UM x = 0; x < uSize; ++x)
+		{
+			if(p[x] != (GAIA::U8)(uSize + x))
+				return GAIA::False;
+		}
+		return GAIA::True;
+	}
+
+	static GAIA::U8* t_msys_heapesg_alloc(GAIA::MSYS::HeapESG& heap, GAIA::UM uSize)
+	{
+		GAIA::U8* p = (GAIA::U8*)heap.memory_alloc(uSize);
+		for(GAIA::UM x = 0; x < uSize; ++x)
+			p[x] = (GAIA::U8)(uSize + x);
+		return p;
+	}
+
+	class HeapESGThread : public GAIA::THREAD::Thread
+	{
+	public:
+		GINL HeapESGThread(){this->init();}
+		GINL GAIA::GVOID SetHeap(GAIA::MSYS::HeapESG* pHeap){m_pHeap = pHeap;}
+		GINL GAIA::GVOID SetExchange(GAIA::U8** pExchange, GAIA::SYNC::Lock* pLock){m_pExchange = pExchange; m_pLock = pLock;}
+		GINL GAIA::GVOID SetSeed(GAIA::U32 uSeed){m_uSeed = uSeed;}
+		GINL GAIA::NUM GetErrorCount() const{return m_sErrorCount;}
+		virtual GAIA::GVOID Run()
+		{
+			GAIA::U8* live[HEAPESG_LIVE_COUNT] = {GNIL};
+			for(GAIA::NUM x = 0; x < HEAPESG_LOOP_COUNT; ++x)
+			{
+				GAIA::NUM sIndex = this->random() % HEAPESG_LIVE_COUNT;
+				if(live[sIndex] != GNIL)
+				{
+					if(!t_msys_heapesg_check(*m_pHeap, live[sIndex], m_pHeap->memory_size(live[sIndex])))
+						++m_sErrorCount;
+
+					// Swap with the other threads, so the buffer is released by a different thread.
+					m_pLock->Enter();
+					{
+						GAIA::U8* pTemp = m_pExchange[sIndex];
+						m_pExchange[sIndex] = live[sIndex];
+						live[sIndex] = pTemp;
+					}
+					m_pLock->Leave();
+					if(live[sIndex] != GNIL)
+					{
+						if(!t_msys_heapesg_check(*m_pHeap, live[sIndex], m_pHeap->memory_size(live[sIndex])))
+							++m_sErrorCount;
+						m_pHeap->memory_release(live[sIndex]);
+						live[sIndex] = GNIL;
+					}
+				}
+				else
+				{
+					GAIA::UM uSize = this->random() % 1024;
+					if(this->random() % 64 == 0)
+						uSize = this->random() % (1024 * 512);
+					live[sIndex] = t_msys_heapesg_alloc(*m_pHeap, uSize);
+				}
+			}
+			for(GAIA::NUM x = 0; x < HEAPESG_LIVE_COUNT; ++x)
+			{
+				if(live[x] == GNIL)
+					continue;
+				if(!t_msys_heapesg_check(*m_pHeap, live[x], m_pHeap->memory_size(live[x])))
+					++m_sErrorCount;
+				m_pHeap->memory_release(live[x]);
+			}
+		}
+	private:
+		GINL GAIA::GVOID init()
+		{
+			m_pHeap = GNIL;
+			m_pExchange = GNIL;
+			m_pLock = GNIL;
+			m_uSeed = 0;
+			m_sErrorCount = 0;
+		}
+		GINL GAIA::U32 random()
+		{
+			m_uSeed = m_uSeed * 1103515245 + 12345;
+			return (m_uSeed >> 8) & 0x00FFFFFF;
+		}
+	private:
+		GAIA::MSYS::HeapESG* m_pHeap;
+		GAIA::U8** m_pExchange;
+		GAIA::SYNC::Lock* m_pLock;
+		GAIA::U32 m_uSeed;
+		GAIA::NUM m_sErrorCount;
+	};
+
+	extern GAIA::GVOID t_msys_heapesg(GAIA::LOG::Log& logobj)
+	{
+		// Single thread.
+		{
+			GAIA::MSYS::HeapESG heap;
+			static const GAIA::UM SIZES[] = {0, 1, 15, 16, 17, 100, 1000, 4000, 65536, 313648, 313649, 1024 * 1024};
+			GAIA::U8* p[sizeofarray(SIZES)];
+			GAIA::UM uUseSize = 0;
+			for(GAIA::NUM x = 0; x < sizeofarray(SIZES); ++x)
+			{
+				p[x] = t_msys_heapesg_alloc(heap, SIZES[x]);
+				uUseSize += SIZES[x];
+			}
+			if(heap.piece_size() != sizeofarray(SIZES))
+				TERROR;
+			if(heap.alloc_times() != sizeofarray(SIZES))
+				TERROR;
+			if(heap.use_size() != uUseSize)
+				TERROR;
+			if(heap.size() < uUseSize)
+				TERROR;
+			if(heap.capacity() < heap.size())
+				TERROR;
+			for(GAIA::NUM x = 0; x < sizeofarray(SIZES); ++x)
+			{
+				if(!t_msys_heapesg_check(heap, p[x], SIZES[x]))
+					TERROR;
+				heap.memory_release(p[x]);
+			}
+			if(heap.piece_size() != 0)
+				TERROR;
+			if(heap.use_size() != 0)
+				TERROR;
+			if(heap.size() != 0)
+				TERROR;
+
+			// Alloc and release more than the thread cache could hold.
+			static const GAIA::NUM COUNT = 100000;
+			GAIA::U8** pList = (GAIA::U8**)heap.memory_alloc(sizeof(GAIA::U8*) * COUNT);
+			for(GAIA::NUM x = 0; x < COUNT; ++x)
+				pList[x] = t_msys_heapesg_alloc(heap, x % 200);
+			for(GAIA::NUM x = 0; x < COUNT; ++x)
+			{
+				if(!t_msys_heapesg_check(heap, pList[x], x % 200))
+				{
+					TERROR;
+					break;
+				}
+				heap.memory_release(pList[x]);
+			}
+			heap.memory_release(pList);
+			if(heap.piece_size() != 0)
+				TERROR;
+			if(heap.alloc_times() != sizeofarray(SIZES) + COUNT + 1)
+				TERROR;
+		}
+
+		// Multi threads, the buffers are released by the other threads.
+		{
+			GAIA::MSYS::HeapESG heap;
+			GAIA::SYNC::Lock lr;
+			GAIA::U8* exchange[HEAPESG_LIVE_COUNT] = {GNIL};
+			HeapESGThread threads[HEAPESG_THREAD_COUNT];
+			for(GAIA::NUM x = 0; x < HEAPESG_THREAD_COUNT; ++x)
+			{
+				threads[x].SetHeap(&heap);
+				threads[x].SetExchange(exchange, &lr);
+				threads[x].SetSeed((GAIA::U32)x + 1);
+			}
+			for(GAIA::NUM x = 0; x < HEAPESG_THREAD_COUNT; ++x)
+			{
+				if(!threads[x].Start())
+					TERROR;
+			}
+			for(GAIA::NUM x = 0; x < HEAPESG_THREAD_COUNT; ++x)
+			{
+				if(!threads[x].Wait())
+					TERROR;
+				if(threads[x].GetErrorCount() != 0)
+					TERROR;
+			}
+			for(GAIA::NUM x = 0; x < HEAPESG_LIVE_COUNT; ++x)
+			{
+				if(exchange[x] == GNIL)
+					continue;
+				if(!t_msys_heapesg_check(heap, exchange[x], heap.memory_size(exchange[x])))
+					TERROR;
+				heap.memory_release(exchange[x]);
+			}
+			if(heap.piece_size() != 0)
+				TERROR;
+			if(heap.use_size() != 0)
+				TERROR;
+			if(heap.size() != 0)
+				TERROR;
+		}
+	}
+}
@@ -1,8 +1,116 @@
 #include "preheader.h"
 #include "t_common.h"
+#include <time.h>
 
 namespace TEST
 {
+	class AsyncEchoSocket : public GAIA::NETWORK::AsyncSocket
+	{
+	protected:
+		virtual GAIA::GVOID OnRecved(const GAIA::GVOID* pData, GAIA::NUM sSize)
+		{
+			this->Send(pData, sSize);
+		}
+	};
+
+	class AsyncListenSocket : public GAIA::NETWORK::AsyncSocket
+	{
+	public:
+		~AsyncListenSocket()
+		{
+			for(GAIA::NUM x = 0; x < listAccepted.size(); ++x)
+				gdel listAccepted[x];
+		}
+	protected:
+		virtual GAIA::NETWORK::AsyncSocket* OnAccepting(const GAIA::NETWORK::Addr& addr)
+		{
+			AsyncEchoSocket* pSock = gnew AsyncEchoSocket;
+			GAIA::SYNC::Autolock al(lr);
+			listAccepted.push_back(pSock);
+			return pSock;
+		}
+	public:
+		GAIA::SYNC::Lock lr;
+		GAIA::CTN::Vector<AsyncEchoSocket*> listAccepted;
+	};
+
+	class AsyncClientSocket : public GAIA::NETWORK::AsyncSocket
+	{
+	public:
+		AsyncClientSocket(GAIA::SYNC::Atomic& recved, GAIA::SYNC::Atomic& connected) : recved(recved), connected(connected){}
+	protected:
+		virtual GAIA::GVOID OnConnected(const GAIA::NETWORK::Addr& addr)
+		{
+			++connected;
+		}
+		virtual GAIA::GVOID OnRecved(const GAIA::GVOID* pData, GAIA::NUM sSize)
+		{
+			const GAIA::U8* p = GSCAST(const GAIA::U8*)(pData);
+			for(GAIA::NUM x = 0; x < sSize; ++x)
+			{
+				if(p[x] != (GAIA::U8)'A')
+					bError = GAIA::True;
+			}
+			recved += sSize;
+		}
+	public:
+		GAIA::SYNC::Atomic& recved;
+		GAIA::SYNC::Atomic& connected;
+		GAIA::BL bError;
+	};
+
+	class AsyncSelfCloseSocket : public GAIA::NETWORK::AsyncSocket
+	{
+	public:
+		AsyncSelfCloseSocket(GAIA::SYNC::Atomic& closed) : closed(closed){}
+	protected:
+		virtual GAIA::GVOID OnRecved(const GAIA::GVOID* pData, GAIA::NUM sSize)
+		{
+			// Let the rest data arrive, the socket becomes ready again while it is dispatching.
+			GAIA::SYNC::gsleep(1);
+			this->Close();
+		}
+		virtual GAIA::GVOID OnClosed()
+		{
+			++closed;
+		}
+	public:
+		GAIA::SYNC::Atomic& closed;
+	};
+
+	class AsyncCollectSocket : public GAIA::NETWORK::AsyncSocket
+	{
+	public:
+		AsyncCollectSocket(){nSentFileCount = 0;}
+	protected:
+		virtual GAIA::GVOID OnRecved(const GAIA::GVOID* pData, GAIA::NUM sSize)
+		{
+			GAIA::SYNC::Autolock al(lr);
+			const GAIA::U8* p = GSCAST(const GAIA::U8*)(pData);
+			for(GAIA::NUM x = 0; x < sSize; ++x)
+				recved.push_back(p[x]);
+		}
+		virtual GAIA::GVOID OnSentFile(GAIA::N32 nFile, const GAIA::N64& lOffset, const GAIA::N64& lSize)
+		{
+			++nSentFileCount;
+		}
+	public:
+		GAIA::SYNC::Lock lr;
+		GAIA::CTN::Vector<GAIA::U8> recved;
+		volatile GAIA::N32 nSentFileCount;
+	};
+
+	class AsyncReleaseCallBack : public GAIA::NETWORK::AsyncSocket::SendCallBack
+	{
+	public:
+		virtual GAIA::GVOID OnRelease(const GAIA::GVOID* pData, GAIA::NUM sSize)
+		{
+			++released;
+		}
+	public:
+		GAIA::SYNC::Atomic released;
+	};
+
 	extern GAIA::GVOID t_network_asyncsocket(GAIA::LOG::Log& logobj)
 	{
 		// Simple AsyncDispatcher.
@@ -10,30 +118,386 @@ namespace TEST
 			GAIA::NETWORK::AsyncDispatcher disp;
 			if(disp.IsBegin())
 				TERROR;
+			if(!disp.SetThreadCount(4))
+				TERROR;
+			if(disp.GetThreadCount() != 4)
+				TERROR;
 			if(!disp.Begin())
 				TERROR;
 			if(!disp.IsBegin())
 				TERROR;
+			if(disp.Begin())
+				TERROR;
+			if(disp.SetThreadCount(2))
+				TERROR;
 			if(!disp.End())
 				TERROR;
+			if(disp.IsBegin())
+				TERROR;
 		}
 
 		// Simple AsyncSocket.
 		{
 			GAIA::NETWORK::AsyncSocket sock;
+			if(sock.IsCreated())
+				TERROR;
+			sock.Create();
+			if(!sock.IsCreated())
+				TERROR;
+			if(sock.IsConnected())
+				TERROR;
+			GAIA::NETWORK::AsyncDispatcher disp;
+			if(disp.AddAsyncSocket(sock))
+				TERROR;
+			disp.Begin();
+			if(!disp.AddAsyncSocket(sock))
+				TERROR;
+			if(disp.AddAsyncSocket(sock))
+				TERROR;
+			if(!disp.IsExistAsyncSocket(sock))
+				TERROR;
+			if(disp.GetAsyncSocketCount() != 1)
+				TERROR;
+			if(sock.GetDispatcher() != &disp)
+				TERROR;
+			if(!disp.RemoveAsyncSocket(sock))
+				TERROR;
+			if(disp.RemoveAsyncSocket(sock))
+				TERROR;
+			if(disp.IsExistAsyncSocket(sock))
+				TERROR;
+			if(disp.GetAsyncSocketCount() != 0)
+				TERROR;
+			if(!disp.AddAsyncSocket(sock))
+				TERROR;
+			sock.Close();
+			if(sock.IsCreated())
+				TERROR;
+			if(disp.GetAsyncSocketCount() != 0)
+				TERROR;
+			disp.End();
 		}
 
 		// Multi connect, send, receive, close.
+		GTRY
 		{
 			static const GAIA::NUM SOCKET_COUNT = 1000;
+			static const GAIA::NUM SEND_SIZE = 1024 * 16;
+			static const GAIA::NUM SEND_TIMES = 4;
+
+			GAIA::NETWORK::AsyncDispatcher disp;
+			disp.SetThreadCount(4);
+			disp.Begin();
+
+			AsyncListenSocket listensock;
+			listensock.Create();
+			GAIA::NETWORK::Addr addrListen;
+			addrListen.fromstring("127.0.0.1:0");
+			listensock.Bind(addrListen);
+			listensock.Listen();
+			if(!listensock.IsListen())
+				TERROR;
+			if(!listensock.GetLocalAddress(addrListen))
+				TERROR;
+			addrListen.ip.fromstring("127.0.0.1");
+			if(!disp.AddAsyncSocket(listensock))
+				TERROR;
+
+			GAIA::SYNC::Atomic recved;
+			GAIA::SYNC::Atomic connected;
+			GAIA::CTN::Vector<AsyncClientSocket*> listSockets;
+			GAIA::CTN::Vector<GAIA::U8> data;
+			data.resize(SEND_SIZE);
+			data.reset((GAIA::U8)'A');
+
+			for(GAIA::NUM x = 0; x < SOCKET_COUNT; ++x)
+			{
+				AsyncClientSocket* pSock = gnew AsyncClientSocket(recved, connected);
+				pSock->bError = GAIA::False;
+				pSock->Create();
+				if(!disp.AddAsyncSocket(*pSock))
+					TERROR;
+				pSock->Connect(addrListen);
+				for(GAIA::NUM y = 0; y < SEND_TIMES; ++y)
+					pSock->Send(data.fptr(), data.size());
+				listSockets.push_back(pSock);
+			}
+
+			GAIA::U64 uStartTime = GAIA::TIME::tick_time();
+			while(recved < SOCKET_COUNT * SEND_SIZE * SEND_TIMES)
+			{
+				if(GAIA::TIME::tick_time() - uStartTime > 30 * 1000 * 1000)
+					break;
+				GAIA::SYNC::gsleep(10);
+			}
+			if(connected != SOCKET_COUNT)
+				TERROR;
+			if(recved != SOCKET_COUNT * SEND_SIZE * SEND_TIMES)
+				TERROR;
+			if(listensock.listAccepted.size() != SOCKET_COUNT)
+				TERROR;
+			if(disp.GetAsyncSocketCount() != SOCKET_COUNT * 2 + 1)
+				TERROR;
+
+			for(GAIA::NUM x = 0; x < listSockets.size(); ++x)
+			{
+				AsyncClientSocket* pSock = listSockets[x];
+				if(pSock->bError)
+					TERROR;
+				if(pSock->GetSendingSize() != 0)
+					TERROR;
+				pSock->Close();
+				gdel pSock;
+			}
+			disp.End();
+			if(disp.GetAsyncSocketCount() != 0)
+				TERROR;
+		}
+		GCATCH(Network)
+		{
+			GSTM << e.GetErrorText() << " Error=" << e.GetError() << " OSError=" << e.GetOSError() << " Exception!" << "\n";
+			TERROR;
+		}
+		GCATCHBASE
+		{
+			e.SetDispatched(GAIA::True);
+			TERROR;
+		}
+
+		// Close in the recv callback, other dispatch threads are running.
+		GTRY
+		{
+			static const GAIA::NUM SOCKET_COUNT = 200;
+			static const GAIA::NUM SEND_SIZE = 1024;
+			static const GAIA::NUM SEND_TIMES = 8;
 
 			GAIA::NETWORK::AsyncDispatcher disp;
-			GAIA::CTN::Vector<GAIA::NETWORK::AsyncSocket*> listSockets;
+			disp.SetThreadCount(4);
+			disp.Begin();
+
+			AsyncListenSocket listensock;
+			listensock.Create();
+			GAIA::NETWORK::Addr addrListen;
+			addrListen.fromstring("127.0.0.1:0");
+			listensock.Bind(addrListen);
+			listensock.Listen();
+			if(!listensock.GetLocalAddress(addrListen))
+				TERROR;
+			addrListen.ip.fromstring("127.0.0.1");
+			if(!disp.AddAsyncSocket(listensock))
+				TERROR;
+
+			GAIA::SYNC::Atomic closed;
+			GAIA::CTN::Vector<AsyncSelfCloseSocket*> listSockets;
+			GAIA::CTN::Vector<GAIA::U8> data;
+			data.resize(SEND_SIZE);
+			data.reset((GAIA::U8)'A');
 
 			for(GAIA::NUM x = 0; x < SOCKET_COUNT; ++x)
 			{
+				AsyncSelfCloseSocket* pSock = gnew AsyncSelfCloseSocket(closed);
+				pSock->Create();
+				if(!disp.AddAsyncSocket(*pSock))
+					TERROR;
+				pSock->Connect(addrListen);
+				for(GAIA::NUM y = 0; y < SEND_TIMES; ++y)
+					pSock->Send(data.fptr(), data.size());
+				listSockets.push_back(pSock);
+			}
+
+			GAIA::U64 uStartTime = GAIA::TIME::tick_time();
+			while(closed < SOCKET_COUNT)
+			{
+				if(GAIA::TIME::tick_time() - uStartTime > 30 * 1000 * 1000)
+					break;
+				GAIA::SYNC::gsleep(10);
+			}
+			if(closed != SOCKET_COUNT)
+				TERROR;
+
+			for(GAIA::NUM x = 0; x < listSockets.size(); ++x)
+			{
+				AsyncSelfCloseSocket* pSock = listSockets[x];
+				if(pSock->IsCreated())
+					TERROR;
+				gdel pSock;
+			}
+			disp.End();
+			if(disp.GetAsyncSocketCount() != 0)
+				TERROR;
+		}
+		GCATCH(Network)
+		{
+			GSTM << e.GetErrorText() << " Error=" << e.GetError() << " OSError=" << e.GetOSError() << " Exception!" << "\n";
+			TERROR;
+		}
+		GCATCHBASE
+		{
+			e.SetDispatched(GAIA::True);
+			TERROR;
+		}
+
+		// The idle connection don't wake up the dispatch threads.
+		GTRY
+		{
+			GAIA::NETWORK::AsyncDispatcher disp;
+			disp.SetThreadCount(2);
+			disp.Begin();
+
+			AsyncListenSocket listensock;
+			listensock.Create();
+			GAIA::NETWORK::Addr addrListen;
+			addrListen.fromstring("127.0.0.1:0");
+			listensock.Bind(addrListen);
+			listensock.Listen();
+			if(!listensock.GetLocalAddress(addrListen))
+				TERROR;
+			addrListen.ip.fromstring("127.0.0.1");
+			if(!disp.AddAsyncSocket(listensock))
+				TERROR;
+
+			GAIA::SYNC::Atomic recved;
+			GAIA::SYNC::Atomic connected;
+			AsyncClientSocket sock(recved, connected);
+			sock.bError = GAIA::False;
+			sock.Create();
+			if(!disp.AddAsyncSocket(sock))
+				TERROR;
+			sock.Connect(addrListen);
+			sock.Send("A", 1);
+
+			GAIA::U64 uStartTime = GAIA::TIME::tick_time();
+			while(recved < 1)
+			{
+				if(GAIA::TIME::tick_time() - uStartTime > 10 * 1000 * 1000)
+					break;
+				GAIA::SYNC::gsleep(10);
+			}
+			if(connected != 1 || recved != 1)
+				TERROR;
+
+			clock_t tCPUBegin = clock();
+			GAIA::SYNC::gsleep(1000);
+			clock_t tCPUEnd = clock();
+			if(tCPUEnd - tCPUBegin > CLOCKS_PER_SEC / 10)
+				TERROR;
+			if(connected != 1 || recved != 1 || sock.bError)
+				TERROR;
+
+			sock.Close();
+			disp.End();
+		}
+		GCATCH(Network)
+		{
+			GSTM << e.GetErrorText() << " Error=" << e.GetError() << " OSError=" << e.GetOSError() << " Exception!" << "\n";
+			TERROR;
+		}
+		GCATCHBASE
+		{
+			e.SetDispatched(GAIA::True);
+			TERROR;
+		}
+
+		// SendV and SendFile.
+		GTRY
+		{
+			static const GAIA::NUM SLICE_SIZE = 1024 * 100;
+			static const GAIA::NUM FILE_SIZE = 1024 * 200;
+
+			GAIA::NETWORK::AsyncDispatcher disp;
+			disp.Begin();
+
+			AsyncListenSocket listensock;
+			listensock.Create();
+			GAIA::NETWORK::Addr addrListen;
+			addrListen.fromstring("127.0.0.1:0");
+			listensock.Bind(addrListen);
+			listensock.Listen();
+			listensock.GetLocalAddress(addrListen);
+			addrListen.ip.fromstring("127.0.0.1");
+			disp.AddAsyncSocket(listensock);
 
+			GAIA::CTN::Vector<GAIA::U8> slice0, slice1, slice2, expected;
+			slice0.resize(SLICE_SIZE);
+			slice0.reset((GAIA::U8)'a');
+			slice1.resize(SLICE_SIZE);
+			slice1.reset((GAIA::U8)'b');
+			slice2.resize(SLICE_SIZE);
+			slice2.reset((GAIA::U8)'c');
+			expected += slice0;
+			expected += slice1;
+			expected += slice2;
+
+			FILE* pFile = tmpfile();
+			if(pFile == GNIL)
+				TERROR;
+			for(GAIA::NUM x = 0; x < FILE_SIZE; ++x)
+			{
+				GAIA::U8 u = (GAIA::U8)(x % 251);
+				fwrite(&u, 1, 1, pFile);
+				if(x >= 100)
+					expected.push_back(u);
+			}
+			fflush(pFile);
+			expected.push_back((GAIA::U8)'!');
+
+			AsyncReleaseCallBack cb;
+			AsyncCollectSocket sock;
+			sock.Create();
+			disp.AddAsyncSocket(sock);
+			sock.Connect(addrListen);
+
+			GAIA::NETWORK::AsyncSocket::Slice slices[3];
+			slices[0].pData = slice0.fptr();
+			slices[0].sSize = slice0.size();
+			slices[0].pCallBack = &cb;
+			slices[1].pData = slice1.fptr();
+			slices[1].sSize = slice1.size();
+			slices[1].pCallBack = &cb;
+			slices[2].pData = slice2.fptr();
+			slices[2].sSize = slice2.size();
+			slices[2].pCallBack = GNIL;
+			sock.SendV(slices, sizeofarray(slices));
+			sock.SendFile(fileno(pFile), 100, FILE_SIZE - 100);
+			sock.Send("!", 1);
+
+			GAIA::U64 uStartTime = GAIA::TIME::tick_time();
+			for(;;)
+			{
+				{
+					GAIA::SYNC::Autolock al(sock.lr);
+					if(sock.recved.size() >= expected.size())
+						break;
+				}
+				if(GAIA::TIME::tick_time() - uStartTime > 10 * 1000 * 1000)
+					break;
+				GAIA::SYNC::gsleep(10);
+			}
+			{
+				GAIA::SYNC::Autolock al(sock.lr);
+				if(sock.recved != expected)
+					TERROR;
 			}
+			if(cb.released != 2)
+				TERROR;
+			if(sock.nSentFileCount != 1)
+				TERROR;
+			if(sock.GetSendingSize() != 0)
+				TERROR;
+
+			sock.Close();
+			disp.End();
+			fclose(pFile);
+		}
+		GCATCH(Network)
+		{
+			GSTM << e.GetErrorText() << " Error=" << e.GetError() << " OSError=" << e.GetOSError() << " Exception!" << "\n";
+			TERROR;
+		}
+		GCATCHBASE
+		{
+			e.SetDispatched(GAIA::True);
+			TERROR;
 		}
 	}
 }
\ No newline at end of file
@@ -0,0 +1,113 @@
+﻿#include "preheader.h"
+#include "t_common.h"
+
+namespace TEST
+{
+	extern GAIA::GVOID t_network_congestion(GAIA::LOG::Log& logobj)
+	{
+		static const GAIA::U64 MSS = GAIA::NETWORK::CongestionControl::DEFAULT_MSS;
+
+		// NewReno.
+		{
+			GAIA::NETWORK::CongestionControlNewReno cc;
+			if(cc.GetMSS() != MSS)
+				TERROR;
+			if(cc.GetWindow() != MSS * GAIA::NETWORK::CongestionControlNewReno::INITIAL_WINDOW_SEGMENTS)
+				TERROR;
+			if(!cc.IsSlowStart())
+				TERROR;
+			if(cc.GetPacingInterval(1000) != 0)
+				TERROR;
+
+			// Slow start.
+			cc.OnAck(0, MSS * 2, 50 * 1000, 50 * 1000);
+			if(cc.GetWindow() != MSS * 12)
+				TERROR;
+			if(cc.GetPacingInterval(1000) == 0)
+				TERROR;
+			cc.OnAck(0, MSS, GAIA::NETWORK::CongestionControl::INVALID_RTT, 60 * 1000);
+			if(cc.GetWindow() != MSS * 13)
+				TERROR;
+
+			// Loss, the window is halved once per recovery.
+			cc.OnLoss(MSS * 13, MSS, 100 * 1000);
+			if(cc.GetWindow() != MSS * 13 / 2)
+				TERROR;
+			if(cc.GetSSThresh() != MSS * 13 / 2)
+				TERROR;
+			if(cc.IsSlowStart())
+				TERROR;
+			cc.OnLoss(MSS * 6, MSS, 120 * 1000);
+			if(cc.GetWindow() != MSS * 13 / 2)
+				TERROR;
+
+			// Congestion avoidance, one segment per window acknowledged.
+			cc.OnAck(0, MSS * 13 / 2, 50 * 1000, 200 * 1000);
+			if(cc.GetWindow() != MSS * 13 / 2 + MSS)
+				TERROR;
+			cc.OnAck(0, MSS, 50 * 1000, 210 * 1000);
+			if(cc.GetWindow() != MSS * 13 / 2 + MSS)
+				TERROR;
+
+			// Timeout.
+			GAIA::U64 uWindow = cc.GetWindow();
+			cc.OnTimeout(uWindow, 300 * 1000);
+			if(cc.GetWindow() != MSS)
+				TERROR;
+			if(cc.GetSSThresh() != uWindow / 2)
+				TERROR;
+			if(!cc.IsSlowStart())
+				TERROR;
+
+			cc.SetMSS(100);
+			if(cc.GetMSS() != 100)
+				TERROR;
+			cc.SetMSS(0);
+			if(cc.GetMSS() != MSS)
+				TERROR;
+		}
+
+		// BBR.
+		{
+			GAIA::NETWORK::CongestionControlBBR cc;
+			if(cc.GetMode() != GAIA::NETWORK::CongestionControlBBR::MODE_STARTUP)
+				TERROR;
+			if(cc.GetWindow() != MSS * GAIA::NETWORK::CongestionControlBBR::INITIAL_WINDOW_SEGMENTS)
+				TERROR;
+			if(cc.GetMinRTT() != GAIA::NETWORK::CongestionControl::INVALID_RTT)
+				TERROR;
+			if(cc.GetBandwidth() != 0)
+				TERROR;
+			if(cc.GetPacingInterval(1000) != 0)
+				TERROR;
+
+			// Deliver 12000 bytes each 10 milliseconds with 20 milliseconds round trip time, the bandwidth is 1200000 bytes per second.
+			for(GAIA::U64 t = 10 * 1000; t <= 2 * 1000 * 1000; t += 10 * 1000)
+				cc.OnAck(0, 12000, 20 * 1000, t);
+			if(cc.GetMinRTT() != 20 * 1000)
+				TERROR;
+			if(cc.GetBandwidth() != 1200000)
+				TERROR;
+			if(cc.GetMode() != GAIA::NETWORK::CongestionControlBBR::MODE_PROBEBW)
+				TERROR;
+			if(cc.GetWindow() != 1200000 * 20 / 1000 * 2)
+				TERROR;
+			GAIA::U64 uPacingInterval = cc.GetPacingInterval(12000);
+			if(uPacingInterval < 10 * 1000 * 3 / 4 || uPacingInterval > 10 * 1000 * 4 / 3 + 1)
+				TERROR;
+
+			// The losses are not congestion signal.
+			cc.OnLoss(MSS * 10, MSS, 2100 * 1000);
+			if(cc.GetWindow() != 1200000 * 20 / 1000 * 2)
+				TERROR;
+
+			// Timeout limit the window until the next acknowledgement.
+			cc.OnTimeout(MSS * 10, 2200 * 1000);
+			if(cc.GetWindow() != MSS)
+				TERROR;
+			cc.OnAck(0, MSS, GAIA::NETWORK::CongestionControl::INVALID_RTT, 2300 * 1000);
+			if(cc.GetWindow() < MSS * GAIA::NETWORK::CongestionControlBBR::MIN_WINDOW_SEGMENTS)
+				TERROR;
+		}
+	}
+}
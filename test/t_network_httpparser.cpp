@@ -0,0 +1,295 @@
+#include "preheader.h"
+#include "t_common.h"
+
+namespace TEST
+{
+	class HttpParserRecorder : public GAIA::NETWORK::HttpParser::CallBack
+	{
+	public:
+		HttpParserRecorder(){this->Reset();}
+		GAIA::GVOID Reset()
+		{
+			strLog.clear();
+			strBody.clear();
+			sMessageCount = 0;
+		}
+		virtual GAIA::GVOID OnRequestLine(GAIA::NETWORK::HttpParser& parser, const GAIA::NETWORK::HttpParser::View& method, const GAIA::NETWORK::HttpParser::View& url, const GAIA::NETWORK::HttpParser::View& version)
+		{
+			this->append(method);
+			strLog += " ";
+			this->append(url);
+			strLog += " ";
+			this->append(version);
+			strLog += "\n";
+		}
+		virtual GAIA::GVOID OnHead(GAIA::NETWORK::HttpParser& parser, const GAIA::NETWORK::HttpParser::View& name, const GAIA::NETWORK::HttpParser::View& value)
+		{
+			this->append(name);
+			strLog += "=";
+			this->append(value);
+			strLog += "\n";
+		}
+		virtual GAIA::GVOID OnHeadComplete(GAIA::NETWORK::HttpParser& parser)
+		{
+			strLog += "[head]\n";
+		}
+		virtual GAIA::GVOID OnBody(GAIA::NETWORK::HttpParser& parser, const GAIA::CH* p, GAIA::NUM sSize)
+		{
+			this->append(strBody, p, sSize);
+		}
+		virtual GAIA::GVOID OnMessageComplete(GAIA::NETWORK::HttpParser& parser)
+		{
+			strLog += "[complete]\n";
+			++sMessageCount;
+		}
+	private:
+		GAIA::GVOID append(const GAIA::NETWORK::HttpParser::View& v)
+		{
+			this->append(strLog, v.p, v.sLen);
+		}
+		GAIA::GVOID append(GAIA::CTN::AString& str, const GAIA::CH* p, GAIA::NUM sSize)
+		{
+			GAIA::CH sz[2] = {0};
+			for(GAIA::NUM x = 0; x < sSize; ++x)
+			{
+				sz[0] = p[x];
+				str += sz;
+			}
+		}
+	public:
+		GAIA::CTN::AString strLog;
+		GAIA::CTN::AString strBody;
+		GAIA::NUM sMessageCount;
+	};
+
+	/*
+	*	Feed the stream to parser by pieces, keep the bytes not consumed like a connection buffer.
+	*/
+	static GAIA::BL t_network_httpparser_feed(GAIA::NETWORK::HttpParser& parser, const GAIA::CH* psz, GAIA::NUM sPieceSize)
+	{
+		GAIA::CTN::AString strBuf;
+		GAIA::NUM sLen = GAIA::ALGO::gstrlen(psz);
+		for(GAIA::NUM x = 0; x < sLen; x += sPieceSize)
+		{
+			GAIA::CH sz[2] = {0};
+			for(GAIA::NUM y = x; y < x + sPieceSize && y < sLen; ++y)
+			{
+				sz[0] = psz[y];
+				strBuf += sz;
+			}
+			GAIA::NUM sConsumed;
+			if(!parser.Execute(strBuf.fptr(), strBuf.size(), sConsumed))
+				return GAIA::False;
+			if(sConsumed > strBuf.size())
+				return GAIA::False;
+			if(sConsumed == strBuf.size())
+				strBuf.clear();
+			else if(sConsumed > 0)
+				strBuf.right(sConsumed - 1);
+		}
+		return strBuf.empty();
+	}
+
+	extern GAIA::GVOID t_network_httpparser(GAIA::LOG::Log& logobj)
+	{
+		// Simple request in one buffer.
+		{
+			static const GAIA::CH REQUEST[] =
+				"GET /index.html?a=1 HTTP/1.1\r\n"
+				"Host: www.example.com\r\n"
+				"User-Agent:  gaia \t\r\n"
+				"\r\n";
+			HttpParserRecorder rec;
+			GAIA::NETWORK::HttpParser parser;
+			parser.SetCallBack(&rec);
+			if(!parser.IsIdle())
+				TERROR;
+			GAIA::NUM sConsumed;
+			if(!parser.Execute(REQUEST, sizeof(REQUEST) - 1, sConsumed))
+				TERROR;
+			if(sConsumed != sizeof(REQUEST) - 1)
+				TERROR;
+			if(rec.strLog !=
+				"GET /index.html?a=1 HTTP/1.1\n"
+				"Host=www.example.com\n"
+				"User-Agent=gaia\n"
+				"[head]\n"
+				"[complete]\n")
+				TERROR;
+			if(parser.GetVersionMajor() != 1 || parser.GetVersionMinor() != 1)
+				TERROR;
+			if(!parser.IsKeepAlive())
+				TERROR;
+			if(parser.IsChunked())
+				TERROR;
+			if(parser.GetContentLength() != GINVALID)
+				TERROR;
+			if(!parser.IsIdle())
+				TERROR;
+		}
+
+		// Partial reads, the result must be the same to the whole buffer.
+		{
+			static const GAIA::CH REQUEST[] =
+				"POST /upload HTTP/1.0\r\n"
+				"Content-Length: 11\r\n"
+				"Connection: keep-alive\r\n"
+				"\r\n"
+				"hello world";
+			HttpParserRecorder recwhole;
+			{
+				GAIA::NETWORK::HttpParser parser;
+				parser.SetCallBack(&recwhole);
+				if(!t_network_httpparser_feed(parser, REQUEST, sizeof(REQUEST)))
+					TERROR;
+				if(!parser.IsKeepAlive())
+					TERROR;
+				if(parser.GetContentLength() != 11)
+					TERROR;
+			}
+			for(GAIA::NUM sPieceSize = 1; sPieceSize < 16; ++sPieceSize)
+			{
+				HttpParserRecorder rec;
+				GAIA::NETWORK::HttpParser parser;
+				parser.SetCallBack(&rec);
+				if(!t_network_httpparser_feed(parser, REQUEST, sPieceSize))
+					TERROR;
+				if(rec.strLog != recwhole.strLog)
+					TERROR;
+				if(rec.strBody != "hello world")
+					TERROR;
+				if(rec.sMessageCount != 1)
+					TERROR;
+			}
+		}
+
+		// Pipelined requests and chunked body.
+		{
+			static const GAIA::CH REQUEST[] =
+				"\r\n"
+				"POST /a HTTP/1.1\r\n"
+				"Transfer-Encoding: gzip, chunked\r\n"
+				"\r\n"
+				"5;ext=1\r\n"
+				"hello\r\n"
+				"B\r\n"
+				", chunked!!\r\n"
+				"0\r\n"
+				"X-Trailer: t\r\n"
+				"\r\n"
+				"GET /b HTTP/1.0\r\n"
+				"\r\n"
+				"PUT /c HTTP/1.1\r\n"
+				"Content-Length: 3\r\n"
+				"Connection: close\r\n"
+				"\r\n"
+				"xyz";
+			for(GAIA::NUM sPieceSize = 1; sPieceSize <= sizeof(REQUEST); sPieceSize += 7)
+			{
+				HttpParserRecorder rec;
+				GAIA::NETWORK::HttpParser parser;
+				parser.SetCallBack(&rec);
+				if(!t_network_httpparser_feed(parser, REQUEST, sPieceSize))
+					TERROR;
+				if(rec.sMessageCount != 3)
+					TERROR;
+				if(rec.strBody != "hello, chunked!!xyz")
+					TERROR;
+				if(rec.strLog !=
+					"POST /a HTTP/1.1\n"
+					"Transfer-Encoding=gzip, chunked\n"
+					"[head]\n"
+					"X-Trailer=t\n"
+					"[complete]\n"
+					"GET /b HTTP/1.0\n"
+					"[head]\n"
+					"[complete]\n"
+					"PUT /c HTTP/1.1\n"
+					"Content-Length=3\n"
+					"Connection=close\n"
+					"[head]\n"
+					"[complete]\n")
+					TERROR;
+				if(parser.IsKeepAlive())
+					TERROR;
+				if(!parser.IsIdle())
+					TERROR;
+			}
+		}
+
+		// The repeated Transfer-Encoding fields are combined.
+		{
+			static const GAIA::CH REQUEST[] =
+				"POST / HTTP/1.1\r\n"
+				"Transfer-Encoding: gzip;level=1\r\n"
+				"Transfer-Encoding: chunked\r\n"
+				"\r\n"
+				"3\r\n"
+				"abc\r\n"
+				"0\r\n"
+				"\r\n";
+			HttpParserRecorder rec;
+			GAIA::NETWORK::HttpParser parser;
+			parser.SetCallBack(&rec);
+			if(!t_network_httpparser_feed(parser, REQUEST, sizeof(REQUEST)))
+				TERROR;
+			if(!parser.IsChunked())
+				TERROR;
+			if(rec.strBody != "abc")
+				TERROR;
+			if(rec.sMessageCount != 1)
+				TERROR;
+		}
+
+		// Invalid requests.
+		{
+			static const GAIA::CH* INVALID_REQUESTS[] =
+			{
+				"GET /\r\n\r\n",
+				"GET / HTTP/2.0\r\n\r\n",
+				"GET / HTTP/1.1 \r\n\r\n",
+				"G(T / HTTP/1.1\r\n\r\n",
+				"GET / HTTP/1.1\r\nHost : a\r\n\r\n",
+				"GET / HTTP/1.1\r\nHost: a\r\n folded\r\n\r\n",
+				"GET / HTTP/1.1\r\n: a\r\n\r\n",
+				"POST / HTTP/1.1\r\nContent-Length: 1\r\nContent-Length: 2\r\n\r\n",
+				"POST / HTTP/1.1\r\nContent-Length: -1\r\n\r\n",
+				"POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nZ\r\n",
+				"POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n1\r\nab\r\n",
+				"POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\nTransfer-Encoding: identity\r\nContent-Length: 3\r\n\r\nabc",
+				"POST / HTTP/1.1\r\nTransfer-Encoding: chunked, gzip\r\n\r\n0\r\n\r\n",
+				"POST / HTTP/1.1\r\nTransfer-Encoding: chunked, chunked\r\n\r\n0\r\n\r\n",
+				"POST / HTTP/1.1\r\nTransfer-Encoding: gzip chunked\r\n\r\n0\r\n\r\n",
+				"POST / HTTP/1.1\r\nTransfer-Encoding: gzip\r\n\r\nabc",
+				"POST / HTTP/1.1\r\nTransfer-Encoding: gzip\r\nContent-Length: 3\r\n\r\nabc",
+				"POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\nContent-Length: 3\r\n\r\n0\r\n\r\n",
+				"POST / HTTP/1.1\r\nContent-Length: 3\r\nTransfer-Encoding: chunked\r\n\r\n0\r\n\r\n",
+			};
+			for(GAIA::NUM x = 0; x < sizeofarray(INVALID_REQUESTS); ++x)
+			{
+				GAIA::NETWORK::HttpParser parser;
+				GAIA::NUM sConsumed;
+				if(parser.Execute(INVALID_REQUESTS[x], GAIA::ALGO::gstrlen(INVALID_REQUESTS[x]), sConsumed))
+					TERROR;
+				if(!parser.IsError())
+					TERROR;
+				if(parser.Execute("GET / HTTP/1.1\r\n\r\n", 18, sConsumed))
+					TERROR;
+				parser.Reset();
+				if(!parser.Execute("GET / HTTP/1.1\r\n\r\n", 18, sConsumed))
+					TERROR;
+			}
+		}
+
+		// The line is too long.
+		{
+			GAIA::CTN::AString str = "GET /";
+			for(GAIA::NUM x = 0; x < GAIA::NETWORK::HttpParser::MAX_LINE_SIZE; ++x)
+				str += "a";
+			GAIA::NETWORK::HttpParser parser;
+			GAIA::NUM sConsumed;
+			if(parser.Execute(str.fptr(), str.size(), sConsumed))
+				TERROR;
+		}
+	}
+}
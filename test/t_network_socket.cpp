@@ -74,5 +74,75 @@ namespace TEST
 			e.SetDispatched(GAIA::True);
 			TERROR;
 		}
+
+		// Datagram batch test.
+		GTRY
+		{
+			static const GAIA::N32 DATAGRAM_COUNT = GAIA::NETWORK::Socket::MAX_BATCH_SIZE * 2 + 3;
+
+			GAIA::NETWORK::Addr addrRecv, addrSend;
+			addrRecv.fromstring("127.0.0.1:8013");
+			addrSend.fromstring("127.0.0.1:8014");
+			GAIA::NETWORK::Socket sockrecv, socksend;
+			sockrecv.Create(GAIA::NETWORK::Socket::SOCKET_TYPE_DATAGRAM);
+			sockrecv.SetOption(GAIA::NETWORK::Socket::SOCKET_OPTION_NOBLOCK, GAIA::True);
+			sockrecv.Bind(addrRecv);
+			socksend.Create(GAIA::NETWORK::Socket::SOCKET_TYPE_DATAGRAM);
+			socksend.Bind(addrSend);
+
+			GAIA::N32 sendbuf[DATAGRAM_COUNT];
+			GAIA::NETWORK::Socket::Datagram dgs[DATAGRAM_COUNT];
+			for(GAIA::N32 x = 0; x < DATAGRAM_COUNT; ++x)
+			{
+				sendbuf[x] = x;
+				dgs[x].addr = addrRecv;
+				dgs[x].p = &sendbuf[x];
+				dgs[x].nSize = sizeof(sendbuf[x]) - x % 2;
+			}
+			if(socksend.SendToBatch(dgs, DATAGRAM_COUNT) != DATAGRAM_COUNT)
+				TERROR;
+
+			GAIA::N32 recvbuf[DATAGRAM_COUNT];
+			GAIA::N32 nRecved = 0;
+			for(GAIA::NUM nTry = 0; nTry < 100 && nRecved < DATAGRAM_COUNT; ++nTry)
+			{
+				for(GAIA::N32 x = nRecved; x < DATAGRAM_COUNT; ++x)
+				{
+					dgs[x].addr.reset();
+					dgs[x].p = &recvbuf[x];
+					dgs[x].nSize = sizeof(recvbuf[x]);
+				}
+				GAIA::N32 nCount = sockrecv.RecvFromBatch(dgs + nRecved, DATAGRAM_COUNT - nRecved);
+				if(nCount == 0)
+					GAIA::SYNC::gsleep(10);
+				nRecved += nCount;
+			}
+			if(nRecved != DATAGRAM_COUNT)
+				TERROR;
+			for(GAIA::N32 x = 0; x < nRecved; ++x)
+			{
+				if(dgs[x].addr != addrSend)
+					TERROR;
+				if(dgs[x].nSize != sizeof(recvbuf[x]) - x % 2)
+					TERROR;
+				if(GAIA::ALGO::gmemcmp(&recvbuf[x], &sendbuf[x], dgs[x].nSize) != 0)
+					TERROR;
+			}
+			if(sockrecv.RecvFromBatch(dgs, DATAGRAM_COUNT) != 0)
+				TERROR;
+
+			sockrecv.Close();
+			socksend.Close();
+		}
+		GCATCH(Network)
+		{
+			GSTM << e.GetErrorText() << " Error=" << e.GetError() << " OSError=" << e.GetOSError() << " Exception!" << "\n";
+			TERROR;
+		}
+		GCATCHBASE
+		{
+			e.SetDispatched(GAIA::True);
+			TERROR;
+		}
 	}
 }
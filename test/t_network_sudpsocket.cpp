@@ -131,6 +131,8 @@ namespace TEST
 			m_bResend = bResend;
 			m_bRerecv = bRerecv;
 			m_bTimeout = bTimeout;
+			m_sShardBegin = GINVALID;
+			m_sShardStep = 1;
 		}
 
 		GAIA::GVOID Run()
@@ -150,7 +152,13 @@ namespace TEST
 				{
 					SUDPSocketImpl* pSock = m_listSocks[x];
 					GAST(pSock != GNIL);
-					pSock->Execute(uDeltaTime, m_bSend, m_bRecv, m_bResend, m_bRerecv, m_bTimeout);
+					if(m_sShardBegin == GINVALID)
+						pSock->Execute(uDeltaTime, m_bSend, m_bRecv, m_bResend, m_bRerecv, m_bTimeout);
+					else
+					{
+						for(GAIA::NUM y = m_sShardBegin; y < pSock->GetShardCount(); y += m_sShardStep)
+							pSock->ExecuteShard(y, uDeltaTime, m_bSend, m_bResend, m_bRerecv, m_bTimeout);
+					}
 				}
 
 				if(m_bSend)
@@ -167,6 +175,7 @@ namespace TEST
 		}
 
 		GAIA::GVOID SetStopCmd(){m_bStopCmd = GAIA::True;}
+		GAIA::GVOID SetShardRange(GAIA::NUM sShardBegin, GAIA::NUM sShardStep){m_sShardBegin = sShardBegin; m_sShardStep = sShardStep;}
 
 	private:
 		GAIA::BL m_bStopCmd;
@@ -176,6 +185,8 @@ namespace TEST
 		GAIA::BL m_bResend;
 		GAIA::BL m_bRerecv;
 		GAIA::BL m_bTimeout;
+		GAIA::NUM m_sShardBegin;
+		GAIA::NUM m_sShardStep;
 	};
 
 	class SUDPSocketRecv : public GAIA::Base
@@ -194,6 +205,271 @@ namespace TEST
 		GAIA::CTN::Vector<GAIA::CTN::Pair<GAIA::NETWORK::Addr, GAIA::U16> > listLastSerial;
 	};
 
+	static const GAIA::NUM SUDPSOCKET_LOSSY_MSGSIZE = 512;
+
+	class SUDPSocketLossy : public SUDPSocketImpl
+	{
+	public:
+		GINL SUDPSocketLossy(GAIA::BL bBBR){m_bBBR = bBBR;}
+		virtual GAIA::NETWORK::CongestionControl* OnCreateCongestionControl(const GAIA::NETWORK::Addr& addr)
+		{
+			if(m_bBBR)
+				return gnew GAIA::NETWORK::CongestionControlBBR;
+			return SUDPSocketImpl::OnCreateCongestionControl(addr);
+		}
+	private:
+		GAIA::BL m_bBBR;
+	};
+
+	/*
+		Relay the datagrams between a client and a server,
+		drop some of them, and delay the others with a jitter, so they are reordered.
+	*/
+	class SUDPSocketLossyProxy : public GAIA::THREAD::Thread
+	{
+	public:
+		class Delayed : public GAIA::Base
+		{
+		public:
+			GAIA::U64 uTime;
+			GAIA::NETWORK::Addr addr;
+			GAIA::N32 nSize;
+			GAIA::U8 buf[GAIA::NETWORK::GAIA_NETWORK_MTU];
+		};
+	public:
+		GINL SUDPSocketLossyProxy(const GAIA::NETWORK::Addr& addrProxy, const GAIA::NETWORK::Addr& addrClient, const GAIA::NETWORK::Addr& addrServer)
+		{
+			m_bStopCmd = GAIA::False;
+			m_addrClient = addrClient;
+			m_addrServer = addrServer;
+			m_uSeed = 1;
+			m_sDropCount = 0;
+			m_sock.Create(GAIA::NETWORK::Socket::SOCKET_TYPE_DATAGRAM);
+			m_sock.Bind(addrProxy);
+			m_sock.SetOption(GAIA::NETWORK::Socket::SOCKET_OPTION_NOBLOCK, GAIA::True);
+			m_sock.SetOption(GAIA::NETWORK::Socket::SOCKET_OPTION_SENDBUFSIZE, 1000 * 1024);
+			m_sock.SetOption(GAIA::NETWORK::Socket::SOCKET_OPTION_RECVBUFSIZE, 1000 * 1024);
+		}
+		GAIA::GVOID Run()
+		{
+			static const GAIA::U32 DROP_PERCENT = 5;
+			static const GAIA::U64 DELAY_TIME = 20 * 1000;
+			static const GAIA::U64 JITTER_TIME = 10 * 1000;
+			while(!m_bStopCmd)
+			{
+				GAIA::U64 uCurrentTime = GAIA::TIME::tick_time();
+				for(;;)
+				{
+					Delayed d;
+					d.addr.reset();
+					d.nSize = m_sock.RecvFrom(d.addr, d.buf, sizeof(d.buf));
+					if(d.nSize <= 0)
+						break;
+					if(this->random() % 100 < DROP_PERCENT)
+					{
+						++m_sDropCount;
+						continue;
+					}
+					if(d.addr == m_addrClient)
+						d.addr = m_addrServer;
+					else if(d.addr == m_addrServer)
+						d.addr = m_addrClient;
+					else
+						continue;
+					d.uTime = uCurrentTime + DELAY_TIME + this->random() % JITTER_TIME;
+					m_delayed.push_back(d);
+				}
+				GAIA::NUM sRemain = 0;
+				for(GAIA::NUM x = 0; x < m_delayed.size(); ++x)
+				{
+					Delayed& d = m_delayed[x];
+					if(d.uTime <= uCurrentTime)
+						m_sock.SendTo(d.addr, d.buf, d.nSize);
+					else
+					{
+						if(sRemain != x)
+							m_delayed[sRemain] = d;
+						++sRemain;
+					}
+				}
+				while(m_delayed.size() > sRemain)
+					m_delayed.pop_back();
+				GAIA::SYNC::gsleep(1);
+			}
+			m_sock.Close();
+		}
+		GAIA::GVOID SetStopCmd(){m_bStopCmd = GAIA::True;}
+		GAIA::NUM GetDropCount() const{return m_sDropCount;}
+	private:
+		GINL GAIA::U32 random()
+		{
+			m_uSeed = m_uSeed * 1103515245 + 12345;
+			return (m_uSeed >> 8) & 0x00FFFFFF;
+		}
+	private:
+		GAIA::BL m_bStopCmd;
+		GAIA::NETWORK::Socket m_sock;
+		GAIA::NETWORK::Addr m_addrClient;
+		GAIA::NETWORK::Addr m_addrServer;
+		GAIA::U32 m_uSeed;
+		GAIA::NUM m_sDropCount;
+		GAIA::CTN::Vector<Delayed> m_delayed;
+	};
+
+	static GAIA::GVOID t_network_sudpsocket_lossy(GAIA::LOG::Log& logobj, GAIA::BL bBBR)
+	{
+		static const GAIA::NUM SUDPSOCKET_LOSSY_MSGCOUNT = 300;
+
+		GTRY
+		{
+			GAIA::NETWORK::Addr addrProxy, addrClient, addrServer;
+			addrProxy.ip.fromstring("127.0.0.1");
+			addrProxy.uPort = 9020;
+			addrClient.ip.fromstring("127.0.0.1");
+			addrClient.uPort = 9021;
+			addrServer.ip.fromstring("127.0.0.1");
+			addrServer.uPort = 9022;
+
+			GAIA::CTN::Vector<SUDPSocketImpl*> listSocks;
+			SUDPSocketLossy* pClient = gnew SUDPSocketLossy(bBBR);
+			SUDPSocketLossy* pServer = gnew SUDPSocketLossy(bBBR);
+			listSocks.push_back(pClient);
+			listSocks.push_back(pServer);
+			for(GAIA::NUM x = 0; x < listSocks.size(); ++x)
+			{
+				SUDPSocketImpl* pSock = listSocks[x];
+				pSock->Create();
+				pSock->Bind(x == 0 ? addrClient : addrServer);
+				pSock->SetOption(GAIA::NETWORK::Socket::SOCKET_OPTION_NOBLOCK, GAIA::True);
+				pSock->SetOption(GAIA::NETWORK::Socket::SOCKET_OPTION_SENDBUFSIZE, 1000 * 1024);
+				pSock->SetOption(GAIA::NETWORK::Socket::SOCKET_OPTION_RECVBUFSIZE, 1000 * 1024);
+			}
+
+			// A small selective acknowledgement window, so some serials are out of it.
+			pServer->SetAckWindowSize(100);
+			if(pServer->GetAckWindowSize() != 128)
+				TERROR;
+			pClient->SetAckWindowSize(0);
+			if(pClient->GetAckWindowSize() != GAIA::NETWORK::SUDPSocket::DEFAULT_ACK_WINDOW_SIZE)
+				TERROR;
+
+			SUDPSocketLossyProxy proxy(addrProxy, addrClient, addrServer);
+			proxy.Start();
+			GAIA::CTN::Vector<SUDPSocketThread*> listThreads;
+			listThreads.push_back(gnew SUDPSocketThread(listSocks, GAIA::True, GAIA::True, GAIA::True, GAIA::True, GAIA::True));
+			for(GAIA::NUM x = 0; x < listThreads.size(); ++x)
+				listThreads[x]->Start();
+
+			// Send.
+			for(GAIA::NUM x = 0; x < SUDPSOCKET_LOSSY_MSGCOUNT; ++x)
+			{
+				GAIA::U8 msgbuf[SUDPSOCKET_LOSSY_MSGSIZE];
+				SUDPSocketSerialMsg msg;
+				msg.uSerial = x;
+				msg.uData = x;
+				GAIA::ALGO::gmemset(msgbuf, (GAIA::U8)x, sizeof(msgbuf));
+				GAIA::ALGO::gmemcpy(msgbuf, &msg, sizeof(msg));
+				if(pClient->SendTo(addrProxy, msgbuf, sizeof(msgbuf)) != sizeof(msgbuf))
+				{
+					TERROR;
+					break;
+				}
+			}
+
+			// Receive, all the safe datagrams arrive in order.
+			GAIA::NUM sRecvCount = 0;
+			GAIA::U64 uStartTime = GAIA::TIME::tick_time();
+			while(sRecvCount < SUDPSOCKET_LOSSY_MSGCOUNT)
+			{
+				GAIA::NETWORK::Addr addrRecvFrom;
+				addrRecvFrom.reset();
+				GAIA::U8 msgbuf[GAIA::NETWORK::GAIA_NETWORK_MTU];
+				GAIA::N32 nRecv = pServer->RecvFrom(addrRecvFrom, msgbuf, sizeof(msgbuf));
+				if(nRecv <= 0)
+				{
+					if(GAIA::TIME::tick_time() - uStartTime > 30 * 1000 * 1000)
+					{
+						TERROR;
+						break;
+					}
+					GAIA::SYNC::gsleep(1);
+					continue;
+				}
+				SUDPSocketSerialMsg& msg = *(SUDPSocketSerialMsg*)msgbuf;
+				if(nRecv != SUDPSOCKET_LOSSY_MSGSIZE || addrRecvFrom != addrProxy || msg.uSerial != (GAIA::U16)sRecvCount || msgbuf[nRecv - 1] != (GAIA::U8)sRecvCount)
+				{
+					TERROR;
+					break;
+				}
+				++sRecvCount;
+			}
+			logobj << "\tSUDPSocket lossy " << (bBBR ? "BBR" : "NewReno") << " timecost = " << (GAIA::F64)(GAIA::TIME::tick_time() - uStartTime) / 1000 << "(ms)" << logobj.End();
+
+			// Wait all the safe datagrams acknowledged.
+			GAIA::NETWORK::SUDPSocket::LinkInfo info;
+			uStartTime = GAIA::TIME::tick_time();
+			for(;;)
+			{
+				if(!pClient->GetLinkInfo(addrProxy, info))
+				{
+					TERROR;
+					break;
+				}
+				if(info.sInflightCount == 0)
+					break;
+				if(GAIA::TIME::tick_time() - uStartTime > 30 * 1000 * 1000)
+				{
+					TERROR;
+					break;
+				}
+				GAIA::SYNC::gsleep(10);
+			}
+			if(info.uInflightSize != 0)
+				TERROR;
+			if(!info.bRTTValid)
+				TERROR;
+			if(info.uSRTT < 2 * 20 * 1000) // The proxy delay both directions.
+				TERROR;
+			if(info.uRTO < pClient->GetMinResendTime() || info.uRTO < info.uSRTT)
+				TERROR;
+			if(info.uWindow < (bBBR ? 4 : 1) * GAIA::NETWORK::CongestionControl::DEFAULT_MSS)
+				TERROR;
+			if(pServer->GetLinkInfo(addrProxy, info))
+				TERROR;
+			if(proxy.GetDropCount() == 0)
+				TERROR;
+			if(pClient->GetState().uResendSerialMsgCount == 0)
+				TERROR;
+
+			for(GAIA::NUM x = 0; x < listThreads.size(); ++x)
+			{
+				listThreads[x]->SetStopCmd();
+				listThreads[x]->Wait();
+				gdel listThreads[x];
+			}
+			listThreads.clear();
+			proxy.SetStopCmd();
+			proxy.Wait();
+
+			for(GAIA::NUM x = 0; x < listSocks.size(); ++x)
+			{
+				listSocks[x]->Close();
+				gdel listSocks[x];
+			}
+			listSocks.clear();
+		}
+		GCATCH(Network)
+		{
+			GSTM << e.GetErrorText() << " Error=" << e.GetError() << " OSError=" << e.GetOSError() << " Exception!" << "\n";
+			TERROR;
+		}
+		GCATCHBASE
+		{
+			e.SetDispatched(GAIA::True);
+			TERROR;
+		}
+	}
+
 	extern GAIA::GVOID t_network_sudpsocket(GAIA::LOG::Log& logobj)
 	{
 		static const GAIA::NUM SUDPSOCKET_COUNT = 3;
@@ -212,11 +488,14 @@ namespace TEST
 				addr.uPort = 9010 + x;
 				listAddrs.push_back(addr);
 				SUDPSocketImpl* pSock = gnew SUDPSocketImpl;
+				if(x == 1)
+					pSock->SetShardCount(1);
 				pSock->Create();
 				pSock->Bind(addr);
 				pSock->SetOption(GAIA::NETWORK::Socket::SOCKET_OPTION_NOBLOCK, GAIA::True);
 				pSock->SetOption(GAIA::NETWORK::Socket::SOCKET_OPTION_SENDBUFSIZE, 1000 * 1024);
 				pSock->SetOption(GAIA::NETWORK::Socket::SOCKET_OPTION_RECVBUFSIZE, 1000 * 1024);
+				pSock->SetResendTime(100 * 1000); // The datagrams lost by the full receive buffer must be resent before the receive test timeout.
 				listSocks.push_back(pSock);
 				SUDPSocketRecv sockrecv;
 				sockrecv.addr = addr;
@@ -239,6 +518,24 @@ namespace TEST
 			SUDPSocketImpl* pServerSocket = listSocks[0];
 			GAIA::BL bExistError = GAIA::False;
 
+			// Shard test.
+			{
+				if(listSocks[0]->GetShardCount() != GAIA::NETWORK::SUDPSocket::DEFAULT_SHARD_COUNT)
+					TERROR;
+				if(listSocks[1]->GetShardCount() != 1)
+					TERROR;
+				for(GAIA::NUM x = 0; x < listAddrs.size(); ++x)
+				{
+					GAIA::NUM sShardIndex = pServerSocket->GetShardIndex(listAddrs[x]);
+					if(sShardIndex < 0 || sShardIndex >= pServerSocket->GetShardCount())
+						TERROR;
+					if(pServerSocket->GetShardIndex(listAddrs[x]) != sShardIndex)
+						TERROR;
+					if(listSocks[1]->GetShardIndex(listAddrs[x]) != 0)
+						TERROR;
+				}
+			}
+
 			// New thread.
 			GAIA::CTN::Vector<SUDPSocketThread*> listThreads;
 			listThreads.push_back(gnew SUDPSocketThread(listSocks, GAIA::True, GAIA::False, GAIA::False, GAIA::False, GAIA::False));
@@ -246,6 +543,12 @@ namespace TEST
 			listThreads.push_back(gnew SUDPSocketThread(listSocks, GAIA::False, GAIA::False, GAIA::True, GAIA::False, GAIA::False));
 			listThreads.push_back(gnew SUDPSocketThread(listSocks, GAIA::False, GAIA::False, GAIA::False, GAIA::True, GAIA::False));
 			listThreads.push_back(gnew SUDPSocketThread(listSocks, GAIA::False, GAIA::False, GAIA::False, GAIA::False, GAIA::True));
+			for(GAIA::NUM x = 0; x < 2; ++x)
+			{
+				SUDPSocketThread* pThread = gnew SUDPSocketThread(listSocks, GAIA::True, GAIA::False, GAIA::False, GAIA::True, GAIA::False);
+				pThread->SetShardRange(x, 2);
+				listThreads.push_back(pThread);
+			}
 
 			// Start thread.
 			for(GAIA::NUM x = 0; x < listThreads.size(); ++x)
@@ -520,5 +823,9 @@ namespace TEST
 			e.SetDispatched(GAIA::True);
 			TERROR;
 		}
+
+		// Lossy loopback test, the datagrams are relayed by a proxy which drop, delay and reorder them.
+		t_network_sudpsocket_lossy(logobj, GAIA::False);
+		t_network_sudpsocket_lossy(logobj, GAIA::True);
 	}
 }
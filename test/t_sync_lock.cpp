@@ -84,6 +84,25 @@ namespace TEST
 		GAIA::U32* m_p;
 	};
 
+	class ThdLockRHold : public GAIA::THREAD::Thread
+	{
+	public:
+		GINL ThdLockRHold(){this->init();}
+		virtual GAIA::GVOID Run()
+		{
+			GAIA::SYNC::AutolockR al(*m_pLockRW);
+			*m_p = 1;
+			GAIA::SYNC::gsleep(100);
+			*m_p = 2;
+		}
+		GINL GAIA::GVOID SetParam(GAIA::SYNC::LockRW* pLockRW, volatile GAIA::U32* p){m_pLockRW = pLockRW; m_p = p;}
+	private:
+		GINL GAIA::GVOID init(){m_pLockRW = GNIL; m_p = GNIL;}
+	private:
+		GAIA::SYNC::LockRW* m_pLockRW;
+		volatile GAIA::U32* m_p;
+	};
+
 	extern GAIA::GVOID t_sync_lock(GAIA::LOG::Log& logobj)
 	{
 		static const GAIA::NUM THREAD_COUNT = 10;
@@ -148,5 +167,23 @@ namespace TEST
 			if(u != THREAD_COUNT * 10000)
 				TERROR;
 		}
+
+		// The first reader left, it must wait the other reader when enter write.
+		{
+			GAIA::SYNC::LockRW l;
+			volatile GAIA::U32 u = 0;
+			ThdLockRHold t;
+			t.SetParam(&l, &u);
+			l.EnterRead();
+			t.Start();
+			while(u == 0)
+				GAIA::SYNC::gsleep(1);
+			l.LeaveRead();
+			l.EnterWrite();
+			if(u != 2)
+				TERROR;
+			l.LeaveWrite();
+			t.Wait();
+		}
 	}
 }
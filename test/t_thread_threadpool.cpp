@@ -26,6 +26,74 @@ namespace TEST
 		GAIA::NUM* m_pValue;
 		GAIA::SYNC::Lock* m_pLock;
 	};
+	class ThreadPoolOrderTask : public GAIA::THREAD::ThreadPool::Task
+	{
+	public:
+		GINL GAIA::GVOID SetValue(GAIA::NUM sValue){m_sValue = sValue;}
+		GINL GAIA::GVOID SetList(GAIA::CTN::Vector<GAIA::NUM>* pList){m_pList = pList;}
+		virtual GAIA::GVOID Run()
+		{
+			GAST(m_pList != GNIL);
+			m_pList->push_back(m_sValue);
+		}
+	private:
+		GAIA::NUM m_sValue;
+		GAIA::CTN::Vector<GAIA::NUM>* m_pList;
+	};
+	class ThreadPoolForFunc
+	{
+	public:
+		GINL ThreadPoolForFunc(GAIA::NUM* p){m_p = p;}
+		GINL GAIA::GVOID operator()(GAIA::NUM sBegin, GAIA::NUM sEnd)
+		{
+			for(GAIA::NUM x = sBegin; x < sEnd; ++x)
+				m_p[x] = x * 2;
+		}
+	private:
+		GAIA::NUM* m_p;
+	};
+	class ThreadPoolSumFunc
+	{
+	public:
+		GINL GAIA::N64 operator()(GAIA::NUM sBegin, GAIA::NUM sEnd)
+		{
+			GAIA::N64 ret = 0;
+			for(GAIA::NUM x = sBegin; x < sEnd; ++x)
+				ret += x;
+			return ret;
+		}
+	};
+	class ThreadPoolSumJoin
+	{
+	public:
+		GINL GAIA::N64 operator()(const GAIA::N64& a, const GAIA::N64& b){return a + b;}
+	};
+	class ThreadPoolNestTask : public GAIA::THREAD::ThreadPool::Task
+	{
+	public:
+		GINL ThreadPoolNestTask(GAIA::THREAD::ThreadPool* pPool, GAIA::N64* pResult){m_pPool = pPool; m_pResult = pResult;}
+		virtual GAIA::GVOID Run()
+		{
+			ThreadPoolSumFunc func;
+			ThreadPoolSumJoin join;
+			*m_pResult = m_pPool->ParallelReduce(0, 10000, 100, (GAIA::N64)0, func, join);
+		}
+	private:
+		GAIA::THREAD::ThreadPool* m_pPool;
+		GAIA::N64* m_pResult;
+	};
+	class ThreadPoolBlockTask : public GAIA::THREAD::ThreadPool::Task
+	{
+	public:
+		virtual GAIA::GVOID Run()
+		{
+			m_started.Fire();
+			m_release.Wait((GAIA::U32)GINVALID);
+		}
+	public:
+		GAIA::SYNC::Event m_started;
+		GAIA::SYNC::Event m_release;
+	};
 	extern GAIA::GVOID t_thread_threadpool(GAIA::LOG::Log& logobj)
 	{
 		GAIA::SYNC::Lock lr;
@@ -56,5 +124,144 @@ namespace TEST
 		TAST(tp.End());
 		if(sValue != listTask.size() * 2)
 			TERROR;
+
+		sValue = 0;
+		TAST(tp.SetScheduleMode(GAIA::THREAD::ThreadPool::SCHEDULE_MODE_STEAL));
+		TAST(tp.GetScheduleMode() == GAIA::THREAD::ThreadPool::SCHEDULE_MODE_STEAL);
+		TAST(tp.Begin());
+		{
+			TAST(!tp.SetScheduleMode(GAIA::THREAD::ThreadPool::SCHEDULE_MODE_STATIC));
+			for(GAIA::NUM x = 0; x < listTask.size(); ++x)
+				tp.RunTask(listTask[x]);
+			for(GAIA::NUM x = 0; x < listTask.size(); ++x)
+				tp.PushTask(listTask[x]);
+			tp.FlushTask();
+		}
+		TAST(tp.End());
+		if(sValue != listTask.size() * 2)
+			TERROR;
+
+		// The tasks pushed to a blocked work thread are stolen by the others.
+		sValue = 0;
+		ThreadPoolBlockTask blocktask;
+		TAST(tp.Begin());
+		{
+			tp.RunTask(blocktask);
+			blocktask.m_started.Wait((GAIA::U32)GINVALID);
+			for(GAIA::NUM x = 0; x < listTask.size(); ++x)
+				tp.RunTask(listTask[x]);
+			GAIA::NUM sCompleted = 0;
+			GAIA::U64 uStartTime = GAIA::TIME::tick_time();
+			while(GAIA::TIME::tick_time() - uStartTime < 10 * 1000 * 1000)
+			{
+				lr.Enter();
+				sCompleted = sValue;
+				lr.Leave();
+				if(sCompleted == listTask.size())
+					break;
+				GAIA::SYNC::gsleep(1);
+			}
+			if(sCompleted != listTask.size())
+				TERROR;
+			blocktask.m_release.Fire();
+		}
+		TAST(tp.End());
+		if(sValue != listTask.size())
+			TERROR;
+
+		GAIA::CTN::Vector<GAIA::NUM> listOrder;
+		GAIA::CTN::Vector<ThreadPoolOrderTask> listOrderTask;
+		listOrderTask.resize(100);
+		TAST(tp.Begin());
+		{
+			GAIA::U32 uGroupIndex = tp.ReserveGroupIndex();
+			for(GAIA::NUM x = 0; x < listOrderTask.size(); ++x)
+			{
+				listOrderTask[x].SetValue(x);
+				listOrderTask[x].SetList(&listOrder);
+				listOrderTask[x].SetGroupIndex(uGroupIndex);
+				listOrderTask[x].SetOrdered(GAIA::True);
+				tp.PushTask(listOrderTask[x]);
+			}
+			tp.FlushTask();
+		}
+		TAST(tp.End());
+		TAST(listOrder.size() == listOrderTask.size());
+		for(GAIA::NUM x = 0; x < listOrder.size(); ++x)
+		{
+			if(listOrder[x] != x)
+			{
+				TERROR;
+				break;
+			}
+		}
+
+		for(GAIA::NUM sMode = GAIA::THREAD::ThreadPool::SCHEDULE_MODE_STATIC; sMode <= GAIA::THREAD::ThreadPool::SCHEDULE_MODE_STEAL; ++sMode)
+		{
+			TAST(tp.SetScheduleMode((GAIA::THREAD::ThreadPool::SCHEDULE_MODE)sMode));
+			TAST(tp.Begin());
+			{
+				GAIA::CTN::Vector<GAIA::NUM> listFor;
+				listFor.resize(100000);
+				listFor.reset(0);
+				ThreadPoolForFunc forfunc(listFor.fptr());
+				tp.ParallelFor(0, listFor.size(), 1000, forfunc);
+				for(GAIA::NUM x = 0; x < listFor.size(); ++x)
+				{
+					if(listFor[x] != x * 2)
+					{
+						TERROR;
+						break;
+					}
+				}
+
+				// ParallelSort, the merge passes have odd block count.
+				GAIA::MATH::RandomLCG lcg;
+				GAIA::CTN::Vector<GAIA::N32> listSort;
+				listSort.resize(100003);
+				for(GAIA::NUM x = 0; x < listSort.size(); ++x)
+					listSort[x] = (GAIA::N32)(lcg.random_u16() % 5000);
+				GAIA::CTN::Vector<GAIA::N32> listSortResult = listSort;
+				GAIA::ALGO::sort(listSortResult.fptr(), listSortResult.bptr());
+				tp.ParallelSort(listSort.fptr(), listSort.size(), 3000);
+				for(GAIA::NUM x = 0; x < listSort.size(); ++x)
+				{
+					if(listSort[x] != listSortResult[x])
+					{
+						TERROR;
+						break;
+					}
+				}
+
+				ThreadPoolSumFunc sumfunc;
+				ThreadPoolSumJoin sumjoin;
+				GAIA::N64 nSum = tp.ParallelReduce(0, 100000, 7, (GAIA::N64)0, sumfunc, sumjoin);
+				if(nSum != (GAIA::N64)100000 * 99999 / 2)
+					TERROR;
+				nSum = tp.ParallelReduce(10, 10, 7, (GAIA::N64)0, sumfunc, sumjoin);
+				if(nSum != 0)
+					TERROR;
+
+				// ParallelReduce in the tasks of the same thread pool.
+				GAIA::CTN::Vector<GAIA::N64> listNestResult;
+				listNestResult.resize(20);
+				listNestResult.reset(0);
+				GAIA::CTN::Vector<ThreadPoolNestTask*> listNestTask;
+				for(GAIA::NUM x = 0; x < listNestResult.size(); ++x)
+				{
+					ThreadPoolNestTask* pTask = gnew ThreadPoolNestTask(&tp, &listNestResult[x]);
+					tp.RunTask(*pTask);
+					listNestTask.push_back(pTask);
+				}
+				for(GAIA::NUM x = 0; x < listNestTask.size(); ++x)
+				{
+					listNestTask[x]->Wait();
+					listNestTask[x]->drop_ref();
+					if(listNestResult[x] != (GAIA::N64)10000 * 9999 / 2)
+						TERROR;
+				}
+			}
+			TAST(tp.End());
+		}
 	}
 }
@@ -98,6 +98,31 @@ namespace TEST
 		GINL GAIA::GVOID init(){}
 	};
 
+	class TimerCallBackCount : public GAIA::TIME::Timer::CallBack
+	{
+	public:
+		GINL TimerCallBackCount(){this->init();}
+		virtual GAIA::GVOID UpdateTimer(GAIA::TIME::Timer* pTimer, GAIA::TIME::Timer::FIRE_REASON reason)
+		{
+			if(reason != GAIA::TIME::Timer::FIRE_REASON_UPDATE)
+				return;
+			if(pTimer->GetLastUpdateTime() % pTimer->GetDesc().nEscapeUSec != 0)
+				++m_nErrorCount;
+			++m_nCount;
+		}
+		GINL GAIA::N64 GetCount() const{return m_nCount;}
+		GINL GAIA::N64 GetErrorCount() const{return m_nErrorCount;}
+	private:
+		GINL GAIA::GVOID init()
+		{
+			m_nCount = 0;
+			m_nErrorCount = 0;
+		}
+	private:
+		GAIA::N64 m_nCount;
+		GAIA::N64 m_nErrorCount;
+	};
+
 	extern GAIA::GVOID t_time_timer(GAIA::LOG::Log& logobj)
 	{
 		/* Create common object. */
@@ -206,5 +231,132 @@ namespace TEST
 		/* Release instance. */
 		GAIA_RELEASE_SAFE(pTimerMgr);
 		GAIA_RELEASE_SAFE(pTimer3);
+
+		/* Many timers with simulated time. */
+		{
+			static const GAIA::NUM TIMER_COUNT = 10000;
+			static const GAIA::TIME::Timer::__MicroSecType STEP_TIME = 700;
+			static const GAIA::TIME::Timer::__MicroSecType TOTAL_TIME = 1000 * 1000;
+
+			GAIA::TIME::TimerMgr mgr;
+			GAIA::TIME::TimerMgr::Desc descMgr;
+			descMgr.reset();
+			TAST(mgr.Create(descMgr));
+
+			TimerCallBackCount cb;
+			GAIA::CTN::Vector<GAIA::TIME::Timer*> listTimer;
+			for(GAIA::NUM x = 0; x < TIMER_COUNT; ++x)
+			{
+				GAIA::TIME::Timer* pTimer = gnew GAIA::TIME::Timer;
+				GAIA::TIME::Timer::Desc desc;
+				desc.reset();
+				desc.nEscapeUSec = (x % 997 + 1) * 1000 + x % 3;
+				desc.nMaxUpdateTimes = GAIA::N32MAX;
+				desc.pCallBack = &cb;
+				desc.bAutoRelease = GAIA::False;
+				desc.bMultiCallBack = x % 2 == 0;
+				TAST(pTimer->Create(desc));
+				TAST(mgr.Regist(*pTimer));
+				listTimer.push_back(pTimer);
+			}
+			if(mgr.GetTimerCount() != TIMER_COUNT)
+				TERROR;
+
+			/* Unregist the multi callback timers at half time. */
+			GAIA::N64 nExpectCount = 0;
+			for(GAIA::TIME::Timer::__MicroSecType t = 0; t < TOTAL_TIME; t += STEP_TIME)
+			{
+				mgr.Update(STEP_TIME);
+				if(t < TOTAL_TIME / 2 && t + STEP_TIME >= TOTAL_TIME / 2)
+				{
+					for(GAIA::NUM x = 0; x < TIMER_COUNT; x += 2)
+					{
+						GAIA::TIME::Timer* pTimer = listTimer[x];
+						if(pTimer->GetUpdateTimes() != (mgr.GetLastUpdateTime() - 1) / pTimer->GetDesc().nEscapeUSec)
+							TERROR;
+						nExpectCount += pTimer->GetUpdateTimes();
+						TAST(mgr.Unregist(*pTimer));
+					}
+					if(mgr.GetTimerCount() != TIMER_COUNT / 2)
+						TERROR;
+				}
+			}
+
+			/* The single callback timers fire once for each update. */
+			GAIA::TIME::Timer::__MicroSecType nNow = mgr.GetLastUpdateTime();
+			for(GAIA::NUM x = 1; x < TIMER_COUNT; x += 2)
+			{
+				GAIA::TIME::Timer* pTimer = listTimer[x];
+				const GAIA::TIME::Timer::__MicroSecType& nEscape = pTimer->GetDesc().nEscapeUSec;
+				if(nNow - pTimer->GetLastUpdateTime() > nEscape)
+					TERROR;
+				if(pTimer->GetUpdateTimes() == 0)
+					TERROR;
+				nExpectCount += pTimer->GetUpdateTimes();
+			}
+			if(cb.GetCount() != nExpectCount)
+				TERROR;
+			if(cb.GetErrorCount() != 0)
+				TERROR;
+
+			for(GAIA::NUM x = 0; x < listTimer.size(); ++x)
+			{
+				GAIA::TIME::Timer* pTimer = listTimer[x];
+				if(pTimer->IsRegisted())
+					TAST(mgr.Unregist(*pTimer));
+				GAIA_RELEASE_SAFE(pTimer);
+			}
+			if(mgr.GetTimerCount() != 0)
+				TERROR;
+		}
+
+		/* Long escape timers and large update escape. */
+		{
+			GAIA::TIME::TimerMgr mgr;
+			GAIA::TIME::TimerMgr::Desc descMgr;
+			descMgr.reset();
+			TAST(mgr.Create(descMgr));
+
+			static const GAIA::TIME::Timer::__MicroSecType ESCAPES[] =
+			{
+				200 * 1000,
+				10 * 1000 * 1000,
+				100 * 1000 * 1000,
+				(GAIA::TIME::Timer::__MicroSecType)3600 * 1000 * 1000,
+				(GAIA::TIME::Timer::__MicroSecType)60 * 24 * 3600 * 1000 * 1000,
+			};
+			TimerCallBackCount cb[sizeofarray(ESCAPES)];
+			GAIA::TIME::Timer timers[sizeofarray(ESCAPES)];
+			for(GAIA::NUM x = 0; x < sizeofarray(ESCAPES); ++x)
+			{
+				GAIA::TIME::Timer::Desc desc;
+				desc.reset();
+				desc.nEscapeUSec = ESCAPES[x];
+				desc.nMaxUpdateTimes = GAIA::N32MAX;
+				desc.pCallBack = &cb[x];
+				desc.bAutoRelease = GAIA::False;
+				TAST(timers[x].Create(desc));
+				TAST(mgr.Regist(timers[x]));
+			}
+
+			GAIA::TIME::Timer::__MicroSecType nStep = (GAIA::TIME::Timer::__MicroSecType)7 * 24 * 3600 * 1000 * 1000 + 12345;
+			for(GAIA::NUM x = 0; x < 10; ++x)
+			{
+				mgr.Update(nStep);
+				mgr.Update(1);
+			}
+
+			GAIA::TIME::Timer::__MicroSecType nNow = mgr.GetLastUpdateTime();
+			for(GAIA::NUM x = 0; x < sizeofarray(ESCAPES); ++x)
+			{
+				if(cb[x].GetCount() != (nNow - 1) / ESCAPES[x])
+					TERROR;
+				if(cb[x].GetErrorCount() != 0)
+					TERROR;
+			}
+
+			for(GAIA::NUM x = 0; x < sizeofarray(ESCAPES); ++x)
+				TAST(mgr.Unregist(timers[x]));
+		}
 	}
 }
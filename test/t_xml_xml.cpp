@@ -3,6 +3,261 @@
 
 namespace TEST
 {
+	static GAIA::BL IsSlice(const GAIA::U8* p, GAIA::NUM sLen, const GAIA::CH* psz)
+	{
+		if(psz == GNIL)
+			return p == GNIL;
+		if(p == GNIL || sLen != GAIA::ALGO::gstrlen(psz))
+			return GAIA::False;
+		for(GAIA::NUM x = 0; x < sLen; ++x)
+		{
+			if(p[x] != (GAIA::U8)psz[x])
+				return GAIA::False;
+		}
+		return GAIA::True;
+	}
+	static GAIA::BL WriteTestFile(const GAIA::TCH* pszFileName, const GAIA::GVOID* p, GAIA::NUM sSize)
+	{
+		GAIA::FSYS::File f;
+		if(!f.Open(pszFileName, GAIA::FSYS::File::OPEN_TYPE_CREATEALWAYS | GAIA::FSYS::File::OPEN_TYPE_WRITE))
+			return GAIA::False;
+		return f.Write(p, sSize) == sSize;
+	}
+	static GAIA::GVOID ReadXMLNode(GAIA::XML::XML& xml, GAIA::XML::XML::Cursor& cur, GAIA::NUM& sNodeCount, GAIA::NUM& sNameCount, GAIA::NUM& sCommentCount)
+	{
+		for(;;)
+		{
+			const GAIA::TCH* pszName = xml.BeginReadNode(cur);
+			if(pszName == GNIL)
+				break;
+			switch(cur.GetReadType())
+			{
+			case GAIA::XML::XML_NODE_CONTAINER:
+			case GAIA::XML::XML_NODE_MULTICONTAINER:
+				++sNodeCount;
+				ReadXMLNode(xml, cur, sNodeCount, sNameCount, sCommentCount);
+				break;
+			case GAIA::XML::XML_NODE_NAME:
+				{
+					++sNameCount;
+					const GAIA::TCH* pszValue = xml.BeginReadNode(cur);
+					if(pszValue == GNIL || cur.GetReadType() != GAIA::XML::XML_NODE_VALUE)
+						sNameCount = GINVALID;
+					else
+						xml.EndReadNode(cur);
+				}
+				break;
+			case GAIA::XML::XML_NODE_COMMENT:
+				++sCommentCount;
+				break;
+			default:
+				break;
+			}
+			xml.EndReadNode(cur);
+		}
+	}
+	static GAIA::GVOID ReadXML(GAIA::LOG::Log& logobj, GAIA::XML::XML& xml, const GAIA::TCH* pszFileName)
+	{
+		GAIA::XML::XMLReader reader;
+		if(!reader.OpenFile(pszFileName, 256))
+			TERROR;
+		GAIA::XML::XML::Cursor cur;
+		cur.BindReader(&reader);
+		GAIA::NUM sNodeCount = 0, sNameCount = 0, sCommentCount = 0;
+		ReadXMLNode(xml, cur, sNodeCount, sNameCount, sCommentCount);
+		if(sNodeCount != 40 || sNameCount != 120 || sCommentCount != 40)
+			TERROR;
+		if(reader.GetEvent() != GAIA::XML::XML_EVENT_END)
+			TERROR;
+
+		if(!reader.OpenFile(pszFileName))
+			TERROR;
+		cur.BindReader(&reader);
+		const GAIA::TCH* pszName = xml.BeginReadNode(cur);
+		if(pszName == GNIL || GAIA::ALGO::gstrcmp(pszName, _T("Root")) != 0)
+			TERROR;
+		pszName = xml.BeginReadNode(cur);
+		if(pszName == GNIL || GAIA::ALGO::gstrcmp(pszName, _T("Name0")) != 0)
+			TERROR;
+		pszName = xml.ReadNode(cur);
+		if(pszName == GNIL || GAIA::ALGO::gstrcmp(pszName, _T("Value0")) != 0)
+			TERROR;
+		if(xml.BeginReadNode(cur) != GNIL)
+			TERROR;
+		xml.EndReadNode(cur);
+		GAIA::NUM sChildCount = 1;
+		while(xml.ReadNode(cur) != GNIL)
+			++sChildCount;
+		if(sChildCount != 7)
+			TERROR;
+		if(!xml.EndReadNode(cur))
+			TERROR;
+		if(xml.BeginReadNode(cur) != GNIL)
+			TERROR;
+	}
+	class XMLEventCheck
+	{
+	public:
+		GAIA::XML::XML_EVENT e;
+		const GAIA::CH* pszName;
+		const GAIA::CH* pszValue;
+		GAIA::NUM sDepth;
+	};
+	static GAIA::GVOID CheckXMLEvents(GAIA::LOG::Log& logobj, GAIA::XML::XMLReader& reader, const XMLEventCheck* pChecks, GAIA::NUM sCount)
+	{
+		for(GAIA::NUM x = 0; x < sCount; ++x)
+		{
+			const XMLEventCheck& c = pChecks[x];
+			if(reader.Read() != c.e)
+			{
+				TERROR;
+				break;
+			}
+			const GAIA::U8* p;
+			GAIA::NUM sLen;
+			p = reader.GetName(sLen);
+			if(!IsSlice(p, sLen, c.pszName))
+				TERROR;
+			p = reader.GetValue(sLen);
+			if(!IsSlice(p, sLen, c.pszValue))
+				TERROR;
+			if(reader.GetDepth() != c.sDepth)
+				TERROR;
+		}
+		if(reader.Read() != GAIA::XML::XML_EVENT_END)
+			TERROR;
+	}
+	static GAIA::GVOID ReadXMLEvents(GAIA::LOG::Log& logobj)
+	{
+		static const GAIA::CH XML_SOURCE[] =
+			"<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+			"<!DOCTYPE note>\n"
+			"<Root a=\"1\" b = 'x>y'>\n"
+			"\t<!--comment content-->\n"
+			"\t<Node1/>\n"
+			"\t<Node2 c=\"\"></Node2 >\n"
+			"\t<Node3>\n\t\tabc def\n\t</Node3>\n"
+			"\t<Node4><![CDATA[<raw>]]></Node4>\n"
+			"</Root>\n";
+		static const XMLEventCheck XML_EVENTS[] =
+		{
+			{GAIA::XML::XML_EVENT_HEAD, GNIL, "xml version=\"1.0\" encoding=\"utf-8\"", 0},
+			{GAIA::XML::XML_EVENT_STARTELEMENT, "Root", GNIL, 0},
+			{GAIA::XML::XML_EVENT_ATTRIBUTE, "a", "1", 1},
+			{GAIA::XML::XML_EVENT_ATTRIBUTE, "b", "x>y", 1},
+			{GAIA::XML::XML_EVENT_COMMENT, GNIL, "comment content", 1},
+			{GAIA::XML::XML_EVENT_STARTELEMENT, "Node1", GNIL, 1},
+			{GAIA::XML::XML_EVENT_ENDELEMENT, "Node1", GNIL, 1},
+			{GAIA::XML::XML_EVENT_STARTELEMENT, "Node2", GNIL, 1},
+			{GAIA::XML::XML_EVENT_ATTRIBUTE, "c", "", 2},
+			{GAIA::XML::XML_EVENT_ENDELEMENT, "Node2", GNIL, 1},
+			{GAIA::XML::XML_EVENT_STARTELEMENT, "Node3", GNIL, 1},
+			{GAIA::XML::XML_EVENT_TEXT, GNIL, "abc def", 2},
+			{GAIA::XML::XML_EVENT_ENDELEMENT, "Node3", GNIL, 1},
+			{GAIA::XML::XML_EVENT_STARTELEMENT, "Node4", GNIL, 1},
+			{GAIA::XML::XML_EVENT_TEXT, GNIL, "<raw>", 2},
+			{GAIA::XML::XML_EVENT_ENDELEMENT, "Node4", GNIL, 1},
+			{GAIA::XML::XML_EVENT_ENDELEMENT, "Root", GNIL, 0},
+		};
+
+		GAIA::XML::XMLReader reader;
+		if(!reader.OpenMem(XML_SOURCE, sizeof(XML_SOURCE) - 1))
+			TERROR;
+		CheckXMLEvents(logobj, reader, XML_EVENTS, sizeofarray(XML_EVENTS));
+
+		GAIA::TCH szFileName[GAIA::MAXPL];
+		GAIA::ALGO::gstrcpy(szFileName, g_gaia_appdocdir);
+		GAIA::ALGO::gstrcat(szFileName, "test_reader.xml");
+		if(!WriteTestFile(szFileName, XML_SOURCE, sizeof(XML_SOURCE) - 1))
+			TERROR;
+		if(!reader.OpenFile(szFileName, GAIA::XML::XMLReader::MIN_WINDOW_SIZE))
+			TERROR;
+		CheckXMLEvents(logobj, reader, XML_EVENTS, sizeofarray(XML_EVENTS));
+
+		// The text longer than the window.
+		GAIA::CTN::AString strSource = "<Root>";
+		GAIA::CTN::AString strText;
+		for(GAIA::NUM x = 0; x < 300; ++x)
+			strText += "ab\xE4\xB8\xAD";
+		strSource += strText;
+		strSource += "</Root>";
+		if(!WriteTestFile(szFileName, strSource.fptr(), strSource.size()))
+			TERROR;
+		if(!reader.OpenFile(szFileName, GAIA::XML::XMLReader::MIN_WINDOW_SIZE))
+			TERROR;
+		if(reader.Read() != GAIA::XML::XML_EVENT_STARTELEMENT)
+			TERROR;
+		GAIA::CTN::Vector<GAIA::U8> listReaded;
+		GAIA::NUM sTextCount = 0;
+		while(reader.Read() == GAIA::XML::XML_EVENT_TEXT)
+		{
+			GAIA::NUM sLen;
+			const GAIA::U8* p = reader.GetValue(sLen);
+			if(sLen <= 0 || sLen > GAIA::XML::XMLReader::MIN_WINDOW_SIZE || (p[0] & 0xC0) == 0x80)
+				TERROR;
+			for(GAIA::NUM y = 0; y < sLen; ++y)
+				listReaded.push_back(p[y]);
+			++sTextCount;
+		}
+		if(reader.GetEvent() != GAIA::XML::XML_EVENT_ENDELEMENT)
+			TERROR;
+		if(reader.Read() != GAIA::XML::XML_EVENT_END)
+			TERROR;
+		if(sTextCount <= 1 || !IsSlice(listReaded.fptr(), listReaded.size(), strText.fptr()))
+			TERROR;
+
+		// The tag longer than the window.
+		strSource = "<Root a=\"";
+		strSource += strText;
+		strSource += "\"/>";
+		if(!WriteTestFile(szFileName, strSource.fptr(), strSource.size()))
+			TERROR;
+		if(!reader.OpenFile(szFileName, GAIA::XML::XMLReader::MIN_WINDOW_SIZE))
+			TERROR;
+		if(reader.Read() != GAIA::XML::XML_EVENT_ERROR)
+			TERROR;
+		reader.Close();
+
+		GAIA::FSYS::Dir dir;
+		dir.RemoveFile(szFileName);
+
+		static const GAIA::CH* INVALID_SOURCES[] =
+		{
+			"<Root><A></B></Root>",
+			"<Root>",
+			"</Root>",
+			"<Root a=1/>",
+			"<Root a=\"1\"",
+			"<Root><!--abc</Root>",
+			"<Root/></Root>",
+			"<Root a=\"1\" / >",
+		};
+		for(GAIA::NUM x = 0; x < sizeofarray(INVALID_SOURCES); ++x)
+		{
+			if(!reader.OpenMem(INVALID_SOURCES[x], GAIA::ALGO::gstrlen(INVALID_SOURCES[x])))
+				TERROR;
+			GAIA::XML::XML_EVENT e;
+			do
+			{
+				e = reader.Read();
+			}
+			while(e != GAIA::XML::XML_EVENT_END && e != GAIA::XML::XML_EVENT_ERROR);
+			if(e != GAIA::XML::XML_EVENT_ERROR)
+				TERROR;
+		}
+
+		GAIA::XML::XML xml;
+		static const GAIA::TCH XML_MEM_SOURCE[] = _T("<Root a=\"1\"><Node/><!--c--></Root>");
+		if(!xml.LoadFromMem(XML_MEM_SOURCE, GAIA::ALGO::gstrlen(XML_MEM_SOURCE)))
+			TERROR;
+		if(GAIA::ALGO::gstrcmp(xml.GetRootNode().GetName(), _T("Root")) != 0)
+			TERROR;
+		if(xml.GetRootNode().GetChildCount() != 3)
+			TERROR;
+		static const GAIA::TCH XML_MEM_INVALID_SOURCE[] = _T("<Root><Node></Root>");
+		if(xml.LoadFromMem(XML_MEM_INVALID_SOURCE, GAIA::ALGO::gstrlen(XML_MEM_INVALID_SOURCE)))
+			TERROR;
+	}
 	static GAIA::GVOID SaveLoadXML(GAIA::LOG::Log& logobj, GAIA::XML::XML& xml)
 	{
 		GAIA::CTN::TChars strTemp, strTemp1, strTemp2;
@@ -112,6 +367,7 @@ namespace TEST
 			TERROR;
 		if(!xml.SaveToFile(szFileName, GAIA::XML::XML_SAVE_BESTREAD))
 			TERROR;
+		ReadXML(logobj, xml, szFileName);
 		GAIA::FSYS::Dir dir;
 		dir.RemoveFile(szFileName);
 	}
@@ -135,5 +391,7 @@ namespace TEST
 			SaveLoadXML(logobj, *pXML);
 		}
 		gdel pXML;
+
+		ReadXMLEvents(logobj);
 	}
 }
@@ -0,0 +1,95 @@
+#include "preheader.h"
+#include "t_common.h"
+
+namespace TEST
+{
+	class TPerfAdditiveHashKey : public GAIA::Base
+	{
+	public:
+		GAIA::U64 hash() const
+		{
+			GAIA::U64 ret = 0;
+			for(const GAIA::CH* p = m_psz; *p != '\0'; ++p)
+				ret += *p;
+			return ret;
+		}
+		GAIA::BL operator == (const TPerfAdditiveHashKey& src) const{return GAIA::ALGO::gstrcmp(m_psz, src.m_psz) == 0;}
+		GAIA::BL operator != (const TPerfAdditiveHashKey& src) const{return !this->operator == (src);}
+	public:
+		const GAIA::CH* m_psz;
+	};
+	class TPerfWordHashKey : public GAIA::Base
+	{
+	public:
+		GAIA::U64 hash() const{return GAIA::ALGO::hash(m_psz);}
+		GAIA::BL operator == (const TPerfWordHashKey& src) const{return GAIA::ALGO::gstrcmp(m_psz, src.m_psz) == 0;}
+		GAIA::BL operator != (const TPerfWordHashKey& src) const{return !this->operator == (src);}
+	public:
+		const GAIA::CH* m_psz;
+	};
+
+	template<typename _KeyType> GAIA::GVOID tperf_algo_hash_keys(GAIA::LOG::Log& logobj, const GAIA::CH* pszName, const GAIA::CTN::Vector<GAIA::CTN::BasicChars<GAIA::CH, GAIA::N8, 32> >& listKey)
+	{
+		GAIA::CTN::Vector<_KeyType> listHashKey;
+		listHashKey.resize(listKey.size());
+		for(GAIA::NUM x = 0; x < listKey.size(); ++x)
+			listHashKey[x].m_psz = listKey[x].fptr();
+
+		// Chain length when the bucket count equal to the key count.
+		GAIA::CTN::Vector<GAIA::NUM> listChain;
+		listChain.resize(listHashKey.size());
+		listChain.reset(0);
+		for(GAIA::NUM x = 0; x < listHashKey.size(); ++x)
+			++listChain[(GAIA::NUM)(listHashKey[x].hash() % (GAIA::U64)listChain.size())];
+		GAIA::NUM sUsedBucket = 0;
+		GAIA::NUM sMaxChain = 0;
+		for(GAIA::NUM x = 0; x < listChain.size(); ++x)
+		{
+			if(listChain[x] == 0)
+				continue;
+			++sUsedBucket;
+			if(listChain[x] > sMaxChain)
+				sMaxChain = listChain[x];
+		}
+
+		// Lookup throughput.
+		GAIA::CTN::HashSet<_KeyType> hs;
+		GAIA::U64 uInsertStartTime = GAIA::TIME::tick_time();
+		for(GAIA::NUM x = 0; x < listHashKey.size(); ++x)
+			hs.insert(listHashKey[x]);
+		GAIA::U64 uInsertEndTime = GAIA::TIME::tick_time();
+		GAIA::NUM sFinded = 0;
+		GAIA::U64 uFindStartTime = GAIA::TIME::tick_time();
+		for(GAIA::NUM x = 0; x < listHashKey.size(); ++x)
+		{
+			if(hs.find(listHashKey[x]) != GNIL)
+				++sFinded;
+		}
+		GAIA::U64 uFindEndTime = GAIA::TIME::tick_time();
+		if(sFinded != listHashKey.size())
+			TERROR;
+
+		logobj << "\t\t" << pszName << " UsedBucket = " << sUsedBucket << "/" << listChain.size() << ", AvgChain = " << (GAIA::F64)listHashKey.size() / (GAIA::F64)sUsedBucket << ", MaxChain = " << sMaxChain << logobj.End();
+		logobj << "\t\t" << pszName << " Insert Time = " << uInsertEndTime - uInsertStartTime << "(us), Find Time = " << uFindEndTime - uFindStartTime << "(us)" << logobj.End();
+	}
+
+	extern GAIA::GVOID tperf_algo_hash(GAIA::LOG::Log& logobj)
+	{
+		static const GAIA::NUM SAMPLE_COUNT = 20000;
+
+		// Http head like names, short keys with the same prefix.
+		GAIA::CTN::Vector<GAIA::CTN::BasicChars<GAIA::CH, GAIA::N8, 32> > listKey;
+		for(GAIA::NUM x = 0; x < SAMPLE_COUNT; ++x)
+		{
+			GAIA::CH szTemp[32];
+			GAIA::ALGO::gstrcpy(szTemp, "X-Header-");
+			GAIA::ALGO::castv(x, szTemp + GAIA::ALGO::gstrlen(szTemp), 16);
+			listKey.push_back(szTemp);
+		}
+
+		logobj << "\t\tBegin compare additive hash and word hash..." << logobj.End();
+		tperf_algo_hash_keys<TPerfAdditiveHashKey>(logobj, "AdditiveHash", listKey);
+		tperf_algo_hash_keys<TPerfWordHashKey>(logobj, "WordHash", listKey);
+		logobj << "\n" << logobj.End();
+	}
+}
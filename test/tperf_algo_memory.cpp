@@ -0,0 +1,91 @@
+#include "preheader.h"
+#include "t_common.h"
+#include <string.h>
+
+namespace TEST
+{
+	extern GAIA::GVOID tperf_algo_memory(GAIA::LOG::Log& logobj)
+	{
+		static const GAIA::NUM TOTAL_SIZE = 64 * 1024 * 1024;
+		static const GAIA::NUM MAX_SIZE = 16 * 1024 * 1024;
+		static const GAIA::NUM SIZES[] = {8, 32, 100, 256, 4096, 64 * 1024, 1024 * 1024, MAX_SIZE};
+
+		// The begin offset is changed by the loop, so the unaligned memory is tested too.
+		GAIA::U8* pSrc = gnew GAIA::U8[MAX_SIZE + 64];
+		GAIA::U8* pDst = gnew GAIA::U8[MAX_SIZE + 64];
+		for(GAIA::NUM x = 0; x < MAX_SIZE + 64; ++x)
+			pSrc[x] = pDst[x] = (GAIA::U8)x;
+
+		for(GAIA::NUM x = 0; x < sizeofarray(SIZES); ++x)
+		{
+			GAIA::NUM sSize = SIZES[x];
+			GAIA::NUM sLoop = TOTAL_SIZE / sSize;
+
+			GAIA::U64 uStartTime = GAIA::TIME::tick_time();
+			for(GAIA::NUM y = 0; y < sLoop; ++y)
+				GAIA::ALGO::gmemcpy(pDst + (y & 15), pSrc + (y & 31), sSize);
+			GAIA::U64 uCopyTime = GAIA::TIME::tick_time() - uStartTime;
+			uStartTime = GAIA::TIME::tick_time();
+			for(GAIA::NUM y = 0; y < sLoop; ++y)
+				memcpy(pDst + (y & 15), pSrc + (y & 31), sSize);
+			GAIA::U64 uLibcCopyTime = GAIA::TIME::tick_time() - uStartTime;
+
+			uStartTime = GAIA::TIME::tick_time();
+			for(GAIA::NUM y = 0; y < sLoop; ++y)
+				GAIA::ALGO::gmemset(pDst + (y & 15), (GAIA::U8)y, sSize);
+			GAIA::U64 uSetTime = GAIA::TIME::tick_time() - uStartTime;
+			uStartTime = GAIA::TIME::tick_time();
+			for(GAIA::NUM y = 0; y < sLoop; ++y)
+				memset(pDst + (y & 15), (GAIA::U8)y, sSize);
+			GAIA::U64 uLibcSetTime = GAIA::TIME::tick_time() - uStartTime;
+
+			GAIA::ALGO::gmemcpy(pDst, pSrc, sSize + 16);
+			GAIA::NUM sEqual = 0;
+			uStartTime = GAIA::TIME::tick_time();
+			for(GAIA::NUM y = 0; y < sLoop; ++y)
+			{
+				if(GAIA::ALGO::gmemcmp(pDst + (y & 15), pSrc + (y & 15), sSize) == 0)
+					++sEqual;
+			}
+			GAIA::U64 uCmpTime = GAIA::TIME::tick_time() - uStartTime;
+			uStartTime = GAIA::TIME::tick_time();
+			for(GAIA::NUM y = 0; y < sLoop; ++y)
+			{
+				if(memcmp(pDst + (y & 15), pSrc + (y & 15), sSize) == 0)
+					++sEqual;
+			}
+			GAIA::U64 uLibcCmpTime = GAIA::TIME::tick_time() - uStartTime;
+			if(sEqual != sLoop * 2)
+				TERROR;
+
+			logobj << "\t\tSize = " << sSize << ", Loop = " << sLoop << logobj.End();
+			logobj << "\t\t\tgmemcpy Time = " << uCopyTime << "(us), memcpy Time = " << uLibcCopyTime << "(us)" << logobj.End();
+			logobj << "\t\t\tgmemset Time = " << uSetTime << "(us), memset Time = " << uLibcSetTime << "(us)" << logobj.End();
+			logobj << "\t\t\tgmemcmp Time = " << uCmpTime << "(us), memcmp Time = " << uLibcCmpTime << "(us)" << logobj.End();
+		}
+
+		// Image rows copy, the rows have gap.
+		{
+			static const GAIA::NUM WIDTH = 1920 * 4;
+			static const GAIA::NUM HEIGHT = 1080;
+			static const GAIA::NUM STRIDE = WIDTH + 64;
+			GAIA::U64 uStartTime = GAIA::TIME::tick_time();
+			for(GAIA::NUM y = 0; y < 10; ++y)
+				GAIA::ALGO::gmemcpy(pDst, pSrc, STRIDE, STRIDE, WIDTH, HEIGHT);
+			GAIA::U64 uStrideTime = GAIA::TIME::tick_time() - uStartTime;
+			uStartTime = GAIA::TIME::tick_time();
+			for(GAIA::NUM y = 0; y < 10; ++y)
+			{
+				for(GAIA::NUM z = 0; z < HEIGHT; ++z)
+					memcpy(pDst + z * STRIDE, pSrc + z * STRIDE, WIDTH);
+			}
+			GAIA::U64 uLibcStrideTime = GAIA::TIME::tick_time() - uStartTime;
+			if(GAIA::ALGO::gmemcmp(pDst, pSrc, STRIDE, STRIDE, WIDTH, HEIGHT) != 0)
+				TERROR;
+			logobj << "\t\tStrided gmemcpy Time = " << uStrideTime << "(us), memcpy by rows Time = " << uLibcStrideTime << "(us)" << logobj.End();
+		}
+
+		gdel[] pSrc;
+		gdel[] pDst;
+	}
+}
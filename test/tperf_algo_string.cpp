@@ -0,0 +1,95 @@
+#include "preheader.h"
+#include "t_common.h"
+
+namespace TEST
+{
+	template<typename _CharType> class TPerfStrScalarPtr
+	{
+	public:
+		TPerfStrScalarPtr(const _CharType* p = GNIL){m_p = p;}
+		const _CharType& operator * () const{return *m_p;}
+		const _CharType& operator [] (GAIA::NUM sIndex) const{return m_p[sIndex];}
+		TPerfStrScalarPtr& operator ++ (){++m_p; return *this;}
+		GAIA::BL operator ! () const{return m_p == GNIL;}
+		const _CharType* ptr() const{return m_p;}
+	private:
+		const _CharType* m_p;
+	};
+
+	template<typename _CharType> GAIA::GVOID tperf_algo_string_type(GAIA::LOG::Log& logobj, const GAIA::CH* pszName)
+	{
+		typedef TPerfStrScalarPtr<_CharType> __ScalarPtr;
+		static const GAIA::NUM STRING_LEN = 64 * 1024;
+		static const GAIA::NUM LOOP_COUNT = 200;
+
+		// Printable text without the key char 'z', the needle is at the end.
+		// The begin of gstrlen is changed by the loop, so the compiler can't hoist it.
+		_CharType* p1 = gnew _CharType[STRING_LEN + 1];
+		_CharType* p2 = gnew _CharType[STRING_LEN + 1];
+		for(GAIA::NUM x = 0; x < STRING_LEN; ++x)
+			p1[x] = p2[x] = (_CharType)('a' + x % 23);
+		p1[STRING_LEN - 1] = p2[STRING_LEN - 1] = 'z';
+		p1[STRING_LEN] = p2[STRING_LEN] = '\0';
+		p2[STRING_LEN - 2] = 'y';
+		_CharType szNeedle[] = {'a', 'b', 'c', 'z', '\0'};
+		_CharType szKeys[] = {'x', 'y', 'z', '\0'};
+		const _CharType* cp1 = p1;
+		const _CharType* cp2 = p2;
+		const _CharType* pNeedle = szNeedle;
+		const _CharType* pKeys = szKeys;
+		__ScalarPtr sp1(p1);
+		__ScalarPtr sp2(p2);
+		__ScalarPtr spNeedle(szNeedle);
+		__ScalarPtr spKeys(szKeys);
+
+		// Warm up the cache and the cpu.
+		for(GAIA::NUM x = 0; x < LOOP_COUNT; ++x)
+			GAIA::ALGO::gstrcmp(cp1, cp2);
+
+		GAIA::NUM sSimdSum = 0;
+		GAIA::NUM sScalarSum = 0;
+		GAIA::U64 uSimdTime[6];
+		GAIA::U64 uScalarTime[6];
+		GAIA::U64 uStartTime;
+
+	#define TPERF_ALGO_STRING_CASE(index, simd, scalar) \
+		uStartTime = GAIA::TIME::tick_time(); \
+		for(GAIA::NUM x = 0; x < LOOP_COUNT; ++x) \
+			sSimdSum += (GAIA::NUM)(simd); \
+		uSimdTime[index] = GAIA::TIME::tick_time() - uStartTime; \
+		uStartTime = GAIA::TIME::tick_time(); \
+		for(GAIA::NUM x = 0; x < LOOP_COUNT; ++x) \
+			sScalarSum += (GAIA::NUM)(scalar); \
+		uScalarTime[index] = GAIA::TIME::tick_time() - uStartTime;
+
+		TPERF_ALGO_STRING_CASE(0, GAIA::ALGO::gstrlen(cp1 + x % 16), GAIA::ALGO::gstrlen(__ScalarPtr(cp1 + x % 16)));
+		TPERF_ALGO_STRING_CASE(1, GAIA::ALGO::gstrch(cp1, 'z') - cp1, GAIA::ALGO::gstrch(sp1, 'z').ptr() - cp1);
+		TPERF_ALGO_STRING_CASE(2, GAIA::ALGO::gstrchs(cp1, pKeys) - cp1, GAIA::ALGO::gstrchs(sp1, spKeys).ptr() - cp1);
+		TPERF_ALGO_STRING_CASE(3, GAIA::ALGO::gstrcnt(cp1, 'a'), GAIA::ALGO::gstrcnt(sp1, 'a'));
+		TPERF_ALGO_STRING_CASE(4, GAIA::ALGO::gstrcmp(cp1, cp2), GAIA::ALGO::gstrcmp(sp1, sp2));
+		TPERF_ALGO_STRING_CASE(5, GAIA::ALGO::gstrstr(cp1, pNeedle) - cp1, GAIA::ALGO::gstrstr(sp1, spNeedle).ptr() - cp1);
+
+	#undef TPERF_ALGO_STRING_CASE
+
+		if(sSimdSum != sScalarSum)
+			TERROR;
+
+		static const GAIA::CH* FUNC_NAMES[] = {"gstrlen", "gstrch", "gstrchs", "gstrcnt", "gstrcmp", "gstrstr"};
+		for(GAIA::NUM x = 0; x < sizeofarray(FUNC_NAMES); ++x)
+		{
+			logobj << "\t\t" << pszName << " " << FUNC_NAMES[x] << " SIMD Time = " << uSimdTime[x] << "(us), Scalar Time = " << uScalarTime[x] << "(us), Speedup = " <<
+				(GAIA::F64)uScalarTime[x] / (GAIA::F64)GAIA::ALGO::gmax(uSimdTime[x], (GAIA::U64)1) << logobj.End();
+		}
+
+		gdel[] p1;
+		gdel[] p2;
+	}
+
+	extern GAIA::GVOID tperf_algo_string(GAIA::LOG::Log& logobj)
+	{
+		if(!GAIA::ALGO::StrSimd<GAIA::CH>::IS_SIMD)
+			logobj << "\t\tSIMD is disabled, the both paths are scalar." << logobj.End();
+		tperf_algo_string_type<GAIA::CH>(logobj, "CH");
+		tperf_algo_string_type<GAIA::WCH>(logobj, "WCH");
+	}
+}
@@ -61,6 +61,37 @@ namespace TEST
 			logobj << "\n" << logobj.End();
 		}
 
+		{
+			logobj << "\t\tBegin compare HashMap and FlatHashMap..." << logobj.End();
+
+			static const GAIA::NUM SAMPLE_COUNT = 100000;
+
+			GAIA::CTN::HashMap<GAIA::N32, GAIA::N32> hm;
+			GAIA::CTN::FlatHashMap<GAIA::N32, GAIA::N32> fhm;
+
+			GAIA::U64 uHashMapStartTime = GAIA::TIME::tick_time();
+			for(GAIA::NUM x = 0; x < SAMPLE_COUNT; ++x)
+				hm.insert(x, -x);
+			for(GAIA::NUM x = 0; x < SAMPLE_COUNT; ++x)
+				hm.find(x);
+			for(GAIA::NUM x = 0; x < SAMPLE_COUNT; ++x)
+				hm.erase(x);
+			GAIA::U64 uHashMapEndTime = GAIA::TIME::tick_time();
+
+			GAIA::U64 uFlatHashMapStartTime = GAIA::TIME::tick_time();
+			for(GAIA::NUM x = 0; x < SAMPLE_COUNT; ++x)
+				fhm.insert(x, -x);
+			for(GAIA::NUM x = 0; x < SAMPLE_COUNT; ++x)
+				fhm.find(x);
+			for(GAIA::NUM x = 0; x < SAMPLE_COUNT; ++x)
+				fhm.erase(x);
+			GAIA::U64 uFlatHashMapEndTime = GAIA::TIME::tick_time();
+
+			logobj << "\t\tHashMap Time = " << uHashMapEndTime - uHashMapStartTime << "(us)" << logobj.End();
+			logobj << "\t\tFlatHashMap Time = " << uFlatHashMapEndTime - uFlatHashMapStartTime << "(us)"  << logobj.End();
+			logobj << "\n" << logobj.End();
+		}
+
 		// Container's performance compare to stl.
 		{
 			logobj << "\t\tBegin compare Map and STLMap..." << logobj.End();